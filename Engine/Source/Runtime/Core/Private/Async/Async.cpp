@@ -40,6 +40,39 @@ private:
 };
 
 
+/** Queued work for functions run by FThreadPoolExecutor. */
+class FAsyncQueuedFunction
+	: public IQueuedWork
+{
+public:
+
+	/** Creates and initializes a new instance. */
+	FAsyncQueuedFunction(TFunction<void()>&& InFunction)
+		: Function(MoveTemp(InFunction))
+	{ }
+
+	// IQueuedWork interface
+
+	virtual void DoThreadedWork() override
+	{
+		Function();
+		delete this;
+	}
+
+	virtual void Abandon() override
+	{
+		// the continuation still has to run, or the future it sets is never ready
+		Function();
+		delete this;
+	}
+
+private:
+
+	/** The function to execute in the thread pool. */
+	TFunction<void()> Function;
+};
+
+
 /* Global functions
  *****************************************************************************/
 
@@ -55,3 +88,24 @@ void AsyncTask(ENamedThreads::Type Thread, TFunction<void()> Function)
 {
 	TGraphTask<FAsyncGraphTask>::CreateTask().ConstructAndDispatchWhenReady(Thread, MoveTemp(Function));
 }
+
+
+/* FTaskGraphExecutor interface
+ *****************************************************************************/
+
+void FTaskGraphExecutor::Execute(TFunction<void()>&& Function) const
+{
+	AsyncTask(Thread, MoveTemp(Function));
+}
+
+
+/* FThreadPoolExecutor interface
+ *****************************************************************************/
+
+void FThreadPoolExecutor::Execute(TFunction<void()>&& Function) const
+{
+	// if you hit this assertion then the executor was made before GThreadPool was created
+	check(ThreadPool != nullptr);
+
+	ThreadPool->AddQueuedWork(new FAsyncQueuedFunction(MoveTemp(Function)));
+}
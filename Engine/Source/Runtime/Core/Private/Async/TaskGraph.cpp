@@ -21,6 +21,9 @@
 #include "HAL/IConsoleManager.h"
 #include "Misc/App.h"
 #include "Containers/LockFreeFixedSizeAllocator.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "HAL/PlatformAffinity.h"
 #include "Async/TaskGraphInterfaces.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogTaskGraph, Log, All);
@@ -147,6 +150,22 @@ static FAutoConsoleVariableRef CVarMaxTasksToStartOnDequeue(
 	ECVF_Cheat
 	);
 
+static int32 GUseWorkStealing = 1;
+static FAutoConsoleVariableRef CVarUseWorkStealing(
+	TEXT("TaskGraph.UseWorkStealing"),
+	GUseWorkStealing,
+	TEXT("If > 0, anythread tasks queued from a task thread go to that thread's own deque and idle task threads steal from the other deques. Otherwise every anythread task goes through the shared queue. Not used with TaskGraph.FastScheduler."),
+	ECVF_Cheat
+	);
+
+static int32 GWorkerSpinCount = 2000;
+static FAutoConsoleVariableRef CVarWorkerSpinCount(
+	TEXT("TaskGraph.WorkerSpinCount"),
+	GWorkerSpinCount,
+	TEXT("Number of times a task thread that ran out of work looks for more before it blocks. Spinning threads are not woken up when tasks are queued. Ignored on single core machines and with TaskGraph.FastScheduler."),
+	ECVF_Cheat
+	);
+
 #define PROFILE_TASKGRAPH (0)
 #if PROFILE_TASKGRAPH
 	struct FProfileRec
@@ -1243,11 +1262,17 @@ private:
 		}
 #endif
 		verify(++Queue.RecursionGuard == 1);
+		bool bLookingForWork = false;
 		while (1)
 		{
 			FBaseGraphTask* Task = FindWork();
 			if (!Task)
 			{
+				if (SpinForWork())
+				{
+					bLookingForWork = true;
+					continue;
+				}
 #if STATS
 				if(bTasksOpen)
 				{
@@ -1267,8 +1292,15 @@ private:
 					ProcessingTasks.Start(StatName);
 				}
 #endif
+				bLookingForWork = true;
 				continue;
 			}
+			if (bLookingForWork)
+			{
+				// there may be more where this came from, make sure another thread is looking
+				bLookingForWork = false;
+				NotifyFoundWork();
+			}
 			TestRandomizedThreads();
 			Task->Execute(NewTasks, ENamedThreads::Type(ThreadId));
 			TestRandomizedThreads();
@@ -1321,6 +1353,11 @@ private:
 
 				NotifyStalling();
 				TestRandomizedThreads();
+				if (HasPendingWork())
+				{
+					// work was queued after we last looked, but maybe before the queuing thread could see our stall hint
+					return;
+				}
 				Queue.StallRestartEvent->Wait(MAX_uint32, bCountAsStall);
 				TestRandomizedThreads();
 				Queue.StallRestartEvent->Reset();
@@ -1339,12 +1376,156 @@ private:
 	 */
 	void NotifyStalling();
 
+	/**
+	 *	Internal function to look for work for a while before stalling. Called from this thread.
+	 *	@return true if there might be work now.
+	 */
+	bool SpinForWork();
+
+	/**
+	 *	Internal function to check, without taking anything, for work this thread could take. Called from this thread.
+	 *	@return true if any of the queues this thread takes work from looked non-empty.
+	 */
+	bool HasPendingWork();
+
+	/**
+	 *	Internal function to notify the system that I found work after spinning or stalling. Another thread is woken up to look for more if none is spinning.
+	 */
+	void NotifyFoundWork();
+
 	/** Array of queues, only the first one is used for unnamed threads. **/
 	FThreadTaskQueue Queue;
 
 	int32 PriorityIndex;
 };
 
+/** 
+ *	FWorkStealingTaskDeque
+ *	Fixed size Chase-Lev deque of anythread tasks owned by one task thread.
+ *	The owner pushes and pops at the bottom, so it runs the tasks it queued last while their data is still in cache.
+ *	Any other thread may steal from the top, taking the oldest task, which is usually the one that fans out the most.
+ *	Only the owner may call Push and Pop.
+**/
+class FWorkStealingTaskDeque
+{
+public:
+	enum
+	{
+		/** Tasks a deque holds before the owner has to queue to the shared queue instead. Must be a power of two. **/
+		Capacity = 1024
+	};
+
+	FWorkStealingTaskDeque()
+		: Top(0)
+		, Bottom(0)
+	{
+		static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+		YMemory::Memzero((void*)Tasks, sizeof(Tasks));
+	}
+
+	/** 
+	 *	Pushes a task at the bottom. Called from the owner only.
+	 *	@return false if the deque is full.
+	**/
+	FORCEINLINE bool Push(FBaseGraphTask* Task)
+	{
+		const int64 LocalBottom = Bottom;
+		if (LocalBottom - Top >= Capacity)
+		{
+			return false;
+		}
+		Tasks[LocalBottom & (Capacity - 1)] = Task;
+		YPlatformMisc::MemoryBarrier(); // the task must be visible before thieves can see the new bottom
+		Bottom = LocalBottom + 1;
+		return true;
+	}
+
+	/** 
+	 *	Pushes as many of the tasks as fit at the bottom, making them visible to thieves all at once. Called from the owner only.
+	 *	@return The number of tasks pushed, the first ones of the array.
+	**/
+	FORCEINLINE int32 PushMany(FBaseGraphTask* const* NewTasks, int32 NumTasks)
+	{
+		const int64 LocalBottom = Bottom;
+		const int32 NumToPush = (int32)YMath::Min<int64>(NumTasks, Capacity - (LocalBottom - Top));
+		for (int32 Index = 0; Index < NumToPush; Index++)
+		{
+			Tasks[(LocalBottom + Index) & (Capacity - 1)] = NewTasks[Index];
+		}
+		YPlatformMisc::MemoryBarrier(); // the tasks must be visible before thieves can see the new bottom
+		Bottom = LocalBottom + NumToPush;
+		return NumToPush;
+	}
+
+	/** 
+	 *	Pops the task pushed last. Called from the owner only.
+	 *	@return The task or nullptr if the deque is empty or the last task was stolen.
+	**/
+	FORCEINLINE FBaseGraphTask* Pop()
+	{
+		const int64 LocalBottom = Bottom - 1;
+		if (LocalBottom < Top)
+		{
+			// cheap early out, only the owner makes the deque grow
+			return nullptr;
+		}
+		FPlatformAtomics::InterlockedExchange(&Bottom, LocalBottom); // full barrier, a thief reading top after this sees the reservation
+		const int64 LocalTop = Top;
+		if (LocalTop > LocalBottom)
+		{
+			Bottom = LocalBottom + 1;
+			return nullptr;
+		}
+		FBaseGraphTask* Task = Tasks[LocalBottom & (Capacity - 1)];
+		if (LocalTop == LocalBottom)
+		{
+			// last task, race the thieves for it
+			if (FPlatformAtomics::InterlockedCompareExchange(&Top, LocalTop + 1, LocalTop) != LocalTop)
+			{
+				Task = nullptr;
+			}
+			Bottom = LocalBottom + 1;
+		}
+		return Task;
+	}
+
+	/** 
+	 *	Steals the task pushed first. Can be called from any thread.
+	 *	@return The task or nullptr if the deque is empty or another thread won the race for the task.
+	**/
+	FORCEINLINE FBaseGraphTask* Steal()
+	{
+		const int64 LocalTop = Top;
+		YPlatformMisc::MemoryBarrier();
+		const int64 LocalBottom = Bottom;
+		if (LocalTop >= LocalBottom)
+		{
+			return nullptr;
+		}
+		FBaseGraphTask* Task = Tasks[LocalTop & (Capacity - 1)];
+		if (FPlatformAtomics::InterlockedCompareExchange(&Top, LocalTop + 1, LocalTop) != LocalTop)
+		{
+			return nullptr;
+		}
+		return Task;
+	}
+
+	/** @return true if the deque looked empty. Only a hint unless called from the owner. **/
+	FORCEINLINE bool IsEmpty() const
+	{
+		return Bottom <= Top;
+	}
+
+private:
+	/** Next task to steal. **/
+	volatile int64 Top;
+	uint8 PadToAvoidContention1[PLATFORM_CACHE_LINE_SIZE - sizeof(int64)];
+	/** Next free slot, only written by the owner. **/
+	volatile int64 Bottom;
+	uint8 PadToAvoidContention2[PLATFORM_CACHE_LINE_SIZE - sizeof(int64)];
+	FBaseGraphTask* volatile Tasks[Capacity];
+};
+
 /** 
  *	FTaskGraphImplementation
  *	Implementation of the centralized part of the task graph system.
@@ -1374,6 +1555,19 @@ struct FWorkerThread
 	}
 };
 
+/** How task threads are pinned to the processors, chosen with -TaskGraphAffinity= on the command line */
+enum class ETaskThreadPlacement : uint8
+{
+	/** Task threads run anywhere the task graph thread mask allows */
+	None,
+	/** Each task thread runs on one physical core and its SMT siblings */
+	Core,
+	/** Each task thread runs on the cores sharing the last level cache of its core */
+	CacheDomain,
+	/** Each task thread runs on the NUMA node of its core */
+	Node,
+};
+
 class FTaskGraphImplementation : public FTaskGraphInterface  
 {
 public:
@@ -1398,9 +1592,14 @@ public:
 	{
 		bCreatedHiPriorityThreads = !!ENamedThreads::bHasHighPriorityThreads;
 		bCreatedBackgroundPriorityThreads = !!ENamedThreads::bHasBackgroundThreads;
+		bSpinWhenIdle = YPlatformMisc::NumberOfCoresIncludingHyperthreads() > 1;
+
+		YPlatformMisc::GetProcessorTopology(Processors);
+		Placement = ParseTaskThreadPlacement();
 
 		int32 MaxTaskThreads = MAX_THREADS;
-		int32 NumTaskThreads = YPlatformMisc::NumberOfWorkerThreadsToSpawn();
+		// the topology only has the processors we are allowed to run on, so it may have fewer cores than the machine
+		int32 NumTaskThreads = YMath::Max(YMath::Min(YPlatformMisc::NumberOfWorkerThreadsToSpawn(), CountTopologyCores() - 1), 1);
 
 		// if we don't want any performance-based threads, then force the task graph to not create any worker threads, and run in game thread
 		if (!FPlatformProcess::SupportsMultithreading())
@@ -1425,6 +1624,12 @@ public:
 
 		NumTaskThreadSets = 1 + bCreatedHiPriorityThreads + bCreatedBackgroundPriorityThreads;
 
+		int32 NumTaskThreadsFromCommandLine = 0;
+		if (FPlatformProcess::SupportsMultithreading() && FParse::Value(FCommandLine::Get(), TEXT("TaskGraphWorkers="), NumTaskThreadsFromCommandLine) && NumTaskThreadsFromCommandLine > 0)
+		{
+			NumTaskThreads = YMath::Min(NumTaskThreadsFromCommandLine, (MAX_THREADS - NumNamedThreads) / NumTaskThreadSets);
+		}
+
 		// if we don't have enough threads to allow all of the sets asked for, then we can't create what was asked for.
 		check(NumTaskThreadSets == 1 || YMath::Min<int32>(NumTaskThreads * NumTaskThreadSets + NumNamedThreads, MAX_THREADS) == NumTaskThreads * NumTaskThreadSets + NumNamedThreads);
 		NumThreads = YMath::Max<int32>(YMath::Min<int32>(NumTaskThreads * NumTaskThreadSets + NumNamedThreads, MAX_THREADS), NumNamedThreads + 1);
@@ -1437,6 +1642,8 @@ public:
 		NumTaskThreadsPerSet = (NumThreads - NumNamedThreads) / NumTaskThreadSets;
 		check((NumThreads - NumNamedThreads) % NumTaskThreadSets == 0); // should be equal numbers of threads per priority set
 
+		SetupTaskThreadPlacement();
+
 		UE_LOG(LogTaskGraph, Log, TEXT("Started task graph with %d named threads and %d total threads with %d sets of task threads."), NumNamedThreads, NumThreads, NumTaskThreadSets);
 		check(NumThreads - NumNamedThreads >= 1);  // need at least one pure worker thread
 		check(NumThreads <= MAX_THREADS);
@@ -1482,7 +1689,8 @@ public:
 				ThreadPri = TPri_BelowNormal; // we want normal tasks below normal threads like the game thread
 			}
 			uint32 StackSize = 384 * 1024;
-			WorkerThreads[ThreadIndex].RunnableThread = FRunnableThread::Create(&Thread(ThreadIndex), *Name, StackSize, ThreadPri, FPlatformAffinity::GetTaskGraphThreadMask()); // these are below normal threads so that they sleep when the named threads are active
+			const uint64 AffinityMask = TaskThreadAffinity[(ThreadIndex - NumNamedThreads) % NumTaskThreadsPerSet];
+			WorkerThreads[ThreadIndex].RunnableThread = FRunnableThread::Create(&Thread(ThreadIndex), *Name, StackSize, ThreadPri, AffinityMask); // these are below normal threads so that they sleep when the named threads are active
 			WorkerThreads[ThreadIndex].bAttached = true;
 		}
 	}
@@ -1587,19 +1795,25 @@ public:
 			TASKGRAPH_SCOPE_CYCLE_COUNTER(3, STAT_TaskGraph_QueueTask_AnyThread);
 			if (FPlatformProcess::SupportsMultithreading())
 			{
-				int32 TaskPriority = ENamedThreads::GetTaskPriority(Task->ThreadToExecuteOn);
-				int32 Priority = ENamedThreads::GetThreadPriorityIndex(Task->ThreadToExecuteOn);
-				if (Priority == (ENamedThreads::BackgroundThreadPriority >> ENamedThreads::ThreadPriorityShift) && (!bCreatedBackgroundPriorityThreads || !ENamedThreads::bHasBackgroundThreads))
-				{
-					Priority = ENamedThreads::NormalThreadPriority >> ENamedThreads::ThreadPriorityShift; // we don't have background threads, promote to normal
-					TaskPriority = ENamedThreads::NormalTaskPriority >> ENamedThreads::TaskPriorityShift; // demote to normal task pri
-				}
-				else if (Priority == (ENamedThreads::HighThreadPriority >> ENamedThreads::ThreadPriorityShift) && (!bCreatedHiPriorityThreads || !ENamedThreads::bHasHighPriorityThreads))
+				int32 Priority;
+				int32 TaskPriority;
+				GetAnyThreadPriorities(Task->ThreadToExecuteOn, Priority, TaskPriority);
+
+				if (!TaskPriority && GUseWorkStealing && !GFastSchedulerLatched)
 				{
-					Priority = ENamedThreads::NormalThreadPriority >> ENamedThreads::ThreadPriorityShift; // we don't have hi priority threads, demote to normal
-					TaskPriority = ENamedThreads::HighTaskPriority >> ENamedThreads::TaskPriorityShift; // promote to hi task pri
+					// tasks queued from a task thread of the right priority go to its own deque
+					int32 CurrentThreadIndex = ENamedThreads::GetThreadIndex(InCurrentThreadIfKnown);
+					if (CurrentThreadIndex == ENamedThreads::AnyThread)
+					{
+						CurrentThreadIndex = ENamedThreads::GetThreadIndex(GetCurrentThread());
+					}
+					if (CurrentThreadIndex != ENamedThreads::AnyThread && CurrentThreadIndex >= NumNamedThreads && 
+						ThreadIndexToPriorityIndex(CurrentThreadIndex) == Priority && LocalAnyThreadTasks[CurrentThreadIndex].Push(Task))
+					{
+						WakeThreadToSteal(Priority, CurrentThreadIndex);
+						return;
+					}
 				}
-				check(Priority >= 0 && Priority < MAX_THREAD_PRIORITIES);
 
 				{
 					TASKGRAPH_SCOPE_CYCLE_COUNTER(4, STAT_TaskGraph_QueueTask_IncomingAnyThreadTasks_Push);
@@ -1622,6 +1836,12 @@ public:
 				}
 				else
 				{
+					YPlatformMisc::MemoryBarrier(); // pairs with the barrier in SpinForWork
+					if (NumSpinningThreads[Priority].GetValue())
+					{
+						// a spinning thread will pick it up
+						return;
+					}
 					ENamedThreads::Type CurrentThreadIfKnown = ENamedThreads::AnyThread;
 					if (ENamedThreads::GetThreadIndex(InCurrentThreadIfKnown) == ENamedThreads::AnyThread)
 					{
@@ -1690,6 +1910,33 @@ public:
 	}
 
 
+	virtual void QueueTasks(FBaseGraphTask* const* Tasks, int32 NumTasks, ENamedThreads::Type ThreadToExecuteOn, ENamedThreads::Type InCurrentThreadIfKnown = ENamedThreads::AnyThread) final override
+	{
+		int32 NumPushed = 0;
+		if (NumTasks > 1 && ENamedThreads::GetThreadIndex(ThreadToExecuteOn) == ENamedThreads::AnyThread && FPlatformProcess::SupportsMultithreading() && GUseWorkStealing && !GFastSchedulerLatched)
+		{
+			int32 Priority;
+			int32 TaskPriority;
+			GetAnyThreadPriorities(ThreadToExecuteOn, Priority, TaskPriority);
+			int32 CurrentThreadIndex = ENamedThreads::GetThreadIndex(InCurrentThreadIfKnown);
+			if (CurrentThreadIndex == ENamedThreads::AnyThread)
+			{
+				CurrentThreadIndex = ENamedThreads::GetThreadIndex(GetCurrentThread());
+			}
+			if (!TaskPriority && CurrentThreadIndex != ENamedThreads::AnyThread && CurrentThreadIndex >= NumNamedThreads && ThreadIndexToPriorityIndex(CurrentThreadIndex) == Priority)
+			{
+				NumPushed = LocalAnyThreadTasks[CurrentThreadIndex].PushMany(Tasks, NumTasks);
+				// this thread runs one of them, the others are for thieves
+				WakeThreadsToSteal(Priority, CurrentThreadIndex, NumPushed - 1);
+			}
+		}
+		// whatever did not fit in the deque, or cannot use it, is queued one task at a time
+		for (int32 Index = NumPushed; Index < NumTasks; Index++)
+		{
+			QueueTask(Tasks[Index], ThreadToExecuteOn, InCurrentThreadIfKnown);
+		}
+	}
+
 	virtual	int32 GetNumWorkerThreads() final override
 	{
 		int32 Result = (NumThreads - NumNamedThreads) / NumTaskThreadSets - GNumWorkerThreadsToIgnore;
@@ -2111,6 +2358,14 @@ public:
 				}
 			} while (!IncomingAnyThreadTasksHiPri[Priority].IsEmpty() || !SortedAnyThreadTasksHiPri[Priority].IsEmpty());
 		}
+		{
+			// newest task of our own, it most likely shares data with what we just did
+			FBaseGraphTask* Task = LocalAnyThreadTasks[ThreadInNeed].Pop();
+			if (Task)
+			{
+				return Task;
+			}
+		}
 		{
 			FBaseGraphTask* Task = SortedAnyThreadTasks[Priority].Pop();
 			if (Task)
@@ -2158,7 +2413,7 @@ public:
 				}
 			}
 		} while (!IncomingAnyThreadTasks[Priority].IsEmpty() || !SortedAnyThreadTasks[Priority].IsEmpty());
-		return nullptr;
+		return StealWork(ThreadInNeed);
 	}
 
 #endif
@@ -2183,6 +2438,167 @@ public:
 		}
 	}
 
+	/** 
+	 *	Steals the oldest task from the deque of another task thread of the same priority, in the order set up by SetupTaskThreadPlacement.
+	 *	@param	ThreadInNeed; Id of the thread requesting work.
+	 *	@return Task that was stolen if any was found.
+	**/
+	FBaseGraphTask* StealWork(ENamedThreads::Type ThreadInNeed)
+	{
+		const int32 MyIndex = (int32(ThreadInNeed) - NumNamedThreads) % NumTaskThreadsPerSet;
+		const int32 FirstThreadInSet = int32(ThreadInNeed) - MyIndex;
+		for (int32 Offset = 0; Offset < NumTaskThreadsPerSet - 1; Offset++)
+		{
+			FWorkStealingTaskDeque& Victim = LocalAnyThreadTasks[FirstThreadInSet + StealOrder[MyIndex][Offset]];
+			while (!Victim.IsEmpty())
+			{
+				FBaseGraphTask* Task = Victim.Steal();
+				if (Task)
+				{
+					return Task;
+				}
+				// lost the race to another thread, the victim may still have more
+			}
+		}
+		return nullptr;
+	}
+
+	/** 
+	 *	Called from a task thread that ran out of work, checks the queues for a while before it stalls.
+	 *	Spinning threads are counted so that queuing a task does not need to wake anyone up while one of them is looking.
+	 *	@param	ThreadInNeed; Id of the thread that ran out of work.
+	 *	@return true if there might be work now.
+	**/
+	bool SpinForWork(ENamedThreads::Type ThreadInNeed)
+	{
+		if (GFastSchedulerLatched || GWorkerSpinCount <= 0 || !bSpinWhenIdle)
+		{
+			return false;
+		}
+		const int32 Priority = ThreadIndexToPriorityIndex(ThreadInNeed);
+		NumSpinningThreads[Priority].Increment();
+		bool bFoundWork = false;
+		for (int32 Index = 0; Index < GWorkerSpinCount && !bFoundWork; Index++)
+		{
+			bFoundWork = HasPendingWork(ThreadInNeed);
+			if ((Index & 63) == 63)
+			{
+				FPlatformProcess::SleepNoStats(0.0f);
+			}
+		}
+		// the decrement is a full barrier; a thread that queues after it sees no spinner and wakes somebody up, 
+		// and if we go on to stall we check the queues again after posting our stall hint
+		NumSpinningThreads[Priority].Decrement();
+		return bFoundWork;
+	}
+
+	/** 
+	 *	@param	ThreadInNeed; Id of the task thread asking.
+	 *	@return true if any queue the thread takes work from looked non-empty. Always false with the fast scheduler, which does its own bookkeeping.
+	**/
+	bool HasPendingWork(ENamedThreads::Type ThreadInNeed)
+	{
+		if (GFastSchedulerLatched)
+		{
+			return false;
+		}
+		const int32 Priority = ThreadIndexToPriorityIndex(ThreadInNeed);
+		YPlatformMisc::MemoryBarrier();
+		if (!IncomingAnyThreadTasksHiPri[Priority].IsEmpty() || !IncomingAnyThreadTasks[Priority].IsEmpty())
+		{
+			return true;
+		}
+#if !USE_NEW_LOCK_FREE_LISTS
+		if (!SortedAnyThreadTasksHiPri[Priority].IsEmpty() || !SortedAnyThreadTasks[Priority].IsEmpty())
+		{
+			return true;
+		}
+#endif
+		const int32 FirstThreadInSet = Priority * NumTaskThreadsPerSet + NumNamedThreads;
+		for (int32 Index = 0; Index < NumTaskThreadsPerSet; Index++)
+		{
+			if (!LocalAnyThreadTasks[FirstThreadInSet + Index].IsEmpty())
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** 
+	 *	Hint from a worker thread that found work after spinning or stalling. Keeps one thread looking while there might be more.
+	 *	@param	FoundThread; Id of the thread that found work.
+	**/
+	void NotifyFoundWork(ENamedThreads::Type FoundThread)
+	{
+		if (!GFastSchedulerLatched)
+		{
+			WakeThreadToSteal(ThreadIndexToPriorityIndex(FoundThread), FoundThread);
+		}
+	}
+
+	/** 
+	 *	Wakes up a stalled task thread after a task was pushed to a deque, unless a spinning thread will find the task anyway.
+	 *	No thread is woken up when none posted a stall hint: a thread posts its hint before it checks the queues for the last time, 
+	 *	so every thread is either running, spinning, or going to see the task.
+	 *	@param	Priority; Priority set of the task.
+	 *	@param	CurrentThread; Id of the thread that queued the task, it is never woken up.
+	**/
+	void WakeThreadToSteal(int32 Priority, int32 CurrentThread)
+	{
+		WakeThreadsToSteal(Priority, CurrentThread, 1);
+	}
+
+	/** 
+	 *	Wakes up to NumToWake stalled task threads of a priority to steal work just pushed to the deque of the current thread. Threads that are spinning count as woken.
+	 *	@param	Priority; the priority set of the current thread.
+	 *	@param	CurrentThread; index of the current thread.
+	 *	@param	NumToWake; the most threads that could find something to steal.
+	**/
+	void WakeThreadsToSteal(int32 Priority, int32 CurrentThread, int32 NumToWake)
+	{
+		YPlatformMisc::MemoryBarrier(); // pairs with the barriers in SpinForWork and HasPendingWork
+		NumToWake -= NumSpinningThreads[Priority].GetValue();
+		while (NumToWake > 0)
+		{
+			FTaskThreadBase* Target;
+			do
+			{
+				Target = StalledUnnamedThreads[Priority].Pop();
+			}
+			while (Target && Target->GetThreadId() == CurrentThread); // our own hint is stale, we are obviously running
+			if (!Target)
+			{
+				break;
+			}
+			Target->WakeUp();
+			NumToWake--;
+		}
+	}
+
+	/** 
+	 *	Works out the set of task threads an anythread task runs on and its priority within the set. Sets that were not created fall back to the normal one.
+	 *	@param	ThreadToExecuteOn; the thread and priorities the task was queued with.
+	 *	@param	OutPriority; the index of the set of task threads.
+	 *	@param	OutTaskPriority; nonzero for high priority tasks.
+	**/
+	void GetAnyThreadPriorities(ENamedThreads::Type ThreadToExecuteOn, int32& OutPriority, int32& OutTaskPriority)
+	{
+		OutTaskPriority = ENamedThreads::GetTaskPriority(ThreadToExecuteOn);
+		OutPriority = ENamedThreads::GetThreadPriorityIndex(ThreadToExecuteOn);
+		if (OutPriority == (ENamedThreads::BackgroundThreadPriority >> ENamedThreads::ThreadPriorityShift) && (!bCreatedBackgroundPriorityThreads || !ENamedThreads::bHasBackgroundThreads))
+		{
+			OutPriority = ENamedThreads::NormalThreadPriority >> ENamedThreads::ThreadPriorityShift; // we don't have background threads, promote to normal
+			OutTaskPriority = ENamedThreads::NormalTaskPriority >> ENamedThreads::TaskPriorityShift; // demote to normal task pri
+		}
+		else if (OutPriority == (ENamedThreads::HighThreadPriority >> ENamedThreads::ThreadPriorityShift) && (!bCreatedHiPriorityThreads || !ENamedThreads::bHasHighPriorityThreads))
+		{
+			OutPriority = ENamedThreads::NormalThreadPriority >> ENamedThreads::ThreadPriorityShift; // we don't have hi priority threads, demote to normal
+			OutTaskPriority = ENamedThreads::HighTaskPriority >> ENamedThreads::TaskPriorityShift; // promote to hi task pri
+		}
+		check(OutPriority >= 0 && OutPriority < MAX_THREAD_PRIORITIES);
+	}
+
 	void SetTaskThreadPriorities(EThreadPriority Pri)
 	{
 		check(NumTaskThreadSets == 1); // otherwise tuning this doesn't make a lot of sense
@@ -2195,6 +2611,29 @@ public:
 		}
 	}
 
+	/** Logs the processors we can run on, then the affinity and steal order of the task threads of each set. */
+	void LogTopology()
+	{
+		static const TCHAR* PlacementNames[] = { TEXT("none"), TEXT("core"), TEXT("cache"), TEXT("node") };
+		UE_LOG(LogConsoleResponse, Display, TEXT("%d processors in %d cores, %d task threads per set, placement %s:"),
+			Processors.Num(), CountTopologyCores(), NumTaskThreadsPerSet, PlacementNames[(int32)Placement]);
+		for (const FProcessorTopology& Processor : Processors)
+		{
+			UE_LOG(LogConsoleResponse, Display, TEXT("  Processor %3d: core %3d, cache domain %2d, node %d"),
+				Processor.LogicalId, Processor.CoreId, Processor.CacheDomainId, Processor.NodeId);
+		}
+		for (int32 Index = 0; Index < NumTaskThreadsPerSet; Index++)
+		{
+			YString Victims;
+			for (int32 Offset = 0; Offset < NumTaskThreadsPerSet - 1; Offset++)
+			{
+				Victims += YString::Printf(Offset ? TEXT(" %d") : TEXT("%d"), StealOrder[Index][Offset]);
+			}
+			UE_LOG(LogConsoleResponse, Display, TEXT("  Task thread %2d: affinity 0x%016llx, steals from %s"),
+				Index, (unsigned long long)TaskThreadAffinity[Index], Victims.Len() ? *Victims : TEXT("nobody"));
+		}
+	}
+
 private:
 
 	// Internals
@@ -2237,6 +2676,128 @@ private:
 		return CurrentThreadIfKnown;
 	}
 
+	/** Reads -TaskGraphAffinity=none|core|cache|node from the command line. */
+	static ETaskThreadPlacement ParseTaskThreadPlacement()
+	{
+		YString PlacementName;
+		if (!FParse::Value(FCommandLine::Get(), TEXT("TaskGraphAffinity="), PlacementName))
+		{
+			return ETaskThreadPlacement::None;
+		}
+		if (PlacementName == TEXT("core"))
+		{
+			return ETaskThreadPlacement::Core;
+		}
+		if (PlacementName == TEXT("cache"))
+		{
+			return ETaskThreadPlacement::CacheDomain;
+		}
+		if (PlacementName == TEXT("node"))
+		{
+			return ETaskThreadPlacement::Node;
+		}
+		if (PlacementName != TEXT("none"))
+		{
+			UE_LOG(LogTaskGraph, Warning, TEXT("Unknown -TaskGraphAffinity=%s, expected none, core, cache or node."), *PlacementName);
+		}
+		return ETaskThreadPlacement::None;
+	}
+
+	/** @return the number of physical cores in Processors, which is sorted so that the processors of a core are next to each other. */
+	int32 CountTopologyCores() const
+	{
+		int32 NumCores = 0;
+		for (int32 Index = 0; Index < Processors.Num(); Index++)
+		{
+			NumCores += (Index == 0 || Processors[Index].CoreId != Processors[Index - 1].CoreId);
+		}
+		return YMath::Max(NumCores, 1);
+	}
+
+	/**
+	 *	Gives each task thread of a set a core and the matching affinity mask, then orders the threads each one steals from,
+	 *	nearest first: same core, same cache domain, same node, then the rest. Threads at the same distance keep the
+	 *	rotation starting with the next one along, which is the whole order when there is no placement.
+	 *	The cores go in topology order, skipping the first one which is left to the game thread, so neighbouring
+	 *	threads share caches. The same placement is used for every set.
+	**/
+	void SetupTaskThreadPlacement()
+	{
+		TArray<int32> CoreFirstProcessors;
+		for (int32 Index = 0; Index < Processors.Num(); Index++)
+		{
+			if (Index == 0 || Processors[Index].CoreId != Processors[Index - 1].CoreId)
+			{
+				CoreFirstProcessors.Add(Index);
+			}
+		}
+
+		int32 ThreadProcessors[MAX_THREADS];
+		for (int32 Index = 0; Index < NumTaskThreadsPerSet; Index++)
+		{
+			TaskThreadAffinity[Index] = FPlatformAffinity::GetTaskGraphThreadMask();
+			ThreadProcessors[Index] = INDEX_NONE;
+			if (Placement == ETaskThreadPlacement::None || CoreFirstProcessors.Num() == 0)
+			{
+				continue;
+			}
+			const int32 NumCores = CoreFirstProcessors.Num();
+			ThreadProcessors[Index] = CoreFirstProcessors[(Index + (NumCores > 1 ? 1 : 0)) % NumCores];
+			const FProcessorTopology& Home = Processors[ThreadProcessors[Index]];
+
+			uint64 Mask = 0;
+			for (const FProcessorTopology& Processor : Processors)
+			{
+				const bool bShared =
+					Placement == ETaskThreadPlacement::Core ? Processor.CoreId == Home.CoreId :
+					Placement == ETaskThreadPlacement::CacheDomain ? Processor.CacheDomainId == Home.CacheDomainId :
+					Processor.NodeId == Home.NodeId;
+				if (bShared && Processor.LogicalId < 64)
+				{
+					Mask |= uint64(1) << Processor.LogicalId;
+				}
+			}
+			// processors past the end of the mask cannot be pinned to, threads placed there stay unpinned
+			Mask &= FPlatformAffinity::GetTaskGraphThreadMask();
+			if (Mask)
+			{
+				TaskThreadAffinity[Index] = Mask;
+			}
+		}
+
+		for (int32 Index = 0; Index < NumTaskThreadsPerSet; Index++)
+		{
+			int32 NumVictims = 0;
+			for (int32 Distance = 0; Distance < 4; Distance++)
+			{
+				for (int32 Offset = 1; Offset < NumTaskThreadsPerSet; Offset++)
+				{
+					const int32 Victim = (Index + Offset) % NumTaskThreadsPerSet;
+					int32 VictimDistance = 0;
+					if (ThreadProcessors[Index] != INDEX_NONE && ThreadProcessors[Victim] != INDEX_NONE)
+					{
+						const FProcessorTopology& Mine = Processors[ThreadProcessors[Index]];
+						const FProcessorTopology& Theirs = Processors[ThreadProcessors[Victim]];
+						VictimDistance =
+							Mine.CoreId == Theirs.CoreId ? 0 :
+							Mine.CacheDomainId == Theirs.CacheDomainId ? 1 :
+							Mine.NodeId == Theirs.NodeId ? 2 : 3;
+					}
+					if (VictimDistance == Distance)
+					{
+						StealOrder[Index][NumVictims++] = Victim;
+					}
+				}
+			}
+			check(NumVictims == NumTaskThreadsPerSet - 1);
+		}
+
+		if (Placement != ETaskThreadPlacement::None)
+		{
+			UE_LOG(LogTaskGraph, Log, TEXT("Pinned %d task threads per set over %d cores."), NumTaskThreadsPerSet, CoreFirstProcessors.Num());
+		}
+	}
+
 	int32 ThreadIndexToPriorityIndex(int32 ThreadIndex)
 	{
 		check(ThreadIndex >= NumNamedThreads && ThreadIndex < NumThreads);
@@ -2279,6 +2840,20 @@ private:
 	uint32				PerThreadIDTLSSlot;
 	/** Thread safe list of stalled thread "Hints". **/
 	TLockFreePointerListUnordered<FTaskThreadBase, PLATFORM_CACHE_LINE_SIZE>		StalledUnnamedThreads[MAX_THREAD_PRIORITIES];
+	/** Number of task threads looking for work in SpinForWork. **/
+	FThreadSafeCounter	NumSpinningThreads[MAX_THREAD_PRIORITIES];
+	/** false on single core machines, where spinning only keeps the thread that would queue work from running. **/
+	bool				bSpinWhenIdle;
+	/** Anythread tasks queued from each task thread, indexed by thread id. Unused for named threads. **/
+	FWorkStealingTaskDeque	LocalAnyThreadTasks[MAX_THREADS];
+	/** Processors we may run on, sorted by node, cache domain and core. **/
+	TArray<FProcessorTopology> Processors;
+	/** How task threads are pinned, from -TaskGraphAffinity= on the command line. **/
+	ETaskThreadPlacement	Placement;
+	/** Affinity mask of the task threads, by index in their set. **/
+	uint64				TaskThreadAffinity[MAX_THREADS];
+	/** For each task thread of a set, the other threads of the set in the order it steals from them. **/
+	int32				StealOrder[MAX_THREADS][MAX_THREADS];
 
 	/** Array of callbacks to call before shutdown. **/
 	TArray<TFunction<void()> > ShutdownCallbacks;
@@ -2417,6 +2992,21 @@ void FTaskThreadAnyThread::NotifyStalling()
 	return FTaskGraphImplementation::Get().NotifyStalling(ThreadId);
 }
 
+bool FTaskThreadAnyThread::SpinForWork()
+{
+	return FTaskGraphImplementation::Get().SpinForWork(ThreadId);
+}
+
+bool FTaskThreadAnyThread::HasPendingWork()
+{
+	return FTaskGraphImplementation::Get().HasPendingWork(ThreadId);
+}
+
+void FTaskThreadAnyThread::NotifyFoundWork()
+{
+	FTaskGraphImplementation::Get().NotifyFoundWork(ThreadId);
+}
+
 
 
 // Statics in FTaskGraphInterface
@@ -2599,6 +3189,9 @@ void FGraphEvent::Reset()
 	EventsToWaitFor.Empty();  // we will let the memory block free here if there is one; these are not common
 	// checkThreadGraph(!LockFreePointerQueueNext); // temp
 	bComplete= false;
+#if TASKGRAPH_TRACE
+	TraceTaskId = 0;
+#endif
 }
 
 #else
@@ -2820,6 +3413,8 @@ void FTaskGraphInterface::BroadcastSlow_OnlyUseForSpecialPurposes(bool bDoTaskTh
 // Benchmark
 
 #include "Async/ParallelFor.h"
+#include "Async/ParallelSort.h"
+#include "Templates/RadixSort.h"
 
 static FORCEINLINE void DoWork(void* Hash, FThreadSafeCounter& Counter, FThreadSafeCounter& Cycles, int32 Work)
 {
@@ -2900,6 +3495,46 @@ private:
 	bool *Out;
 };
 
+class FSpawnGraphTask : public FCustomStatIDGraphTaskBase
+{
+public:
+	FORCEINLINE FSpawnGraphTask(FThreadSafeCounter& InCounter, FThreadSafeCounter& InCycles, int32 InDepth, int32 InWork)
+		: FCustomStatIDGraphTaskBase(TStatId())
+		, Counter(InCounter)
+		, Cycles(InCycles)
+		, Depth(InDepth)
+		, Work(InWork)
+	{
+	}
+	static FORCEINLINE ENamedThreads::Type GetDesiredThread()
+	{
+		return ENamedThreads::AnyThread;
+	}
+	static FORCEINLINE ESubsequentsMode::Type GetSubsequentsMode() { return ESubsequentsMode::FireAndForget; }
+	void FORCEINLINE DoTask(ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+	{
+		if (Depth > 0)
+		{
+			for (int32 Index = 0; Index < 8; Index++)
+			{
+				TGraphTask<FSpawnGraphTask>::CreateTask(nullptr, CurrentThread).ConstructAndDispatchWhenReady(Counter, Cycles, Depth - 1, Work);
+			}
+		}
+		DoWork(this, Counter, Cycles, Work);
+	}
+
+	/** @return the number of tasks in a tree of the given depth **/
+	static int32 NumTasks(int32 InDepth)
+	{
+		return InDepth > 0 ? 1 + 8 * NumTasks(InDepth - 1) : 1;
+	}
+private:
+	FThreadSafeCounter& Counter;
+	FThreadSafeCounter& Cycles;
+	int32 Depth;
+	int32 Work;
+};
+
 
 void PrintResult(double& StartTime, double& QueueTime, double& EndTime, double& JoinTime, FThreadSafeCounter& Counter, FThreadSafeCounter& Cycles, const TCHAR* Message)
 {
@@ -2917,32 +3552,12 @@ void PrintResult(double& StartTime, double& QueueTime, double& EndTime, double&
 	JoinTime = 0.0;
 }
 
-static void TaskGraphBenchmark(const TArray<YString>& Args)
+static void TaskGraphBenchmarkPass()
 {
 	double StartTime, QueueTime, EndTime, JoinTime;
 	FThreadSafeCounter Counter;
 	FThreadSafeCounter Cycles;
 	
-	if (Args.Num() == 1 && Args[0] == TEXT("infinite"))
-	{
-		while (true)
-		{
-			{
-				StartTime = FPlatformTime::Seconds();
-
-				ParallelFor(1000, 
-					[&Counter, &Cycles](int32 Index)
-				{
-					TGraphTask<FIncGraphTaskGT>::CreateTask().ConstructAndDispatchWhenReady(Counter, Cycles, -1);
-				}
-				);
-				QueueTime = FPlatformTime::Seconds();
-				JoinTime = QueueTime;
-				FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread_Local);
-				EndTime = FPlatformTime::Seconds();
-			}
-		}
-	}
 	{
 		StartTime = FPlatformTime::Seconds();
 		FGraphEventArray Tasks;
@@ -3107,6 +3722,40 @@ static void TaskGraphBenchmark(const TArray<YString>& Args)
 	}
 	PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, TEXT("1000 tasks, GT submit, counter tracking, with work"));
 
+	for (int32 Work = 0; Work <= 1000; Work += 1000)
+	{
+		{
+			StartTime = FPlatformTime::Seconds();
+			for (int32 Index = 0; Index < 10000; Index++)
+			{
+				TGraphTask<FIncGraphTask>::CreateTask(nullptr, ENamedThreads::GameThread).ConstructAndDispatchWhenReady(Counter, Cycles, Work);
+			}
+			QueueTime = FPlatformTime::Seconds();
+			JoinTime = QueueTime;
+			while (Counter.GetValue() < 10000)
+			{
+				FPlatformProcess::Sleep(0.0f);
+			}
+			EndTime = FPlatformTime::Seconds();
+		}
+		PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, Work ? TEXT("10000 tasks, GT submit, counter tracking, with work") : TEXT("10000 tasks, GT submit, counter tracking"));
+		{
+			StartTime = FPlatformTime::Seconds();
+			FGraphEventRef Batch = TGraphTaskBatch<FIncGraphTask>::CreateAndDispatchWhenReady(10000,
+				[&Counter, &Cycles, Work](int32 Index)
+				{
+					return FIncGraphTask(Counter, Cycles, Work);
+				},
+				nullptr, ENamedThreads::GameThread);
+			QueueTime = FPlatformTime::Seconds();
+			JoinTime = QueueTime;
+			FTaskGraphInterface::Get().WaitUntilTaskCompletes(Batch, ENamedThreads::GameThread_Local);
+			EndTime = FPlatformTime::Seconds();
+			check(Counter.GetValue() == 10000);
+		}
+		PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, Work ? TEXT("10000 tasks, GT submit, batched, with work") : TEXT("10000 tasks, GT submit, batched"));
+	}
+
 	{
 		StartTime = FPlatformTime::Seconds();
 
@@ -3123,6 +3772,31 @@ static void TaskGraphBenchmark(const TArray<YString>& Args)
 	}
 	PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, TEXT("1000 GT tasks, ParallelFor, no tracking (none needed)"));
 
+	{
+		StartTime = FPlatformTime::Seconds();
+		TGraphTask<FSpawnGraphTask>::CreateTask().ConstructAndDispatchWhenReady(Counter, Cycles, 4, 0);
+		QueueTime = FPlatformTime::Seconds();
+		JoinTime = QueueTime;
+		while (Counter.GetValue() < FSpawnGraphTask::NumTasks(4))
+		{
+			FPlatformProcess::Sleep(0.0f);
+		}
+		EndTime = FPlatformTime::Seconds();
+	}
+	PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, TEXT("4681 tasks, each spawning 8 from a task thread, counter tracking"));
+	{
+		StartTime = FPlatformTime::Seconds();
+		TGraphTask<FSpawnGraphTask>::CreateTask().ConstructAndDispatchWhenReady(Counter, Cycles, 4, 1000);
+		QueueTime = FPlatformTime::Seconds();
+		JoinTime = QueueTime;
+		while (Counter.GetValue() < FSpawnGraphTask::NumTasks(4))
+		{
+			FPlatformProcess::Sleep(0.0f);
+		}
+		EndTime = FPlatformTime::Seconds();
+	}
+	PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, TEXT("4681 tasks, each spawning 8 from a task thread, counter tracking, with work"));
+
 
 	{
 		StartTime = FPlatformTime::Seconds();
@@ -3165,14 +3839,211 @@ static void TaskGraphBenchmark(const TArray<YString>& Args)
 		EndTime = FPlatformTime::Seconds();
 	}
 	PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, TEXT("1000 element ParallelFor, single threaded, with work"));
+	{
+		StartTime = FPlatformTime::Seconds();
+		QueueTime = StartTime;
+		JoinTime = QueueTime;
+		ParallelForRange(1000, 
+			[&Counter, &Cycles](int32 Begin, int32 End)
+			{
+				for (int32 Index = Begin; Index < End; Index++)
+				{
+					DoWork(&Counter, Counter, Cycles, 1000);
+				}
+			}
+		);
+		EndTime = FPlatformTime::Seconds();
+	}
+	PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, TEXT("1000 element ParallelForRange, with work"));
+
+	{
+		StartTime = FPlatformTime::Seconds();
+		QueueTime = StartTime;
+		JoinTime = QueueTime;
+		ParallelFor(1000, 
+			[&Counter, &Cycles](int32 Index)
+			{
+				DoWork(&Counter, Counter, Cycles, Index * 2);
+			}
+		);
+		EndTime = FPlatformTime::Seconds();
+	}
+	PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, TEXT("1000 element ParallelFor, uneven work"));
+	{
+		StartTime = FPlatformTime::Seconds();
+		QueueTime = StartTime;
+		JoinTime = QueueTime;
+		ParallelForRange(1000, 
+			[&Counter, &Cycles](int32 Begin, int32 End)
+			{
+				for (int32 Index = Begin; Index < End; Index++)
+				{
+					DoWork(&Counter, Counter, Cycles, Index * 2);
+				}
+			}
+		);
+		EndTime = FPlatformTime::Seconds();
+	}
+	PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, TEXT("1000 element ParallelForRange, uneven work"));
+
+	{
+		TArray<int32> Values;
+		Values.AddUninitialized(1000000);
+		int32* ValueData = Values.GetData();
+
+		StartTime = FPlatformTime::Seconds();
+		QueueTime = StartTime;
+		JoinTime = QueueTime;
+		ParallelFor(Values.Num(), 
+			[ValueData](int32 Index)
+			{
+				ValueData[Index] = Index & 1023;
+			}
+		);
+		EndTime = FPlatformTime::Seconds();
+		PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, TEXT("1M element ParallelFor, fill"));
+
+		StartTime = FPlatformTime::Seconds();
+		QueueTime = StartTime;
+		JoinTime = QueueTime;
+		ParallelForRange(Values.Num(), 
+			[ValueData](int32 Begin, int32 End)
+			{
+				for (int32 Index = Begin; Index < End; Index++)
+				{
+					ValueData[Index] = Index & 1023;
+				}
+			}
+		);
+		EndTime = FPlatformTime::Seconds();
+		PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, TEXT("1M element ParallelForRange, fill"));
+
+		StartTime = FPlatformTime::Seconds();
+		QueueTime = StartTime;
+		JoinTime = QueueTime;
+		const int64 Sum = ParallelTransformReduce(Values.Num(), int64(0), 
+			[ValueData](int32 Index) { return int64(ValueData[Index]); }, 
+			[](int64 A, int64 B) { return A + B; }
+		);
+		EndTime = FPlatformTime::Seconds();
+		check(Sum == int64(1023) * 512 * (Values.Num() / 1024) + int64(Values.Num() % 1024) * (Values.Num() % 1024 - 1) / 2);
+		PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, TEXT("1M element ParallelTransformReduce, sum"));
+	}
+}
+
+static void TaskGraphBenchmark(const TArray<YString>& Args)
+{
+	double StartTime, QueueTime, EndTime, JoinTime;
+	FThreadSafeCounter Counter;
+	FThreadSafeCounter Cycles;
+
+	if (Args.Num() == 1 && Args[0] == TEXT("infinite"))
+	{
+		while (true)
+		{
+			{
+				StartTime = FPlatformTime::Seconds();
+
+				ParallelFor(1000, 
+					[&Counter, &Cycles](int32 Index)
+				{
+					TGraphTask<FIncGraphTaskGT>::CreateTask().ConstructAndDispatchWhenReady(Counter, Cycles, -1);
+				}
+				);
+				QueueTime = FPlatformTime::Seconds();
+				JoinTime = QueueTime;
+				FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread_Local);
+				EndTime = FPlatformTime::Seconds();
+			}
+		}
+	}
+	if (Args.Num() == 1 && Args[0] == TEXT("comparestealing"))
+	{
+		// anythread tasks queued from task threads go to the shared queue in the first pass and to the deques in the second
+		const int32 SavedUseWorkStealing = GUseWorkStealing;
+		for (int32 UseWorkStealing = 0; UseWorkStealing < 2; UseWorkStealing++)
+		{
+			GUseWorkStealing = UseWorkStealing;
+			UE_LOG(LogConsoleResponse, Display, TEXT("TaskGraph.UseWorkStealing %d"), GUseWorkStealing);
+			TaskGraphBenchmarkPass();
+		}
+		GUseWorkStealing = SavedUseWorkStealing;
+		return;
+	}
+	TaskGraphBenchmarkPass();
 }
 
 static FAutoConsoleCommand TaskGraphBenchmarkCmd(
 	TEXT("TaskGraph.Benchmark"),
-	TEXT("Prints the time to run 1000 no-op tasks."),
+	TEXT("Prints the time to run 1000 no-op tasks. Use 'comparestealing' to run it without and with TaskGraph.UseWorkStealing, 'infinite' to loop forever."),
 	FConsoleCommandWithArgsDelegate::CreateStatic(&TaskGraphBenchmark)
 	);
 
+static void SortBenchmark(const TArray<YString>& Args)
+{
+	const int32 Sizes[] = { 10000, 100000, 1000000, 4000000 };
+	const int32 MaxSize = Args.Num() ? YMath::Max(FCString::Atoi(*Args[0]), 1) : MAX_int32;
+
+	// Fewer cores are simulated by capping the number of chunks, which is the most tasks the sort runs at once
+	const int32 MaxThreads = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+
+	YRandomStream Stream(0x5eed);
+	TArray<uint32> Values;
+	TArray<uint32> Sorted;
+	for (int32 Size : Sizes)
+	{
+		if (Size > MaxSize)
+		{
+			break;
+		}
+		Values.Reset(Size);
+		for (int32 Index = 0; Index < Size; Index++)
+		{
+			Values.Add(Stream.GetUnsignedInt());
+		}
+
+		auto TimeSort = [&Values, &Sorted, Size](const TCHAR* Name, int32 NumThreads, TFunctionRef<void()> SortFunction)
+		{
+			Sorted = Values;
+			const double StartTime = FPlatformTime::Seconds();
+			SortFunction();
+			const double EndTime = FPlatformTime::Seconds();
+			for (int32 Index = 1; Index < Size; Index++)
+			{
+				check(Sorted[Index - 1] <= Sorted[Index]);
+			}
+			UE_LOG(LogConsoleResponse, Display, TEXT("%8d elements, %-18s %2d threads %8.2fms"), Size, Name, NumThreads, float(1000.0 * (EndTime - StartTime)));
+		};
+
+		TimeSort(TEXT("Sort"), 1, [&Sorted]() { Sorted.Sort(); });
+		if (Size <= 100000)
+		{
+			// the in place merge sort is quadratic enough to take minutes beyond this
+			TimeSort(TEXT("StableSort"), 1, [&Sorted]() { Sorted.StableSort(); });
+		}
+		TimeSort(TEXT("RadixSort"), 1, [&Sorted]() { RadixSort(Sorted); });
+		for (int32 NumThreads = 1; NumThreads <= MaxThreads; NumThreads *= 2)
+		{
+			TimeSort(TEXT("ParallelSort"), NumThreads, [&Sorted, NumThreads]()
+			{
+				UE4ParallelSort_Private::ParallelSortInternal(Sorted.GetData(), Sorted.Num(), TLess<uint32>(), false, NumThreads);
+			});
+			TimeSort(TEXT("ParallelStableSort"), NumThreads, [&Sorted, NumThreads]()
+			{
+				UE4ParallelSort_Private::ParallelSortInternal(Sorted.GetData(), Sorted.Num(), TLess<uint32>(), true, NumThreads);
+			});
+		}
+		TimeSort(TEXT("ParallelSort"), MaxThreads, [&Sorted]() { ParallelSort(Sorted); });
+		TimeSort(TEXT("ParallelStableSort"), MaxThreads, [&Sorted]() { ParallelStableSort(Sorted); });
+	}
+}
+
+static FAutoConsoleCommand SortBenchmarkCmd(
+	TEXT("TaskGraph.SortBenchmark"),
+	TEXT("Times Sort, StableSort and RadixSort against ParallelSort and ParallelStableSort capped at a growing number of threads, on up to 4M random integers. An optional argument caps the number of elements."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&SortBenchmark)
+	);
+
 static void SetTaskThreadPriority(const TArray<YString>& Args)
 {
 	EThreadPriority Pri = TPri_Normal;
@@ -3198,3 +4069,14 @@ static FAutoConsoleCommand TaskThreadPriorityCmd(
 	TEXT("Sets the priority of the task threads. Argument is one of belownormal, normal or abovenormal."),
 	FConsoleCommandWithArgsDelegate::CreateStatic(&SetTaskThreadPriority)
 	);
+
+static void LogTaskGraphTopology()
+{
+	FTaskGraphImplementation::Get().LogTopology();
+}
+
+static FAutoConsoleCommand TaskGraphTopologyCmd(
+	TEXT("TaskGraph.Topology"),
+	TEXT("Logs the processor topology, then the affinity and steal order of the task threads. Placement is set with -TaskGraphAffinity=none|core|cache|node and the number of task threads with -TaskGraphWorkers=N on the command line."),
+	FConsoleCommandDelegate::CreateStatic(&LogTaskGraphTopology)
+	);
@@ -0,0 +1,511 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "Async/TaskGraphTrace.h"
+#include "Math/SolidAngleMathUtility.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/FileHelper.h"
+#include "Misc/OutputDeviceRedirector.h"
+#include "Misc/Paths.h"
+#include "Containers/Map.h"
+#include "CoreGlobals.h"
+#include "Stats/Stats.h"
+
+bool FTaskGraphTrace::bEnabled = false;
+
+namespace TaskGraphTrace_Private
+{
+	struct FTraceEvent
+	{
+		uint64 Cycles;
+		const void* StatId;
+		uint32 TaskId;
+		uint32 OtherTaskId;
+		FTaskGraphTrace::EEventType Type;
+	};
+
+	/** Ring buffer of one thread. Only its thread writes to it; it starts over when it sees a new generation. */
+	struct FThreadTraceBuffer
+	{
+		uint32 ThreadId;
+		uint32 Generation;
+		uint64 NumWritten;
+		TArray<FTraceEvent> Events;
+	};
+
+	static FCriticalSection BuffersCritical;
+	static TArray<FThreadTraceBuffer*> Buffers;
+	static uint32 BufferTlsSlot = 0xFFFFFFFF;
+	static uint32 Generation = 0;
+	static int32 EventsPerThread = 0;
+	static uint64 StartCycles = 0;
+	static FThreadSafeCounter NextTaskId;
+
+	static double ToMicroseconds(uint64 Cycles)
+	{
+		return Cycles > StartCycles ? FPlatformTime::ToSeconds64(Cycles - StartCycles) * 1000000.0 : 0.0;
+	}
+
+	static YString GetStatName(const void* StatId)
+	{
+#if STATS
+		if (StatId)
+		{
+			const TStatId Stat((const TStatIdData*)StatId);
+			if (!Stat.IsNone())
+			{
+				return FStatNameAndInfo::GetShortNameFrom(Stat.GetName()).ToString();
+			}
+		}
+#endif
+		return TEXT("Task");
+	}
+
+	static YString GetThreadName(uint32 ThreadId)
+	{
+		YString Name = FThreadManager::Get().GetThreadName(ThreadId);
+		if (Name.IsEmpty())
+		{
+			Name = ThreadId == GGameThreadId ? YString(TEXT("GameThread")) : YString::Printf(TEXT("Thread %u"), ThreadId);
+		}
+		return Name;
+	}
+
+	/** @return the text right after Key in Line, or null if Line does not have it */
+	static const TCHAR* FindValue(const TCHAR* Line, const TCHAR* Key)
+	{
+		const TCHAR* Found = FCString::Strstr(Line, Key);
+		return Found ? Found + FCString::Strlen(Key) : nullptr;
+	}
+
+	static YString ReadString(const TCHAR* Value)
+	{
+		YString Result;
+		while (Value && *Value && *Value != TEXT('"'))
+		{
+			Result += *Value++;
+		}
+		return Result;
+	}
+}
+
+void FTaskGraphTrace::Start(int32 InEventsPerThread)
+{
+	using namespace TaskGraphTrace_Private;
+	check(InEventsPerThread > 0);
+	if (BufferTlsSlot == 0xFFFFFFFF)
+	{
+		BufferTlsSlot = YPlatformTLS::AllocTlsSlot();
+	}
+	EventsPerThread = (int32)YMath::RoundUpToPowerOfTwo((uint32)InEventsPerThread);
+	StartCycles = FPlatformTime::Cycles64();
+	YPlatformMisc::MemoryBarrier();
+	Generation++;
+	YPlatformMisc::MemoryBarrier();
+	bEnabled = true;
+}
+
+void FTaskGraphTrace::Stop()
+{
+	bEnabled = false;
+}
+
+uint32 FTaskGraphTrace::NewTaskId()
+{
+	uint32 Id = (uint32)TaskGraphTrace_Private::NextTaskId.Increment();
+	while (!Id)
+	{
+		Id = (uint32)TaskGraphTrace_Private::NextTaskId.Increment();
+	}
+	return Id;
+}
+
+void FTaskGraphTrace::RecordEvent(EEventType Type, uint32 TaskId, uint32 OtherTaskId, const void* StatId)
+{
+	using namespace TaskGraphTrace_Private;
+	FThreadTraceBuffer* Buffer = (FThreadTraceBuffer*)YPlatformTLS::GetTlsValue(BufferTlsSlot);
+	if (!Buffer)
+	{
+		Buffer = new FThreadTraceBuffer;
+		Buffer->ThreadId = YPlatformTLS::GetCurrentThreadId();
+		Buffer->Generation = 0;
+		Buffer->NumWritten = 0;
+		YPlatformTLS::SetTlsValue(BufferTlsSlot, Buffer);
+		FScopeLock Lock(&BuffersCritical);
+		Buffers.Add(Buffer);
+	}
+	if (Buffer->Generation != Generation)
+	{
+		FScopeLock Lock(&BuffersCritical);
+		Buffer->NumWritten = 0;
+		if (Buffer->Events.Num() != EventsPerThread)
+		{
+			Buffer->Events.Empty(EventsPerThread);
+			Buffer->Events.AddUninitialized(EventsPerThread);
+		}
+		Buffer->Generation = Generation;
+	}
+	FTraceEvent& Event = Buffer->Events[Buffer->NumWritten & (Buffer->Events.Num() - 1)];
+	Event.Cycles = FPlatformTime::Cycles64();
+	Event.StatId = StatId;
+	Event.TaskId = TaskId;
+	Event.OtherTaskId = OtherTaskId;
+	Event.Type = Type;
+	YPlatformMisc::MemoryBarrier();
+	Buffer->NumWritten++;
+}
+
+void FTaskGraphTrace::GetTraceData(FTaskGraphTraceData& OutData)
+{
+	using namespace TaskGraphTrace_Private;
+	struct FTaskRecord
+	{
+		uint64 QueuedCycles;
+		uint64 StartCycles;
+		uint64 EndCycles;
+		const void* StatId;
+		uint32 ThreadId;
+		uint32 CompletedBy;
+		TArray<uint32> Prerequisites;
+
+		FTaskRecord()
+			: QueuedCycles(0)
+			, StartCycles(0)
+			, EndCycles(0)
+			, StatId(nullptr)
+			, ThreadId(0)
+			, CompletedBy(0)
+		{
+		}
+	};
+
+	OutData = FTaskGraphTraceData();
+	TMap<uint32, FTaskRecord> Records;
+	{
+		FScopeLock Lock(&BuffersCritical);
+		for (FThreadTraceBuffer* Buffer : Buffers)
+		{
+			if (Buffer->Generation != Generation || !Buffer->Events.Num())
+			{
+				continue;
+			}
+			const uint64 NumWritten = Buffer->NumWritten;
+			const uint64 Capacity = Buffer->Events.Num();
+			for (uint64 Index = NumWritten > Capacity ? NumWritten - Capacity : 0; Index < NumWritten; Index++)
+			{
+				const FTraceEvent& Event = Buffer->Events[Index & (Capacity - 1)];
+				FTaskRecord& Record = Records.FindOrAdd(Event.TaskId);
+				switch (Event.Type)
+				{
+				case EEventType::Queued:
+					Record.QueuedCycles = Event.Cycles;
+					break;
+				case EEventType::Started:
+					Record.StartCycles = Event.Cycles;
+					Record.StatId = Event.StatId;
+					Record.ThreadId = Buffer->ThreadId;
+					break;
+				case EEventType::Finished:
+					Record.EndCycles = Event.Cycles;
+					break;
+				case EEventType::Dependency:
+					Record.Prerequisites.AddUnique(Event.OtherTaskId);
+					break;
+				case EEventType::CompletedBy:
+					Record.CompletedBy = Event.OtherTaskId;
+					break;
+				}
+			}
+		}
+	}
+
+	TMap<const void*, YString> StatNames;
+	for (const TPair<uint32, FTaskRecord>& Pair : Records)
+	{
+		const FTaskRecord& Record = Pair.Value;
+		if (!Record.StartCycles || !Record.EndCycles)
+		{
+			continue;
+		}
+		FTaskGraphTraceTask& Task = OutData.Tasks[OutData.Tasks.AddDefaulted()];
+		Task.Id = Pair.Key;
+		Task.ThreadId = Record.ThreadId;
+		YString* Name = StatNames.Find(Record.StatId);
+		Task.Name = Name ? *Name : StatNames.Add(Record.StatId, GetStatName(Record.StatId));
+		Task.StartTime = ToMicroseconds(Record.StartCycles);
+		Task.EndTime = YMath::Max(Task.StartTime, ToMicroseconds(Record.EndCycles));
+		// The queued event is lost if the buffer of the queuing thread wrapped around
+		Task.QueuedTime = Record.QueuedCycles ? YMath::Min(Task.StartTime, ToMicroseconds(Record.QueuedCycles)) : Task.StartTime;
+		Task.Prerequisites = Record.Prerequisites;
+		Task.CompletedBy = Record.CompletedBy;
+		OutData.ThreadIds.AddUnique(Record.ThreadId);
+	}
+	OutData.Tasks.Sort([](const FTaskGraphTraceTask& A, const FTaskGraphTraceTask& B) { return A.StartTime < B.StartTime; });
+	OutData.ThreadIds.Sort();
+	for (uint32 ThreadId : OutData.ThreadIds)
+	{
+		OutData.ThreadNames.Add(GetThreadName(ThreadId));
+	}
+}
+
+bool FTaskGraphTrace::ExportChromeTrace(const TCHAR* Filename)
+{
+	FTaskGraphTraceData Data;
+	GetTraceData(Data);
+
+	TArray<YString> Lines;
+	for (int32 Index = 0; Index < Data.ThreadIds.Num(); Index++)
+	{
+		Lines.Add(YString::Printf(TEXT("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}"),
+			Data.ThreadIds[Index], *Data.ThreadNames[Index].ReplaceCharWithEscapedChar()));
+	}
+	for (const FTaskGraphTraceTask& Task : Data.Tasks)
+	{
+		YString Prerequisites;
+		for (int32 Index = 0; Index < Task.Prerequisites.Num(); Index++)
+		{
+			Prerequisites += YString::Printf(Index ? TEXT(",%u") : TEXT("%u"), Task.Prerequisites[Index]);
+		}
+		Lines.Add(YString::Printf(TEXT("{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"id\":%u,\"queued\":%.3f,\"completedby\":%u,\"prereqs\":[%s]}}"),
+			*Task.Name.ReplaceCharWithEscapedChar(), Task.ThreadId, Task.StartTime, Task.EndTime - Task.StartTime, Task.Id, Task.QueuedTime, Task.CompletedBy, *Prerequisites));
+	}
+
+	// One event per line, which is what ImportChromeTrace reads back
+	const YString Json = YString(TEXT("{\"traceEvents\":[\n")) + YString::Join(Lines, TEXT(",\n")) + TEXT("\n]}\n");
+	return FFileHelper::SaveStringToFile(Json, Filename);
+}
+
+bool FTaskGraphTrace::ImportChromeTrace(const TCHAR* Filename, FTaskGraphTraceData& OutData)
+{
+	using namespace TaskGraphTrace_Private;
+	OutData = FTaskGraphTraceData();
+	YString Json;
+	if (!FFileHelper::LoadFileToString(Json, Filename))
+	{
+		return false;
+	}
+	TArray<YString> Lines;
+	Json.ParseIntoArrayLines(Lines);
+	for (const YString& Line : Lines)
+	{
+		const TCHAR* Tid = FindValue(*Line, TEXT("\"tid\":"));
+		if (!Tid)
+		{
+			continue;
+		}
+		const uint32 ThreadId = (uint32)FCString::Strtoui64(Tid, nullptr, 10);
+		if (FindValue(*Line, TEXT("\"ph\":\"M\"")))
+		{
+			const TCHAR* Args = FindValue(*Line, TEXT("\"args\":"));
+			if (Args && OutData.ThreadIds.Find(ThreadId) == INDEX_NONE)
+			{
+				OutData.ThreadIds.Add(ThreadId);
+				OutData.ThreadNames.Add(ReadString(FindValue(Args, TEXT("\"name\":\""))));
+			}
+		}
+		else if (FindValue(*Line, TEXT("\"ph\":\"X\"")))
+		{
+			const TCHAR* Ts = FindValue(*Line, TEXT("\"ts\":"));
+			const TCHAR* Dur = FindValue(*Line, TEXT("\"dur\":"));
+			const TCHAR* Id = FindValue(*Line, TEXT("\"id\":"));
+			if (!Ts || !Dur || !Id)
+			{
+				continue;
+			}
+			FTaskGraphTraceTask& Task = OutData.Tasks[OutData.Tasks.AddDefaulted()];
+			Task.Id = (uint32)FCString::Strtoui64(Id, nullptr, 10);
+			Task.ThreadId = ThreadId;
+			Task.Name = ReadString(FindValue(*Line, TEXT("\"name\":\"")));
+			Task.StartTime = FCString::Atod(Ts);
+			Task.EndTime = Task.StartTime + FCString::Atod(Dur);
+			const TCHAR* Queued = FindValue(*Line, TEXT("\"queued\":"));
+			Task.QueuedTime = Queued ? FCString::Atod(Queued) : Task.StartTime;
+			const TCHAR* CompletedBy = FindValue(*Line, TEXT("\"completedby\":"));
+			Task.CompletedBy = CompletedBy ? (uint32)FCString::Strtoui64(CompletedBy, nullptr, 10) : 0;
+			const TCHAR* Prerequisites = FindValue(*Line, TEXT("\"prereqs\":["));
+			while (Prerequisites && FChar::IsDigit(*Prerequisites))
+			{
+				TCHAR* End = nullptr;
+				Task.Prerequisites.Add((uint32)FCString::Strtoui64(Prerequisites, &End, 10));
+				Prerequisites = *End == TEXT(',') ? End + 1 : nullptr;
+			}
+		}
+	}
+	return OutData.Tasks.Num() > 0;
+}
+
+void FTaskGraphTrace::Analyze(const FTaskGraphTraceData& Data, YOutputDevice& Ar, int32 MaxPathTasks)
+{
+	if (!Data.Tasks.Num())
+	{
+		Ar.Logf(TEXT("No tasks in the trace."));
+		return;
+	}
+
+	TMap<uint32, int32> TaskIndices;
+	double TraceStart = Data.Tasks[0].StartTime;
+	double TraceEnd = Data.Tasks[0].EndTime;
+	double TotalQueueLatency = 0.0;
+	double TotalBusyTime = 0.0;
+	int32 LastTask = 0;
+	TMap<uint32, double> BusyTimes;
+	for (int32 Index = 0; Index < Data.Tasks.Num(); Index++)
+	{
+		const FTaskGraphTraceTask& Task = Data.Tasks[Index];
+		TaskIndices.Add(Task.Id, Index);
+		TraceStart = YMath::Min(TraceStart, Task.StartTime);
+		if (Task.EndTime > TraceEnd)
+		{
+			TraceEnd = Task.EndTime;
+			LastTask = Index;
+		}
+		TotalQueueLatency += Task.StartTime - Task.QueuedTime;
+		BusyTimes.FindOrAdd(Task.ThreadId) += Task.EndTime - Task.StartTime;
+		TotalBusyTime += Task.EndTime - Task.StartTime;
+	}
+	const double Span = YMath::Max(TraceEnd - TraceStart, 0.001);
+
+	// The task whose end completes the event of a task, following DontCompleteUntil gather tasks
+	auto GetCompletingTask = [&Data, &TaskIndices](int32 Index)
+	{
+		for (int32 Depth = 0; Data.Tasks[Index].CompletedBy && Depth < Data.Tasks.Num(); Depth++)
+		{
+			const int32* Gather = TaskIndices.Find(Data.Tasks[Index].CompletedBy);
+			if (!Gather)
+			{
+				break;
+			}
+			Index = *Gather;
+		}
+		return Index;
+	};
+
+	// Walk back through the prerequisite that finished last
+	TArray<int32> Path;
+	for (int32 Current = LastTask; Current != INDEX_NONE && Path.Num() < Data.Tasks.Num(); )
+	{
+		Path.Add(Current);
+		int32 Gating = INDEX_NONE;
+		for (uint32 PrerequisiteId : Data.Tasks[Current].Prerequisites)
+		{
+			const int32* Prerequisite = TaskIndices.Find(PrerequisiteId);
+			if (Prerequisite)
+			{
+				// a task completed by the current one, such as the batch it belongs to, gates it with its own end
+				int32 Completing = GetCompletingTask(*Prerequisite);
+				if (Completing == Current)
+				{
+					Completing = *Prerequisite;
+				}
+				if (Gating == INDEX_NONE || Data.Tasks[Completing].EndTime > Data.Tasks[Gating].EndTime)
+				{
+					Gating = Completing;
+				}
+			}
+		}
+		Current = Gating;
+	}
+
+	struct FPathTask
+	{
+		int32 Task;
+		double RunTime;
+		double WaitTime;
+	};
+	TArray<FPathTask> PathTasks;
+	double PathRunTime = 0.0;
+	for (int32 Index = Path.Num() - 1; Index >= 0; Index--)
+	{
+		const FTaskGraphTraceTask& Task = Data.Tasks[Path[Index]];
+		// Time between the gating prerequisite finishing, or the task being queued for the first one, and starting
+		const double ReadyTime = Index + 1 < Path.Num() ? Data.Tasks[Path[Index + 1]].EndTime : Task.QueuedTime;
+		FPathTask PathTask = { Path[Index], Task.EndTime - Task.StartTime, YMath::Max(Task.StartTime - ReadyTime, 0.0) };
+		PathRunTime += PathTask.RunTime;
+		PathTasks.Add(PathTask);
+	}
+	const double PathTime = Data.Tasks[LastTask].EndTime - Data.Tasks[Path.Last()].QueuedTime;
+
+	auto GetThreadName = [&Data](uint32 ThreadId)
+	{
+		const int32 Index = Data.ThreadIds.Find(ThreadId);
+		return Index != INDEX_NONE ? Data.ThreadNames[Index] : YString::Printf(TEXT("Thread %u"), ThreadId);
+	};
+
+	Ar.Logf(TEXT("%d tasks over %.3fms, average queue latency %.3fms, average parallelism %.2f"),
+		Data.Tasks.Num(), Span / 1000.0, TotalQueueLatency / Data.Tasks.Num() / 1000.0, TotalBusyTime / Span);
+	Ar.Logf(TEXT("Critical path: %d tasks, %.3fms, %.3fms running and %.3fms waiting to run, ends with %s"),
+		PathTasks.Num(), PathTime / 1000.0, PathRunTime / 1000.0, (PathTime - PathRunTime) / 1000.0, *Data.Tasks[LastTask].Name);
+	TArray<FPathTask> LongestPathTasks = PathTasks;
+	LongestPathTasks.Sort([](const FPathTask& A, const FPathTask& B) { return A.RunTime + A.WaitTime > B.RunTime + B.WaitTime; });
+	for (int32 Index = 0; Index < LongestPathTasks.Num() && Index < MaxPathTasks; Index++)
+	{
+		const FTaskGraphTraceTask& Task = Data.Tasks[LongestPathTasks[Index].Task];
+		Ar.Logf(TEXT("   %-40s %8.3fms run %8.3fms wait  id %u on %s"), *Task.Name, LongestPathTasks[Index].RunTime / 1000.0,
+			LongestPathTasks[Index].WaitTime / 1000.0, Task.Id, *GetThreadName(Task.ThreadId));
+	}
+	Ar.Logf(TEXT("Thread utilization:"));
+	for (const TPair<uint32, double>& Pair : BusyTimes)
+	{
+		Ar.Logf(TEXT("   %-40s %6.2f%% busy, %.3fms"), *GetThreadName(Pair.Key), Pair.Value * 100.0 / Span, Pair.Value / 1000.0);
+	}
+}
+
+static YString GetTraceFilename(const TArray<YString>& Args)
+{
+	return Args.Num() ? Args[0] : YPaths::GameSavedDir() / TEXT("TaskGraphTrace.json");
+}
+
+static void TaskGraphTraceStart(const TArray<YString>& Args)
+{
+	FTaskGraphTrace::Start(Args.Num() ? YMath::Max(FCString::Atoi(*Args[0]), 1) : 64 * 1024);
+	UE_LOG(LogConsoleResponse, Display, TEXT("Task graph trace started."));
+}
+
+static void TaskGraphTraceStop(const TArray<YString>& Args)
+{
+	FTaskGraphTrace::Stop();
+	const YString Filename = GetTraceFilename(Args);
+	if (FTaskGraphTrace::ExportChromeTrace(*Filename))
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("Task graph trace written to %s"), *Filename);
+	}
+	else
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("Could not write the task graph trace to %s"), *Filename);
+	}
+}
+
+static void TaskGraphTraceAnalyze(const TArray<YString>& Args)
+{
+	FTaskGraphTraceData Data;
+	const YString Filename = GetTraceFilename(Args);
+	if (!FTaskGraphTrace::ImportChromeTrace(*Filename, Data))
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("Could not read a task graph trace from %s"), *Filename);
+		return;
+	}
+	FTaskGraphTrace::Analyze(Data, *GLog);
+}
+
+static FAutoConsoleCommand TaskGraphTraceStartCmd(
+	TEXT("TaskGraph.TraceStart"),
+	TEXT("Starts recording task graph tasks. Optional argument: the number of events kept per thread, 65536 by default."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&TaskGraphTraceStart)
+	);
+
+static FAutoConsoleCommand TaskGraphTraceStopCmd(
+	TEXT("TaskGraph.TraceStop"),
+	TEXT("Stops recording task graph tasks and writes them as a Chrome trace. Optional argument: the file, Saved/TaskGraphTrace.json by default."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&TaskGraphTraceStop)
+	);
+
+static FAutoConsoleCommand TaskGraphTraceAnalyzeCmd(
+	TEXT("TaskGraph.TraceAnalyze"),
+	TEXT("Prints the critical path and thread utilization of a trace written by TaskGraph.TraceStop. Optional argument: the file, Saved/TaskGraphTrace.json by default."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&TaskGraphTraceAnalyze)
+	);
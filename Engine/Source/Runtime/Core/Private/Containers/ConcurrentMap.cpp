@@ -0,0 +1,360 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "Containers/ConcurrentMap.h"
+#include "HAL/PlatformAtomics.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/TlsAutoCleanup.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Logging/LogMacros.h"
+#include "Math/SolidAngleMathUtility.h"
+#include "Misc/CString.h"
+
+namespace UE4ConcurrentMap_Private
+{
+	/** A thread's view of the epoch. Records are never freed, a thread that exits hands its record to the next new thread. */
+	MS_ALIGN(PLATFORM_CACHE_LINE_SIZE) struct FEpochRecord
+	{
+		/** Holds the epoch pinned by the thread, or 0 when it is not reading. */
+		volatile int64 Epoch;
+
+		/** Holds how many reads the thread is nested in, only used by the owner. */
+		int32 Depth;
+
+		/** Set while a thread owns the record. */
+		volatile int32 bInUse;
+
+		/** Holds the next record of the list of all records. */
+		FEpochRecord* Next;
+	} GCC_ALIGN(PLATFORM_CACHE_LINE_SIZE);
+
+	/** Holds the global epoch, starting at 1 since 0 means not reading. */
+	static volatile int64 GlobalEpoch = 1;
+
+	/** Holds the records of all threads that ever read a concurrent map. */
+	static FEpochRecord* volatile Records = nullptr;
+
+	static uint32 EpochTlsSlot = YPlatformTLS::AllocTlsSlot();
+
+	/** Gives the record back when its runnable thread exits. */
+	class FEpochRecordOwner : public FTlsAutoCleanup
+	{
+	public:
+		explicit FEpochRecordOwner(FEpochRecord* InRecord)
+			: Record(InRecord)
+		{
+		}
+
+		virtual ~FEpochRecordOwner()
+		{
+			if (Record)
+			{
+				Record->Epoch = 0;
+				YPlatformMisc::MemoryBarrier();
+				Record->bInUse = 0;
+			}
+		}
+
+		/** Lets go of the record without giving it back, the thread keeps it. */
+		void KeepRecord()
+		{
+			Record = nullptr;
+		}
+
+	private:
+		FEpochRecord* Record;
+	};
+
+	static FEpochRecord* AcquireRecord()
+	{
+		FEpochRecord* Record = Records;
+		for (; Record; Record = Record->Next)
+		{
+			if (!Record->bInUse && FPlatformAtomics::InterlockedCompareExchange(&Record->bInUse, 1, 0) == 0)
+			{
+				break;
+			}
+		}
+
+		if (!Record)
+		{
+			Record = new(YMemory::Malloc(sizeof(FEpochRecord), PLATFORM_CACHE_LINE_SIZE)) FEpochRecord();
+			Record->Epoch = 0;
+			Record->bInUse = 1;
+			for (;;)
+			{
+				FEpochRecord* Head = Records;
+				Record->Next = Head;
+				if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&Records, Record, Head) == Head)
+				{
+					break;
+				}
+			}
+		}
+
+		Record->Depth = 0;
+		YPlatformTLS::SetTlsValue(EpochTlsSlot, Record);
+		// Only runnable threads clean up their TLS when they exit. The main thread and threads that weren't started
+		// through FRunnableThread keep their record for as long as the process runs, an idle record never holds
+		// reclamation back.
+		FEpochRecordOwner* Owner = new FEpochRecordOwner(Record);
+		if (!Owner->Register())
+		{
+			Owner->KeepRecord();
+			delete Owner;
+		}
+		return Record;
+	}
+
+	FEpochRecord* EnterEpoch()
+	{
+		FEpochRecord* Record = (FEpochRecord*)YPlatformTLS::GetTlsValue(EpochTlsSlot);
+		if (!Record)
+		{
+			Record = AcquireRecord();
+		}
+
+		if (Record->Depth++ == 0)
+		{
+			Record->Epoch = GlobalEpoch;
+			// the pinned epoch must be visible before anything is read
+			YPlatformMisc::MemoryBarrier();
+		}
+		return Record;
+	}
+
+	void LeaveEpoch(FEpochRecord* Record)
+	{
+		if (--Record->Depth == 0)
+		{
+			// everything read must be done with before the epoch is let go
+			YPlatformMisc::MemoryBarrier();
+			Record->Epoch = 0;
+		}
+	}
+
+	int64 GetEpoch()
+	{
+		YPlatformMisc::MemoryBarrier();
+		return GlobalEpoch;
+	}
+
+	int64 TryAdvanceEpoch()
+	{
+		const int64 Epoch = GlobalEpoch;
+		YPlatformMisc::MemoryBarrier();
+
+		for (const FEpochRecord* Record = Records; Record; Record = Record->Next)
+		{
+			const int64 RecordEpoch = Record->Epoch;
+			if (RecordEpoch && RecordEpoch != Epoch)
+			{
+				return Epoch;
+			}
+		}
+
+		// losing the race means someone else advanced it
+		FPlatformAtomics::InterlockedCompareExchange(&GlobalEpoch, Epoch + 1, Epoch);
+		return GlobalEpoch;
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+
+namespace ConcurrentMapBenchmark
+{
+	/** Waits for all the workers to be ready, then runs the body */
+	class FWorker : public FRunnable
+	{
+	public:
+		FWorker(TFunction<void()>&& InBody, volatile int32& InNumReady, volatile int32& InGo)
+			: Body(MoveTemp(InBody))
+			, NumReady(InNumReady)
+			, Go(InGo)
+		{
+		}
+
+		virtual uint32 Run() override
+		{
+			FPlatformAtomics::InterlockedIncrement(&NumReady);
+			while (!Go)
+			{
+				FPlatformProcess::Sleep(0.0f);
+			}
+			Body();
+			return 0;
+		}
+
+	private:
+		TFunction<void()> Body;
+		volatile int32& NumReady;
+		volatile int32& Go;
+	};
+
+	/** Operations are made in batches, within a scope of this type */
+	struct FNoScope
+	{
+	};
+
+	/** The map everyone uses today */
+	struct FLockedMap
+	{
+		typedef FNoScope FBatchScope;
+
+		TMap<uint32, uint32> Map;
+		mutable FCriticalSection Lock;
+
+		bool Find(uint32 Key, uint32& OutValue) const
+		{
+			FScopeLock ScopeLock(&Lock);
+			const uint32* Value = Map.Find(Key);
+			if (Value)
+			{
+				OutValue = *Value;
+			}
+			return Value != nullptr;
+		}
+		void Add(uint32 Key, uint32 Value)
+		{
+			FScopeLock ScopeLock(&Lock);
+			Map.Add(Key, Value);
+		}
+	};
+
+	struct FConcurrentMap
+	{
+		typedef FNoScope FBatchScope;
+
+		TConcurrentMap<uint32, uint32> Map;
+
+		bool Find(uint32 Key, uint32& OutValue) const
+		{
+			return Map.Find(Key, OutValue);
+		}
+		void Add(uint32 Key, uint32 Value)
+		{
+			Map.Add(Key, Value);
+		}
+	};
+
+	/** Pins the epoch once per batch rather than once per lookup */
+	struct FPinnedConcurrentMap : public FConcurrentMap
+	{
+		typedef FConcurrentMapReadScope FBatchScope;
+	};
+
+	/** Operations made within one FBatchScope */
+	static const int32 BatchSize = 64;
+
+	/**
+	* Runs NumOps random operations on NumKeys keys on each of NumThreads threads, WritePercent of them updates and the
+	* others lookups, and logs the total throughput. Every value is its key plus a multiple of NumKeys, which readers check.
+	*/
+	template<typename MapType>
+	static void Run(const TCHAR* Name, int32 NumThreads, int32 NumKeys, int32 NumOps, int32 WritePercent)
+	{
+		MapType* Map = new MapType();
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			Map->Add(Key, Key);
+		}
+
+		volatile int32 NumReady = 0;
+		volatile int32 Go = 0;
+		volatile int32 NumErrors = 0;
+		TArray<FWorker*> Workers;
+		TArray<FRunnableThread*> Threads;
+
+		for (int32 ThreadIndex = 0; ThreadIndex < NumThreads; ++ThreadIndex)
+		{
+			Workers.Add(new FWorker([Map, ThreadIndex, NumKeys, NumOps, WritePercent, &NumErrors]()
+			{
+				uint32 Random = 0x9E3779B9u * (ThreadIndex + 1);
+				int32 LocalErrors = 0;
+				for (int32 BatchStart = 0; BatchStart < NumOps; BatchStart += BatchSize)
+				{
+					typename MapType::FBatchScope BatchScope;
+					for (int32 Op = BatchStart, BatchEnd = YMath::Min(BatchStart + BatchSize, NumOps); Op < BatchEnd; ++Op)
+					{
+						Random ^= Random << 13;
+						Random ^= Random >> 17;
+						Random ^= Random << 5;
+						const uint32 Key = Random % uint32(NumKeys);
+						if (int32((Random >> 8) % 100) < WritePercent)
+						{
+							Map->Add(Key, Key + uint32(NumKeys) * uint32(Op & 7));
+						}
+						else
+						{
+							uint32 Value;
+							LocalErrors += !Map->Find(Key, Value) || Value % uint32(NumKeys) != Key;
+						}
+					}
+				}
+				FPlatformAtomics::InterlockedAdd(&NumErrors, LocalErrors);
+			}, NumReady, Go));
+		}
+
+		for (int32 WorkerIndex = 0; WorkerIndex < Workers.Num(); ++WorkerIndex)
+		{
+			Threads.Add(FRunnableThread::Create(Workers[WorkerIndex], *YString::Printf(TEXT("MapBench%d"), WorkerIndex)));
+			check(Threads.Last());
+		}
+		while (NumReady < Workers.Num())
+		{
+			FPlatformProcess::Sleep(0.0f);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		FPlatformAtomics::InterlockedExchange(&Go, 1);
+		for (FRunnableThread* Thread : Threads)
+		{
+			Thread->WaitForCompletion();
+		}
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+		for (FRunnableThread* Thread : Threads)
+		{
+			delete Thread;
+		}
+		for (FWorker* Worker : Workers)
+		{
+			delete Worker;
+		}
+		delete Map;
+
+		const double NumTotal = double(NumThreads) * NumOps;
+		UE_LOG(LogConsoleResponse, Display, TEXT("  %-36s %2d threads %10.2f Mops/s%s"), Name, NumThreads,
+			NumTotal / Seconds / 1e6, NumErrors ? TEXT("  INVALID RESULT") : TEXT(""));
+	}
+}
+
+static void ConcurrentMapBenchmarkCommand(const TArray<YString>& Args)
+{
+	using namespace ConcurrentMapBenchmark;
+
+	const int32 MaxThreads = Args.Num() > 0 ? YMath::Clamp(FCString::Atoi(*Args[0]), 1, 64) : 64;
+	const int32 NumKeys = Args.Num() > 1 ? YMath::Max(1, FCString::Atoi(*Args[1])) : 100000;
+	const int32 NumOps = Args.Num() > 2 ? YMath::Max(1, FCString::Atoi(*Args[2])) : 1000000;
+	const int32 WritePercent = Args.Num() > 3 ? YMath::Clamp(FCString::Atoi(*Args[3]), 0, 100) : 5;
+
+	UE_LOG(LogConsoleResponse, Display, TEXT("%d keys, %d operations per thread, %d%% writes"), NumKeys, NumOps, WritePercent);
+	for (int32 NumThreads = 1; NumThreads <= MaxThreads; NumThreads *= 2)
+	{
+		Run<FConcurrentMap>(TEXT("TConcurrentMap"), NumThreads, NumKeys, NumOps, WritePercent);
+		Run<FPinnedConcurrentMap>(TEXT("TConcurrentMap, pinned per 64 ops"), NumThreads, NumKeys, NumOps, WritePercent);
+		Run<FLockedMap>(TEXT("TMap with FCriticalSection"), NumThreads, NumKeys, NumOps, WritePercent);
+	}
+}
+
+static FAutoConsoleCommand ConcurrentMapBenchmarkCmd(
+	TEXT("Containers.ConcurrentMapBenchmark"),
+	TEXT("Measures the throughput of TConcurrentMap against a TMap behind a lock, with mostly lookups from 1 to MaxThreads threads.\n")
+	TEXT("Usage: Containers.ConcurrentMapBenchmark [MaxThreads=64] [NumKeys=100000] [OpsPerThread=1000000] [WritePercent=5]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&ConcurrentMapBenchmarkCommand)
+	);
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,176 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "Containers/FlatSet.h"
+#include "Containers/FlatMap.h"
+#include "Containers/Map.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Logging/LogMacros.h"
+#include "Math/SolidAngleMathUtility.h"
+#include "Misc/CString.h"
+
+MS_ALIGN(16) const int8 UE4FlatSet_Private::EmptyGroup[16] GCC_ALIGN(16) =
+{
+	UE4FlatSet_Private::CtrlEmpty, UE4FlatSet_Private::CtrlEmpty, UE4FlatSet_Private::CtrlEmpty, UE4FlatSet_Private::CtrlEmpty,
+	UE4FlatSet_Private::CtrlEmpty, UE4FlatSet_Private::CtrlEmpty, UE4FlatSet_Private::CtrlEmpty, UE4FlatSet_Private::CtrlEmpty,
+	UE4FlatSet_Private::CtrlEmpty, UE4FlatSet_Private::CtrlEmpty, UE4FlatSet_Private::CtrlEmpty, UE4FlatSet_Private::CtrlEmpty,
+	UE4FlatSet_Private::CtrlEmpty, UE4FlatSet_Private::CtrlEmpty, UE4FlatSet_Private::CtrlEmpty, UE4FlatSet_Private::CtrlEmpty,
+};
+
+#if !UE_BUILD_SHIPPING
+
+namespace FlatSetBenchmark
+{
+	/** Scrambles an index into a key; it is a bijection, so even indices give distinct keys that odd indices never hit. */
+	static FORCEINLINE uint32 MakeKey(uint32 Index)
+	{
+		Index *= 0x9E3779B1u;
+		Index ^= Index >> 15;
+		Index *= 0x85EBCA77u;
+		return Index ^ (Index >> 13);
+	}
+
+	static FORCEINLINE uint32 GetHitKey(int32 Index)
+	{
+		return MakeKey(uint32(Index) * 2);
+	}
+
+	static FORCEINLINE uint32 GetMissKey(int32 Index)
+	{
+		return MakeKey(uint32(Index) * 2 + 1);
+	}
+
+	static void LogResult(const TCHAR* Operation, const TCHAR* Name, double Seconds, int32 NumOps, uint64 Checksum)
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("  %-12s %-28s %8.2f ns/op  (%llu)"), Operation, Name, Seconds * 1e9 / double(NumOps), Checksum);
+	}
+
+	/** Set adapters, so that TSet and TFlatSet run the same code */
+	static FORCEINLINE bool Contains(const TSet<uint32>& Set, uint32 Key)          { return Set.Contains(Key); }
+	static FORCEINLINE bool Contains(const TFlatSet<uint32>& Set, uint32 Key)      { return Set.Contains(Key); }
+	static FORCEINLINE void Insert(TSet<uint32>& Set, uint32 Key)                  { Set.Add(Key); }
+	static FORCEINLINE void Insert(TFlatSet<uint32>& Set, uint32 Key)              { Set.Add(Key); }
+
+	/** Map adapters */
+	static FORCEINLINE const uint32* Find(const TMap<uint32, uint32>& Map, uint32 Key)     { return Map.Find(Key); }
+	static FORCEINLINE const uint32* Find(const TFlatMap<uint32, uint32>& Map, uint32 Key) { return Map.Find(Key); }
+	static FORCEINLINE void Insert(TMap<uint32, uint32>& Map, uint32 Key)                  { Map.Add(Key, Key); }
+	static FORCEINLINE void Insert(TFlatMap<uint32, uint32>& Map, uint32 Key)              { Map.Add(Key, Key); }
+
+	template<typename SetType>
+	static void RunSet(const TCHAR* Name, int32 NumElements)
+	{
+		SetType Set;
+		uint64 Checksum = 0;
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumElements; ++Index)
+		{
+			Insert(Set, GetHitKey(Index));
+		}
+		LogResult(TEXT("Insert"), Name, FPlatformTime::Seconds() - StartTime, NumElements, Set.Num());
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumElements; ++Index)
+		{
+			Checksum += Contains(Set, GetHitKey(Index));
+		}
+		LogResult(TEXT("Find hit"), Name, FPlatformTime::Seconds() - StartTime, NumElements, Checksum);
+
+		Checksum = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumElements; ++Index)
+		{
+			Checksum += Contains(Set, GetMissKey(Index));
+		}
+		LogResult(TEXT("Find miss"), Name, FPlatformTime::Seconds() - StartTime, NumElements, Checksum);
+
+		Checksum = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (uint32 Element : Set)
+		{
+			Checksum += Element;
+		}
+		LogResult(TEXT("Iterate"), Name, FPlatformTime::Seconds() - StartTime, NumElements, Checksum);
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumElements; Index += 2)
+		{
+			Set.Remove(GetHitKey(Index));
+		}
+		LogResult(TEXT("Remove"), Name, FPlatformTime::Seconds() - StartTime, (NumElements + 1) / 2, Set.Num());
+
+		UE_LOG(LogConsoleResponse, Display, TEXT("  %-12s %-28s %8u KB"), TEXT("Memory"), Name, Set.GetAllocatedSize() / 1024);
+	}
+
+	template<typename MapType>
+	static void RunMap(const TCHAR* Name, int32 NumElements)
+	{
+		MapType Map;
+		uint64 Checksum = 0;
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumElements; ++Index)
+		{
+			Insert(Map, GetHitKey(Index));
+		}
+		LogResult(TEXT("Insert"), Name, FPlatformTime::Seconds() - StartTime, NumElements, Map.Num());
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumElements; ++Index)
+		{
+			if (const uint32* Value = Find(Map, GetHitKey(Index)))
+			{
+				Checksum += *Value;
+			}
+		}
+		LogResult(TEXT("Find hit"), Name, FPlatformTime::Seconds() - StartTime, NumElements, Checksum);
+
+		Checksum = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumElements; ++Index)
+		{
+			Checksum += Find(Map, GetMissKey(Index)) != nullptr;
+		}
+		LogResult(TEXT("Find miss"), Name, FPlatformTime::Seconds() - StartTime, NumElements, Checksum);
+
+		Checksum = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (const auto& Pair : Map)
+		{
+			Checksum += Pair.Value;
+		}
+		LogResult(TEXT("Iterate"), Name, FPlatformTime::Seconds() - StartTime, NumElements, Checksum);
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumElements; Index += 2)
+		{
+			Map.Remove(GetHitKey(Index));
+		}
+		LogResult(TEXT("Remove"), Name, FPlatformTime::Seconds() - StartTime, (NumElements + 1) / 2, Map.Num());
+
+		UE_LOG(LogConsoleResponse, Display, TEXT("  %-12s %-28s %8u KB"), TEXT("Memory"), Name, Map.GetAllocatedSize() / 1024);
+	}
+}
+
+static void FlatSetBenchmarkCommand(const TArray<YString>& Args)
+{
+	using namespace FlatSetBenchmark;
+
+	const int32 NumElements = Args.Num() > 0 ? YMath::Clamp(FCString::Atoi(*Args[0]), 1, 1 << 26) : 1000000;
+
+	UE_LOG(LogConsoleResponse, Display, TEXT("%d uint32 keys, misses are keys that are not in the container"), NumElements);
+	RunSet<TSet<uint32>>(TEXT("TSet<uint32>"), NumElements);
+	RunSet<TFlatSet<uint32>>(TEXT("TFlatSet<uint32>"), NumElements);
+	RunMap<TMap<uint32, uint32>>(TEXT("TMap<uint32, uint32>"), NumElements);
+	RunMap<TFlatMap<uint32, uint32>>(TEXT("TFlatMap<uint32, uint32>"), NumElements);
+}
+
+static FAutoConsoleCommand FlatSetBenchmarkCmd(
+	TEXT("Containers.FlatSetBenchmark"),
+	TEXT("Measures insertion, successful and failed lookups, iteration and removal in TFlatSet and TFlatMap against TSet and TMap.\n")
+	TEXT("Usage: Containers.FlatSetBenchmark [NumElements=1000000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&FlatSetBenchmarkCommand)
+	);
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,336 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "Containers/InlineString.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformAtomics.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/PlatformTime.h"
+#include "Logging/LogMacros.h"
+#include "Math/SolidAngleMathUtility.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/CString.h"
+#include "Misc/Parse.h"
+
+#if !UE_BUILD_SHIPPING && !PLATFORM_USES_FIXED_GMalloc_CLASS
+
+namespace InlineStringBenchmark
+{
+	/** Forwards everything to the malloc below it, and counts the allocations made by one thread while it is counting */
+	class FMallocCountProxy : public YMalloc
+	{
+	private:
+		/** Malloc we're based on, aka using under the hood */
+		YMalloc* UsedMalloc;
+
+		/** Thread whose allocations are counted, 0 when not counting */
+		volatile uint32 CountingThreadId;
+
+		/** Allocations and reallocations made by the counting thread, only touched by that thread */
+		uint64 NumAllocs;
+
+		FORCEINLINE void Count()
+		{
+			if (UNLIKELY(CountingThreadId) && CountingThreadId == YPlatformTLS::GetCurrentThreadId())
+			{
+				++NumAllocs;
+			}
+		}
+
+	public:
+		explicit FMallocCountProxy(YMalloc* InMalloc)
+			: UsedMalloc(InMalloc)
+			, CountingThreadId(0)
+			, NumAllocs(0)
+		{
+		}
+
+		void StartCounting()
+		{
+			NumAllocs = 0;
+			CountingThreadId = YPlatformTLS::GetCurrentThreadId();
+		}
+
+		uint64 StopCounting()
+		{
+			CountingThreadId = 0;
+			return NumAllocs;
+		}
+
+		YMalloc* GetUsedMalloc() const
+		{
+			return UsedMalloc;
+		}
+
+		// YMalloc interface begin
+		virtual void InitializeStatsMetadata() override
+		{
+			UsedMalloc->InitializeStatsMetadata();
+		}
+
+		virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+		{
+			Count();
+			return UsedMalloc->Malloc(Size, Alignment);
+		}
+
+		virtual void* Realloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+		{
+			if (NewSize)
+			{
+				Count();
+			}
+			return UsedMalloc->Realloc(Ptr, NewSize, Alignment);
+		}
+
+		virtual void Free(void* Ptr) override
+		{
+			UsedMalloc->Free(Ptr);
+		}
+
+		virtual void FreeSized(void* Ptr, SIZE_T Size, uint32 Alignment) override
+		{
+			UsedMalloc->FreeSized(Ptr, Size, Alignment);
+		}
+
+		virtual bool TryReallocInPlace(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+		{
+			return UsedMalloc->TryReallocInPlace(Ptr, NewSize, Alignment);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return UsedMalloc->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return UsedMalloc->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim() override
+		{
+			UsedMalloc->Trim();
+		}
+
+		virtual void SetupTLSCachesOnCurrentThread() override
+		{
+			UsedMalloc->SetupTLSCachesOnCurrentThread();
+		}
+
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+		{
+			UsedMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+		}
+
+		virtual void GetAllocatorStats(YGenericMemoryStats& OutStats) override
+		{
+			UsedMalloc->GetAllocatorStats(OutStats);
+		}
+
+		virtual void DumpAllocatorStats(class YOutputDevice& Ar) override
+		{
+			UsedMalloc->DumpAllocatorStats(Ar);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return UsedMalloc->IsInternallyThreadSafe();
+		}
+
+		virtual bool ValidateHeap() override
+		{
+			return UsedMalloc->ValidateHeap();
+		}
+
+		virtual bool Exec(UWorld* InWorld, const TCHAR* Cmd, YOutputDevice& Ar) override
+		{
+			return UsedMalloc->Exec(InWorld, Cmd, Ar);
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return UsedMalloc->GetDescriptiveName();
+		}
+		// YMalloc interface end
+	};
+
+	/** Proxy of the last run. It is never deleted, other threads may still be inside it after it is taken off GMalloc. */
+	static FMallocCountProxy* Proxy = nullptr;
+
+	/** Puts the proxy on top of GMalloc for the lifetime of the benchmark, and puts the previous GMalloc back afterwards */
+	class FScopedMallocCountProxy
+	{
+	public:
+		FScopedMallocCountProxy()
+		{
+			for (;;)
+			{
+				PreviousMalloc = GMalloc;
+				FMallocCountProxy* NewProxy = Proxy && Proxy->GetUsedMalloc() == PreviousMalloc ? Proxy : new FMallocCountProxy(PreviousMalloc);
+				if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&GMalloc, NewProxy, PreviousMalloc) == PreviousMalloc)
+				{
+					Proxy = NewProxy;
+					break;
+				}
+				if (NewProxy != Proxy)
+				{
+					// never installed, so nothing can be inside it
+					delete NewProxy;
+				}
+			}
+		}
+
+		~FScopedMallocCountProxy()
+		{
+			// blocks allocated through the proxy came from the previous malloc, so they can be freed by it directly
+			if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&GMalloc, PreviousMalloc, Proxy) != Proxy)
+			{
+				UE_LOG(LogConsoleResponse, Warning, TEXT("GMalloc was replaced during the benchmark, the allocation counting proxy is left under it"));
+			}
+		}
+
+	private:
+		/** GMalloc before the proxy was installed */
+		YMalloc* PreviousMalloc;
+	};
+
+	static void LogResult(const TCHAR* Name, uint64 NumAllocs, double Seconds, int32 NumOps, const TCHAR* OpName)
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("  %-44s %8.2f allocs/%s %10.1f ns/%s"), Name, double(NumAllocs) / NumOps, OpName, Seconds * 1e9 / NumOps, OpName);
+	}
+
+	/** Runs Body NumRepeats times and logs the allocations and time of one run */
+	template<typename BodyType>
+	static void Measure(const TCHAR* Name, int32 NumRepeats, int32 OpsPerRepeat, const TCHAR* OpName, BodyType Body)
+	{
+		// the first run is not counted, so that buffers reused across runs are already there
+		Body();
+
+		Proxy->StartCounting();
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Repeat = 0; Repeat < NumRepeats; ++Repeat)
+		{
+			Body();
+		}
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+		const uint64 NumAllocs = Proxy->StopCounting();
+
+		LogResult(Name, NumAllocs, Seconds, NumRepeats * OpsPerRepeat, OpName);
+	}
+
+	/** Makes an ini file with the usual mix of short and long, plain and quoted, set and array values */
+	static YString MakeIniText(int32 NumSections, int32& OutNumLines)
+	{
+		YString Text;
+		OutNumLines = 0;
+		for (int32 Section = 0; Section < NumSections; ++Section)
+		{
+			Text += YString::Printf(TEXT("[/Script/Engine.BenchmarkSettings%d]\r\n"), Section);
+			Text += YString::Printf(TEXT("bEnabled=True\r\nMaxCount=%d\r\nScale=1.500000\r\n"), Section);
+			Text += YString::Printf(TEXT("DefaultMap=/Game/Maps/Benchmark/BenchmarkMap%d.BenchmarkMap%d\r\n"), Section, Section);
+			Text += TEXT("; a comment that is skipped\r\n");
+			Text += YString::Printf(TEXT("Description=\"A \\\"quoted\\\" value\\nthat spans two lines %d\"\r\n"), Section);
+			Text += TEXT("Short=\"abc\"\r\n");
+			for (int32 Entry = 0; Entry < 8; ++Entry)
+			{
+				Text += YString::Printf(TEXT("+Paths=(Path=\"/Game/Content/Folder%d\",Priority=%d)\r\n"), Entry, Entry);
+			}
+			Text += TEXT("\r\n");
+			OutNumLines += 15;
+		}
+		return Text;
+	}
+
+	/** A command line, with the usual switches, values, quoted paths and escapes */
+	static const TCHAR* CommandLine = TEXT("Benchmark -game -log -ResX=1920 -ResY=1080 -ExecCmds=\"stat fps, stat unit\" ")
+		TEXT("\"C:/Program Files/Solid Angle/Binaries/Game.exe\" -abslog=\"D:/Logs/Run 1/Game.log\" -nosound -windowed -benchmark");
+}
+
+static void InlineStringBenchmarkCommand(const TArray<YString>& Args)
+{
+	using namespace InlineStringBenchmark;
+
+	const int32 NumSections = Args.Num() > 0 ? YMath::Clamp(FCString::Atoi(*Args[0]), 1, 100000) : 100;
+	const int32 NumRepeats = Args.Num() > 1 ? YMath::Max(1, FCString::Atoi(*Args[1])) : 10;
+
+	FScopedMallocCountProxy ScopedProxy;
+
+	int32 NumLines = 0;
+	const YString IniText = MakeIniText(NumSections, NumLines);
+
+	UE_LOG(LogConsoleResponse, Display, TEXT("Config loading, %d sections, %d lines"), NumSections, NumLines);
+	Measure(TEXT("FConfigFile::ProcessInputFileContents"), NumRepeats, NumLines, TEXT("line"), [&IniText]()
+	{
+		FConfigFile File;
+		File.ProcessInputFileContents(IniText);
+	});
+	Measure(TEXT("FConfigFile::CombineFromBuffer"), NumRepeats, NumLines, TEXT("line"), [&IniText]()
+	{
+		FConfigFile File;
+		File.CombineFromBuffer(IniText);
+	});
+
+	const int32 NumParseRepeats = NumRepeats * 1000;
+	int32 NumTokens = 0;
+	for (const TCHAR* Str = CommandLine; FParse::Token(Str, false).Len(); ++NumTokens)
+	{
+	}
+	int32 NumIniLines = 0;
+	YString IniLine;
+	for (const TCHAR* Str = *IniText; *Str; FParse::Line(&Str, IniLine), ++NumIniLines)
+	{
+	}
+
+	UE_LOG(LogConsoleResponse, Display, TEXT("FParse, %d tokens, %d lines"), NumTokens, NumIniLines);
+	Measure(TEXT("FParse::Token into a new YString"), NumParseRepeats, NumTokens, TEXT("call"), []()
+	{
+		for (const TCHAR* Str = CommandLine;;)
+		{
+			YString Token;
+			if (!FParse::Token(Str, Token, true))
+			{
+				break;
+			}
+		}
+	});
+	Measure(TEXT("FParse::Token into a YInlineString"), NumParseRepeats, NumTokens, TEXT("call"), []()
+	{
+		for (const TCHAR* Str = CommandLine;;)
+		{
+			YInlineString Token;
+			if (!FParse::Token(Str, Token, true))
+			{
+				break;
+			}
+		}
+	});
+	Measure(TEXT("FParse::QuotedString into a new YString"), NumParseRepeats, 1, TEXT("call"), []()
+	{
+		YString Value;
+		FParse::QuotedString(TEXT("\"C:/Program Files/Solid Angle/Binaries/Game.exe \\\"-windowed\\\"\\n\""), Value);
+	});
+	Measure(TEXT("FParse::Line into a reused YString"), NumRepeats, NumIniLines, TEXT("line"), [&IniText]()
+	{
+		YString Line;
+		for (const TCHAR* Str = *IniText; *Str; FParse::Line(&Str, Line))
+		{
+		}
+	});
+	Measure(TEXT("FParse::Line into a reused YInlineString"), NumRepeats, NumIniLines, TEXT("line"), [&IniText]()
+	{
+		YInlineString Line;
+		for (const TCHAR* Str = *IniText; *Str; FParse::Line(&Str, Line))
+		{
+		}
+	});
+}
+
+static FAutoConsoleCommand InlineStringBenchmarkCmd(
+	TEXT("String.InlineStringBenchmark"),
+	TEXT("Counts the allocations made, and measures the time taken, when loading config files and parsing with FParse into YString and YInlineString.\n")
+	TEXT("Usage: String.InlineStringBenchmark [NumSections=100] [NumRepeats=10]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&InlineStringBenchmarkCommand)
+	);
+
+#endif // !UE_BUILD_SHIPPING && !PLATFORM_USES_FIXED_GMalloc_CLASS
@@ -0,0 +1,318 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Misc/AssertionMacros.h"
+#include "Containers/Array.h"
+#include "Containers/SolidAngleString.h"
+#include "Containers/CircularQueue.h"
+#include "Containers/LockFreeList.h"
+#include "Containers/MpmcQueue.h"
+#include "Containers/Queue.h"
+#include "Containers/SpscRingBuffer.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Logging/LogMacros.h"
+#include "Math/SolidAngleMathUtility.h"
+#include "Misc/CString.h"
+#include "Templates/Function.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace QueueBenchmark
+{
+	/** Capacity of the bounded queues */
+	static const uint32 QueueSize = 1024;
+
+	/** Elements moved at once by the batched cases */
+	static const uint32 BatchSize = 64;
+
+	/**
+	* The queues are wrapped to offer Push and Pop of up to Num elements, returning how many were moved.
+	* Those that have no batch operations move one element per call.
+	*/
+	struct FMpmcQueueAdapter
+	{
+		TMpmcQueue<uint64> Queue;
+
+		FMpmcQueueAdapter()
+			: Queue(QueueSize)
+		{
+		}
+		uint32 Push(const uint64* Values, uint32 Num)
+		{
+			return Queue.Enqueue(*Values) ? 1 : 0;
+		}
+		uint32 Pop(uint64* Values, uint32 Num)
+		{
+			return Queue.Dequeue(*Values) ? 1 : 0;
+		}
+	};
+
+	struct FSpscRingBufferAdapter
+	{
+		TSpscRingBuffer<uint64> Queue;
+
+		FSpscRingBufferAdapter()
+			: Queue(QueueSize)
+		{
+		}
+		uint32 Push(const uint64* Values, uint32 Num)
+		{
+			return Queue.EnqueueMany(Values, Num);
+		}
+		uint32 Pop(uint64* Values, uint32 Num)
+		{
+			return Queue.DequeueMany(Values, Num);
+		}
+	};
+
+	struct FCircularQueueAdapter
+	{
+		TCircularQueue<uint64> Queue;
+
+		FCircularQueueAdapter()
+			: Queue(QueueSize)
+		{
+		}
+		uint32 Push(const uint64* Values, uint32 Num)
+		{
+			return Queue.Enqueue(*Values) ? 1 : 0;
+		}
+		uint32 Pop(uint64* Values, uint32 Num)
+		{
+			return Queue.Dequeue(*Values) ? 1 : 0;
+		}
+	};
+
+	template<EQueueMode Mode>
+	struct TQueueAdapter
+	{
+		TQueue<uint64, Mode> Queue;
+
+		uint32 Push(const uint64* Values, uint32 Num)
+		{
+			return Queue.Enqueue(*Values) ? 1 : 0;
+		}
+		uint32 Pop(uint64* Values, uint32 Num)
+		{
+			return Queue.Dequeue(*Values) ? 1 : 0;
+		}
+	};
+
+	/** The pointer list is intrusive, so each element gets a node allocated by the producer and freed by the consumer */
+	struct FPointerListAdapter
+	{
+		struct FNode
+		{
+			void* LockFreePointerQueueNext;
+			uint64 Value;
+		};
+
+		FLockFreePointerListFIFOIntrusive<FNode, PLATFORM_CACHE_LINE_SIZE> Queue;
+
+		uint32 Push(const uint64* Values, uint32 Num)
+		{
+			FNode* Node = new FNode;
+			Node->Value = *Values;
+			Queue.Push(Node);
+			return 1;
+		}
+		uint32 Pop(uint64* Values, uint32 Num)
+		{
+			FNode* Node = Queue.Pop();
+			if (!Node)
+			{
+				return 0;
+			}
+			*Values = Node->Value;
+			delete Node;
+			return 1;
+		}
+	};
+
+	/** Waits for all the workers to be ready, then runs the body */
+	class FWorker : public FRunnable
+	{
+	public:
+		FWorker(TFunction<void()>&& InBody, volatile int32& InNumReady, volatile int32& InGo)
+			: Body(MoveTemp(InBody))
+			, NumReady(InNumReady)
+			, Go(InGo)
+		{
+		}
+
+		virtual uint32 Run() override
+		{
+			FPlatformAtomics::InterlockedIncrement(&NumReady);
+			while (!Go)
+			{
+				FPlatformProcess::Sleep(0.0f);
+			}
+			Body();
+			return 0;
+		}
+
+	private:
+		TFunction<void()> Body;
+		volatile int32& NumReady;
+		volatile int32& Go;
+	};
+
+	/**
+	* Moves NumProducers * NumValues values through the queue and logs the throughput. Producers push BatchCount values
+	* at a time; consumers check that the sum of what they popped is right and, when alone, that it came out in order.
+	*/
+	template<typename AdapterType>
+	static void Run(const TCHAR* Name, int32 NumProducers, int32 NumConsumers, int32 NumValues, uint32 BatchCount)
+	{
+		AdapterType* Adapter = new AdapterType();
+		const int64 NumTotal = int64(NumProducers) * NumValues;
+		volatile int64 Sum = 0;
+		volatile int64 NumConsumed = 0;
+		volatile int32 NumReady = 0;
+		volatile int32 Go = 0;
+		bool bInOrder = true;
+		TArray<FWorker*> Workers;
+		TArray<FRunnableThread*> Threads;
+
+		for (int32 ProducerIndex = 0; ProducerIndex < NumProducers; ++ProducerIndex)
+		{
+			Workers.Add(new FWorker([Adapter, ProducerIndex, NumValues, BatchCount]()
+			{
+				uint64 Values[BatchSize];
+				uint64 NextValue = uint64(ProducerIndex) * NumValues + 1;
+				const uint64 EndValue = NextValue + NumValues;
+				while (NextValue < EndValue)
+				{
+					const uint32 Num = uint32(YMath::Min<uint64>(BatchCount, EndValue - NextValue));
+					for (uint32 Index = 0; Index < Num; ++Index)
+					{
+						Values[Index] = NextValue + Index;
+					}
+					uint32 NumPushed = 0;
+					while (NumPushed < Num)
+					{
+						const uint32 NumNow = Adapter->Push(Values + NumPushed, Num - NumPushed);
+						if (!NumNow)
+						{
+							FPlatformProcess::Sleep(0.0f);
+						}
+						NumPushed += NumNow;
+					}
+					NextValue += Num;
+				}
+			}, NumReady, Go));
+		}
+		for (int32 ConsumerIndex = 0; ConsumerIndex < NumConsumers; ++ConsumerIndex)
+		{
+			const bool bCheckOrder = NumProducers == 1 && NumConsumers == 1;
+			Workers.Add(new FWorker([Adapter, NumTotal, BatchCount, bCheckOrder, &Sum, &NumConsumed, &bInOrder]()
+			{
+				uint64 Values[BatchSize];
+				uint64 LastValue = 0;
+				int64 LocalSum = 0;
+				int64 LocalCount = 0;
+				while (true)
+				{
+					const uint32 Num = Adapter->Pop(Values, BatchCount);
+					for (uint32 Index = 0; Index < Num; ++Index)
+					{
+						LocalSum += Values[Index];
+						if (bCheckOrder && Values[Index] != ++LastValue)
+						{
+							bInOrder = false;
+						}
+					}
+					LocalCount += Num;
+					// publish the count now and then, and whenever the queue runs dry, so that everyone can tell when it is over
+					if (LocalCount && (!Num || LocalCount >= 4096))
+					{
+						FPlatformAtomics::InterlockedAdd(&Sum, LocalSum);
+						FPlatformAtomics::InterlockedAdd(&NumConsumed, LocalCount);
+						LocalSum = 0;
+						LocalCount = 0;
+					}
+					if (!Num)
+					{
+						if (NumConsumed >= NumTotal)
+						{
+							break;
+						}
+						FPlatformProcess::Sleep(0.0f);
+					}
+				}
+			}, NumReady, Go));
+		}
+
+		for (int32 WorkerIndex = 0; WorkerIndex < Workers.Num(); ++WorkerIndex)
+		{
+			Threads.Add(FRunnableThread::Create(Workers[WorkerIndex], *YString::Printf(TEXT("QueueBench%d"), WorkerIndex)));
+			check(Threads.Last());
+		}
+		while (NumReady < Workers.Num())
+		{
+			FPlatformProcess::Sleep(0.0f);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		FPlatformAtomics::InterlockedExchange(&Go, 1);
+		for (FRunnableThread* Thread : Threads)
+		{
+			Thread->WaitForCompletion();
+		}
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+		for (FRunnableThread* Thread : Threads)
+		{
+			delete Thread;
+		}
+		for (FWorker* Worker : Workers)
+		{
+			delete Worker;
+		}
+		delete Adapter;
+
+		const bool bValid = NumConsumed == NumTotal && Sum == NumTotal * (NumTotal + 1) / 2 && bInOrder;
+		UE_LOG(LogConsoleResponse, Display, TEXT("%-44s %10.2f Mops/s %8.1f ns/op%s"), Name,
+			double(NumTotal) / Seconds / 1e6, Seconds * 1e9 / double(NumTotal), bValid ? TEXT("") : TEXT("  INVALID RESULT"));
+	}
+}
+
+static void QueueBenchmarkCommand(const TArray<YString>& Args)
+{
+	using namespace QueueBenchmark;
+
+	const int32 NumThreads = Args.Num() > 0 ? YMath::Clamp(FCString::Atoi(*Args[0]), 1, 64) : 4;
+	const int32 NumValues = Args.Num() > 1 ? YMath::Max(1, FCString::Atoi(*Args[1])) : 1000000;
+
+	UE_LOG(LogConsoleResponse, Display, TEXT("%d values per producer, bounded queues hold %u"), NumValues, QueueSize);
+
+	UE_LOG(LogConsoleResponse, Display, TEXT("1 producer, 1 consumer"));
+	Run<FSpscRingBufferAdapter>(TEXT("  TSpscRingBuffer, batches of 64"), 1, 1, NumValues, BatchSize);
+	Run<FSpscRingBufferAdapter>(TEXT("  TSpscRingBuffer"), 1, 1, NumValues, 1);
+	Run<FCircularQueueAdapter>(TEXT("  TCircularQueue"), 1, 1, NumValues, 1);
+	Run<TQueueAdapter<EQueueMode::Spsc>>(TEXT("  TQueue<Spsc>"), 1, 1, NumValues, 1);
+	Run<FMpmcQueueAdapter>(TEXT("  TMpmcQueue"), 1, 1, NumValues, 1);
+	Run<FPointerListAdapter>(TEXT("  FLockFreePointerListFIFOIntrusive"), 1, 1, NumValues, 1);
+
+	UE_LOG(LogConsoleResponse, Display, TEXT("%d producers, 1 consumer"), NumThreads);
+	Run<FMpmcQueueAdapter>(TEXT("  TMpmcQueue"), NumThreads, 1, NumValues, 1);
+	Run<TQueueAdapter<EQueueMode::Mpsc>>(TEXT("  TQueue<Mpsc>"), NumThreads, 1, NumValues, 1);
+	Run<FPointerListAdapter>(TEXT("  FLockFreePointerListFIFOIntrusive"), NumThreads, 1, NumValues, 1);
+
+	UE_LOG(LogConsoleResponse, Display, TEXT("%d producers, %d consumers"), NumThreads, NumThreads);
+	Run<FMpmcQueueAdapter>(TEXT("  TMpmcQueue"), NumThreads, NumThreads, NumValues, 1);
+	Run<FPointerListAdapter>(TEXT("  FLockFreePointerListFIFOIntrusive"), NumThreads, NumThreads, NumValues, 1);
+}
+
+static FAutoConsoleCommand QueueBenchmarkCmd(
+	TEXT("Containers.QueueBenchmark"),
+	TEXT("Measures the throughput of TSpscRingBuffer and TMpmcQueue against TCircularQueue, TQueue and the lock-free pointer list, with one or several producer and consumer threads.\n")
+	TEXT("Usage: Containers.QueueBenchmark [Threads=4] [ValuesPerProducer=1000000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&QueueBenchmarkCommand)
+	);
+
+#endif // !UE_BUILD_SHIPPING
@@ -8,6 +8,7 @@
 #include "HAL/SolidAngleMemory.h"
 #include "Templates/SolidAngleTemplate.h"
 #include "Containers/SolidAngleString.h"
+#include "Containers/StringView.h"
 #include "Logging/LogMacros.h"
 #include "CoreGlobals.h"
 #include "Misc/ByteSwap.h"
@@ -188,6 +189,16 @@ int32 YString::Find(const TCHAR* SubStr, ESearchCase::Type SearchCase, ESearchDi
 	}
 }
 
+int32 YString::Find(const YStringView& SubStr, ESearchCase::Type SearchCase, ESearchDir::Type SearchDir, int32 StartPosition) const
+{
+	return YStringView(*this).Find(SubStr, SearchCase, SearchDir, StartPosition);
+}
+
+bool YString::Split(const YStringView& InS, YStringView* LeftS, YStringView* RightS, ESearchCase::Type SearchCase, ESearchDir::Type SearchDir) const
+{
+	return YStringView(*this).Split(InS, LeftS, RightS, SearchCase, SearchDir);
+}
+
 YString YString::ToUpper() const
 {
 	YString New(**this);
@@ -247,6 +258,11 @@ bool YString::StartsWith(const YString& InPrefix, ESearchCase::Type SearchCase )
 	}
 }
 
+bool YString::StartsWith(const YStringView& InPrefix, ESearchCase::Type SearchCase) const
+{
+	return YStringView(*this).StartsWith(InPrefix, SearchCase);
+}
+
 bool YString::EndsWith(const TCHAR* InSuffix, ESearchCase::Type SearchCase) const
 {
 	if (!InSuffix || *InSuffix == TEXT('\0'))
@@ -288,6 +304,11 @@ bool YString::EndsWith(const YString& InSuffix, ESearchCase::Type SearchCase ) c
 	}
 }
 
+bool YString::EndsWith(const YStringView& InSuffix, ESearchCase::Type SearchCase) const
+{
+	return YStringView(*this).EndsWith(InSuffix, SearchCase);
+}
+
 bool YString::RemoveFromStart( const YString& InPrefix, ESearchCase::Type SearchCase )
 {
 	if ( InPrefix.IsEmpty() )
@@ -740,6 +761,12 @@ int32 YString::ParseIntoArray( TArray<YString>& OutArray, const TCHAR* pchDelim,
 	return OutArray.Num();
 }
 
+int32 YString::ParseIntoArray(TArray<YStringView>& OutArray, const TCHAR* pchDelim, const bool InCullEmpty) const
+{
+	check(pchDelim);
+	return YStringView(*this).ParseIntoArray(OutArray, pchDelim, InCullEmpty);
+}
+
 bool YString::MatchesWildcard(const YString& InWildcard, ESearchCase::Type SearchCase) const
 {
 	YString Wildcard(InWildcard);
@@ -219,6 +219,43 @@ void YGenericPlatformMemory::BinnedFreeToOS(void* Ptr, SIZE_T Size)
 	UE_LOG(LogMemory, Error, TEXT("YGenericPlatformMemory::BinnedFreeToOS not implemented on this platform"));
 }
 
+bool YGenericPlatformMemory::BinnedTryExtendInPlace(void* Ptr, SIZE_T OldSize, SIZE_T NewSize)
+{
+	return false;
+}
+
+SIZE_T YGenericPlatformMemory::GetHugePageSize()
+{
+	return 2 * 1024 * 1024;
+}
+
+void* YGenericPlatformMemory::HugePageAllocFromOS(SIZE_T Size, bool& bOutHugePages)
+{
+	// No huge page support, regular pages still keep the region contiguous
+	bOutHugePages = false;
+	return YPlatformMemory::BinnedAllocFromOS(Size);
+}
+
+void YGenericPlatformMemory::HugePageFreeToOS(void* Ptr, SIZE_T Size)
+{
+	YPlatformMemory::BinnedFreeToOS(Ptr, Size);
+}
+
+uint32 YGenericPlatformMemory::GetNumaNodeCount()
+{
+	return 1;
+}
+
+uint32 YGenericPlatformMemory::GetCurrentNumaNode()
+{
+	return 0;
+}
+
+void* YGenericPlatformMemory::NumaAllocFromOS(SIZE_T Size, uint32 Node)
+{
+	return YPlatformMemory::BinnedAllocFromOS(Size);
+}
+
 void YGenericPlatformMemory::DumpStats(class YOutputDevice& Ar)
 {
 	const float InvMB = 1.0f / 1024.0f / 1024.0f;
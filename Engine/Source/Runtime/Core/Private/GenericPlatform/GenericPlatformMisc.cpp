@@ -931,6 +931,22 @@ int32 YGenericPlatformMisc::NumberOfCoresIncludingHyperthreads()
 	return YPlatformMisc::NumberOfCores();
 }
 
+void YGenericPlatformMisc::GetProcessorTopology(TArray<FProcessorTopology>& OutProcessors)
+{
+	const int32 NumLogical = YMath::Max(YPlatformMisc::NumberOfCoresIncludingHyperthreads(), 1);
+	const int32 NumCores = YMath::Clamp(YPlatformMisc::NumberOfCores(), 1, NumLogical);
+
+	OutProcessors.Empty(NumLogical);
+	for (int32 Index = 0; Index < NumLogical; Index++)
+	{
+		FProcessorTopology& Processor = OutProcessors[OutProcessors.AddUninitialized()];
+		Processor.LogicalId = Index;
+		Processor.CoreId = Index * NumCores / NumLogical;
+		Processor.CacheDomainId = 0;
+		Processor.NodeId = 0;
+	}
+}
+
 int32 YGenericPlatformMisc::NumberOfWorkerThreadsToSpawn()
 {
 	static int32 MaxGameThreads = 4;
@@ -1,10 +1,31 @@
 #include "HAL/Allocators/CachedOSPageAllocator.h"
+#include "HAL/Allocators/HugePageOSAllocator.h"
 #include "HAL/SolidAngleMemory.h"
 #include "Logging/LogMacros.h"
 #include "CoreGlobals.h"
 
+static FORCEINLINE void* AllocFromPageSource(YHugePageOSAllocator* PageSource, SIZE_T Size, int32 NumaNode)
+{
+	if (PageSource)
+	{
+		return PageSource->Allocate(Size);
+	}
+	return NumaNode != INDEX_NONE ? YPlatformMemory::NumaAllocFromOS(Size, NumaNode) : YPlatformMemory::BinnedAllocFromOS(Size);
+}
 
-void* YCachedOSPageAllocator::AllocateImpl(SIZE_T Size, FFreePageBlock* First, FFreePageBlock* Last, uint32& FreedPageBlocksNum, uint32& CachedTotal)
+static FORCEINLINE void FreeToPageSource(YHugePageOSAllocator* PageSource, void* Ptr, SIZE_T Size)
+{
+	if (PageSource)
+	{
+		PageSource->Free(Ptr, Size);
+	}
+	else
+	{
+		YPlatformMemory::BinnedFreeToOS(Ptr, Size);
+	}
+}
+
+void* YCachedOSPageAllocator::AllocateImpl(SIZE_T Size, SIZE_T* OutActualSize, FFreePageBlock* First, FFreePageBlock* Last, uint32& FreedPageBlocksNum, uint32& CachedTotal, YHugePageOSAllocator* PageSource, int32 NumaNode)
 {
 	if (First != Last)
 	{
@@ -20,7 +41,8 @@ void* YCachedOSPageAllocator::AllocateImpl(SIZE_T Size, FFreePageBlock* First, F
 			}
 		}
 
-		if (!Found)
+		// a larger block can only be handed out if the caller frees it with its real size
+		if (!Found && OutActualSize)
 		{
 			SIZE_T SizeTimes4 = Size * 4;
 
@@ -40,6 +62,10 @@ void* YCachedOSPageAllocator::AllocateImpl(SIZE_T Size, FFreePageBlock* First, F
 			void* Result = Found->Ptr;
 			UE_CLOG(!Result, LogMemory, Fatal, TEXT("OS memory allocation cache has been corrupted!"));
 			CachedTotal -= Found->ByteSize;
+			if (OutActualSize)
+			{
+				*OutActualSize = Found->ByteSize;
+			}
 			if (Found + 1 != Last)
 			{
 				YMemory::Memmove(Found, Found + 1, sizeof(FFreePageBlock) * ((Last - Found) - 1));
@@ -48,15 +74,19 @@ void* YCachedOSPageAllocator::AllocateImpl(SIZE_T Size, FFreePageBlock* First, F
 			return Result;
 		}
 
-		if (void* Ptr = YPlatformMemory::BinnedAllocFromOS(Size))
+		if (void* Ptr = AllocFromPageSource(PageSource, Size, NumaNode))
 		{
+			if (OutActualSize)
+			{
+				*OutActualSize = Size;
+			}
 			return Ptr;
 		}
 
 		// Are we holding on to much mem? Release it all.
 		for (FFreePageBlock* Block = First; Block != Last; ++Block)
 		{
-			YPlatformMemory::BinnedFreeToOS(Block->Ptr, Block->ByteSize);
+			FreeToPageSource(PageSource, Block->Ptr, Block->ByteSize);
 			Block->Ptr      = nullptr;
 			Block->ByteSize = 0;
 		}
@@ -64,14 +94,18 @@ void* YCachedOSPageAllocator::AllocateImpl(SIZE_T Size, FFreePageBlock* First, F
 		CachedTotal        = 0;
 	}
 
-	return YPlatformMemory::BinnedAllocFromOS(Size);
+	if (OutActualSize)
+	{
+		*OutActualSize = Size;
+	}
+	return AllocFromPageSource(PageSource, Size, NumaNode);
 }
 
-void YCachedOSPageAllocator::FreeImpl(void* Ptr, SIZE_T Size, uint32 NumCacheBlocks, uint32 CachedByteLimit, FFreePageBlock* First, uint32& FreedPageBlocksNum, uint32& CachedTotal)
+void YCachedOSPageAllocator::FreeImpl(void* Ptr, SIZE_T Size, uint32 NumCacheBlocks, uint32 CachedByteLimit, FFreePageBlock* First, uint32& FreedPageBlocksNum, uint32& CachedTotal, YHugePageOSAllocator* PageSource)
 {
 	if (Size > CachedByteLimit / 4)
 	{
-		YPlatformMemory::BinnedFreeToOS(Ptr, Size);
+		FreeToPageSource(PageSource, Ptr, Size);
 		return;
 	}
 
@@ -86,7 +120,7 @@ void YCachedOSPageAllocator::FreeImpl(void* Ptr, SIZE_T Size, uint32 NumCacheBlo
 		{
 			YMemory::Memmove(First, First + 1, sizeof(FFreePageBlock) * FreedPageBlocksNum);
 		}
-		YPlatformMemory::BinnedFreeToOS(FreePtr, FreeSize);
+		FreeToPageSource(PageSource, FreePtr, FreeSize);
 	}
 
 	First[FreedPageBlocksNum].Ptr      = Ptr;
@@ -96,7 +130,7 @@ void YCachedOSPageAllocator::FreeImpl(void* Ptr, SIZE_T Size, uint32 NumCacheBlo
 	++FreedPageBlocksNum;
 }
 
-void YCachedOSPageAllocator::FreeAllImpl(FFreePageBlock* First, uint32& FreedPageBlocksNum, uint32& CachedTotal)
+void YCachedOSPageAllocator::FreeAllImpl(FFreePageBlock* First, uint32& FreedPageBlocksNum, uint32& CachedTotal, YHugePageOSAllocator* PageSource)
 {
 	while (FreedPageBlocksNum)
 	{
@@ -109,6 +143,6 @@ void YCachedOSPageAllocator::FreeAllImpl(FFreePageBlock* First, uint32& FreedPag
 		{
 			YMemory::Memmove(First, First + 1, sizeof(FFreePageBlock)* FreedPageBlocksNum);
 		}
-		YPlatformMemory::BinnedFreeToOS(FreePtr, FreeSize);
+		FreeToPageSource(PageSource, FreePtr, FreeSize);
 	}
 }
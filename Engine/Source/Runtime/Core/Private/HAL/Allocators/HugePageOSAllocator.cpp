@@ -0,0 +1,209 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "HAL/Allocators/HugePageOSAllocator.h"
+#include "HAL/SolidAngleMemory.h"
+#include "Templates/AlignmentTemplates.h"
+#include "Misc/AssertionMacros.h"
+
+namespace HugePageOSAllocatorPrivate
+{
+	/** Returns the index of the first run of NumBits set bits in Mask, or INDEX_NONE. */
+	static int32 FindFreeRun(uint64 Mask, uint32 NumBits, uint32 MaskBits)
+	{
+		const uint64 RunMask = (NumBits == 64) ? ~(uint64)0 : (((uint64)1 << NumBits) - 1);
+		for (uint32 Index = 0; Index + NumBits <= MaskBits; ++Index)
+		{
+			if (((Mask >> Index) & RunMask) == RunMask)
+			{
+				return int32(Index);
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	static FORCEINLINE uint64 MakeRunMask(uint32 FirstBit, uint32 NumBits)
+	{
+		return ((NumBits == 64) ? ~(uint64)0 : (((uint64)1 << NumBits) - 1)) << FirstBit;
+	}
+}
+
+bool YHugePageOSAllocator::Init(SIZE_T InChunkSize)
+{
+	check(!NumRegions && !Stats.FallbackBytes);
+
+	const SIZE_T HugePageSize = YPlatformMemory::GetHugePageSize();
+	// This runs while the allocator is being created, so don't log
+	if (!InChunkSize || HugePageSize % InChunkSize != 0 || HugePageSize / InChunkSize > 64 || HugePageSize / InChunkSize < 2)
+	{
+		return false;
+	}
+
+	ChunkSize       = InChunkSize;
+	RegionSize      = HugePageSize;
+	ChunksPerRegion = uint32(HugePageSize / InChunkSize);
+	return true;
+}
+
+void* YHugePageOSAllocator::Allocate(SIZE_T Size)
+{
+	if (IsEnabled())
+	{
+		const SIZE_T AlignedSize = Align(Size, ChunkSize);
+		const uint32 NumChunks = uint32(AlignedSize / ChunkSize);
+
+		// Carving more than half a region just leaves unusable holes behind
+		if (NumChunks <= ChunksPerRegion / 2)
+		{
+			int32 RegionIndex = INDEX_NONE;
+			int32 FirstChunk  = INDEX_NONE;
+			for (uint32 Index = 0; Index < NumRegions; ++Index)
+			{
+				if (Regions[Index].NumFreeChunks >= NumChunks)
+				{
+					FirstChunk = HugePageOSAllocatorPrivate::FindFreeRun(Regions[Index].FreeMask, NumChunks, ChunksPerRegion);
+					if (FirstChunk != INDEX_NONE)
+					{
+						RegionIndex = int32(Index);
+						break;
+					}
+				}
+			}
+
+			if (RegionIndex == INDEX_NONE)
+			{
+				RegionIndex = AddRegion();
+				FirstChunk  = 0;
+			}
+
+			if (RegionIndex != INDEX_NONE)
+			{
+				FRegion& Region = Regions[RegionIndex];
+				Region.FreeMask      &= ~HugePageOSAllocatorPrivate::MakeRunMask(FirstChunk, NumChunks);
+				Region.NumFreeChunks -= NumChunks;
+				Stats.CarvedBytes    += AlignedSize;
+				return Region.Base + FirstChunk * ChunkSize;
+			}
+		}
+	}
+
+	void* Result = YPlatformMemory::BinnedAllocFromOS(Size);
+	if (Result)
+	{
+		Stats.FallbackBytes += Size;
+	}
+	return Result;
+}
+
+void YHugePageOSAllocator::Free(void* Ptr, SIZE_T Size)
+{
+	const int32 RegionIndex = FindRegion(Ptr);
+	if (RegionIndex == INDEX_NONE)
+	{
+		Stats.FallbackBytes -= Size;
+		YPlatformMemory::BinnedFreeToOS(Ptr, Size);
+		return;
+	}
+
+	FRegion& Region = Regions[RegionIndex];
+	const SIZE_T AlignedSize = Align(Size, ChunkSize);
+	const uint32 NumChunks  = uint32(AlignedSize / ChunkSize);
+	const uint32 FirstChunk = uint32(((uint8*)Ptr - Region.Base) / ChunkSize);
+	const uint64 RunMask    = HugePageOSAllocatorPrivate::MakeRunMask(FirstChunk, NumChunks);
+	checkf((Region.FreeMask & RunMask) == 0, TEXT("Huge page chunk %p freed twice"), Ptr);
+
+	Region.FreeMask      |= RunMask;
+	Region.NumFreeChunks += NumChunks;
+	Stats.CarvedBytes    -= AlignedSize;
+
+	if (Region.NumFreeChunks == ChunksPerRegion)
+	{
+		// Keep a single empty region around so that a pool being freed and reallocated doesn't hit the OS every time
+		for (uint32 Index = 0; Index < NumRegions; ++Index)
+		{
+			if (Index != uint32(RegionIndex) && Regions[Index].NumFreeChunks == ChunksPerRegion)
+			{
+				RemoveRegion(RegionIndex);
+				break;
+			}
+		}
+	}
+}
+
+int32 YHugePageOSAllocator::FindRegion(const void* Ptr) const
+{
+	// Binary search for the last region starting at or before Ptr
+	int32 Low  = 0;
+	int32 High = int32(NumRegions);
+	while (Low < High)
+	{
+		const int32 Mid = (Low + High) / 2;
+		if (Regions[Mid].Base <= (const uint8*)Ptr)
+		{
+			Low = Mid + 1;
+		}
+		else
+		{
+			High = Mid;
+		}
+	}
+
+	const int32 Index = Low - 1;
+	if (Index >= 0 && (const uint8*)Ptr < Regions[Index].Base + RegionSize)
+	{
+		return Index;
+	}
+	return INDEX_NONE;
+}
+
+int32 YHugePageOSAllocator::AddRegion()
+{
+	if (NumRegions == HUGEPAGE_MAX_REGIONS)
+	{
+		return INDEX_NONE;
+	}
+
+	bool bHugePages = false;
+	uint8* Base = (uint8*)YPlatformMemory::HugePageAllocFromOS(RegionSize, bHugePages);
+	if (!Base)
+	{
+		return INDEX_NONE;
+	}
+	check(IsAligned(Base, ChunkSize));
+
+	int32 Index = int32(NumRegions);
+	while (Index > 0 && Regions[Index - 1].Base > Base)
+	{
+		--Index;
+	}
+	if (Index != int32(NumRegions))
+	{
+		YMemory::Memmove(&Regions[Index + 1], &Regions[Index], sizeof(FRegion) * (NumRegions - Index));
+	}
+	++NumRegions;
+
+	FRegion& Region = Regions[Index];
+	Region.Base          = Base;
+	Region.FreeMask      = HugePageOSAllocatorPrivate::MakeRunMask(0, ChunksPerRegion);
+	Region.NumFreeChunks = ChunksPerRegion;
+	Region.bHugePages    = bHugePages;
+
+	++Stats.NumRegions;
+	Stats.RegionBytes   += RegionSize;
+	Stats.HugePageBytes += bHugePages ? RegionSize : 0;
+	return Index;
+}
+
+void YHugePageOSAllocator::RemoveRegion(int32 Index)
+{
+	const FRegion Region = Regions[Index];
+	--NumRegions;
+	if (Index != int32(NumRegions))
+	{
+		YMemory::Memmove(&Regions[Index], &Regions[Index + 1], sizeof(FRegion) * (NumRegions - Index));
+	}
+
+	--Stats.NumRegions;
+	Stats.RegionBytes   -= RegionSize;
+	Stats.HugePageBytes -= Region.bHugePages ? RegionSize : 0;
+	YPlatformMemory::HugePageFreeToOS(Region.Base, RegionSize);
+}
@@ -11,6 +11,15 @@
 #include "GenericPlatform/GenericPlatformProcess.h"
 #include "Stats/Stats.h"
 #include "HAL/IConsoleManager.h"
+#include "HAL/MemoryMisc.h"
+#include "Misc/OutputDevice.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include <stdio.h>
 
 
 #if BINNED2_ALLOW_RUNTIME_TWEAKING
@@ -55,7 +64,8 @@ static FAutoConsoleVariableRef GMallocBinned2AllocExtraCVar(
 // Block sizes are based around getting the maximum amount of allocations per pool, with as little alignment waste as possible.
 // Block sizes should be close to even divisors of the system page size, and well distributed.
 // They must be 16-byte aligned as well.
-static uint16 SmallBlockSizes[] =
+// A different table can be passed to the constructor, see -binned2sizes and MallocBinned2.SaveSizeClasses.
+static const uint16 DefaultSmallBlockSizes[] =
 {
 	16, 32, 48, 64, 80, 96, 112, 128,
 	160, 192, 224, 256, 288, 320, 384, 448,
@@ -72,7 +82,25 @@ uint32 YMallocBinned2::OsAllocationGranularity = 0;
 uint32 YMallocBinned2::PageSize = 0;
 YMallocBinned2* YMallocBinned2::MallocBinned2 = nullptr;
 // Mapping of sizes to small table indices
-uint8 YMallocBinned2::MemSizeToIndex[1 + (BINNED2_MAX_SMALL_POOL_SIZE >> BINNED2_MINIMUM_ALIGNMENT_SHIFT)] = { 0 };
+uint8 YMallocBinned2::MemSizeToIndex[BINNED2_SIZE_BUCKET_COUNT] = { 0 };
+
+int32 GMallocBinned2RemoteFrees = DEFAULT_GMallocBinned2RemoteFrees;
+static FAutoConsoleVariableRef GMallocBinned2RemoteFreesCVar(
+	TEXT("MallocBinned2.RemoteFrees"),
+	GMallocBinned2RemoteFrees,
+	TEXT("When a thread frees small blocks of a pool that another thread allocates from, hand the full bundles straight to that thread instead of going through the global recycler and the allocator lock")
+	);
+
+#if BINNED2_ALLOCATOR_STATS
+int64 YMallocBinned2::SizeProfile[BINNED2_SIZE_BUCKET_COUNT] = { 0 };
+
+int32 GMallocBinned2CaptureSizeProfile = 0;
+static FAutoConsoleVariableRef GMallocBinned2CaptureSizeProfileCVar(
+	TEXT("MallocBinned2.CaptureSizeProfile"),
+	GMallocBinned2CaptureSizeProfile,
+	TEXT("Counts small allocations per size so that MallocBinned2.SaveSizeClasses can compute a table of block sizes for this workload")
+	);
+#endif
 
 YMallocBinned2::FPoolList::FPoolList()
 	: Front(nullptr)
@@ -383,16 +411,18 @@ struct YMallocBinned2::Private
 		return nullptr;
 	}
 
+	// Bundles only ever hold blocks of one NUMA node, so the recycler keeps them apart
 	struct FGlobalRecycler
 	{
-		bool PushBundle(uint32 InPoolIndex, FBundleNode* InBundle)
+		bool PushBundle(uint32 InNumaNode, uint32 InPoolIndex, FBundleNode* InBundle)
 		{
+			FPaddedBundlePointer& Slots = Bundles[InNumaNode][InPoolIndex];
 			uint32 NumCachedBundles = YMath::Min<uint32>(GMallocBinned2MaxBundlesBeforeRecycle, BINNED2_MAX_GMallocBinned2MaxBundlesBeforeRecycle);
 			for (uint32 Slot = 0; Slot < NumCachedBundles; Slot++)
 			{
-				if (!Bundles[InPoolIndex].FreeBundles[Slot])
+				if (!Slots.FreeBundles[Slot])
 				{
-					if (!FPlatformAtomics::InterlockedCompareExchangePointer((void**)&Bundles[InPoolIndex].FreeBundles[Slot], InBundle, nullptr))
+					if (!FPlatformAtomics::InterlockedCompareExchangePointer((void**)&Slots.FreeBundles[Slot], InBundle, nullptr))
 					{
 						return true;
 					}
@@ -401,15 +431,16 @@ struct YMallocBinned2::Private
 			return false;
 		}
 
-		FBundleNode* PopBundle(uint32 InPoolIndex)
+		FBundleNode* PopBundle(uint32 InNumaNode, uint32 InPoolIndex)
 		{
+			FPaddedBundlePointer& Slots = Bundles[InNumaNode][InPoolIndex];
 			uint32 NumCachedBundles = YMath::Min<uint32>(GMallocBinned2MaxBundlesBeforeRecycle, BINNED2_MAX_GMallocBinned2MaxBundlesBeforeRecycle);
 			for (uint32 Slot = 0; Slot < NumCachedBundles; Slot++)
 			{
-				FBundleNode* Result = Bundles[InPoolIndex].FreeBundles[Slot];
+				FBundleNode* Result = Slots.FreeBundles[Slot];
 				if (Result)
 				{
-					if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&Bundles[InPoolIndex].FreeBundles[Slot], nullptr, Result) == Result)
+					if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&Slots.FreeBundles[Slot], nullptr, Result) == Result)
 					{
 						return Result;
 					}
@@ -432,15 +463,51 @@ struct YMallocBinned2::Private
 			}
 		};
 		static_assert(sizeof(FPaddedBundlePointer) == PLATFORM_CACHE_LINE_SIZE, "FPaddedBundlePointer should be the same size as a cache line");
-		MS_ALIGN(PLATFORM_CACHE_LINE_SIZE) FPaddedBundlePointer Bundles[BINNED2_SMALL_POOL_COUNT] GCC_ALIGN(PLATFORM_CACHE_LINE_SIZE);
+		MS_ALIGN(PLATFORM_CACHE_LINE_SIZE) FPaddedBundlePointer Bundles[BINNED2_MAX_NUMA_NODES][BINNED2_SMALL_POOL_COUNT] GCC_ALIGN(PLATFORM_CACHE_LINE_SIZE);
 	};
 
 	static FGlobalRecycler GGlobalRecycler;
 
-	static void FreeBundles(YMallocBinned2& Allocator, FBundleNode* BundlesToRecycle, uint32 InBlockSize, uint32 InPoolIndex)
+	// Blocks freed by threads of other NUMA nodes, chained into one bundle through NextNodeInCurrentBundle.
+	// Any thread pushes, threads of the node take the whole chain at once, so there is no ABA to worry about.
+	struct FNodeFreeList
 	{
-		FPoolTable& Table = Allocator.SmallPoolTables[InPoolIndex];
+		void Push(FBundleNode* Node)
+		{
+			while (true)
+			{
+				FBundleNode* OldHead = Head;
+				Node->NextNodeInCurrentBundle = OldHead;
+				if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&Head, Node, OldHead) == OldHead)
+				{
+					return;
+				}
+			}
+		}
+
+		FBundleNode* PopAll()
+		{
+			if (!Head)
+			{
+				return nullptr;
+			}
+			FBundleNode* Result = (FBundleNode*)FPlatformAtomics::InterlockedExchangePtr((void**)&Head, nullptr);
+			if (Result)
+			{
+				Result->NextBundle = nullptr;
+			}
+			return Result;
+		}
 
+		FBundleNode* volatile Head;
+		uint8 Padding[PLATFORM_CACHE_LINE_SIZE - sizeof(FBundleNode*)];
+	};
+	static_assert(sizeof(FNodeFreeList) == PLATFORM_CACHE_LINE_SIZE, "FNodeFreeList should be the same size as a cache line");
+
+	MS_ALIGN(PLATFORM_CACHE_LINE_SIZE) static FNodeFreeList GNodeFreeLists[BINNED2_MAX_NUMA_NODES][BINNED2_SMALL_POOL_COUNT] GCC_ALIGN(PLATFORM_CACHE_LINE_SIZE);
+
+	static void FreeBundles(YMallocBinned2& Allocator, FBundleNode* BundlesToRecycle, uint32 InBlockSize, uint32 InPoolIndex)
+	{
 		FBundleNode* Bundle = BundlesToRecycle;
 		while (Bundle)
 		{
@@ -457,12 +524,18 @@ struct YMallocBinned2::Private
 				}
 				NodePool->CheckCanary(FPoolInfo::ECanary::FirstFreeBlockIsPtr);
 
+				const uint32 NumaNode = GetPoolHeaderFromPointer(Node)->NumaNode;
+				FPoolTable& Table = Allocator.SmallPoolTables[NumaNode][InPoolIndex];
+
 				// If this pool was exhausted, move to available list.
 				if (!NodePool->FirstFreeBlock)
 				{
 					Table.ActivePools.LinkToFront(NodePool);
 				}
 
+#if BINNED2_ALLOCATOR_STATS
+				++Table.Counters.PoolFrees;
+#endif
 				// Free a pooled allocation.
 				FFreeBlock* Free = (FFreeBlock*)Node;
 				Free->NumFreeBlocks = 1;
@@ -479,7 +552,10 @@ struct YMallocBinned2::Private
 
 					// Free the OS memory.
 					NodePool->Unlink();
-					Allocator.CachedOSPageAllocator.Free(BasePtrOfNode, Allocator.PageSize);
+					Allocator.GetPoolPageAllocator(NumaNode).Free(BasePtrOfNode, Allocator.PageSize);
+#if BINNED2_ALLOCATOR_STATS
+					++Table.Counters.OSFrees;
+#endif
 				}
 
 				Node = NextNode;
@@ -491,6 +567,7 @@ struct YMallocBinned2::Private
 };
 
 YMallocBinned2::Private::FGlobalRecycler YMallocBinned2::Private::GGlobalRecycler;
+YMallocBinned2::Private::FNodeFreeList YMallocBinned2::Private::GNodeFreeLists[BINNED2_MAX_NUMA_NODES][BINNED2_SMALL_POOL_COUNT];
 
 FORCEINLINE bool YMallocBinned2::FPoolList::IsEmpty() const
 {
@@ -515,17 +592,21 @@ void YMallocBinned2::FPoolList::LinkToFront(FPoolInfo* Pool)
 	Pool->Link(Front);
 }
 
-YMallocBinned2::FPoolInfo& YMallocBinned2::FPoolList::PushNewPoolToFront(YMallocBinned2& Allocator, uint32 InBlockSize, uint32 InPoolIndex)
+YMallocBinned2::FPoolInfo& YMallocBinned2::FPoolList::PushNewPoolToFront(YMallocBinned2& Allocator, uint32 InBlockSize, uint32 InPoolIndex, uint32 InNumaNode)
 {
 	const uint32 LocalPageSize = Allocator.PageSize;
 
 	// Allocate memory.
-	FFreeBlock* Free = new (Allocator.CachedOSPageAllocator.Allocate(LocalPageSize)) FFreeBlock(LocalPageSize, InBlockSize, InPoolIndex);
+	FFreeBlock* Free = new (Allocator.GetPoolPageAllocator(InNumaNode).Allocate(LocalPageSize)) FFreeBlock(LocalPageSize, InBlockSize, InPoolIndex);
 	if (!Free)
 	{
 		Private::OutOfMemory(LocalPageSize);
 	}
 	check(IsAligned(Free, LocalPageSize));
+	Free->NumaNode = uint8(InNumaNode);
+#if BINNED2_ALLOCATOR_STATS
+	++Allocator.SmallPoolTables[InNumaNode][InPoolIndex].Counters.OSCommits;
+#endif
 	// Create pool
 	FPoolInfo* Result = Private::GetOrCreatePoolInfo(Allocator, Free, FPoolInfo::ECanary::FirstFreeBlockIsPtr, false);
 	Result->Link(Front);
@@ -535,19 +616,43 @@ YMallocBinned2::FPoolInfo& YMallocBinned2::FPoolList::PushNewPoolToFront(YMalloc
 	return *Result;
 }
 
-YMallocBinned2::YMallocBinned2()
+YMallocBinned2::YMallocBinned2(bool bUseHugePages, const uint16* InSmallBlockSizes, bool bUseNuma)
 	: HashBucketFreeList(nullptr)
+	, bNumaAware(false)
+	, NumNumaNodes(1)
+#if BINNED2_ALLOCATOR_STATS
+	, RegisteredThreadLists(nullptr)
+#endif
+	, bCustomSmallBlockSizes(false)
+	, SmallBlockSizesError(nullptr)
 {
 	static bool bOnce = false;
 	check(!bOnce); // this is now a singleton-like thing and you cannot make multiple copies
 	bOnce = true;
 
+	for (uint32 NumaNode = 0; NumaNode < BINNED2_MAX_NUMA_NODES; ++NumaNode)
+	{
+		for (uint32 PoolIndex = 0; PoolIndex < BINNED2_SMALL_POOL_COUNT; ++PoolIndex)
+		{
+			RemoteFreeOwners[NumaNode][PoolIndex] = nullptr;
+		}
+	}
+
+	YGenericPlatformMemoryConstants Constants = YPlatformMemory::GetConstants();
+
+	// This runs before logging is possible, a rejected table is reported by DumpAllocatorStats
+	const uint16* SmallBlockSizes = DefaultSmallBlockSizes;
+	if (InSmallBlockSizes && ValidateSmallBlockSizes(InSmallBlockSizes, Constants.PageSize, &SmallBlockSizesError))
+	{
+		SmallBlockSizes = InSmallBlockSizes;
+		bCustomSmallBlockSizes = true;
+	}
+
 	for (uint32 Index = 0; Index != BINNED2_SMALL_POOL_COUNT; ++Index)
 	{
 		uint32 Partner = BINNED2_SMALL_POOL_COUNT - Index - 1;
 		SmallBlockSizesReversed[Index] = SmallBlockSizes[Partner];
 	}
-	YGenericPlatformMemoryConstants Constants = YPlatformMemory::GetConstants();
 	PageSize = Constants.PageSize;
 	OsAllocationGranularity = Constants.OsAllocationGranularity ? Constants.OsAllocationGranularity : PageSize;
 	NumPoolsPerPage = PageSize / sizeof(FPoolInfo);
@@ -559,8 +664,8 @@ YMallocBinned2::YMallocBinned2()
 	checkf(SmallBlockSizes[BINNED2_SMALL_POOL_COUNT - 1] == BINNED2_MAX_SMALL_POOL_SIZE, TEXT("BINNED2_MAX_SMALL_POOL_SIZE must equal the smallest block size"));
 	checkf(PageSize % BINNED2_LARGE_ALLOC == 0, TEXT("OS page size must be a multiple of BINNED2_LARGE_ALLOC"));
 	checkf(sizeof(YMallocBinned2::FFreeBlock) <= SmallBlockSizes[0], TEXT("Pool header must be able to fit into the smallest block"));
-	static_assert(ARRAY_COUNT(SmallBlockSizes) == BINNED2_SMALL_POOL_COUNT, "Small block size array size must match BINNED2_SMALL_POOL_COUNT");
-	static_assert(ARRAY_COUNT(SmallBlockSizes) <= 256, "Small block size array size must fit in a byte");
+	static_assert(ARRAY_COUNT(DefaultSmallBlockSizes) == BINNED2_SMALL_POOL_COUNT, "Small block size array size must match BINNED2_SMALL_POOL_COUNT");
+	static_assert(ARRAY_COUNT(DefaultSmallBlockSizes) <= 256, "Small block size array size must fit in a byte");
 	static_assert(sizeof(FFreeBlock) <= BINNED2_MINIMUM_ALIGNMENT, "Free block struct must be small enough to fit into a block.");
 
 	// Init pool tables.
@@ -570,13 +675,16 @@ YMallocBinned2::YMallocBinned2()
 		checkf(SmallBlockSizes[Index] <= PageSize, TEXT("Small block size must be small enough to fit into a page"));
 		checkf(SmallBlockSizes[Index] % BINNED2_MINIMUM_ALIGNMENT == 0, TEXT("Small block size must be a multiple of BINNED2_MINIMUM_ALIGNMENT"));
 
-		SmallPoolTables[Index].BlockSize = SmallBlockSizes[Index];
+		for (uint32 NumaNode = 0; NumaNode < BINNED2_MAX_NUMA_NODES; ++NumaNode)
+		{
+			SmallPoolTables[NumaNode][Index].BlockSize = SmallBlockSizes[Index];
+		}
 	}
 
 	// Set up pool mappings
 	uint8* IndexEntry = MemSizeToIndex;
 	uint32  PoolIndex  = 0;
-	for (uint32 Index = 0; Index != 1 + (BINNED2_MAX_SMALL_POOL_SIZE >> BINNED2_MINIMUM_ALIGNMENT_SHIFT); ++Index)
+	for (uint32 Index = 0; Index != BINNED2_SIZE_BUCKET_COUNT; ++Index)
 	{
 		
 		uint32 BlockSize = Index << BINNED2_MINIMUM_ALIGNMENT_SHIFT; // inverse of int32 Index = int32((Size >> BINNED2_MINIMUM_ALIGNMENT_SHIFT));
@@ -600,6 +708,22 @@ YMallocBinned2::YMallocBinned2()
 
 	HashBuckets = (PoolHashBucket*)YPlatformMemory::BinnedAllocFromOS(Align(MaxHashBuckets * sizeof(PoolHashBucket), OsAllocationGranularity));
 	DefaultConstructItems<PoolHashBucket>(HashBuckets, MaxHashBuckets);
+
+	if (bUseHugePages && HugePageOSAllocator.Init(PageSize))
+	{
+		CachedOSPageAllocator.SetPageSource(&HugePageOSAllocator);
+	}
+
+	if (bUseNuma && YPlatformMemory::GetNumaNodeCount() > 1)
+	{
+		bNumaAware = true;
+		NumNumaNodes = YMath::Min<uint32>(YPlatformMemory::GetNumaNodeCount(), BINNED2_MAX_NUMA_NODES);
+		for (uint32 NumaNode = 0; NumaNode < NumNumaNodes; ++NumaNode)
+		{
+			NodePageAllocators[NumaNode].SetNumaNode(NumaNode);
+		}
+	}
+
 	MallocBinned2 = this;
 	GFixedMallocLocationPtr = (YMalloc**)(&MallocBinned2);
 }
@@ -608,6 +732,217 @@ YMallocBinned2::~YMallocBinned2()
 {
 }
 
+const uint16* YMallocBinned2::GetDefaultSmallBlockSizes()
+{
+	return DefaultSmallBlockSizes;
+}
+
+void YMallocBinned2::GetSmallBlockSizes(uint16* OutSizes)
+{
+	for (uint32 Index = 0; Index != BINNED2_SMALL_POOL_COUNT; ++Index)
+	{
+		OutSizes[Index] = PoolIndexToBlockSize(Index);
+	}
+}
+
+bool YMallocBinned2::ValidateSmallBlockSizes(const uint16* Sizes, uint32 InPageSize, const TCHAR** OutError)
+{
+	const TCHAR* Error = nullptr;
+	if (Sizes[BINNED2_SMALL_POOL_COUNT - 1] != BINNED2_MAX_SMALL_POOL_SIZE)
+	{
+		Error = TEXT("The last block size must equal BINNED2_MAX_SMALL_POOL_SIZE");
+	}
+	else if (Sizes[0] < sizeof(FFreeBlock))
+	{
+		Error = TEXT("Pool header must be able to fit into the smallest block");
+	}
+	for (uint32 Index = 0; Index != BINNED2_SMALL_POOL_COUNT && !Error; ++Index)
+	{
+		if (Index > 0 && Sizes[Index - 1] >= Sizes[Index])
+		{
+			Error = TEXT("Small block sizes must be strictly increasing");
+		}
+		else if (Sizes[Index] > InPageSize)
+		{
+			Error = TEXT("Small block size must be small enough to fit into a page");
+		}
+		else if (Sizes[Index] % BINNED2_MINIMUM_ALIGNMENT != 0)
+		{
+			Error = TEXT("Small block size must be a multiple of BINNED2_MINIMUM_ALIGNMENT");
+		}
+	}
+
+	if (OutError)
+	{
+		*OutError = Error;
+	}
+	return Error == nullptr;
+}
+
+bool YMallocBinned2::ParseSmallBlockSizes(const ANSICHAR* Value, uint16* OutSizes)
+{
+	// A list starts with a digit, anything else is a file name
+	ANSICHAR FileContents[4096];
+	if (*Value < '0' || *Value > '9')
+	{
+		FILE* File = fopen(Value, "rb");
+		if (!File)
+		{
+			return false;
+		}
+		const SIZE_T Read = fread(FileContents, 1, sizeof(FileContents) - 1, File);
+		fclose(File);
+		FileContents[Read] = 0;
+		Value = FileContents;
+	}
+
+	uint32 NumSizes = 0;
+	for (const ANSICHAR* Ch = Value; *Ch; )
+	{
+		if (*Ch == ';')
+		{
+			while (*Ch && *Ch != '\n')
+			{
+				++Ch;
+			}
+		}
+		else if (*Ch >= '0' && *Ch <= '9')
+		{
+			uint32 Size = 0;
+			for (; *Ch >= '0' && *Ch <= '9'; ++Ch)
+			{
+				Size = Size * 10 + uint32(*Ch - '0');
+				if (Size > MAX_uint16)
+				{
+					return false;
+				}
+			}
+			if (NumSizes == BINNED2_SMALL_POOL_COUNT)
+			{
+				return false;
+			}
+			OutSizes[NumSizes++] = uint16(Size);
+		}
+		else if (*Ch == ',' || *Ch == ' ' || *Ch == '\t' || *Ch == '\r' || *Ch == '\n')
+		{
+			++Ch;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return NumSizes == BINNED2_SMALL_POOL_COUNT;
+}
+
+namespace MallocBinned2SizeClasses
+{
+	/** Bytes lost at the end of a page by a pool of the given block size, spread over its blocks. */
+	static double PageTailPerBlock(uint32 BlockSize, uint32 InPageSize)
+	{
+		// Same block count as FFreeBlock
+		uint32 NumBlocks = InPageSize / BlockSize;
+		if (NumBlocks * BlockSize + BINNED2_MINIMUM_ALIGNMENT > InPageSize)
+		{
+			NumBlocks--;
+		}
+		return NumBlocks ? double(InPageSize - NumBlocks * BlockSize) / double(NumBlocks) : double(InPageSize);
+	}
+}
+
+void YMallocBinned2::ComputeSmallBlockSizes(const uint64* SizeCounts, uint32 InPageSize, uint16* OutSizes)
+{
+	// Bucket i holds requests rounded up to i * BINNED2_MINIMUM_ALIGNMENT bytes; zero sized requests go to the smallest pool.
+	// Every bucket gets one extra request so that sizes missing from the profile still count for something.
+	const int32 NumBuckets = BINNED2_SIZE_BUCKET_COUNT - 1;
+	TArray<double> Weights;
+	TArray<double> WeightedBuckets;
+	Weights.AddZeroed(NumBuckets + 1);
+	WeightedBuckets.AddZeroed(NumBuckets + 1);
+	for (int32 Bucket = 1; Bucket <= NumBuckets; ++Bucket)
+	{
+		const double Weight = double(SizeCounts[Bucket] + (Bucket == 1 ? SizeCounts[0] : 0) + 1);
+		Weights[Bucket] = Weights[Bucket - 1] + Weight;
+		WeightedBuckets[Bucket] = WeightedBuckets[Bucket - 1] + Weight * Bucket;
+	}
+
+	TArray<double> TailPerBlock;
+	TailPerBlock.AddZeroed(NumBuckets + 1);
+	for (int32 Bucket = 1; Bucket <= NumBuckets; ++Bucket)
+	{
+		TailPerBlock[Bucket] = MallocBinned2SizeClasses::PageTailPerBlock(Bucket << BINNED2_MINIMUM_ALIGNMENT_SHIFT, InPageSize);
+	}
+
+	// Cost[Pools][Last] is the least waste serving buckets 1..Last with Pools pools, the largest one being Last
+	const double Infinity = 1e300;
+	TArray<double> Cost;
+	TArray<uint16> Previous;
+	Cost.Init(Infinity, (BINNED2_SMALL_POOL_COUNT + 1) * (NumBuckets + 1));
+	Previous.AddZeroed((BINNED2_SMALL_POOL_COUNT + 1) * (NumBuckets + 1));
+	Cost[0] = 0.0;
+
+	for (int32 Pools = 1; Pools <= BINNED2_SMALL_POOL_COUNT; ++Pools)
+	{
+		double* CostRow = &Cost[Pools * (NumBuckets + 1)];
+		const double* PreviousRow = &Cost[(Pools - 1) * (NumBuckets + 1)];
+		uint16* PreviousBucket = &Previous[Pools * (NumBuckets + 1)];
+		for (int32 Last = Pools; Last <= NumBuckets; ++Last)
+		{
+			// The pool serves buckets First + 1..Last, and may be at most a third larger than its smallest request
+			const int32 MinFirst = YMath::Max(Pools - 1, YMath::Min(Last - 1, (3 * Last + 3) / 4 - 1));
+			const double BlockTail = TailPerBlock[Last];
+			for (int32 First = MinFirst; First < Last; ++First)
+			{
+				if (PreviousRow[First] >= Infinity)
+				{
+					continue;
+				}
+				const double Requests = Weights[Last] - Weights[First];
+				const double Rounding = double(BINNED2_MINIMUM_ALIGNMENT) * (Requests * Last - (WeightedBuckets[Last] - WeightedBuckets[First]));
+				const double Total = PreviousRow[First] + Rounding + Requests * BlockTail;
+				if (Total < CostRow[Last])
+				{
+					CostRow[Last] = Total;
+					PreviousBucket[Last] = uint16(First);
+				}
+			}
+		}
+	}
+
+	if (Cost[BINNED2_SMALL_POOL_COUNT * (NumBuckets + 1) + NumBuckets] >= Infinity)
+	{
+		YMemory::Memcpy(OutSizes, DefaultSmallBlockSizes, sizeof(DefaultSmallBlockSizes));
+		return;
+	}
+
+	int32 Last = NumBuckets;
+	for (int32 Pools = BINNED2_SMALL_POOL_COUNT; Pools > 0; --Pools)
+	{
+		OutSizes[Pools - 1] = uint16(Last << BINNED2_MINIMUM_ALIGNMENT_SHIFT);
+		Last = Previous[Pools * (NumBuckets + 1) + Last];
+	}
+	check(ValidateSmallBlockSizes(OutSizes, InPageSize));
+}
+
+double YMallocBinned2::ComputeSmallBlockWaste(const uint64* SizeCounts, const uint16* Sizes, uint32 InPageSize)
+{
+	double Requested = 0.0;
+	double Lost = 0.0;
+	uint32 PoolIndex = 0;
+	for (uint32 Bucket = 0; Bucket != BINNED2_SIZE_BUCKET_COUNT; ++Bucket)
+	{
+		const uint32 Size = Bucket << BINNED2_MINIMUM_ALIGNMENT_SHIFT;
+		while (Sizes[PoolIndex] < Size)
+		{
+			++PoolIndex;
+		}
+		const double Count = double(SizeCounts[Bucket]);
+		Requested += Count * Size;
+		Lost += Count * (double(Sizes[PoolIndex] - Size) + MallocBinned2SizeClasses::PageTailPerBlock(Sizes[PoolIndex], InPageSize));
+	}
+	return Requested > 0.0 ? Lost / Requested : 0.0;
+}
+
 bool YMallocBinned2::IsInternallyThreadSafe() const
 { 
 	return true;
@@ -635,10 +970,13 @@ void* YMallocBinned2::MallocExternal(SIZE_T Size, uint32 Alignment)
 			}
 		}
 
+		// Thread caches stick to their home node, threads without one use whatever node they are running on
+		const uint32 NumaNode = Lists ? Lists->NumaNode : GetCurrentNumaNode();
+
 		FScopeLock Lock(&Mutex);
 
 		// Allocate from small object pool.
-		FPoolTable& Table = SmallPoolTables[PoolIndex];
+		FPoolTable& Table = SmallPoolTables[NumaNode][PoolIndex];
 
 		FPoolInfo* Pool;
 		if (!Table.ActivePools.IsEmpty())
@@ -647,10 +985,19 @@ void* YMallocBinned2::MallocExternal(SIZE_T Size, uint32 Alignment)
 		}
 		else
 		{
-			Pool = &Table.ActivePools.PushNewPoolToFront(*this, Table.BlockSize, PoolIndex);
+			Pool = &Table.ActivePools.PushNewPoolToFront(*this, Table.BlockSize, PoolIndex, NumaNode);
 		}
 
 		void* Result = Pool->AllocateRegularBlock();
+#if BINNED2_ALLOCATOR_STATS
+		++Table.Counters.PoolAllocs;
+		uint32 NumBlocks = 1;
+#endif
+		// The thread refilling from the pool is the one that wants the blocks other threads free
+		if (Lists && GMallocBinned2RemoteFrees && RemoteFreeOwners[NumaNode][PoolIndex] != Lists)
+		{
+			RemoteFreeOwners[NumaNode][PoolIndex] = Lists;
+		}
 		if (GMallocBinned2AllocExtra)
 		{
 			if (Lists)
@@ -662,9 +1009,20 @@ void* YMallocBinned2::MallocExternal(SIZE_T Size, uint32 Alignment)
 						break;
 					}
 					Result = Pool->AllocateRegularBlock();
+#if BINNED2_ALLOCATOR_STATS
+					++Table.Counters.PoolAllocs;
+					++NumBlocks;
+#endif
 				}
 			}
 		}
+#if BINNED2_ALLOCATOR_STATS
+		// Sampled on refills only, checking the node on every allocation would cost more than it tells
+		if (bNumaAware && Lists && GetCurrentNumaNode() != NumaNode)
+		{
+			Table.Counters.RemoteNodeAllocs += NumBlocks;
+		}
+#endif
 		if (!Pool->HasFreeRegularBlock())
 		{
 			Table.ExhaustedPools.LinkToFront(Pool);
@@ -682,7 +1040,8 @@ void* YMallocBinned2::MallocExternal(SIZE_T Size, uint32 Alignment)
 
 	// Use OS for non-pooled allocations.
 	UPTRINT AlignedSize = Align(Size, OsAllocationGranularity);
-	void* Result = CachedOSPageAllocator.Allocate(AlignedSize);
+	SIZE_T ActualSize = 0;
+	void* Result = CachedOSPageAllocator.Allocate(AlignedSize, &ActualSize);
 	if (!Result)
 	{
 		Private::OutOfMemory(AlignedSize);
@@ -691,8 +1050,9 @@ void* YMallocBinned2::MallocExternal(SIZE_T Size, uint32 Alignment)
 
 	// Create pool.
 	FPoolInfo* Pool = Private::GetOrCreatePoolInfo(*this, Result, FPoolInfo::ECanary::FirstFreeBlockIsOSAllocSize, false);
-	check(Size > 0 && Size <= AlignedSize && AlignedSize >= OsAllocationGranularity);
-	Pool->SetOSAllocationSizes(Size, AlignedSize);
+	check(Size > 0 && Size <= AlignedSize && AlignedSize >= OsAllocationGranularity && ActualSize >= AlignedSize);
+	// a reused cache block may be larger than asked for, and has to go back with its real size
+	Pool->SetOSAllocationSizes(Size, ActualSize);
 
 	return Result;
 }
@@ -747,6 +1107,16 @@ void* YMallocBinned2::ReallocExternal(void* Ptr, SIZE_T NewSize, uint32 Alignmen
 	UPTRINT PoolOsBytes = Pool->GetOsAllocatedBytes();
 	uint32 PoolOSRequestedBytes = Pool->GetOSRequestedBytes();
 	checkf(PoolOSRequestedBytes <= PoolOsBytes, TEXT("YMallocBinned2::ReallocExternal %d %d"), int32(PoolOSRequestedBytes), int32(PoolOsBytes));
+	if (NewSize > PoolOsBytes && !(NewSize <= BINNED2_MAX_SMALL_POOL_SIZE && Alignment <= BINNED2_MINIMUM_ALIGNMENT))
+	{
+		// Growing in place saves the copy, which for these sizes dominates the cost of the realloc
+		const UPTRINT NewOsBytes = Align(NewSize, OsAllocationGranularity);
+		if (TryExtendOSAllocation(Ptr, PoolOsBytes, NewOsBytes))
+		{
+			Pool->SetOSAllocationSizes(NewSize, NewOsBytes);
+			return Ptr;
+		}
+	}
 	if (NewSize > PoolOsBytes || // can't fit in the old block
 		(NewSize <= BINNED2_MAX_SMALL_POOL_SIZE && Alignment <= BINNED2_MINIMUM_ALIGNMENT) || // can switch to the small block allocator
 		Align(NewSize, OsAllocationGranularity) < PoolOsBytes) // we can get some pages back
@@ -774,9 +1144,17 @@ void YMallocBinned2::FreeExternal(void* Ptr)
 		uint32 PoolIndex = BasePtr->PoolIndex;
 		FBundleNode* BundlesToRecycle = nullptr;
 		FPerThreadFreeBlockLists* Lists = GMallocBinned2PerThreadCaches ? FPerThreadFreeBlockLists::Get() : nullptr;
-		if (Lists)
+		if (Lists && BasePtr->NumaNode != Lists->NumaNode)
 		{
-			BundlesToRecycle = Lists->RecycleFullBundle(BasePtr->PoolIndex);
+			// Keep thread caches on their home node, the block waits on its own node for a thread there to pick it up
+			Private::GNodeFreeLists[BasePtr->NumaNode][PoolIndex].Push((FBundleNode*)Ptr);
+#if BINNED2_ALLOCATOR_STATS
+			Lists->CountForeignNodeFree(PoolIndex);
+#endif
+		}
+		else if (Lists)
+		{
+			BundlesToRecycle = Lists->RecycleFullBundle(BasePtr->PoolIndex, GMallocBinned2RemoteFrees ? RemoteFreeOwners[Lists->NumaNode][PoolIndex] : nullptr);
 			bool bPushed = Lists->Free(Ptr, PoolIndex, BlockSize);
 			check(bPushed);
 		}
@@ -809,6 +1187,43 @@ void YMallocBinned2::FreeExternal(void* Ptr)
 	}
 }
 
+bool YMallocBinned2::TryReallocInPlaceExternal(void* Ptr, SIZE_T NewSize, uint32 Alignment)
+{
+	check(!Ptr || IsOSAllocation(Ptr));
+	if (!Ptr || !NewSize || (NewSize <= BINNED2_MAX_SMALL_POOL_SIZE && Alignment <= BINNED2_MINIMUM_ALIGNMENT))
+	{
+		// Realloc would move these to the small pools
+		return false;
+	}
+
+	FScopeLock Lock(&Mutex);
+
+	FPoolInfo* Pool = Private::FindPoolInfo(*this, Ptr);
+	if (!Pool)
+	{
+		UE_LOG(LogMemory, Fatal, TEXT("YMallocBinned2 Attempt to realloc an unrecognized block %p"), Ptr);
+	}
+	const UPTRINT PoolOsBytes = Pool->GetOsAllocatedBytes();
+	const UPTRINT NewOsBytes = Align(NewSize, OsAllocationGranularity);
+	if (NewOsBytes < PoolOsBytes)
+	{
+		// Same as Realloc, a shrink that can give pages back moves the block
+		return false;
+	}
+	if (NewOsBytes > PoolOsBytes && !TryExtendOSAllocation(Ptr, PoolOsBytes, NewOsBytes))
+	{
+		return false;
+	}
+	Pool->SetOSAllocationSizes(NewSize, NewOsBytes);
+	return true;
+}
+
+bool YMallocBinned2::TryExtendOSAllocation(void* Ptr, UPTRINT OldOsBytes, UPTRINT NewOsBytes)
+{
+	// Blocks carved out of the huge page region are not mappings of their own
+	return !CachedOSPageAllocator.HasPageSource() && YPlatformMemory::BinnedTryExtendInPlace(Ptr, OldOsBytes, NewOsBytes);
+}
+
 bool YMallocBinned2::GetAllocationSizeExternal(void* Ptr, SIZE_T& SizeOut)
 {
 	if (!IsOSAllocation(Ptr))
@@ -865,10 +1280,13 @@ bool YMallocBinned2::ValidateHeap()
 {
 	FScopeLock Lock(&Mutex);
 
-	for (FPoolTable& Table : SmallPoolTables)
+	for (uint32 NumaNode = 0; NumaNode < NumNumaNodes; ++NumaNode)
 	{
-		Table.ActivePools.ValidateActivePools();
-		Table.ExhaustedPools.ValidateExhaustedPools();
+		for (FPoolTable& Table : SmallPoolTables[NumaNode])
+		{
+			Table.ActivePools.ValidateActivePools();
+			Table.ExhaustedPools.ValidateExhaustedPools();
+		}
 	}
 
 	return true;
@@ -879,97 +1297,881 @@ const TCHAR* YMallocBinned2::GetDescriptiveName()
 	return TEXT("binned2");
 }
 
-void YMallocBinned2::FlushCurrentThreadCache()
+void YMallocBinned2::GetAllocatorStats(YGenericMemoryStats& out_Stats)
 {
-	FPerThreadFreeBlockLists* Lists = FPerThreadFreeBlockLists::Get();
-	if (Lists)
+	YMalloc::GetAllocatorStats(out_Stats);
+
+	YHugePageOSAllocator::FStats HugePageStats;
+	uint32 CachedOSBytes = 0;
 	{
 		FScopeLock Lock(&Mutex);
-		for (int32 PoolIndex = 0; PoolIndex != BINNED2_SMALL_POOL_COUNT; ++PoolIndex)
+		HugePageStats = HugePageOSAllocator.GetStats();
+		CachedOSBytes = CachedOSPageAllocator.GetCachedTotal();
+		for (uint32 NumaNode = 0; NumaNode < NumNumaNodes; ++NumaNode)
 		{
-			FBundleNode* Bundles = Lists->PopBundles(PoolIndex);
-			if (Bundles)
-			{
-				Private::FreeBundles(*this, Bundles, PoolIndexToBlockSize(PoolIndex), PoolIndex);
-			}
+			CachedOSBytes += NodePageAllocators[NumaNode].GetCachedTotal();
 		}
 	}
-}
-
-#include "Async/TaskGraphInterfaces.h"
-
-void YMallocBinned2::Trim()
-{
-	QUICK_SCOPE_CYCLE_COUNTER(STAT_FMallocBinned2_Trim);
 
-	if (GMallocBinned2PerThreadCaches)
-	{
-		//double StartTime = FPlatformTime::Seconds();
-		TFunction<void(ENamedThreads::Type CurrentThread)> Broadcast =
-			[this](ENamedThreads::Type MyThread)
-		{
-			FlushCurrentThreadCache();
-		};
-		// Skip task threads on desktop platforms as it is too slow and they don't have much memory
-		FTaskGraphInterface::BroadcastSlow_OnlyUseForSpecialPurposes(!PLATFORM_DESKTOP, false, Broadcast);
-		//UE_LOG(LogTemp, Display, TEXT("Trim Broadcast = %6.2fms"), 1000.0f * float(FPlatformTime::Seconds() - StartTime));
-	}
+	out_Stats.Add(TEXT("Binned2 cached OS bytes"), CachedOSBytes);
+	if (HugePageOSAllocator.IsEnabled())
 	{
-		//double StartTime = FPlatformTime::Seconds();
-		FScopeLock Lock(&Mutex);
-		CachedOSPageAllocator.FreeAll();
-		//UE_LOG(LogTemp, Display, TEXT("Trim CachedOSPageAllocator = %6.2fms"), 1000.0f * float(FPlatformTime::Seconds() - StartTime));
+		out_Stats.Add(TEXT("Binned2 huge page regions"), HugePageStats.NumRegions);
+		out_Stats.Add(TEXT("Binned2 huge page region bytes"), HugePageStats.RegionBytes);
+		out_Stats.Add(TEXT("Binned2 huge page backed bytes"), HugePageStats.HugePageBytes);
+		out_Stats.Add(TEXT("Binned2 huge page carved bytes"), HugePageStats.CarvedBytes);
+		out_Stats.Add(TEXT("Binned2 huge page fallback bytes"), HugePageStats.FallbackBytes);
 	}
-}
 
-void YMallocBinned2::SetupTLSCachesOnCurrentThread()
-{
-	if (!BINNED2_ALLOW_RUNTIME_TWEAKING && !GMallocBinned2PerThreadCaches)
+#if BINNED2_ALLOCATOR_STATS
+	FPoolCounters Pools[BINNED2_SMALL_POOL_COUNT];
+	GetPoolCounters(Pools);
+
+	FPoolCounters Total;
+	SIZE_T CachedBytes = 0;
+	for (uint32 PoolIndex = 0; PoolIndex < BINNED2_SMALL_POOL_COUNT; ++PoolIndex)
 	{
-		return;
+		Total.Accumulate(Pools[PoolIndex]);
+		CachedBytes += SIZE_T(Pools[PoolIndex].CachedBlocks) * PoolIndexToBlockSize(PoolIndex);
 	}
-	if (!YMallocBinned2::Binned2TlsSlot)
+	out_Stats.Add(TEXT("Binned2 thread cached bytes"), CachedBytes);
+	out_Stats.Add(TEXT("Binned2 cache allocs"), SIZE_T(Total.CacheAllocs));
+	out_Stats.Add(TEXT("Binned2 pool allocs"), SIZE_T(Total.PoolAllocs));
+	out_Stats.Add(TEXT("Binned2 bundles recycled"), SIZE_T(Total.BundlesRecycled));
+	out_Stats.Add(TEXT("Binned2 bundles freed"), SIZE_T(Total.BundlesFreed));
+	out_Stats.Add(TEXT("Binned2 remote bundles"), SIZE_T(Total.RemoteBundlesPushed));
+	if (bNumaAware)
 	{
-		YMallocBinned2::Binned2TlsSlot = YPlatformTLS::AllocTlsSlot();
+		out_Stats.Add(TEXT("Binned2 remote node allocs"), SIZE_T(Total.RemoteNodeAllocs));
+		out_Stats.Add(TEXT("Binned2 foreign node frees"), SIZE_T(Total.ForeignNodeFrees));
 	}
-	check(YMallocBinned2::Binned2TlsSlot);
-	FPerThreadFreeBlockLists::SetTLS();
-}
-
-void YMallocBinned2::ClearAndDisableTLSCachesOnCurrentThread()
-{
-	FlushCurrentThreadCache();
-	FPerThreadFreeBlockLists::ClearTLS();
+	out_Stats.Add(TEXT("Binned2 OS commits"), SIZE_T(Total.OSCommits));
+	out_Stats.Add(TEXT("Binned2 OS frees"), SIZE_T(Total.OSFrees));
+#endif
 }
 
-
-bool YMallocBinned2::FFreeBlockList::ObtainPartial(uint32 InPoolIndex)
+void YMallocBinned2::DumpAllocatorStats(class YOutputDevice& Ar)
 {
-	if (!PartialBundle.Head)
+	YHugePageOSAllocator::FStats HugePageStats;
+	uint32 CachedOSBytes = 0;
 	{
-		PartialBundle.Count = 0;
-		PartialBundle.Head = YMallocBinned2::Private::GGlobalRecycler.PopBundle(InPoolIndex);
-		if (PartialBundle.Head)
+		FScopeLock Lock(&Mutex);
+		HugePageStats = HugePageOSAllocator.GetStats();
+		CachedOSBytes = CachedOSPageAllocator.GetCachedTotal();
+		for (uint32 NumaNode = 0; NumaNode < NumNumaNodes; ++NumaNode)
 		{
-			PartialBundle.Count = PartialBundle.Head->Count;
-			PartialBundle.Head->NextBundle = nullptr;
-			return true;
+			CachedOSBytes += NodePageAllocators[NumaNode].GetCachedTotal();
 		}
-		return false;
 	}
-	return true;
-}
 
-YMallocBinned2::FBundleNode* YMallocBinned2::FFreeBlockList::RecyleFull(uint32 InPoolIndex)
-{
-	YMallocBinned2::FBundleNode* Result = nullptr;
-	if (FullBundle.Head)
+	Ar.Logf(TEXT("Allocator Stats for %s:"), GetDescriptiveName());
+	Ar.Logf(TEXT("Cached OS pages %.2f MB"), CachedOSBytes / (1024.0f * 1024.0f));
+	if (bCustomSmallBlockSizes)
+	{
+		Ar.Logf(TEXT("Small pools use a custom table of block sizes"));
+	}
+	else if (SmallBlockSizesError)
+	{
+		Ar.Logf(TEXT("Custom table of block sizes rejected: %s"), SmallBlockSizesError);
+	}
+	if (bNumaAware)
+	{
+		Ar.Logf(TEXT("Small pools kept per NUMA node, %u of %u nodes"), NumNumaNodes, YPlatformMemory::GetNumaNodeCount());
+#if BINNED2_ALLOCATOR_STATS
+		FPoolCounters Total;
+		{
+			FScopeLock Lock(&Mutex);
+			for (uint32 NumaNode = 0; NumaNode < NumNumaNodes; ++NumaNode)
+			{
+				int64 Pages = 0;
+				for (const FPoolTable& Table : SmallPoolTables[NumaNode])
+				{
+					Pages += int64(Table.Counters.OSCommits) - int64(Table.Counters.OSFrees);
+				}
+				Ar.Logf(TEXT("  Node %u: %.2f MB of pool pages"), NumaNode, double(Pages) * PageSize / (1024.0 * 1024.0));
+			}
+		}
+		FPoolCounters Pools[BINNED2_SMALL_POOL_COUNT];
+		GetPoolCounters(Pools);
+		for (const FPoolCounters& Pool : Pools)
+		{
+			Total.Accumulate(Pool);
+		}
+		Ar.Logf(TEXT("Blocks cached away from their home node %llu, blocks freed on another node %llu"), Total.RemoteNodeAllocs, Total.ForeignNodeFrees);
+#endif
+	}
+	if (!HugePageOSAllocator.IsEnabled())
+	{
+		Ar.Logf(TEXT("Huge pages disabled"));
+		return;
+	}
+
+	// Coverage is the share of OS pages handed to the pools that live in huge page backed regions
+	const SIZE_T TotalOSBytes = HugePageStats.CarvedBytes + HugePageStats.FallbackBytes;
+	const double CarvedFraction = TotalOSBytes ? double(HugePageStats.CarvedBytes) / double(TotalOSBytes) : 0.0;
+	const double BackedFraction = HugePageStats.RegionBytes ? double(HugePageStats.HugePageBytes) / double(HugePageStats.RegionBytes) : 0.0;
+	Ar.Logf(TEXT("Huge page regions %u, %.2f MB reserved, %.2f MB huge page backed"),
+		HugePageStats.NumRegions, HugePageStats.RegionBytes / (1024.0f * 1024.0f), HugePageStats.HugePageBytes / (1024.0f * 1024.0f));
+	Ar.Logf(TEXT("OS pages in use %.2f MB carved from regions, %.2f MB direct from the OS"),
+		HugePageStats.CarvedBytes / (1024.0f * 1024.0f), HugePageStats.FallbackBytes / (1024.0f * 1024.0f));
+	Ar.Logf(TEXT("Huge page coverage %.1f%%"), 100.0 * CarvedFraction * BackedFraction);
+}
+
+#if BINNED2_ALLOCATOR_STATS
+void YMallocBinned2::GetPoolCounters(FPoolCounters* OutCounters)
+{
+	FScopeLock Lock(&Mutex);
+	for (uint32 PoolIndex = 0; PoolIndex < BINNED2_SMALL_POOL_COUNT; ++PoolIndex)
+	{
+		OutCounters[PoolIndex] = RetiredThreadCounters[PoolIndex];
+		for (uint32 NumaNode = 0; NumaNode < NumNumaNodes; ++NumaNode)
+		{
+			OutCounters[PoolIndex].Accumulate(SmallPoolTables[NumaNode][PoolIndex].Counters);
+		}
+	}
+
+	FThreadCounters ThreadCounters;
+	for (FPerThreadFreeBlockLists* Lists = RegisteredThreadLists; Lists; Lists = Lists->NextThreadLists)
+	{
+		Lists->GetCounters(ThreadCounters);
+		for (uint32 PoolIndex = 0; PoolIndex < BINNED2_SMALL_POOL_COUNT; ++PoolIndex)
+		{
+			OutCounters[PoolIndex].Accumulate(ThreadCounters.Pools[PoolIndex]);
+		}
+	}
+}
+
+void YMallocBinned2::GetThreadCounters(TArray<FThreadCounters>& OutThreads)
+{
+	OutThreads.Reset();
+
+	// Growing the array allocates, so size it before walking the registry. Threads registering in between are skipped.
+	int32 NumThreads = 0;
+	{
+		FScopeLock Lock(&Mutex);
+		for (FPerThreadFreeBlockLists* Lists = RegisteredThreadLists; Lists; Lists = Lists->NextThreadLists)
+		{
+			++NumThreads;
+		}
+	}
+	OutThreads.AddUninitialized(NumThreads);
+
+	FScopeLock Lock(&Mutex);
+	int32 Index = 0;
+	for (FPerThreadFreeBlockLists* Lists = RegisteredThreadLists; Lists && Index < NumThreads; Lists = Lists->NextThreadLists)
+	{
+		Lists->GetCounters(OutThreads[Index++]);
+	}
+	OutThreads.SetNum(Index, false);
+}
+
+void YMallocBinned2::DumpPoolCounters(class YOutputDevice& Ar)
+{
+	FPoolCounters Pools[BINNED2_SMALL_POOL_COUNT];
+	GetPoolCounters(Pools);
+
+	Ar.Logf(TEXT("Pool counters for %s:"), GetDescriptiveName());
+	Ar.Logf(TEXT("%6s %12s %12s %10s %10s %10s %10s %12s %12s %8s %8s %10s %10s %10s %10s"),
+		TEXT("Block"), TEXT("CacheAllocs"), TEXT("CachePushes"), TEXT("Recycled"), TEXT("Freed"), TEXT("Obtained"), TEXT("Cached"),
+		TEXT("PoolAllocs"), TEXT("PoolFrees"), TEXT("Commits"), TEXT("Decommit"), TEXT("RemotePush"), TEXT("RemotePop"), TEXT("RemoteNode"), TEXT("ForeignFree"));
+	for (uint32 PoolIndex = 0; PoolIndex < BINNED2_SMALL_POOL_COUNT; ++PoolIndex)
+	{
+		const FPoolCounters& Counters = Pools[PoolIndex];
+		Ar.Logf(TEXT("%6u %12llu %12llu %10llu %10llu %10llu %10llu %12llu %12llu %8llu %8llu %10llu %10llu %10llu %10llu"),
+			PoolIndexToBlockSize(PoolIndex), Counters.CacheAllocs, Counters.CachePushes, Counters.BundlesRecycled, Counters.BundlesFreed,
+			Counters.BundlesObtained, Counters.CachedBlocks, Counters.PoolAllocs, Counters.PoolFrees, Counters.OSCommits, Counters.OSFrees,
+			Counters.RemoteBundlesPushed, Counters.RemoteBundlesPopped, Counters.RemoteNodeAllocs, Counters.ForeignNodeFrees);
+	}
+}
+
+bool YMallocBinned2::DumpPoolCountersToCSV(const TCHAR* Filename)
+{
+	TArray<FThreadCounters> Threads;
+	GetThreadCounters(Threads);
+
+	FPoolCounters Pools[BINNED2_SMALL_POOL_COUNT];
+	GetPoolCounters(Pools);
+
+	YString Csv = TEXT("Thread,BlockSize,CacheAllocs,CachePushes,BundlesRecycled,BundlesFreed,BundlesObtained,CachedBlocks,PoolAllocs,PoolFrees,OSCommits,OSFrees,RemoteBundlesPushed,RemoteBundlesPopped,RemoteNodeAllocs,ForeignNodeFrees\n");
+	auto AppendRow = [this, &Csv](const TCHAR* Thread, uint32 PoolIndex, const FPoolCounters& Counters)
+	{
+		Csv += YString::Printf(TEXT("%s,%u,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu\n"),
+			Thread, PoolIndexToBlockSize(PoolIndex), Counters.CacheAllocs, Counters.CachePushes, Counters.BundlesRecycled, Counters.BundlesFreed,
+			Counters.BundlesObtained, Counters.CachedBlocks, Counters.PoolAllocs, Counters.PoolFrees, Counters.OSCommits, Counters.OSFrees,
+			Counters.RemoteBundlesPushed, Counters.RemoteBundlesPopped, Counters.RemoteNodeAllocs, Counters.ForeignNodeFrees);
+	};
+
+	for (const FThreadCounters& Thread : Threads)
+	{
+		const YString ThreadName = YString::Printf(TEXT("%u"), Thread.ThreadId);
+		for (uint32 PoolIndex = 0; PoolIndex < BINNED2_SMALL_POOL_COUNT; ++PoolIndex)
+		{
+			AppendRow(*ThreadName, PoolIndex, Thread.Pools[PoolIndex]);
+		}
+	}
+	for (uint32 PoolIndex = 0; PoolIndex < BINNED2_SMALL_POOL_COUNT; ++PoolIndex)
+	{
+		AppendRow(TEXT("Total"), PoolIndex, Pools[PoolIndex]);
+	}
+
+	return FFileHelper::SaveStringToFile(Csv, Filename);
+}
+
+static void MallocBinned2DumpCounters(YOutputDevice& Ar)
+{
+	if (!YMallocBinned2::MallocBinned2)
+	{
+		Ar.Logf(TEXT("GMalloc is not a YMallocBinned2"));
+		return;
+	}
+	YMallocBinned2::MallocBinned2->DumpPoolCounters(Ar);
+}
+
+static FAutoConsoleCommandWithOutputDevice GMallocBinned2DumpCountersCommand(
+	TEXT("MallocBinned2.DumpCounters"),
+	TEXT("Logs the per pool counters of YMallocBinned2, summed over all thread caches"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&MallocBinned2DumpCounters)
+	);
+
+static void MallocBinned2DumpCountersCSV(const TArray<YString>& Args)
+{
+	if (!YMallocBinned2::MallocBinned2)
+	{
+		UE_LOG(LogMemory, Warning, TEXT("GMalloc is not a YMallocBinned2"));
+		return;
+	}
+
+	const YString Filename = Args.Num() ? Args[0] : YPaths::ProfilingDir() / TEXT("MallocBinned2Counters.csv");
+	if (YMallocBinned2::MallocBinned2->DumpPoolCountersToCSV(*Filename))
+	{
+		UE_LOG(LogMemory, Display, TEXT("Wrote MallocBinned2 counters to %s"), *Filename);
+	}
+	else
+	{
+		UE_LOG(LogMemory, Warning, TEXT("Failed to write MallocBinned2 counters to %s"), *Filename);
+	}
+}
+
+static FAutoConsoleCommand GMallocBinned2DumpCountersCSVCommand(
+	TEXT("MallocBinned2.DumpCountersCSV"),
+	TEXT("Writes the per thread and per pool counters of YMallocBinned2 to a CSV file.\n")
+	TEXT("Usage: MallocBinned2.DumpCountersCSV [Filename], defaults to <ProfilingDir>/MallocBinned2Counters.csv"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&MallocBinned2DumpCountersCSV)
+	);
+
+void YMallocBinned2::GetSizeProfile(uint64* OutCounts)
+{
+	for (uint32 Bucket = 0; Bucket != BINNED2_SIZE_BUCKET_COUNT; ++Bucket)
+	{
+		OutCounts[Bucket] = uint64(SizeProfile[Bucket]);
+	}
+}
+
+void YMallocBinned2::ResetSizeProfile()
+{
+	for (uint32 Bucket = 0; Bucket != BINNED2_SIZE_BUCKET_COUNT; ++Bucket)
+	{
+		FPlatformAtomics::InterlockedExchange(&SizeProfile[Bucket], 0);
+	}
+}
+
+static YString SmallBlockSizesToString(const uint16* Sizes)
+{
+	YString Result;
+	for (uint32 Index = 0; Index != BINNED2_SMALL_POOL_COUNT; ++Index)
+	{
+		Result += YString::Printf(Index ? TEXT(",%u") : TEXT("%u"), uint32(Sizes[Index]));
+	}
+	return Result;
+}
+
+static void MallocBinned2SaveSizeClasses(const TArray<YString>& Args)
+{
+	if (!YMallocBinned2::MallocBinned2)
+	{
+		UE_LOG(LogMemory, Warning, TEXT("GMalloc is not a YMallocBinned2"));
+		return;
+	}
+
+	TArray<uint64> Profile;
+	Profile.AddZeroed(BINNED2_SIZE_BUCKET_COUNT);
+	YMallocBinned2::GetSizeProfile(Profile.GetData());
+	uint64 NumRequests = 0;
+	for (uint64 Count : Profile)
+	{
+		NumRequests += Count;
+	}
+	if (!NumRequests)
+	{
+		UE_LOG(LogMemory, Warning, TEXT("No size profile captured, set MallocBinned2.CaptureSizeProfile 1 and run the workload first"));
+		return;
+	}
+
+	const uint32 PageSize = YMallocBinned2::PageSize;
+	uint16 CurrentSizes[BINNED2_SMALL_POOL_COUNT];
+	uint16 Sizes[BINNED2_SMALL_POOL_COUNT];
+	YMallocBinned2::MallocBinned2->GetSmallBlockSizes(CurrentSizes);
+	YMallocBinned2::ComputeSmallBlockSizes(Profile.GetData(), PageSize, Sizes);
+
+	const double DefaultWaste = YMallocBinned2::ComputeSmallBlockWaste(Profile.GetData(), YMallocBinned2::GetDefaultSmallBlockSizes(), PageSize);
+	const double CurrentWaste = YMallocBinned2::ComputeSmallBlockWaste(Profile.GetData(), CurrentSizes, PageSize);
+	const double Waste = YMallocBinned2::ComputeSmallBlockWaste(Profile.GetData(), Sizes, PageSize);
+
+	const YString Filename = Args.Num() ? Args[0] : YPaths::ProfilingDir() / TEXT("MallocBinned2SizeClasses.txt");
+	const YString Contents = YString::Printf(TEXT("; YMallocBinned2 block sizes computed from %llu small requests, use with -binned2sizes=<this file>\n")
+		TEXT("; Estimated waste %.1f%%, default table %.1f%%, table in use %.1f%%\n%s\n"),
+		NumRequests, 100.0 * Waste, 100.0 * DefaultWaste, 100.0 * CurrentWaste, *SmallBlockSizesToString(Sizes));
+
+	UE_LOG(LogMemory, Display, TEXT("Estimated waste for %llu captured requests: %.1f%% with the computed table, %.1f%% with the default table, %.1f%% with the table in use"),
+		NumRequests, 100.0 * Waste, 100.0 * DefaultWaste, 100.0 * CurrentWaste);
+	if (FFileHelper::SaveStringToFile(Contents, *Filename))
+	{
+		UE_LOG(LogMemory, Display, TEXT("Wrote MallocBinned2 block sizes to %s"), *Filename);
+	}
+	else
+	{
+		UE_LOG(LogMemory, Warning, TEXT("Failed to write MallocBinned2 block sizes to %s"), *Filename);
+	}
+}
+
+static FAutoConsoleCommand GMallocBinned2SaveSizeClassesCommand(
+	TEXT("MallocBinned2.SaveSizeClasses"),
+	TEXT("Computes a table of small block sizes from the profile captured with MallocBinned2.CaptureSizeProfile and writes it to a file for -binned2sizes.\n")
+	TEXT("Usage: MallocBinned2.SaveSizeClasses [Filename], defaults to <ProfilingDir>/MallocBinned2SizeClasses.txt"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&MallocBinned2SaveSizeClasses)
+	);
+
+static void MallocBinned2SizeClassBenchmark(const TArray<YString>& Args)
+{
+	YMallocBinned2* Allocator = YMallocBinned2::MallocBinned2;
+	if (!Allocator)
+	{
+		UE_LOG(LogMemory, Warning, TEXT("GMalloc is not a YMallocBinned2"));
+		return;
+	}
+	const int32 NumAllocs = Args.Num() ? YMath::Max(1, FCString::Atoi(*Args[0])) : 1000000;
+
+	// Replay the captured profile if there is one, otherwise grow arrays of 48, 80 and 112 byte structs
+	TArray<uint64> Profile;
+	Profile.AddZeroed(BINNED2_SIZE_BUCKET_COUNT);
+	YMallocBinned2::GetSizeProfile(Profile.GetData());
+	uint64 NumRequests = 0;
+	for (uint64 Count : Profile)
+	{
+		NumRequests += Count;
+	}
+
+	uint32 Seed = 0x1234567;
+	auto NextRandom = [&Seed]()
+	{
+		Seed = Seed * 196314165 + 907633515;
+		return Seed >> 8;
+	};
+
+	TArray<uint32> RequestSizes;
+	RequestSizes.Reserve(NumAllocs);
+	if (NumRequests)
+	{
+		TArray<uint64> Cumulative;
+		Cumulative.AddUninitialized(BINNED2_SIZE_BUCKET_COUNT);
+		uint64 Sum = 0;
+		for (uint32 Bucket = 0; Bucket != BINNED2_SIZE_BUCKET_COUNT; ++Bucket)
+		{
+			Sum += Profile[Bucket];
+			Cumulative[Bucket] = Sum;
+		}
+		for (int32 Index = 0; Index < NumAllocs; ++Index)
+		{
+			const uint64 Pick = ((uint64(NextRandom()) << 24) ^ NextRandom()) % Sum;
+			int32 Low = 0;
+			int32 High = BINNED2_SIZE_BUCKET_COUNT - 1;
+			while (Low < High)
+			{
+				const int32 Mid = (Low + High) / 2;
+				if (Cumulative[Mid] > Pick)
+				{
+					High = Mid;
+				}
+				else
+				{
+					Low = Mid + 1;
+				}
+			}
+			const int32 Bucket = Low;
+			RequestSizes.Add(YMath::Max<uint32>(1, Bucket << BINNED2_MINIMUM_ALIGNMENT_SHIFT));
+		}
+	}
+	else
+	{
+		static const uint32 StructSizes[] = { 48, 80, 112 };
+		for (int32 Index = 0; Index < NumAllocs; ++Index)
+		{
+			const uint32 Size = StructSizes[NextRandom() % ARRAY_COUNT(StructSizes)] * (1 + NextRandom() % 24);
+			RequestSizes.Add(Size);
+			++Profile[(Size + BINNED2_MINIMUM_ALIGNMENT - 1) >> BINNED2_MINIMUM_ALIGNMENT_SHIFT];
+		}
+	}
+
+	const uint32 PageSize = YMallocBinned2::PageSize;
+	uint16 CurrentSizes[BINNED2_SMALL_POOL_COUNT];
+	uint16 ComputedSizes[BINNED2_SMALL_POOL_COUNT];
+	Allocator->GetSmallBlockSizes(CurrentSizes);
+	YMallocBinned2::ComputeSmallBlockSizes(Profile.GetData(), PageSize, ComputedSizes);
+	UE_LOG(LogConsoleResponse, Display, TEXT("%d allocations from %s, table in use: %s"), NumAllocs,
+		NumRequests ? TEXT("the captured profile") : TEXT("growing arrays of 48/80/112 byte structs"), Allocator->HasCustomSmallBlockSizes() ? TEXT("custom") : TEXT("default"));
+	UE_LOG(LogConsoleResponse, Display, TEXT("Estimated waste: %5.1f%% default table, %5.1f%% table in use, %5.1f%% table computed for this workload"),
+		100.0 * YMallocBinned2::ComputeSmallBlockWaste(Profile.GetData(), YMallocBinned2::GetDefaultSmallBlockSizes(), PageSize),
+		100.0 * YMallocBinned2::ComputeSmallBlockWaste(Profile.GetData(), CurrentSizes, PageSize),
+		100.0 * YMallocBinned2::ComputeSmallBlockWaste(Profile.GetData(), ComputedSizes, PageSize));
+
+	// Measure the table in use; run again with -binned2sizes to compare against another one
+	auto CommittedPages = [Allocator]()
+	{
+		YMallocBinned2::FPoolCounters Pools[BINNED2_SMALL_POOL_COUNT];
+		Allocator->GetPoolCounters(Pools);
+		int64 Pages = 0;
+		for (const YMallocBinned2::FPoolCounters& Pool : Pools)
+		{
+			Pages += int64(Pool.OSCommits) - int64(Pool.OSFrees);
+		}
+		return Pages;
+	};
+
+	TArray<void*> Pointers;
+	Pointers.AddUninitialized(NumAllocs);
+	uint64 RequestedBytes = 0;
+	const int64 PagesBefore = CommittedPages();
+
+	const double AllocStart = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < NumAllocs; ++Index)
+	{
+		Pointers[Index] = Allocator->Malloc(RequestSizes[Index], DEFAULT_ALIGNMENT);
+		RequestedBytes += RequestSizes[Index];
+	}
+	const double AllocEnd = FPlatformTime::Seconds();
+
+	const int64 PagesUsed = CommittedPages() - PagesBefore;
+
+	// Free every other block first so that the pools go through a fragmented state
+	const double FreeStart = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < NumAllocs; Index += 2)
+	{
+		Allocator->Free(Pointers[Index]);
+	}
+	for (int32 Index = 1; Index < NumAllocs; Index += 2)
+	{
+		Allocator->Free(Pointers[Index]);
+	}
+	const double FreeEnd = FPlatformTime::Seconds();
+
+	const double PoolBytes = double(PagesUsed) * PageSize;
+	UE_LOG(LogConsoleResponse, Display, TEXT("Malloc %6.1fns   Free %6.1fns   %.2f MB requested   %.2f MB of pool pages   %5.1f%% overhead"),
+		1e9 * (AllocEnd - AllocStart) / NumAllocs, 1e9 * (FreeEnd - FreeStart) / NumAllocs,
+		RequestedBytes / (1024.0 * 1024.0), PoolBytes / (1024.0 * 1024.0), RequestedBytes ? 100.0 * (PoolBytes - double(RequestedBytes)) / double(RequestedBytes) : 0.0);
+}
+
+static FAutoConsoleCommand GMallocBinned2SizeClassBenchmarkCommand(
+	TEXT("MallocBinned2.SizeClassBenchmark"),
+	TEXT("Compares the estimated waste of the default, in use and computed tables of small block sizes, then times the table in use.\n")
+	TEXT("Replays the profile captured with MallocBinned2.CaptureSizeProfile if there is one.\n")
+	TEXT("Usage: MallocBinned2.SizeClassBenchmark [NumAllocs=1000000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&MallocBinned2SizeClassBenchmark)
+	);
+
+namespace RemoteFreeBenchmark
+{
+	/** Single producer, single consumer ring of pointers that doesn't allocate while the benchmark runs. */
+	struct FPointerRing
+	{
+		enum { Capacity = 1024 };
+
+		FPointerRing()
+			: WriteIndex(0)
+			, ReadIndex(0)
+		{
+		}
+
+		bool TryPush(void* Ptr)
+		{
+			const int32 Index = WriteIndex;
+			if (Index - ReadIndex == Capacity)
+			{
+				return false;
+			}
+			Slots[Index % Capacity] = Ptr;
+			FPlatformAtomics::InterlockedExchange(&WriteIndex, Index + 1);
+			return true;
+		}
+
+		void* TryPop()
+		{
+			const int32 Index = ReadIndex;
+			if (Index == WriteIndex)
+			{
+				return nullptr;
+			}
+			YPlatformMisc::MemoryBarrier();
+			void* Result = Slots[Index % Capacity];
+			FPlatformAtomics::InterlockedExchange(&ReadIndex, Index + 1);
+			return Result;
+		}
+
+		void* Slots[Capacity];
+		volatile int32 WriteIndex;
+		uint8 Padding[PLATFORM_CACHE_LINE_SIZE];
+		volatile int32 ReadIndex;
+	};
+
+	/** Allocates blocks into a ring, frees blocks out of it, or both when a single thread runs the benchmark. */
+	class FWorker : public FRunnable
+	{
+	public:
+		FWorker(FPointerRing& InRing, int32 InNumBlocks, bool bInProduce, bool bInConsume, volatile int32& InNumReady, volatile int32& InGo)
+			: Ring(InRing)
+			, NumBlocks(InNumBlocks)
+			, bProduce(bInProduce)
+			, bConsume(bInConsume)
+			, NumReady(InNumReady)
+			, Go(InGo)
+		{
+		}
+
+		virtual uint32 Run() override
+		{
+			YMemory::SetupTLSCachesOnCurrentThread();
+			FPlatformAtomics::InterlockedIncrement(&NumReady);
+			while (!Go)
+			{
+				FPlatformProcess::Sleep(0.0f);
+			}
+
+			int32 NumProduced = bProduce ? 0 : NumBlocks;
+			int32 NumConsumed = bConsume ? 0 : NumBlocks;
+			while (NumProduced < NumBlocks || NumConsumed < NumBlocks)
+			{
+				bool bProgress = false;
+				if (NumProduced < NumBlocks)
+				{
+					// 16 to 256 bytes, the sizes of task graph payloads
+					void* Ptr = YMemory::Malloc(16 + 16 * (NumProduced % 16));
+					*(uint8*)Ptr = 0;
+					while (!Ring.TryPush(Ptr))
+					{
+						if (bConsume)
+						{
+							YMemory::Free(Ring.TryPop());
+							++NumConsumed;
+						}
+						else
+						{
+							FPlatformProcess::Sleep(0.0f);
+						}
+					}
+					++NumProduced;
+					bProgress = true;
+				}
+				if (NumConsumed < NumBlocks)
+				{
+					if (void* Ptr = Ring.TryPop())
+					{
+						YMemory::Free(Ptr);
+						++NumConsumed;
+						bProgress = true;
+					}
+				}
+				if (!bProgress)
+				{
+					FPlatformProcess::Sleep(0.0f);
+				}
+			}
+
+			YMemory::ClearAndDisableTLSCachesOnCurrentThread();
+			return 0;
+		}
+
+	private:
+		FPointerRing& Ring;
+		int32 NumBlocks;
+		bool bProduce;
+		bool bConsume;
+		volatile int32& NumReady;
+		volatile int32& Go;
+	};
+
+	struct FResult
+	{
+		double Seconds;
+		YMallocBinned2::FPoolCounters Counters;
+	};
+
+	/** Runs NumThreads / 2 producer and consumer pairs, or a single thread that does both, and sums the pool counters they change. */
+	static FResult Run(int32 NumThreads, int32 NumBlocks)
+	{
+		const int32 NumRings = YMath::Max(1, NumThreads / 2);
+		TArray<FPointerRing*> Rings;
+		TArray<FWorker*> Workers;
+		TArray<FRunnableThread*> Threads;
+		volatile int32 NumReady = 0;
+		volatile int32 Go = 0;
+
+		for (int32 RingIndex = 0; RingIndex < NumRings; ++RingIndex)
+		{
+			FPointerRing* Ring = new FPointerRing();
+			Rings.Add(Ring);
+			if (NumThreads == 1)
+			{
+				Workers.Add(new FWorker(*Ring, NumBlocks, true, true, NumReady, Go));
+			}
+			else
+			{
+				Workers.Add(new FWorker(*Ring, NumBlocks, true, false, NumReady, Go));
+				Workers.Add(new FWorker(*Ring, NumBlocks, false, true, NumReady, Go));
+			}
+		}
+
+		YMallocBinned2::FPoolCounters Before[BINNED2_SMALL_POOL_COUNT];
+		YMallocBinned2::MallocBinned2->GetPoolCounters(Before);
+
+		for (int32 WorkerIndex = 0; WorkerIndex < Workers.Num(); ++WorkerIndex)
+		{
+			Threads.Add(FRunnableThread::Create(Workers[WorkerIndex], *YString::Printf(TEXT("MallocBinned2Bench%d"), WorkerIndex)));
+			check(Threads.Last());
+		}
+		while (NumReady < Workers.Num())
+		{
+			FPlatformProcess::Sleep(0.0f);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		FPlatformAtomics::InterlockedExchange(&Go, 1);
+		for (FRunnableThread* Thread : Threads)
+		{
+			Thread->WaitForCompletion();
+		}
+		FResult Result;
+		Result.Seconds = FPlatformTime::Seconds() - StartTime;
+
+		// Exited threads have folded their counters into the retired totals
+		YMallocBinned2::FPoolCounters After[BINNED2_SMALL_POOL_COUNT];
+		YMallocBinned2::MallocBinned2->GetPoolCounters(After);
+		for (uint32 PoolIndex = 0; PoolIndex < BINNED2_SMALL_POOL_COUNT; ++PoolIndex)
+		{
+			Result.Counters.PoolAllocs += After[PoolIndex].PoolAllocs - Before[PoolIndex].PoolAllocs;
+			Result.Counters.PoolFrees += After[PoolIndex].PoolFrees - Before[PoolIndex].PoolFrees;
+			Result.Counters.RemoteBundlesPushed += After[PoolIndex].RemoteBundlesPushed - Before[PoolIndex].RemoteBundlesPushed;
+		}
+
+		for (FRunnableThread* Thread : Threads)
+		{
+			delete Thread;
+		}
+		for (FWorker* Worker : Workers)
+		{
+			delete Worker;
+		}
+		for (FPointerRing* Ring : Rings)
+		{
+			delete Ring;
+		}
+		return Result;
+	}
+}
+
+static void MallocBinned2RemoteFreeBenchmark(const TArray<YString>& Args)
+{
+	using namespace RemoteFreeBenchmark;
+
+	if (!YMallocBinned2::MallocBinned2)
+	{
+		UE_LOG(LogMemory, Warning, TEXT("GMalloc is not a YMallocBinned2"));
+		return;
+	}
+	if (!GMallocBinned2PerThreadCaches)
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("Remote frees need the per-thread caches"));
+		return;
+	}
+	const int32 MaxThreads = Args.Num() > 0 ? YMath::Clamp(FCString::Atoi(*Args[0]), 1, 64) : 64;
+	const int32 NumBlocks = Args.Num() > 1 ? YMath::Max(1, FCString::Atoi(*Args[1])) : 200000;
+
+	const int32 OldRemoteFrees = GMallocBinned2RemoteFrees;
+	UE_LOG(LogConsoleResponse, Display, TEXT("Producers allocate %d blocks of 16-256 bytes each, consumers on other threads free them"), NumBlocks);
+	UE_LOG(LogConsoleResponse, Display, TEXT("%8s %14s %14s %16s %16s %14s"),
+		TEXT("Threads"), TEXT("Off Mops/s"), TEXT("On Mops/s"), TEXT("Off locked/op"), TEXT("On locked/op"), TEXT("Remote bundles"));
+	for (int32 NumThreads = 1; NumThreads <= MaxThreads; NumThreads *= 2)
+	{
+		const double NumOps = double(NumBlocks) * YMath::Max(1, NumThreads / 2);
+
+		GMallocBinned2RemoteFrees = 0;
+		const FResult Off = Run(NumThreads, NumBlocks);
+		GMallocBinned2RemoteFrees = 1;
+		const FResult On = Run(NumThreads, NumBlocks);
+
+		// Blocks moved through the pools under the allocator lock, per allocation
+		UE_LOG(LogConsoleResponse, Display, TEXT("%8d %14.2f %14.2f %16.3f %16.3f %14llu"), NumThreads,
+			NumOps / Off.Seconds / 1e6, NumOps / On.Seconds / 1e6,
+			double(Off.Counters.PoolAllocs + Off.Counters.PoolFrees) / NumOps, double(On.Counters.PoolAllocs + On.Counters.PoolFrees) / NumOps,
+			On.Counters.RemoteBundlesPushed);
+	}
+	GMallocBinned2RemoteFrees = OldRemoteFrees;
+}
+
+static FAutoConsoleCommand GMallocBinned2RemoteFreeBenchmarkCommand(
+	TEXT("MallocBinned2.RemoteFreeBenchmark"),
+	TEXT("Measures producer/consumer alloc/free throughput with MallocBinned2.RemoteFrees off and on, at 1, 2, 4... threads.\n")
+	TEXT("Usage: MallocBinned2.RemoteFreeBenchmark [MaxThreads=64] [BlocksPerProducer=200000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&MallocBinned2RemoteFreeBenchmark)
+	);
+#endif
+
+void YMallocBinned2::FlushCurrentThreadCache()
+{
+	FPerThreadFreeBlockLists* Lists = FPerThreadFreeBlockLists::Get();
+	if (Lists)
+	{
+		FScopeLock Lock(&Mutex);
+		for (int32 PoolIndex = 0; PoolIndex != BINNED2_SMALL_POOL_COUNT; ++PoolIndex)
+		{
+			FBundleNode* Bundles = Lists->PopBundles(PoolIndex);
+			if (Bundles)
+			{
+				Private::FreeBundles(*this, Bundles, PoolIndexToBlockSize(PoolIndex), PoolIndex);
+			}
+			FBundleNode* RemoteBundles = Lists->PopRemoteBundles(PoolIndex);
+			if (RemoteBundles)
+			{
+				Private::FreeBundles(*this, RemoteBundles, PoolIndexToBlockSize(PoolIndex), PoolIndex);
+			}
+		}
+	}
+}
+
+#include "Async/TaskGraphInterfaces.h"
+
+void YMallocBinned2::Trim()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FMallocBinned2_Trim);
+
+	if (GMallocBinned2PerThreadCaches)
+	{
+		//double StartTime = FPlatformTime::Seconds();
+		TFunction<void(ENamedThreads::Type CurrentThread)> Broadcast =
+			[this](ENamedThreads::Type MyThread)
+		{
+			FlushCurrentThreadCache();
+		};
+		// Skip task threads on desktop platforms as it is too slow and they don't have much memory
+		FTaskGraphInterface::BroadcastSlow_OnlyUseForSpecialPurposes(!PLATFORM_DESKTOP, false, Broadcast);
+		//UE_LOG(LogTemp, Display, TEXT("Trim Broadcast = %6.2fms"), 1000.0f * float(FPlatformTime::Seconds() - StartTime));
+	}
+	{
+		//double StartTime = FPlatformTime::Seconds();
+		FScopeLock Lock(&Mutex);
+		// Blocks sent back to nodes that nobody on them allocated again
+		for (uint32 NumaNode = 0; NumaNode < NumNumaNodes; ++NumaNode)
+		{
+			for (uint32 PoolIndex = 0; PoolIndex < BINNED2_SMALL_POOL_COUNT; ++PoolIndex)
+			{
+				if (FBundleNode* Bundle = Private::GNodeFreeLists[NumaNode][PoolIndex].PopAll())
+				{
+					Private::FreeBundles(*this, Bundle, PoolIndexToBlockSize(PoolIndex), PoolIndex);
+				}
+			}
+			NodePageAllocators[NumaNode].FreeAll();
+		}
+		CachedOSPageAllocator.FreeAll();
+		//UE_LOG(LogTemp, Display, TEXT("Trim CachedOSPageAllocator = %6.2fms"), 1000.0f * float(FPlatformTime::Seconds() - StartTime));
+	}
+}
+
+void YMallocBinned2::SetupTLSCachesOnCurrentThread()
+{
+	if (!BINNED2_ALLOW_RUNTIME_TWEAKING && !GMallocBinned2PerThreadCaches)
+	{
+		return;
+	}
+	if (!YMallocBinned2::Binned2TlsSlot)
+	{
+		YMallocBinned2::Binned2TlsSlot = YPlatformTLS::AllocTlsSlot();
+	}
+	check(YMallocBinned2::Binned2TlsSlot);
+	FPerThreadFreeBlockLists::SetTLS();
+}
+
+void YMallocBinned2::ClearAndDisableTLSCachesOnCurrentThread()
+{
+	FlushCurrentThreadCache();
+	FPerThreadFreeBlockLists::ClearTLS();
+}
+
+
+bool YMallocBinned2::FFreeBlockList::ObtainPartial(uint32 InPoolIndex, FRemoteFreeList& RemoteList, uint32 InNumaNode)
+{
+	if (!PartialBundle.Head)
+	{
+		// Blocks other threads freed back to us come first, they are still warm in some cache and nobody else wants them.
+		// Blocks that threads of other nodes sent back to ours come next, they only count as one bundle however many there are.
+		PartialBundle.Head = RemoteList.Pop();
+#if BINNED2_ALLOCATOR_STATS
+		if (PartialBundle.Head)
+		{
+			++Counters.RemoteBundlesPopped;
+		}
+#endif
+		if (!PartialBundle.Head)
+		{
+			PartialBundle.Head = YMallocBinned2::Private::GNodeFreeLists[InNumaNode][InPoolIndex].PopAll();
+		}
+		if (PartialBundle.Head)
+		{
+			PartialBundle.Count = 0;
+			for (FBundleNode* Node = PartialBundle.Head; Node; Node = Node->NextNodeInCurrentBundle)
+			{
+				++PartialBundle.Count;
+			}
+			return true;
+		}
+
+		PartialBundle.Count = 0;
+		PartialBundle.Head = YMallocBinned2::Private::GGlobalRecycler.PopBundle(InNumaNode, InPoolIndex);
+		if (PartialBundle.Head)
+		{
+			PartialBundle.Count = PartialBundle.Head->Count;
+			PartialBundle.Head->NextBundle = nullptr;
+#if BINNED2_ALLOCATOR_STATS
+			++Counters.BundlesObtained;
+#endif
+			return true;
+		}
+		return false;
+	}
+	return true;
+}
+
+YMallocBinned2::FBundleNode* YMallocBinned2::FFreeBlockList::RecyleFull(uint32 InPoolIndex, FRemoteFreeList* RemoteList, uint32 InNumaNode)
+{
+	YMallocBinned2::FBundleNode* Result = nullptr;
+	if (FullBundle.Head && RemoteList && RemoteList->Push(FullBundle.Head))
+	{
+#if BINNED2_ALLOCATOR_STATS
+		++Counters.RemoteBundlesPushed;
+#endif
+		FullBundle.Reset();
+	}
+	else if (FullBundle.Head)
 	{
 		FullBundle.Head->Count = FullBundle.Count;
-		if (!YMallocBinned2::Private::GGlobalRecycler.PushBundle(InPoolIndex, FullBundle.Head))
+		if (!YMallocBinned2::Private::GGlobalRecycler.PushBundle(InNumaNode, InPoolIndex, FullBundle.Head))
 		{
 			Result = FullBundle.Head;
 			Result->NextBundle = nullptr;
+#if BINNED2_ALLOCATOR_STATS
+			++Counters.BundlesFreed;
+		}
+		else
+		{
+			++Counters.BundlesRecycled;
+#endif
 		}
 		FullBundle.Reset();
 	}
@@ -1013,12 +2215,59 @@ void YMallocBinned2::FPerThreadFreeBlockLists::SetTLS()
 	{
 		ThreadSingleton = new (YPlatformMemory::BinnedAllocFromOS(Align(sizeof(FPerThreadFreeBlockLists), YMallocBinned2::OsAllocationGranularity))) FPerThreadFreeBlockLists();
 		YPlatformTLS::SetTlsValue(YMallocBinned2::Binned2TlsSlot, ThreadSingleton);
+		ThreadSingleton->NumaNode = YMallocBinned2::MallocBinned2->GetCurrentNumaNode();
+#if BINNED2_ALLOCATOR_STATS
+		ThreadSingleton->ThreadId = YPlatformTLS::GetCurrentThreadId();
+		FScopeLock Lock(&YMallocBinned2::MallocBinned2->Mutex);
+		ThreadSingleton->NextThreadLists = YMallocBinned2::MallocBinned2->RegisteredThreadLists;
+		YMallocBinned2::MallocBinned2->RegisteredThreadLists = ThreadSingleton;
+#endif
 	}
 }
 
 void YMallocBinned2::FPerThreadFreeBlockLists::ClearTLS()
 {
 	check(YMallocBinned2::Binned2TlsSlot);
+	if (FPerThreadFreeBlockLists* ThreadSingleton = Get())
+	{
+#if BINNED2_ALLOCATOR_STATS
+		// Keep the counters of this thread in the totals once it stops using its cache
+		FThreadCounters Counters;
+		ThreadSingleton->GetCounters(Counters);
+#endif
+
+		YMallocBinned2& Allocator = *YMallocBinned2::MallocBinned2;
+		FScopeLock Lock(&Allocator.Mutex);
+
+		// The cache itself is never freed, so threads that still see it as an owner can keep trying to push; the closed lists turn them away
+		for (uint32 PoolIndex = 0; PoolIndex < BINNED2_SMALL_POOL_COUNT; ++PoolIndex)
+		{
+			if (Allocator.RemoteFreeOwners[ThreadSingleton->NumaNode][PoolIndex] == ThreadSingleton)
+			{
+				Allocator.RemoteFreeOwners[ThreadSingleton->NumaNode][PoolIndex] = nullptr;
+			}
+			if (FBundleNode* RemoteBundles = ThreadSingleton->CloseRemoteBundles(PoolIndex))
+			{
+				Private::FreeBundles(Allocator, RemoteBundles, Allocator.PoolIndexToBlockSize(PoolIndex), PoolIndex);
+			}
+		}
+
+#if BINNED2_ALLOCATOR_STATS
+		for (FPerThreadFreeBlockLists** Link = &YMallocBinned2::MallocBinned2->RegisteredThreadLists; *Link; Link = &(*Link)->NextThreadLists)
+		{
+			if (*Link == ThreadSingleton)
+			{
+				*Link = ThreadSingleton->NextThreadLists;
+				break;
+			}
+		}
+		for (uint32 PoolIndex = 0; PoolIndex < BINNED2_SMALL_POOL_COUNT; ++PoolIndex)
+		{
+			Counters.Pools[PoolIndex].CachedBlocks = 0;
+			YMallocBinned2::MallocBinned2->RetiredThreadCounters[PoolIndex].Accumulate(Counters.Pools[PoolIndex]);
+		}
+#endif
+	}
 	YPlatformTLS::SetTlsValue(YMallocBinned2::Binned2TlsSlot, nullptr);
 }
 
@@ -0,0 +1,509 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	MallocGuard.cpp: Proxy that puts a sample of allocations between guard pages
+=============================================================================*/
+
+#include "HAL/MallocGuard.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformStackWalk.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/SolidAngleMathUtility.h"
+#include "Templates/AlignmentTemplates.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/OutputDeviceRedirector.h"
+#include "Logging/LogMacros.h"
+
+#if USE_MALLOC_GUARD
+
+#if PLATFORM_LINUX || PLATFORM_MAC
+#include <signal.h>
+#elif PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#endif
+
+namespace MallocGuard
+{
+	/** Written into the parts of a sampled page that the block doesn't cover */
+	static const uint8 FillPattern = 0xeb;
+
+	/** Marks the end of the free slot queue */
+	static const uint32 NoSlot = 0xffffffff;
+
+	/** Frames of the proxy itself at the top of the captured callstacks */
+	static const uint32 IgnoredFrames = 2;
+
+	/** Countdown used while the sample rate is 0; threads pick up a new rate when it runs out */
+	static const UPTRINT IdleCountdown = 1024 * 1024;
+
+	static FMallocGuardProxy* Proxy = nullptr;
+
+	static void CaptureCallstack(uint64* OutFrames)
+	{
+		uint64 Frames[IgnoredFrames + FMallocGuardProxy::MaxCallstackDepth];
+		FPlatformStackWalk::CaptureStackBackTrace(Frames, ARRAY_COUNT(Frames));
+		YMemory::Memcpy(OutFrames, Frames + IgnoredFrames, sizeof(uint64) * FMallocGuardProxy::MaxCallstackDepth);
+	}
+
+	static void LogCallstack(const uint64* Frames, uint32 MaxDepth)
+	{
+		for (uint32 Index = 0; Index < MaxDepth && Frames[Index]; ++Index)
+		{
+			ANSICHAR Line[1024];
+			Line[0] = 0;
+			FPlatformStackWalk::ProgramCounterToHumanReadableString(Index, Frames[Index], Line, ARRAY_COUNT(Line));
+			UE_LOG(LogMemory, Error, TEXT("    %s"), ANSI_TO_TCHAR(Line));
+		}
+	}
+
+#if PLATFORM_LINUX || PLATFORM_MAC
+	static struct sigaction PreviousSegvAction;
+	static struct sigaction PreviousBusAction;
+
+	static void FaultHandler(int32 Signal, siginfo_t* Info, void* Context)
+	{
+		// See FMallocGuardProxy::ReportFault for what this risks in a signal handler
+		if (Proxy && Proxy->ReportFault(Info->si_addr))
+		{
+			// Skips the stack walk and the handler
+			uint64 Frames[IgnoredFrames + 64];
+			FPlatformStackWalk::CaptureStackBackTrace(Frames, ARRAY_COUNT(Frames));
+			UE_LOG(LogMemory, Error, TEXT("  Faulting callstack:"));
+			LogCallstack(Frames + IgnoredFrames, 64);
+			GLog->Flush();
+		}
+
+		// Whoever handled the signal before gets it next, for our faults as well so that the crash handler runs
+		const struct sigaction& Previous = Signal == SIGSEGV ? PreviousSegvAction : PreviousBusAction;
+		if ((Previous.sa_flags & SA_SIGINFO) && Previous.sa_sigaction)
+		{
+			Previous.sa_sigaction(Signal, Info, Context);
+		}
+		else if (Previous.sa_handler != SIG_DFL && Previous.sa_handler != SIG_IGN)
+		{
+			Previous.sa_handler(Signal);
+		}
+		else
+		{
+			// The default action ends the process when the faulting instruction runs again, so this handler is only put
+			// aside for a fault that is fatal anyway
+			sigaction(Signal, &Previous, nullptr);
+		}
+	}
+
+	static void InstallFaultHandlers()
+	{
+		struct sigaction Action;
+		YMemory::Memzero(Action);
+		Action.sa_sigaction = &FaultHandler;
+		Action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+		sigemptyset(&Action.sa_mask);
+		sigaction(SIGSEGV, &Action, &PreviousSegvAction);
+		sigaction(SIGBUS, &Action, &PreviousBusAction);
+	}
+#elif PLATFORM_WINDOWS
+	static LONG WINAPI FaultHandler(LPEXCEPTION_POINTERS ExceptionInfo)
+	{
+		const EXCEPTION_RECORD* Record = ExceptionInfo->ExceptionRecord;
+		if (Record->ExceptionCode == EXCEPTION_ACCESS_VIOLATION && Record->NumberParameters >= 2 && Proxy)
+		{
+			if (Proxy->ReportFault((const void*)Record->ExceptionInformation[1]))
+			{
+				GLog->Flush();
+			}
+		}
+		// The crash handler reports the faulting callstack
+		return EXCEPTION_CONTINUE_SEARCH;
+	}
+
+	static void InstallFaultHandlers()
+	{
+		AddVectoredExceptionHandler(1, &FaultHandler);
+	}
+#else
+	static void InstallFaultHandlers()
+	{
+	}
+#endif
+}
+
+FMallocGuardProxy::FMallocGuardProxy(YMalloc* InMalloc, uint32 InSampleRate, uint32 InNumSlots)
+	: UsedMalloc(InMalloc)
+	, PoolBase(0)
+	, PoolSize(0)
+	, Slots(nullptr)
+	, NumSlots(YMath::Max<uint32>(InNumSlots, 1))
+	, FirstFree(MallocGuard::NoSlot)
+	, LastFree(MallocGuard::NoSlot)
+	, SampleRate(int32(InSampleRate))
+	, CountdownTlsSlot(YPlatformTLS::AllocTlsSlot())
+	, NumSampled(0)
+	, NumLive(0)
+	, NumPoolFull(0)
+{
+	checkf(UsedMalloc, TEXT("FMallocGuardProxy is used without a valid malloc!"));
+
+	// Protection works on whole OS pages
+	const YPlatformMemoryConstants& Constants = YPlatformMemory::GetConstants();
+	PageSize = Constants.OsAllocationGranularity ? Constants.OsAllocationGranularity : Constants.PageSize;
+
+	// Straight from the OS, the proxy must not allocate through itself
+	const SIZE_T SlotsSize = Align(sizeof(FSlot) * NumSlots, PageSize);
+	Slots = (FSlot*)YPlatformMemory::BinnedAllocFromOS(SlotsSize);
+	PoolSize = (2 * SIZE_T(NumSlots) + 1) * PageSize;
+	void* Pool = YPlatformMemory::BinnedAllocFromOS(PoolSize);
+	if (!Slots || !Pool)
+	{
+		YPlatformMemory::OnOutOfMemory(SlotsSize + PoolSize, 0);
+	}
+	PoolBase = (UPTRINT)Pool;
+	verify(YPlatformMemory::PageProtect(Pool, PoolSize, false, false));
+
+	YMemory::Memzero(Slots, sizeof(FSlot) * NumSlots);
+	for (uint32 Index = 0; Index < NumSlots; ++Index)
+	{
+		Slots[Index].NextFree = Index + 1 < NumSlots ? Index + 1 : MallocGuard::NoSlot;
+	}
+	FirstFree = 0;
+	LastFree = NumSlots - 1;
+}
+
+FMallocGuardProxy::~FMallocGuardProxy()
+{
+	check(MallocGuard::Proxy != this);
+	YPlatformMemory::BinnedFreeToOS((void*)PoolBase, PoolSize);
+	YPlatformMemory::BinnedFreeToOS(Slots, Align(sizeof(FSlot) * NumSlots, PageSize));
+	YPlatformTLS::FreeTlsSlot(CountdownTlsSlot);
+}
+
+bool FMallocGuardProxy::Install(uint32 SampleRate, uint32 NumSlots)
+{
+	if (MallocGuard::Proxy)
+	{
+		MallocGuard::Proxy->SetSampleRate(SampleRate);
+		return true;
+	}
+	if (PLATFORM_USES_FIXED_GMalloc_CLASS || !GMalloc)
+	{
+		return false;
+	}
+
+	while (!MallocGuard::Proxy)
+	{
+		YMalloc* LocalGMalloc = GMalloc;
+		FMallocGuardProxy* NewProxy = new FMallocGuardProxy(LocalGMalloc, SampleRate, NumSlots);
+		if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&GMalloc, NewProxy, LocalGMalloc) != LocalGMalloc)
+		{
+			// Someone else put a proxy on top in the meantime; this one was never seen and never handed anything out
+			delete NewProxy;
+			continue;
+		}
+		// Published once it is GMalloc, the fault handlers only need it once it has handed out a block
+		FPlatformAtomics::InterlockedExchangePtr((void**)&MallocGuard::Proxy, NewProxy);
+		MallocGuard::InstallFaultHandlers();
+	}
+
+	UE_LOG(LogMemory, Display, TEXT("Guarded allocations: sampling 1 in %u allocations of up to %u bytes into %u slots"),
+		SampleRate, uint32(MallocGuard::Proxy->PageSize), MallocGuard::Proxy->NumSlots);
+	return true;
+}
+
+FMallocGuardProxy* FMallocGuardProxy::Get()
+{
+	return MallocGuard::Proxy;
+}
+
+void FMallocGuardProxy::SetSampleRate(uint32 InSampleRate)
+{
+	FPlatformAtomics::InterlockedExchange(&SampleRate, int32(InSampleRate));
+}
+
+bool FMallocGuardProxy::StartNextCountdown(UPTRINT Countdown)
+{
+	const uint32 Rate = uint32(SampleRate);
+	UPTRINT NextCountdown = MallocGuard::IdleCountdown;
+	if (Rate)
+	{
+		// Uniform in [1, 2 * Rate - 1] so that samples don't line up with patterns in the allocations
+		uint64 Random = FPlatformTime::Cycles64() * 0x9e3779b97f4a7c15ull;
+		Random ^= Random >> 29;
+		NextCountdown = Rate > 1 ? 1 + UPTRINT(Random % (2 * uint64(Rate) - 1)) : 1;
+	}
+	YPlatformTLS::SetTlsValue(CountdownTlsSlot, (void*)NextCountdown);
+	// 0 is a thread that hasn't drawn a countdown yet
+	return Countdown == 1 && Rate;
+}
+
+void* FMallocGuardProxy::GuardedMalloc(SIZE_T Size, uint32 Alignment)
+{
+	Alignment = YMath::Max(Size >= 16 ? (uint32)16 : (uint32)8, Alignment);
+	if (!Size || Size > PageSize || Alignment > PageSize)
+	{
+		return nullptr;
+	}
+
+	uint64 Callstack[MaxCallstackDepth];
+	MallocGuard::CaptureCallstack(Callstack);
+
+	FScopeLock Lock(&Mutex);
+
+	const uint32 SlotIndex = FirstFree;
+	if (SlotIndex == MallocGuard::NoSlot)
+	{
+		++NumPoolFull;
+		return nullptr;
+	}
+	FSlot& Slot = Slots[SlotIndex];
+	FirstFree = Slot.NextFree;
+	if (FirstFree == MallocGuard::NoSlot)
+	{
+		LastFree = MallocGuard::NoSlot;
+	}
+
+	uint8* Page = GetSlotPage(SlotIndex);
+	verify(YPlatformMemory::PageProtect(Page, PageSize, true, true));
+	YMemory::Memset(Page, MallocGuard::FillPattern, PageSize);
+
+	// Every other block touches the end of its page to catch overruns, the others touch the start to catch underruns
+	const bool bAtEnd = (NumSampled & 1) == 0;
+	Slot.Ptr = bAtEnd ? AlignDown((UPTRINT)Page + PageSize - Size, Alignment) : (UPTRINT)Page;
+	Slot.Size = Size;
+	Slot.State = ESlotState::Allocated;
+	Slot.AllocThreadId = YPlatformTLS::GetCurrentThreadId();
+	Slot.FreeThreadId = 0;
+	YMemory::Memcpy(Slot.AllocCallstack, Callstack, sizeof(Callstack));
+	YMemory::Memzero(Slot.FreeCallstack);
+
+	++NumSampled;
+	++NumLive;
+	return (void*)Slot.Ptr;
+}
+
+void* FMallocGuardProxy::GuardedRealloc(void* Ptr, SIZE_T NewSize, uint32 Alignment)
+{
+	if (!NewSize)
+	{
+		GuardedFree(Ptr);
+		return nullptr;
+	}
+
+	SIZE_T OldSize = 0;
+	verify(GetAllocationSize(Ptr, OldSize));
+	void* Result = Malloc(NewSize, Alignment);
+	if (Result)
+	{
+		YMemory::Memcpy(Result, Ptr, YMath::Min(OldSize, NewSize));
+		GuardedFree(Ptr);
+	}
+	return Result;
+}
+
+void FMallocGuardProxy::GuardedFree(void* Ptr)
+{
+	uint64 Callstack[MaxCallstackDepth];
+	MallocGuard::CaptureCallstack(Callstack);
+
+	FScopeLock Lock(&Mutex);
+
+	const SIZE_T PageIndex = ((UPTRINT)Ptr - PoolBase) / PageSize;
+	const uint32 SlotIndex = uint32(PageIndex / 2);
+	FSlot* Slot = (PageIndex & 1) ? &Slots[SlotIndex] : nullptr;
+	if (!Slot || Slot->State != ESlotState::Allocated || Slot->Ptr != (UPTRINT)Ptr)
+	{
+		const bool bDoubleFree = Slot && Slot->State == ESlotState::Freed && Slot->Ptr == (UPTRINT)Ptr;
+		UE_LOG(LogMemory, Error, TEXT("Guarded allocation error: %s of %p"), bDoubleFree ? TEXT("double free") : TEXT("free of a pointer that was never allocated"), Ptr);
+		if (Slot && Slot->State != ESlotState::Unused)
+		{
+			LogSlot(*Slot);
+		}
+		UE_LOG(LogMemory, Error, TEXT("  Freed again by thread %u at:"), YPlatformTLS::GetCurrentThreadId());
+		MallocGuard::LogCallstack(Callstack, MaxCallstackDepth);
+		UE_LOG(LogMemory, Fatal, TEXT("Guarded allocation error, see the log above"));
+		return;
+	}
+
+	const uint8* FirstBad = nullptr;
+	const SIZE_T NumBad = CheckFillPattern(*Slot, SlotIndex, FirstBad);
+	if (NumBad)
+	{
+		const bool bOverrun = (UPTRINT)FirstBad >= Slot->Ptr + Slot->Size;
+		UE_LOG(LogMemory, Error, TEXT("Guarded allocation error: %u bytes written %s a %u byte block, first one %d bytes %s it"),
+			uint32(NumBad), bOverrun ? TEXT("past the end of") : TEXT("before the start of"), uint32(Slot->Size),
+			int32(bOverrun ? (UPTRINT)FirstBad - (Slot->Ptr + Slot->Size) : Slot->Ptr - (UPTRINT)FirstBad), bOverrun ? TEXT("past") : TEXT("before"));
+		LogSlot(*Slot);
+		UE_LOG(LogMemory, Error, TEXT("  Being freed by thread %u at:"), YPlatformTLS::GetCurrentThreadId());
+		MallocGuard::LogCallstack(Callstack, MaxCallstackDepth);
+		UE_LOG(LogMemory, Fatal, TEXT("Guarded allocation error, see the log above"));
+	}
+
+	verify(YPlatformMemory::PageProtect(GetSlotPage(SlotIndex), PageSize, false, false));
+	Slot->State = ESlotState::Freed;
+	Slot->FreeThreadId = YPlatformTLS::GetCurrentThreadId();
+	YMemory::Memcpy(Slot->FreeCallstack, Callstack, sizeof(Callstack));
+
+	// Back of the queue, so the page stays inaccessible for as long as possible
+	Slot->NextFree = MallocGuard::NoSlot;
+	if (LastFree != MallocGuard::NoSlot)
+	{
+		Slots[LastFree].NextFree = SlotIndex;
+	}
+	else
+	{
+		FirstFree = SlotIndex;
+	}
+	LastFree = SlotIndex;
+	--NumLive;
+}
+
+SIZE_T FMallocGuardProxy::CheckFillPattern(const FSlot& Slot, uint32 SlotIndex, const uint8*& OutFirstBad) const
+{
+	const uint8* Page = GetSlotPage(SlotIndex);
+	const uint8* BlockStart = (const uint8*)Slot.Ptr;
+	const uint8* BlockEnd = BlockStart + Slot.Size;
+	SIZE_T NumBad = 0;
+	OutFirstBad = nullptr;
+	// Overruns first, they are the more common kind
+	for (const uint8* Byte = BlockEnd; Byte < Page + PageSize; ++Byte)
+	{
+		if (*Byte != MallocGuard::FillPattern)
+		{
+			OutFirstBad = OutFirstBad ? OutFirstBad : Byte;
+			++NumBad;
+		}
+	}
+	for (const uint8* Byte = BlockStart; Byte > Page; --Byte)
+	{
+		if (Byte[-1] != MallocGuard::FillPattern)
+		{
+			OutFirstBad = OutFirstBad ? OutFirstBad : Byte - 1;
+			++NumBad;
+		}
+	}
+	return NumBad;
+}
+
+void FMallocGuardProxy::LogSlot(const FSlot& Slot) const
+{
+	UE_LOG(LogMemory, Error, TEXT("  Block of %u bytes at %p, allocated by thread %u at:"), uint32(Slot.Size), (void*)Slot.Ptr, Slot.AllocThreadId);
+	MallocGuard::LogCallstack(Slot.AllocCallstack, MaxCallstackDepth);
+	if (Slot.State == ESlotState::Freed)
+	{
+		UE_LOG(LogMemory, Error, TEXT("  Freed by thread %u at:"), Slot.FreeThreadId);
+		MallocGuard::LogCallstack(Slot.FreeCallstack, MaxCallstackDepth);
+	}
+}
+
+bool FMallocGuardProxy::ReportFault(const void* Address)
+{
+	if (!IsGuarded(Address))
+	{
+		return false;
+	}
+
+	const UPTRINT Addr = (UPTRINT)Address;
+	const SIZE_T PageIndex = (Addr - PoolBase) / PageSize;
+	if (PageIndex & 1)
+	{
+		const FSlot& Slot = Slots[PageIndex / 2];
+		if (Slot.State == ESlotState::Freed)
+		{
+			UE_LOG(LogMemory, Error, TEXT("Guarded allocation error: use after free at %p, %d bytes from the start of a freed block"), Address, int32(Addr - Slot.Ptr));
+			LogSlot(Slot);
+		}
+		else
+		{
+			UE_LOG(LogMemory, Error, TEXT("Guarded allocation error: access to %p, in a page that was never handed out"), Address);
+		}
+		return true;
+	}
+
+	// A guard page, blame the nearest block around it
+	const FSlot* Before = PageIndex > 0 ? &Slots[PageIndex / 2 - 1] : nullptr;
+	const FSlot* After = PageIndex / 2 < NumSlots ? &Slots[PageIndex / 2] : nullptr;
+	Before = Before && Before->State != ESlotState::Unused ? Before : nullptr;
+	After = After && After->State != ESlotState::Unused ? After : nullptr;
+	const SIZE_T DistanceAfterEnd = Before ? Addr - (Before->Ptr + Before->Size) : ~SIZE_T(0);
+	const SIZE_T DistanceBeforeStart = After ? After->Ptr - Addr : ~SIZE_T(0);
+	if (!Before && !After)
+	{
+		UE_LOG(LogMemory, Error, TEXT("Guarded allocation error: access to %p, in a guard page next to no block"), Address);
+	}
+	else if (DistanceAfterEnd <= DistanceBeforeStart)
+	{
+		UE_LOG(LogMemory, Error, TEXT("Guarded allocation error: buffer overflow at %p, %u bytes past the end of a %s%u byte block"),
+			Address, uint32(DistanceAfterEnd), Before->State == ESlotState::Freed ? TEXT("freed ") : TEXT(""), uint32(Before->Size));
+		LogSlot(*Before);
+	}
+	else
+	{
+		UE_LOG(LogMemory, Error, TEXT("Guarded allocation error: buffer underflow at %p, %u bytes before the start of a %s%u byte block"),
+			Address, uint32(DistanceBeforeStart), After->State == ESlotState::Freed ? TEXT("freed ") : TEXT(""), uint32(After->Size));
+		LogSlot(*After);
+	}
+	return true;
+}
+
+bool FMallocGuardProxy::ValidateHeap()
+{
+	bool bValid = true;
+	{
+		FScopeLock Lock(&Mutex);
+		for (uint32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+		{
+			const FSlot& Slot = Slots[SlotIndex];
+			const uint8* FirstBad = nullptr;
+			if (Slot.State == ESlotState::Allocated && CheckFillPattern(Slot, SlotIndex, FirstBad))
+			{
+				UE_LOG(LogMemory, Error, TEXT("Guarded allocation error: written outside its bounds at %p"), FirstBad);
+				LogSlot(Slot);
+				bValid = false;
+			}
+		}
+	}
+	return UsedMalloc->ValidateHeap() && bValid;
+}
+
+bool FMallocGuardProxy::GetAllocationSize(void* Original, SIZE_T& SizeOut)
+{
+	if (IsGuarded(Original))
+	{
+		const SIZE_T PageIndex = ((UPTRINT)Original - PoolBase) / PageSize;
+		checkSlow(PageIndex & 1);
+		SizeOut = Slots[PageIndex / 2].Size;
+		return true;
+	}
+	return UsedMalloc->GetAllocationSize(Original, SizeOut);
+}
+
+void FMallocGuardProxy::DumpAllocatorStats(YOutputDevice& Ar)
+{
+	Ar.Logf(TEXT("Guarded allocations: 1 in %d sampled, %u so far, %u live in %u slots of %u bytes, %u samples missed because every slot was taken"),
+		SampleRate, NumSampled, NumLive, NumSlots, uint32(PageSize), NumPoolFull);
+	UsedMalloc->DumpAllocatorStats(Ar);
+}
+
+static void MallocGuardUse(const TArray<YString>& Args)
+{
+	const int32 SampleRate = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000;
+	const int32 NumSlots = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 256;
+	if (SampleRate < 0 || NumSlots <= 0)
+	{
+		UE_LOG(LogMemory, Error, TEXT("Usage: Memory.UseGuard [SampleRate] [NumSlots]"));
+		return;
+	}
+	if (!FMallocGuardProxy::Install(uint32(SampleRate), uint32(NumSlots)))
+	{
+		UE_LOG(LogMemory, Error, TEXT("The guard proxy cannot be turned on because we are using PLATFORM_USES_FIXED_GMalloc_CLASS"));
+	}
+}
+
+static FAutoConsoleCommand GMallocGuardUseCommand(
+	TEXT("Memory.UseGuard"),
+	TEXT("Puts one allocation in SampleRate between guard pages to catch overruns, underruns and use after free, installing the guard proxy on first use.\n")
+	TEXT("Usage: Memory.UseGuard [SampleRate] [NumSlots], defaults to 1000 and 256. Run it again to change the rate, 0 stops sampling.\n")
+	TEXT("Each slot costs two OS pages of address space and one of memory while in use."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&MallocGuardUse)
+	);
+
+#endif // USE_MALLOC_GUARD
@@ -7,6 +7,7 @@
 #include "HAL/MallocTBB.h"
 #include "Math/SolidAngleMathUtility.h"
 #include "HAL/SolidAngleMemory.h"
+#include "Templates/AlignmentTemplates.h"
 
 // Only use for supported platforms
 #if PLATFORM_SUPPORTS_TBB && TBB_ALLOCATOR_ALLOWED
@@ -117,6 +118,18 @@ void TMallocTBB::Free( void* Ptr )
 	MEM_TIME(MemTime += FPlatformTime::Seconds())
 }
 
+bool TMallocTBB::TryReallocInPlace(void* Ptr, SIZE_T NewSize, uint32 Alignment)
+{
+	// tbbmalloc can't grow a block, but its size classes leave some room to grow into.
+	// Shrinking to less than half goes through Realloc so that the memory is given back.
+	const SIZE_T UsableSize = scalable_msize(Ptr);
+	if (!NewSize || NewSize > UsableSize || NewSize <= UsableSize / 2)
+	{
+		return false;
+	}
+	return Alignment == DEFAULT_ALIGNMENT || IsAligned(Ptr, Alignment);
+}
+
 bool TMallocTBB::GetAllocationSize(void *Original, SIZE_T &SizeOut)
 {
 	SizeOut = scalable_msize(Original);
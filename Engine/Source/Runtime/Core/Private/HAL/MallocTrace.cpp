@@ -0,0 +1,693 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	MallocTrace.cpp: Proxy that records allocation events to a binary file
+=============================================================================*/
+
+#include "HAL/MallocTrace.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformStackWalk.h"
+#include "HAL/Event.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/TlsAutoCleanup.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/SolidAngleMathUtility.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Paths.h"
+#include "Logging/LogMacros.h"
+#include "ProfilingDebugging/ProfilingHelpers.h"
+
+#if USE_MALLOC_TRACE
+
+namespace MallocTrace
+{
+	/** Size of the buffers threads record events into, header included */
+	static const uint32 BlockSize = 64 * 1024;
+
+	/** Room reserved for one event; the largest is a callstack of MaxCallstackDepth frames, or a realloc without callstacks */
+	static const uint32 MaxEventSize = 64 + 10 * MaxCallstackDepth;
+
+	/** Threads beyond this many alive at once are not traced */
+	static const int32 MaxThreads = 1024;
+
+	/** Number of distinct callstacks that can be given an id, must be a power of two */
+	static const uint32 CallstackTableSize = 64 * 1024;
+	static const uint32 MaxCallstackProbes = 64;
+
+	/** Frames of the tracer itself at the top of every captured callstack */
+	static const uint32 IgnoredFrames = 2;
+
+	/** How often the writer thread wakes up to write full blocks, in ms */
+	static const uint32 WritePeriodMs = 50;
+
+	struct FBlock
+	{
+		FBlock* Next;
+		uint32 ThreadId;
+		/** Bytes of complete events, published after every event so StopTrace can write out a block its thread still owns */
+		volatile int32 Committed;
+		uint64 BaseCycles;
+
+		uint8* Data()
+		{
+			return (uint8*)(this + 1);
+		}
+	};
+
+	static const uint32 BlockCapacity = BlockSize - sizeof(FBlock);
+
+	struct FThreadState
+	{
+		FBlock* Block;
+		uint64 LastCycles;
+		UPTRINT LastPtr;
+		uint32 ThreadId;
+		/** Trace the block was filled in; a new trace throws away what the previous one left behind */
+		int32 Session;
+		/** Set while the thread records an event, StopTrace waits for it to clear */
+		volatile int32 bInEvent;
+		/** Set on the writer thread and while an event is recorded, so the tracer's own allocations are not traced */
+		bool bSuppressed;
+		/** Set while a thread owns the state. A runnable thread gives its state back when it exits, along with its block. */
+		volatile int32 bInUse;
+	};
+
+	static FThreadState ThreadStates[MaxThreads];
+	static volatile int32 NumThreadStates = 0;
+
+	/** Handed to threads past MaxThreads, and to exiting threads once they have given their state back */
+	static FThreadState UntracedThreadState = { nullptr, 0, 0, 0, 0, 0, true, 1 };
+
+	static uint32 ThreadStateTlsSlot = YPlatformTLS::AllocTlsSlot();
+
+	/** Gives the state back when its runnable thread exits. */
+	class FThreadStateOwner : public FTlsAutoCleanup
+	{
+	public:
+		FThreadStateOwner()
+			: State(nullptr)
+		{
+		}
+
+		virtual ~FThreadStateOwner()
+		{
+			if (State)
+			{
+				// Whatever the thread allocates or frees from here on, this included, is not traced
+				YPlatformTLS::SetTlsValue(ThreadStateTlsSlot, &UntracedThreadState);
+				YPlatformMisc::MemoryBarrier();
+				State->bInUse = 0;
+			}
+		}
+
+		FThreadState* State;
+	};
+
+	static FThreadState* AcquireThreadState()
+	{
+		for (;;)
+		{
+			for (int32 Index = 0; Index < YMath::Min<int32>(NumThreadStates, MaxThreads); ++Index)
+			{
+				FThreadState& State = ThreadStates[Index];
+				if (!State.bInUse && FPlatformAtomics::InterlockedCompareExchange(&State.bInUse, 1, 0) == 0)
+				{
+					return &State;
+				}
+			}
+
+			const int32 Index = FPlatformAtomics::InterlockedIncrement(&NumThreadStates) - 1;
+			if (Index >= MaxThreads)
+			{
+				return nullptr;
+			}
+			// a thread scanning the states may have taken the new one already
+			if (FPlatformAtomics::InterlockedCompareExchange(&ThreadStates[Index].bInUse, 1, 0) == 0)
+			{
+				return &ThreadStates[Index];
+			}
+		}
+	}
+
+	/** Incremented by every StartTrace */
+	static volatile int32 Session = 0;
+
+	/** Hashes of the callstacks seen in the current trace, a callstack's id is its index plus one */
+	static uint64 CallstackHashes[CallstackTableSize];
+
+	/** Blocks waiting for the writer thread, pushed by any thread and taken all at once by the writer */
+	static FBlock* volatile FullBlocks = nullptr;
+
+	/** Written blocks, ready to be handed to a thread again */
+	static FBlock* FreeBlocks = nullptr;
+	static FCriticalSection FreeBlocksCritical;
+
+	/** Events lost because no block could be allocated */
+	static volatile int32 NumDroppedEvents = 0;
+
+	/** Serializes StartTrace and StopTrace */
+	static FCriticalSection ControlCritical;
+
+	static YString LastTraceFilename;
+
+	static int32 CallstackDepth = 12;
+	static FAutoConsoleVariableRef CVarCallstackDepth(
+		TEXT("MallocTrace.CallstackDepth"),
+		CallstackDepth,
+		TEXT("Number of frames recorded for every traced allocation, up to 32. 0 records no callstacks, which is much cheaper.")
+		);
+
+	static FThreadState& GetThreadState()
+	{
+		FThreadState* State = (FThreadState*)YPlatformTLS::GetTlsValue(ThreadStateTlsSlot);
+		if (!State)
+		{
+			State = AcquireThreadState();
+			if (!State)
+			{
+				YPlatformTLS::SetTlsValue(ThreadStateTlsSlot, &UntracedThreadState);
+				return UntracedThreadState;
+			}
+
+			// The previous owner's events stay in its block, see BeginEvent
+			State->ThreadId = YPlatformTLS::GetCurrentThreadId();
+			YPlatformTLS::SetTlsValue(ThreadStateTlsSlot, State);
+
+			// Only runnable threads clean up after themselves, the states of other threads stay taken.
+			// The owner is freed once the thread has given its state back, so it is not traced at all.
+			const bool bWasSuppressed = State->bSuppressed;
+			State->bSuppressed = true;
+			FThreadStateOwner* Owner = new FThreadStateOwner();
+			State->bSuppressed = bWasSuppressed;
+			if (Owner->Register())
+			{
+				Owner->State = State;
+			}
+			else
+			{
+				State->bSuppressed = true;
+				delete Owner;
+				State->bSuppressed = bWasSuppressed;
+			}
+		}
+		return *State;
+	}
+
+	static int32 GetNumThreadStates()
+	{
+		return YMath::Min<int32>(NumThreadStates, MaxThreads);
+	}
+
+	static FBlock* AllocBlock()
+	{
+		{
+			FScopeLock Lock(&FreeBlocksCritical);
+			if (FBlock* Block = FreeBlocks)
+			{
+				FreeBlocks = Block->Next;
+				return Block;
+			}
+		}
+		// Straight from the OS, the tracer must not allocate through GMalloc
+		return (FBlock*)YPlatformMemory::BinnedAllocFromOS(BlockSize);
+	}
+
+	static void ReleaseBlock(FBlock* Block)
+	{
+		FScopeLock Lock(&FreeBlocksCritical);
+		Block->Next = FreeBlocks;
+		FreeBlocks = Block;
+	}
+
+	static void PushFullBlock(FBlock* Block)
+	{
+		while (true)
+		{
+			FBlock* Head = FullBlocks;
+			Block->Next = Head;
+			if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&FullBlocks, Block, Head) == Head)
+			{
+				return;
+			}
+		}
+	}
+
+	static FBlock* PopAllFullBlocks()
+	{
+		return (FBlock*)FPlatformAtomics::InterlockedExchangePtr((void**)&FullBlocks, nullptr);
+	}
+
+	static void ResetBlock(FThreadState& State, FBlock* Block, uint64 Cycles)
+	{
+		Block->ThreadId = State.ThreadId;
+		Block->Committed = 0;
+		Block->BaseCycles = Cycles;
+		State.LastCycles = Cycles;
+		State.LastPtr = 0;
+	}
+
+	/** Claims the thread's state for one event, or returns null if the thread is not traced or the trace has just stopped */
+	static FThreadState* BeginTrace()
+	{
+		FThreadState& State = GetThreadState();
+		if (State.bSuppressed)
+		{
+			return nullptr;
+		}
+		State.bSuppressed = true;
+		State.bInEvent = 1;
+		// Pairs with the barrier in StopTrace: either StopTrace sees bInEvent set or this thread sees tracing stopped
+		YPlatformMisc::MemoryBarrier();
+		if (!FMallocTraceProxy::IsTracing())
+		{
+			State.bInEvent = 0;
+			State.bSuppressed = false;
+			return nullptr;
+		}
+		return &State;
+	}
+
+	static void EndTrace(FThreadState& State)
+	{
+		YPlatformMisc::MemoryBarrier();
+		State.bInEvent = 0;
+		State.bSuppressed = false;
+	}
+
+	/** Makes sure the thread's block has room for one more event and returns where to write it */
+	static uint8* BeginEvent(FThreadState& State, uint64 Cycles)
+	{
+		FBlock* Block = State.Block;
+		if (State.Session != Session)
+		{
+			State.Session = Session;
+			if (Block)
+			{
+				ResetBlock(State, Block, Cycles);
+			}
+		}
+		else if (Block && Block->ThreadId != State.ThreadId)
+		{
+			// The state was given back by a thread that exited, its events are written out under its own id
+			if (Block->Committed)
+			{
+				PushFullBlock(Block);
+				Block = nullptr;
+				State.Block = nullptr;
+			}
+			else
+			{
+				ResetBlock(State, Block, Cycles);
+			}
+		}
+		if (!Block || Block->Committed + MaxEventSize > BlockCapacity)
+		{
+			if (Block)
+			{
+				PushFullBlock(Block);
+			}
+			Block = AllocBlock();
+			State.Block = Block;
+			if (!Block)
+			{
+				FPlatformAtomics::InterlockedIncrement(&NumDroppedEvents);
+				return nullptr;
+			}
+			ResetBlock(State, Block, Cycles);
+		}
+		return Block->Data() + Block->Committed;
+	}
+
+	static void EndEvent(FThreadState& State, uint8* End)
+	{
+		// The event has to be visible before the size that covers it
+		YPlatformMisc::MemoryBarrier();
+		State.Block->Committed = int32(End - State.Block->Data());
+	}
+
+	static FORCEINLINE uint8* WriteVarInt(uint8* Out, uint64 Value)
+	{
+		while (Value >= 0x80)
+		{
+			*Out++ = uint8(Value) | 0x80;
+			Value >>= 7;
+		}
+		*Out++ = uint8(Value);
+		return Out;
+	}
+
+	static FORCEINLINE uint8* WritePtr(FThreadState& State, uint8* Out, const void* Ptr)
+	{
+		const int64 Delta = int64(UPTRINT(Ptr) - State.LastPtr);
+		State.LastPtr = UPTRINT(Ptr);
+		return WriteVarInt(Out, (uint64(Delta) << 1) ^ uint64(Delta >> 63));
+	}
+
+	static FORCEINLINE uint8* WriteCycles(FThreadState& State, uint8* Out, uint64 Cycles)
+	{
+		Out = WriteVarInt(Out, Cycles - State.LastCycles);
+		State.LastCycles = Cycles;
+		return Out;
+	}
+
+	/** Captures the current callstack and returns its id, recording its frames the first time it is seen */
+	static uint32 GetCallstackId(FThreadState& State, uint64 Cycles)
+	{
+		const uint32 Depth = (uint32)YMath::Clamp<int32>(CallstackDepth, 0, MaxCallstackDepth);
+		if (!Depth)
+		{
+			return 0;
+		}
+
+		uint64 Frames[IgnoredFrames + MaxCallstackDepth];
+		FPlatformStackWalk::CaptureStackBackTrace(Frames, IgnoredFrames + Depth);
+		const uint64* Callstack = Frames + IgnoredFrames;
+		uint32 NumFrames = 0;
+		uint64 Hash = 0xcbf29ce484222325ull;
+		while (NumFrames < Depth && Callstack[NumFrames])
+		{
+			Hash = (Hash ^ Callstack[NumFrames++]) * 0x100000001b3ull;
+		}
+		Hash ^= Hash >> 29;
+		Hash = Hash ? Hash : 1;
+
+		for (uint32 Probe = 0; Probe < MaxCallstackProbes; ++Probe)
+		{
+			const uint32 Index = (uint32(Hash) + Probe) & (CallstackTableSize - 1);
+			uint64 Existing = CallstackHashes[Index];
+			if (!Existing)
+			{
+				Existing = (uint64)FPlatformAtomics::InterlockedCompareExchange((volatile int64*)&CallstackHashes[Index], int64(Hash), 0);
+				if (!Existing)
+				{
+					const uint32 Id = Index + 1;
+					uint8* Out = BeginEvent(State, Cycles);
+					if (!Out)
+					{
+						// Nothing defines the id, so the slot is given up and the next hit tries to write it again
+						FPlatformAtomics::InterlockedCompareExchange((volatile int64*)&CallstackHashes[Index], 0, int64(Hash));
+						return 0;
+					}
+					*Out++ = uint8(EEvent::Callstack);
+					Out = WriteVarInt(Out, Id);
+					Out = WriteVarInt(Out, NumFrames);
+					for (uint32 Frame = 0; Frame < NumFrames; ++Frame)
+					{
+						Out = WriteVarInt(Out, Callstack[Frame]);
+					}
+					EndEvent(State, Out);
+					return Id;
+				}
+			}
+			if (Existing == Hash)
+			{
+				return Index + 1;
+			}
+		}
+		// Table is full around this hash
+		return 0;
+	}
+
+	/** Writes full blocks to the trace file in the background and everything that is left once the trace stops */
+	class FWriter : public FRunnable
+	{
+	public:
+		explicit FWriter(YArchive* InArchive)
+			: Archive(InArchive)
+			, WakeEvent(FPlatformProcess::GetSynchEventFromPool())
+			, bStopping(0)
+			, BytesWritten(0)
+		{
+		}
+
+		virtual ~FWriter()
+		{
+			FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		}
+
+		virtual uint32 Run() override
+		{
+			GetThreadState().bSuppressed = true;
+
+			while (!bStopping)
+			{
+				WakeEvent->Wait(WritePeriodMs);
+				WriteBlocks(PopAllFullBlocks());
+			}
+
+			// StopTrace has waited for every thread to finish its last event, so the blocks they still own are complete
+			WriteBlocks(PopAllFullBlocks());
+			for (int32 Index = 0; Index < GetNumThreadStates(); ++Index)
+			{
+				FBlock* Block = ThreadStates[Index].Block;
+				if (Block && Block->Committed)
+				{
+					WriteBlock(Block);
+					Block->Committed = 0;
+				}
+			}
+
+			delete Archive;
+			Archive = nullptr;
+			return 0;
+		}
+
+		virtual void Stop() override
+		{
+			bStopping = 1;
+			WakeEvent->Trigger();
+		}
+
+		uint64 GetBytesWritten() const
+		{
+			return BytesWritten;
+		}
+
+	private:
+		void WriteBlock(FBlock* Block)
+		{
+			FBlockHeader Header;
+			Header.ThreadId = Block->ThreadId;
+			Header.Size = uint32(Block->Committed);
+			Header.BaseCycles = Block->BaseCycles;
+			Archive->Serialize(&Header, sizeof(Header));
+			Archive->Serialize(Block->Data(), Header.Size);
+			BytesWritten += sizeof(Header) + Header.Size;
+		}
+
+		void WriteBlocks(FBlock* Block)
+		{
+			while (Block)
+			{
+				FBlock* Next = Block->Next;
+				WriteBlock(Block);
+				ReleaseBlock(Block);
+				Block = Next;
+			}
+		}
+
+		YArchive* Archive;
+		FEvent* WakeEvent;
+		volatile int32 bStopping;
+		uint64 BytesWritten;
+	};
+
+	static FMallocTraceProxy* Proxy = nullptr;
+	static FWriter* Writer = nullptr;
+	static FRunnableThread* WriterThread = nullptr;
+
+	/** Puts the proxy on top of GMalloc the first time a trace is started, it stays there afterwards */
+	static void InstallProxy()
+	{
+		while (!Proxy)
+		{
+			YMalloc* LocalGMalloc = GMalloc;
+			FMallocTraceProxy* NewProxy = new FMallocTraceProxy(LocalGMalloc);
+			if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&GMalloc, NewProxy, LocalGMalloc) == LocalGMalloc)
+			{
+				Proxy = NewProxy;
+				break;
+			}
+			delete NewProxy;
+		}
+	}
+}
+
+volatile int32 FMallocTraceProxy::bTracing = 0;
+
+FMallocTraceProxy::FMallocTraceProxy(YMalloc* InMalloc)
+	: UsedMalloc(InMalloc)
+{
+	checkf(UsedMalloc, TEXT("FMallocTraceProxy is used without a valid malloc!"));
+}
+
+void FMallocTraceProxy::TraceAlloc(void* Ptr, SIZE_T Size)
+{
+	using namespace MallocTrace;
+	if (FThreadState* State = BeginTrace())
+	{
+		const uint64 Cycles = FPlatformTime::Cycles64();
+		const uint32 CallstackId = GetCallstackId(*State, Cycles);
+		if (uint8* Out = BeginEvent(*State, Cycles))
+		{
+			*Out++ = uint8(EEvent::Alloc);
+			Out = WritePtr(*State, Out, Ptr);
+			Out = WriteVarInt(Out, Size);
+			Out = WriteVarInt(Out, CallstackId);
+			Out = WriteCycles(*State, Out, Cycles);
+			EndEvent(*State, Out);
+		}
+		EndTrace(*State);
+	}
+}
+
+void FMallocTraceProxy::TraceRealloc(void* OldPtr, void* NewPtr, SIZE_T Size, uint64 ReleaseCycles)
+{
+	using namespace MallocTrace;
+	if (FThreadState* State = BeginTrace())
+	{
+		const uint64 Cycles = FPlatformTime::Cycles64();
+		// Cycles never go back within a block, in case the malloc below traced something of its own in the meantime
+		ReleaseCycles = YMath::Clamp(ReleaseCycles, State->LastCycles, Cycles);
+		const uint32 CallstackId = NewPtr ? GetCallstackId(*State, ReleaseCycles) : 0;
+		if (uint8* Out = BeginEvent(*State, ReleaseCycles))
+		{
+			*Out++ = uint8(EEvent::Realloc);
+			Out = WritePtr(*State, Out, OldPtr);
+			Out = WritePtr(*State, Out, NewPtr);
+			Out = WriteVarInt(Out, Size);
+			Out = WriteVarInt(Out, CallstackId);
+			Out = WriteCycles(*State, Out, ReleaseCycles);
+			Out = WriteCycles(*State, Out, Cycles);
+			EndEvent(*State, Out);
+		}
+		EndTrace(*State);
+	}
+}
+
+void FMallocTraceProxy::TraceFree(void* Ptr)
+{
+	using namespace MallocTrace;
+	if (FThreadState* State = BeginTrace())
+	{
+		const uint64 Cycles = FPlatformTime::Cycles64();
+		if (uint8* Out = BeginEvent(*State, Cycles))
+		{
+			*Out++ = uint8(EEvent::Free);
+			Out = WritePtr(*State, Out, Ptr);
+			Out = WriteCycles(*State, Out, Cycles);
+			EndEvent(*State, Out);
+		}
+		EndTrace(*State);
+	}
+}
+
+bool FMallocTraceProxy::StartTrace(const TCHAR* Filename)
+{
+	using namespace MallocTrace;
+	FScopeLock Lock(&ControlCritical);
+
+	if (IsTracing())
+	{
+		UE_LOG(LogMemory, Warning, TEXT("A malloc trace is already being written to %s"), *LastTraceFilename);
+		return false;
+	}
+
+	const YString TraceFilename = (Filename && *Filename) ? YString(Filename) : YPaths::ProfilingDir() / TEXT("MallocTrace") / CreateProfileFilename(TEXT(".mtrace"), false);
+	IFileManager::Get().MakeDirectory(*YPaths::GetPath(TraceFilename), true);
+	YArchive* Archive = IFileManager::Get().CreateFileWriter(*TraceFilename);
+	if (!Archive)
+	{
+		UE_LOG(LogMemory, Warning, TEXT("Failed to open %s for the malloc trace"), *TraceFilename);
+		return false;
+	}
+
+	InstallProxy();
+
+	FFileHeader Header;
+	Header.Magic = FileMagic;
+	Header.Version = FileVersion;
+	Header.StartCycles = FPlatformTime::Cycles64();
+	Header.SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+	Archive->Serialize(&Header, sizeof(Header));
+
+	YMemory::Memzero(CallstackHashes, sizeof(CallstackHashes));
+	NumDroppedEvents = 0;
+	FPlatformAtomics::InterlockedIncrement(&Session);
+
+	Writer = new FWriter(Archive);
+	WriterThread = FRunnableThread::Create(Writer, TEXT("MallocTraceWriter"), 0, TPri_BelowNormal);
+	LastTraceFilename = TraceFilename;
+
+	FPlatformAtomics::InterlockedExchange(&bTracing, 1);
+	UE_LOG(LogMemory, Display, TEXT("Malloc trace started, writing to %s"), *TraceFilename);
+	return true;
+}
+
+void FMallocTraceProxy::StopTrace()
+{
+	using namespace MallocTrace;
+	FScopeLock Lock(&ControlCritical);
+
+	if (!IsTracing())
+	{
+		UE_LOG(LogMemory, Warning, TEXT("No malloc trace is running"));
+		return;
+	}
+
+	// The exchange is a full barrier, see BeginTrace
+	FPlatformAtomics::InterlockedExchange(&bTracing, 0);
+	for (int32 Index = 0; Index < GetNumThreadStates(); ++Index)
+	{
+		while (ThreadStates[Index].bInEvent)
+		{
+			FPlatformProcess::Sleep(0.0f);
+		}
+	}
+
+	// Kill asks the writer to stop and waits for it to write everything out
+	WriterThread->Kill(true);
+	const uint64 BytesWritten = Writer->GetBytesWritten();
+	delete WriterThread;
+	delete Writer;
+	WriterThread = nullptr;
+	Writer = nullptr;
+
+	UE_LOG(LogMemory, Display, TEXT("Malloc trace stopped, wrote %.1f MB to %s"), double(BytesWritten) / (1024.0 * 1024.0), *LastTraceFilename);
+	if (NumDroppedEvents)
+	{
+		UE_LOG(LogMemory, Warning, TEXT("%d events were dropped because the trace could not get memory for its buffers"), NumDroppedEvents);
+	}
+}
+
+YString FMallocTraceProxy::GetLastTraceFilename()
+{
+	FScopeLock Lock(&MallocTrace::ControlCritical);
+	return MallocTrace::LastTraceFilename;
+}
+
+static void MallocTraceStart(const TArray<YString>& Args)
+{
+	FMallocTraceProxy::StartTrace(Args.Num() ? *Args[0] : nullptr);
+}
+
+static FAutoConsoleCommand GMallocTraceStartCommand(
+	TEXT("MallocTrace.Start"),
+	TEXT("Starts recording every allocation and free to a binary trace file, installing the tracing proxy on first use.\n")
+	TEXT("Usage: MallocTrace.Start [Filename], defaults to a new file in <ProfilingDir>/MallocTrace"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&MallocTraceStart)
+	);
+
+static FAutoConsoleCommand GMallocTraceStopCommand(
+	TEXT("MallocTrace.Stop"),
+	TEXT("Stops the malloc trace started with MallocTrace.Start and writes out what is left of it"),
+	FConsoleCommandDelegate::CreateStatic(&FMallocTraceProxy::StopTrace)
+	);
+
+#endif // USE_MALLOC_TRACE
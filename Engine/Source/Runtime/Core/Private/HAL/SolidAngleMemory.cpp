@@ -196,6 +196,10 @@ public:
 	{
 		return UsedMalloc->QuantizeSize(Count, Alignment);
 	}
+	virtual bool TryReallocInPlace(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		return UsedMalloc->TryReallocInPlace(Ptr, NewSize, Alignment);
+	}
 	virtual void Trim() override
 	{
 		return UsedMalloc->Trim();
@@ -444,6 +448,29 @@ void YMemory::FreeExternal(void* Original)
 	}
 }
 
+void YMemory::FreeSizedExternal(void* Original, SIZE_T Size, uint32 Alignment)
+{
+	if (!GMalloc)
+	{
+		GCreateMalloc();
+		CA_ASSUME(GMalloc != NULL);	// Don't want to assert, but suppress static analysis warnings about potentially NULL GMalloc
+	}
+	if (Original)
+	{
+		GMalloc->FreeSized(Original, Size, Alignment);
+	}
+}
+
+bool YMemory::TryReallocInPlaceExternal(void* Original, SIZE_T Count, uint32 Alignment)
+{
+	if (!GMalloc)
+	{
+		GCreateMalloc();
+		CA_ASSUME(GMalloc != NULL);	// Don't want to assert, but suppress static analysis warnings about potentially NULL GMalloc
+	}
+	return GMalloc->TryReallocInPlace(Original, Count, Alignment);
+}
+
 SIZE_T YMemory::GetAllocSizeExternal(void* Original)
 { 
 	if (!GMalloc)
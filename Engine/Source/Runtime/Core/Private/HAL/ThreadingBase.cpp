@@ -6,6 +6,9 @@
 #include "Stats/Stats.h"
 #include "Misc/CoreStats.h"
 #include "Misc/EventPool.h"
+#include "Misc/QueuedThreadPool.h"
+#include "Containers/Map.h"
+#include "HAL/IConsoleManager.h"
 
 DEFINE_STAT( STAT_EventWaitWithId );
 DEFINE_STAT( STAT_EventTriggerWithId );
@@ -411,6 +414,17 @@ protected:
 	/** My Thread  */
 	FRunnableThread* Thread;
 
+	/** How long the last work this thread did took, read by the pool when the thread returns to it */
+	uint64 LastWorkCycles;
+
+	/**
+	 * Asks the pool to let this thread exit once it has been idle for long enough.
+	 *
+	 * @param IdleStartCycles When the thread started waiting, moved forward when the pool refuses
+	 * @return true if the pool no longer knows about this thread and it must exit
+	 */
+	bool TryRetire(uint64& IdleStartCycles);
+
 	/**
 	 * The real thread entry point. It waits for work events to be queued. Once
 	 * an event is queued, it executes it and goes back to waiting.
@@ -423,11 +437,17 @@ protected:
 			SET_DWORD_STAT( STAT_ThreadPoolDummyCounter, 0 );
 			// We need to wait for shorter amount of time
 			bool bContinueWaiting = true;
+			uint64 IdleStartCycles = FPlatformTime::Cycles64();
 			while( bContinueWaiting )
 			{				
 				DECLARE_SCOPE_CYCLE_COUNTER( TEXT( "FQueuedThread::Run.WaitForWork" ), STAT_FQueuedThread_Run_WaitForWork, STATGROUP_ThreadPoolAsyncTasks );
 				// Wait for some work to do
 				bContinueWaiting = !DoWorkEvent->Wait( 10 );
+				if (bContinueWaiting && !TimeToDie && TryRetire(IdleStartCycles))
+				{
+					// The pool reaps retired threads with KillThread
+					return 0;
+				}
 			}
 
 			IQueuedWork* LocalQueuedWork = QueuedWork;
@@ -436,8 +456,10 @@ protected:
 			check(LocalQueuedWork || TimeToDie); // well you woke me up, where is the job or termination request?
 			while (LocalQueuedWork)
 			{
+				const uint64 StartCycles = FPlatformTime::Cycles64();
 				// Tell the object to do the work
 				LocalQueuedWork->DoThreadedWork();
+				LastWorkCycles = FPlatformTime::Cycles64() - StartCycles;
 				// Let the object cleanup before we remove our ref to it
 				LocalQueuedWork = OwningThreadPool->ReturnToPoolOrGetNextJob(this);
 			} 
@@ -454,6 +476,7 @@ public:
 		, QueuedWork(nullptr)
 		, OwningThreadPool(nullptr)
 		, Thread(nullptr)
+		, LastWorkCycles(0)
 	{ }
 
 	/**
@@ -522,18 +545,102 @@ public:
 		DoWorkEvent->Trigger();
 	}
 
+	/** @return how long the last work done by this thread took, only valid on the thread itself */
+	uint64 GetLastWorkCycles() const
+	{
+		return LastWorkCycles;
+	}
 };
 
 
 /**
  * Implementation of a queued thread pool.
+ *
+ * Queued work is kept in one intrusive list per priority band and indexed by a map, so that queuing, taking the next
+ * work and retracting are all constant time. The pool grows and retires threads within the limits set by
+ * SetElasticLimits, which default to the number of threads it was created with.
  */
 class FQueuedThreadPoolBase : public FQueuedThreadPool
 {
 protected:
 
-	/** The work queue to pull from. */
-	TArray<IQueuedWork*> QueuedWork;
+	/**
+	 * Grows a pool whose threads are all blocked. Nothing else notices, as blocked work queues nothing more and no
+	 * thread comes back to the pool. Also deletes the threads that retired while nothing was queued.
+	 */
+	class FMonitor : public FRunnable
+	{
+	public:
+
+		FMonitor(FQueuedThreadPoolBase* InPool)
+			: Pool(InPool)
+			, WakeEvent(FPlatformProcess::GetSynchEventFromPool())
+			, TimeToDie(0)
+			, Thread(nullptr)
+		{
+			Thread = FRunnableThread::Create(this, TEXT("ThreadPoolMonitor"), 16 * 1024, TPri_AboveNormal);
+			check(Thread);
+		}
+
+		virtual ~FMonitor()
+		{
+			FPlatformAtomics::InterlockedExchange(&TimeToDie, 1);
+			WakeEvent->Trigger();
+			Thread->WaitForCompletion();
+			delete Thread;
+			FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		}
+
+		virtual uint32 Run() override
+		{
+			while (!TimeToDie)
+			{
+				WakeEvent->Wait(Pool->GetMonitorPeriodMs());
+				if (!TimeToDie)
+				{
+					Pool->CheckStalledWork();
+				}
+			}
+			return 0;
+		}
+
+	private:
+
+		FQueuedThreadPoolBase* Pool;
+		FEvent* WakeEvent;
+		volatile int32 TimeToDie;
+		FRunnableThread* Thread;
+	};
+
+	/** Queued work, linked in its band. Unused nodes are linked through Next in FreeNodes. */
+	struct FQueuedWorkNode
+	{
+		IQueuedWork* Work;
+		FQueuedWorkNode* Prev;
+		FQueuedWorkNode* Next;
+		uint64 QueuedCycles;
+		EQueuedWorkPriority Priority;
+	};
+
+	/** FIFO of the work queued with one priority */
+	struct FQueuedWorkBand
+	{
+		FQueuedWorkNode* Head;
+		FQueuedWorkNode* Tail;
+		int32 Num;
+	};
+
+	/** The work queues to pull from, highest priority first. */
+	FQueuedWorkBand QueuedWork[(int32)EQueuedWorkPriority::Count];
+
+	/** Node of every queued work, for retraction. */
+	TMap<IQueuedWork*, FQueuedWorkNode*> QueuedWorkNodes;
+
+	/** Nodes to reuse for queuing work. */
+	FQueuedWorkNode* FreeNodes;
+
+	/** Work in all the bands. */
+	int32 NumQueuedWork;
 	
 	/** The thread pool to dole work out to. */
 	TArray<FQueuedThread*> QueuedThreads;
@@ -541,59 +648,273 @@ protected:
 	/** All threads in the pool. */
 	TArray<FQueuedThread*> AllThreads;
 
+	/** Threads that left the pool after being idle and still have to be killed and deleted. */
+	TArray<FQueuedThread*> RetiredThreads;
+
+	/** Started by SetElasticLimits once the pool may grow */
+	FMonitor* Monitor;
+
 	/** The synchronization object used to protect access to the queued work. */
 	FCriticalSection* SynchQueue;
 
 	/** If true, indicates the destruction process has taken place. */
 	bool TimeToDie;
 
+	/** Stack size and priority of the threads, kept to create more of them */
+	uint32 ThreadStackSize;
+	EThreadPriority ThreadPriority;
+
+	/** Elastic limits, see SetElasticLimits */
+	uint32 MinThreads;
+	uint32 MaxThreads;
+	double GrowAfterSeconds;
+	double RetireAfterSeconds;
+
+	/** Counters reported by GetStats */
+	int32 PeakNumQueuedWork;
+	uint64 NumStarted;
+	uint64 NumRetracted;
+	uint32 NumThreadsAdded;
+	uint32 NumThreadsRetired;
+	uint64 TotalWaitCycles;
+	uint64 MaxWaitCycles;
+	uint64 TotalRunCycles;
+
+	/** Appends work to the queue of its band. Must hold SynchQueue. */
+	void EnqueueWork(IQueuedWork* InQueuedWork, EQueuedWorkPriority InPriority)
+	{
+		check(!QueuedWorkNodes.Contains(InQueuedWork)); // the same work can't be queued twice
+		FQueuedWorkNode* Node = FreeNodes;
+		if (Node)
+		{
+			FreeNodes = Node->Next;
+		}
+		else
+		{
+			Node = new FQueuedWorkNode;
+		}
+		FQueuedWorkBand& Band = QueuedWork[(int32)InPriority];
+		Node->Work = InQueuedWork;
+		Node->Prev = Band.Tail;
+		Node->Next = nullptr;
+		Node->QueuedCycles = FPlatformTime::Cycles64();
+		Node->Priority = InPriority;
+		if (Band.Tail)
+		{
+			Band.Tail->Next = Node;
+		}
+		else
+		{
+			Band.Head = Node;
+		}
+		Band.Tail = Node;
+		Band.Num++;
+		QueuedWorkNodes.Add(InQueuedWork, Node);
+		NumQueuedWork++;
+		PeakNumQueuedWork = YMath::Max(PeakNumQueuedWork, NumQueuedWork);
+	}
+
+	/** Unlinks queued work from its band and recycles its node. Must hold SynchQueue. */
+	void RemoveWork(FQueuedWorkNode* Node)
+	{
+		FQueuedWorkBand& Band = QueuedWork[(int32)Node->Priority];
+		if (Node->Prev)
+		{
+			Node->Prev->Next = Node->Next;
+		}
+		else
+		{
+			Band.Head = Node->Next;
+		}
+		if (Node->Next)
+		{
+			Node->Next->Prev = Node->Prev;
+		}
+		else
+		{
+			Band.Tail = Node->Prev;
+		}
+		Band.Num--;
+		QueuedWorkNodes.Remove(Node->Work);
+		NumQueuedWork--;
+		Node->Next = FreeNodes;
+		FreeNodes = Node;
+	}
+
+	/** Takes the oldest work of the highest priority band that has any. Must hold SynchQueue. */
+	IQueuedWork* DequeueWork()
+	{
+		for (int32 Priority = 0; Priority < (int32)EQueuedWorkPriority::Count; Priority++)
+		{
+			FQueuedWorkNode* Node = QueuedWork[Priority].Head;
+			if (Node)
+			{
+				IQueuedWork* Work = Node->Work;
+				const uint64 WaitCycles = FPlatformTime::Cycles64() - Node->QueuedCycles;
+				TotalWaitCycles += WaitCycles;
+				MaxWaitCycles = YMath::Max(MaxWaitCycles, WaitCycles);
+				NumStarted++;
+				RemoveWork(Node);
+				return Work;
+			}
+		}
+		return nullptr;
+	}
+
+	/** @return how long the work that was queued first has been waiting. Must hold SynchQueue. */
+	double GetOldestWaitSeconds() const
+	{
+		uint64 OldestCycles = MAX_uint64;
+		for (int32 Priority = 0; Priority < (int32)EQueuedWorkPriority::Count; Priority++)
+		{
+			if (QueuedWork[Priority].Head)
+			{
+				OldestCycles = YMath::Min(OldestCycles, QueuedWork[Priority].Head->QueuedCycles);
+			}
+		}
+		return OldestCycles == MAX_uint64 ? 0.0 : FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - OldestCycles);
+	}
+
+	/** Creates a thread and adds it to AllThreads. Must hold SynchQueue. */
+	FQueuedThread* CreateThread()
+	{
+		// Create a new queued thread
+		FQueuedThread* pThread = new FQueuedThread();
+		// Now create the thread and add it if ok
+		if (pThread->Create(this,ThreadStackSize,ThreadPriority) == true)
+		{
+			AllThreads.Add(pThread);
+			return pThread;
+		}
+		// Failed to fully create so clean up
+		delete pThread;
+		return nullptr;
+	}
+
+	/**
+	 * Adds a thread to take the most urgent work if the oldest queued work has waited too long, which is how running
+	 * work that blocks for a long time shows up, or if the pool is below its minimum. Must hold SynchQueue.
+	 */
+	void GrowIfStalled()
+	{
+		const uint32 NumThreads = AllThreads.Num();
+		if (NumQueuedWork > 0 && (NumThreads < MinThreads || (NumThreads < MaxThreads && GetOldestWaitSeconds() >= GrowAfterSeconds)))
+		{
+			FQueuedThread* Thread = CreateThread();
+			if (Thread)
+			{
+				NumThreadsAdded++;
+				Thread->DoWork(DequeueWork());
+			}
+		}
+	}
+
+	/** @return how long the monitor sleeps between two checks of the queue */
+	uint32 GetMonitorPeriodMs() const
+	{
+		return (uint32)YMath::Clamp(GrowAfterSeconds * 250.0, 5.0, 100.0);
+	}
+
+	/** Called by the monitor: grows the pool if its work is stalled and deletes retired threads. */
+	void CheckStalledWork()
+	{
+		TArray<FQueuedThread*> ThreadsToDelete;
+		{
+			FScopeLock sl(SynchQueue);
+			if (TimeToDie)
+			{
+				return;
+			}
+			Exchange(ThreadsToDelete, RetiredThreads);
+			GrowIfStalled();
+		}
+		DeleteThreads(ThreadsToDelete);
+	}
+
+	/** Kills and deletes threads that are no longer in the pool. Must not hold SynchQueue. */
+	static void DeleteThreads(TArray<FQueuedThread*>& Threads)
+	{
+		for (int32 Index = 0; Index < Threads.Num(); Index++)
+		{
+			Threads[Index]->KillThread();
+			delete Threads[Index];
+		}
+		Threads.Empty();
+	}
+
 public:
 
 	/** Default constructor. */
 	FQueuedThreadPoolBase()
-		: SynchQueue(nullptr)
+		: FreeNodes(nullptr)
+		, NumQueuedWork(0)
+		, Monitor(nullptr)
+		, SynchQueue(nullptr)
 		, TimeToDie(0)
-	{ }
+		, ThreadStackSize(0)
+		, ThreadPriority(TPri_Normal)
+		, MinThreads(0)
+		, MaxThreads(0)
+		, GrowAfterSeconds(0.0)
+		, RetireAfterSeconds(0.0)
+		, PeakNumQueuedWork(0)
+		, NumStarted(0)
+		, NumRetracted(0)
+		, NumThreadsAdded(0)
+		, NumThreadsRetired(0)
+		, TotalWaitCycles(0)
+		, MaxWaitCycles(0)
+		, TotalRunCycles(0)
+	{
+		YMemory::Memzero(QueuedWork, sizeof(QueuedWork));
+	}
 
 	/** Virtual destructor (cleans up the synchronization objects). */
 	virtual ~FQueuedThreadPoolBase()
 	{
 		Destroy();
+		while (FreeNodes)
+		{
+			FQueuedWorkNode* Node = FreeNodes;
+			FreeNodes = Node->Next;
+			delete Node;
+		}
 	}
 
-	virtual bool Create(uint32 InNumQueuedThreads,uint32 StackSize = (32 * 1024),EThreadPriority ThreadPriority=TPri_Normal) override
+	virtual bool Create(uint32 InNumQueuedThreads,uint32 StackSize = (32 * 1024),EThreadPriority InThreadPriority=TPri_Normal) override
 	{
 		// Make sure we have synch objects
 		bool bWasSuccessful = true;
 		check(SynchQueue == nullptr);
 		SynchQueue = new FCriticalSection();
-		FScopeLock Lock(SynchQueue);
-		// Presize the array so there is no extra memory allocated
-		check(QueuedThreads.Num() == 0);
-		QueuedThreads.Empty(InNumQueuedThreads);
-
-		// Check for stack size override.
-		if( OverrideStackSize > StackSize )
 		{
-			StackSize = OverrideStackSize;
-		}
+			FScopeLock Lock(SynchQueue);
+			// Presize the array so there is no extra memory allocated
+			check(QueuedThreads.Num() == 0);
+			QueuedThreads.Empty(InNumQueuedThreads);
 
-		// Now create each thread and add it to the array
-		for (uint32 Count = 0; Count < InNumQueuedThreads && bWasSuccessful == true; Count++)
-		{
-			// Create a new queued thread
-			FQueuedThread* pThread = new FQueuedThread();
-			// Now create the thread and add it if ok
-			if (pThread->Create(this,StackSize,ThreadPriority) == true)
+			// Check for stack size override.
+			if( OverrideStackSize > StackSize )
 			{
-				QueuedThreads.Add(pThread);
-				AllThreads.Add(pThread);
+				StackSize = OverrideStackSize;
 			}
-			else
+			ThreadStackSize = StackSize;
+			ThreadPriority = InThreadPriority;
+			MinThreads = InNumQueuedThreads;
+			MaxThreads = InNumQueuedThreads;
+
+			// Now create each thread and add it to the array
+			for (uint32 Count = 0; Count < InNumQueuedThreads && bWasSuccessful == true; Count++)
 			{
-				// Failed to fully create so clean up
-				bWasSuccessful = false;
-				delete pThread;
+				FQueuedThread* pThread = CreateThread();
+				if (pThread)
+				{
+					QueuedThreads.Add(pThread);
+				}
+				else
+				{
+					bWasSuccessful = false;
+				}
 			}
 		}
 		// Destroy any created threads if the full set was not successful
@@ -608,17 +929,28 @@ public:
 	{
 		if (SynchQueue)
 		{
+			// Stopped first, it must not add threads while the pool shuts down. It takes the lock, so it is deleted
+			// outside of it.
+			FMonitor* MonitorToDelete = nullptr;
+			{
+				FScopeLock Lock(SynchQueue);
+				Exchange(MonitorToDelete, Monitor);
+			}
+			delete MonitorToDelete;
 			{
 				FScopeLock Lock(SynchQueue);
 				TimeToDie = 1;
 				YPlatformMisc::MemoryBarrier();
 				// Clean up all queued objects
-				for (int32 Index = 0; Index < QueuedWork.Num(); Index++)
+				for (int32 Priority = 0; Priority < (int32)EQueuedWorkPriority::Count; Priority++)
 				{
-					QueuedWork[Index]->Abandon();
+					while (FQueuedWorkNode* Node = QueuedWork[Priority].Head)
+					{
+						IQueuedWork* Work = Node->Work;
+						RemoveWork(Node);
+						Work->Abandon();
+					}
 				}
-				// Empty out the invalid pointers
-				QueuedWork.Empty();
 			}
 			// wait for all threads to finish up
 			while (1)
@@ -632,18 +964,17 @@ public:
 				}
 				FPlatformProcess::Sleep(0.0f);
 			}
-			// Delete all threads
+			// Delete all threads. Idle threads may be waiting on the lock to retire, so they are killed outside of it.
+			TArray<FQueuedThread*> ThreadsToDelete;
 			{
 				FScopeLock Lock(SynchQueue);
-				// Now tell each thread to die and delete those
-				for (int32 Index = 0; Index < AllThreads.Num(); Index++)
-				{
-					AllThreads[Index]->KillThread();
-					delete AllThreads[Index];
-				}
+				ThreadsToDelete = MoveTemp(AllThreads);
+				ThreadsToDelete.Append(RetiredThreads);
 				QueuedThreads.Empty();
 				AllThreads.Empty();
+				RetiredThreads.Empty();
 			}
+			DeleteThreads(ThreadsToDelete);
 			delete SynchQueue;
 			SynchQueue = nullptr;
 		}
@@ -652,14 +983,14 @@ public:
 	int32 GetNumQueuedJobs() const
 	{
 		// this is a estimate of the number of queued jobs. 
-		// no need for thread safe lock as the queuedWork array isn't moved around in memory so unless this class is being destroyed then we don't need to wrory about it
-		return QueuedWork.Num();
+		// no need for thread safe lock as this is a plain counter, so unless this class is being destroyed then we don't need to wrory about it
+		return NumQueuedWork;
 	}
 	virtual int32 GetNumThreads() const 
 	{
 		return AllThreads.Num();
 	}
-	void AddQueuedWork(IQueuedWork* InQueuedWork) override
+	void AddQueuedWork(IQueuedWork* InQueuedWork, EQueuedWorkPriority InPriority = EQueuedWorkPriority::Normal) override
 	{
 		if (TimeToDie)
 		{
@@ -667,32 +998,39 @@ public:
 			return;
 		}
 		check(InQueuedWork != nullptr);
-		FQueuedThread* Thread = nullptr;
-		// Check to see if a thread is available. Make sure no other threads
-		// can manipulate the thread pool while we do this.
-		check(SynchQueue);
-		FScopeLock sl(SynchQueue);
-		if (QueuedThreads.Num() > 0)
-		{
-			// Cycle through all available threads to make sure that stats are up to date.
-			int32 Index = 0;
-			// Grab that thread to use
-			Thread = QueuedThreads[Index];
-			// Remove it from the list so no one else grabs it
-			QueuedThreads.RemoveAt(Index);
-		}
-		// Was there a thread ready?
-		if (Thread != nullptr)
-		{
-			// We have a thread, so tell it to do the work
-			Thread->DoWork(InQueuedWork);
-		}
-		else
+		check(InPriority < EQueuedWorkPriority::Count);
+		TArray<FQueuedThread*> ThreadsToDelete;
 		{
-			// There were no threads available, queue the work to be done
-			// as soon as one does become available
-			QueuedWork.Add(InQueuedWork);
+			FQueuedThread* Thread = nullptr;
+			// Check to see if a thread is available. Make sure no other threads
+			// can manipulate the thread pool while we do this.
+			check(SynchQueue);
+			FScopeLock sl(SynchQueue);
+			if (RetiredThreads.Num() > 0)
+			{
+				Exchange(ThreadsToDelete, RetiredThreads);
+			}
+			if (QueuedThreads.Num() > 0)
+			{
+				// Grab the most recently idle thread, which is the least likely to be retiring
+				Thread = QueuedThreads.Pop(false);
+				NumStarted++;
+			}
+			// Was there a thread ready?
+			if (Thread != nullptr)
+			{
+				// We have a thread, so tell it to do the work
+				Thread->DoWork(InQueuedWork);
+			}
+			else
+			{
+				// There were no threads available, queue the work to be done
+				// as soon as one does become available
+				EnqueueWork(InQueuedWork, InPriority);
+				GrowIfStalled();
+			}
 		}
+		DeleteThreads(ThreadsToDelete);
 	}
 
 	virtual bool RetractQueuedWork(IQueuedWork* InQueuedWork) override
@@ -704,7 +1042,14 @@ public:
 		check(InQueuedWork != nullptr);
 		check(SynchQueue);
 		FScopeLock sl(SynchQueue);
-		return !!QueuedWork.RemoveSingle(InQueuedWork);
+		FQueuedWorkNode** Node = QueuedWorkNodes.Find(InQueuedWork);
+		if (!Node)
+		{
+			return false;
+		}
+		RemoveWork(*Node);
+		NumRetracted++;
+		return true;
 	}
 
 	virtual IQueuedWork* ReturnToPoolOrGetNextJob(FQueuedThread* InQueuedThread) override
@@ -713,19 +1058,15 @@ public:
 		IQueuedWork* Work = nullptr;
 		// Check to see if there is any work to be done
 		FScopeLock sl(SynchQueue);
+		TotalRunCycles += InQueuedThread->GetLastWorkCycles();
 		if (TimeToDie)
 		{
-			check(!QueuedWork.Num());  // we better not have anything if we are dying
-		}
-		if (QueuedWork.Num() > 0)
-		{
-			// Grab the oldest work in the queue. This is slower than
-			// getting the most recent but prevents work from being
-			// queued and never done
-			Work = QueuedWork[0];
-			// Remove it from the list so no one else grabs it
-			QueuedWork.RemoveAt(0);
+			check(!NumQueuedWork);  // we better not have anything if we are dying
 		}
+		// Grab the oldest work of the most urgent band. This is slower than
+		// getting the most recent but prevents work from being
+		// queued and never done
+		Work = DequeueWork();
 		if (!Work)
 		{
 			// There was no work to be done, so add the thread to the pool
@@ -733,8 +1074,93 @@ public:
 		}
 		return Work;
 	}
+
+	virtual void SetElasticLimits(uint32 InMinThreads, uint32 InMaxThreads, double InGrowAfterSeconds, double InRetireAfterSeconds) override
+	{
+		check(InMinThreads <= InMaxThreads);
+		check(SynchQueue);
+		FScopeLock sl(SynchQueue);
+		MinThreads = InMinThreads;
+		MaxThreads = InMaxThreads;
+		GrowAfterSeconds = InGrowAfterSeconds;
+		RetireAfterSeconds = InRetireAfterSeconds;
+		// Only a pool that may grow or retire threads needs watching; once started, the monitor runs until Destroy.
+		// Its first check waits for the lock.
+		if (!Monitor && !TimeToDie && (InMaxThreads > InMinThreads || InRetireAfterSeconds > 0.0))
+		{
+			Monitor = new FMonitor(this);
+		}
+	}
+
+	virtual void GetStats(FQueuedThreadPoolStats& OutStats) const override
+	{
+		OutStats = FQueuedThreadPoolStats();
+		if (!SynchQueue)
+		{
+			return;
+		}
+		FScopeLock sl(SynchQueue);
+		OutStats.NumThreads = AllThreads.Num();
+		OutStats.NumIdleThreads = QueuedThreads.Num();
+		for (int32 Priority = 0; Priority < (int32)EQueuedWorkPriority::Count; Priority++)
+		{
+			OutStats.NumQueued[Priority] = QueuedWork[Priority].Num;
+		}
+		OutStats.PeakNumQueued = PeakNumQueuedWork;
+		OutStats.NumStarted = NumStarted;
+		OutStats.NumRetracted = NumRetracted;
+		OutStats.NumThreadsAdded = NumThreadsAdded;
+		OutStats.NumThreadsRetired = NumThreadsRetired;
+		OutStats.TotalWaitSeconds = FPlatformTime::ToSeconds64(TotalWaitCycles);
+		OutStats.MaxWaitSeconds = FPlatformTime::ToSeconds64(MaxWaitCycles);
+		OutStats.TotalRunSeconds = FPlatformTime::ToSeconds64(TotalRunCycles);
+	}
+
+	/** @return how long a thread may stay idle before it retires, 0 if it never does */
+	double GetRetireAfterSeconds() const
+	{
+		return RetireAfterSeconds;
+	}
+
+	/**
+	 * Takes an idle thread out of the pool if there are more threads than the minimum.
+	 *
+	 * @param InQueuedThread The thread that has been idle for longer than GetRetireAfterSeconds
+	 * @return true if the thread was retired and must exit, to be deleted by the next AddQueuedWork or Destroy
+	 */
+	bool RetireIdleThread(FQueuedThread* InQueuedThread)
+	{
+		FScopeLock sl(SynchQueue);
+		if (TimeToDie || (uint32)AllThreads.Num() <= MinThreads)
+		{
+			return false;
+		}
+		// Not idle anymore if it was handed work since it stopped waiting
+		if (QueuedThreads.RemoveSingle(InQueuedThread) == 0)
+		{
+			return false;
+		}
+		AllThreads.RemoveSingle(InQueuedThread);
+		RetiredThreads.Add(InQueuedThread);
+		NumThreadsRetired++;
+		return true;
+	}
 };
 
+bool FQueuedThread::TryRetire(uint64& IdleStartCycles)
+{
+	FQueuedThreadPoolBase* Pool = static_cast<FQueuedThreadPoolBase*>(OwningThreadPool);
+	const double RetireAfterSeconds = Pool->GetRetireAfterSeconds();
+	const uint64 NowCycles = FPlatformTime::Cycles64();
+	if (RetireAfterSeconds <= 0.0 || FPlatformTime::ToSeconds64(NowCycles - IdleStartCycles) < RetireAfterSeconds)
+	{
+		return false;
+	}
+	// Don't ask again before another full period if the pool needs this thread
+	IdleStartCycles = NowCycles;
+	return Pool->RetireIdleThread(this);
+}
+
 uint32 FQueuedThreadPool::OverrideStackSize = 0;
 
 FQueuedThreadPool* FQueuedThreadPool::Allocate()
@@ -742,6 +1168,38 @@ FQueuedThreadPool* FQueuedThreadPool::Allocate()
 	return new FQueuedThreadPoolBase;
 }
 
+static void DumpQueuedThreadPoolStats(const TCHAR* Name, FQueuedThreadPool* Pool)
+{
+	if (!Pool)
+	{
+		return;
+	}
+	FQueuedThreadPoolStats Stats;
+	Pool->GetStats(Stats);
+	UE_LOG(LogConsoleResponse, Display, TEXT("%s: %d threads (%d idle, %u added, %u retired), queued %d/%d/%d/%d/%d (peak %d)"),
+		Name, Stats.NumThreads, Stats.NumIdleThreads, Stats.NumThreadsAdded, Stats.NumThreadsRetired,
+		Stats.NumQueued[0], Stats.NumQueued[1], Stats.NumQueued[2], Stats.NumQueued[3], Stats.NumQueued[4], Stats.PeakNumQueued);
+	UE_LOG(LogConsoleResponse, Display, TEXT("%s: %llu started, %llu retracted, wait %.3fms avg %.3fms max, run %.3fms avg"),
+		Name, Stats.NumStarted, Stats.NumRetracted,
+		Stats.NumStarted ? Stats.TotalWaitSeconds * 1000.0 / double(Stats.NumStarted) : 0.0, Stats.MaxWaitSeconds * 1000.0,
+		Stats.NumStarted ? Stats.TotalRunSeconds * 1000.0 / double(Stats.NumStarted) : 0.0);
+}
+
+static void DumpThreadPoolStats(const TArray<YString>& Args)
+{
+	DumpQueuedThreadPoolStats(TEXT("GThreadPool"), GThreadPool);
+	DumpQueuedThreadPoolStats(TEXT("GIOThreadPool"), GIOThreadPool);
+#if WITH_EDITOR
+	DumpQueuedThreadPoolStats(TEXT("GLargeThreadPool"), GLargeThreadPool);
+#endif
+}
+
+static FAutoConsoleCommand ThreadPoolStatsCmd(
+	TEXT("ThreadPool.Stats"),
+	TEXT("Prints the threads, queue depth per priority, wait and run times of the global queued thread pools."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&DumpThreadPoolStats)
+	);
+
 
 /*-----------------------------------------------------------------------------
 	FThreadSingletonInitializer
@@ -769,11 +1227,13 @@ FTlsAutoCleanup* FThreadSingletonInitializer::Get( TFunctionRef<FTlsAutoCleanup*
 	return ThreadSingleton;
 }
 
-void FTlsAutoCleanup::Register()
+bool FTlsAutoCleanup::Register()
 {
 	FRunnableThread* RunnableThread = FRunnableThread::GetRunnableThread();
 	if( RunnableThread )
 	{
 		RunnableThread->TlsInstances.Add( this );
+		return true;
 	}
+	return false;
 }
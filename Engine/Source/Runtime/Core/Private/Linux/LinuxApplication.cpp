@@ -0,0 +1,18 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "GenericPlatform/GenericApplication.h"
+
+void FDisplayMetrics::GetDisplayMetrics(struct FDisplayMetrics& OutDisplayMetrics)
+{
+	// Only headless targets are built for Linux, so there is no display to query.
+	OutDisplayMetrics.PrimaryDisplayWidth = 0;
+	OutDisplayMetrics.PrimaryDisplayHeight = 0;
+
+	OutDisplayMetrics.PrimaryDisplayWorkAreaRect = FPlatformRect(0, 0, 0, 0);
+	OutDisplayMetrics.VirtualDisplayRect = OutDisplayMetrics.PrimaryDisplayWorkAreaRect;
+	OutDisplayMetrics.MonitorInfo.Empty();
+
+	// Apply the debug safe zones
+	OutDisplayMetrics.ApplyDefaultSafeZones();
+}
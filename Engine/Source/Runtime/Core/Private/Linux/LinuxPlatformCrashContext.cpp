@@ -0,0 +1,40 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "HAL/ExceptionHandling.h"
+#include "HAL/PlatformStackWalk.h"
+#include "HAL/ThreadHeartBeat.h"
+#include "Misc/ScopeLock.h"
+#include "Logging/LogMacros.h"
+#include "CoreGlobals.h"
+
+static FCriticalSection EnsureLock;
+static bool bReentranceGuard = false;
+
+/**
+ * Report an ensure. There is no crash report client on Linux, so the callstack is dumped to the log instead.
+ */
+void NewReportEnsure( const TCHAR* ErrorMessage )
+{
+	// Simple re-entrance guard.
+	FScopeLock Lock(&EnsureLock);
+
+	if( bReentranceGuard )
+	{
+		return;
+	}
+
+	// Stop checking heartbeat for this thread. Ensure can take a lot of time.
+	FThreadHeartBeat::Get().KillHeartBeat();
+
+	bReentranceGuard = true;
+
+	const SIZE_T StackTraceSize = 65535;
+	ANSICHAR StackTrace[StackTraceSize];
+	StackTrace[0] = 0;
+	FPlatformStackWalk::StackWalkAndDump(StackTrace, StackTraceSize, 1);
+
+	UE_LOG(LogLinux, Error, TEXT("Ensure condition failed: %s\n%s"), ErrorMessage, ANSI_TO_TCHAR(StackTrace));
+
+	bReentranceGuard = false;
+}
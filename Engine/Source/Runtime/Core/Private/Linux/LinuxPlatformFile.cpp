@@ -0,0 +1,369 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "Linux/LinuxPlatformFile.h"
+#include "CoreTypes.h"
+#include "Misc/DateTime.h"
+#include "Misc/AssertionMacros.h"
+#include "Logging/LogMacros.h"
+#include "Math/SolidAngleMathUtility.h"
+#include "HAL/SolidAngleMemory.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Containers/SolidAngleString.h"
+#include "Containers/StringConv.h"
+#include "Templates/Function.h"
+#include "Misc/Paths.h"
+#include "CoreGlobals.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <utime.h>
+
+namespace
+{
+	FORCEINLINE YDateTime UnixStatTimeToUEDateTime(const struct timespec& InTime)
+	{
+		return YDateTime::FromUnixTimestamp(InTime.tv_sec) + YTimespan(InTime.tv_nsec / 100);
+	}
+
+	FORCEINLINE FFileStatData UnixStatToUEFileData(const struct stat& FileInfo)
+	{
+		const bool bIsDirectory = S_ISDIR(FileInfo.st_mode);
+
+		int64 FileSize = -1;
+		if (!bIsDirectory)
+		{
+			FileSize = FileInfo.st_size;
+		}
+
+		// Linux does not record a creation time, the status change time is the closest equivalent
+		return FFileStatData(
+			UnixStatTimeToUEDateTime(FileInfo.st_ctim),
+			UnixStatTimeToUEDateTime(FileInfo.st_atim),
+			UnixStatTimeToUEDateTime(FileInfo.st_mtim),
+			FileSize,
+			bIsDirectory,
+			!(FileInfo.st_mode & S_IWUSR)
+			);
+	}
+}
+
+/**
+ * Linux file handle implementation
+**/
+class CORE_API FFileHandleLinux : public IFileHandle
+{
+	enum {READWRITE_SIZE = 1024 * 1024};
+	int32 FileHandle;
+
+	FORCEINLINE bool IsValid()
+	{
+		return FileHandle != -1;
+	}
+
+public:
+	FFileHandleLinux(int32 InFileHandle = -1)
+		: FileHandle(InFileHandle)
+	{
+	}
+	virtual ~FFileHandleLinux()
+	{
+		close(FileHandle);
+		FileHandle = -1;
+	}
+	virtual int64 Tell() override
+	{
+		check(IsValid());
+		return lseek(FileHandle, 0, SEEK_CUR);
+	}
+	virtual bool Seek(int64 NewPosition) override
+	{
+		check(IsValid());
+		check(NewPosition >= 0);
+		return lseek(FileHandle, NewPosition, SEEK_SET) != -1;
+	}
+	virtual bool SeekFromEnd(int64 NewPositionRelativeToEnd = 0) override
+	{
+		check(IsValid());
+		check(NewPositionRelativeToEnd <= 0);
+		return lseek(FileHandle, NewPositionRelativeToEnd, SEEK_END) != -1;
+	}
+	virtual bool Read(uint8* Destination, int64 BytesToRead) override
+	{
+		check(IsValid());
+		while (BytesToRead)
+		{
+			check(BytesToRead >= 0);
+			int64 ThisSize = YMath::Min<int64>(READWRITE_SIZE, BytesToRead);
+			check(Destination);
+			const ssize_t Result = read(FileHandle, Destination, ThisSize);
+			if (Result < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (Result <= 0)
+			{
+				return false;
+			}
+			Destination += Result;
+			BytesToRead -= Result;
+		}
+		return true;
+	}
+	virtual bool Write(const uint8* Source, int64 BytesToWrite) override
+	{
+		check(IsValid());
+		while (BytesToWrite)
+		{
+			check(BytesToWrite >= 0);
+			int64 ThisSize = YMath::Min<int64>(READWRITE_SIZE, BytesToWrite);
+			check(Source);
+			const ssize_t Result = write(FileHandle, Source, ThisSize);
+			if (Result < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (Result <= 0)
+			{
+				return false;
+			}
+			Source += Result;
+			BytesToWrite -= Result;
+		}
+		return true;
+	}
+	virtual int64 Size() override
+	{
+		check(IsValid());
+		struct stat FileInfo;
+		if (fstat(FileHandle, &FileInfo) == -1)
+		{
+			return -1;
+		}
+		return FileInfo.st_size;
+	}
+};
+
+/**
+ * Linux File I/O implementation
+**/
+class CORE_API FLinuxPlatformFile : public IPhysicalPlatformFile
+{
+protected:
+	virtual YString NormalizeFilename(const TCHAR* Filename)
+	{
+		YString Result(Filename);
+		YPaths::NormalizeFilename(Result);
+		return YPaths::ConvertRelativePathToFull(Result);
+	}
+	virtual YString NormalizeDirectory(const TCHAR* Directory)
+	{
+		YString Result(Directory);
+		YPaths::NormalizeDirectoryName(Result);
+		return YPaths::ConvertRelativePathToFull(Result);
+	}
+	bool Stat(const YString& NormalizedPath, struct stat& OutFileInfo)
+	{
+		return stat(TCHAR_TO_UTF8(*NormalizedPath), &OutFileInfo) == 0;
+	}
+public:
+	virtual bool FileExists(const TCHAR* Filename) override
+	{
+		struct stat FileInfo;
+		return Stat(NormalizeFilename(Filename), FileInfo) && S_ISREG(FileInfo.st_mode);
+	}
+	virtual int64 FileSize(const TCHAR* Filename) override
+	{
+		struct stat FileInfo;
+		if (Stat(NormalizeFilename(Filename), FileInfo) && S_ISREG(FileInfo.st_mode))
+		{
+			return FileInfo.st_size;
+		}
+		return -1;
+	}
+	virtual bool DeleteFile(const TCHAR* Filename) override
+	{
+		return unlink(TCHAR_TO_UTF8(*NormalizeFilename(Filename))) == 0;
+	}
+	virtual bool IsReadOnly(const TCHAR* Filename) override
+	{
+		struct stat FileInfo;
+		if (Stat(NormalizeFilename(Filename), FileInfo))
+		{
+			return !(FileInfo.st_mode & S_IWUSR);
+		}
+		return false;
+	}
+	virtual bool MoveFile(const TCHAR* To, const TCHAR* From) override
+	{
+		return rename(TCHAR_TO_UTF8(*NormalizeFilename(From)), TCHAR_TO_UTF8(*NormalizeFilename(To))) == 0;
+	}
+	virtual bool SetReadOnly(const TCHAR* Filename, bool bNewReadOnlyValue) override
+	{
+		const YString NormalizedFilename = NormalizeFilename(Filename);
+		struct stat FileInfo;
+		if (!Stat(NormalizedFilename, FileInfo))
+		{
+			return false;
+		}
+		mode_t NewMode = bNewReadOnlyValue ? (FileInfo.st_mode & ~(S_IWUSR | S_IWGRP | S_IWOTH)) : (FileInfo.st_mode | S_IWUSR);
+		return chmod(TCHAR_TO_UTF8(*NormalizedFilename), NewMode) == 0;
+	}
+
+	virtual YDateTime GetTimeStamp(const TCHAR* Filename) override
+	{
+		struct stat FileInfo;
+		if (Stat(NormalizeFilename(Filename), FileInfo))
+		{
+			return UnixStatTimeToUEDateTime(FileInfo.st_mtim);
+		}
+
+		return YDateTime::MinValue();
+	}
+
+	virtual void SetTimeStamp(const TCHAR* Filename, YDateTime DateTime) override
+	{
+		const YString NormalizedFilename = NormalizeFilename(Filename);
+		struct stat FileInfo;
+		if (!Stat(NormalizedFilename, FileInfo))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SetTimeStamp: Failed to stat file %s"), Filename);
+			return;
+		}
+
+		// keep the access time, only the modification time is changed
+		struct utimbuf Times;
+		Times.actime = FileInfo.st_atime;
+		Times.modtime = DateTime.ToUnixTimestamp();
+		if (utime(TCHAR_TO_UTF8(*NormalizedFilename), &Times) != 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SetTimeStamp: Failed to utime on %s"), Filename);
+		}
+	}
+
+	virtual YDateTime GetAccessTimeStamp(const TCHAR* Filename) override
+	{
+		struct stat FileInfo;
+		if (Stat(NormalizeFilename(Filename), FileInfo))
+		{
+			return UnixStatTimeToUEDateTime(FileInfo.st_atim);
+		}
+
+		return YDateTime::MinValue();
+	}
+
+	virtual YString GetFilenameOnDisk(const TCHAR* Filename) override
+	{
+		// the filesystem is case sensitive, so the name on disk is the name that was asked for
+		return Filename;
+	}
+	virtual IFileHandle* OpenRead(const TCHAR* Filename, bool bAllowWrite = false) override
+	{
+		int32 Handle = open(TCHAR_TO_UTF8(*NormalizeFilename(Filename)), (bAllowWrite ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+		if (Handle != -1)
+		{
+			return new FFileHandleLinux(Handle);
+		}
+		return nullptr;
+	}
+	virtual IFileHandle* OpenWrite(const TCHAR* Filename, bool bAppend = false, bool bAllowRead = false) override
+	{
+		int32 Flags = O_CREAT | O_CLOEXEC | (bAllowRead ? O_RDWR : O_WRONLY);
+		if (!bAppend)
+		{
+			Flags |= O_TRUNC;
+		}
+		int32 Handle = open(TCHAR_TO_UTF8(*NormalizeFilename(Filename)), Flags, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH);
+		if (Handle != -1)
+		{
+			FFileHandleLinux* PlatformFileHandle = new FFileHandleLinux(Handle);
+			if (bAppend)
+			{
+				PlatformFileHandle->SeekFromEnd(0);
+			}
+			return PlatformFileHandle;
+		}
+		return nullptr;
+	}
+
+	virtual bool DirectoryExists(const TCHAR* Directory) override
+	{
+		// Empty Directory is the current directory so assume it always exists.
+		bool bExists = !FCString::Strlen(Directory);
+		if (!bExists)
+		{
+			struct stat FileInfo;
+			bExists = Stat(NormalizeDirectory(Directory), FileInfo) && S_ISDIR(FileInfo.st_mode);
+		}
+		return bExists;
+	}
+	virtual bool CreateDirectory(const TCHAR* Directory) override
+	{
+		return mkdir(TCHAR_TO_UTF8(*NormalizeDirectory(Directory)), 0755) == 0 || errno == EEXIST;
+	}
+	virtual bool DeleteDirectory(const TCHAR* Directory) override
+	{
+		rmdir(TCHAR_TO_UTF8(*NormalizeDirectory(Directory)));
+		return !DirectoryExists(Directory);
+	}
+	virtual FFileStatData GetStatData(const TCHAR* FilenameOrDirectory) override
+	{
+		struct stat FileInfo;
+		if (Stat(NormalizeFilename(FilenameOrDirectory), FileInfo))
+		{
+			return UnixStatToUEFileData(FileInfo);
+		}
+
+		return FFileStatData();
+	}
+	virtual bool IterateDirectory(const TCHAR* Directory, FDirectoryVisitor& Visitor) override
+	{
+		const YString DirectoryStr = Directory;
+		return IterateDirectoryCommon(Directory, [&](const YString& InName, const struct stat& InInfo) -> bool
+		{
+			return Visitor.Visit(*(DirectoryStr / InName), S_ISDIR(InInfo.st_mode));
+		});
+	}
+	virtual bool IterateDirectoryStat(const TCHAR* Directory, FDirectoryStatVisitor& Visitor) override
+	{
+		const YString DirectoryStr = Directory;
+		return IterateDirectoryCommon(Directory, [&](const YString& InName, const struct stat& InInfo) -> bool
+		{
+			return Visitor.Visit(*(DirectoryStr / InName), UnixStatToUEFileData(InInfo));
+		});
+	}
+	bool IterateDirectoryCommon(const TCHAR* Directory, const TFunctionRef<bool(const YString&, const struct stat&)>& Visitor)
+	{
+		bool Result = false;
+		const YString NormalizedDirectory = NormalizeDirectory(Directory);
+		DIR* Handle = opendir(TCHAR_TO_UTF8(*NormalizedDirectory));
+		if (Handle)
+		{
+			Result = true;
+			struct dirent* Entry;
+			while (Result && (Entry = readdir(Handle)) != nullptr)
+			{
+				if (strcmp(Entry->d_name, ".") && strcmp(Entry->d_name, ".."))
+				{
+					const YString EntryName = UTF8_TO_TCHAR(Entry->d_name);
+					struct stat EntryInfo;
+					if (Stat(NormalizedDirectory / EntryName, EntryInfo))
+					{
+						Result = Visitor(EntryName, EntryInfo);
+					}
+				}
+			}
+			closedir(Handle);
+		}
+		return Result;
+	}
+};
+
+IPlatformFile& IPlatformFile::GetPlatformPhysical()
+{
+	static FLinuxPlatformFile Singleton;
+	return Singleton;
+}
@@ -0,0 +1,553 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "Linux/LinuxPlatformMemory.h"
+#include "Misc/AssertionMacros.h"
+#include "Logging/LogMacros.h"
+#include "Misc/OutputDevice.h"
+#include "Math/NumericLimits.h"
+#include "Containers/SolidAngleString.h"
+#include "CoreGlobals.h"
+#include "Misc/OutputDeviceRedirector.h"
+#include "Misc/CString.h"
+#include "Stats/Stats.h"
+#include "GenericPlatform/GenericPlatformMemoryPoolStats.h"
+
+#include "HAL/MallocAnsi.h"
+#include "HAL/MallocStomp.h"
+#include "HAL/MemoryMisc.h"
+#include "HAL/MallocBinned.h"
+#include "HAL/MallocBinned2.h"
+#include "Linux/LinuxSysfs.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sysinfo.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sched.h>
+
+namespace LinuxPlatformMemory
+{
+	/**
+	 * Reads a "Key:   <value> kB" line out of a /proc file such as /proc/meminfo or /proc/self/status.
+	 *
+	 * @return value in bytes, 0 if the key was not found
+	 */
+	static uint64 ReadProcValue(const ANSICHAR* FileName, const ANSICHAR* Key)
+	{
+		uint64 Result = 0;
+		FILE* File = fopen(FileName, "r");
+		if (File)
+		{
+			const SIZE_T KeyLen = strlen(Key);
+			ANSICHAR Line[256];
+			while (fgets(Line, sizeof(Line), File))
+			{
+				if (strncmp(Line, Key, KeyLen) == 0 && Line[KeyLen] == ':')
+				{
+					unsigned long long Value = 0;
+					if (sscanf(Line + KeyLen + 1, "%llu", &Value) == 1)
+					{
+						Result = Value * 1024ULL;
+					}
+					break;
+				}
+			}
+			fclose(File);
+		}
+		return Result;
+	}
+
+	/** Returns true if the command line passed to this process contains the given switch. */
+	static bool CommandLineContains(const ANSICHAR* Switch)
+	{
+		bool bFound = false;
+		int Fd = open("/proc/self/cmdline", O_RDONLY);
+		if (Fd >= 0)
+		{
+			ANSICHAR Buffer[4096];
+			ssize_t Read = read(Fd, Buffer, sizeof(Buffer) - 1);
+			close(Fd);
+			for (ssize_t Idx = 0; Idx < Read && !bFound; Idx += strlen(Buffer + Idx) + 1)
+			{
+				Buffer[Read] = 0;
+				bFound = strcasecmp(Buffer + Idx, Switch) == 0;
+			}
+		}
+		return bFound;
+	}
+
+	/**
+	 * Finds a "-Name=Value" argument in the command line passed to this process.
+	 *
+	 * @param Prefix switch including the '=', e.g. "-binned2sizes="
+	 * @return true if found, OutValue is truncated to OutValueSize
+	 */
+	static bool CommandLineValue(const ANSICHAR* Prefix, ANSICHAR* OutValue, SIZE_T OutValueSize)
+	{
+		bool bFound = false;
+		int Fd = open("/proc/self/cmdline", O_RDONLY);
+		if (Fd >= 0)
+		{
+			ANSICHAR Buffer[4096];
+			ssize_t Read = read(Fd, Buffer, sizeof(Buffer) - 1);
+			close(Fd);
+			const SIZE_T PrefixLen = strlen(Prefix);
+			for (ssize_t Idx = 0; Idx < Read && !bFound; Idx += strlen(Buffer + Idx) + 1)
+			{
+				Buffer[Read] = 0;
+				if (strncasecmp(Buffer + Idx, Prefix, PrefixLen) == 0)
+				{
+					strncpy(OutValue, Buffer + Idx + PrefixLen, OutValueSize - 1);
+					OutValue[OutValueSize - 1] = 0;
+					bFound = true;
+				}
+			}
+		}
+		return bFound;
+	}
+
+	/** NUMA nodes and the cores that belong to them, from /sys/devices/system/node. */
+	struct FNumaTopology
+	{
+		enum
+		{
+			MaxNodes = 64,
+			MaxCpus = 1024,
+			BitsPerMaskWord = sizeof(unsigned long) * 8
+		};
+
+		uint32 NumNodes;
+		uint8  CpuToNode[MaxCpus];
+
+		FNumaTopology()
+			: NumNodes(1)
+		{
+			memset(CpuToNode, 0, sizeof(CpuToNode));
+
+			// Node numbers can have holes, nodes without cores never come up as current and only cost a few bytes per table
+			uint32 HighestNode = 0;
+			LinuxSysfs::ForEachOnlineNode([this, &HighestNode](int32 Node)
+			{
+				if (Node >= MaxNodes)
+				{
+					return;
+				}
+				HighestNode = YMath::Max<uint32>(HighestNode, uint32(Node));
+				LinuxSysfs::ForEachCpuOfNode(Node, [this, Node](int32 Cpu)
+				{
+					if (Cpu < MaxCpus)
+					{
+						CpuToNode[Cpu] = uint8(Node);
+					}
+				});
+			});
+			NumNodes = HighestNode + 1;
+		}
+	};
+
+	/** Read on first use, which is the allocator's constructor when NUMA placement is enabled. */
+	static const FNumaTopology& GetNumaTopology()
+	{
+		static FNumaTopology Topology;
+		return Topology;
+	}
+}
+
+void YLinuxPlatformMemory::Init()
+{
+	YGenericPlatformMemory::Init();
+
+	const YPlatformMemoryConstants& MemoryConstants = YPlatformMemory::GetConstants();
+	UE_LOG(LogMemory, Log, TEXT("Memory total: Physical=%.1fGB (%dGB approx) Pagesize=%.1fKB"),
+		float(MemoryConstants.TotalPhysical / 1024.0 / 1024.0 / 1024.0),
+		MemoryConstants.TotalPhysicalGB,
+		float(MemoryConstants.OsAllocationGranularity / 1024.0));
+}
+
+// Set rather to use BinnedMalloc2 for binned malloc, can be overridden below
+#define USE_MALLOC_BINNED2 (1)
+
+YMalloc* YLinuxPlatformMemory::BaseAllocator()
+{
+	if (FORCE_ANSI_ALLOCATOR)
+	{
+		AllocatorToUse = EMemoryAllocatorToUse::Ansi;
+	}
+	else if (USE_MALLOC_STOMP)
+	{
+		AllocatorToUse = EMemoryAllocatorToUse::Stomp;
+	}
+	else if (USE_MALLOC_BINNED2)
+	{
+		AllocatorToUse = EMemoryAllocatorToUse::Binned2;
+	}
+	else
+	{
+		AllocatorToUse = EMemoryAllocatorToUse::Binned;
+	}
+
+#if !UE_BUILD_SHIPPING
+	// If not shipping, allow overriding with command line options, this happens very early (before FCommandLine is set) so read /proc directly
+	if (LinuxPlatformMemory::CommandLineContains("-ansimalloc"))
+	{
+		AllocatorToUse = EMemoryAllocatorToUse::Ansi;
+	}
+	else if (LinuxPlatformMemory::CommandLineContains("-binnedmalloc2"))
+	{
+		AllocatorToUse = EMemoryAllocatorToUse::Binned2;
+	}
+	else if (LinuxPlatformMemory::CommandLineContains("-binnedmalloc"))
+	{
+		AllocatorToUse = EMemoryAllocatorToUse::Binned;
+	}
+#endif
+
+	switch (AllocatorToUse)
+	{
+	case EMemoryAllocatorToUse::Ansi:
+		return new FMallocAnsi();
+#if USE_MALLOC_STOMP
+	case EMemoryAllocatorToUse::Stomp:
+		return new FMallocStomp();
+#endif
+	case EMemoryAllocatorToUse::Binned2:
+	{
+		bool bUseHugePages = BINNED2_USE_HUGE_PAGES;
+		bool bUseNuma = BINNED2_USE_NUMA;
+#if !UE_BUILD_SHIPPING
+		bUseHugePages = bUseHugePages || LinuxPlatformMemory::CommandLineContains("-hugepages");
+		bUseNuma = bUseNuma || LinuxPlatformMemory::CommandLineContains("-numa");
+#endif
+		// -binned2sizes=16,32,... or -binned2sizes=<file written by MallocBinned2.SaveSizeClasses>
+		ANSICHAR SizesValue[1024];
+		uint16 SmallBlockSizes[BINNED2_SMALL_POOL_COUNT];
+		if (LinuxPlatformMemory::CommandLineValue("-binned2sizes=", SizesValue, sizeof(SizesValue))
+			&& YMallocBinned2::ParseSmallBlockSizes(SizesValue, SmallBlockSizes))
+		{
+			return new YMallocBinned2(bUseHugePages, SmallBlockSizes, bUseNuma);
+		}
+		return new YMallocBinned2(bUseHugePages, nullptr, bUseNuma);
+	}
+
+	default:	// intentional fall-through
+	case EMemoryAllocatorToUse::Binned:
+		return new YMallocBinned((uint32)(GetConstants().PageSize&MAX_uint32), (uint64)MAX_uint32 + 1);
+	}
+}
+
+YPlatformMemoryStats YLinuxPlatformMemory::GetStats()
+{
+	// This method is slow, do not call it too often.
+	YPlatformMemoryStats MemoryStats;
+
+	MemoryStats.AvailablePhysical = LinuxPlatformMemory::ReadProcValue("/proc/meminfo", "MemAvailable");
+	if (MemoryStats.AvailablePhysical == 0)
+	{
+		// kernels older than 3.14 do not report MemAvailable
+		MemoryStats.AvailablePhysical = LinuxPlatformMemory::ReadProcValue("/proc/meminfo", "MemFree") + LinuxPlatformMemory::ReadProcValue("/proc/meminfo", "Cached");
+	}
+	MemoryStats.AvailableVirtual = MemoryStats.AvailablePhysical + LinuxPlatformMemory::ReadProcValue("/proc/meminfo", "SwapFree");
+
+	MemoryStats.UsedPhysical = LinuxPlatformMemory::ReadProcValue("/proc/self/status", "VmRSS");
+	MemoryStats.PeakUsedPhysical = LinuxPlatformMemory::ReadProcValue("/proc/self/status", "VmHWM");
+	MemoryStats.UsedVirtual = LinuxPlatformMemory::ReadProcValue("/proc/self/status", "VmSize");
+	MemoryStats.PeakUsedVirtual = LinuxPlatformMemory::ReadProcValue("/proc/self/status", "VmPeak");
+
+	return MemoryStats;
+}
+
+const YPlatformMemoryConstants& YLinuxPlatformMemory::GetConstants()
+{
+	static YPlatformMemoryConstants MemoryConstants;
+
+	if (MemoryConstants.TotalPhysical == 0)
+	{
+		struct sysinfo SysInfo;
+		if (sysinfo(&SysInfo) == 0)
+		{
+			MemoryConstants.TotalPhysical = static_cast<uint64>(SysInfo.mem_unit) * static_cast<uint64>(SysInfo.totalram);
+			MemoryConstants.TotalVirtual = MemoryConstants.TotalPhysical + static_cast<uint64>(SysInfo.mem_unit) * static_cast<uint64>(SysInfo.totalswap);
+		}
+
+		// Binned allocators want 64KiB pages like on Windows (allocation granularity), the OS hands out 4KiB ones
+		MemoryConstants.OsAllocationGranularity = sysconf(_SC_PAGESIZE);
+		MemoryConstants.PageSize = Align(BINNED2_LARGE_ALLOC, MemoryConstants.OsAllocationGranularity);
+#if PLATFORM_64BITS
+		MemoryConstants.AddressLimit = DECLARE_UINT64(0x0000800000000000);	// 47-bit user space
+#endif
+
+		MemoryConstants.TotalPhysicalGB = (MemoryConstants.TotalPhysical + 1024 * 1024 * 1024 - 1) / 1024 / 1024 / 1024;
+	}
+
+	return MemoryConstants;
+}
+
+bool YLinuxPlatformMemory::PageProtect(void* const Ptr, const SIZE_T Size, const bool bCanRead, const bool bCanWrite)
+{
+	int32 ProtectMode;
+	if (bCanRead && bCanWrite)
+	{
+		ProtectMode = PROT_READ | PROT_WRITE;
+	}
+	else if (bCanWrite)
+	{
+		ProtectMode = PROT_WRITE;
+	}
+	else if (bCanRead)
+	{
+		ProtectMode = PROT_READ;
+	}
+	else
+	{
+		ProtectMode = PROT_NONE;
+	}
+	return mprotect(Ptr, Size, ProtectMode) == 0;
+}
+
+void* YLinuxPlatformMemory::BinnedAllocFromOS(SIZE_T Size)
+{
+	// mmap only guarantees OS page alignment, binned allocators rely on PageSize alignment so map the slack and trim it
+	const YPlatformMemoryConstants& MemoryConstants = GetConstants();
+	const SIZE_T AlignedSize = Align(Size, MemoryConstants.OsAllocationGranularity);
+	const SIZE_T ExtraSize = MemoryConstants.PageSize - MemoryConstants.OsAllocationGranularity;
+
+	void* Pointer = mmap(nullptr, AlignedSize + ExtraSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (Pointer == MAP_FAILED)
+	{
+		return nullptr;
+	}
+
+	uint8* AlignedPointer = Align((uint8*)Pointer, MemoryConstants.PageSize);
+	const SIZE_T LeadingSlack = AlignedPointer - (uint8*)Pointer;
+	const SIZE_T TrailingSlack = ExtraSize - LeadingSlack;
+	if (LeadingSlack)
+	{
+		munmap(Pointer, LeadingSlack);
+	}
+	if (TrailingSlack)
+	{
+		munmap(AlignedPointer + AlignedSize, TrailingSlack);
+	}
+	return AlignedPointer;
+}
+
+void YLinuxPlatformMemory::BinnedFreeToOS(void* Ptr, SIZE_T Size)
+{
+	const SIZE_T AlignedSize = Align(Size, GetConstants().OsAllocationGranularity);
+	if (munmap(Ptr, AlignedSize) != 0)
+	{
+		const int ErrNo = errno;
+		UE_LOG(LogHAL, Fatal, TEXT("munmap(addr=%p, len=%llu) failed with errno = %d (%s)"), Ptr, (uint64)AlignedSize,
+			ErrNo, ANSI_TO_TCHAR(strerror(ErrNo)));
+	}
+}
+
+bool YLinuxPlatformMemory::BinnedTryExtendInPlace(void* Ptr, SIZE_T OldSize, SIZE_T NewSize)
+{
+	checkSlow(IsAligned(OldSize, GetConstants().OsAllocationGranularity) && IsAligned(NewSize, GetConstants().OsAllocationGranularity));
+	// Without MREMAP_MAYMOVE the kernel only grows the mapping if the pages after it are free, and fails otherwise
+	return NewSize <= OldSize || mremap(Ptr, OldSize, NewSize, 0) != MAP_FAILED;
+}
+
+uint32 YLinuxPlatformMemory::GetNumaNodeCount()
+{
+	return LinuxPlatformMemory::GetNumaTopology().NumNodes;
+}
+
+uint32 YLinuxPlatformMemory::GetCurrentNumaNode()
+{
+	const LinuxPlatformMemory::FNumaTopology& Topology = LinuxPlatformMemory::GetNumaTopology();
+	if (Topology.NumNodes == 1)
+	{
+		return 0;
+	}
+	const int Cpu = sched_getcpu();
+	return (Cpu >= 0 && Cpu < LinuxPlatformMemory::FNumaTopology::MaxCpus) ? Topology.CpuToNode[Cpu] : 0;
+}
+
+void* YLinuxPlatformMemory::NumaAllocFromOS(SIZE_T Size, uint32 Node)
+{
+	typedef LinuxPlatformMemory::FNumaTopology FNumaTopology;
+
+	void* Pointer = BinnedAllocFromOS(Size);
+	if (Pointer && Node < GetNumaNodeCount() && GetNumaNodeCount() > 1)
+	{
+		// mbind without libnuma; nothing is touched yet, so every page is faulted in on the preferred node
+		const int LinuxMpolPreferred = 1;
+		unsigned long NodeMask[FNumaTopology::MaxNodes / FNumaTopology::BitsPerMaskWord] = { 0 };
+		NodeMask[Node / FNumaTopology::BitsPerMaskWord] = 1UL << (Node % FNumaTopology::BitsPerMaskWord);
+		syscall(SYS_mbind, Pointer, Align(Size, GetConstants().OsAllocationGranularity), LinuxMpolPreferred, NodeMask, FNumaTopology::MaxNodes + 1, 0);
+	}
+	return Pointer;
+}
+
+void* YLinuxPlatformMemory::HugePageAllocFromOS(SIZE_T Size, bool& bOutHugePages)
+{
+	// Transparent huge pages are only used for 2MB aligned ranges, so map the slack and trim it like BinnedAllocFromOS
+	const SIZE_T HugePageSize = GetHugePageSize();
+	const SIZE_T AlignedSize = Align(Size, HugePageSize);
+	const SIZE_T ExtraSize = HugePageSize - GetConstants().OsAllocationGranularity;
+
+	void* Pointer = mmap(nullptr, AlignedSize + ExtraSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (Pointer == MAP_FAILED)
+	{
+		bOutHugePages = false;
+		return nullptr;
+	}
+
+	uint8* AlignedPointer = Align((uint8*)Pointer, HugePageSize);
+	const SIZE_T LeadingSlack = AlignedPointer - (uint8*)Pointer;
+	const SIZE_T TrailingSlack = ExtraSize - LeadingSlack;
+	if (LeadingSlack)
+	{
+		munmap(Pointer, LeadingSlack);
+	}
+	if (TrailingSlack)
+	{
+		munmap(AlignedPointer + AlignedSize, TrailingSlack);
+	}
+
+#ifdef MADV_HUGEPAGE
+	// Fails when THP is disabled in the kernel, in which case the region still works with regular pages
+	bOutHugePages = madvise(AlignedPointer, AlignedSize, MADV_HUGEPAGE) == 0;
+#else
+	bOutHugePages = false;
+#endif
+	return AlignedPointer;
+}
+
+void YLinuxPlatformMemory::HugePageFreeToOS(void* Ptr, SIZE_T Size)
+{
+	BinnedFreeToOS(Ptr, Align(Size, GetHugePageSize()));
+}
+
+YPlatformMemory::YSharedMemoryRegion* YLinuxPlatformMemory::MapNamedSharedMemoryRegion(const YString& InName, bool bCreate, uint32 AccessMode, SIZE_T Size)
+{
+	// expecting platform-independent name, so convert it to match platform requirements
+	YString Name(TEXT("/"));
+	Name += InName;
+	FTCHARToUTF8 NameUTF8(*Name);
+
+	// correct size to match platform constraints
+	const YPlatformMemoryConstants& MemoryConstants = GetConstants();
+	check(MemoryConstants.OsAllocationGranularity);
+	Size = Align(Size, MemoryConstants.OsAllocationGranularity);
+
+	int OpenFlags = bCreate ? O_CREAT : 0;
+	// note that you cannot combine O_RDONLY and O_WRONLY to get O_RDWR
+	check(AccessMode != 0);
+	if (AccessMode == YPlatformMemory::ESharedMemoryAccess::Read)
+	{
+		OpenFlags |= O_RDONLY;
+	}
+	else if (AccessMode == YPlatformMemory::ESharedMemoryAccess::Write)
+	{
+		OpenFlags |= O_WRONLY;
+	}
+	else if (AccessMode == (YPlatformMemory::ESharedMemoryAccess::Write | YPlatformMemory::ESharedMemoryAccess::Read))
+	{
+		OpenFlags |= O_RDWR;
+	}
+
+	int SharedMemoryFd = shm_open(NameUTF8.Get(), OpenFlags, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+	if (SharedMemoryFd == -1)
+	{
+		int ErrNo = errno;
+		UE_LOG(LogHAL, Warning, TEXT("shm_open(name='%s', flags=0x%x) failed with errno = %d (%s)"), *Name, OpenFlags, ErrNo,
+			ANSI_TO_TCHAR(strerror(ErrNo)));
+		return NULL;
+	}
+
+	// truncate if creating (note that we may still don't have rights to do so)
+	if (bCreate)
+	{
+		int Res = ftruncate(SharedMemoryFd, Size);
+		if (Res != 0)
+		{
+			int ErrNo = errno;
+			UE_LOG(LogHAL, Warning, TEXT("ftruncate(fd=%d, size=%llu) failed with errno = %d (%s)"), SharedMemoryFd, (uint64)Size, ErrNo,
+				ANSI_TO_TCHAR(strerror(ErrNo)));
+			shm_unlink(NameUTF8.Get());
+			return NULL;
+		}
+	}
+
+	// map
+	int MmapProtFlags = 0;
+	if (AccessMode & YPlatformMemory::ESharedMemoryAccess::Read)
+	{
+		MmapProtFlags |= PROT_READ;
+	}
+
+	if (AccessMode & YPlatformMemory::ESharedMemoryAccess::Write)
+	{
+		MmapProtFlags |= PROT_WRITE;
+	}
+
+	void* Ptr = mmap(NULL, Size, MmapProtFlags, MAP_SHARED, SharedMemoryFd, 0);
+	if (Ptr == MAP_FAILED)
+	{
+		int ErrNo = errno;
+		UE_LOG(LogHAL, Warning, TEXT("mmap(addr=NULL, length=%llu, prot=0x%x, flags=MAP_SHARED, fd=%d, 0) failed with errno = %d (%s)"),
+			(uint64)Size, MmapProtFlags, SharedMemoryFd, ErrNo, ANSI_TO_TCHAR(strerror(ErrNo)));
+
+		if (bCreate)
+		{
+			shm_unlink(NameUTF8.Get());
+		}
+		return NULL;
+	}
+
+	return new FLinuxSharedMemoryRegion(Name, AccessMode, Ptr, Size, SharedMemoryFd, bCreate);
+}
+
+bool YLinuxPlatformMemory::UnmapNamedSharedMemoryRegion(YSharedMemoryRegion * MemoryRegion)
+{
+	bool bAllSucceeded = true;
+
+	if (MemoryRegion)
+	{
+		FLinuxSharedMemoryRegion * LinuxRegion = static_cast< FLinuxSharedMemoryRegion* >(MemoryRegion);
+
+		if (munmap(LinuxRegion->GetAddress(), LinuxRegion->GetSize()) == -1)
+		{
+			bAllSucceeded = false;
+
+			int ErrNo = errno;
+			UE_LOG(LogHAL, Warning, TEXT("munmap(addr=%p, len=%llu) failed with errno = %d (%s)"), LinuxRegion->GetAddress(), (uint64)LinuxRegion->GetSize(),
+				ErrNo, ANSI_TO_TCHAR(strerror(ErrNo)));
+		}
+
+		if (close(LinuxRegion->GetFileDescriptor()) == -1)
+		{
+			bAllSucceeded = false;
+
+			int ErrNo = errno;
+			UE_LOG(LogHAL, Warning, TEXT("close(fd=%d) failed with errno = %d (%s)"), LinuxRegion->GetFileDescriptor(),
+				ErrNo, ANSI_TO_TCHAR(strerror(ErrNo)));
+		}
+
+		if (LinuxRegion->NeedsToUnlinkRegion())
+		{
+			FTCHARToUTF8 NameUTF8(LinuxRegion->GetName());
+			if (shm_unlink(NameUTF8.Get()) == -1)
+			{
+				bAllSucceeded = false;
+
+				int ErrNo = errno;
+				UE_LOG(LogHAL, Warning, TEXT("shm_unlink(name='%s') failed with errno = %d (%s)"), LinuxRegion->GetName(),
+					ErrNo, ANSI_TO_TCHAR(strerror(ErrNo)));
+			}
+		}
+
+		// delete the region
+		delete LinuxRegion;
+	}
+
+	return bAllSucceeded;
+}
@@ -0,0 +1,469 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "Linux/LinuxPlatformMisc.h"
+#include "Misc/AssertionMacros.h"
+#include "Logging/LogMacros.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformProcess.h"
+#include "CoreGlobals.h"
+#include "Containers/StringConv.h"
+#include "Containers/SolidAngleString.h"
+#include "Misc/Guid.h"
+#include "Linux/LinuxSysfs.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <netpacket/packet.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/statvfs.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#if PLATFORM_CPU_X86_FAMILY || defined(__x86_64__) || defined(__i386__)
+	#include <cpuid.h>
+	#define LINUX_HAS_CPUID 1
+#else
+	#define LINUX_HAS_CPUID 0
+#endif
+
+namespace LinuxPlatformMisc
+{
+	/** Set by the termination signal handler, polled by the main loop through GIsRequestingExit. */
+	static void GracefulTerminationHandler(int32 Signal)
+	{
+		GIsRequestingExit = true;
+	}
+
+	/** Returns the number of distinct (physical id, core id) pairs listed in /proc/cpuinfo, or 0 on failure. */
+	static int32 CountPhysicalCores()
+	{
+		FILE* CpuInfo = fopen("/proc/cpuinfo", "r");
+		if (!CpuInfo)
+		{
+			return 0;
+		}
+
+		TArray<uint64> SeenCores;
+		int32 PhysicalId = 0;
+		char Line[256];
+		while (fgets(Line, sizeof(Line), CpuInfo))
+		{
+			int32 Value = 0;
+			if (sscanf(Line, "physical id : %d", &Value) == 1)
+			{
+				PhysicalId = Value;
+			}
+			else if (sscanf(Line, "core id : %d", &Value) == 1)
+			{
+				SeenCores.AddUnique((uint64(PhysicalId) << 32) | uint32(Value));
+			}
+		}
+		fclose(CpuInfo);
+		return SeenCores.Num();
+	}
+
+	/**
+	 * Returns the lowest cpu sharing the last level cache of Cpu, which identifies the cache domain, or INDEX_NONE if
+	 * sysfs does not describe the caches.
+	 */
+	static int32 FindLastLevelCacheOwner(int32 Cpu)
+	{
+		int32 BestLevel = 0;
+		int32 Owner = INDEX_NONE;
+		for (int32 CacheIndex = 0; ; CacheIndex++)
+		{
+			char Path[128];
+			int32 Level = 0;
+			snprintf(Path, sizeof(Path), "/sys/devices/system/cpu/cpu%d/cache/index%d/level", Cpu, CacheIndex);
+			if (!LinuxSysfs::ReadInt(Path, Level))
+			{
+				break;
+			}
+			int32 FirstSharing = 0;
+			snprintf(Path, sizeof(Path), "/sys/devices/system/cpu/cpu%d/cache/index%d/shared_cpu_list", Cpu, CacheIndex);
+			if (Level >= BestLevel && LinuxSysfs::ReadInt(Path, FirstSharing))
+			{
+				BestLevel = Level;
+				Owner = FirstSharing;
+			}
+		}
+		return Owner;
+	}
+}
+
+void YLinuxPlatformMisc::PlatformPreInit()
+{
+	YGenericPlatformMisc::PlatformPreInit();
+}
+
+void YLinuxPlatformMisc::PlatformInit()
+{
+	UE_LOG(LogInit, Log, TEXT("Linux hardware info:"));
+	UE_LOG(LogInit, Log, TEXT(" - we are %sthe first instance of this executable"), FPlatformProcess::IsFirstInstance() ? TEXT("") : TEXT("not "));
+	UE_LOG(LogInit, Log, TEXT(" - this machine has %d physical cores, %d logical cores"), NumberOfCores(), NumberOfCoresIncludingHyperthreads());
+	UE_LOG(LogInit, Log, TEXT(" - CPU: %s '%s' (signature: 0x%X)"), *GetCPUVendor(), *GetCPUBrand(), GetCPUInfo());
+}
+
+void YLinuxPlatformMisc::SetGracefulTerminationHandler()
+{
+	struct sigaction Action;
+	YMemory::Memzero(Action);
+	Action.sa_handler = LinuxPlatformMisc::GracefulTerminationHandler;
+	sigfillset(&Action.sa_mask);
+	Action.sa_flags = SA_RESTART;
+	sigaction(SIGINT, &Action, nullptr);
+	sigaction(SIGTERM, &Action, nullptr);
+	sigaction(SIGHUP, &Action, nullptr);
+}
+
+void YLinuxPlatformMisc::GetEnvironmentVariable(const TCHAR* VariableName, TCHAR* Result, int32 ResultLength)
+{
+	check(Result && ResultLength > 0);
+	const char* Value = getenv(TCHAR_TO_UTF8(VariableName));
+	if (Value)
+	{
+		FCString::Strncpy(Result, UTF8_TO_TCHAR(Value), ResultLength);
+	}
+	else
+	{
+		*Result = 0;
+	}
+}
+
+void YLinuxPlatformMisc::SetEnvironmentVar(const TCHAR* VariableName, const TCHAR* Value)
+{
+	if (Value == nullptr || *Value == 0)
+	{
+		unsetenv(TCHAR_TO_UTF8(VariableName));
+	}
+	else
+	{
+		setenv(TCHAR_TO_UTF8(VariableName), TCHAR_TO_UTF8(Value), 1);
+	}
+}
+
+TArray<uint8> YLinuxPlatformMisc::GetMacAddress()
+{
+	TArray<uint8> Result;
+
+	struct ifaddrs* Interfaces = nullptr;
+	if (getifaddrs(&Interfaces) != 0)
+	{
+		return Result;
+	}
+
+	for (struct ifaddrs* Interface = Interfaces; Interface; Interface = Interface->ifa_next)
+	{
+		if (Interface->ifa_addr == nullptr || Interface->ifa_addr->sa_family != AF_PACKET || (Interface->ifa_flags & IFF_LOOPBACK))
+		{
+			continue;
+		}
+
+		const struct sockaddr_ll* LinkAddress = reinterpret_cast<const struct sockaddr_ll*>(Interface->ifa_addr);
+		if (LinkAddress->sll_halen == 6)
+		{
+			Result.Append(LinkAddress->sll_addr, 6);
+			break;
+		}
+	}
+
+	freeifaddrs(Interfaces);
+	return Result;
+}
+
+#if !UE_BUILD_SHIPPING
+bool YLinuxPlatformMisc::IsDebuggerPresent()
+{
+	// the kernel reports the pid of the tracer, if any, in /proc/self/status
+	int StatusFile = open("/proc/self/status", O_RDONLY);
+	if (StatusFile == -1)
+	{
+		return false;
+	}
+
+	char Buffer[4096];
+	const ssize_t Length = read(StatusFile, Buffer, sizeof(Buffer) - 1);
+	close(StatusFile);
+	if (Length <= 0)
+	{
+		return false;
+	}
+	Buffer[Length] = 0;
+
+	const char* TracerPid = strstr(Buffer, "TracerPid:");
+	return TracerPid && atoi(TracerPid + 10) != 0;
+}
+#endif
+
+void YLinuxPlatformMisc::LocalPrint(const TCHAR *Message)
+{
+	// stdout is byte-oriented, so convert explicitly rather than mixing wide and narrow output
+	fputs(TCHAR_TO_UTF8(Message), stdout);
+}
+
+void YLinuxPlatformMisc::RequestExit(bool Force)
+{
+	UE_LOG(LogHAL, Log, TEXT("YLinuxPlatformMisc::RequestExit(%i)"), Force);
+	if (Force)
+	{
+		// Force immediate exit, without running destructors or flushing config.
+		_exit(1);
+	}
+	else
+	{
+		// Tell the platform specific code we want to exit cleanly from the main loop.
+		GIsRequestingExit = 1;
+	}
+}
+
+const TCHAR* YLinuxPlatformMisc::GetSystemErrorMessage(TCHAR* OutBuffer, int32 BufferCount, int32 Error)
+{
+	check(OutBuffer && BufferCount);
+	if (Error == 0)
+	{
+		Error = errno;
+	}
+
+	char ErrorBuffer[1024];
+	// GNU strerror_r may return a static string rather than filling the buffer
+	const char* ErrorString = strerror_r(Error, ErrorBuffer, sizeof(ErrorBuffer));
+	FCString::Strncpy(OutBuffer, UTF8_TO_TCHAR(ErrorString), BufferCount);
+	return OutBuffer;
+}
+
+void YLinuxPlatformMisc::CreateGuid(YGuid& Result)
+{
+	// prefer kernel randomness, fall back to the time-based generic implementation
+	int RandomFile = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+	if (RandomFile != -1)
+	{
+		uint32 Bytes[4];
+		const ssize_t BytesRead = read(RandomFile, Bytes, sizeof(Bytes));
+		close(RandomFile);
+		if (BytesRead == sizeof(Bytes))
+		{
+			Result = YGuid(Bytes[0], Bytes[1], Bytes[2], Bytes[3]);
+			return;
+		}
+	}
+	YGenericPlatformMisc::CreateGuid(Result);
+}
+
+bool YLinuxPlatformMisc::Is64bitOperatingSystem()
+{
+	return PLATFORM_64BITS;
+}
+
+int32 YLinuxPlatformMisc::NumberOfCores()
+{
+	static int32 CoreCount = 0;
+	if (CoreCount == 0)
+	{
+		CoreCount = LinuxPlatformMisc::CountPhysicalCores();
+		if (CoreCount <= 0)
+		{
+			CoreCount = NumberOfCoresIncludingHyperthreads();
+		}
+	}
+	return CoreCount;
+}
+
+int32 YLinuxPlatformMisc::NumberOfCoresIncludingHyperthreads()
+{
+	static int32 CoreCount = 0;
+	if (CoreCount == 0)
+	{
+		cpu_set_t AvailableCpus;
+		CPU_ZERO(&AvailableCpus);
+		if (sched_getaffinity(0, sizeof(AvailableCpus), &AvailableCpus) == 0)
+		{
+			CoreCount = CPU_COUNT(&AvailableCpus);
+		}
+		if (CoreCount <= 0)
+		{
+			CoreCount = YMath::Max<int32>(1, (int32)sysconf(_SC_NPROCESSORS_ONLN));
+		}
+	}
+	return CoreCount;
+}
+
+void YLinuxPlatformMisc::GetProcessorTopology(TArray<FProcessorTopology>& OutProcessors)
+{
+	cpu_set_t AvailableCpus;
+	CPU_ZERO(&AvailableCpus);
+	if (sched_getaffinity(0, sizeof(AvailableCpus), &AvailableCpus) != 0)
+	{
+		YGenericPlatformMisc::GetProcessorTopology(OutProcessors);
+		return;
+	}
+
+	// node of each cpu, the same nodes YLinuxPlatformMemory places memory on
+	TArray<int32> CpuNodes;
+	CpuNodes.AddZeroed(CPU_SETSIZE);
+	LinuxSysfs::ForEachOnlineNode([&CpuNodes](int32 Node)
+	{
+		LinuxSysfs::ForEachCpuOfNode(Node, [&CpuNodes, Node](int32 Cpu)
+		{
+			if (Cpu < CPU_SETSIZE)
+			{
+				CpuNodes[Cpu] = Node;
+			}
+		});
+	});
+
+	// physical ids, cores and caches are identified by keys until they are given dense ids
+	TArray<uint64> CoreKeys;
+	TArray<int64> CacheKeys;
+	TArray<int32> NodeKeys;
+	bool bFoundTopology = false;
+	OutProcessors.Empty(CPU_COUNT(&AvailableCpus));
+	for (int32 Cpu = 0; Cpu < CPU_SETSIZE; Cpu++)
+	{
+		if (!CPU_ISSET(Cpu, &AvailableCpus))
+		{
+			continue;
+		}
+		char Path[128];
+		int32 Package = 0;
+		int32 Core = Cpu;
+		snprintf(Path, sizeof(Path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", Cpu);
+		LinuxSysfs::ReadInt(Path, Package);
+		snprintf(Path, sizeof(Path), "/sys/devices/system/cpu/cpu%d/topology/core_id", Cpu);
+		bFoundTopology |= LinuxSysfs::ReadInt(Path, Core);
+
+		// without cache information, the package is the best guess of which cores share a cache
+		const int32 CacheOwner = LinuxPlatformMisc::FindLastLevelCacheOwner(Cpu);
+		const int64 CacheKey = CacheOwner != INDEX_NONE ? int64(CacheOwner) : -1 - int64(Package);
+
+		FProcessorTopology& Processor = OutProcessors[OutProcessors.AddUninitialized()];
+		Processor.LogicalId = Cpu;
+		Processor.CoreId = CoreKeys.AddUnique((uint64(uint32(Package)) << 32) | uint32(Core));
+		Processor.CacheDomainId = CacheKeys.AddUnique(CacheKey);
+		Processor.NodeId = NodeKeys.AddUnique(CpuNodes[Cpu]);
+	}
+
+	if (!bFoundTopology)
+	{
+		YGenericPlatformMisc::GetProcessorTopology(OutProcessors);
+		return;
+	}
+
+	OutProcessors.Sort([](const FProcessorTopology& A, const FProcessorTopology& B)
+	{
+		if (A.NodeId != B.NodeId)
+		{
+			return A.NodeId < B.NodeId;
+		}
+		if (A.CacheDomainId != B.CacheDomainId)
+		{
+			return A.CacheDomainId < B.CacheDomainId;
+		}
+		if (A.CoreId != B.CoreId)
+		{
+			return A.CoreId < B.CoreId;
+		}
+		return A.LogicalId < B.LogicalId;
+	});
+}
+
+uint32 YLinuxPlatformMisc::GetLastError()
+{
+	return (uint32)errno;
+}
+
+YString YLinuxPlatformMisc::GetCPUVendor()
+{
+#if LINUX_HAS_CPUID
+	union
+	{
+		char Buffer[12 + 1];
+		struct
+		{
+			uint32 Dw0;
+			uint32 Dw1;
+			uint32 Dw2;
+		} Dw;
+	} VendorResult;
+
+	uint32 Eax = 0;
+	__cpuid(0, Eax, VendorResult.Dw.Dw0, VendorResult.Dw.Dw2, VendorResult.Dw.Dw1);
+	VendorResult.Buffer[12] = 0;
+	return YString(ANSI_TO_TCHAR(VendorResult.Buffer));
+#else
+	return YGenericPlatformMisc::GetCPUVendor();
+#endif
+}
+
+YString YLinuxPlatformMisc::GetCPUBrand()
+{
+#if LINUX_HAS_CPUID
+	ANSICHAR BrandString[0x40] = { 0 };
+	uint32 MaxExtId = __get_cpuid_max(0x80000000, nullptr);
+	if (MaxExtId >= 0x80000004)
+	{
+		uint32* BrandWords = reinterpret_cast<uint32*>(BrandString);
+		for (uint32 Leaf = 0; Leaf < 3; ++Leaf)
+		{
+			__cpuid(0x80000002 + Leaf, BrandWords[Leaf * 4 + 0], BrandWords[Leaf * 4 + 1], BrandWords[Leaf * 4 + 2], BrandWords[Leaf * 4 + 3]);
+		}
+	}
+	return YString(ANSI_TO_TCHAR(BrandString)).Trim().TrimTrailing();
+#else
+	return YGenericPlatformMisc::GetCPUBrand();
+#endif
+}
+
+uint32 YLinuxPlatformMisc::GetCPUInfo()
+{
+#if LINUX_HAS_CPUID
+	uint32 Eax = 0, Ebx = 0, Ecx = 0, Edx = 0;
+	__cpuid(1, Eax, Ebx, Ecx, Edx);
+	return Eax;
+#else
+	return 0;
+#endif
+}
+
+void YLinuxPlatformMisc::GetOSVersions(YString& out_OSVersionLabel, YString& out_OSSubVersionLabel)
+{
+	struct utsname SystemInfo;
+	if (uname(&SystemInfo) == 0)
+	{
+		out_OSVersionLabel = UTF8_TO_TCHAR(SystemInfo.sysname);
+		out_OSSubVersionLabel = UTF8_TO_TCHAR(SystemInfo.release);
+	}
+	else
+	{
+		out_OSVersionLabel = TEXT("Linux");
+		out_OSSubVersionLabel.Empty();
+	}
+}
+
+bool YLinuxPlatformMisc::GetDiskTotalAndFreeSpace(const YString& InPath, uint64& TotalNumberOfBytes, uint64& NumberOfFreeBytes)
+{
+	struct statvfs FSStat;
+	if (statvfs(TCHAR_TO_UTF8(*InPath), &FSStat) != 0)
+	{
+		return false;
+	}
+	TotalNumberOfBytes = uint64(FSStat.f_blocks) * uint64(FSStat.f_frsize);
+	NumberOfFreeBytes = uint64(FSStat.f_bavail) * uint64(FSStat.f_frsize);
+	return true;
+}
+
+YString YLinuxPlatformMisc::GetOperatingSystemId()
+{
+	FILE* MachineIdFile = fopen("/etc/machine-id", "r");
+	if (!MachineIdFile)
+	{
+		return YString();
+	}
+	char MachineId[64] = { 0 };
+	const bool bRead = fgets(MachineId, sizeof(MachineId), MachineIdFile) != nullptr;
+	fclose(MachineIdFile);
+	return bRead ? YString(ANSI_TO_TCHAR(MachineId)).TrimTrailing().TrimTrailing() : YString();
+}
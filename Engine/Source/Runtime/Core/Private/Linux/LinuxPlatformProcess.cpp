@@ -0,0 +1,579 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "Linux/LinuxPlatformProcess.h"
+#include "HAL/PlatformMisc.h"
+#include "Misc/AssertionMacros.h"
+#include "Logging/LogMacros.h"
+#include "HAL/SolidAngleMemory.h"
+#include "Templates/SolidAngleTemplate.h"
+#include "CoreGlobals.h"
+#include "Misc/Parse.h"
+#include "Containers/StringConv.h"
+#include "Containers/SolidAngleString.h"
+#include "Misc/Paths.h"
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <pwd.h>
+#include <sched.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace LinuxPlatformProcess
+{
+	/** Splits a command line into argv-style tokens, honouring double quotes. */
+	static void TokenizeParams(const TCHAR* Params, TArray<YString>& OutArgs)
+	{
+		YString Current;
+		bool bInQuotes = false;
+		bool bHasToken = false;
+		for (const TCHAR* Ch = Params; Ch && *Ch; ++Ch)
+		{
+			if (*Ch == TEXT('"'))
+			{
+				bInQuotes = !bInQuotes;
+				bHasToken = true;
+			}
+			else if (!bInQuotes && (*Ch == TEXT(' ') || *Ch == TEXT('\t')))
+			{
+				if (bHasToken)
+				{
+					OutArgs.Add(Current);
+					Current.Empty();
+					bHasToken = false;
+				}
+			}
+			else
+			{
+				Current += *Ch;
+				bHasToken = true;
+			}
+		}
+		if (bHasToken)
+		{
+			OutArgs.Add(Current);
+		}
+	}
+
+	/** Reads everything available from Fd until EOF. */
+	static void DrainFd(int Fd, TArray<ANSICHAR>& Out)
+	{
+		ANSICHAR Buffer[4096];
+		for (;;)
+		{
+			const ssize_t BytesRead = read(Fd, Buffer, sizeof(Buffer));
+			if (BytesRead > 0)
+			{
+				Out.Append(Buffer, BytesRead);
+			}
+			else if (BytesRead < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			else
+			{
+				break;
+			}
+		}
+	}
+}
+
+void* FLinuxPlatformProcess::GetDllHandle(const TCHAR* Filename)
+{
+	check(Filename);
+	void* Handle = dlopen(TCHAR_TO_UTF8(Filename), RTLD_LAZY | RTLD_LOCAL);
+	if (!Handle)
+	{
+		UE_LOG(LogHAL, Warning, TEXT("dlopen failed: %s"), UTF8_TO_TCHAR(dlerror()));
+	}
+	return Handle;
+}
+
+void FLinuxPlatformProcess::FreeDllHandle(void* DllHandle)
+{
+	check(DllHandle);
+	dlclose(DllHandle);
+}
+
+void* FLinuxPlatformProcess::GetDllExport(void* DllHandle, const TCHAR* ProcName)
+{
+	check(DllHandle);
+	check(ProcName);
+	return dlsym(DllHandle, TCHAR_TO_ANSI(ProcName));
+}
+
+uint32 FLinuxPlatformProcess::GetCurrentProcessId()
+{
+	return getpid();
+}
+
+void FLinuxPlatformProcess::SetThreadAffinityMask(uint64 AffinityMask)
+{
+	cpu_set_t CpuSet;
+	CPU_ZERO(&CpuSet);
+	for (uint32 CpuIndex = 0; CpuIndex < 64; ++CpuIndex)
+	{
+		if (AffinityMask & (uint64(1) << CpuIndex))
+		{
+			CPU_SET(CpuIndex, &CpuSet);
+		}
+	}
+	// an all-ones mask is the default everywhere, so don't bother the scheduler with it
+	if (AffinityMask != 0xFFFFFFFFFFFFFFFFULL && CPU_COUNT(&CpuSet) > 0)
+	{
+		pthread_setaffinity_np(pthread_self(), sizeof(CpuSet), &CpuSet);
+	}
+}
+
+const TCHAR* FLinuxPlatformProcess::BaseDir()
+{
+	static TCHAR Result[PLATFORM_MAX_FILEPATH_LENGTH] = TEXT("");
+	if (!Result[0])
+	{
+		char SelfPath[PLATFORM_MAX_FILEPATH_LENGTH] = { 0 };
+		if (readlink("/proc/self/exe", SelfPath, ARRAY_COUNT(SelfPath) - 1) == -1)
+		{
+			int ErrNo = errno;
+			UE_LOG(LogHAL, Fatal, TEXT("readlink() failed with errno = %d (%s)"), ErrNo, UTF8_TO_TCHAR(strerror(ErrNo)));
+			return Result;
+		}
+
+		YString TempResult(UTF8_TO_TCHAR(SelfPath));
+		int32 LastSlash = INDEX_NONE;
+		if (TempResult.FindLastChar(TEXT('/'), LastSlash))
+		{
+			TempResult = TempResult.Left(LastSlash + 1);
+		}
+		FCString::Strncpy(Result, *TempResult, ARRAY_COUNT(Result));
+	}
+	return Result;
+}
+
+const TCHAR* FLinuxPlatformProcess::UserDir()
+{
+	static TCHAR Result[PLATFORM_MAX_FILEPATH_LENGTH] = TEXT("");
+	if (!Result[0])
+	{
+		YString Home;
+		if (const char* XdgDocuments = getenv("XDG_DOCUMENTS_DIR"))
+		{
+			Home = UTF8_TO_TCHAR(XdgDocuments);
+		}
+		else
+		{
+			Home = YString(UserSettingsDir()) / TEXT("Documents");
+		}
+		Home /= TEXT("");
+		FCString::Strncpy(Result, *Home, ARRAY_COUNT(Result));
+	}
+	return Result;
+}
+
+const TCHAR* FLinuxPlatformProcess::UserSettingsDir()
+{
+	static TCHAR Result[PLATFORM_MAX_FILEPATH_LENGTH] = TEXT("");
+	if (!Result[0])
+	{
+		const char* Home = getenv("HOME");
+		if (!Home)
+		{
+			struct passwd* UserInfo = getpwuid(geteuid());
+			Home = (UserInfo && UserInfo->pw_dir) ? UserInfo->pw_dir : "/tmp";
+		}
+		YString HomeDir(UTF8_TO_TCHAR(Home));
+		HomeDir /= TEXT("");
+		FCString::Strncpy(Result, *HomeDir, ARRAY_COUNT(Result));
+	}
+	return Result;
+}
+
+const TCHAR* FLinuxPlatformProcess::UserTempDir()
+{
+	static TCHAR Result[PLATFORM_MAX_FILEPATH_LENGTH] = TEXT("");
+	if (!Result[0])
+	{
+		const char* TmpDir = getenv("TMPDIR");
+		YString TempDir(UTF8_TO_TCHAR(TmpDir ? TmpDir : "/tmp"));
+		TempDir /= TEXT("");
+		FCString::Strncpy(Result, *TempDir, ARRAY_COUNT(Result));
+	}
+	return Result;
+}
+
+const TCHAR* FLinuxPlatformProcess::ApplicationSettingsDir()
+{
+	static TCHAR Result[PLATFORM_MAX_FILEPATH_LENGTH] = TEXT("");
+	if (!Result[0])
+	{
+		YString SettingsDir = YString(UserSettingsDir()) / TEXT(".config/Epic/");
+		FCString::Strncpy(Result, *SettingsDir, ARRAY_COUNT(Result));
+	}
+	return Result;
+}
+
+const TCHAR* FLinuxPlatformProcess::ComputerName()
+{
+	static TCHAR Result[256] = TEXT("");
+	if (!Result[0])
+	{
+		char HostName[256] = { 0 };
+		if (gethostname(HostName, ARRAY_COUNT(HostName) - 1) == 0)
+		{
+			FCString::Strncpy(Result, UTF8_TO_TCHAR(HostName), ARRAY_COUNT(Result));
+		}
+		else
+		{
+			FCString::Strcpy(Result, TEXT("Linux Computer"));
+		}
+	}
+	return Result;
+}
+
+const TCHAR* FLinuxPlatformProcess::UserName(bool bOnlyAlphaNumeric)
+{
+	static TCHAR Name[256] = TEXT("");
+	static TCHAR AlphaNumericName[256] = TEXT("");
+	if (!Name[0])
+	{
+		struct passwd* UserInfo = getpwuid(geteuid());
+		const char* LoginName = (UserInfo && UserInfo->pw_name) ? UserInfo->pw_name : "Linux User";
+		FCString::Strncpy(Name, UTF8_TO_TCHAR(LoginName), ARRAY_COUNT(Name));
+
+		TCHAR* Out = AlphaNumericName;
+		for (const TCHAR* In = Name; *In; ++In)
+		{
+			if (FChar::IsAlnum(*In))
+			{
+				*Out++ = *In;
+			}
+		}
+		*Out = 0;
+	}
+	return bOnlyAlphaNumeric ? AlphaNumericName : Name;
+}
+
+void FLinuxPlatformProcess::SetCurrentWorkingDirectoryToBaseDir()
+{
+	YPlatformMisc::CacheLaunchDir();
+	if (chdir(TCHAR_TO_UTF8(BaseDir())) != 0)
+	{
+		int ErrNo = errno;
+		UE_LOG(LogHAL, Warning, TEXT("chdir() to '%s' failed with errno = %d"), BaseDir(), ErrNo);
+	}
+}
+
+YString FLinuxPlatformProcess::GetCurrentWorkingDirectory()
+{
+	char CurrentDir[PLATFORM_MAX_FILEPATH_LENGTH] = { 0 };
+	if (getcwd(CurrentDir, ARRAY_COUNT(CurrentDir)) == nullptr)
+	{
+		return YString();
+	}
+	return YString(UTF8_TO_TCHAR(CurrentDir));
+}
+
+const TCHAR* FLinuxPlatformProcess::ExecutableName(bool bRemoveExtension)
+{
+	static TCHAR Result[PLATFORM_MAX_FILEPATH_LENGTH] = TEXT("");
+	if (!Result[0])
+	{
+		char SelfPath[PLATFORM_MAX_FILEPATH_LENGTH] = { 0 };
+		if (readlink("/proc/self/exe", SelfPath, ARRAY_COUNT(SelfPath) - 1) == -1)
+		{
+			return Result;
+		}
+		const char* LastSlash = strrchr(SelfPath, '/');
+		FCString::Strncpy(Result, UTF8_TO_TCHAR(LastSlash ? LastSlash + 1 : SelfPath), ARRAY_COUNT(Result));
+	}
+	// executables have no extension on Linux, so there is nothing to remove
+	return Result;
+}
+
+const TCHAR* FLinuxPlatformProcess::GetModulePrefix()
+{
+	return TEXT("lib");
+}
+
+const TCHAR* FLinuxPlatformProcess::GetModuleExtension()
+{
+	return TEXT("so");
+}
+
+const TCHAR* FLinuxPlatformProcess::GetBinariesSubdirectory()
+{
+	return TEXT("Linux");
+}
+
+FProcHandle FLinuxPlatformProcess::CreateProc(const TCHAR* URL, const TCHAR* Parms, bool bLaunchDetached, bool bLaunchHidden, bool bLaunchReallyHidden, uint32* OutProcessID, int32 PriorityModifier, const TCHAR* OptionalWorkingDirectory, void* PipeWriteChild, void * PipeReadChild)
+{
+	check(URL);
+
+	TArray<YString> Args;
+	Args.Add(URL);
+	LinuxPlatformProcess::TokenizeParams(Parms, Args);
+
+	// keep the converted strings alive until posix_spawn has copied them
+	TArray<TArray<ANSICHAR>> ArgStorage;
+	TArray<char*> Argv;
+	ArgStorage.SetNum(Args.Num());
+	for (int32 ArgIndex = 0; ArgIndex < Args.Num(); ++ArgIndex)
+	{
+		FTCHARToUTF8 Converted(*Args[ArgIndex]);
+		ArgStorage[ArgIndex].Append(Converted.Get(), Converted.Length() + 1);
+		Argv.Add(ArgStorage[ArgIndex].GetData());
+	}
+	Argv.Add(nullptr);
+
+	posix_spawn_file_actions_t FileActions;
+	posix_spawn_file_actions_init(&FileActions);
+	if (PipeWriteChild)
+	{
+		const int WriteFd = (int)(PTRINT)PipeWriteChild - 1;
+		posix_spawn_file_actions_adddup2(&FileActions, WriteFd, STDOUT_FILENO);
+		posix_spawn_file_actions_adddup2(&FileActions, WriteFd, STDERR_FILENO);
+	}
+	if (PipeReadChild)
+	{
+		const int ReadFd = (int)(PTRINT)PipeReadChild - 1;
+		posix_spawn_file_actions_adddup2(&FileActions, ReadFd, STDIN_FILENO);
+	}
+	if (OptionalWorkingDirectory && *OptionalWorkingDirectory)
+	{
+		UE_LOG(LogHAL, Warning, TEXT("CreateProc: working directory '%s' is ignored on this platform"), OptionalWorkingDirectory);
+	}
+
+	posix_spawnattr_t SpawnAttr;
+	posix_spawnattr_init(&SpawnAttr);
+	if (bLaunchDetached)
+	{
+		posix_spawnattr_setflags(&SpawnAttr, POSIX_SPAWN_SETSID);
+	}
+
+	pid_t ChildPid = -1;
+	const int SpawnResult = posix_spawn(&ChildPid, Argv[0], &FileActions, &SpawnAttr, Argv.GetData(), environ);
+	posix_spawnattr_destroy(&SpawnAttr);
+	posix_spawn_file_actions_destroy(&FileActions);
+
+	if (SpawnResult != 0)
+	{
+		UE_LOG(LogHAL, Warning, TEXT("CreateProc failed: posix_spawn('%s') returned %d (%s)"), URL, SpawnResult, UTF8_TO_TCHAR(strerror(SpawnResult)));
+		if (OutProcessID)
+		{
+			*OutProcessID = 0;
+		}
+		return FProcHandle();
+	}
+
+	if (PriorityModifier != 0)
+	{
+		// map the -2..2 scale onto nice values, higher modifier means higher priority
+		setpriority(PRIO_PROCESS, ChildPid, -5 * YMath::Clamp(PriorityModifier, -2, 2));
+	}
+
+	if (OutProcessID)
+	{
+		*OutProcessID = ChildPid;
+	}
+	return FProcHandle(ChildPid);
+}
+
+bool FLinuxPlatformProcess::IsProcRunning(FProcHandle & ProcessHandle)
+{
+	if (!ProcessHandle.IsValid() || ProcessHandle.bHasBeenWaitedFor)
+	{
+		return false;
+	}
+
+	int Status = 0;
+	const pid_t WaitResult = waitpid(ProcessHandle.Get(), &Status, WNOHANG);
+	if (WaitResult == 0)
+	{
+		return true;
+	}
+	if (WaitResult == ProcessHandle.Get())
+	{
+		ProcessHandle.bIsRunning = false;
+		ProcessHandle.bHasBeenWaitedFor = true;
+		ProcessHandle.ReturnCode = WIFEXITED(Status) ? WEXITSTATUS(Status) : -1;
+	}
+	return false;
+}
+
+void FLinuxPlatformProcess::WaitForProc(FProcHandle & ProcessHandle)
+{
+	if (!ProcessHandle.IsValid() || ProcessHandle.bHasBeenWaitedFor)
+	{
+		return;
+	}
+
+	int Status = 0;
+	pid_t WaitResult;
+	do
+	{
+		WaitResult = waitpid(ProcessHandle.Get(), &Status, 0);
+	}
+	while (WaitResult == -1 && errno == EINTR);
+
+	ProcessHandle.bIsRunning = false;
+	ProcessHandle.bHasBeenWaitedFor = true;
+	ProcessHandle.ReturnCode = (WaitResult != -1 && WIFEXITED(Status)) ? WEXITSTATUS(Status) : -1;
+}
+
+void FLinuxPlatformProcess::CloseProc(FProcHandle & ProcessHandle)
+{
+	// reap the child if it has already exited so it does not linger as a zombie
+	IsProcRunning(ProcessHandle);
+	ProcessHandle.Reset();
+}
+
+void FLinuxPlatformProcess::TerminateProc(FProcHandle & ProcessHandle, bool KillTree)
+{
+	if (!ProcessHandle.IsValid() || ProcessHandle.bHasBeenWaitedFor)
+	{
+		return;
+	}
+	if (KillTree)
+	{
+		UE_LOG(LogHAL, Verbose, TEXT("TerminateProc: KillTree is not supported, only the process itself is killed"));
+	}
+	kill(ProcessHandle.Get(), SIGTERM);
+	WaitForProc(ProcessHandle);
+}
+
+bool FLinuxPlatformProcess::GetProcReturnCode(FProcHandle & ProcHandle, int32* ReturnCode)
+{
+	if (IsProcRunning(ProcHandle) || !ProcHandle.bHasBeenWaitedFor)
+	{
+		return false;
+	}
+	if (ReturnCode)
+	{
+		*ReturnCode = ProcHandle.ReturnCode;
+	}
+	return true;
+}
+
+bool FLinuxPlatformProcess::IsApplicationRunning(uint32 ProcessId)
+{
+	return kill((pid_t)ProcessId, 0) == 0 || errno == EPERM;
+}
+
+YString FLinuxPlatformProcess::GetApplicationName(uint32 ProcessId)
+{
+	char ExePath[64];
+	snprintf(ExePath, sizeof(ExePath), "/proc/%u/exe", ProcessId);
+
+	char ProcessPath[PLATFORM_MAX_FILEPATH_LENGTH] = { 0 };
+	if (readlink(ExePath, ProcessPath, ARRAY_COUNT(ProcessPath) - 1) == -1)
+	{
+		return YString();
+	}
+	return YString(UTF8_TO_TCHAR(ProcessPath));
+}
+
+bool FLinuxPlatformProcess::GetApplicationMemoryUsage(uint32 ProcessId, SIZE_T* OutMemoryUsage)
+{
+	char StatmPath[64];
+	snprintf(StatmPath, sizeof(StatmPath), "/proc/%u/statm", ProcessId);
+
+	FILE* StatmFile = fopen(StatmPath, "r");
+	if (!StatmFile)
+	{
+		return false;
+	}
+	unsigned long long TotalPages = 0, ResidentPages = 0;
+	const bool bParsed = fscanf(StatmFile, "%llu %llu", &TotalPages, &ResidentPages) == 2;
+	fclose(StatmFile);
+
+	if (bParsed && OutMemoryUsage)
+	{
+		*OutMemoryUsage = (SIZE_T)ResidentPages * (SIZE_T)sysconf(_SC_PAGESIZE);
+	}
+	return bParsed;
+}
+
+bool FLinuxPlatformProcess::IsThisApplicationForeground()
+{
+	// there is no portable notion of a foreground application without a windowing system
+	return true;
+}
+
+bool FLinuxPlatformProcess::ExecProcess(const TCHAR* URL, const TCHAR* Params, int32* OutReturnCode, YString* OutStdOut, YString* OutStdErr)
+{
+	int StdOutPipe[2] = { -1, -1 };
+	int StdErrPipe[2] = { -1, -1 };
+	if (pipe2(StdOutPipe, O_CLOEXEC) != 0 || pipe2(StdErrPipe, O_CLOEXEC) != 0)
+	{
+		UE_LOG(LogHAL, Warning, TEXT("ExecProcess: unable to create pipes for '%s'"), URL);
+		return false;
+	}
+
+	TArray<YString> Args;
+	Args.Add(URL);
+	LinuxPlatformProcess::TokenizeParams(Params, Args);
+
+	TArray<TArray<ANSICHAR>> ArgStorage;
+	TArray<char*> Argv;
+	ArgStorage.SetNum(Args.Num());
+	for (int32 ArgIndex = 0; ArgIndex < Args.Num(); ++ArgIndex)
+	{
+		FTCHARToUTF8 Converted(*Args[ArgIndex]);
+		ArgStorage[ArgIndex].Append(Converted.Get(), Converted.Length() + 1);
+		Argv.Add(ArgStorage[ArgIndex].GetData());
+	}
+	Argv.Add(nullptr);
+
+	posix_spawn_file_actions_t FileActions;
+	posix_spawn_file_actions_init(&FileActions);
+	posix_spawn_file_actions_adddup2(&FileActions, StdOutPipe[1], STDOUT_FILENO);
+	posix_spawn_file_actions_adddup2(&FileActions, StdErrPipe[1], STDERR_FILENO);
+
+	pid_t ChildPid = -1;
+	const int SpawnResult = posix_spawnp(&ChildPid, Argv[0], &FileActions, nullptr, Argv.GetData(), environ);
+	posix_spawn_file_actions_destroy(&FileActions);
+	close(StdOutPipe[1]);
+	close(StdErrPipe[1]);
+
+	if (SpawnResult != 0)
+	{
+		close(StdOutPipe[0]);
+		close(StdErrPipe[0]);
+		return false;
+	}
+
+	// stderr is drained after stdout; children producing more than a pipe buffer
+	// of stderr before closing stdout would block, which is acceptable for the tools we run
+	TArray<ANSICHAR> StdOutBytes, StdErrBytes;
+	LinuxPlatformProcess::DrainFd(StdOutPipe[0], StdOutBytes);
+	LinuxPlatformProcess::DrainFd(StdErrPipe[0], StdErrBytes);
+	close(StdOutPipe[0]);
+	close(StdErrPipe[0]);
+
+	FProcHandle Handle(ChildPid);
+	WaitForProc(Handle);
+
+	if (OutStdOut)
+	{
+		StdOutBytes.Add(0);
+		*OutStdOut = UTF8_TO_TCHAR(StdOutBytes.GetData());
+	}
+	if (OutStdErr)
+	{
+		StdErrBytes.Add(0);
+		*OutStdErr = UTF8_TO_TCHAR(StdErrBytes.GetData());
+	}
+	if (OutReturnCode)
+	{
+		*OutReturnCode = Handle.ReturnCode;
+	}
+	return true;
+}
@@ -0,0 +1,56 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "Linux/LinuxPlatformStackWalk.h"
+#include "HAL/PlatformStackWalk.h"
+#include "HAL/SolidAngleMemory.h"
+#include "Math/SolidAngleMathUtility.h"
+#include "Containers/StringConv.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <stdlib.h>
+
+void FLinuxPlatformStackWalk::ProgramCounterToSymbolInfo(uint64 ProgramCounter, FProgramCounterSymbolInfo& out_SymbolInfo)
+{
+	out_SymbolInfo.ProgramCounter = ProgramCounter;
+
+	Dl_info SymbolInfo;
+	if (dladdr(reinterpret_cast<void*>(ProgramCounter), &SymbolInfo) == 0)
+	{
+		return;
+	}
+
+	if (SymbolInfo.dli_fname)
+	{
+		const char* ModuleName = strrchr(SymbolInfo.dli_fname, '/');
+		FCStringAnsi::Strncpy(out_SymbolInfo.ModuleName, ModuleName ? ModuleName + 1 : SymbolInfo.dli_fname, FProgramCounterSymbolInfo::MAX_NAME_LENGHT);
+		out_SymbolInfo.OffsetInModule = ProgramCounter - reinterpret_cast<uint64>(SymbolInfo.dli_fbase);
+	}
+
+	if (SymbolInfo.dli_sname)
+	{
+		int DemangleStatus = 0;
+		char* Demangled = abi::__cxa_demangle(SymbolInfo.dli_sname, nullptr, nullptr, &DemangleStatus);
+		FCStringAnsi::Strncpy(out_SymbolInfo.FunctionName, (DemangleStatus == 0 && Demangled) ? Demangled : SymbolInfo.dli_sname, FProgramCounterSymbolInfo::MAX_NAME_LENGHT);
+		// __cxa_demangle allocates with malloc
+		free(Demangled);
+		out_SymbolInfo.SymbolDisplacement = (int32)(ProgramCounter - reinterpret_cast<uint64>(SymbolInfo.dli_saddr));
+	}
+}
+
+void FLinuxPlatformStackWalk::CaptureStackBackTrace(uint64* BackTrace, uint32 MaxDepth, void* Context)
+{
+	if (BackTrace == nullptr || MaxDepth == 0)
+	{
+		return;
+	}
+
+	// backtrace() fills an array of void*, which has the same size as uint64 on 64-bit targets
+	static_assert(sizeof(void*) == sizeof(uint64), "CaptureStackBackTrace assumes 64-bit pointers");
+	const int32 Depth = backtrace(reinterpret_cast<void**>(BackTrace), (int32)MaxDepth);
+	for (uint32 Index = YMath::Max(Depth, 0); Index < MaxDepth; ++Index)
+	{
+		BackTrace[Index] = 0;
+	}
+}
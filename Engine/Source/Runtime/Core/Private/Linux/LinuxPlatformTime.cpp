@@ -0,0 +1,69 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "Linux/LinuxPlatformTime.h"
+#include "Misc/AssertionMacros.h"
+#include "Containers/Ticker.h"
+#include "HAL/PlatformMisc.h"
+
+#include <sys/resource.h>
+
+float FLinuxPlatformTime::CPUTimePctRelative = 0.0f;
+
+
+double FLinuxPlatformTime::InitTiming(void)
+{
+	struct timespec Resolution;
+	verify( clock_getres(CLOCK_MONOTONIC, &Resolution) == 0 );
+
+	// Cycles() counts microseconds and Cycles64() counts 100ns ticks, see LinuxPlatformTime.h
+	SecondsPerCycle = 1.0 / 1000000.0;
+	SecondsPerCycle64 = 1.0 / 10000000.0;
+
+	// Polling more often than this gives noisy results from getrusage(),
+	// but it should be enough for longterm CPU usage monitoring.
+	static const float PollingInterval = 1.0f / 4.0f;
+
+	// Register a ticker delegate for updating the CPU utilization data.
+	FTicker::GetCoreTicker().AddTicker( FTickerDelegate::CreateStatic( &FPlatformTime::UpdateCPUTime ), PollingInterval );
+
+	return FPlatformTime::Seconds();
+}
+
+
+bool FLinuxPlatformTime::UpdateCPUTime( float /*DeltaTime*/ )
+{
+	static double LastTotalProcessTime = 0.0;
+	static double LastTotalUserAndKernelTime = 0.0;
+
+	struct rusage Usage;
+	if (getrusage(RUSAGE_SELF, &Usage) != 0)
+	{
+		return true;
+	}
+
+	const double CurrentTotalUserAndKernelTime =
+		double(Usage.ru_utime.tv_sec) + double(Usage.ru_utime.tv_usec) / 1e6 +
+		double(Usage.ru_stime.tv_sec) + double(Usage.ru_stime.tv_usec) / 1e6;
+	const double CurrentTotalProcessTime = FPlatformTime::Seconds();
+
+	const double IntervalProcessTime = CurrentTotalProcessTime - LastTotalProcessTime;
+	const double IntervalUserAndKernelTime = CurrentTotalUserAndKernelTime - LastTotalUserAndKernelTime;
+
+	// IntervalUserAndKernelTime == 0.0 means that the OS hasn't updated the data yet, 
+	// so don't update to avoid oscillating between 0 and calculated value.
+	if( IntervalUserAndKernelTime > 0.0 && LastTotalProcessTime > 0.0 )
+	{
+		CPUTimePctRelative = IntervalUserAndKernelTime/IntervalProcessTime * 100.0f;
+	}
+
+	LastTotalProcessTime = CurrentTotalProcessTime;
+	LastTotalUserAndKernelTime = CurrentTotalUserAndKernelTime;
+
+	return true;
+}
+
+
+FCPUTime FLinuxPlatformTime::GetCPUTime()
+{
+	return FCPUTime( CPUTimePctRelative / (float)YPlatformMisc::NumberOfCoresIncludingHyperthreads(), CPUTimePctRelative );
+}
@@ -0,0 +1,91 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Readers for the one line files under /sys that describe cpus, caches and NUMA nodes. */
+namespace LinuxSysfs
+{
+	/** Reads the first line of a sysfs file, false if it can't be opened. */
+	inline bool ReadFirstLine(const ANSICHAR* FileName, ANSICHAR* OutLine, int32 OutLineSize)
+	{
+		FILE* File = fopen(FileName, "r");
+		if (!File)
+		{
+			return false;
+		}
+		const bool bRead = fgets(OutLine, OutLineSize, File) != nullptr;
+		fclose(File);
+		return bRead;
+	}
+
+	/** Reads the number a sysfs file starts with, false if there is none. */
+	inline bool ReadInt(const ANSICHAR* FileName, int32& OutValue)
+	{
+		ANSICHAR Line[64];
+		return ReadFirstLine(FileName, Line, sizeof(Line)) && sscanf(Line, "%d", &OutValue) == 1;
+	}
+
+	/** Calls Visit for every index in a sysfs list such as "0-3,8-11". */
+	template <typename VisitorType>
+	void ForEachListEntry(const ANSICHAR* List, VisitorType Visit)
+	{
+		while (*List)
+		{
+			ANSICHAR* End = nullptr;
+			const long First = strtol(List, &End, 10);
+			if (End == List || First < 0)
+			{
+				break;
+			}
+			long Last = First;
+			if (*End == '-')
+			{
+				List = End + 1;
+				Last = strtol(List, &End, 10);
+			}
+			for (long Index = First; Index <= Last; ++Index)
+			{
+				Visit(Index);
+			}
+			if (*End != ',')
+			{
+				break;
+			}
+			List = End + 1;
+		}
+	}
+
+	/**
+	 * Calls Visit for every online NUMA node. Node numbers can have holes, and nodes that aren't online have no cpus.
+	 *
+	 * @return false if sysfs doesn't list the nodes, a kernel without NUMA support
+	 */
+	template <typename VisitorType>
+	bool ForEachOnlineNode(VisitorType Visit)
+	{
+		ANSICHAR Nodes[256];
+		if (!ReadFirstLine("/sys/devices/system/node/online", Nodes, sizeof(Nodes)))
+		{
+			return false;
+		}
+		ForEachListEntry(Nodes, [&Visit](long Node) { Visit(int32(Node)); });
+		return true;
+	}
+
+	/** Calls Visit for every cpu of a NUMA node, none for a node without cpus. */
+	template <typename VisitorType>
+	void ForEachCpuOfNode(int32 Node, VisitorType Visit)
+	{
+		ANSICHAR FileName[64];
+		ANSICHAR Cpus[4096];
+		snprintf(FileName, sizeof(FileName), "/sys/devices/system/node/node%d/cpulist", Node);
+		if (ReadFirstLine(FileName, Cpus, sizeof(Cpus)))
+		{
+			ForEachListEntry(Cpus, [&Visit](long Cpu) { Visit(int32(Cpu)); });
+		}
+	}
+}
@@ -1961,7 +1961,7 @@ YVector4 YMath::ComputeBaryCentric3D(const YVector& Point, const YVector& A, con
 	//The point V can be expressed as Ax=v where x is the vector containing the weights {w1...wn}
 	//Solve for x by multiplying both sides by AInv   (AInv * A)x = AInv * v ==> x = AInv * v
 	const YMatrix InvSolvMat = SolvMat.Inverse();
-	const YPlane BaryCoords = InvSolvMat.TransformVector(V);	 
+	const YPlane BaryCoords = YVector4(InvSolvMat.TransformVector(V), 0.0f);	 
 
 	//Reorder the weights to be a, b, c, d
 	return YVector4(1.0f - BaryCoords.X - BaryCoords.Y - BaryCoords.Z, BaryCoords.X, BaryCoords.Y, BaryCoords.Z);
@@ -1,6 +1,7 @@
 // Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
 
 #include "Misc/ConfigCacheIni.h"
+#include "Containers/InlineString.h"
 #include "Misc/DateTime.h"
 #include "Misc/MessageDialog.h"
 #include "HAL/FileManager.h"
@@ -361,6 +362,11 @@ void FConfigFile::CombineFromBuffer(const YString& Buffer)
 	const TCHAR* Ptr = *Buffer;
 	FConfigSection* CurrentSection = nullptr;
 	YString CurrentSectionName;
+
+	// these are reused for every line, so they only allocate for the first line or value that does not fit inline
+	YInlineString TheLine;
+	YInlineString QuotedValue;
+
 	bool Done = false;
 	while (!Done)
 	{
@@ -371,7 +377,6 @@ void FConfigFile::CombineFromBuffer(const YString& Buffer)
 		}
 
 		// read the next line
-		YString TheLine;
 		int32 LinesConsumed = 0;
 		FParse::LineExtended(&Ptr, TheLine, LinesConsumed, false);
 		if (Ptr == nullptr || *Ptr == 0)
@@ -465,39 +470,41 @@ void FConfigFile::CombineFromBuffer(const YString& Buffer)
 				if (*Value == '\"')
 				{
 					Value++;
+					QuotedValue.Reset();
 					//epic moelfke: fixed handling of escaped characters in quoted string
 					while (*Value && *Value != '\"')
 					{
 						if (*Value != '\\') // unescaped character
 						{
-							ProcessedValue += *Value++;
+							QuotedValue += *Value++;
 						}
 						else if (*++Value == '\\') // escaped forward slash "\\"
 						{
-							ProcessedValue += '\\';
+							QuotedValue += '\\';
 							Value++;
 						}
 						else if (*Value == '\"') // escaped double quote "\""
 						{
-							ProcessedValue += '\"';
+							QuotedValue += '\"';
 							Value++;
 						}
 						else if (*Value == TEXT('n'))
 						{
-							ProcessedValue += TEXT('\n');
+							QuotedValue += TEXT('\n');
 							Value++;
 						}
 						else if (*Value == TEXT('u') && Value[1] && Value[2] && Value[3] && Value[4])	// \uXXXX - UNICODE code point
 						{
-							ProcessedValue += (TCHAR)(FParse::HexDigit(Value[1])*(1 << 12) + FParse::HexDigit(Value[2])*(1 << 8) + FParse::HexDigit(Value[3])*(1 << 4) + FParse::HexDigit(Value[4]));
+							QuotedValue += (TCHAR)(FParse::HexDigit(Value[1])*(1 << 12) + FParse::HexDigit(Value[2])*(1 << 8) + FParse::HexDigit(Value[3])*(1 << 4) + FParse::HexDigit(Value[4]));
 							Value += 5;
 						}
 						else if (Value[1]) // some other escape sequence, assume it's a hex character value
 						{
-							ProcessedValue += (TCHAR)(FParse::HexDigit(Value[0]) * 16 + FParse::HexDigit(Value[1]));
+							QuotedValue += (TCHAR)(FParse::HexDigit(Value[0]) * 16 + FParse::HexDigit(Value[1]));
 							Value += 2;
 						}
 					}
+					ProcessedValue = QuotedValue.ToString();
 				}
 				else
 				{
@@ -571,6 +578,12 @@ void FConfigFile::ProcessInputFileContents(const YString& Contents)
 {
 	const TCHAR* Ptr = Contents.Len() > 0 ? *Contents : nullptr;
 	FConfigSection* CurrentSection = nullptr;
+
+	// these are reused for every line, so they only allocate for the first line or value that does not fit inline
+	YInlineString TheLine;
+	YInlineString PreprocessedValue;
+	YInlineString ProcessedValue;
+
 	bool Done = false;
 	while (!Done && Ptr != nullptr)
 	{
@@ -580,7 +593,6 @@ void FConfigFile::ProcessInputFileContents(const YString& Contents)
 			Ptr++;
 		}
 		// read the next line
-		YString TheLine;
 		int32 LinesConsumed = 0;
 		FParse::LineExtended(&Ptr, TheLine, LinesConsumed, false);
 		if (Ptr == nullptr || *Ptr == 0)
@@ -642,10 +654,30 @@ void FConfigFile::ProcessInputFileContents(const YString& Contents)
 				// If this line is delimited by quotes
 				if (*Value == '\"')
 				{
-					YString PreprocessedValue = YString(Value).TrimQuotes().ReplaceQuotesWithEscapedQuotes();
+					// the same as YString(Value).TrimQuotes().ReplaceQuotesWithEscapedQuotes(), without the temporary strings
+					const int32 ValueLen = FCString::Strlen(Value);
+					const TCHAR* ValueEnd = Value + ValueLen - (ValueLen > 1 && Value[ValueLen - 1] == '\"' ? 1 : 0);
+					bool bEscaped = false;
+					PreprocessedValue.Reset();
+					for (const TCHAR* Char = Value + 1; Char < ValueEnd; ++Char)
+					{
+						if (bEscaped)
+						{
+							bEscaped = false;
+						}
+						else if (*Char == '\\')
+						{
+							bEscaped = true;
+						}
+						else if (*Char == '\"')
+						{
+							PreprocessedValue += TCHAR('\\');
+						}
+						PreprocessedValue += *Char;
+					}
 					const TCHAR* NewValue = *PreprocessedValue;
 
-					YString ProcessedValue;
+					ProcessedValue.Reset();
 					//epic moelfke: fixed handling of escaped characters in quoted string
 					while (*NewValue && *NewValue != '\"')
 					{
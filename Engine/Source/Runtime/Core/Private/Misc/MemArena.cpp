@@ -0,0 +1,188 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/MemArena.h"
+#include "HAL/PlatformAtomics.h"
+#include "Stats/Stats.h"
+
+DECLARE_MEMORY_STAT(TEXT("MemArena Large Chunks"), STAT_MemArenaLargeChunks, STATGROUP_Memory);
+
+uint32 FMemArena::CurrentTlsSlot = YPlatformTLS::AllocTlsSlot();
+
+FMemArena::FMemArena(int32 InMaxChunkSize)
+	: Top(nullptr)
+	, End(nullptr)
+	, TopChunk(nullptr)
+	, SpareChunks(nullptr)
+	, UsedBytesBelowTopChunk(0)
+	, ReservedBytes(0)
+	, HighWaterMark(0)
+	, MaxChunkSize(AlignArbitrary<int32>(YMath::Max<int32>(InMaxChunkSize, FPageAllocator::PageSize), FPageAllocator::PageSize))
+	, LastChunkSize(0)
+	, TopMark(nullptr)
+	, NumMarks(0)
+	, OwnerThreadId(int32(YPlatformTLS::GetCurrentThreadId()))
+{
+}
+
+FMemArena::~FMemArena()
+{
+	check(GIsCriticalError || !NumMarks);
+	check(OwnerThreadId == 0 || IsOwnedByCurrentThread());
+
+	Rewind(nullptr, nullptr, 0);
+	Trim();
+}
+
+void FMemArena::Reset()
+{
+	check(IsOwnedByCurrentThread());
+	check(!NumMarks);
+
+	Rewind(nullptr, nullptr, 0);
+}
+
+void FMemArena::Trim()
+{
+	while (SpareChunks)
+	{
+		FChunk* Chunk = SpareChunks;
+		SpareChunks = Chunk->Next;
+		FreeChunk(Chunk);
+	}
+	// The next chunk starts small again
+	LastChunkSize = TopChunk ? TopChunk->DataSize + (int32)sizeof(FChunk) : 0;
+}
+
+bool FMemArena::ContainsPointer(const void* Pointer) const
+{
+	const uint8* Ptr = (const uint8*)Pointer;
+	for (const FChunk* Chunk = TopChunk; Chunk; Chunk = Chunk->Next)
+	{
+		if (Ptr >= Chunk->Data() && Ptr < Chunk->Data() + Chunk->DataSize)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FMemArena::RaiseMarksAbove(const void* Ptr)
+{
+	check(IsOwnedByCurrentThread());
+
+	// marks are nested, so once Ptr is above one it is above all the ones below it
+	for (FMemArenaMark* Mark = TopMark; Mark && IsBelowMark(Ptr, *Mark); Mark = Mark->NextTopmostMark)
+	{
+		Mark->Top                         = Top;
+		Mark->SavedChunk                  = TopChunk;
+		Mark->SavedUsedBytesBelowTopChunk = UsedBytesBelowTopChunk;
+	}
+}
+
+bool FMemArena::IsBelowMark(const void* Pointer, const FMemArenaMark& Mark) const
+{
+	const uint8* Ptr = (const uint8*)Pointer;
+	for (const FChunk* Chunk = Mark.SavedChunk; Chunk; Chunk = Chunk->Next)
+	{
+		if (Ptr >= Chunk->Data() && Ptr < Chunk->Data() + Chunk->DataSize)
+		{
+			return Chunk != Mark.SavedChunk || Ptr < Mark.Top;
+		}
+	}
+	return false;
+}
+
+void FMemArena::ReleaseOwnership()
+{
+	checkf(IsOwnedByCurrentThread(), TEXT("Only the owner of an arena can release it"));
+	checkf(!NumMarks, TEXT("Arena released with %d marks outstanding"), NumMarks);
+
+	// The exchange is a full barrier, so the next owner sees everything written to the arena
+	FPlatformAtomics::InterlockedExchange(&OwnerThreadId, 0);
+}
+
+void FMemArena::AcquireOwnership()
+{
+	const int32 ThreadId = int32(YPlatformTLS::GetCurrentThreadId());
+	const int32 PreviousOwner = FPlatformAtomics::InterlockedCompareExchange(&OwnerThreadId, ThreadId, 0);
+	checkf(PreviousOwner == 0, TEXT("Arena acquired while still owned by thread %u"), uint32(PreviousOwner));
+}
+
+void FMemArena::AllocateNewChunk(int32 MinSize)
+{
+	if (TopChunk)
+	{
+		UsedBytesBelowTopChunk += Top - TopChunk->Data();
+	}
+
+	// Reuse the first spare that is large enough
+	FChunk* Chunk = nullptr;
+	for (FChunk** Link = &SpareChunks; *Link; Link = &(*Link)->Next)
+	{
+		if ((*Link)->DataSize >= MinSize)
+		{
+			Chunk = *Link;
+			*Link = Chunk->Next;
+			break;
+		}
+	}
+
+	if (!Chunk)
+	{
+		// Double the chunk size every time, up to MaxChunkSize
+		const int32 TotalSize = MinSize + (int32)sizeof(FChunk);
+		const int32 GrownSize = YMath::Min(LastChunkSize * 2, MaxChunkSize);
+		const int32 AllocSize = AlignArbitrary<int32>(YMath::Max(TotalSize, GrownSize), FPageAllocator::PageSize);
+		if (AllocSize == FPageAllocator::PageSize)
+		{
+			Chunk = (FChunk*)FPageAllocator::Alloc();
+		}
+		else
+		{
+			Chunk = (FChunk*)YMemory::Malloc(AllocSize);
+			INC_MEMORY_STAT_BY(STAT_MemArenaLargeChunks, AllocSize);
+		}
+		Chunk->DataSize = AllocSize - (int32)sizeof(FChunk);
+		ReservedBytes += AllocSize;
+		LastChunkSize = AllocSize;
+	}
+
+	Chunk->Next = TopChunk;
+	TopChunk    = Chunk;
+	Top         = Chunk->Data();
+	End         = Top + Chunk->DataSize;
+}
+
+void FMemArena::Rewind(FChunk* NewTopChunk, uint8* NewTop, SIZE_T NewUsedBytesBelowTopChunk)
+{
+	HighWaterMark = GetHighWaterMark();
+
+	// Chunks above the mark become spares; walking down from the top leaves the oldest one at the head of the list
+	while (TopChunk != NewTopChunk)
+	{
+		FChunk* Chunk = TopChunk;
+		TopChunk      = Chunk->Next;
+		Chunk->Next   = SpareChunks;
+		SpareChunks   = Chunk;
+	}
+
+	TopChunk = NewTopChunk;
+	Top = NewTop;
+	End = NewTopChunk ? NewTopChunk->Data() + NewTopChunk->DataSize : nullptr;
+	UsedBytesBelowTopChunk = NewUsedBytesBelowTopChunk;
+}
+
+void FMemArena::FreeChunk(FChunk* Chunk)
+{
+	const int32 ChunkSize = Chunk->DataSize + (int32)sizeof(FChunk);
+	ReservedBytes -= ChunkSize;
+	if (ChunkSize == FPageAllocator::PageSize)
+	{
+		FPageAllocator::Free(Chunk);
+	}
+	else
+	{
+		DEC_MEMORY_STAT_BY(STAT_MemArenaLargeChunks, ChunkSize);
+		YMemory::FreeSized(Chunk, ChunkSize);
+	}
+}
@@ -176,7 +176,7 @@ void YOutputDeviceRedirector::Serialize( const TCHAR* Data, ELogVerbosity::Type
 #if PLATFORM_WINDOWS
 		_tprintf(_T("%s\n"), Data);
 #else
-		FGenericPlatformMisc::LocalPrint(Data);
+		YGenericPlatformMisc::LocalPrint(Data);
 		// printf("%s\n", TCHAR_TO_ANSI(Data));
 #endif
 		return;
@@ -224,6 +224,61 @@ bool FParse::Value(
 	int32			MaxLen,
 	bool			bShouldStopOnComma
 )
+{
+	YStringView View;
+	if (!FParse::Value(Stream, Match, View, bShouldStopOnComma))
+	{
+		return false;
+	}
+
+	// Truncated to the buffer
+	const int32 NumChars = YMath::Min(View.Len(), MaxLen - 1);
+	YMemory::Memcpy(Value, View.GetData(), NumChars * sizeof(TCHAR));
+	Value[NumChars] = 0;
+	return true;
+}
+
+//
+// Checks if a command-line parameter exists in the stream.
+//
+bool FParse::Param( const TCHAR* Stream, const TCHAR* Param )
+{
+	const TCHAR* Start = Stream;
+	if( *Stream )
+	{
+		while( (Start=FCString::Strifind(Start+1,Param)) != NULL )
+		{
+			if( Start>Stream && (Start[-1]=='-' || Start[-1]=='/') )
+			{
+				const TCHAR* End = Start + FCString::Strlen(Param);
+				if ( End == NULL || *End == 0 || FChar::IsWhitespace(*End) )
+				{
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+// 
+// Parse a string.
+//
+bool FParse::Value( const TCHAR* Stream, const TCHAR* Match, YString& Value, bool bShouldStopOnComma )
+{
+	YStringView View;
+	if( FParse::Value( Stream, Match, View, bShouldStopOnComma ) )
+	{
+		Value = View.ToString();
+		return 1;
+	}
+	else return 0;
+}
+
+//
+// Get a string from a text string, as a view into it. The other string overloads copy out of this one.
+//
+bool FParse::Value( const TCHAR* Stream, const TCHAR* Match, YStringView& Value, bool bShouldStopOnComma )
 {
 	const TCHAR* Found = FCString::Strifind(Stream,Match);
 
@@ -233,6 +288,7 @@ bool FParse::Value(
 	}
 
 	const TCHAR* Start = Found + FCString::Strlen(Match);
+	const TCHAR* End;
 
 	// Check for quoted arguments' string with spaces
 	// -Option="Value1 Value2"
@@ -254,14 +310,9 @@ bool FParse::Value(
 	if (bArgumentsQuoted || bFullyQuoted)
 	{
 		// Skip quote character if only params were quoted.
-		int32 QuoteCharactersToSkip = bArgumentsQuoted ? 1 : 0;
-		FCString::Strncpy(Value, Start + QuoteCharactersToSkip, MaxLen);
-
-		Value[MaxLen-1]=0;
-		TCHAR* Temp = FCString::Strstr( Value, TEXT("\x22") );
-		if (Temp != nullptr)
+		Start += bArgumentsQuoted ? 1 : 0;
+		for (End = Start; *End && *End != '"'; ++End)
 		{
-			*Temp = 0;
 		}
 	}
 	else
@@ -270,56 +321,13 @@ bool FParse::Value(
 		Start += FCString::Strspn(Start, TEXT(" \r\n\t"));
 
 		// Non-quoted string without spaces.
-		FCString::Strncpy( Value, Start, MaxLen );
-		Value[MaxLen-1]=0;
-		TCHAR* Temp;
-		Temp = FCString::Strstr( Value, TEXT(" ")  ); if( Temp ) *Temp=0;
-		Temp = FCString::Strstr( Value, TEXT("\r") ); if( Temp ) *Temp=0;
-		Temp = FCString::Strstr( Value, TEXT("\n") ); if( Temp ) *Temp=0;
-		Temp = FCString::Strstr( Value, TEXT("\t") ); if( Temp ) *Temp=0;
-		if (bShouldStopOnComma)
-		{
-			Temp = FCString::Strstr( Value, TEXT(",")  ); if( Temp ) *Temp=0;
-		}
-	}
-	return true;
-}
-
-//
-// Checks if a command-line parameter exists in the stream.
-//
-bool FParse::Param( const TCHAR* Stream, const TCHAR* Param )
-{
-	const TCHAR* Start = Stream;
-	if( *Stream )
-	{
-		while( (Start=FCString::Strifind(Start+1,Param)) != NULL )
+		for (End = Start; *End && *End != ' ' && *End != '\r' && *End != '\n' && *End != '\t' && !(bShouldStopOnComma && *End == ','); ++End)
 		{
-			if( Start>Stream && (Start[-1]=='-' || Start[-1]=='/') )
-			{
-				const TCHAR* End = Start + FCString::Strlen(Param);
-				if ( End == NULL || *End == 0 || FChar::IsWhitespace(*End) )
-				{
-					return true;
-				}
-			}
 		}
 	}
-	return false;
-}
 
-// 
-// Parse a string.
-//
-bool FParse::Value( const TCHAR* Stream, const TCHAR* Match, YString& Value, bool bShouldStopOnComma )
-{
-	TCHAR Temp[4096]=TEXT("");
-	if( FParse::Value( Stream, Match, Temp, ARRAY_COUNT(Temp), bShouldStopOnComma ) )
-	{
-		Value = Temp;
-		return 1;
-	}
-	else return 0;
+	Value = YStringView(Start, End - Start);
+	return true;
 }
 
 // 
@@ -340,44 +348,49 @@ bool FParse::QuotedString( const TCHAR* Buffer, YString& Value, int32* OutNumCha
 		return false;
 	}
 
+	// collect the characters first, so that Value grows once rather than once every few characters
+	TInlineString<255> Quoted;
+
 	while (*Buffer && *Buffer != TCHAR('"') && *Buffer != TCHAR('\n') && *Buffer != TCHAR('\r'))
 	{
 		if (*Buffer != TCHAR('\\')) // unescaped character
 		{
-			Value += *Buffer++;
+			Quoted += *Buffer++;
 		}
 		else if (*++Buffer == TCHAR('\\')) // escaped backslash "\\"
 		{
-			Value += TEXT("\\");
+			Quoted += TCHAR('\\');
 			++Buffer;
 		}
 		else if (*Buffer == TCHAR('\"')) // escaped double quote "\""
 		{
-			Value += TCHAR('"');
+			Quoted += TCHAR('"');
 			++Buffer;
 		}
 		else if (*Buffer == TCHAR('\'')) // escaped single quote "\'"
 		{
-			Value += TCHAR('\'');
+			Quoted += TCHAR('\'');
 			++Buffer;
 		}
 		else if (*Buffer == TCHAR('n')) // escaped newline
 		{
-			Value += TCHAR('\n');
+			Quoted += TCHAR('\n');
 			++Buffer;
 		}
 		else if (*Buffer == TCHAR('r')) // escaped carriage return
 		{
-			Value += TCHAR('\r');
+			Quoted += TCHAR('\r');
 			++Buffer;
 		}
 		else // some other escape sequence, assume it's a hex character value
 		{
-			Value += YString::Printf(TEXT("%c"), (HexDigit(Buffer[0]) * 16) + HexDigit(Buffer[1]));
+			Quoted += TCHAR((HexDigit(Buffer[0]) * 16) + HexDigit(Buffer[1]));
 			Buffer += 2;
 		}
 	}
 
+	Value.Append(*Quoted, Quoted.Len());
+
 	// Require closing quote
 	if (*Buffer++ != TCHAR('"'))
 	{
@@ -743,107 +756,362 @@ bool FParse::Token( const TCHAR*& Str, TCHAR* Result, int32 MaxLen, bool UseEsca
 	return Len!=0;
 }
 
-bool FParse::Token( const TCHAR*& Str, YString& Arg, bool UseEscape )
+namespace UE4Parse_Private
 {
-	Arg.Empty();
+	/** What a line or token is parsed into before it is copied into a YString, so that the YString grows only once. */
+	typedef TInlineString<255> FParseBuffer;
 
-	// Skip preceeding spaces and tabs.
-	while( FChar::IsWhitespace(*Str) )
+	/** Copies what was parsed over Result, allocating at most once and not at all if Result is big enough already. */
+	static void CopyToString(const FParseBuffer& Parsed, YString& Result)
 	{
-		Str++;
+		Result.Reset(Parsed.Len());
+		Result.Append(*Parsed, Parsed.Len());
 	}
 
-	if ( *Str == TEXT('"') )
+	/** Grabs the next space-delimited string from the input stream into any string type. */
+	template<typename StringType>
+	static bool Token(const TCHAR*& Str, StringType& Arg, bool UseEscape)
 	{
-		// Get quoted string.
-		Str++;
-		while( *Str && *Str != TCHAR('"') )
+		Arg.Reset();
+
+		// Skip preceeding spaces and tabs.
+		while( FChar::IsWhitespace(*Str) )
 		{
-			TCHAR c = *Str++;
-			if( c==TEXT('\\') && UseEscape )
+			Str++;
+		}
+
+		if ( *Str == TEXT('"') )
+		{
+			// Get quoted string.
+			Str++;
+			while( *Str && *Str != TCHAR('"') )
 			{
-				// Get escape.
-				c = *Str++;
-				if( !c )
+				TCHAR c = *Str++;
+				if( c==TEXT('\\') && UseEscape )
+				{
+					// Get escape.
+					c = *Str++;
+					if( !c )
+					{
+						break;
+					}
+				}
+
+				Arg += c;
+			}
+
+			if ( *Str == TEXT('"') )
+			{
+				Str++;
+			}
+		}
+		else
+		{
+			// Get unquoted string (that might contain a quoted part, which will be left intact).
+			// For example, -ARG="foo bar baz", will be treated as one token, with quotes intact
+			bool bInQuote = false;
+
+			while (1)
+			{
+				TCHAR Character = *Str;
+				if ((Character == 0) || (FChar::IsWhitespace(Character) && !bInQuote))
 				{
 					break;
 				}
+				Str++;
+
+				// Preserve escapes if they're in a quoted string (the check for " is in the else to let \" work as expected)
+				if (Character == TEXT('\\') && UseEscape && bInQuote)
+				{
+					Arg += Character;
+
+					Character = *Str;
+					if (!Character)
+					{
+						break;
+					}
+					Str++;
+				}
+				else if (Character == TEXT('"'))
+				{
+					bInQuote = !bInQuote;
+				}
+
+				Arg += Character;
 			}
+		}
+
+		return Arg.Len() > 0;
+	}
+
+	/** Grabs the next alpha-numeric space-delimited token from the input stream into any string type. */
+	template<typename StringType>
+	static bool AlnumToken(const TCHAR*& Str, StringType& Arg)
+	{
+		Arg.Reset();
 
-			Arg += c;
+		// Skip preceeding spaces and tabs.
+		while (FChar::IsWhitespace(*Str))
+		{
+			Str++;
 		}
 
-		if ( *Str == TEXT('"') )
+		while (FChar::IsAlnum(*Str) || *Str == TEXT('_'))
 		{
+			Arg += *Str;
 			Str++;
 		}
+
+		return Arg.Len() > 0;
 	}
-	else
+
+	/** Gets a line of Stream into any string type. */
+	template<typename StringType>
+	static bool Line(const TCHAR** Stream, StringType& Result, bool Exact)
 	{
-		// Get unquoted string (that might contain a quoted part, which will be left intact).
-		// For example, -ARG="foo bar baz", will be treated as one token, with quotes intact
-		bool bInQuote = false;
+		bool GotStream=0;
+		bool IsQuoted=0;
+		bool Ignore=0;
 
-		while (1)
+		Result.Reset();
+
+		while( **Stream!=0 && **Stream!=10 && **Stream!=13 )
 		{
-			TCHAR Character = *Str;
-			if ((Character == 0) || (FChar::IsWhitespace(Character) && !bInQuote))
-			{
+			// Start of comments.
+			if( !IsQuoted && !Exact && (*Stream)[0]=='/' && (*Stream)[1]=='/' )
+				Ignore = 1;
+
+			// Command chaining.
+			if( !IsQuoted && !Exact && **Stream=='|' )
 				break;
+
+			// Check quoting.
+			IsQuoted = IsQuoted ^ (**Stream==34);
+			GotStream=1;
+
+			// Got stuff.
+			if( !Ignore )
+			{
+				Result.AppendChar( *((*Stream)++) );
 			}
-			Str++;
+			else
+			{
+				(*Stream)++;
+			}
+		}
+		if( Exact )
+		{
+			// Eat up exactly one CR/LF.
+			if( **Stream == 13 )
+				(*Stream)++;
+			if( **Stream == 10 )
+				(*Stream)++;
+		}
+		else
+		{
+			// Eat up all CR/LF's.
+			while( **Stream==10 || **Stream==13 || **Stream=='|' )
+				(*Stream)++;
+		}
 
-			// Preserve escapes if they're in a quoted string (the check for " is in the else to let \" work as expected)
-			if (Character == TEXT('\\') && UseEscape && bInQuote)
+		return **Stream!=0 || GotStream;
+	}
+
+	/** Gets an extended line of Stream into any string type. */
+	template<typename StringType>
+	static bool LineExtended(const TCHAR** Stream, StringType& Result, int32& LinesConsumed, bool Exact)
+	{
+		bool GotStream=0;
+		bool IsQuoted=0;
+		bool Ignore=0;
+		int32 BracketDepth = 0;
+
+		Result.Reset();
+		LinesConsumed = 0;
+
+		while (**Stream != 0 && ((**Stream != 10 && **Stream != 13) || BracketDepth > 0))
+		{
+			// Start of comments.
+			if( !IsQuoted && !Exact && (*Stream)[0]=='/' && (*Stream)[1]=='/' )
+				Ignore = 1;
+
+			// Command chaining.
+			if( !IsQuoted && !Exact && **Stream=='|' )
+				break;
+
+			GotStream = 1;
+
+			// bracketed line break
+			if (**Stream == 10 || **Stream == 13)
 			{
-				Arg += Character;
+				checkSlow(BracketDepth > 0);
 
-				Character = *Str;
-				if (!Character)
+				Result.AppendChar(TEXT(' '));
+				LinesConsumed++;
+				(*Stream)++;
+				if (**Stream == 10 || **Stream == 13)
 				{
-					break;
+					(*Stream)++;
 				}
-				Str++;
 			}
-			else if (Character == TEXT('"'))
+			// allow line break if the end of the line is a backslash
+			else if (!IsQuoted && (*Stream)[0] == '\\' && ((*Stream)[1] == 10 || (*Stream)[1] == 13))
 			{
-				bInQuote = !bInQuote;
+				Result.AppendChar(TEXT(' '));
+				LinesConsumed++;
+				(*Stream) += 2;
+				if (**Stream == 10 || **Stream == 13)
+				{
+					(*Stream)++;
+				}
 			}
+			// check for starting or ending brace
+			else if (!IsQuoted && **Stream == '{')
+			{
+				BracketDepth++;
+				(*Stream)++;
+			}
+			else if (!IsQuoted && **Stream == '}' && BracketDepth > 0)
+			{
+				BracketDepth--;
+				(*Stream)++;
+			}
+			else
+			{
+				// Check quoting.
+				IsQuoted = IsQuoted ^ (**Stream==34);
 
-			Arg += Character;
+				// Got stuff.
+				if( !Ignore )
+				{
+					Result.AppendChar( *((*Stream)++) );
+				}
+				else
+				{
+					(*Stream)++;
+				}
+			}
+		}
+		if (**Stream == 0)
+		{
+			if (GotStream)
+			{
+				LinesConsumed++;
+			}
+		}
+		else if (Exact)
+		{
+			// Eat up exactly one CR/LF.
+			if (**Stream == 13 || **Stream == 10)
+			{
+				LinesConsumed++;
+				if (**Stream == 13)
+				{
+					(*Stream)++;
+				}
+				if( **Stream == 10 )
+				{
+					(*Stream)++;
+				}
+			}
+		}
+		else
+		{
+			// Eat up all CR/LF's.
+			while (**Stream == 10 || **Stream == 13 || **Stream == '|')
+			{
+				if (**Stream != '|')
+				{
+					LinesConsumed++;
+				}
+				if (((*Stream)[0] == 10 && (*Stream)[1] == 13) || ((*Stream)[0] == 13 && (*Stream)[1] == 10))
+				{
+					(*Stream)++;
+				}
+				(*Stream)++;
+			}
 		}
-	}
 
-	return Arg.Len() > 0;
+		return **Stream!=0 || GotStream;
+	}
 }
-YString FParse::Token( const TCHAR*& Str, bool UseEscape )
+
+bool FParse::Token( const TCHAR*& Str, YString& Arg, bool UseEscape )
 {
-	TCHAR Buffer[1024];
-	if( FParse::Token( Str, Buffer, ARRAY_COUNT(Buffer), UseEscape ) )
-		return Buffer;
-	else
-		return TEXT("");
+	UE4Parse_Private::FParseBuffer Parsed;
+	const bool bResult = UE4Parse_Private::Token(Str, Parsed, UseEscape);
+	UE4Parse_Private::CopyToString(Parsed, Arg);
+	return bResult;
 }
 
-bool FParse::AlnumToken(const TCHAR*& Str, YString& Arg)
+bool FParse::Token( const TCHAR*& Str, YInlineString& Arg, bool UseEscape )
 {
-	Arg.Empty();
+	return UE4Parse_Private::Token(Str, Arg, UseEscape);
+}
 
+bool FParse::Token( const TCHAR*& Str, YStringView& Arg )
+{
 	// Skip preceeding spaces and tabs.
-	while (FChar::IsWhitespace(*Str))
+	while( FChar::IsWhitespace(*Str) )
 	{
 		Str++;
 	}
 
-	while (FChar::IsAlnum(*Str) || *Str == TEXT('_'))
+	const TCHAR* Start;
+	if ( *Str == TEXT('"') )
 	{
-		Arg += *Str;
-		Str++;
+		// Get quoted string.
+		Start = ++Str;
+		while( *Str && *Str != TCHAR('"') )
+		{
+			Str++;
+		}
+		Arg = YStringView(Start, Str - Start);
+
+		if ( *Str == TEXT('"') )
+		{
+			Str++;
+		}
+	}
+	else
+	{
+		// Get unquoted string (that might contain a quoted part, which will be left intact).
+		bool bInQuote = false;
+		for (Start = Str; *Str && (bInQuote || !FChar::IsWhitespace(*Str)); Str++)
+		{
+			if (*Str == TEXT('"'))
+			{
+				bInQuote = !bInQuote;
+			}
+		}
+		Arg = YStringView(Start, Str - Start);
 	}
 
 	return Arg.Len() > 0;
 }
 
+YString FParse::Token( const TCHAR*& Str, bool UseEscape )
+{
+	TCHAR Buffer[1024];
+	if( FParse::Token( Str, Buffer, ARRAY_COUNT(Buffer), UseEscape ) )
+		return Buffer;
+	else
+		return TEXT("");
+}
+
+bool FParse::AlnumToken(const TCHAR*& Str, YString& Arg)
+{
+	UE4Parse_Private::FParseBuffer Parsed;
+	const bool bResult = UE4Parse_Private::AlnumToken(Str, Parsed);
+	UE4Parse_Private::CopyToString(Parsed, Arg);
+	return bResult;
+}
+
+bool FParse::AlnumToken(const TCHAR*& Str, YInlineString& Arg)
+{
+	return UE4Parse_Private::AlnumToken(Str, Arg);
+}
+
 //
 // Get a line of Stream (everything up to, but not including, CR/LF.
 // Returns 0 if ok, nonzero if at end of stream and returned 0-length string.
@@ -904,18 +1172,30 @@ bool FParse::Line
 	YString&		Result,
 	bool			Exact
 )
+{
+	UE4Parse_Private::FParseBuffer Parsed;
+	const bool bResult = UE4Parse_Private::Line(Stream, Parsed, Exact);
+	UE4Parse_Private::CopyToString(Parsed, Result);
+	return bResult;
+}
+
+bool FParse::Line(const TCHAR** Stream, YInlineString& Result, bool Exact)
+{
+	return UE4Parse_Private::Line(Stream, Result, Exact);
+}
+
+bool FParse::Line(const TCHAR** Stream, YStringView& Result, bool Exact)
 {
 	bool GotStream=0;
 	bool IsQuoted=0;
-	bool Ignore=0;
-
-	Result = TEXT("");
+	const TCHAR* Start = *Stream;
+	const TCHAR* End = nullptr;
 
 	while( **Stream!=0 && **Stream!=10 && **Stream!=13 )
 	{
-		// Start of comments.
-		if( !IsQuoted && !Exact && (*Stream)[0]=='/' && (*Stream)[1]=='/' )
-			Ignore = 1;
+		// Start of comments, the rest of the line is left out of the view.
+		if( !IsQuoted && !Exact && (*Stream)[0]=='/' && (*Stream)[1]=='/' && !End )
+			End = *Stream;
 
 		// Command chaining.
 		if( !IsQuoted && !Exact && **Stream=='|' )
@@ -924,17 +1204,10 @@ bool FParse::Line
 		// Check quoting.
 		IsQuoted = IsQuoted ^ (**Stream==34);
 		GotStream=1;
-
-		// Got stuff.
-		if( !Ignore )
-		{
-			Result.AppendChar( *((*Stream)++) );
-		}
-		else
-		{
-			(*Stream)++;
-		}
+		(*Stream)++;
 	}
+	Result = YStringView(Start, (End ? End : *Stream) - Start);
+
 	if( Exact )
 	{
 		// Eat up exactly one CR/LF.
@@ -955,118 +1228,15 @@ bool FParse::Line
 
 bool FParse::LineExtended(const TCHAR** Stream, YString& Result, int32& LinesConsumed, bool Exact)
 {
-	bool GotStream=0;
-	bool IsQuoted=0;
-	bool Ignore=0;
-	int32 BracketDepth = 0;
-
-	Result = TEXT("");
-	LinesConsumed = 0;
-
-	while (**Stream != 0 && ((**Stream != 10 && **Stream != 13) || BracketDepth > 0))
-	{
-		// Start of comments.
-		if( !IsQuoted && !Exact && (*Stream)[0]=='/' && (*Stream)[1]=='/' )
-			Ignore = 1;
-
-		// Command chaining.
-		if( !IsQuoted && !Exact && **Stream=='|' )
-			break;
-
-		GotStream = 1;
-
-		// bracketed line break
-		if (**Stream == 10 || **Stream == 13)
-		{
-			checkSlow(BracketDepth > 0);
-
-			Result.AppendChar(TEXT(' '));
-			LinesConsumed++;
-			(*Stream)++;
-			if (**Stream == 10 || **Stream == 13)
-			{
-				(*Stream)++;
-			}
-		}
-		// allow line break if the end of the line is a backslash
-		else if (!IsQuoted && (*Stream)[0] == '\\' && ((*Stream)[1] == 10 || (*Stream)[1] == 13))
-		{
-			Result.AppendChar(TEXT(' '));
-			LinesConsumed++;
-			(*Stream) += 2;
-			if (**Stream == 10 || **Stream == 13)
-			{
-				(*Stream)++;
-			}
-		}
-		// check for starting or ending brace
-		else if (!IsQuoted && **Stream == '{')
-		{
-			BracketDepth++;
-			(*Stream)++;
-		}
-		else if (!IsQuoted && **Stream == '}' && BracketDepth > 0)
-		{
-			BracketDepth--;
-			(*Stream)++;
-		}
-		else
-		{
-			// Check quoting.
-			IsQuoted = IsQuoted ^ (**Stream==34);
-
-			// Got stuff.
-			if( !Ignore )
-			{
-				Result.AppendChar( *((*Stream)++) );
-			}
-			else
-			{
-				(*Stream)++;
-			}
-		}
-	}
-	if (**Stream == 0)
-	{
-		if (GotStream)
-		{
-			LinesConsumed++;
-		}
-	}
-	else if (Exact)
-	{
-		// Eat up exactly one CR/LF.
-		if (**Stream == 13 || **Stream == 10)
-		{
-			LinesConsumed++;
-			if (**Stream == 13)
-			{
-				(*Stream)++;
-			}
-			if( **Stream == 10 )
-			{
-				(*Stream)++;
-			}
-		}
-	}
-	else
-	{
-		// Eat up all CR/LF's.
-		while (**Stream == 10 || **Stream == 13 || **Stream == '|')
-		{
-			if (**Stream != '|')
-			{
-				LinesConsumed++;
-			}
-			if (((*Stream)[0] == 10 && (*Stream)[1] == 13) || ((*Stream)[0] == 13 && (*Stream)[1] == 10))
-			{
-				(*Stream)++;
-			}
-			(*Stream)++;
-		}
-	}
+	UE4Parse_Private::FParseBuffer Parsed;
+	const bool bResult = UE4Parse_Private::LineExtended(Stream, Parsed, LinesConsumed, Exact);
+	UE4Parse_Private::CopyToString(Parsed, Result);
+	return bResult;
+}
 
-	return **Stream!=0 || GotStream;
+bool FParse::LineExtended(const TCHAR** Stream, YInlineString& Result, int32& LinesConsumed, bool Exact)
+{
+	return UE4Parse_Private::LineExtended(Stream, Result, LinesConsumed, Exact);
 }
 
 uint32 FParse::HexNumber (const TCHAR* HexString)
@@ -27,6 +27,20 @@ namespace UE4Paths_Private
 	auto IsSlashOrBackslash    = [](TCHAR C) { return C == TEXT('/') || C == TEXT('\\'); };
 	auto IsNotSlashOrBackslash = [](TCHAR C) { return C != TEXT('/') && C != TEXT('\\'); };
 
+	/** @return the index of the last character before EndPos that matches Pred, or INDEX_NONE */
+	template<typename PredicateType>
+	int32 FindLastCharByPredicate(const YStringView& Path, PredicateType Pred, int32 EndPos)
+	{
+		for (int32 Index = EndPos - 1; Index >= 0; --Index)
+		{
+			if (Pred(Path[Index]))
+			{
+				return Index;
+			}
+		}
+		return INDEX_NONE;
+	}
+
 	YString GameSavedDir()
 	{
 		YString Result = YPaths::GameUserDir();
@@ -554,6 +568,56 @@ YString YPaths::GetPath(YString&& InPath)
 	return Result;
 }
 
+YStringView YPaths::GetExtensionView(const YStringView& InPath, bool bIncludeDot)
+{
+	const YStringView Filename = GetCleanFilenameView(InPath);
+	int32 DotPos = INDEX_NONE;
+	if (Filename.FindLastChar(TEXT('.'), DotPos))
+	{
+		return Filename.Mid(DotPos + (bIncludeDot ? 0 : 1));
+	}
+
+	return YStringView();
+}
+
+YStringView YPaths::GetCleanFilenameView(const YStringView& InPath)
+{
+	int32 EndPos   = UE4Paths_Private::FindLastCharByPredicate(InPath, UE4Paths_Private::IsNotSlashOrBackslash, InPath.Len()) + 1;
+	int32 StartPos = UE4Paths_Private::FindLastCharByPredicate(InPath, UE4Paths_Private::IsSlashOrBackslash, EndPos) + 1;
+
+	return InPath.Mid(StartPos, EndPos - StartPos);
+}
+
+YStringView YPaths::GetBaseFilenameView(const YStringView& InPath, bool bRemovePath)
+{
+	const YStringView Wk = bRemovePath ? GetCleanFilenameView(InPath) : InPath;
+
+	// remove the extension
+	int32 ExtPos = INDEX_NONE;
+	Wk.FindLastChar(TEXT('.'), ExtPos);
+
+	// determine the position of the path/leaf separator
+	int32 LeafPos = INDEX_NONE;
+	if (!bRemovePath)
+	{
+		LeafPos = UE4Paths_Private::FindLastCharByPredicate(Wk, UE4Paths_Private::IsSlashOrBackslash, Wk.Len());
+	}
+
+	if (ExtPos != INDEX_NONE && (LeafPos == INDEX_NONE || ExtPos > LeafPos))
+	{
+		return Wk.Left(ExtPos);
+	}
+
+	return Wk;
+}
+
+YStringView YPaths::GetPathView(const YStringView& InPath)
+{
+	int32 Pos = UE4Paths_Private::FindLastCharByPredicate(InPath, UE4Paths_Private::IsSlashOrBackslash, InPath.Len());
+
+	return Pos != INDEX_NONE ? InPath.Left(Pos) : YStringView();
+}
+
 YString YPaths::ChangeExtension(const YString& InPath, const YString& InNewExtension)
 {
 	int32 Pos = INDEX_NONE;
@@ -1043,6 +1107,13 @@ void YPaths::Split( const YString& InPath, YString& PathPart, YString& FilenameP
 	ExtensionPart = GetExtension(InPath);
 }
 
+void YPaths::Split(const YStringView& InPath, YStringView& PathPart, YStringView& FilenamePart, YStringView& ExtensionPart)
+{
+	PathPart = GetPathView(InPath);
+	FilenamePart = GetBaseFilenameView(InPath);
+	ExtensionPart = GetExtensionView(InPath);
+}
+
 const YString& YPaths::GetRelativePathToRoot()
 {
 	struct FRelativePathInitializer
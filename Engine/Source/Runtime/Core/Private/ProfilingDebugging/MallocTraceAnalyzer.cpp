@@ -0,0 +1,495 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	MallocTraceAnalyzer.cpp: Offline reports for files written by FMallocTraceProxy
+=============================================================================*/
+
+#include "ProfilingDebugging/MallocTraceAnalyzer.h"
+#include "Containers/Set.h"
+#include "Containers/StringConv.h"
+#include "HAL/PlatformStackWalk.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/OutputDeviceRedirector.h"
+#include "Logging/LogMacros.h"
+
+#if USE_MALLOC_TRACE
+
+const double FMallocTraceAnalyzer::ShortLifetimeSeconds = 0.001;
+
+/** Frames shown for each callsite in the report */
+static const int32 FramesPerCallsite = 3;
+
+static const TCHAR* LifetimeBucketNames[FMallocTraceAnalyzer::NumLifetimeBuckets + 1] =
+{
+	TEXT("< 1 us"),
+	TEXT("1-10 us"),
+	TEXT("10-100 us"),
+	TEXT("0.1-1 ms"),
+	TEXT("1-10 ms"),
+	TEXT("10-100 ms"),
+	TEXT("0.1-1 s"),
+	TEXT("1-10 s"),
+	TEXT(">= 10 s"),
+	TEXT("never freed"),
+};
+
+FMallocTraceAnalyzer::FMallocTraceAnalyzer()
+	: SecondsPerCycle(0.0)
+	, StartCycles(0)
+	, EndCycles(0)
+	, NumThreads(0)
+	, NumAllocs(0)
+	, NumFrees(0)
+	, NumReallocs(0)
+	, NumUnknownFrees(0)
+	, PeakLiveBytes(0)
+	, PeakCycles(0)
+	, PeakEventIndex(INDEX_NONE)
+	, FinalLiveBytes(0)
+{
+	YMemory::Memzero(LifetimeHistogram, sizeof(LifetimeHistogram));
+}
+
+bool FMallocTraceAnalyzer::Load(const TCHAR* InFilename)
+{
+	using namespace MallocTrace;
+	check(Events.Num() == 0 && Callsites.Num() == 0);
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, InFilename))
+	{
+		UE_LOG(LogMemory, Warning, TEXT("Failed to read malloc trace %s"), InFilename);
+		return false;
+	}
+
+	FFileHeader Header;
+	if (Data.Num() < (int32)sizeof(Header))
+	{
+		UE_LOG(LogMemory, Warning, TEXT("%s is too small to be a malloc trace"), InFilename);
+		return false;
+	}
+	YMemory::Memcpy(&Header, Data.GetData(), sizeof(Header));
+	if (Header.Magic != FileMagic || Header.Version != FileVersion)
+	{
+		UE_LOG(LogMemory, Warning, TEXT("%s is not a version %u malloc trace"), InFilename, FileVersion);
+		return false;
+	}
+
+	Filename = InFilename;
+	SecondsPerCycle = Header.SecondsPerCycle;
+	StartCycles = Header.StartCycles;
+
+	TSet<uint32> ThreadIds;
+	int64 Offset = sizeof(Header);
+	while (Offset < Data.Num())
+	{
+		FBlockHeader Block;
+		if (Offset + (int64)sizeof(Block) > Data.Num())
+		{
+			UE_LOG(LogMemory, Warning, TEXT("%s ends in the middle of a block, the trace was not stopped cleanly"), InFilename);
+			break;
+		}
+		YMemory::Memcpy(&Block, Data.GetData() + Offset, sizeof(Block));
+		Offset += sizeof(Block);
+		if (Offset + Block.Size > Data.Num())
+		{
+			UE_LOG(LogMemory, Warning, TEXT("%s ends in the middle of a block, the trace was not stopped cleanly"), InFilename);
+			break;
+		}
+		if (!ParseBlock(Data.GetData() + Offset, Block.Size, Block.BaseCycles))
+		{
+			UE_LOG(LogMemory, Warning, TEXT("%s has a corrupt block at offset %lld, ignoring the rest of the file"), InFilename, Offset);
+			break;
+		}
+		ThreadIds.Add(Block.ThreadId);
+		Offset += Block.Size;
+	}
+	NumThreads = ThreadIds.Num();
+
+	// Blocks are written as they fill up, put the events of all threads back in time order
+	Events.Sort([](const FEvent& A, const FEvent& B)
+	{
+		return A.Cycles != B.Cycles ? A.Cycles < B.Cycles : A.Sequence < B.Sequence;
+	});
+	EndCycles = Events.Num() ? Events.Last().Cycles : StartCycles;
+
+	Replay(Events.Num(), true);
+	if (PeakEventIndex != INDEX_NONE)
+	{
+		Replay(PeakEventIndex + 1, false);
+	}
+	return true;
+}
+
+bool FMallocTraceAnalyzer::ParseBlock(const uint8* Data, uint32 Size, uint64 BaseCycles)
+{
+	using namespace MallocTrace;
+
+	const uint8* Cursor = Data;
+	const uint8* End = Data + Size;
+	uint64 Cycles = BaseCycles;
+	uint64 LastPtr = 0;
+
+	auto ReadVarInt = [&Cursor, End](uint64& OutValue)
+	{
+		OutValue = 0;
+		for (uint32 Shift = 0; Cursor < End && Shift < 64; Shift += 7)
+		{
+			const uint8 Byte = *Cursor++;
+			OutValue |= uint64(Byte & 0x7f) << Shift;
+			if (!(Byte & 0x80))
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+	auto ReadPtr = [&ReadVarInt, &LastPtr](uint64& OutPtr)
+	{
+		uint64 ZigZag;
+		if (!ReadVarInt(ZigZag))
+		{
+			return false;
+		}
+		LastPtr += uint64(int64(ZigZag >> 1) ^ -int64(ZigZag & 1));
+		OutPtr = LastPtr;
+		return true;
+	};
+	auto ReadCycles = [&ReadVarInt, &Cycles](uint64& OutCycles)
+	{
+		uint64 Delta;
+		if (!ReadVarInt(Delta))
+		{
+			return false;
+		}
+		Cycles += Delta;
+		OutCycles = Cycles;
+		return true;
+	};
+
+	while (Cursor < End)
+	{
+		FEvent Event;
+		YMemory::Memzero(&Event, sizeof(Event));
+		Event.Type = EEvent(*Cursor++);
+
+		uint64 CallstackId = 0;
+		bool bValid = false;
+		switch (Event.Type)
+		{
+			case EEvent::Alloc:
+				bValid = ReadPtr(Event.Ptr) && ReadVarInt(Event.Size) && ReadVarInt(CallstackId) && ReadCycles(Event.Cycles);
+				NumAllocs += bValid ? 1 : 0;
+				break;
+
+			case EEvent::Free:
+				// Frees release OldPtr like reallocs do
+				bValid = ReadPtr(Event.OldPtr) && ReadCycles(Event.Cycles);
+				NumFrees += bValid ? 1 : 0;
+				break;
+
+			case EEvent::Realloc:
+			{
+				// The old block is released when the realloc starts and the new one allocated when it returns, replayed as two events
+				uint64 AllocCycles;
+				bValid = ReadPtr(Event.OldPtr) && ReadPtr(Event.Ptr) && ReadVarInt(Event.Size) && ReadVarInt(CallstackId) && ReadCycles(Event.Cycles) && ReadCycles(AllocCycles);
+				if (bValid && Event.Ptr)
+				{
+					FEvent AllocEvent = Event;
+					AllocEvent.OldPtr = 0;
+					AllocEvent.Cycles = AllocCycles;
+					AllocEvent.CallstackId = uint32(CallstackId);
+					Event.Ptr = 0;
+					Event.Size = 0;
+					Event.Sequence = Events.Num();
+					Events.Add(Event);
+					Event = AllocEvent;
+				}
+				NumReallocs += bValid ? 1 : 0;
+				break;
+			}
+
+			case EEvent::Callstack:
+			{
+				uint64 Depth;
+				if (!ReadVarInt(CallstackId) || !ReadVarInt(Depth) || Depth > MaxCallstackDepth)
+				{
+					return false;
+				}
+				TArray<uint64>& Frames = Callstacks.Add(uint32(CallstackId));
+				Frames.SetNumUninitialized((int32)Depth);
+				for (uint64& Frame : Frames)
+				{
+					if (!ReadVarInt(Frame))
+					{
+						return false;
+					}
+				}
+				continue;
+			}
+
+			default:
+				return false;
+		}
+
+		if (!bValid)
+		{
+			return false;
+		}
+		Event.CallstackId = uint32(CallstackId);
+		Event.Sequence = Events.Num();
+		Events.Add(Event);
+	}
+	return true;
+}
+
+int32 FMallocTraceAnalyzer::FindOrAddCallsite(uint32 CallstackId)
+{
+	if (const int32* Index = CallsiteIndices.Find(CallstackId))
+	{
+		return *Index;
+	}
+	const int32 Index = Callsites.AddZeroed();
+	Callsites[Index].CallstackId = CallstackId;
+	CallsiteIndices.Add(CallstackId, Index);
+	return Index;
+}
+
+void FMallocTraceAnalyzer::Replay(int32 NumEvents, bool bGatherStats)
+{
+	using namespace MallocTrace;
+
+	struct FLiveAlloc
+	{
+		uint64 Size;
+		uint64 Cycles;
+		int32 CallsiteIndex;
+	};
+	TMap<uint64, FLiveAlloc> LiveAllocs;
+	TArray<int64> LiveBytesByCallsite;
+	LiveBytesByCallsite.AddZeroed(Callsites.Num());
+	int64 LiveBytes = 0;
+
+	for (int32 EventIndex = 0; EventIndex < NumEvents; ++EventIndex)
+	{
+		const FEvent& Event = Events[EventIndex];
+
+		if (Event.OldPtr)
+		{
+			FLiveAlloc Alloc;
+			if (LiveAllocs.RemoveAndCopyValue(Event.OldPtr, Alloc))
+			{
+				LiveBytes -= Alloc.Size;
+				if (bGatherStats)
+				{
+					FCallsite& Callsite = Callsites[Alloc.CallsiteIndex];
+					Callsite.LiveBytes -= Alloc.Size;
+					Callsite.NumFrees++;
+
+					const uint64 LifetimeCycles = Event.Cycles - Alloc.Cycles;
+					const double LifetimeSeconds = LifetimeCycles * SecondsPerCycle;
+					Callsite.LifetimeCycles += LifetimeCycles;
+					Callsite.NumShortLived += LifetimeSeconds < ShortLifetimeSeconds ? 1 : 0;
+
+					int32 Bucket = 0;
+					for (double Limit = 1e-6; Bucket < NumLifetimeBuckets - 1 && LifetimeSeconds >= Limit; Limit *= 10.0)
+					{
+						++Bucket;
+					}
+					LifetimeHistogram[Bucket]++;
+				}
+				else
+				{
+					LiveBytesByCallsite[Alloc.CallsiteIndex] -= Alloc.Size;
+				}
+			}
+			else if (bGatherStats)
+			{
+				NumUnknownFrees++;
+			}
+		}
+
+		if (Event.Ptr)
+		{
+			FLiveAlloc Alloc;
+			Alloc.Size = Event.Size;
+			Alloc.Cycles = Event.Cycles;
+			if (bGatherStats)
+			{
+				Alloc.CallsiteIndex = FindOrAddCallsite(Event.CallstackId);
+				FCallsite& Callsite = Callsites[Alloc.CallsiteIndex];
+				Callsite.NumAllocs++;
+				Callsite.AllocatedBytes += Event.Size;
+				Callsite.LiveBytes += Event.Size;
+				Callsite.PeakLiveBytes = YMath::Max(Callsite.PeakLiveBytes, Callsite.LiveBytes);
+			}
+			else
+			{
+				Alloc.CallsiteIndex = CallsiteIndices.FindChecked(Event.CallstackId);
+				LiveBytesByCallsite[Alloc.CallsiteIndex] += Event.Size;
+			}
+			LiveAllocs.Add(Event.Ptr, Alloc);
+			LiveBytes += Event.Size;
+		}
+
+		if (bGatherStats)
+		{
+			if (LiveBytes > PeakLiveBytes)
+			{
+				PeakLiveBytes = LiveBytes;
+				PeakCycles = Event.Cycles;
+				PeakEventIndex = EventIndex;
+			}
+		}
+	}
+
+	if (bGatherStats)
+	{
+		FinalLiveBytes = LiveBytes;
+		LifetimeHistogram[NumLifetimeBuckets] = LiveAllocs.Num();
+	}
+	else
+	{
+		for (int32 Index = 0; Index < Callsites.Num(); ++Index)
+		{
+			Callsites[Index].LiveBytesAtPeak = LiveBytesByCallsite[Index];
+		}
+	}
+}
+
+const TArray<uint64>& FMallocTraceAnalyzer::GetCallstack(uint32 CallstackId) const
+{
+	static const TArray<uint64> NoFrames;
+	const TArray<uint64>* Frames = Callstacks.Find(CallstackId);
+	return Frames ? *Frames : NoFrames;
+}
+
+YString FMallocTraceAnalyzer::DescribeCallsite(uint32 CallstackId) const
+{
+	// Leading frames inside the allocators say nothing about who allocated
+	static const TCHAR* AllocatorFrames[] = { TEXT("YMemory::"), TEXT("YMalloc"), TEXT("FMalloc"), TEXT("operator new"), TEXT("operator delete"), TEXT("Realloc") };
+
+	YString Result;
+	int32 NumShown = 0;
+	for (uint64 Frame : GetCallstack(CallstackId))
+	{
+		FProgramCounterSymbolInfo SymbolInfo;
+		FPlatformStackWalk::ProgramCounterToSymbolInfo(Frame, SymbolInfo);
+		const YString Symbol = SymbolInfo.FunctionName[0]
+			? YString(ANSI_TO_TCHAR(SymbolInfo.FunctionName))
+			: SymbolInfo.ModuleName[0] ? YString::Printf(TEXT("%s+0x%llx"), ANSI_TO_TCHAR(SymbolInfo.ModuleName), SymbolInfo.OffsetInModule) : YString::Printf(TEXT("0x%016llx"), Frame);
+
+		if (!NumShown)
+		{
+			bool bAllocatorFrame = false;
+			for (const TCHAR* AllocatorFrame : AllocatorFrames)
+			{
+				bAllocatorFrame |= Symbol.Contains(AllocatorFrame, ESearchCase::CaseSensitive);
+			}
+			if (bAllocatorFrame)
+			{
+				continue;
+			}
+		}
+
+		Result += NumShown ? TEXT(" <- ") : TEXT("");
+		Result += Symbol;
+		if (++NumShown == FramesPerCallsite)
+		{
+			break;
+		}
+	}
+	return NumShown ? Result : YString(TEXT("<no callstack>"));
+}
+
+void FMallocTraceAnalyzer::Report(YOutputDevice& Ar, int32 NumCallsites) const
+{
+	const double InvToMb = 1.0 / (1024 * 1024);
+	const double DurationSeconds = YMath::Max((EndCycles - StartCycles) * SecondsPerCycle, 1e-6);
+
+	Ar.Logf(TEXT("Malloc trace %s"), *Filename);
+	Ar.Logf(TEXT("  %.2f s on %d threads, %d callsites"), DurationSeconds, NumThreads, Callsites.Num());
+	Ar.Logf(TEXT("  %llu allocs, %llu reallocs, %llu frees, %llu frees of blocks allocated before the trace started"), NumAllocs, NumReallocs, NumFrees, NumUnknownFrees);
+	Ar.Logf(TEXT("  Peak live %.2f MB at %.3f s, %.2f MB live at the end"), PeakLiveBytes * InvToMb, (PeakCycles - StartCycles) * SecondsPerCycle, FinalLiveBytes * InvToMb);
+
+	TArray<const FCallsite*> Sorted;
+	for (const FCallsite& Callsite : Callsites)
+	{
+		Sorted.Add(&Callsite);
+	}
+	const int32 NumShown = YMath::Min(NumCallsites, Sorted.Num());
+
+	Sorted.Sort([](const FCallsite& A, const FCallsite& B) { return A.LiveBytesAtPeak > B.LiveBytesAtPeak; });
+	Ar.Logf(TEXT(""));
+	Ar.Logf(TEXT("Live memory at peak by callsite:"));
+	Ar.Logf(TEXT("%10s %6s %10s %10s  %s"), TEXT("MB"), TEXT("%Peak"), TEXT("SitePeakMB"), TEXT("Allocs"), TEXT("Callsite"));
+	for (int32 Index = 0; Index < NumShown && Sorted[Index]->LiveBytesAtPeak > 0; ++Index)
+	{
+		const FCallsite& Callsite = *Sorted[Index];
+		Ar.Logf(TEXT("%10.2f %5.1f%% %10.2f %10llu  %s"),
+			Callsite.LiveBytesAtPeak * InvToMb,
+			PeakLiveBytes ? 100.0 * Callsite.LiveBytesAtPeak / PeakLiveBytes : 0.0,
+			Callsite.PeakLiveBytes * InvToMb,
+			Callsite.NumAllocs,
+			*DescribeCallsite(Callsite.CallstackId));
+	}
+
+	Sorted.Sort([](const FCallsite& A, const FCallsite& B) { return A.NumAllocs > B.NumAllocs; });
+	Ar.Logf(TEXT(""));
+	Ar.Logf(TEXT("Churn hotspots by allocation count:"));
+	Ar.Logf(TEXT("%10s %10s %10s %12s %10s  %s"), TEXT("Allocs"), TEXT("Allocs/s"), TEXT("ShortLived"), TEXT("AvgLife(ms)"), TEXT("TotalMB"), TEXT("Callsite"));
+	for (int32 Index = 0; Index < NumShown; ++Index)
+	{
+		const FCallsite& Callsite = *Sorted[Index];
+		Ar.Logf(TEXT("%10llu %10.0f %9.1f%% %12.3f %10.2f  %s"),
+			Callsite.NumAllocs,
+			Callsite.NumAllocs / DurationSeconds,
+			Callsite.NumAllocs ? 100.0 * Callsite.NumShortLived / Callsite.NumAllocs : 0.0,
+			Callsite.NumFrees ? 1000.0 * Callsite.LifetimeCycles * SecondsPerCycle / Callsite.NumFrees : 0.0,
+			Callsite.AllocatedBytes * InvToMb,
+			*DescribeCallsite(Callsite.CallstackId));
+	}
+
+	uint64 NumLifetimes = 0;
+	for (uint64 Count : LifetimeHistogram)
+	{
+		NumLifetimes += Count;
+	}
+	Ar.Logf(TEXT(""));
+	Ar.Logf(TEXT("Allocation lifetimes:"));
+	for (int32 Bucket = 0; Bucket <= NumLifetimeBuckets; ++Bucket)
+	{
+		Ar.Logf(TEXT("%12s %12llu %5.1f%%"), LifetimeBucketNames[Bucket], LifetimeHistogram[Bucket], NumLifetimes ? 100.0 * LifetimeHistogram[Bucket] / NumLifetimes : 0.0);
+	}
+}
+
+static void MallocTraceAnalyze(const TArray<YString>& Args)
+{
+	const YString Filename = Args.Num() ? Args[0] : FMallocTraceProxy::GetLastTraceFilename();
+	if (Filename.IsEmpty())
+	{
+		UE_LOG(LogMemory, Warning, TEXT("No malloc trace to analyze, pass a file or record one with MallocTrace.Start and MallocTrace.Stop"));
+		return;
+	}
+	if (FMallocTraceProxy::IsTracing() && Filename == FMallocTraceProxy::GetLastTraceFilename())
+	{
+		UE_LOG(LogMemory, Warning, TEXT("%s is still being written, run MallocTrace.Stop first"), *Filename);
+		return;
+	}
+
+	FMallocTraceAnalyzer Analyzer;
+	if (Analyzer.Load(*Filename))
+	{
+		Analyzer.Report(*GLog, Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 20);
+	}
+}
+
+static FAutoConsoleCommand GMallocTraceAnalyzeCommand(
+	TEXT("MallocTrace.Analyze"),
+	TEXT("Reports peak live memory by callsite, allocation churn hotspots and allocation lifetimes for a malloc trace.\n")
+	TEXT("Usage: MallocTrace.Analyze [Filename] [NumCallsites], defaults to the last trace and 20 callsites"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&MallocTraceAnalyze)
+	);
+
+#endif // USE_MALLOC_TRACE
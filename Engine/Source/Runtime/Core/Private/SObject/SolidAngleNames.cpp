@@ -87,15 +87,15 @@ const TCHAR* DebugYName(YName& Name)
 }
 
 template <typename TCharType>
-static uint16 GetRawCasePreservingHash(const TCharType* Source)
+static uint32 GetRawCasePreservingHash(const TCharType* Source)
 {
-	return FCrc::StrCrc32(Source) & 0xFFFF;
+	return FCrc::StrCrc32(Source);
 
 }
 template <typename TCharType>
-static uint16 GetRawNonCasePreservingHash(const TCharType* Source)
+static uint32 GetRawNonCasePreservingHash(const TCharType* Source)
 {
-	return FCrc::Strihash_DEPRECATED(Source) & 0xFFFF;
+	return FCrc::Strihash_DEPRECATED(Source);
 }
 
 /*-----------------------------------------------------------------------------
@@ -231,15 +231,15 @@ YNameEntrySerialized::YNameEntrySerialized(const YNameEntry& NameEntry)
 	{
 		PreSetIsWideForSerialization(true);
 		FCString::Strcpy(WideName, NAME_SIZE, NameEntry.GetWideName());
-		NonCasePreservingHash = GetRawNonCasePreservingHash(NameEntry.GetWideName());
-		CasePreservingHash = GetRawCasePreservingHash(NameEntry.GetWideName());
+		NonCasePreservingHash = GetRawNonCasePreservingHash(NameEntry.GetWideName()) & 0xFFFF;
+		CasePreservingHash = GetRawCasePreservingHash(NameEntry.GetWideName()) & 0xFFFF;
 	}
 	else
 	{
 		PreSetIsWideForSerialization(false);
 		FCStringAnsi::Strcpy(AnsiName, NAME_SIZE, NameEntry.GetAnsiName());
-		NonCasePreservingHash = GetRawNonCasePreservingHash(NameEntry.GetAnsiName());
-		CasePreservingHash = GetRawCasePreservingHash(NameEntry.GetAnsiName());
+		NonCasePreservingHash = GetRawNonCasePreservingHash(NameEntry.GetAnsiName()) & 0xFFFF;
+		CasePreservingHash = GetRawCasePreservingHash(NameEntry.GetAnsiName()) & 0xFFFF;
 	}
 }
 
@@ -269,17 +269,6 @@ YNameEntry*** YName::GetNameTableForDebuggerVisualizers_MT()
 }
 
 
-FCriticalSection* YName::GetCriticalSection()
-{
-	static FCriticalSection*	CriticalSection = NULL;
-	if( CriticalSection == NULL )
-	{
-		check(IsInGameThread());
-		CriticalSection = new FCriticalSection();
-	}
-	return CriticalSection;
-}
-
 YString YName::NameToDisplayString( const YString& InDisplayName, const bool bIsBool )
 {
 	// Copy the characters out so that we can modify the string in place
@@ -401,13 +390,167 @@ YString YName::NameToDisplayString( const YString& InDisplayName, const bool bIs
 
 
 // Static variables.
-YNameEntry*	YName::NameHashHead[YNameDefs::NameHashBucketCount];
-YNameEntry*	YName::NameHashTail[YNameDefs::NameHashBucketCount];
 int32		YName::NameEntryMemorySize;
 int32		YName::NumAnsiNames;
 int32		YName::NumWideNames;
 
 
+/*-----------------------------------------------------------------------------
+	YName hash.
+-----------------------------------------------------------------------------*/
+
+namespace UE4Names_Private
+{
+	/**
+	 * One open addressed table of a shard of the name hash. A slot holds the full hash of a name in its low half and
+	 * the name index plus one, shifted left once and with the lowest bit set for case sensitive entries, in its high half.
+	 * A slot is written once, while its shard is locked, and never changes after that so lookups need no lock. A slot
+	 * whose high half is zero is empty.
+	 */
+	struct FNameSlotTable
+	{
+		/** Table this one replaced. Lookups may still be probing it, and names are never freed, so it is kept. */
+		FNameSlotTable* Previous;
+		/** Number of slots minus one, a power of two minus one */
+		uint32 Mask;
+		/** Shift that turns a scrambled hash into a slot index */
+		uint32 Shift;
+		/** Slots, allocated past the end of the struct */
+		volatile uint64 Slots[1];
+	};
+
+	MS_ALIGN(PLATFORM_CACHE_LINE_SIZE) struct FNameHashShard
+	{
+		/** Current table of the shard, replaced when it fills up */
+		FNameSlotTable* volatile Table;
+		/** Number of slots used in Table, only accessed with Lock held */
+		int32 NumUsed;
+		/** Held while adding names to the shard */
+		FCriticalSection Lock;
+	} GCC_ALIGN(PLATFORM_CACHE_LINE_SIZE);
+
+	/** Shards of the name hash, allocated by YName::StaticInit so they can't be constructed after use */
+	static FNameHashShard* NameHashShards = nullptr;
+
+	/** Size of the name hash, including the tables replaced as it grew */
+	static volatile int32 NameHashMemorySize = 0;
+
+	static_assert((YNameDefs::NameHashShardCount & (YNameDefs::NameHashShardCount - 1)) == 0, "NameHashShardCount must be a power of two");
+	static_assert((YNameDefs::NameHashShardInitialSlots & (YNameDefs::NameHashShardInitialSlots - 1)) == 0, "NameHashShardInitialSlots must be a power of two");
+
+	static FORCEINLINE FNameHashShard& GetShard(uint32 Hash)
+	{
+		return NameHashShards[Hash & (YNameDefs::NameHashShardCount - 1)];
+	}
+
+	static FORCEINLINE uint32 GetFirstSlot(const FNameSlotTable* Table, uint32 Hash)
+	{
+		// the low bits picked the shard, use the high bits of a multiplicative scramble for the slot
+		return (Hash * 0x9E3779B1u) >> Table->Shift;
+	}
+
+	static FORCEINLINE uint64 MakeSlot(uint32 Hash, int32 Index, ENameCase ComparisonMode)
+	{
+		const uint32 IndexAndCase = (uint32(Index + 1) << 1) | uint32(ComparisonMode == ENameCase::CaseSensitive);
+		return (uint64(IndexAndCase) << 32) | Hash;
+	}
+
+	static FORCEINLINE int32 GetSlotIndex(uint64 Slot)
+	{
+		return int32(Slot >> 33) - 1;
+	}
+
+	/** Reads a slot that may be written concurrently. A plain 64 bit load can tear on 32 bit targets. */
+	static FORCEINLINE uint64 LoadSlot(const FNameSlotTable* Table, uint32 SlotIndex)
+	{
+#if PLATFORM_64BITS
+		return Table->Slots[SlotIndex];
+#else
+		return (uint64)FPlatformAtomics::InterlockedCompareExchange((volatile int64*)&Table->Slots[SlotIndex], 0, 0);
+#endif
+	}
+
+	static FNameSlotTable* AllocateTable(uint32 NumSlots)
+	{
+		const SIZE_T Size = sizeof(FNameSlotTable) + (NumSlots - 1) * sizeof(uint64);
+		FNameSlotTable* Table = (FNameSlotTable*)YMemory::Malloc(Size);
+		YMemory::Memzero(Table, Size);
+		Table->Mask = NumSlots - 1;
+		Table->Shift = 32 - YMath::FloorLog2(NumSlots);
+		FPlatformAtomics::InterlockedAdd(&NameHashMemorySize, int32(Size));
+		return Table;
+	}
+
+	/** Stores the slot in the first free slot of its probe sequence. The table must not be full. */
+	static void InsertSlot(FNameSlotTable* Table, uint64 Slot)
+	{
+		uint32 SlotIndex = GetFirstSlot(Table, uint32(Slot));
+		while (Table->Slots[SlotIndex] >> 32)
+		{
+			SlotIndex = (SlotIndex + 1) & Table->Mask;
+		}
+		// lookups read the slot without the lock, so it must not be written in two halves
+		FPlatformAtomics::InterlockedExchange((volatile int64*)&Table->Slots[SlotIndex], (int64)Slot);
+	}
+
+	/**
+	 * Adds a slot to a shard, growing it when three quarters full. Probing compares hashes only, so it stays cheap at
+	 * that load. Must be called with the lock of the shard held.
+	 */
+	static void AddSlot(FNameHashShard& Shard, uint64 Slot)
+	{
+		FNameSlotTable* Table = Shard.Table;
+		if (uint32(Shard.NumUsed + 1) * 4 > (Table->Mask + 1) * 3)
+		{
+			FNameSlotTable* NewTable = AllocateTable((Table->Mask + 1) * 2);
+			for (uint32 SlotIndex = 0; SlotIndex <= Table->Mask; ++SlotIndex)
+			{
+				if (Table->Slots[SlotIndex] >> 32)
+				{
+					InsertSlot(NewTable, Table->Slots[SlotIndex]);
+				}
+			}
+			NewTable->Previous = Table;
+
+			// the new table must be filled in before lookups can find it
+			YPlatformMisc::MemoryBarrier();
+			Shard.Table = NewTable;
+			Table = NewTable;
+		}
+
+		// the name entry must be visible before lookups can find the slot
+		YPlatformMisc::MemoryBarrier();
+		InsertSlot(Table, Slot);
+		++Shard.NumUsed;
+	}
+
+	/** Finds a name in a table of the hash, without locking. Returns INDEX_NONE if it isn't there. */
+	template <typename TCharType>
+	static int32 FindSlot(const FNameSlotTable* Table, const TNameEntryArray& Names, const TCharType* InName, ENameCase ComparisonMode, uint32 Hash)
+	{
+		const uint64 CaseBit = uint64(ComparisonMode == ENameCase::CaseSensitive) << 32;
+		for (uint32 SlotIndex = GetFirstSlot(Table, Hash); ; SlotIndex = (SlotIndex + 1) & Table->Mask)
+		{
+			const uint64 Slot = LoadSlot(Table, SlotIndex);
+			if (!(Slot >> 32))
+			{
+				return INDEX_NONE;
+			}
+
+			// only names with the same full hash are compared
+			if ((Slot & (0xFFFFFFFFull | (1ull << 32))) == (Hash | CaseBit))
+			{
+				const int32 Index = GetSlotIndex(Slot);
+				if (Names[Index]->IsEqual(InName, ComparisonMode))
+				{
+					return Index;
+				}
+			}
+		}
+	}
+}
+
+
 /*-----------------------------------------------------------------------------
 	YName implementation.
 -----------------------------------------------------------------------------*/
@@ -458,30 +601,14 @@ YName::YName( const TCHAR* Name, int32 InNumber, EFindName FindType )
 
 YName::YName(const YNameEntrySerialized& LoadedEntry)
 {
-	if (LoadedEntry.bWereHashesLoaded)
+	// The serialized hashes only keep 16 bits, while the name hash compares full hashes, so they are not used
+	if (LoadedEntry.IsWide())
 	{
-		// Since the name table can change sizes we need to mask the raw hash to the current size so we don't access out of bounds
-		const uint16 NonCasePreservingHash = LoadedEntry.NonCasePreservingHash & (YNameDefs::NameHashBucketCount - 1);
-		const uint16 CasePreservingHash = LoadedEntry.CasePreservingHash & (YNameDefs::NameHashBucketCount - 1);
-		if (LoadedEntry.IsWide())
-		{
-			Init(LoadedEntry.GetWideName(), NAME_NO_NUMBER_INTERNAL, YName_Add, NonCasePreservingHash, CasePreservingHash);
-		}
-		else
-		{
-			Init(LoadedEntry.GetAnsiName(), NAME_NO_NUMBER_INTERNAL, YName_Add, NonCasePreservingHash, CasePreservingHash);
-		}
+		Init(LoadedEntry.GetWideName(), NAME_NO_NUMBER_INTERNAL, YName_Add, false);
 	}
 	else
 	{
-		if (LoadedEntry.IsWide())
-		{
-			Init(LoadedEntry.GetWideName(), NAME_NO_NUMBER_INTERNAL, YName_Add, false);
-		}
-		else
-		{
-			Init(LoadedEntry.GetAnsiName(), NAME_NO_NUMBER_INTERNAL, YName_Add, false);
-		}
+		Init(LoadedEntry.GetAnsiName(), NAME_NO_NUMBER_INTERNAL, YName_Add, false);
 	}
 }
 
@@ -531,15 +658,15 @@ int32 YName::Compare( const YName& Other ) const
 }
 
 template <typename TCharType>
-uint16 YName::GetCasePreservingHash(const TCharType* Source)
+uint32 YName::GetCasePreservingHash(const TCharType* Source)
 {
-	return GetRawCasePreservingHash(Source) & (YNameDefs::NameHashBucketCount - 1);
+	return GetRawCasePreservingHash(Source);
 }
 
 template <typename TCharType>
-uint16 YName::GetNonCasePreservingHash(const TCharType* Source)
+uint32 YName::GetNonCasePreservingHash(const TCharType* Source)
 {
-	return GetRawNonCasePreservingHash(Source) & (YNameDefs::NameHashBucketCount - 1);
+	return GetRawNonCasePreservingHash(Source);
 }
 
 void YName::Init(const WIDECHAR* InName, int32 InNumber, EFindName FindType, bool bSplitName, int32 HardcodeIndex)
@@ -556,22 +683,11 @@ void YName::Init(const WIDECHAR* InName, int32 InNumber, EFindName FindType, boo
 	}
 }
 
-void YName::Init(const WIDECHAR* InName, int32 InNumber, EFindName FindType, const uint16 NonCasePreservingHash, const uint16 CasePreservingHash)
-{
-	// Since this comes from the FLinkerLoad we know that it is not pure ansi
-	InitInternal<WIDECHAR>(InName, InNumber, FindType, -1, NonCasePreservingHash, CasePreservingHash);
-}
-
 void YName::Init(const ANSICHAR* InName, int32 InNumber, EFindName FindType, bool bSplitName, int32 HardcodeIndex)
 {
 	InitInternal_HashSplit<ANSICHAR>(InName, InNumber, FindType, bSplitName, HardcodeIndex);
 }
 
-void YName::Init(const ANSICHAR* InName, int32 InNumber, EFindName FindType, const uint16 NonCasePreservingHash, const uint16 CasePreservingHash)
-{
-	InitInternal<ANSICHAR>(InName, InNumber, FindType, -1, NonCasePreservingHash, CasePreservingHash);
-}
-
 template <typename TCharType>
 void YName::InitInternal_HashSplit(const TCharType* InName, int32 InNumber, const EFindName FindType, bool bSplitName, const int32 HardcodeIndex)
 {
@@ -588,17 +704,13 @@ void YName::InitInternal_HashSplit(const TCharType* InName, int32 InNumber, cons
 		}
 	}
 	// Hash value of string after splitting
-	const uint16 NonCasePreservingHash = GetNonCasePreservingHash(InName);
-#if WITH_CASE_PRESERVING_NAME
-	const uint16 CasePreservingHash = GetCasePreservingHash(InName);
-#else
-	const uint16 CasePreservingHash = 0;
-#endif
-	InitInternal<TCharType>(InName, InNumber, FindType, HardcodeIndex, NonCasePreservingHash, CasePreservingHash);
+	// The case preserving hash is only needed to add a case variant, so it is left to InitInternal_FindOrAdd
+	const uint32 NonCasePreservingHash = GetNonCasePreservingHash(InName);
+	InitInternal<TCharType>(InName, InNumber, FindType, HardcodeIndex, NonCasePreservingHash);
 }
 
 template <typename TCharType>
-void YName::InitInternal(const TCharType* InName, int32 InNumber, const EFindName FindType, const int32 HardcodeIndex, const uint16 NonCasePreservingHash, const uint16 CasePreservingHash)
+void YName::InitInternal(const TCharType* InName, int32 InNumber, const EFindName FindType, const int32 HardcodeIndex, const uint32 NonCasePreservingHash)
 {
 	check(TCString<TCharType>::Strlen(InName)<=NAME_SIZE);
 
@@ -632,11 +744,11 @@ void YName::InitInternal(const TCharType* InName, int32 InNumber, const EFindNam
 	const bool bIsPureAnsi = TCString<TCharType>::IsPureAnsi(InName);
 	if(bIsPureAnsi)
 	{
-		bWasFoundOrAdded = InitInternal_FindOrAdd<ANSICHAR>(StringCast<ANSICHAR>(InName).Get(), FindType, HardcodeIndex, NonCasePreservingHash, CasePreservingHash, OutComparisonIndex, OutDisplayIndex);
+		bWasFoundOrAdded = InitInternal_FindOrAdd<ANSICHAR>(StringCast<ANSICHAR>(InName).Get(), FindType, HardcodeIndex, NonCasePreservingHash, OutComparisonIndex, OutDisplayIndex);
 	}
 	else
 	{
-		bWasFoundOrAdded = InitInternal_FindOrAdd<WIDECHAR>(StringCast<WIDECHAR>(InName).Get(), FindType, HardcodeIndex, NonCasePreservingHash, CasePreservingHash, OutComparisonIndex, OutDisplayIndex);
+		bWasFoundOrAdded = InitInternal_FindOrAdd<WIDECHAR>(StringCast<WIDECHAR>(InName).Get(), FindType, HardcodeIndex, NonCasePreservingHash, OutComparisonIndex, OutDisplayIndex);
 	}
 
 	if(bWasFoundOrAdded)
@@ -660,11 +772,11 @@ void YName::InitInternal(const TCharType* InName, int32 InNumber, const EFindNam
 template <typename TCharType> void IncrementNameCount();
 template <> void IncrementNameCount<ANSICHAR>()
 {
-	YName::NumAnsiNames++;
+	FPlatformAtomics::InterlockedIncrement(&YName::NumAnsiNames);
 }
 template <> void IncrementNameCount<WIDECHAR>()
 {
-	YName::NumWideNames++;
+	FPlatformAtomics::InterlockedIncrement(&YName::NumWideNames);
 }
 
 template <typename TCharType>
@@ -747,7 +859,7 @@ struct YNameInitHelper<WIDECHAR>
 };
 
 template <typename TCharType>
-bool YName::InitInternal_FindOrAdd(const TCharType* InName, const EFindName FindType, const int32 HardcodeIndex, const uint16 NonCasePreservingHash, const uint16 CasePreservingHash, int32& OutComparisonIndex, int32& OutDisplayIndex)
+bool YName::InitInternal_FindOrAdd(const TCharType* InName, const EFindName FindType, const int32 HardcodeIndex, const uint32 NonCasePreservingHash, int32& OutComparisonIndex, int32& OutDisplayIndex)
 {
 	const bool bWasFoundOrAdded = InitInternal_FindOrAddNameEntry<TCharType>(InName, FindType, ENameCase::IgnoreCase, NonCasePreservingHash, OutComparisonIndex);
 	
@@ -760,7 +872,7 @@ bool YName::InitInternal_FindOrAdd(const TCharType* InName, const EFindName Find
 		// If the string we got back doesn't match the case of the string we provided, also add a case variant version for display purposes
 		if(TCString<TCharType>::Strcmp(InName, YNameInitHelper<TCharType>::GetNameString(NameEntry)) != 0)
 		{
-			if(!InitInternal_FindOrAddNameEntry<TCharType>(InName, FindType, ENameCase::CaseSensitive, CasePreservingHash, OutDisplayIndex))
+			if(!InitInternal_FindOrAddNameEntry<TCharType>(InName, FindType, ENameCase::CaseSensitive, GetCasePreservingHash(InName), OutDisplayIndex))
 			{
 				// We don't consider failing to find/add the case variant a full failure
 				OutDisplayIndex = OutComparisonIndex;
@@ -781,38 +893,38 @@ bool YName::InitInternal_FindOrAdd(const TCharType* InName, const EFindName Find
 }
 
 template <typename TCharType>
-bool YName::InitInternal_FindOrAddNameEntry(const TCharType* InName, const EFindName FindType, const ENameCase ComparisonMode, const uint16 iHash, int32& OutIndex)
+bool YName::InitInternal_FindOrAddNameEntry(const TCharType* InName, const EFindName FindType, const ENameCase ComparisonMode, const uint32 Hash, int32& OutIndex)
 {
+	using namespace UE4Names_Private;
+
 	CallNameCreationHook();
+	TNameEntryArray& Names = GetNames();
+	FNameHashShard& Shard = GetShard(Hash);
 	if (OutIndex < 0)
 	{
 		// Try to find the name in the hash.
-		for( YNameEntry* Hash=NameHashHead[iHash]; Hash; Hash=Hash->HashNext )
+		const int32 FoundIndex = FindSlot(Shard.Table, Names, InName, ComparisonMode, Hash);
+		if (FoundIndex != INDEX_NONE)
 		{
-			YPlatformMisc::Prefetch( Hash->HashNext );
-			// Compare the passed in string
-			if( Hash->IsEqual( InName, ComparisonMode ) )
+			// Found it in the hash.
+			OutIndex = FoundIndex;
+
+			// Check to see if the caller wants to replace the contents of the
+			// YName with the specified value. This is useful for compiling
+			// script classes where the file name is lower case but the class
+			// was intended to be uppercase.
+			if (FindType == YName_Replace_Not_Safe_For_Threading)
 			{
-				// Found it in the hash.
-				OutIndex = Hash->GetIndex();
-
-				// Check to see if the caller wants to replace the contents of the
-				// YName with the specified value. This is useful for compiling
-				// script classes where the file name is lower case but the class
-				// was intended to be uppercase.
-				if (FindType == YName_Replace_Not_Safe_For_Threading)
-				{
-					check(IsInGameThread());
+				check(IsInGameThread());
+				YNameEntry* const NameEntry = const_cast<YNameEntry*>(Names[OutIndex]);
 
-					// This *must* be true, or we'll overwrite memory when the
-					// copy happens if it is longer
-					check(TCString<TCharType>::Strlen(InName) == Hash->GetNameLength());
+				// This *must* be true, or we'll overwrite memory when the
+				// copy happens if it is longer
+				check(TCString<TCharType>::Strlen(InName) == NameEntry->GetNameLength());
 
-					YNameInitHelper<TCharType>::SetNameString(Hash, InName);
-				}
-				check(OutIndex >= 0);
-				return true;
+				YNameInitHelper<TCharType>::SetNameString(NameEntry, InName);
 			}
+			return true;
 		}
 
 		// Didn't find name.
@@ -822,28 +934,19 @@ bool YName::InitInternal_FindOrAddNameEntry(const TCharType* InName, const EFind
 			return false;
 		}
 	}
-	// acquire the lock
-	FScopeLock ScopeLock(GetCriticalSection());
+	// acquire the lock of the shard, names of other shards can be added meanwhile
+	FScopeLock ScopeLock(&Shard.Lock);
 	if (OutIndex < 0)
 	{
 		// Try to find the name in the hash. AGAIN...we might have been adding from a different thread and we just missed it
-		for( YNameEntry* Hash=NameHashHead[iHash]; Hash; Hash=Hash->HashNext )
+		const int32 FoundIndex = FindSlot(Shard.Table, Names, InName, ComparisonMode, Hash);
+		if (FoundIndex != INDEX_NONE)
 		{
-			// Compare the passed in string
-			if( Hash->IsEqual( InName, ComparisonMode ) )
-			{
-				// Found it in the hash.
-				OutIndex = Hash->GetIndex();
-				check(FindType == YName_Add);  // if this was a replace, well it isn't safe for threading. Find should have already been handled
-				return true;
-			}
+			// Found it in the hash.
+			OutIndex = FoundIndex;
+			check(FindType == YName_Add);  // if this was a replace, well it isn't safe for threading. Find should have already been handled
+			return true;
 		}
-	}
-	YNameEntry* OldHashHead=NameHashHead[iHash];
-	YNameEntry* OldHashTail=NameHashTail[iHash];
-	TNameEntryArray& Names = GetNames();
-	if (OutIndex < 0)
-	{
 		OutIndex = Names.AddZeroed(1);
 	}
 	else
@@ -855,28 +958,7 @@ bool YName::InitInternal_FindOrAddNameEntry(const TCharType* InName, const EFind
 	{
 		UE_LOG(LogUnrealNames, Fatal, TEXT("Hardcoded name '%s' at index %i was duplicated (or unexpected concurrency). Existing entry is '%s'."), *NewEntry->GetPlainNameString(), NewEntry->GetIndex(), *Names[OutIndex]->GetPlainNameString() );
 	}
-	if (!OldHashHead)
-	{
-		checkSlow(!OldHashTail);
-
-		// atomically assign the new head as other threads may be reading it
-		if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&NameHashHead[iHash], NewEntry, OldHashHead) != OldHashHead) // we use an atomic operation to check for unexpected concurrency, verify alignment, etc
-		{
-			check(0); // someone changed this while we were changing it
-		}
-		NameHashTail[iHash] = NewEntry; // We can non-atomically assign the tail since it's only ever read while locked
-	}
-	else
-	{
-		checkSlow(OldHashTail);
-
-		// atomically update the linked list as other threads may be reading it
-		if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&OldHashTail->HashNext, NewEntry, nullptr) != nullptr) // we use an atomic operation to check for unexpected concurrency, verify alignment, etc
-		{
-			check(0); // someone changed this while we were changing it
-		}
-		NameHashTail[iHash] = NewEntry; // We can non-atomically assign the tail since it's only ever read while locked
-	}
+	AddSlot(Shard, MakeSlot(Hash, OutIndex, ComparisonMode));
 	check(OutIndex >= 0);
 	return true;
 }
@@ -935,23 +1017,25 @@ void YName::StaticInit()
 	FCrc::Init();
 
 	check(GetIsInitialized() == false);
-	check((YNameDefs::NameHashBucketCount&(YNameDefs::NameHashBucketCount-1)) == 0);
 	GetIsInitialized() = 1;
 
 	// Init the name hash.
-	for (int32 HashIndex = 0; HashIndex < YNameDefs::NameHashBucketCount; HashIndex++)
-	{
-		NameHashHead[HashIndex] = nullptr;
-		NameHashTail[HashIndex] = nullptr;
-	}
-
 	{
-		FScopeLock ScopeLock(GetCriticalSection());
+		using namespace UE4Names_Private;
 
-		TNameEntryArray& Names = GetNames();
-		Names.AddZeroed(NAME_MaxHardcodedNameIndex + 1);
+		NameHashShards = (FNameHashShard*)YMemory::Malloc(sizeof(FNameHashShard) * YNameDefs::NameHashShardCount, ALIGNOF(FNameHashShard));
+		for (uint32 ShardIndex = 0; ShardIndex < YNameDefs::NameHashShardCount; ShardIndex++)
+		{
+			FNameHashShard* Shard = new(NameHashShards + ShardIndex) FNameHashShard();
+			Shard->Table = AllocateTable(YNameDefs::NameHashShardInitialSlots);
+			Shard->NumUsed = 0;
+		}
+		FPlatformAtomics::InterlockedAdd(&NameHashMemorySize, int32(sizeof(FNameHashShard) * YNameDefs::NameHashShardCount));
 	}
 
+	TNameEntryArray& Names = GetNames();
+	Names.AddZeroed(NAME_MaxHardcodedNameIndex + 1);
+
 	{
 		// Register all hardcoded names.
 		#define REGISTER_NAME(num,namestr) YName Temp_##namestr(EName(num), TEXT(#namestr));
@@ -960,26 +1044,33 @@ void YName::StaticInit()
 	}
 
 #if DO_CHECK
-	// Verify no duplicate names.
-	for (int32 HashIndex = 0; HashIndex < YNameDefs::NameHashBucketCount; HashIndex++)
+	// Verify no duplicate names. Hardcoded names are added without a lookup, so a duplicate is found under the index of the first one.
+	for (int32 NameIndex = 0; NameIndex < Names.Num(); NameIndex++)
 	{
-		for (YNameEntry* Hash = NameHashHead[HashIndex]; Hash; Hash = Hash->HashNext)
+		if (const YNameEntry* Hash = Names[NameIndex])
 		{
-			for (YNameEntry* Other = Hash->HashNext; Other; Other = Other->HashNext)
+			int32 FoundIndex = INDEX_NONE;
+			if (Hash->IsWide())
+			{
+				InitInternal_FindOrAddNameEntry<WIDECHAR>(Hash->GetWideName(), YName_Find, ENameCase::IgnoreCase, GetNonCasePreservingHash(Hash->GetWideName()), FoundIndex);
+			}
+			else
+			{
+				InitInternal_FindOrAddNameEntry<ANSICHAR>(Hash->GetAnsiName(), YName_Find, ENameCase::IgnoreCase, GetNonCasePreservingHash(Hash->GetAnsiName()), FoundIndex);
+			}
+
+			if (FoundIndex != NameIndex)
 			{
-				if (FCString::Stricmp(*Hash->GetPlainNameString(), *Other->GetPlainNameString()) == 0)
+				// we can't print out here because there may be no log yet if this happens before main starts
+				if (YPlatformMisc::IsDebuggerPresent())
 				{
-					// we can't print out here because there may be no log yet if this happens before main starts
-					if (YPlatformMisc::IsDebuggerPresent())
-					{
-						YPlatformMisc::DebugBreak();
-					}
-					else
-					{
-						YPlatformMisc::PromptForRemoteDebugging(false);
-						FMessageDialog::Open(EAppMsgType::Ok, FText::Format( NSLOCTEXT("UnrealEd", "DuplicatedHardcodedName", "Duplicate hardcoded name: {0}"), FText::FromString( Hash->GetPlainNameString() ) ) );
-						YPlatformMisc::RequestExit(false);
-					}
+					YPlatformMisc::DebugBreak();
+				}
+				else
+				{
+					YPlatformMisc::PromptForRemoteDebugging(false);
+					FMessageDialog::Open(EAppMsgType::Ok, FText::Format( NSLOCTEXT("UnrealEd", "DuplicatedHardcodedName", "Duplicate hardcoded name: {0}"), FText::FromString( Hash->GetPlainNameString() ) ) );
+					YPlatformMisc::RequestExit(false);
 				}
 			}
 		}
@@ -1008,20 +1099,37 @@ bool& YName::GetIsInitialized()
 	return bIsInitialized;
 }
 
+int32 YName::GetNameTableMemorySize()
+{
+	return GetNameEntryMemorySize() + (GetMaxNames() * sizeof(YNameEntry*)) + UE4Names_Private::NameHashMemorySize;
+}
+
 void YName::DisplayHash( YOutputDevice& Ar )
 {
-	int32 UsedBins=0, NameCount=0, MemUsed = 0;
-	for( int32 i=0; i<YNameDefs::NameHashBucketCount; i++ )
+	using namespace UE4Names_Private;
+
+	int32 NameCount=0, SlotCount=0, LongestProbe=0, MemUsed = 0;
+	TNameEntryArray& Names = GetNames();
+	for( uint32 ShardIndex=0; ShardIndex<YNameDefs::NameHashShardCount; ShardIndex++ )
 	{
-		if( NameHashHead[i] != NULL ) UsedBins++;
-		for( YNameEntry *Hash = NameHashHead[i]; Hash; Hash=Hash->HashNext )
+		FNameHashShard& Shard = NameHashShards[ShardIndex];
+		FScopeLock ScopeLock(&Shard.Lock);
+		const FNameSlotTable* Table = Shard.Table;
+		SlotCount += Table->Mask + 1;
+		for( uint32 SlotIndex=0; SlotIndex<=Table->Mask; SlotIndex++ )
 		{
-			NameCount++;
-			// Count how much memory this entry is using
-			MemUsed += YNameEntry::GetSize( Hash->GetNameLength(), Hash->IsWide() );
+			const uint64 Slot = Table->Slots[SlotIndex];
+			if( Slot >> 32 )
+			{
+				NameCount++;
+				// Count how much memory this entry is using
+				const YNameEntry* Hash = Names[GetSlotIndex(Slot)];
+				MemUsed += YNameEntry::GetSize( Hash->GetNameLength(), !Hash->IsWide() );
+				LongestProbe = YMath::Max<int32>( LongestProbe, ((SlotIndex - GetFirstSlot(Table, uint32(Slot))) & Table->Mask) + 1 );
+			}
 		}
 	}
-	Ar.Logf( TEXT("Hash: %i names, %i/%i hash bins, Mem in bytes %i"), NameCount, UsedBins, YNameDefs::NameHashBucketCount, MemUsed);
+	Ar.Logf( TEXT("Hash: %i names, %i shards, %i slots, longest probe %i, Mem in bytes %i"), NameCount, YNameDefs::NameHashShardCount, SlotCount, LongestProbe, MemUsed);
 }
 
 bool YName::SplitNameWithCheck(const WIDECHAR* OldName, WIDECHAR* NewName, int32 NewNameLen, int32& NewNumber)
@@ -1253,6 +1361,7 @@ YArchive& operator<<(YArchive& Ar, YNameEntrySerialized& E)
  * never go away. It simply uses 64K chunks and allocates new ones as space runs out. This reduces
  * allocation overhead significantly (only minor waste on 64k boundaries) and also greatly helps
  * with fragmentation as 50-100k allocations turn into tens of allocations.
+ * Names of different hash shards are added concurrently, so allocations bump the pool atomically.
  */
 class YNameEntryPoolAllocator
 {
@@ -1261,9 +1370,7 @@ public:
 	YNameEntryPoolAllocator()
 	{
 		TotalAllocatedPages	= 0;
-		CurrentPoolStart	= NULL;
-		CurrentPoolEnd		= NULL;
-		check(ThreadGuard.GetValue() == 0);
+		CurrentPool			= NULL;
 	}
 
 	/**
@@ -1274,23 +1381,28 @@ public:
 	 */
 	YNameEntry* Allocate( int32 Size )
 	{
-		check(ThreadGuard.Increment() == 1);
 		// Some platforms need all of the name entries to be aligned to 4 bytes, so by
 		// aligning the size here the next allocation will be aligned to 4
 		Size = Align( Size, ALIGNOF(YNameEntry) );
+		check( Size <= PoolSize() - PoolHeaderSize );
 
-		// Allocate a new pool if current one is exhausted. We don't worry about a little bit
-		// of waste at the end given the relative size of pool to average and max allocation.
-		if( CurrentPoolEnd - CurrentPoolStart < Size )
+		for (;;)
 		{
-			AllocateNewPool();
+			FPool* Pool = CurrentPool;
+			if( Pool )
+			{
+				// Take our bytes of the current pool. Past its end, the bytes are only wasted.
+				const int32 Offset = FPlatformAtomics::InterlockedAdd( &Pool->Used, Size );
+				if( Offset + Size <= PoolSize() - PoolHeaderSize )
+				{
+					return (YNameEntry*)( (uint8*)Pool + PoolHeaderSize + Offset );
+				}
+			}
+
+			// Allocate a new pool if current one is exhausted. We don't worry about a little bit
+			// of waste at the end given the relative size of pool to average and max allocation.
+			AllocateNewPool( Pool );
 		}
-		check( CurrentPoolEnd - CurrentPoolStart >= Size );
-		// Return current pool start as allocation and increment by size.
-		YNameEntry* NameEntry = (YNameEntry*) CurrentPoolStart;
-		CurrentPoolStart += Size;
-		check(ThreadGuard.Decrement() == 0);
-		return NameEntry;
 	}
 
 	/**
@@ -1315,22 +1427,35 @@ public:
 	}
 
 private:
-	/** Allocates a new pool. */
-	void AllocateNewPool()
+	/** Header of a pool, followed by the name entries */
+	struct FPool
+	{
+		/** Number of bytes handed out, or more once the pool is exhausted */
+		volatile int32 Used;
+	};
+
+	/** Size of the pool header, keeping the name entries aligned */
+	enum { PoolHeaderSize = 16 };
+
+	/** Allocates a new pool, unless another thread already replaced the exhausted one. */
+	void AllocateNewPool( FPool* ExhaustedPool )
 	{
-		TotalAllocatedPages++;
-		CurrentPoolStart = (uint8*) YMemory::Malloc(PoolSize());
-		CurrentPoolEnd = CurrentPoolStart + PoolSize();
+		FPool* NewPool = (FPool*) YMemory::Malloc(PoolSize());
+		NewPool->Used = 0;
+		if( FPlatformAtomics::InterlockedCompareExchangePointer( (void**)&CurrentPool, NewPool, ExhaustedPool ) == ExhaustedPool )
+		{
+			FPlatformAtomics::InterlockedIncrement( &TotalAllocatedPages );
+		}
+		else
+		{
+			YMemory::Free( NewPool );
+		}
 	}
 
-	/** Beginning of pool. Allocated by AllocateNewPool, incremented by Allocate.	*/
-	uint8* CurrentPoolStart;
-	/** End of current pool. Set by AllocateNewPool and checked by Allocate.		*/
-	uint8* CurrentPoolEnd;
+	/** Pool being allocated from. Set by AllocateNewPool and bumped by Allocate.	*/
+	FPool* volatile CurrentPool;
 	/** Total number of pages that have been allocated.								*/
-	int32 TotalAllocatedPages;
-	/** Threadsafe counter to test for unwanted concurrency							*/
-	FThreadSafeCounter ThreadGuard;
+	volatile int32 TotalAllocatedPages;
 };
 
 /** Global allocator for name entries. */
@@ -1342,9 +1467,8 @@ YNameEntry* AllocateNameEntry(const void* Name, NAME_INDEX Index)
 	const SIZE_T NameLen  = TCString<TCharType>::Strlen((TCharType*)Name);
 	int32 NameEntrySize	  = YNameInitHelper<TCharType>::GetSize( NameLen );
 	YNameEntry* NameEntry = GNameEntryPoolAllocator.Allocate( NameEntrySize );
-	YName::NameEntryMemorySize += NameEntrySize;
+	FPlatformAtomics::InterlockedAdd(&YName::NameEntryMemorySize, NameEntrySize);
 	NameEntry->Index      = (Index << NAME_INDEX_SHIFT) | (YNameInitHelper<TCharType>::GetIndexShiftValue());
-	NameEntry->HashNext   = nullptr;
 	YNameInitHelper<TCharType>::SetNameString(NameEntry, (TCharType*)Name, NameLen);
 	IncrementNameCount<TCharType>();
 	return NameEntry;
@@ -1468,3 +1592,194 @@ void CallNameCreationHook()
 
 #endif
 
+
+#if !UE_BUILD_SHIPPING
+
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+
+namespace NameTableBenchmark
+{
+	/** Waits for all the workers to be ready, then runs the body */
+	class FWorker : public FRunnable
+	{
+	public:
+		FWorker(TFunction<void()>&& InBody, volatile int32& InNumReady, volatile int32& InGo)
+			: Body(MoveTemp(InBody))
+			, NumReady(InNumReady)
+			, Go(InGo)
+		{
+		}
+
+		virtual uint32 Run() override
+		{
+			FPlatformAtomics::InterlockedIncrement(&NumReady);
+			while (!Go)
+			{
+				FPlatformProcess::Sleep(0.0f);
+			}
+			Body();
+			return 0;
+		}
+
+	private:
+		TFunction<void()> Body;
+		volatile int32& NumReady;
+		volatile int32& Go;
+	};
+
+	/** Runs the body on NumThreads threads at once, passing each its thread index, and returns how long they took */
+	static double RunThreads(int32 NumThreads, TFunction<void(int32)> Body)
+	{
+		volatile int32 NumReady = 0;
+		volatile int32 Go = 0;
+		TArray<FWorker*> Workers;
+		TArray<FRunnableThread*> Threads;
+
+		for (int32 ThreadIndex = 0; ThreadIndex < NumThreads; ++ThreadIndex)
+		{
+			Workers.Add(new FWorker([&Body, ThreadIndex]() { Body(ThreadIndex); }, NumReady, Go));
+			Threads.Add(FRunnableThread::Create(Workers.Last(), *YString::Printf(TEXT("NameBench%d"), ThreadIndex)));
+			check(Threads.Last());
+		}
+		while (NumReady < NumThreads)
+		{
+			FPlatformProcess::Sleep(0.0f);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		FPlatformAtomics::InterlockedExchange(&Go, 1);
+		for (FRunnableThread* Thread : Threads)
+		{
+			Thread->WaitForCompletion();
+		}
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+		for (FRunnableThread* Thread : Threads)
+		{
+			delete Thread;
+		}
+		for (FWorker* Worker : Workers)
+		{
+			delete Worker;
+		}
+		return Seconds;
+	}
+
+	/** Appends a number in letters, so that names never get a number split off */
+	static ANSICHAR* AppendLetters(ANSICHAR* Out, uint32 Value)
+	{
+		do
+		{
+			*Out++ = 'a' + Value % 26;
+			Value /= 26;
+		}
+		while (Value);
+		return Out;
+	}
+
+	/** Builds the name of the given index for a run of the benchmark, or one that is never added if bMiss */
+	static const ANSICHAR* MakeName(ANSICHAR (&Buffer)[64], uint32 Run, uint32 Index, bool bMiss)
+	{
+		FCStringAnsi::Strcpy(Buffer, bMiss ? "NameBenchMiss_" : "NameBench_");
+		ANSICHAR* Out = AppendLetters(Buffer + FCStringAnsi::Strlen(Buffer), Run);
+		*Out++ = '_';
+		*AppendLetters(Out, Index) = 0;
+		return Buffer;
+	}
+
+	static void LogResult(const TCHAR* Operation, int32 NumThreads, int32 NumNames, double Seconds, int32 NumErrors)
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("  %-12s %2d threads %8.2f Mnames/s %8.1f ns/name/thread%s"), Operation, NumThreads,
+			NumNames / Seconds / 1e6, Seconds * 1e9 * NumThreads / NumNames, NumErrors ? TEXT("  INVALID RESULT") : TEXT(""));
+	}
+}
+
+static void NameTableBenchmarkCommand(const TArray<YString>& Args)
+{
+	using namespace NameTableBenchmark;
+
+	const int32 NumThreads = Args.Num() > 0 ? YMath::Clamp(FCString::Atoi(*Args[0]), 1, 64) : 8;
+	const int32 NumNames = Args.Num() > 1 ? YMath::Max(NumThreads, FCString::Atoi(*Args[1])) : 1000000;
+	if (YName::GetMaxNames() + NumNames > YNameDefs::MaxNames)
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("The name table holds %d names and can't take %d more"), YName::GetMaxNames(), NumNames);
+		return;
+	}
+
+	// every run adds names of its own, since names are never freed
+	static volatile int32 NumRuns = 0;
+	const uint32 Run = FPlatformAtomics::InterlockedIncrement(&NumRuns);
+
+	UE_LOG(LogConsoleResponse, Display, TEXT("%d names on %d threads, the name table holds %d names"), NumNames, NumThreads, YName::GetMaxNames());
+
+	TArray<NAME_INDEX> Indices;
+	Indices.AddUninitialized(NumNames);
+	const int32 NamesPerThread = NumNames / NumThreads;
+	auto GetFirstName = [NamesPerThread](int32 ThreadIndex) { return ThreadIndex * NamesPerThread; };
+	auto GetLastName = [NamesPerThread, NumThreads, NumNames](int32 ThreadIndex) { return ThreadIndex == NumThreads - 1 ? NumNames : (ThreadIndex + 1) * NamesPerThread; };
+	volatile int32 NumErrors = 0;
+
+	double Seconds = RunThreads(NumThreads, [&](int32 ThreadIndex)
+	{
+		ANSICHAR Buffer[64];
+		for (int32 NameIndex = GetFirstName(ThreadIndex); NameIndex < GetLastName(ThreadIndex); ++NameIndex)
+		{
+			Indices[NameIndex] = YName(MakeName(Buffer, Run, NameIndex, false), YName_Add).GetComparisonIndex();
+		}
+	});
+	LogResult(TEXT("Add"), NumThreads, NumNames, Seconds, 0);
+
+	// look up the names another thread added, backwards
+	Seconds = RunThreads(NumThreads, [&](int32 ThreadIndex)
+	{
+		ANSICHAR Buffer[64];
+		const int32 OtherIndex = (ThreadIndex + 1) % NumThreads;
+		int32 LocalErrors = 0;
+		for (int32 NameIndex = GetLastName(OtherIndex) - 1; NameIndex >= GetFirstName(OtherIndex); --NameIndex)
+		{
+			LocalErrors += YName(MakeName(Buffer, Run, NameIndex, false), YName_Find).GetComparisonIndex() != Indices[NameIndex];
+		}
+		FPlatformAtomics::InterlockedAdd(&NumErrors, LocalErrors);
+	});
+	LogResult(TEXT("Find"), NumThreads, NumNames, Seconds, NumErrors);
+
+	Seconds = RunThreads(NumThreads, [&](int32 ThreadIndex)
+	{
+		ANSICHAR Buffer[64];
+		int32 LocalErrors = 0;
+		for (int32 NameIndex = GetFirstName(ThreadIndex); NameIndex < GetLastName(ThreadIndex); ++NameIndex)
+		{
+			LocalErrors += !YName(MakeName(Buffer, Run, NameIndex, true), YName_Find).IsNone();
+		}
+		FPlatformAtomics::InterlockedAdd(&NumErrors, LocalErrors);
+	});
+	LogResult(TEXT("Find missing"), NumThreads, NumNames, Seconds, NumErrors);
+
+	// adding names that exist only looks them up, from all threads at once
+	Seconds = RunThreads(NumThreads, [&](int32 ThreadIndex)
+	{
+		ANSICHAR Buffer[64];
+		int32 LocalErrors = 0;
+		for (int32 NameIndex = GetFirstName(ThreadIndex); NameIndex < GetLastName(ThreadIndex); ++NameIndex)
+		{
+			LocalErrors += YName(MakeName(Buffer, Run, NameIndex, false), YName_Add).GetComparisonIndex() != Indices[NameIndex];
+		}
+		FPlatformAtomics::InterlockedAdd(&NumErrors, LocalErrors);
+	});
+	LogResult(TEXT("Add existing"), NumThreads, NumNames, Seconds, NumErrors);
+
+	UE_LOG(LogConsoleResponse, Display, TEXT("  Name table memory %d KB"), YName::GetNameTableMemorySize() / 1024);
+	YName::DisplayHash(*GLog);
+}
+
+static FAutoConsoleCommand NameTableBenchmarkCmd(
+	TEXT("Names.Benchmark"),
+	TEXT("Measures adding and looking up names from many threads at once. The names it adds stay in the name table.\n")
+	TEXT("Usage: Names.Benchmark [NumThreads=8] [NumNames=1000000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&NameTableBenchmarkCommand)
+	);
+
+#endif // !UE_BUILD_SHIPPING
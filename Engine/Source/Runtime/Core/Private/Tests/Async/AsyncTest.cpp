@@ -12,6 +12,9 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncThreadedTaskTest, "System.Core.Async.Asyn
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncThreadedPoolTest, "System.Core.Async.Async (Thread Pool)", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncVoidTaskTest, "System.Core.Async.Async (Void)", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncCompletionCallbackTest, "System.Core.Async.Async (Completion Callback)", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncContinuationTest, "System.Core.Async.Async (Continuations)", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncWhenAllTest, "System.Core.Async.Async (WhenAll)", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncWhenAnyTest, "System.Core.Async.Async (WhenAny)", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
 
 
 /** Helper methods used in the test cases. */
@@ -95,4 +98,151 @@ bool FAsyncCompletionCallbackTest::RunTest(const YString& Parameters)
 	return true;
 }
 
+
+/** Test that continuations run once the result is set, on every executor, and chain. */
+bool FAsyncContinuationTest::RunTest(const YString& Parameters)
+{
+	// continuations added before the result is set run when it is set
+	{
+		TPromise<int> Promise;
+		TFuture<int> Future = Promise.GetFuture().Next([](int Value) { return Value * 2; }, FInlineExecutor());
+		TestFalse(TEXT("A continuation must not run before the result is set"), Future.IsReady());
+		Promise.SetValue(21);
+		TestTrue(TEXT("An inline continuation must run when the result is set"), Future.IsReady());
+		TestEqual(TEXT("An inline continuation must get the result"), Future.Get(), 42);
+	}
+
+	// continuations added after the result is set run right away
+	{
+		TPromise<int> Promise;
+		TFuture<int> Future = Promise.GetFuture();
+		Promise.SetValue(1);
+		TFuture<int> Continued = Future.Then([](TFuture<int> Self) { return Self.Get() + 1; }, FInlineExecutor());
+		TestFalse(TEXT("Then must consume the future"), Future.IsValid());
+		TestTrue(TEXT("A continuation of a completed future must run right away"), Continued.IsReady());
+		TestEqual(TEXT("A continuation of a completed future must get the result"), Continued.Get(), 2);
+	}
+
+	// chains across the task graph and the thread pool
+	{
+		TFuture<int> Future = Async(EAsyncExecution::TaskGraph, AsyncTestUtils::Task)
+			.Next([](int Value) { return Value + 1; })
+			.Next([](int Value) { return Value * 2; }, FThreadPoolExecutor())
+			.Then([](TFuture<int> Self) { return Self.Get() - 1; });
+		TestEqual(TEXT("Chained continuations must run in order"), Future.Get(), 247);
+	}
+
+	// void results
+	{
+		TPromise<void> Promise;
+		bool bRan = false;
+		TFuture<void> Future = Promise.GetFuture().Next([&bRan]() { bRan = true; }, FInlineExecutor());
+		Promise.SetValue();
+		Future.Get();
+		TestTrue(TEXT("Continuations of void futures must run"), bRan);
+	}
+
+	// shared futures stay valid and can be continued and copied any number of times
+	{
+		TPromise<int> Promise;
+		TSharedFuture<int> Shared = Promise.GetFuture().Share();
+		TSharedFuture<int> Copy = Shared;
+		TFuture<int> First = Shared.Next([](int Value) { return Value + 1; }, FInlineExecutor());
+		TFuture<int> Second = Copy.Then([](TSharedFuture<int> Self) { return Self.Get() + 2; }, FInlineExecutor());
+		Promise.SetValue(10);
+		TestTrue(TEXT("Continuing a shared future must leave it valid"), Shared.IsValid() && Copy.IsValid());
+		TestEqual(TEXT("Every continuation of a shared future must get the result"), First.Get() + Second.Get(), 23);
+		TestEqual(TEXT("Copies of a shared future must share the result"), Copy.Get(), 10);
+
+		TPromise<void> VoidPromise;
+		TSharedFuture<void> VoidShared = VoidPromise.GetFuture().Share();
+		TSharedFuture<void> VoidCopy;
+		VoidCopy = VoidShared;
+		VoidPromise.SetValue();
+		TestTrue(TEXT("Copies of a shared void future must share the result"), VoidCopy.IsReady());
+	}
+
+	return true;
+}
+
+
+/** Test that WhenAll is set once, and only once, all of its futures are ready. */
+bool FAsyncWhenAllTest::RunTest(const YString& Parameters)
+{
+	{
+		TArray<TPromise<int>> Promises;
+		Promises.SetNum(3);
+		TArray<TSharedFuture<int>> Futures;
+		for (TPromise<int>& Promise : Promises)
+		{
+			Futures.Add(Promise.GetFuture().Share());
+		}
+
+		TFuture<int> Sum = WhenAll(Futures).Next([Futures]()
+		{
+			int Result = 0;
+			for (const TSharedFuture<int>& Future : Futures)
+			{
+				Result += Future.Get();
+			}
+			return Result;
+		}, FInlineExecutor());
+
+		Promises[2].SetValue(3);
+		Promises[0].SetValue(1);
+		TestFalse(TEXT("WhenAll must wait for every future"), Sum.IsReady());
+		Promises[1].SetValue(2);
+		TestTrue(TEXT("WhenAll must be set once every future is ready"), Sum.IsReady());
+		TestEqual(TEXT("The futures of WhenAll must be readable from its continuation"), Sum.Get(), 6);
+	}
+
+	// unshared futures, completing on other threads
+	{
+		TArray<TFuture<int>> Futures;
+		for (int32 Index = 0; Index < 16; ++Index)
+		{
+			Futures.Add(Async(EAsyncExecution::ThreadPool, AsyncTestUtils::Task));
+		}
+		WhenAll(Futures).Wait();
+		bool bAllReady = true;
+		for (const TFuture<int>& Future : Futures)
+		{
+			bAllReady &= Future.IsReady() && Future.Get() == 123;
+		}
+		TestTrue(TEXT("WhenAll must leave its futures valid and ready"), bAllReady);
+	}
+
+	{
+		TArray<TSharedFuture<int>> Futures;
+		TestTrue(TEXT("WhenAll of no futures must be ready right away"), WhenAll(Futures).IsReady());
+	}
+
+	return true;
+}
+
+
+/** Test that WhenAny is set to the index of the first future to be ready. */
+bool FAsyncWhenAnyTest::RunTest(const YString& Parameters)
+{
+	TArray<TPromise<int>> Promises;
+	Promises.SetNum(3);
+	TArray<TSharedFuture<int>> Futures;
+	for (TPromise<int>& Promise : Promises)
+	{
+		Futures.Add(Promise.GetFuture().Share());
+	}
+
+	TFuture<int32> First = WhenAny(Futures);
+	TestFalse(TEXT("WhenAny must wait for a future"), First.IsReady());
+	Promises[1].SetValue(1);
+	TestTrue(TEXT("WhenAny must be set once a future is ready"), First.IsReady());
+	Promises[0].SetValue(0);
+	Promises[2].SetValue(2);
+	TestEqual(TEXT("WhenAny must be set to the index of the first future to be ready"), First.Get(), 1);
+
+	TestEqual(TEXT("WhenAny of ready futures must pick the first"), WhenAny(Futures).Get(), 0);
+
+	return true;
+}
+
 #endif //WITH_DEV_AUTOMATION_TESTS
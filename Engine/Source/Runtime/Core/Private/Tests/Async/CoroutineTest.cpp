@@ -0,0 +1,128 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Timespan.h"
+#include "Async/Async.h"
+#include "Async/Coroutine.h"
+#include "HAL/ThreadSafeCounter.h"
+
+// Only compiled as C++20, see the Linux CMakeLists.txt
+#if WITH_DEV_AUTOMATION_TESTS && PLATFORM_COMPILER_HAS_COROUTINES
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCoroutineGraphEventTest, "System.Core.Async.Coroutine.GraphEvent", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCoroutineFutureTest, "System.Core.Async.Coroutine.Future", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCoroutineCancelledReadTest, "System.Core.Async.Coroutine.CancelledRead", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+
+namespace CoroutineTest
+{
+	const YTimespan MaxWaitTime(0, 0, 10);
+
+	/** Awaits a task graph task, then reports what the task did. */
+	TCoroTask<int32> AwaitGraphTask(FThreadSafeCounter& Counter)
+	{
+		FGraphEventRef Event = FFunctionGraphTask::CreateAndDispatchWhenReady([&Counter]() { Counter.Add(42); }, TStatId(), nullptr, ENamedThreads::AnyThread);
+		co_await Event;
+		co_return Counter.GetValue();
+	}
+
+	/** Awaits a future from the task graph, then another coroutine. */
+	TCoroTask<int32> AwaitFuture()
+	{
+		const int32 Value = co_await Async<int32>(EAsyncExecution::TaskGraph, []() { return 123; });
+		FThreadSafeCounter Counter;
+		const int32 Nested = co_await AwaitGraphTask(Counter);
+		co_return Value + Nested;
+	}
+
+	/** Request that is cancelled before it completes, the way requests are when their handle shuts down. */
+	class FCancelledReadRequest
+		: public IAsyncReadRequest
+	{
+	public:
+
+		explicit FCancelledReadRequest(FAsyncFileCallBack* InCallback)
+			: IAsyncReadRequest(InCallback, false, nullptr)
+		{
+			Cancel();
+			SetComplete();
+		}
+
+	protected:
+
+		virtual void WaitCompletionImpl(float TimeLimitSeconds) override
+		{ }
+
+		virtual void CancelImpl() override
+		{ }
+	};
+
+	class FCancellingFileHandle
+		: public IAsyncReadFileHandle
+	{
+	public:
+
+		virtual IAsyncReadRequest* SizeRequest(FAsyncFileCallBack* CompleteCallback = nullptr) override
+		{
+			return new FCancelledReadRequest(CompleteCallback);
+		}
+
+		virtual IAsyncReadRequest* ReadRequest(int64 Offset, int64 BytesToRead, EAsyncIOPriority Priority = AIOP_Normal, FAsyncFileCallBack* CompleteCallback = nullptr, uint8* UserSuppliedMemory = nullptr) override
+		{
+			return new FCancelledReadRequest(CompleteCallback);
+		}
+	};
+
+	/** Returns whether the read came back cancelled. */
+	TCoroTask<bool> ReadCancelled(IAsyncReadFileHandle* FileHandle)
+	{
+		IAsyncReadRequest* Request = co_await ReadAsync(FileHandle, 0, 16);
+		const bool bCancelled = Request == nullptr;
+		delete Request;
+		co_return bCancelled;
+	}
+}
+
+
+bool FCoroutineGraphEventTest::RunTest(const YString& Parameters)
+{
+	FThreadSafeCounter Counter;
+	TFuture<int32> Future = CoroutineTest::AwaitGraphTask(Counter).GetFuture();
+	const bool bReturned = Future.WaitFor(CoroutineTest::MaxWaitTime);
+	TestTrue(TEXT("The coroutine returns once the task is done"), bReturned);
+	if (bReturned)
+	{
+		TestEqual(TEXT("The coroutine resumes after the task ran"), Future.Get(), 42);
+	}
+	return true;
+}
+
+
+bool FCoroutineFutureTest::RunTest(const YString& Parameters)
+{
+	TFuture<int32> Future = CoroutineTest::AwaitFuture().GetFuture();
+	const bool bReturned = Future.WaitFor(CoroutineTest::MaxWaitTime);
+	TestTrue(TEXT("The coroutine returns once the future is set"), bReturned);
+	if (bReturned)
+	{
+		TestEqual(TEXT("The coroutine gets the results of the future and the nested coroutine"), Future.Get(), 123 + 42);
+	}
+	return true;
+}
+
+
+bool FCoroutineCancelledReadTest::RunTest(const YString& Parameters)
+{
+	CoroutineTest::FCancellingFileHandle FileHandle;
+	TFuture<bool> Future = CoroutineTest::ReadCancelled(&FileHandle).GetFuture();
+	const bool bReturned = Future.WaitFor(CoroutineTest::MaxWaitTime);
+	TestTrue(TEXT("The coroutine returns once the read is cancelled"), bReturned);
+	if (bReturned)
+	{
+		TestTrue(TEXT("A cancelled read resumes the coroutine without a request"), Future.Get());
+	}
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS && PLATFORM_COMPILER_HAS_COROUTINES
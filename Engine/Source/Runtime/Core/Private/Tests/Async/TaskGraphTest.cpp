@@ -7,10 +7,14 @@
 #include "Stats/Stats.h"
 #include "Misc/AutomationTest.h"
 #include "Async/TaskGraphInterfaces.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Templates/SharedPointer.h"
 
 #if WITH_DEV_AUTOMATION_TESTS
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTaskGraphTest, "System.Core.Async.TaskGraph", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTaskGraphNestedTasksTest, "System.Core.Async.TaskGraph.NestedTasks", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
 
 
 namespace TaskGraphTestTask
@@ -73,4 +77,121 @@ bool FTaskGraphTest::RunTest(const YString& Parameters)
 	return true;
 }
 
+
+namespace TaskGraphNestedTasksTest
+{
+	/** Tasks form a tree where task I queues tasks I * Fanout + 1 to I * Fanout + Fanout, so all but the root are queued from task threads */
+	const int32 Fanout = 8;
+	const int32 Depth = 5;
+	const int32 NumTasks = 1 + 8 + 64 + 512 + 4096;
+
+	/** Shared by the tasks of a run, so that tasks still queued when the test gives up don't write into freed memory */
+	struct FRunState
+	{
+		volatile int32 RunCounts[NumTasks];
+		FThreadSafeCounter NumRun;
+
+		FRunState()
+		{
+			YMemory::Memzero((void*)RunCounts, sizeof(RunCounts));
+		}
+	};
+}
+
+
+/**
+ * Implements a task that counts its runs and queues its children, which go to the deque of the task thread when stealing is on.
+ */
+class FTaskGraphNestedTestTask
+{
+public:
+
+	FTaskGraphNestedTestTask(int32 InIndex, int32 InDepth, const TSharedRef<TaskGraphNestedTasksTest::FRunState, ESPMode::ThreadSafe>& InState)
+		: Index(InIndex)
+		, Depth(InDepth)
+		, State(InState)
+	{
+	}
+
+	void DoTask(ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+	{
+		using namespace TaskGraphNestedTasksTest;
+
+		if (Depth + 1 < TaskGraphNestedTasksTest::Depth)
+		{
+			for (int32 Child = 1; Child <= Fanout; ++Child)
+			{
+				TGraphTask<FTaskGraphNestedTestTask>::CreateTask().ConstructAndDispatchWhenReady(Index * Fanout + Child, Depth + 1, State);
+			}
+		}
+
+		FPlatformAtomics::InterlockedIncrement(&State->RunCounts[Index]);
+		State->NumRun.Increment();
+	}
+
+	ENamedThreads::Type GetDesiredThread()
+	{
+		return ENamedThreads::AnyThread;
+	}
+
+	TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FTaskGraphNestedTestTask, STATGROUP_TaskGraphTasks);
+	}
+
+	static ESubsequentsMode::Type GetSubsequentsMode()
+	{
+		return ESubsequentsMode::FireAndForget;
+	}
+
+private:
+
+	int32 Index;
+	int32 Depth;
+	TSharedRef<TaskGraphNestedTasksTest::FRunState, ESPMode::ThreadSafe> State;
+};
+
+
+bool FTaskGraphNestedTasksTest::RunTest(const YString& Parameters)
+{
+	using namespace TaskGraphNestedTasksTest;
+
+	IConsoleVariable* UseWorkStealingVar = IConsoleManager::Get().FindConsoleVariable(TEXT("TaskGraph.UseWorkStealing"));
+	if (!UseWorkStealingVar)
+	{
+		AddError(TEXT("TaskGraph.UseWorkStealing must exist"));
+		return false;
+	}
+	const int32 SavedUseWorkStealing = UseWorkStealingVar->GetInt();
+
+	for (int32 UseWorkStealing = 0; UseWorkStealing < 2; ++UseWorkStealing)
+	{
+		UseWorkStealingVar->Set(UseWorkStealing);
+
+		TSharedRef<FRunState, ESPMode::ThreadSafe> State = MakeShareable(new FRunState);
+		TGraphTask<FTaskGraphNestedTestTask>::CreateTask().ConstructAndDispatchWhenReady(0, 0, State);
+
+		const YDateTime StartTime = YDateTime::UtcNow();
+		while (State->NumRun.GetValue() < NumTasks && (YDateTime::UtcNow() - StartTime) < YTimespan(0, 0, 10))
+		{
+			FPlatformProcess::Sleep(0.001f);
+		}
+
+		// wait a little longer so that a task run twice has the time to show up
+		FPlatformProcess::Sleep(0.01f);
+
+		int32 NumRunOnce = 0;
+		for (int32 Index = 0; Index < NumTasks; ++Index)
+		{
+			NumRunOnce += State->RunCounts[Index] == 1;
+		}
+		TestEqual(YString::Printf(TEXT("Every nested task must run, TaskGraph.UseWorkStealing %d"), UseWorkStealing), State->NumRun.GetValue(), NumTasks);
+		TestEqual(YString::Printf(TEXT("Every nested task must run exactly once, TaskGraph.UseWorkStealing %d"), UseWorkStealing), NumRunOnce, NumTasks);
+	}
+
+	UseWorkStealingVar->Set(SavedUseWorkStealing);
+
+	return true;
+}
+
 #endif //WITH_DEV_AUTOMATION_TESTS
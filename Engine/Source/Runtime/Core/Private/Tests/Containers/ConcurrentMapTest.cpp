@@ -0,0 +1,238 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Containers/Array.h"
+#include "Containers/ConcurrentMap.h"
+#include "Misc/AutomationTest.h"
+#include "Async/Async.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FConcurrentMapTest, "System.Core.Containers.ConcurrentMap", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FConcurrentMapThreadedTest, "System.Core.Containers.ConcurrentMap (Threaded)", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+
+namespace ConcurrentMapTest
+{
+	/** A value that counts its live instances per tag, to see when the map frees the nodes it unlinked. */
+	struct FTracked
+	{
+		static volatile int32 NumLive[2];
+
+		int32 Tag;
+
+		FTracked()
+			: Tag(0)
+		{
+			FPlatformAtomics::InterlockedIncrement(&NumLive[Tag]);
+		}
+
+		explicit FTracked(int32 InTag)
+			: Tag(InTag)
+		{
+			FPlatformAtomics::InterlockedIncrement(&NumLive[Tag]);
+		}
+
+		FTracked(const FTracked& Other)
+			: Tag(Other.Tag)
+		{
+			FPlatformAtomics::InterlockedIncrement(&NumLive[Tag]);
+		}
+
+		~FTracked()
+		{
+			FPlatformAtomics::InterlockedDecrement(&NumLive[Tag]);
+		}
+
+		FTracked& operator=(const FTracked& Other)
+		{
+			FPlatformAtomics::InterlockedDecrement(&NumLive[Tag]);
+			Tag = Other.Tag;
+			FPlatformAtomics::InterlockedIncrement(&NumLive[Tag]);
+			return *this;
+		}
+	};
+
+	volatile int32 FTracked::NumLive[2] = { 0, 0 };
+
+	/** @return the shard of a map with NumShards shards that the key goes to. */
+	uint32 GetShardIndex(int32 Key, uint32 NumShards)
+	{
+		return UE4ConcurrentMap_Private::MixHash(GetTypeHash(Key)) & (NumShards - 1);
+	}
+}
+
+
+bool FConcurrentMapTest::RunTest(const YString& Parameters)
+{
+	using namespace ConcurrentMapTest;
+
+	{
+		TConcurrentMap<int32, int32> Map(4);
+		for (int32 Key = 0; Key < 1000; ++Key)
+		{
+			Map.Add(Key, Key * 2);
+		}
+		Map.Add(10, -1);
+
+		bool bFound = true;
+		for (int32 Key = 0; Key < 1000; ++Key)
+		{
+			int32 Value = 0;
+			bFound &= Map.Find(Key, Value) && Value == (Key == 10 ? -1 : Key * 2);
+		}
+		TestTrue(TEXT("Growing must keep every pair"), bFound);
+		TestEqual(TEXT("Replacing a value must not add a key"), Map.Num(), 1000);
+		TestFalse(TEXT("Missing keys must not be found"), Map.Contains(1000));
+
+		int32 Removed = 0;
+		TestTrue(TEXT("RemoveAndCopyValue must find the key"), Map.RemoveAndCopyValue(20, Removed) && Removed == 40);
+		TestFalse(TEXT("Removing a missing key must fail"), Map.Remove(20));
+		TestEqual(TEXT("FindOrAdd must keep an existing value"), Map.FindOrAdd(30, 7), 60);
+		TestEqual(TEXT("FindOrAdd must add a missing key"), Map.FindOrAdd(20, 7), 7);
+
+		int32 NumVisited = 0;
+		int64 Sum = 0;
+		Map.ForEach([&NumVisited, &Sum](const int32& Key, const int32& Value)
+		{
+			++NumVisited;
+			Sum += Key;
+		});
+		TestEqual(TEXT("ForEach must visit every pair"), NumVisited, 1000);
+		TestEqual(TEXT("ForEach must visit each key once"), Sum, int64(999 * 1000 / 2));
+
+		Map.Empty();
+		TestEqual(TEXT("Empty must remove every key"), Map.Num(), 0);
+		TestFalse(TEXT("Empty must leave no key to find"), Map.Contains(5));
+	}
+
+	// nodes a quiet shard retired are freed by the reclamations of busier shards
+	{
+		const uint32 NumShards = 2;
+		TConcurrentMap<int32, FTracked>* Map = new TConcurrentMap<int32, FTracked>(NumShards);
+
+		const int32 QuietKey = 0;
+		int32 BusyKey = 1;
+		while (GetShardIndex(BusyKey, NumShards) == GetShardIndex(QuietKey, NumShards))
+		{
+			++BusyKey;
+		}
+
+		for (int32 Index = 0; Index < 8; ++Index)
+		{
+			Map->Add(QuietKey, FTracked(1));
+		}
+		TestTrue(TEXT("The replaced values of a quiet shard are kept while readers may see them"), FTracked::NumLive[1] > 1);
+		for (int32 Index = 0; Index < 200; ++Index)
+		{
+			Map->Add(BusyKey, FTracked(0));
+		}
+		TestEqual(TEXT("The replaced values of a quiet shard must be freed"), (int32)FTracked::NumLive[1], 1);
+
+		delete Map;
+		TestEqual(TEXT("Destroying the map must free every value"), FTracked::NumLive[0] + FTracked::NumLive[1], 0);
+	}
+
+	return true;
+}
+
+
+/** Test that readers always see a value that was added for the key while writers add, replace and remove keys. */
+bool FConcurrentMapThreadedTest::RunTest(const YString& Parameters)
+{
+	const int32 NumWriters = 4;
+	const int32 NumReaders = 4;
+	const int32 NumKeys = 4096;
+	const int32 NumRounds = 20;
+
+	// every value is its key plus a multiple of NumKeys; keys below NumKeys / 2 are never removed
+	TConcurrentMap<int32, int32> Map(16);
+	for (int32 Key = 0; Key < NumKeys; ++Key)
+	{
+		Map.Add(Key, Key);
+	}
+
+	volatile int32 bDone = 0;
+	FThreadSafeCounter NumErrors;
+	FThreadSafeCounter NumMissing;
+
+	TArray<TFuture<void>> Readers;
+	for (int32 Reader = 0; Reader < NumReaders; ++Reader)
+	{
+		Readers.Add(Async<void>(EAsyncExecution::Thread, [&, Reader]()
+		{
+			uint32 Random = 0x9E3779B9u * (Reader + 1);
+			while (!bDone)
+			{
+				FConcurrentMapReadScope ReadScope;
+				for (int32 Op = 0; Op < 64; ++Op)
+				{
+					Random ^= Random << 13;
+					Random ^= Random >> 17;
+					Random ^= Random << 5;
+					const int32 Key = int32(Random % NumKeys);
+					int32 Value;
+					if (Map.Find(Key, Value))
+					{
+						NumErrors.Add(Value % NumKeys != Key ? 1 : 0);
+					}
+					else
+					{
+						NumMissing.Add(Key < NumKeys / 2 ? 1 : 0);
+					}
+				}
+			}
+		}));
+	}
+
+	TArray<TFuture<void>> Writers;
+	for (int32 Writer = 0; Writer < NumWriters; ++Writer)
+	{
+		Writers.Add(Async<void>(EAsyncExecution::Thread, [&, Writer]()
+		{
+			for (int32 Round = 1; Round <= NumRounds; ++Round)
+			{
+				for (int32 Key = Writer; Key < NumKeys; Key += NumWriters)
+				{
+					if (Key < NumKeys / 2)
+					{
+						Map.Add(Key, Key + NumKeys * Round);
+					}
+					else if (Round & 1)
+					{
+						Map.Remove(Key);
+					}
+					else
+					{
+						Map.FindOrAdd(Key, Key + NumKeys * Round);
+					}
+				}
+			}
+		}));
+	}
+
+	for (TFuture<void>& Writer : Writers)
+	{
+		Writer.Wait();
+	}
+	FPlatformAtomics::InterlockedExchange(&bDone, 1);
+	for (TFuture<void>& Reader : Readers)
+	{
+		Reader.Wait();
+	}
+
+	TestEqual(TEXT("Readers must only see values added for the key"), NumErrors.GetValue(), 0);
+	TestEqual(TEXT("Readers must always find keys that are only replaced"), NumMissing.GetValue(), 0);
+	TestEqual(TEXT("Every key must be in the map after the last round, which adds them all"), Map.Num(), NumKeys);
+
+	bool bLastValues = true;
+	for (int32 Key = 0; Key < NumKeys; ++Key)
+	{
+		bLastValues &= Map.FindRef(Key) == Key + NumKeys * NumRounds;
+	}
+	TestTrue(TEXT("Every key must have the value of the last round"), bLastValues);
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,286 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Containers/SolidAngleString.h"
+#include "Containers/FlatSet.h"
+#include "Containers/FlatMap.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlatSetTest, "System.Core.Containers.FlatSet", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlatMapTest, "System.Core.Containers.FlatMap", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+
+namespace FlatSetTest
+{
+	/** Counts live instances, so that elements destroyed twice or never show up. */
+	struct FTracked
+	{
+		static int32 NumLive;
+
+		int32 Key;
+		YString Name;
+
+		FTracked(int32 InKey)
+			: Key(InKey)
+			, Name(YString::Printf(TEXT("Element %d"), InKey))
+		{
+			++NumLive;
+		}
+
+		FTracked(const FTracked& Other)
+			: Key(Other.Key)
+			, Name(Other.Name)
+		{
+			++NumLive;
+		}
+
+		~FTracked()
+		{
+			--NumLive;
+			Key = -1;
+		}
+
+		FTracked& operator=(const FTracked& Other)
+		{
+			Key = Other.Key;
+			Name = Other.Name;
+			return *this;
+		}
+
+		bool operator==(const FTracked& Other) const
+		{
+			return Key == Other.Key;
+		}
+
+		friend uint32 GetTypeHash(const FTracked& Tracked)
+		{
+			check(Tracked.Key >= 0); // hashing a destroyed element
+			return GetTypeHash(Tracked.Key);
+		}
+	};
+
+	int32 FTracked::NumLive = 0;
+
+	/** Puts every key in the same few probe sequences, so that removals leave deleted slots behind. */
+	struct FCollidingKeyFuncs : DefaultKeyFuncs<int32>
+	{
+		static FORCEINLINE uint32 GetKeyHash(int32 Key)
+		{
+			return uint32(Key & 3);
+		}
+	};
+
+	/** @return true if Set holds the elements First to First + Num - 1, each intact. */
+	template<typename SetType>
+	bool HoldsRange(const SetType& Set, int32 First, int32 Num)
+	{
+		if (Set.Num() != Num)
+		{
+			return false;
+		}
+		for (int32 Key = First; Key < First + Num; ++Key)
+		{
+			const FTracked* Element = Set.Find(FTracked(Key));
+			if (!Element || Element->Name != YString::Printf(TEXT("Element %d"), Key))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+
+bool FFlatSetTest::RunTest(const YString& Parameters)
+{
+	using namespace FlatSetTest;
+
+	typedef TFlatSet<FTracked> FTrackedSet;
+
+	// growth with non-trivial elements
+	{
+		FTrackedSet Set;
+		for (int32 Key = 0; Key < 1000; ++Key)
+		{
+			Set.Add(FTracked(Key));
+		}
+		Set.Add(FTracked(10));
+		TestTrue(TEXT("Growing must keep every element intact"), HoldsRange(Set, 0, 1000));
+		TestFalse(TEXT("Missing keys must not be found"), Set.Contains(FTracked(1000)));
+		TestEqual(TEXT("Adding an existing key must replace the element"), FTracked::NumLive, 1000);
+
+		int32 NumVisited = 0;
+		for (const FTracked& Element : Set)
+		{
+			NumVisited += Element.Key >= 0 ? 1 : 0;
+		}
+		TestEqual(TEXT("Iteration must visit every element"), NumVisited, 1000);
+	}
+	TestEqual(TEXT("Destroying the set must destroy its elements"), FTracked::NumLive, 0);
+
+	// Empty and Reset
+	{
+		FTrackedSet Set;
+		for (int32 Key = 0; Key < 100; ++Key)
+		{
+			Set.Add(FTracked(Key));
+		}
+		const int32 Capacity = Set.GetCapacity();
+
+		Set.Reset();
+		TestEqual(TEXT("Reset must destroy the elements"), FTracked::NumLive, 0);
+		TestEqual(TEXT("Reset must keep the table"), Set.GetCapacity(), Capacity);
+		TestFalse(TEXT("Reset must leave no element to find"), Set.Contains(FTracked(5)));
+
+		for (int32 Key = 0; Key < 100; ++Key)
+		{
+			Set.Add(FTracked(Key));
+		}
+		Set.Empty(1000);
+		TestEqual(TEXT("Empty with a larger size must destroy the elements"), FTracked::NumLive, 0);
+		TestTrue(TEXT("Empty with a larger size must grow the table"), Set.GetCapacity() > Capacity);
+		TestEqual(TEXT("Empty must leave no element"), Set.Num(), 0);
+		TestFalse(TEXT("Empty must leave no element to find"), Set.Contains(FTracked(5)));
+
+		for (int32 Key = 0; Key < 100; ++Key)
+		{
+			Set.Add(FTracked(Key));
+		}
+		Set.Empty(10);
+		TestEqual(TEXT("Empty with a smaller size must destroy the elements"), FTracked::NumLive, 0);
+		TestTrue(TEXT("Empty with a smaller size must shrink the table"), Set.GetCapacity() < Capacity);
+
+		for (int32 Key = 0; Key < 100; ++Key)
+		{
+			Set.Add(FTracked(Key));
+		}
+		TestTrue(TEXT("An emptied set must be usable"), HoldsRange(Set, 0, 100));
+		Set.Empty();
+		TestEqual(TEXT("Empty must free the table"), Set.GetAllocatedSize(), 0u);
+	}
+	TestEqual(TEXT("Empty must not destroy any element twice"), FTracked::NumLive, 0);
+
+	// copy and move assignment
+	{
+		FTrackedSet Small;
+		FTrackedSet Large;
+		for (int32 Key = 0; Key < 10; ++Key)
+		{
+			Small.Add(FTracked(Key));
+		}
+		for (int32 Key = 100; Key < 600; ++Key)
+		{
+			Large.Add(FTracked(Key));
+		}
+
+		FTrackedSet Copy = Small;
+		Copy = Large;
+		TestTrue(TEXT("Copying a larger set must copy every element"), HoldsRange(Copy, 100, 500));
+		Copy = Small;
+		TestTrue(TEXT("Copying a smaller set must copy every element"), HoldsRange(Copy, 0, 10));
+		TestEqual(TEXT("Copying must destroy the elements it replaces"), FTracked::NumLive, 520);
+		Copy = FTrackedSet();
+		TestEqual(TEXT("Copying an empty set must leave no element"), Copy.Num(), 0);
+
+		Copy = Small;
+		Copy = MoveTemp(Large);
+		TestTrue(TEXT("Moving must take every element"), HoldsRange(Copy, 100, 500));
+		TestEqual(TEXT("Moving must leave the source empty"), Large.Num(), 0);
+		TestEqual(TEXT("Moving must destroy the elements it replaces"), FTracked::NumLive, 510);
+		Large = Copy;
+		Copy.Add(FTracked(0));
+		TestTrue(TEXT("A copy must not share the table of its source"), HoldsRange(Large, 100, 500));
+	}
+	TestEqual(TEXT("Assignment must not leak or destroy any element twice"), FTracked::NumLive, 0);
+
+	// removal with deleted slots
+	{
+		TFlatSet<int32, FCollidingKeyFuncs> Set;
+		for (int32 Key = 0; Key < 200; ++Key)
+		{
+			Set.Add(Key);
+		}
+		for (int32 Key = 0; Key < 200; Key += 2)
+		{
+			Set.Remove(Key);
+		}
+		bool bFound = true;
+		for (int32 Key = 0; Key < 200; ++Key)
+		{
+			bFound &= Set.Contains(Key) == ((Key & 1) != 0);
+		}
+		TestTrue(TEXT("Removing must not hide the elements probed past the removed ones"), bFound);
+
+		// adding and removing over and over reuses deleted slots instead of growing for ever
+		const int32 Capacity = Set.GetCapacity();
+		for (int32 Round = 0; Round < 20; ++Round)
+		{
+			for (int32 Key = 0; Key < 200; Key += 2)
+			{
+				Set.Add(Key);
+			}
+			for (int32 Key = 0; Key < 200; Key += 2)
+			{
+				Set.Remove(Key);
+			}
+		}
+		TestEqual(TEXT("Deleted slots must be reused"), Set.GetCapacity(), Capacity);
+		TestEqual(TEXT("Only the odd keys must be left"), Set.Num(), 100);
+
+		Set.Empty(1000);
+		TestEqual(TEXT("Empty must drop deleted slots too"), Set.Num(), 0);
+		Set.Add(1);
+		TestTrue(TEXT("A set emptied with deleted slots must be usable"), Set.Contains(1) && !Set.Contains(3));
+	}
+
+	return true;
+}
+
+
+bool FFlatMapTest::RunTest(const YString& Parameters)
+{
+	typedef TFlatMap<YString, int32> FStringMap;
+
+	FStringMap Map;
+	for (int32 Index = 0; Index < 300; ++Index)
+	{
+		Map.Add(YString::Printf(TEXT("Key%d"), Index), Index);
+	}
+	Map.Add(TEXT("Key7"), -7);
+
+	bool bFound = true;
+	for (int32 Index = 0; Index < 300; ++Index)
+	{
+		const int32* Value = Map.Find(YString::Printf(TEXT("Key%d"), Index));
+		bFound &= Value && *Value == (Index == 7 ? -7 : Index);
+	}
+	TestTrue(TEXT("Growing must keep every pair"), bFound);
+	TestEqual(TEXT("Adding an existing key must replace its value"), Map.Num(), 300);
+
+	int32 Removed = 0;
+	TestTrue(TEXT("RemoveAndCopyValue must find the key"), Map.RemoveAndCopyValue(TEXT("Key42"), Removed) && Removed == 42);
+	TestEqual(TEXT("FindRef of a missing key must return a default value"), Map.FindRef(TEXT("Key42")), 0);
+
+	FStringMap Small;
+	Small.Add(TEXT("A"), 1);
+	FStringMap Copy = Small;
+	Copy = Map;
+	TestEqual(TEXT("Copying a larger map must copy every pair"), Copy.Num(), 299);
+	TestEqual(TEXT("A copied map must be searchable"), Copy.FindRef(TEXT("Key299")), 299);
+	Copy = Small;
+	TestEqual(TEXT("Copying a smaller map must copy every pair"), Copy.Num(), 1);
+	TestEqual(TEXT("A map copied over a larger one must be searchable"), Copy.FindRef(TEXT("A")), 1);
+
+	Map.Empty(10);
+	TestEqual(TEXT("Empty must remove every pair"), Map.Num(), 0);
+	Map.Add(TEXT("B"), 2);
+	TestEqual(TEXT("An emptied map must be usable"), Map.FindRef(TEXT("B")), 2);
+	Map.Reset();
+	TestFalse(TEXT("Reset must remove every pair"), Map.Contains(TEXT("B")));
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
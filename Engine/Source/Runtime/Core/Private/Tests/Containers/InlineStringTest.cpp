@@ -0,0 +1,270 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Containers/SolidAngleString.h"
+#include "Containers/InlineString.h"
+#include "Misc/App.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/Parse.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInlineStringTest, "System.Core.Containers.InlineString", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInlineStringParseTest, "System.Core.Misc.Parse.InlineString", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInlineStringConfigTest, "System.Core.Misc.ConfigCacheIni.Parse", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+
+bool FInlineStringTest::RunTest(const YString& Parameters)
+{
+	typedef TInlineString<8> FSmallString;
+
+	// Empty strings point at an empty terminated string and use no heap memory
+	{
+		FSmallString String;
+		TestTrue(TEXT("A new string must be empty"), String.IsEmpty());
+		TestTrue(TEXT("A new string must be inline"), String.IsInline());
+		TestEqual(TEXT("A new string must have no length"), String.Len(), 0);
+		TestEqual(TEXT("A new string must dereference to an empty string"), YString(*String), YString());
+		TestEqual(TEXT("A new string must not allocate"), String.GetAllocatedSize(), (uint32)0);
+	}
+
+	// Characters stay inline up to the inline size and move to the heap past it, keeping the characters
+	{
+		FSmallString String;
+		for (int32 Index = 0; Index < 8; ++Index)
+		{
+			String += TCHAR('a' + Index);
+		}
+		TestEqual(TEXT("A full inline string must hold its characters"), YString(*String), YString(TEXT("abcdefgh")));
+		TestTrue(TEXT("A string as long as its inline size must be inline"), String.IsInline());
+		TestEqual(TEXT("An inline string must not allocate"), String.GetAllocatedSize(), (uint32)0);
+
+		String += TCHAR('i');
+		TestFalse(TEXT("A string longer than its inline size must not be inline"), String.IsInline());
+		TestNotEqual(TEXT("A string that moved to the heap must allocate"), String.GetAllocatedSize(), (uint32)0);
+		TestEqual(TEXT("Moving to the heap must keep the characters"), YString(*String), YString(TEXT("abcdefghi")));
+		TestEqual(TEXT("Moving to the heap must update the length"), String.Len(), 9);
+
+		// Reset keeps the heap memory for reuse, Empty gives it back
+		String.Reset();
+		TestTrue(TEXT("A reset string must be empty"), String.IsEmpty());
+		TestFalse(TEXT("A reset string must keep its heap memory"), String.IsInline());
+		String += TEXT("xyz");
+		TestEqual(TEXT("A reset string must be reusable"), YString(*String), YString(TEXT("xyz")));
+		String.Empty();
+		TestTrue(TEXT("An emptied string must be inline again"), String.IsInline());
+		TestEqual(TEXT("An emptied string must be empty"), String.Len(), 0);
+	}
+
+	// One append across the inline size, copies and conversions
+	{
+		FSmallString String(TEXT("short"));
+		TestTrue(TEXT("A short string must be inline"), String.IsInline());
+		String += TEXT(" and then long");
+		TestFalse(TEXT("Appending past the inline size must move to the heap"), String.IsInline());
+		TestTrue(TEXT("Appending past the inline size must keep the characters"), String == TEXT("short and then long"));
+
+		const FSmallString Copy(String);
+		TestTrue(TEXT("A copy of a heap string must be equal"), Copy == String);
+		TestEqual(TEXT("A heap string must convert to the same YString"), String.ToString(), YString(TEXT("short and then long")));
+
+		FSmallString Moved(MoveTemp(String));
+		TestTrue(TEXT("A moved heap string must keep its characters"), Moved == TEXT("short and then long"));
+
+		Moved.RemoveFromEnd(14);
+		TestTrue(TEXT("Removing from the end must shorten the string"), Moved == TEXT("short"));
+		TestFalse(TEXT("Equals must be case sensitive by default"), Moved.Equals(TEXT("SHORT")));
+		TestTrue(TEXT("Equals may ignore case"), Moved.Equals(TEXT("SHORT"), ESearchCase::IgnoreCase));
+		TestTrue(TEXT("The equality operator must ignore case, like YString"), Moved == TEXT("SHORT"));
+
+		const YString Long(TEXT("a string well past the inline size"));
+		FSmallString FromLong(Long);
+		TestTrue(TEXT("Constructing from a long YString must keep the characters"), FromLong == Long);
+		TestEqual(TEXT("Equal strings must hash the same"), GetTypeHash(FromLong), GetTypeHash(FSmallString(*Long)));
+	}
+
+	return true;
+}
+
+
+bool FInlineStringParseTest::RunTest(const YString& Parameters)
+{
+	// Tokens, short ones inline and long quoted ones past the inline size, match the YString overload
+	{
+		const TCHAR* CommandLine = TEXT("Game -log -ResX=1920 \"C:/Program Files/Solid Angle/Binaries/Game.exe\" \"say \\\"hi\\\"\" -a_token_longer_than_the_inline_size");
+		const TCHAR* Expected[] = { TEXT("Game"), TEXT("-log"), TEXT("-ResX=1920"), TEXT("C:/Program Files/Solid Angle/Binaries/Game.exe"), TEXT("say \"hi\""), TEXT("-a_token_longer_than_the_inline_size") };
+
+		const TCHAR* StringStream = CommandLine;
+		const TCHAR* InlineStream = CommandLine;
+		YString StringToken;
+		YInlineString InlineToken;
+		for (const TCHAR* ExpectedToken : Expected)
+		{
+			TestTrue(TEXT("Token must find every token"), FParse::Token(StringStream, StringToken, true));
+			TestTrue(TEXT("Token must find every inline token"), FParse::Token(InlineStream, InlineToken, true));
+			TestEqual(TEXT("Token must parse the token"), StringToken, YString(ExpectedToken));
+			TestTrue(TEXT("Token must parse the same inline token"), InlineToken.Equals(*StringToken));
+		}
+		TestEqual(TEXT("Both overloads must stop at the same place"), (const TCHAR*)StringStream, (const TCHAR*)InlineStream);
+		TestFalse(TEXT("Token must fail at the end of the stream"), FParse::Token(StringStream, StringToken, true));
+		TestFalse(TEXT("Token must fail at the end of the stream for inline tokens"), FParse::Token(InlineStream, InlineToken, true));
+		TestEqual(TEXT("The token returning overload must agree"), FParse::Token(CommandLine, true), YString(TEXT("Game")));
+	}
+
+	// Alphanumeric tokens stop at the first other character
+	{
+		const TCHAR* StringStream = TEXT("  Name_1(Arg)");
+		const TCHAR* InlineStream = StringStream;
+		YString StringToken;
+		YInlineString InlineToken;
+		TestTrue(TEXT("AlnumToken must find the token"), FParse::AlnumToken(StringStream, StringToken));
+		TestTrue(TEXT("AlnumToken must find the inline token"), FParse::AlnumToken(InlineStream, InlineToken));
+		TestEqual(TEXT("AlnumToken must stop at the parenthesis"), StringToken, YString(TEXT("Name_1")));
+		TestTrue(TEXT("AlnumToken must parse the same inline token"), InlineToken.Equals(*StringToken));
+		TestEqual(TEXT("Both AlnumToken overloads must stop at the same place"), (const TCHAR*)StringStream, (const TCHAR*)InlineStream);
+	}
+
+	// Lines, with comments, blank lines and a line longer than the inline size, into reused outputs
+	{
+		const TCHAR* Text = TEXT("First line\r\n\r\nKey=Value // a comment\nA line that is much longer than the inline size of the string\nLast");
+		const TCHAR* StringStream = Text;
+		const TCHAR* InlineStream = Text;
+		YString StringLine;
+		YInlineString InlineLine;
+		int32 NumLines = 0;
+		while (*StringStream)
+		{
+			TestTrue(TEXT("Line must return each line"), FParse::Line(&StringStream, StringLine));
+			TestTrue(TEXT("Line must return each inline line"), FParse::Line(&InlineStream, InlineLine));
+			TestTrue(TEXT("Line must parse the same inline line"), InlineLine.Equals(*StringLine));
+			++NumLines;
+		}
+		// the blank line is eaten with the line break before it
+		TestEqual(TEXT("Line must return every line that is not blank"), NumLines, 4);
+		TestEqual(TEXT("The last line must be parsed"), StringLine, YString(TEXT("Last")));
+		TestEqual(TEXT("Both Line overloads must stop at the same place"), (const TCHAR*)StringStream, (const TCHAR*)InlineStream);
+
+		StringStream = Text + 14;
+		FParse::Line(&StringStream, StringLine);
+		TestEqual(TEXT("Line must drop the comment"), StringLine, YString(TEXT("Key=Value ")));
+		StringStream = Text + 14;
+		FParse::Line(&StringStream, StringLine, true);
+		TestEqual(TEXT("Exact lines must keep the comment"), StringLine, YString(TEXT("Key=Value // a comment")));
+	}
+
+	// Extended lines join lines ending in a backslash and lines inside braces
+	{
+		const TCHAR* Text = TEXT("One \\\nline\n{Braces\nspan}\nNext");
+		const TCHAR* StringStream = Text;
+		const TCHAR* InlineStream = Text;
+		YString StringLine;
+		YInlineString InlineLine;
+		int32 StringLinesConsumed = 0;
+		int32 InlineLinesConsumed = 0;
+		while (*StringStream)
+		{
+			TestTrue(TEXT("LineExtended must return each line"), FParse::LineExtended(&StringStream, StringLine, StringLinesConsumed));
+			TestTrue(TEXT("LineExtended must return each inline line"), FParse::LineExtended(&InlineStream, InlineLine, InlineLinesConsumed));
+			TestTrue(TEXT("LineExtended must parse the same inline line"), InlineLine.Equals(*StringLine));
+			TestEqual(TEXT("LineExtended must consume the same lines"), InlineLinesConsumed, StringLinesConsumed);
+		}
+		TestEqual(TEXT("The last extended line must be parsed"), StringLine, YString(TEXT("Next")));
+	}
+
+	// Quoted strings unescape, including hex escapes, and append to the value
+	{
+		YString Value(TEXT(">"));
+		int32 NumCharsRead = 0;
+		const TCHAR* Quoted = TEXT("\"C:/Program Files \\\"x\\\"\\n\\41\\\\\" trailing");
+		TestTrue(TEXT("QuotedString must parse a quoted string"), FParse::QuotedString(Quoted, Value, &NumCharsRead));
+		TestEqual(TEXT("QuotedString must unescape and append"), Value, YString(TEXT(">C:/Program Files \"x\"\nA\\")));
+		TestEqual(TEXT("QuotedString must report what it read"), NumCharsRead, 31);
+
+		YString Unterminated;
+		TestFalse(TEXT("QuotedString must fail without a closing quote"), FParse::QuotedString(TEXT("\"open"), Unterminated));
+		TestFalse(TEXT("QuotedString must fail without an opening quote"), FParse::QuotedString(TEXT("plain"), Unterminated));
+	}
+
+	return true;
+}
+
+
+bool FInlineStringConfigTest::RunTest(const YString& Parameters)
+{
+	const YString IniText = TEXT(
+		"[Settings]\r\n"
+		"bEnabled=True\r\n"
+		"; a comment that is skipped\r\n"
+		"DefaultMap=/Game/Maps/A/Map_With_A_Path_Longer_Than_The_Inline_Size.Map\r\n"
+		"Description=\"A \\\"quoted\\\" value\"\r\n"
+		"Short=\"abc\"\r\n"
+		"Plain=No placeholders here\r\n"
+		"Expanded=%GAME%/Config\r\n"
+		"+Paths=(Path=\"/Game/One\")\r\n"
+		"+Paths=(Path=\"/Game/Two\")\r\n"
+		"\r\n"
+		"[Other]\r\n"
+		"Key=Value\r\n");
+
+	// Both ways of reading a buffer must end up with the same values
+	for (int32 bCombine = 0; bCombine < 2; ++bCombine)
+	{
+		FConfigFile File;
+		if (bCombine)
+		{
+			File.CombineFromBuffer(IniText);
+		}
+		else
+		{
+			File.ProcessInputFileContents(IniText);
+		}
+
+		YString Value;
+		TestTrue(TEXT("A plain value must be found"), File.GetString(TEXT("Settings"), TEXT("bEnabled"), Value));
+		TestEqual(TEXT("A plain value must be read"), Value, YString(TEXT("True")));
+		TestTrue(TEXT("A long value must be found"), File.GetString(TEXT("Settings"), TEXT("DefaultMap"), Value));
+		TestEqual(TEXT("A long value must be read whole"), Value, YString(TEXT("/Game/Maps/A/Map_With_A_Path_Longer_Than_The_Inline_Size.Map")));
+		TestTrue(TEXT("A quoted value must be found"), File.GetString(TEXT("Settings"), TEXT("Short"), Value));
+		TestEqual(TEXT("A quoted value must lose its quotes"), Value, YString(TEXT("abc")));
+		TestTrue(TEXT("A value with escaped quotes must be found"), File.GetString(TEXT("Settings"), TEXT("Description"), Value));
+		TestEqual(TEXT("A value with escaped quotes must be unescaped"), Value, YString(TEXT("A \"quoted\" value")));
+		TestTrue(TEXT("A value in the second section must be found"), File.GetString(TEXT("Other"), TEXT("Key"), Value));
+		TestEqual(TEXT("A value in the second section must be read"), Value, YString(TEXT("Value")));
+		TestFalse(TEXT("A comment must not become a key"), File.GetString(TEXT("Settings"), TEXT("; a comment that is skipped"), Value));
+
+		const FConfigSection* Section = File.Find(TEXT("Settings"));
+		TestNotNull(TEXT("The section must be found"), Section);
+		if (Section)
+		{
+			// only combining applies the array operators, processed files are already combined and keep them in the keys
+			TArray<YString> Paths;
+			Section->MultiFind(bCombine ? TEXT("Paths") : TEXT("+Paths"), Paths);
+			TestEqual(TEXT("Array values must all be added"), Paths.Num(), 2);
+			if (Paths.Num() == 2)
+			{
+				TestEqual(TEXT("Array values must keep their order"), Paths[0], YString(TEXT("(Path=\"/Game/One\")")));
+				TestEqual(TEXT("Array values must keep their order"), Paths[1], YString(TEXT("(Path=\"/Game/Two\")")));
+			}
+
+			// Values without a placeholder are not expanded, values with one are
+			const FConfigValue* Plain = Section->Find(TEXT("Plain"));
+			TestNotNull(TEXT("A value without placeholders must be found"), Plain);
+			if (Plain)
+			{
+				TestEqual(TEXT("A value without placeholders must read as saved"), Plain->GetValue(), Plain->GetSavedValue());
+			}
+			const FConfigValue* Expanded = Section->Find(TEXT("Expanded"));
+			TestNotNull(TEXT("A value with a placeholder must be found"), Expanded);
+			if (Expanded)
+			{
+				TestEqual(TEXT("A value with a placeholder must keep it when saved"), Expanded->GetSavedValue(), YString(TEXT("%GAME%/Config")));
+				TestEqual(TEXT("A value with a placeholder must be expanded"), Expanded->GetValue(), YString(FApp::GetGameName()) + TEXT("/Config"));
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
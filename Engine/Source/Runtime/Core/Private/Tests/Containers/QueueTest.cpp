@@ -0,0 +1,259 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Containers/Array.h"
+#include "Containers/MpmcQueue.h"
+#include "Containers/SpscRingBuffer.h"
+#include "Templates/SharedPointer.h"
+#include "Misc/AutomationTest.h"
+#include "Async/Async.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMpmcQueueTest, "System.Core.Containers.MpmcQueue", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMpmcQueueThreadedTest, "System.Core.Containers.MpmcQueue (Threaded)", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpscRingBufferTest, "System.Core.Containers.SpscRingBuffer", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpscRingBufferThreadedTest, "System.Core.Containers.SpscRingBuffer (Threaded)", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+
+namespace QueueTest
+{
+	const int32 NumThreads = 4;
+	const int32 NumPerProducer = 100000;
+
+	/** Encodes the producer in the high bits so that consumers can check the order of each producer's elements. */
+	FORCEINLINE uint32 MakeItem(int32 Producer, int32 Index)
+	{
+		return (uint32(Producer) << 24) | uint32(Index);
+	}
+}
+
+
+/** Test that the queue is FIFO and reports full and empty, over several laps of its cells. */
+bool FMpmcQueueTest::RunTest(const YString& Parameters)
+{
+	TMpmcQueue<int32> Queue(6);
+	TestEqual(TEXT("The capacity must be rounded up to a power of 2"), Queue.Capacity(), 8u);
+
+	int32 Value = -1;
+	TestTrue(TEXT("A new queue must be empty"), Queue.IsEmpty());
+	TestFalse(TEXT("Dequeue must fail on an empty queue"), Queue.Dequeue(Value));
+
+	int32 Next = 0;
+	int32 Expected = 0;
+	bool bInOrder = true;
+	for (int32 Lap = 0; Lap < 5; ++Lap)
+	{
+		for (uint32 Index = 0; Index < Queue.Capacity(); ++Index)
+		{
+			TestTrue(TEXT("Enqueue must succeed until the queue is full"), Queue.Enqueue(Next++));
+		}
+		TestFalse(TEXT("Enqueue must fail on a full queue"), Queue.Enqueue(Next));
+
+		// half out and in again, so the positions of each lap are not aligned on the array
+		for (int32 Index = 0; Index < 3; ++Index)
+		{
+			bInOrder &= Queue.Dequeue(Value) && Value == Expected++;
+		}
+		for (int32 Index = 0; Index < 3; ++Index)
+		{
+			Queue.Enqueue(Next++);
+		}
+		while (Queue.Dequeue(Value))
+		{
+			bInOrder &= Value == Expected++;
+		}
+	}
+	TestTrue(TEXT("Elements must come out in the order they went in"), bInOrder);
+	TestEqual(TEXT("Every element must come out"), Expected, Next);
+	TestTrue(TEXT("A drained queue must be empty"), Queue.IsEmpty());
+
+	// elements left in the queue are destroyed with it
+	TSharedRef<int32> Shared = MakeShareable(new int32(0));
+	{
+		TMpmcQueue<TSharedPtr<int32>> SharedQueue(4);
+		SharedQueue.Enqueue(Shared);
+		SharedQueue.Enqueue(Shared);
+		TSharedPtr<int32> Out;
+		SharedQueue.Dequeue(Out);
+	}
+	TestEqual(TEXT("Destroying the queue must destroy the elements still in it"), Shared.GetSharedReferenceCount(), 1);
+
+	return true;
+}
+
+
+/** Test that with several producers and consumers every element comes out once, in the order its producer added it. */
+bool FMpmcQueueThreadedTest::RunTest(const YString& Parameters)
+{
+	using namespace QueueTest;
+
+	TMpmcQueue<uint32> Queue(1024);
+	FThreadSafeCounter NumConsumed;
+	FThreadSafeCounter NumOutOfOrder;
+	volatile int64 Sum = 0;
+
+	TArray<TFuture<void>> Threads;
+	for (int32 Producer = 0; Producer < NumThreads; ++Producer)
+	{
+		Threads.Add(Async<void>(EAsyncExecution::Thread, [&Queue, Producer]()
+		{
+			for (int32 Index = 0; Index < NumPerProducer; ++Index)
+			{
+				while (!Queue.Enqueue(MakeItem(Producer, Index)))
+				{
+					FPlatformProcess::Sleep(0.0f);
+				}
+			}
+		}));
+	}
+	for (int32 Consumer = 0; Consumer < NumThreads; ++Consumer)
+	{
+		Threads.Add(Async<void>(EAsyncExecution::Thread, [&]()
+		{
+			int32 LastIndex[NumThreads] = { -1, -1, -1, -1 };
+			int64 LocalSum = 0;
+			uint32 Item;
+			while (NumConsumed.GetValue() < NumThreads * NumPerProducer)
+			{
+				if (!Queue.Dequeue(Item))
+				{
+					FPlatformProcess::Sleep(0.0f);
+					continue;
+				}
+				const int32 Producer = Item >> 24;
+				const int32 Index = Item & 0xffffff;
+				if (Index <= LastIndex[Producer])
+				{
+					NumOutOfOrder.Increment();
+				}
+				LastIndex[Producer] = Index;
+				LocalSum += Index;
+				NumConsumed.Increment();
+			}
+			FPlatformAtomics::InterlockedAdd(&Sum, LocalSum);
+		}));
+	}
+	for (TFuture<void>& Thread : Threads)
+	{
+		Thread.Wait();
+	}
+
+	TestEqual(TEXT("Every element must be consumed once"), NumConsumed.GetValue(), NumThreads * NumPerProducer);
+	TestEqual(TEXT("Each producer's elements must come out in order"), NumOutOfOrder.GetValue(), 0);
+	TestEqual(TEXT("No element may be lost or duplicated"), (int64)Sum, int64(NumThreads) * NumPerProducer * (NumPerProducer - 1) / 2);
+	TestTrue(TEXT("The queue must be empty at the end"), Queue.IsEmpty());
+
+	return true;
+}
+
+
+/** Test that the ring buffer is FIFO, reports full and empty, and moves partial batches. */
+bool FSpscRingBufferTest::RunTest(const YString& Parameters)
+{
+	TSpscRingBuffer<int32> Buffer(5);
+	TestEqual(TEXT("The capacity must be rounded up to a power of 2"), Buffer.Capacity(), 8u);
+
+	int32 Value = -1;
+	TestTrue(TEXT("A new buffer must be empty"), Buffer.IsEmpty());
+	TestFalse(TEXT("Dequeue must fail on an empty buffer"), Buffer.Dequeue(Value));
+
+	for (int32 Index = 0; Index < 8; ++Index)
+	{
+		TestTrue(TEXT("Enqueue must succeed until the buffer is full"), Buffer.Enqueue(Index));
+	}
+	TestFalse(TEXT("Enqueue must fail on a full buffer"), Buffer.Enqueue(8));
+	TestEqual(TEXT("The whole capacity must be usable"), Buffer.Count(), 8u);
+
+	int32 Batch[8];
+	TestEqual(TEXT("DequeueMany must stop at what is buffered"), Buffer.DequeueMany(Batch, 3), 3u);
+	TestTrue(TEXT("DequeueMany must return the oldest elements in order"), Batch[0] == 0 && Batch[1] == 1 && Batch[2] == 2);
+
+	// wraps around the end of the array
+	const int32 More[5] = { 8, 9, 10, 11, 12 };
+	TestEqual(TEXT("EnqueueMany must only add what fits"), Buffer.EnqueueMany(More, 5), 3u);
+	TestEqual(TEXT("EnqueueMany must add nothing to a full buffer"), Buffer.EnqueueMany(More + 3, 2), 0u);
+
+	TestEqual(TEXT("DequeueMany must stop at what is buffered"), Buffer.DequeueMany(Batch, 8), 8u);
+	bool bInOrder = true;
+	for (int32 Index = 0; Index < 8; ++Index)
+	{
+		bInOrder &= Batch[Index] == Index + 3;
+	}
+	TestTrue(TEXT("Elements must come out in the order they went in"), bInOrder);
+	TestTrue(TEXT("A drained buffer must be empty"), Buffer.IsEmpty());
+	TestEqual(TEXT("DequeueMany must return nothing from an empty buffer"), Buffer.DequeueMany(Batch, 8), 0u);
+
+	// elements left in the buffer are destroyed with it
+	TSharedRef<int32> Shared = MakeShareable(new int32(0));
+	{
+		TSpscRingBuffer<TSharedPtr<int32>> SharedBuffer(4);
+		SharedBuffer.Enqueue(Shared);
+		SharedBuffer.Enqueue(Shared);
+		TSharedPtr<int32> Out;
+		SharedBuffer.Dequeue(Out);
+	}
+	TestEqual(TEXT("Destroying the buffer must destroy the elements still in it"), Shared.GetSharedReferenceCount(), 1);
+
+	return true;
+}
+
+
+/** Test that a producer and a consumer moving batches of different sizes see every element in order. */
+bool FSpscRingBufferThreadedTest::RunTest(const YString& Parameters)
+{
+	using namespace QueueTest;
+
+	const uint32 NumItems = NumThreads * NumPerProducer;
+	TSpscRingBuffer<uint32> Buffer(256);
+
+	TFuture<void> Producer = Async<void>(EAsyncExecution::Thread, [&Buffer, NumItems]()
+	{
+		uint32 Batch[7];
+		uint32 Next = 0;
+		while (Next < NumItems)
+		{
+			// alternate single elements and batches
+			if (Next & 1)
+			{
+				Next += Buffer.Enqueue(Next) ? 1 : 0;
+				continue;
+			}
+			const uint32 Num = YMath::Min<uint32>(7, NumItems - Next);
+			for (uint32 Index = 0; Index < Num; ++Index)
+			{
+				Batch[Index] = Next + Index;
+			}
+			const uint32 NumAdded = Buffer.EnqueueMany(Batch, Num);
+			Next += NumAdded;
+			if (!NumAdded)
+			{
+				FPlatformProcess::Sleep(0.0f);
+			}
+		}
+	});
+
+	uint32 Expected = 0;
+	uint32 NumOutOfOrder = 0;
+	uint32 Batch[13];
+	while (Expected < NumItems)
+	{
+		const uint32 Num = Buffer.DequeueMany(Batch, 13);
+		for (uint32 Index = 0; Index < Num; ++Index)
+		{
+			NumOutOfOrder += Batch[Index] != Expected++ ? 1 : 0;
+		}
+		if (!Num)
+		{
+			FPlatformProcess::Sleep(0.0f);
+		}
+	}
+	Producer.Wait();
+
+	TestEqual(TEXT("Every element must come out once and in order"), NumOutOfOrder, 0u);
+	TestTrue(TEXT("The buffer must be empty at the end"), Buffer.IsEmpty());
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,70 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "HAL/MallocGuard.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMallocGuardOverrunTest, "System.Core.HAL.MallocGuard.Overrun", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FMallocGuardOverrunTest::RunTest(const YString& Parameters)
+{
+	const YPlatformMemoryConstants& Constants = YPlatformMemory::GetConstants();
+	const UPTRINT PageSize = Constants.OsAllocationGranularity ? Constants.OsAllocationGranularity : Constants.PageSize;
+	const SIZE_T Size = 13;
+
+	// Not installed as GMalloc, every allocation after the first one of this thread is sampled
+	FMallocGuardProxy* Proxy = new FMallocGuardProxy(GMalloc, 1, 4);
+
+	// Sampled blocks alternate between the end and the start of their page, the overrun needs one at the end
+	uint8* Block = nullptr;
+	for (int32 Attempt = 0; Attempt < 4 && !Block; ++Attempt)
+	{
+		uint8* Ptr = (uint8*)Proxy->Malloc(Size, DEFAULT_ALIGNMENT);
+		if (Proxy->IsGuarded(Ptr) && ((UPTRINT)Ptr & (PageSize - 1)) != 0)
+		{
+			Block = Ptr;
+		}
+		else
+		{
+			Proxy->Free(Ptr);
+		}
+	}
+
+	TestNotNull(TEXT("A sampled block is placed at the end of its page"), Block);
+	if (!Block)
+	{
+		delete Proxy;
+		return false;
+	}
+
+	const UPTRINT GuardPage = Align((UPTRINT)Block + Size, PageSize);
+	TestTrue(TEXT("The block leaves less than its alignment before the guard page"), GuardPage - ((UPTRINT)Block + Size) < 8);
+
+	const bool bValidBefore = Proxy->ValidateHeap();
+
+	// Overruns that stay on the block's page only show up in the fill pattern, the errors they log are expected
+	SetSuppressLogs(true);
+	const uint8 Saved = Block[Size];
+	Block[Size] = Saved + 1;
+	const bool bValidAfterOverrun = Proxy->ValidateHeap();
+	Block[Size] = Saved;
+
+	// Overruns into the guard page fault, this is what the fault handler reports for them
+	const bool bFaultReported = Proxy->ReportFault((const void*)GuardPage);
+	const bool bUnrelatedReported = Proxy->ReportFault(&Saved);
+	SetSuppressLogs(false);
+
+	TestTrue(TEXT("A block that is used within its bounds validates"), bValidBefore);
+	TestFalse(TEXT("A write past the end of the block is caught"), bValidAfterOverrun);
+	TestTrue(TEXT("A fault in the guard page after the block is reported"), bFaultReported);
+	TestFalse(TEXT("A fault outside the pool is left alone"), bUnrelatedReported);
+
+	Proxy->Free(Block);
+	delete Proxy;
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,81 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Containers/Array.h"
+#include "Misc/MemArena.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMemArenaTest, "System.Core.Misc.MemArena", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FMemArenaTest::RunTest(const YString& Parameters)
+{
+	typedef TArray<int32, TArenaAllocator<>> FArenaArray;
+
+	FMemArena Arena;
+	FMemArenaScope Scope(Arena);
+
+	// The most recent allocation grows in place while there is no mark
+	{
+		FArenaArray Array;
+		Array.Reserve(4);
+		const int32* Data = Array.GetData();
+		Array.Reserve(64);
+		TestEqual(TEXT("Growing the top allocation must not move it"), (const int32*)Array.GetData(), Data);
+	}
+	Arena.Reset();
+
+	// Containers allocated before a mark must not grow into memory the mark frees, whether they are at the top of the arena or not
+	for (int32 bAtTop = 0; bAtTop < 2; ++bAtTop)
+	{
+		FArenaArray Array;
+		for (int32 Index = 0; Index < 4; ++Index)
+		{
+			Array.Add(Index);
+		}
+		FArenaArray Above;
+		if (!bAtTop)
+		{
+			Above.Add(0);
+		}
+		const int32* Data = Array.GetData();
+		{
+			FMemArenaMark Mark(Arena);
+			for (int32 Index = 4; Index < 64; ++Index)
+			{
+				Array.Add(Index);
+			}
+			TestNotEqual(TEXT("Growing an allocation made before the mark must move it"), (const int32*)Array.GetData(), Data);
+		}
+
+		FArenaArray Other;
+		for (int32 Index = 0; Index < 64; ++Index)
+		{
+			Other.Add(-1);
+		}
+
+		bool bIntact = Array.Num() == 64;
+		for (int32 Index = 0; Index < Array.Num(); ++Index)
+		{
+			bIntact &= Array[Index] == Index;
+		}
+		TestTrue(TEXT("Allocations after popping the mark must not overwrite the grown container"), bIntact);
+		Arena.Reset();
+	}
+
+	// Allocations made after the mark still grow in place
+	{
+		FMemArenaMark Mark(Arena);
+		FArenaArray Array;
+		Array.Reserve(4);
+		const int32* Data = Array.GetData();
+		Array.Reserve(64);
+		TestEqual(TEXT("Growing an allocation made after the mark must not move it"), (const int32*)Array.GetData(), Data);
+	}
+	TestEqual(TEXT("Popping the mark must free everything allocated after it"), Arena.GetByteCount(), (SIZE_T)0);
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
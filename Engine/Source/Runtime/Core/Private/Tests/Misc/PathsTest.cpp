@@ -3,7 +3,9 @@
 #include "CoreTypes.h"
 #include "Misc/AssertionMacros.h"
 #include "Containers/SolidAngleString.h"
+#include "Containers/StringView.h"
 #include "Misc/Paths.h"
+#include "Misc/Parse.h"
 #include "Misc/AutomationTest.h"
 
 YString YPaths::GameProjectFilePath;
@@ -11,6 +13,8 @@ YString YPaths::GameProjectFilePath;
 #if WITH_DEV_AUTOMATION_TESTS
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPathTests, "System.Core.Misc.Paths", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPathViewTests, "System.Core.Misc.PathViews", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStringViewOverloadTests, "System.Core.Misc.StringViewOverloads", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
 
 bool FPathTests::RunTest( const YString& Parameters )
 {
@@ -90,5 +94,163 @@ bool FPathTests::RunTest( const YString& Parameters )
 	return true;
 }
 
+bool FPathViewTests::RunTest( const YString& Parameters )
+{
+	const TCHAR* Paths[] =
+	{
+		TEXT(""),
+		TEXT("file"),
+		TEXT("file.txt"),
+		TEXT(".hidden"),
+		TEXT("Folder/"),
+		TEXT("C:/Folder/file.txt"),
+		TEXT("C:\\Folder\\file.tar.gz"),
+		TEXT("/Folder.ext/file"),
+		TEXT("C:/Folder/.svn"),
+		TEXT("../Relative/Path/name.ext"),
+		TEXT("Mixed\\Slashes/name.ext//"),
+	};
+
+	// The views must match the owned versions, and point into the path rather than copy it
+	for (const TCHAR* Path : Paths)
+	{
+		const YString PathString(Path);
+		const YStringView PathView(PathString);
+		const TCHAR* Begin = PathView.GetData();
+		const TCHAR* End = Begin + PathView.Len();
+
+		auto TestView = [this, Path, Begin, End](const TCHAR* What, const YStringView& View, const YString& Expected)
+		{
+			TestEqual(YString::Printf(TEXT("%s of '%s'"), What, Path), View.ToString(), Expected);
+			if (!View.IsEmpty())
+			{
+				TestTrue(YString::Printf(TEXT("%s of '%s' must point into the path"), What, Path), View.GetData() >= Begin && View.GetData() + View.Len() <= End);
+			}
+		};
+
+		TestView(TEXT("GetExtensionView"),         YPaths::GetExtensionView(PathView),           YPaths::GetExtension(PathString));
+		TestView(TEXT("GetExtensionView with dot"), YPaths::GetExtensionView(PathView, true),     YPaths::GetExtension(PathString, true));
+		TestView(TEXT("GetCleanFilenameView"),     YPaths::GetCleanFilenameView(PathView),       YPaths::GetCleanFilename(PathString));
+		TestView(TEXT("GetBaseFilenameView"),      YPaths::GetBaseFilenameView(PathView),        YPaths::GetBaseFilename(PathString));
+		TestView(TEXT("GetBaseFilenameView with path"), YPaths::GetBaseFilenameView(PathView, false), YPaths::GetBaseFilename(PathString, false));
+		TestView(TEXT("GetPathView"),              YPaths::GetPathView(PathView),                YPaths::GetPath(PathString));
+
+		YString PathPart, FilenamePart, ExtensionPart;
+		YPaths::Split(PathString, PathPart, FilenamePart, ExtensionPart);
+		YStringView PathPartView, FilenamePartView, ExtensionPartView;
+		YPaths::Split(PathView, PathPartView, FilenamePartView, ExtensionPartView);
+		TestView(TEXT("Split path"),               PathPartView,                                 PathPart);
+		TestView(TEXT("Split filename"),           FilenamePartView,                             FilenamePart);
+		TestView(TEXT("Split extension"),          ExtensionPartView,                            ExtensionPart);
+	}
+
+	// Views need not be null terminated, nothing past their end may be read
+	{
+		const YStringView Path(TEXT("C:/Folder/file.txt/More/other.ext"), 18);
+		TestEqual(TEXT("GetExtensionView must stop at the end of the view"), YPaths::GetExtensionView(Path).ToString(), YString(TEXT("txt")));
+		TestEqual(TEXT("GetCleanFilenameView must stop at the end of the view"), YPaths::GetCleanFilenameView(Path).ToString(), YString(TEXT("file.txt")));
+		TestEqual(TEXT("GetBaseFilenameView must stop at the end of the view"), YPaths::GetBaseFilenameView(Path).ToString(), YString(TEXT("file")));
+		TestEqual(TEXT("GetPathView must stop at the end of the view"), YPaths::GetPathView(Path).ToString(), YString(TEXT("C:/Folder")));
+	}
+
+	return true;
+}
+
+bool FStringViewOverloadTests::RunTest( const YString& Parameters )
+{
+	const YString String(TEXT("C:/Folder/Sub/file.txt"));
+
+	// Find with a view must match Find with the same characters, even when the view is not null terminated
+	{
+		const YStringView Folder(TEXT("folderXYZ"), 6);
+		TestEqual(TEXT("Find with a view must ignore case by default"), String.Find(Folder), String.Find(TEXT("folder")));
+		TestEqual(TEXT("Find with a view must find the first match"), String.Find(Folder), 3);
+		TestEqual(TEXT("Find with a view may be case sensitive"), String.Find(Folder, ESearchCase::CaseSensitive), (int32)INDEX_NONE);
+		TestEqual(TEXT("Find with a view may search from the end"), String.Find(YStringView(TEXT("/")), ESearchCase::IgnoreCase, ESearchDir::FromEnd), String.Find(TEXT("/"), ESearchCase::IgnoreCase, ESearchDir::FromEnd));
+		TestEqual(TEXT("Find with a view must start at the start position"), String.Find(YStringView(TEXT("/")), ESearchCase::IgnoreCase, ESearchDir::FromStart, 3), String.Find(TEXT("/"), ESearchCase::IgnoreCase, ESearchDir::FromStart, 3));
+		TestEqual(TEXT("Find with a view must not find what is missing"), String.Find(YStringView(TEXT("missing"))), (int32)INDEX_NONE);
+	}
+
+	// Split into views must match Split into strings, with the views pointing into the string
+	{
+		for (int32 bFromEnd = 0; bFromEnd < 2; ++bFromEnd)
+		{
+			const ESearchDir::Type SearchDir = bFromEnd ? ESearchDir::FromEnd : ESearchDir::FromStart;
+			YString Left, Right;
+			YStringView LeftView, RightView;
+			TestTrue(TEXT("Split must split at the separator"), String.Split(TEXT("/"), &Left, &Right, ESearchCase::IgnoreCase, SearchDir));
+			TestTrue(TEXT("Split into views must split at the separator"), String.Split(YStringView(TEXT("/")), &LeftView, &RightView, ESearchCase::IgnoreCase, SearchDir));
+			TestEqual(TEXT("Split into views must give the same left part"), LeftView.ToString(), Left);
+			TestEqual(TEXT("Split into views must give the same right part"), RightView.ToString(), Right);
+			TestTrue(TEXT("The left view must point into the string"), LeftView.GetData() == *String);
+			TestTrue(TEXT("The right view must point into the string"), RightView.GetData() + RightView.Len() == *String + String.Len());
+		}
+
+		YStringView LeftView(TEXT("unchanged")), RightView(TEXT("unchanged"));
+		TestFalse(TEXT("Split into views must fail without the separator"), String.Split(YStringView(TEXT("|")), &LeftView, &RightView));
+		TestEqual(TEXT("A failed split must leave the views alone"), LeftView.ToString(), YString(TEXT("unchanged")));
+	}
+
+	// StartsWith and EndsWith with views
+	{
+		TestTrue(TEXT("StartsWith a view"), String.StartsWith(YStringView(TEXT("c:/folderXYZ"), 8)));
+		TestFalse(TEXT("StartsWith a view may be case sensitive"), String.StartsWith(YStringView(TEXT("c:/folder")), ESearchCase::CaseSensitive));
+		TestFalse(TEXT("StartsWith a view longer than the string"), String.StartsWith(YStringView(TEXT("C:/Folder/Sub/file.txt.bak"))));
+		TestTrue(TEXT("EndsWith a view"), String.EndsWith(YStringView(TEXT(".TXT"))));
+		TestFalse(TEXT("EndsWith a view may be case sensitive"), String.EndsWith(YStringView(TEXT(".TXT")), ESearchCase::CaseSensitive));
+		TestEqual(TEXT("StartsWith an empty view must match StartsWith an empty string"), String.StartsWith(YStringView()), String.StartsWith(TEXT("")));
+		TestEqual(TEXT("EndsWith an empty view must match EndsWith an empty string"), String.EndsWith(YStringView()), String.EndsWith(TEXT("")));
+	}
+
+	// FParse::Value into a buffer copies out of the view
+	{
+		const TCHAR* Stream = TEXT("-Name=Value1,Rest -Quoted=\"A B\" \"-Full=C D\" -Short=0123456789");
+		const TCHAR* Matches[] = { TEXT("Name="), TEXT("Quoted="), TEXT("Full="), TEXT("Short=") };
+		for (const TCHAR* Match : Matches)
+		{
+			for (int32 bStopOnComma = 0; bStopOnComma < 2; ++bStopOnComma)
+			{
+				TCHAR Buffer[64];
+				YStringView View;
+				TestTrue(TEXT("Value into a buffer must find the match"), FParse::Value(Stream, Match, Buffer, ARRAY_COUNT(Buffer), !!bStopOnComma));
+				TestTrue(TEXT("Value into a view must find the match"), FParse::Value(Stream, Match, View, !!bStopOnComma));
+				TestEqual(TEXT("Value into a buffer must match Value into a view"), YString(Buffer), View.ToString());
+			}
+		}
+
+		TCHAR Buffer[64];
+		FParse::Value(Stream, TEXT("Name="), Buffer, ARRAY_COUNT(Buffer));
+		TestEqual(TEXT("Value must stop on a comma"), YString(Buffer), YString(TEXT("Value1")));
+		FParse::Value(Stream, TEXT("Quoted="), Buffer, ARRAY_COUNT(Buffer));
+		TestEqual(TEXT("Value must take a quoted argument"), YString(Buffer), YString(TEXT("A B")));
+		FParse::Value(Stream, TEXT("Full="), Buffer, ARRAY_COUNT(Buffer));
+		TestEqual(TEXT("Value must take a fully quoted option"), YString(Buffer), YString(TEXT("C D")));
+		FParse::Value(Stream, TEXT("Short="), Buffer, 5);
+		TestEqual(TEXT("Value must truncate to the buffer"), YString(Buffer), YString(TEXT("0123")));
+		TestFalse(TEXT("Value must fail without the match"), FParse::Value(Stream, TEXT("Missing="), Buffer, ARRAY_COUNT(Buffer)));
+	}
+
+	// ParseIntoArray into views must match ParseIntoArray into strings
+	{
+		const YString List(TEXT("a,,bb,ccc,"));
+		for (int32 bCullEmpty = 0; bCullEmpty < 2; ++bCullEmpty)
+		{
+			TArray<YString> Pieces;
+			TArray<YStringView> PieceViews;
+			const int32 NumPieces = List.ParseIntoArray(Pieces, TEXT(","), !!bCullEmpty);
+			TestEqual(TEXT("ParseIntoArray into views must find as many pieces"), List.ParseIntoArray(PieceViews, TEXT(","), !!bCullEmpty), NumPieces);
+			if (PieceViews.Num() == Pieces.Num())
+			{
+				for (int32 Index = 0; Index < Pieces.Num(); ++Index)
+				{
+					TestEqual(TEXT("ParseIntoArray into views must find the same pieces"), PieceViews[Index].ToString(), Pieces[Index]);
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
 
 #endif //WITH_DEV_AUTOMATION_TESTS
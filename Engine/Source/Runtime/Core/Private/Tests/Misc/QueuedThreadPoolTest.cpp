@@ -0,0 +1,325 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/IQueuedWork.h"
+#include "Misc/QueuedThreadPool.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQueuedThreadPoolGrowTest, "System.Core.Misc.QueuedThreadPool (Grow)", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQueuedThreadPoolPriorityTest, "System.Core.Misc.QueuedThreadPool (Priority)", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQueuedThreadPoolRetractTest, "System.Core.Misc.QueuedThreadPool (Retract)", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQueuedThreadPoolRetireTest, "System.Core.Misc.QueuedThreadPool (Retire)", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+
+/** Work that blocks until released, or that only counts itself. */
+class FQueuedThreadPoolTestWork : public IQueuedWork
+{
+public:
+
+	FQueuedThreadPoolTestWork(FEvent* InReleaseEvent, FThreadSafeCounter& InNumDone)
+		: ReleaseEvent(InReleaseEvent)
+		, NumDone(InNumDone)
+	{ }
+
+	virtual void DoThreadedWork() override
+	{
+		if (ReleaseEvent)
+		{
+			ReleaseEvent->Wait();
+		}
+		NumDone.Increment();
+	}
+
+	virtual void Abandon() override
+	{
+	}
+
+private:
+
+	FEvent* ReleaseEvent;
+	FThreadSafeCounter& NumDone;
+};
+
+
+/** Work that records when it ran relative to the other work of a test. */
+class FQueuedThreadPoolOrderedWork : public IQueuedWork
+{
+public:
+
+	FQueuedThreadPoolOrderedWork()
+		: Order(nullptr)
+		, NumDone(nullptr)
+		, Id(INDEX_NONE)
+		, bAbandoned(false)
+	{ }
+
+	void Init(int32* InOrder, FThreadSafeCounter* InNumDone, int32 InId)
+	{
+		Order = InOrder;
+		NumDone = InNumDone;
+		Id = InId;
+	}
+
+	virtual void DoThreadedWork() override
+	{
+		Order[NumDone->Increment() - 1] = Id;
+	}
+
+	virtual void Abandon() override
+	{
+		bAbandoned = true;
+	}
+
+	bool WasAbandoned() const
+	{
+		return bAbandoned;
+	}
+
+private:
+
+	int32* Order;
+	FThreadSafeCounter* NumDone;
+	int32 Id;
+	bool bAbandoned;
+};
+
+
+namespace QueuedThreadPoolTest
+{
+	/** Sleeps until the counter reaches the value, for five seconds at most. */
+	void WaitForCount(const FThreadSafeCounter& Counter, int32 Value)
+	{
+		for (int32 Wait = 0; Wait < 500 && Counter.GetValue() < Value; ++Wait)
+		{
+			FPlatformProcess::Sleep(0.01f);
+		}
+	}
+}
+
+
+/** Test that a pool whose threads all block grows without more work being queued. */
+bool FQueuedThreadPoolGrowTest::RunTest(const YString& Parameters)
+{
+	FQueuedThreadPool* Pool = FQueuedThreadPool::Allocate();
+	Pool->Create(2);
+	Pool->SetElasticLimits(2, 3, 0.01, 0.0);
+
+	FEvent* ReleaseEvent = FPlatformProcess::GetSynchEventFromPool(true);
+	FThreadSafeCounter NumDone;
+	FQueuedThreadPoolTestWork Blocking[2] = { { ReleaseEvent, NumDone }, { ReleaseEvent, NumDone } };
+	FQueuedThreadPoolTestWork Queued(nullptr, NumDone);
+	Pool->AddQueuedWork(&Blocking[0]);
+	Pool->AddQueuedWork(&Blocking[1]);
+	Pool->AddQueuedWork(&Queued);
+
+	for (int32 Wait = 0; Wait < 500 && NumDone.GetValue() == 0; ++Wait)
+	{
+		FPlatformProcess::Sleep(0.01f);
+	}
+	TestEqual(TEXT("Work queued behind blocked threads must run on an added thread"), NumDone.GetValue(), 1);
+	TestEqual(TEXT("The pool must not grow past its maximum"), Pool->GetNumThreads(), 3);
+
+	ReleaseEvent->Trigger();
+	Pool->Destroy();
+	delete Pool;
+	FPlatformProcess::ReturnSynchEventToPool(ReleaseEvent);
+
+	TestEqual(TEXT("Blocked work must finish once released"), NumDone.GetValue(), 3);
+
+	return true;
+}
+
+
+
+/** Test that queued work runs from the highest priority band down, in the order it was queued within a band. */
+bool FQueuedThreadPoolPriorityTest::RunTest(const YString& Parameters)
+{
+	FQueuedThreadPool* Pool = FQueuedThreadPool::Allocate();
+	Pool->Create(1);
+
+	FEvent* ReleaseEvent = FPlatformProcess::GetSynchEventFromPool(true);
+	FThreadSafeCounter NumBlockingDone;
+	FQueuedThreadPoolTestWork Blocking(ReleaseEvent, NumBlockingDone);
+	Pool->AddQueuedWork(&Blocking);
+
+	// Ids are the expected order
+	const EQueuedWorkPriority Priorities[] = { EQueuedWorkPriority::Low, EQueuedWorkPriority::Highest, EQueuedWorkPriority::Normal, EQueuedWorkPriority::Lowest, EQueuedWorkPriority::Highest, EQueuedWorkPriority::High, EQueuedWorkPriority::Normal };
+	const int32 ExpectedIds[] = { 5, 0, 3, 6, 1, 2, 4 };
+	const int32 NumWork = ARRAY_COUNT(Priorities);
+	int32 Order[NumWork];
+	FThreadSafeCounter NumDone;
+	FQueuedThreadPoolOrderedWork Work[NumWork];
+	for (int32 Index = 0; Index < NumWork; ++Index)
+	{
+		Work[Index].Init(Order, &NumDone, ExpectedIds[Index]);
+		Pool->AddQueuedWork(&Work[Index], Priorities[Index]);
+	}
+
+	FQueuedThreadPoolStats Stats;
+	Pool->GetStats(Stats);
+	TestEqual(TEXT("The only thread is busy"), Stats.NumIdleThreads, 0);
+	TestEqual(TEXT("Two items wait in the highest band"), Stats.NumQueued[(int32)EQueuedWorkPriority::Highest], 2);
+	TestEqual(TEXT("One item waits in the high band"), Stats.NumQueued[(int32)EQueuedWorkPriority::High], 1);
+	TestEqual(TEXT("Two items wait in the normal band"), Stats.NumQueued[(int32)EQueuedWorkPriority::Normal], 2);
+	TestEqual(TEXT("One item waits in the low band"), Stats.NumQueued[(int32)EQueuedWorkPriority::Low], 1);
+	TestEqual(TEXT("One item waits in the lowest band"), Stats.NumQueued[(int32)EQueuedWorkPriority::Lowest], 1);
+	TestEqual(TEXT("The peak counts all the queued work"), Stats.PeakNumQueued, NumWork);
+	TestEqual(TEXT("Only the blocking work has started"), Stats.NumStarted, (uint64)1);
+
+	ReleaseEvent->Trigger();
+	QueuedThreadPoolTest::WaitForCount(NumDone, NumWork);
+	TestEqual(TEXT("All the queued work must run"), NumDone.GetValue(), NumWork);
+	if (NumDone.GetValue() == NumWork)
+	{
+		for (int32 Index = 0; Index < NumWork; ++Index)
+		{
+			TestEqual(TEXT("Work must run by band, then in queue order"), Order[Index], Index);
+		}
+	}
+
+	Pool->GetStats(Stats);
+	TestEqual(TEXT("Every item was started"), Stats.NumStarted, (uint64)(NumWork + 1));
+	TestEqual(TEXT("Nothing waits anymore"), Stats.NumQueued[(int32)EQueuedWorkPriority::Normal], 0);
+	TestTrue(TEXT("Queued work waited for the blocking work"), Stats.MaxWaitSeconds > 0.0 && Stats.TotalWaitSeconds >= Stats.MaxWaitSeconds);
+
+	Pool->Destroy();
+	delete Pool;
+	FPlatformProcess::ReturnSynchEventToPool(ReleaseEvent);
+
+	return true;
+}
+
+
+/** Test that queued work can be retracted from anywhere in its band, and that the rest still runs in order. */
+bool FQueuedThreadPoolRetractTest::RunTest(const YString& Parameters)
+{
+	FQueuedThreadPool* Pool = FQueuedThreadPool::Allocate();
+	Pool->Create(1);
+
+	FEvent* ReleaseEvent = FPlatformProcess::GetSynchEventFromPool(true);
+	FThreadSafeCounter NumBlockingDone;
+	FQueuedThreadPoolTestWork Blocking(ReleaseEvent, NumBlockingDone);
+	Pool->AddQueuedWork(&Blocking);
+
+	// Enough work that retracting it would take a while if each retraction searched the queue
+	const int32 NumWork = 10000;
+	TArray<int32> Order;
+	Order.AddZeroed(NumWork);
+	TArray<FQueuedThreadPoolOrderedWork> Work;
+	Work.AddDefaulted(NumWork);
+	FThreadSafeCounter NumDone;
+	for (int32 Index = 0; Index < NumWork; ++Index)
+	{
+		Work[Index].Init(Order.GetData(), &NumDone, Index);
+		Pool->AddQueuedWork(&Work[Index], Index % 2 ? EQueuedWorkPriority::Low : EQueuedWorkPriority::High);
+	}
+
+	// Every third item, from the back so that each one is deep in its band
+	int32 NumRetracted = 0;
+	bool bAllRetracted = true;
+	for (int32 Index = NumWork - 1; Index >= 0; --Index)
+	{
+		if (Index % 3 == 0)
+		{
+			bAllRetracted &= Pool->RetractQueuedWork(&Work[Index]);
+			++NumRetracted;
+		}
+	}
+	TestTrue(TEXT("Queued work must be retracted"), bAllRetracted);
+	TestFalse(TEXT("Work can only be retracted once"), Pool->RetractQueuedWork(&Work[0]));
+	TestFalse(TEXT("The running work can't be retracted"), Pool->RetractQueuedWork(&Blocking));
+
+	FQueuedThreadPoolStats Stats;
+	Pool->GetStats(Stats);
+	TestEqual(TEXT("The retractions are counted"), Stats.NumRetracted, (uint64)NumRetracted);
+	TestEqual(TEXT("Retracted work leaves its band"), Stats.NumQueued[(int32)EQueuedWorkPriority::High] + Stats.NumQueued[(int32)EQueuedWorkPriority::Low], NumWork - NumRetracted);
+
+	ReleaseEvent->Trigger();
+	QueuedThreadPoolTest::WaitForCount(NumDone, NumWork - NumRetracted);
+	FPlatformProcess::Sleep(0.01f);
+	TestEqual(TEXT("Only the work that was left must run"), NumDone.GetValue(), NumWork - NumRetracted);
+	if (NumDone.GetValue() == NumWork - NumRetracted)
+	{
+		// The high band holds the even items and runs first
+		int32 Expected = 0;
+		bool bInOrder = true;
+		for (int32 Band = 0; Band < 2; ++Band)
+		{
+			for (int32 Index = Band; Index < NumWork; Index += 2)
+			{
+				if (Index % 3)
+				{
+					bInOrder &= Order[Expected++] == Index;
+				}
+			}
+		}
+		TestTrue(TEXT("The work that was left must run in order"), bInOrder);
+	}
+
+	Pool->Destroy();
+	delete Pool;
+	FPlatformProcess::ReturnSynchEventToPool(ReleaseEvent);
+
+	bool bAnyAbandoned = false;
+	for (const FQueuedThreadPoolOrderedWork& Item : Work)
+	{
+		bAnyAbandoned |= Item.WasAbandoned();
+	}
+	TestFalse(TEXT("Retracted work must not be abandoned"), bAnyAbandoned);
+
+	return true;
+}
+
+
+/** Test that threads added for stalled work retire once they have been idle long enough, down to the minimum. */
+bool FQueuedThreadPoolRetireTest::RunTest(const YString& Parameters)
+{
+	FQueuedThreadPool* Pool = FQueuedThreadPool::Allocate();
+	Pool->Create(1);
+	Pool->SetElasticLimits(1, 4, 0.0, 0.05);
+
+	FEvent* ReleaseEvent = FPlatformProcess::GetSynchEventFromPool(true);
+	FThreadSafeCounter NumDone;
+	FQueuedThreadPoolTestWork Blocking[4] = { { ReleaseEvent, NumDone }, { ReleaseEvent, NumDone }, { ReleaseEvent, NumDone }, { ReleaseEvent, NumDone } };
+	for (FQueuedThreadPoolTestWork& Work : Blocking)
+	{
+		Pool->AddQueuedWork(&Work);
+	}
+	TestEqual(TEXT("The pool must grow to run the blocked work"), Pool->GetNumThreads(), 4);
+
+	ReleaseEvent->Trigger();
+	QueuedThreadPoolTest::WaitForCount(NumDone, 4);
+	TestEqual(TEXT("The blocked work must finish once released"), NumDone.GetValue(), 4);
+
+	for (int32 Wait = 0; Wait < 500 && Pool->GetNumThreads() > 1; ++Wait)
+	{
+		FPlatformProcess::Sleep(0.01f);
+	}
+	TestEqual(TEXT("Idle threads must retire down to the minimum"), Pool->GetNumThreads(), 1);
+
+	FQueuedThreadPoolStats Stats;
+	Pool->GetStats(Stats);
+	TestEqual(TEXT("The added threads are counted"), Stats.NumThreadsAdded, (uint32)3);
+	TestEqual(TEXT("The retired threads are counted"), Stats.NumThreadsRetired, (uint32)3);
+	TestEqual(TEXT("The thread that is left is idle"), Stats.NumIdleThreads, 1);
+	TestTrue(TEXT("The time spent in work is counted"), Stats.TotalRunSeconds > 0.0);
+
+	// The minimum stays, and takes new work
+	FQueuedThreadPoolTestWork Queued(nullptr, NumDone);
+	Pool->AddQueuedWork(&Queued);
+	QueuedThreadPoolTest::WaitForCount(NumDone, 5);
+	TestEqual(TEXT("The thread that is left must take new work"), NumDone.GetValue(), 5);
+
+	Pool->Destroy();
+	delete Pool;
+	FPlatformProcess::ReturnSynchEventToPool(ReleaseEvent);
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -136,7 +136,37 @@ YMalloc* YWindowsPlatformMemory::BaseAllocator()
 		return new TMallocTBB();
 #endif
 	case EMemoryAllocatorToUse::Binned2:
-		return new YMallocBinned2();
+	{
+		bool bUseHugePages = BINNED2_USE_HUGE_PAGES;
+		bool bUseNuma = BINNED2_USE_NUMA;
+#if !UE_BUILD_SHIPPING
+		bUseHugePages = bUseHugePages || FCString::Stristr(::GetCommandLineW(), TEXT("-hugepages")) != nullptr;
+		bUseNuma = bUseNuma || FCString::Stristr(::GetCommandLineW(), TEXT("-numa")) != nullptr;
+#endif
+		// -binned2sizes=16,32,... or -binned2sizes=<file written by MallocBinned2.SaveSizeClasses>, quotes allowed
+		static const TCHAR SizesSwitch[] = TEXT("-binned2sizes=");
+		if (const TCHAR* SizesArg = FCString::Stristr(::GetCommandLineW(), SizesSwitch))
+		{
+			SizesArg += ARRAY_COUNT(SizesSwitch) - 1;
+			const TCHAR Terminator = *SizesArg == TEXT('"') ? TEXT('"') : TEXT(' ');
+			SizesArg += Terminator == TEXT('"') ? 1 : 0;
+
+			ANSICHAR SizesValue[1024];
+			int32 Len = 0;
+			for (; SizesArg[Len] && SizesArg[Len] != Terminator && Len < ARRAY_COUNT(SizesValue) - 1; ++Len)
+			{
+				SizesValue[Len] = ANSICHAR(SizesArg[Len]);
+			}
+			SizesValue[Len] = 0;
+
+			uint16 SmallBlockSizes[BINNED2_SMALL_POOL_COUNT];
+			if (YMallocBinned2::ParseSmallBlockSizes(SizesValue, SmallBlockSizes))
+			{
+				return new YMallocBinned2(bUseHugePages, SmallBlockSizes, bUseNuma);
+			}
+		}
+		return new YMallocBinned2(bUseHugePages, nullptr, bUseNuma);
+	}
 
 	default:	// intentional fall-through
 	case EMemoryAllocatorToUse::Binned:
@@ -263,6 +293,84 @@ void YWindowsPlatformMemory::BinnedFreeToOS(void* Ptr, SIZE_T Size)
 		verify(VirtualFree(Ptr, 0, MEM_RELEASE) != 0);
 }
 
+namespace WindowsPlatformMemory
+{
+	/** Large pages need SeLockMemoryPrivilege to be enabled on the process token, returns true if it is. */
+	static bool EnableLockMemoryPrivilege()
+	{
+		static int32 bEnabled = -1;
+		if (bEnabled == -1)
+		{
+			bEnabled = 0;
+			HANDLE Token = nullptr;
+			if (::OpenProcessToken(::GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &Token))
+			{
+				TOKEN_PRIVILEGES Privileges;
+				Privileges.PrivilegeCount = 1;
+				Privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+				if (::LookupPrivilegeValueW(nullptr, SE_LOCK_MEMORY_NAME, &Privileges.Privileges[0].Luid))
+				{
+					// AdjustTokenPrivileges succeeds even if the privilege wasn't granted, so check the last error too
+					bEnabled = ::AdjustTokenPrivileges(Token, 0, &Privileges, 0, nullptr, nullptr) && ::GetLastError() == ERROR_SUCCESS;
+				}
+				::CloseHandle(Token);
+			}
+		}
+		return bEnabled == 1;
+	}
+}
+
+SIZE_T YWindowsPlatformMemory::GetHugePageSize()
+{
+	const SIZE_T LargePageMinimum = ::GetLargePageMinimum();
+	return LargePageMinimum ? LargePageMinimum : YGenericPlatformMemory::GetHugePageSize();
+}
+
+void* YWindowsPlatformMemory::HugePageAllocFromOS(SIZE_T Size, bool& bOutHugePages)
+{
+	const SIZE_T AlignedSize = Align(Size, GetHugePageSize());
+	if (::GetLargePageMinimum() && WindowsPlatformMemory::EnableLockMemoryPrivilege())
+	{
+		// Large pages are always committed and aligned to the large page size
+		if (void* Ptr = VirtualAlloc(NULL, AlignedSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE))
+		{
+			bOutHugePages = true;
+			return Ptr;
+		}
+	}
+
+	bOutHugePages = false;
+	return VirtualAlloc(NULL, AlignedSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+void YWindowsPlatformMemory::HugePageFreeToOS(void* Ptr, SIZE_T Size)
+{
+	verify(VirtualFree(Ptr, 0, MEM_RELEASE) != 0);
+}
+
+uint32 YWindowsPlatformMemory::GetNumaNodeCount()
+{
+	ULONG HighestNode = 0;
+	return ::GetNumaHighestNodeNumber(&HighestNode) ? uint32(HighestNode) + 1 : 1;
+}
+
+uint32 YWindowsPlatformMemory::GetCurrentNumaNode()
+{
+	PROCESSOR_NUMBER Processor;
+	::GetCurrentProcessorNumberEx(&Processor);
+	USHORT Node = 0;
+	return ::GetNumaProcessorNodeEx(&Processor, &Node) ? uint32(Node) : 0;
+}
+
+void* YWindowsPlatformMemory::NumaAllocFromOS(SIZE_T Size, uint32 Node)
+{
+	if (void* Ptr = ::VirtualAllocExNuma(::GetCurrentProcess(), NULL, Size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, Node))
+	{
+		return Ptr;
+	}
+	return BinnedAllocFromOS(Size);
+}
+
 YPlatformMemory::YSharedMemoryRegion* YWindowsPlatformMemory::MapNamedSharedMemoryRegion(const YString& InName, bool bCreate, uint32 AccessMode, SIZE_T Size)
 {
 	YString Name(TEXT("Global\\"));
@@ -378,6 +378,36 @@ TFuture<ResultType> AsyncThread(TFunction<ResultType()> Function, uint32 StackSi
 CORE_API void AsyncTask(ENamedThreads::Type Thread, TFunction<void()> Function);
 
 
+/* Executors
+*****************************************************************************/
+
+/**
+* Executor that runs future continuations in a queued thread pool, for continuations that take long enough to
+* hold up the task graph.
+*/
+class CORE_API FThreadPoolExecutor
+{
+public:
+
+	/**
+	* Creates and initializes a new instance.
+	*
+	* @param InThreadPool The pool to run the continuations in.
+	*/
+	explicit FThreadPoolExecutor(FQueuedThreadPool* InThreadPool = GThreadPool)
+		: ThreadPool(InThreadPool)
+	{ }
+
+	/** Queues work that calls the function. */
+	void Execute(TFunction<void()>&& Function) const;
+
+private:
+
+	/** The pool to run the continuations in. */
+	FQueuedThreadPool* ThreadPool;
+};
+
+
 /* Inline functions
 *****************************************************************************/
 
@@ -62,8 +62,9 @@ class FAutoDeleteAsyncTask
 
 	/* Generic start function, not called directly
 	* @param bForceSynchronous if true, this job will be started synchronously, now, on this thread
+	* @param InPriority the priority band of the pool the job is queued in
 	**/
-	void Start(bool bForceSynchronous)
+	void Start(bool bForceSynchronous, EQueuedWorkPriority InPriority = EQueuedWorkPriority::Normal)
 	{
 		YPlatformMisc::MemoryBarrier();
 		FQueuedThreadPool* QueuedPool = GThreadPool;
@@ -73,7 +74,7 @@ class FAutoDeleteAsyncTask
 		}
 		if (QueuedPool)
 		{
-			QueuedPool->AddQueuedWork(this);
+			QueuedPool->AddQueuedWork(this, InPriority);
 		}
 		else
 		{
@@ -135,10 +136,11 @@ public:
 
 	/**
 	* Run this task on the lo priority thread pool. It is not safe to use this object after this call.
+	* @param InPriority the priority band of the pool the task is queued in
 	**/
-	void StartBackgroundTask()
+	void StartBackgroundTask(EQueuedWorkPriority InPriority = EQueuedWorkPriority::Normal)
 	{
-		Start(false);
+		Start(false, InPriority);
 	}
 
 };
@@ -220,8 +222,9 @@ class FAsyncTask
 
 	/* Generic start function, not called directly
 	* @param bForceSynchronous if true, this job will be started synchronously, now, on this thread
+	* @param InPriority the priority band of the pool the job is queued in
 	**/
-	void Start(bool bForceSynchronous, FQueuedThreadPool* InQueuedPool)
+	void Start(bool bForceSynchronous, FQueuedThreadPool* InQueuedPool, EQueuedWorkPriority InPriority = EQueuedWorkPriority::Normal)
 	{
 		FScopeCycleCounter Scope(Task.GetStatId(), true);
 		DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FAsyncTask::Start"), STAT_FAsyncTask_Start, STATGROUP_ThreadPoolAsyncTasks);
@@ -241,7 +244,7 @@ class FAsyncTask
 				DoneEvent = FPlatformProcess::GetSynchEventFromPool(true);
 			}
 			DoneEvent->Reset();
-			QueuedPool->AddQueuedWork(this);
+			QueuedPool->AddQueuedWork(this, InPriority);
 		}
 		else
 		{
@@ -396,10 +399,12 @@ public:
 
 	/**
 	* Queue this task for processing by the background thread pool
+	* @param InQueuedPool the pool to queue the task in
+	* @param InPriority the priority band of the pool the task is queued in
 	**/
-	void StartBackgroundTask(FQueuedThreadPool* InQueuedPool = GThreadPool)
+	void StartBackgroundTask(FQueuedThreadPool* InQueuedPool = GThreadPool, EQueuedWorkPriority InPriority = EQueuedWorkPriority::Normal)
 	{
-		Start(false, InQueuedPool);
+		Start(false, InQueuedPool, InPriority);
 	}
 
 	/**
@@ -0,0 +1,523 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	Coroutine.h: C++20 coroutines that run on the task graph
+=============================================================================*/
+
+#pragma once
+
+#include "CoreTypes.h"
+
+#if PLATFORM_COMPILER_HAS_COROUTINES
+
+#include <coroutine>
+#include "Misc/AssertionMacros.h"
+#include "Templates/SolidAngleTemplate.h"
+#include "HAL/SolidAngleMemory.h"
+#include "Containers/LockFreeFixedSizeAllocator.h"
+#include "Stats/Stats.h"
+#include "Misc/CoreStats.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Async/Future.h"
+#include "Async/AsyncFileHandle.h"
+
+template<typename ResultType> class TCoroTask;
+
+namespace UE4Coroutine_Private
+{
+	/**
+	 * Pools coroutine frames by power of two size classes, so that starting and finishing a coroutine doesn't go
+	 * through GMalloc. Frames bigger than the largest class are rare and come from GMalloc.
+	 */
+	struct FFrameAllocator
+	{
+		static void* Allocate(SIZE_T Size)
+		{
+			switch (GetPoolIndex(Size))
+			{
+			case 0: return GetPool<128>().Allocate();
+			case 1: return GetPool<256>().Allocate();
+			case 2: return GetPool<512>().Allocate();
+			case 3: return GetPool<1024>().Allocate();
+			case 4: return GetPool<2048>().Allocate();
+			case 5: return GetPool<4096>().Allocate();
+			default: return YMemory::Malloc(Size);
+			}
+		}
+
+		static void Free(void* Ptr, SIZE_T Size)
+		{
+			switch (GetPoolIndex(Size))
+			{
+			case 0: GetPool<128>().Free(Ptr); break;
+			case 1: GetPool<256>().Free(Ptr); break;
+			case 2: GetPool<512>().Free(Ptr); break;
+			case 3: GetPool<1024>().Free(Ptr); break;
+			case 4: GetPool<2048>().Free(Ptr); break;
+			case 5: GetPool<4096>().Free(Ptr); break;
+			default: YMemory::Free(Ptr); break;
+			}
+		}
+
+	private:
+		static FORCEINLINE int32 GetPoolIndex(SIZE_T Size)
+		{
+			int32 Index = 0;
+			for (SIZE_T BlockSize = 128; BlockSize < Size; BlockSize *= 2)
+			{
+				Index++;
+			}
+			return Index;
+		}
+
+		template<int32 BlockSize>
+		static TLockFreeFixedSizeAllocator<BlockSize, PLATFORM_CACHE_LINE_SIZE>& GetPool()
+		{
+			static TLockFreeFixedSizeAllocator<BlockSize, PLATFORM_CACHE_LINE_SIZE> Pool;
+			return Pool;
+		}
+	};
+
+	/** Resumes a suspended coroutine from a task on the given thread, once the prerequisites are complete. */
+	inline void ResumeFromTask(std::coroutine_handle<> Handle, ENamedThreads::Type Thread, const FGraphEventArray* Prerequisites = nullptr)
+	{
+		FFunctionGraphTask::CreateAndDispatchWhenReady([Handle]() { Handle.resume(); }, GET_STATID(STAT_TaskGraph_OtherTasks), Prerequisites, Thread);
+	}
+
+	/** Part of the coroutine promise that doesn't depend on the result type. */
+	class FCoroPromiseBase
+	{
+	public:
+
+		FCoroPromiseBase()
+			: ResumeThread(ENamedThreads::AnyThread)
+			, CompletionEvent(FGraphEvent::CreateGraphEvent())
+		{ }
+
+		static void* operator new(SIZE_T Size)
+		{
+			return FFrameAllocator::Allocate(Size);
+		}
+
+		static void operator delete(void* Ptr, SIZE_T Size)
+		{
+			FFrameAllocator::Free(Ptr, Size);
+		}
+
+		/** Coroutines start running on the calling thread and free their frame as soon as they return. */
+		std::suspend_never initial_suspend() const noexcept
+		{
+			return std::suspend_never();
+		}
+
+		std::suspend_never final_suspend() const noexcept
+		{
+			return std::suspend_never();
+		}
+
+		void unhandled_exception()
+		{
+			checkf(false, TEXT("Unhandled exception in a coroutine task"));
+		}
+
+		/** The thread the coroutine resumes on after waiting, changed with ResumeOn. */
+		ENamedThreads::Type ResumeThread;
+
+		/** Completes once the coroutine returns, so that graph tasks can have it as a prerequisite. */
+		FGraphEventRef CompletionEvent;
+
+	protected:
+
+		void DispatchCompletionEvent()
+		{
+			TArray<FBaseGraphTask*> NewTasks;
+			CompletionEvent->DispatchSubsequents(NewTasks);
+		}
+	};
+
+	template<typename ResultType>
+	class TCoroPromise
+		: public FCoroPromiseBase
+	{
+	public:
+
+		TCoroTask<ResultType> get_return_object()
+		{
+			return TCoroTask<ResultType>(Promise.GetFuture(), CompletionEvent);
+		}
+
+		template<typename ValueType>
+		void return_value(ValueType&& Value)
+		{
+			Promise.SetValue(Forward<ValueType>(Value));
+			DispatchCompletionEvent();
+		}
+
+	private:
+
+		TPromise<ResultType> Promise;
+	};
+
+	template<>
+	class TCoroPromise<void>
+		: public FCoroPromiseBase
+	{
+	public:
+
+		TCoroTask<void> get_return_object();
+
+		void return_void()
+		{
+			Promise.SetValue();
+			DispatchCompletionEvent();
+		}
+
+	private:
+
+		TPromise<void> Promise;
+	};
+
+	/** Suspends until all the events are complete, then resumes on the coroutine's resume thread. */
+	class FGraphEventAwaiter
+	{
+	public:
+
+		explicit FGraphEventAwaiter(const FGraphEventArray& InEvents)
+			: Events(InEvents)
+		{ }
+
+		bool await_ready() const
+		{
+			for (const FGraphEventRef& Event : Events)
+			{
+				if (Event.GetReference() && !Event->IsComplete())
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		template<typename PromiseType>
+		void await_suspend(std::coroutine_handle<PromiseType> Handle) const
+		{
+			ResumeFromTask(Handle, Handle.promise().ResumeThread, &Events);
+		}
+
+		void await_resume() const
+		{ }
+
+	private:
+
+		FGraphEventArray Events;
+	};
+
+	/** Suspends until the future has its result, then resumes on the coroutine's resume thread with the result. */
+	template<typename ResultType>
+	class TFutureAwaiter
+	{
+	public:
+
+		explicit TFutureAwaiter(TFuture<ResultType>&& InFuture)
+			: Future(MoveTemp(InFuture))
+		{ }
+
+		bool await_ready() const
+		{
+			return Future.IsReady();
+		}
+
+		template<typename PromiseType>
+		void await_suspend(std::coroutine_handle<PromiseType> Handle)
+		{
+			const ENamedThreads::Type Thread = Handle.promise().ResumeThread;
+
+			// Then moves the future out of the awaiter, the continuation puts it back before resuming.
+			// Nothing may touch the awaiter after this, the coroutine may already be running on another thread.
+			Future.Then([this, Handle, Thread](TFuture<ResultType> CompletedFuture)
+			{
+				Future = MoveTemp(CompletedFuture);
+				ResumeFromTask(Handle, Thread);
+			}, FInlineExecutor());
+		}
+
+		ResultType await_resume()
+		{
+			return Future.Get();
+		}
+
+	private:
+
+		TFuture<ResultType> Future;
+	};
+
+	/** Moves the coroutine to a task on the given thread, which later waits resume on as well. */
+	class FResumeOnAwaiter
+	{
+	public:
+
+		explicit FResumeOnAwaiter(ENamedThreads::Type InThread)
+			: Thread(InThread)
+		{ }
+
+		bool await_ready() const
+		{
+			return false;
+		}
+
+		template<typename PromiseType>
+		void await_suspend(std::coroutine_handle<PromiseType> Handle) const
+		{
+			Handle.promise().ResumeThread = Thread;
+			ResumeFromTask(Handle, Thread);
+		}
+
+		void await_resume() const
+		{ }
+
+	private:
+
+		ENamedThreads::Type Thread;
+	};
+
+	/**
+	 * Suspends until an async file read completes, then resumes on the coroutine's resume thread with the request,
+	 * or with nullptr if the read was cancelled.
+	 */
+	class FAsyncReadAwaiter
+	{
+	public:
+
+		FAsyncReadAwaiter(IAsyncReadFileHandle* InFileHandle, int64 InOffset, int64 InBytesToRead, EAsyncIOPriority InPriority, uint8* InUserSuppliedMemory)
+			: FileHandle(InFileHandle)
+			, Offset(InOffset)
+			, BytesToRead(InBytesToRead)
+			, Priority(InPriority)
+			, UserSuppliedMemory(InUserSuppliedMemory)
+			, Request(nullptr)
+			, bWasCancelled(false)
+		{ }
+
+		bool await_ready() const
+		{
+			return false;
+		}
+
+		template<typename PromiseType>
+		void await_suspend(std::coroutine_handle<PromiseType> Handle)
+		{
+			const ENamedThreads::Type Thread = Handle.promise().ResumeThread;
+
+			// the request is taken from the callback, the read may complete before ReadRequest returns
+			Callback = [this, Handle, Thread](bool bInWasCancelled, IAsyncReadRequest* InRequest)
+			{
+				Request = InRequest;
+				bWasCancelled = bInWasCancelled;
+				ResumeFromTask(Handle, Thread);
+			};
+			FileHandle->ReadRequest(Offset, BytesToRead, Priority, &Callback, UserSuppliedMemory);
+		}
+
+		IAsyncReadRequest* await_resume()
+		{
+			// the callback runs just before the request is marked complete
+			Request->WaitCompletion();
+			if (bWasCancelled)
+			{
+				// there are no results to take, so the coroutine never sees the request
+				delete Request;
+				Request = nullptr;
+			}
+			return Request;
+		}
+
+	private:
+
+		IAsyncReadFileHandle* FileHandle;
+		int64 Offset;
+		int64 BytesToRead;
+		EAsyncIOPriority Priority;
+		uint8* UserSuppliedMemory;
+		IAsyncReadRequest* Request;
+		bool bWasCancelled;
+		FAsyncFileCallBack Callback;
+	};
+}
+
+
+/**
+* Return type of coroutines that run on the task graph. The coroutine starts on the calling thread and whenever it
+* has to wait, resumes in a task on its resume thread: any worker thread until it changes it with ResumeOn.
+* It can co_await graph events, TFutures, other TCoroTasks, ReadAsync and ResumeOn. Frames come from pools rather
+* than GMalloc.
+*
+* Usage example:
+*
+*		TCoroTask<int32> LoadAndParse(IAsyncReadFileHandle* File, int64 Size)
+*		{
+*			IAsyncReadRequest* Request = co_await ReadAsync(File, 0, Size);
+*			if (!Request)
+*			{
+*				co_return 0;							// cancelled
+*			}
+*			uint8* Data = Request->GetReadResults();
+*			delete Request;
+*
+*			const int32 Result = Parse(Data, Size);		// on a worker thread
+*			YMemory::Free(Data);
+*
+*			co_await ResumeOn(ENamedThreads::GameThread);
+*			Publish(Result);							// on the game thread
+*			co_return Result;
+*		}
+*/
+template<typename ResultType>
+class TCoroTask
+{
+public:
+
+	typedef UE4Coroutine_Private::TCoroPromise<ResultType> promise_type;
+
+	/** Move constructor. */
+	TCoroTask(TCoroTask&& Other)
+		: Future(MoveTemp(Other.Future))
+		, CompletionEvent(MoveTemp(Other.CompletionEvent))
+	{ }
+
+	/** Move assignment operator. */
+	TCoroTask& operator=(TCoroTask&& Other)
+	{
+		Future = MoveTemp(Other.Future);
+		CompletionEvent = MoveTemp(Other.CompletionEvent);
+		return *this;
+	}
+
+public:
+
+	/**
+	* Checks whether the coroutine has returned.
+	*
+	* @return true if the result is available.
+	*/
+	bool IsReady() const
+	{
+		return Future.IsReady();
+	}
+
+	/**
+	* Gets the result, blocking the calling thread until the coroutine has returned.
+	* Never call this from the thread the coroutine needs to resume on.
+	*
+	* @return The result.
+	*/
+	ResultType Get() const
+	{
+		return Future.Get();
+	}
+
+	/**
+	* Moves the future for the result out of the task, to chain continuations on it.
+	*
+	* @return The future.
+	*/
+	TFuture<ResultType> GetFuture()
+	{
+		return MoveTemp(Future);
+	}
+
+	/**
+	* Gets the event that completes once the coroutine returns, to use as a prerequisite of graph tasks.
+	*
+	* @return The completion event.
+	*/
+	const FGraphEventRef& GetCompletionEvent() const
+	{
+		return CompletionEvent;
+	}
+
+	/** Awaits the coroutine from another one, moving the result out of this task. */
+	UE4Coroutine_Private::TFutureAwaiter<ResultType> operator co_await() &&
+	{
+		return UE4Coroutine_Private::TFutureAwaiter<ResultType>(MoveTemp(Future));
+	}
+
+private:
+
+	friend promise_type;
+
+	TCoroTask(TFuture<ResultType>&& InFuture, const FGraphEventRef& InCompletionEvent)
+		: Future(MoveTemp(InFuture))
+		, CompletionEvent(InCompletionEvent)
+	{ }
+
+	/** Hidden copy constructor (tasks cannot be copied). */
+	TCoroTask(const TCoroTask&);
+
+	/** Hidden copy assignment (tasks cannot be copied). */
+	TCoroTask& operator=(const TCoroTask&);
+
+	/** The future set to the value the coroutine returns. */
+	TFuture<ResultType> Future;
+
+	/** Completes once the coroutine returns. */
+	FGraphEventRef CompletionEvent;
+};
+
+
+inline TCoroTask<void> UE4Coroutine_Private::TCoroPromise<void>::get_return_object()
+{
+	return TCoroTask<void>(Promise.GetFuture(), CompletionEvent);
+}
+
+
+/**
+* Moves the calling coroutine to a task on the given thread, i.e. co_await ResumeOn(ENamedThreads::GameThread).
+* Waits later in the coroutine resume on that thread as well.
+*
+* @param Thread The thread to continue on.
+*/
+inline UE4Coroutine_Private::FResumeOnAwaiter ResumeOn(ENamedThreads::Type Thread)
+{
+	return UE4Coroutine_Private::FResumeOnAwaiter(Thread);
+}
+
+
+/**
+* Reads part of a file without blocking the calling coroutine's thread, i.e. co_await ReadAsync(File, 0, Size).
+* The coroutine owns the request it gets back and deletes it once it has taken the results. It gets nullptr instead
+* when the read was cancelled, that request is deleted already.
+*
+* @param FileHandle The file to read from.
+* @param Offset Offset into the file to start reading.
+* @param BytesToRead Number of bytes to read.
+* @param Priority Priority of the request.
+* @param UserSuppliedMemory Optional memory to read into.
+*/
+inline UE4Coroutine_Private::FAsyncReadAwaiter ReadAsync(IAsyncReadFileHandle* FileHandle, int64 Offset, int64 BytesToRead, EAsyncIOPriority Priority = AIOP_Normal, uint8* UserSuppliedMemory = nullptr)
+{
+	return UE4Coroutine_Private::FAsyncReadAwaiter(FileHandle, Offset, BytesToRead, Priority, UserSuppliedMemory);
+}
+
+
+/** Lets coroutine tasks co_await graph events. */
+inline UE4Coroutine_Private::FGraphEventAwaiter operator co_await(const FGraphEventRef& Event)
+{
+	FGraphEventArray Events;
+	Events.Add(Event);
+	return UE4Coroutine_Private::FGraphEventAwaiter(Events);
+}
+
+inline UE4Coroutine_Private::FGraphEventAwaiter operator co_await(const FGraphEventArray& Events)
+{
+	return UE4Coroutine_Private::FGraphEventAwaiter(Events);
+}
+
+
+/** Lets coroutine tasks co_await futures, the future is moved into the awaiter. */
+template<typename ResultType>
+UE4Coroutine_Private::TFutureAwaiter<ResultType> operator co_await(TFuture<ResultType>&& Future)
+{
+	return UE4Coroutine_Private::TFutureAwaiter<ResultType>(MoveTemp(Future));
+}
+
+#endif // PLATFORM_COMPILER_HAS_COROUTINES
@@ -5,14 +5,50 @@
 #include "CoreTypes.h"
 #include "Misc/AssertionMacros.h"
 #include "Templates/SolidAngleTemplate.h"
+#include "Templates/Decay.h"
 #include "Templates/Function.h"
 #include "Misc/Timespan.h"
 #include "Templates/SharedPointer.h"
 #include "Misc/DateTime.h"
 #include "HAL/Event.h"
 #include "HAL/PlatformProcess.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/ScopeLock.h"
+#include "Containers/Array.h"
+#include "Async/TaskGraphInterfaces.h"
 
+template<typename ResultType> class TFuture;
 template<typename ResultType> class TSharedFuture;
+template<typename ResultType> class TPromise;
+
+namespace UE4Future_Private
+{
+	/** Sets a promise to the result of a function (void results are handled by the specialization below). */
+	template<typename ResultType>
+	struct TSetPromise
+	{
+		template<typename PromiseType, typename Func, typename ArgType>
+		static void Set(PromiseType& Promise, Func& Function, ArgType&& Arg)
+		{
+			Promise.SetValue(Function(Forward<ArgType>(Arg)));
+		}
+	};
+
+	template<>
+	struct TSetPromise<void>
+	{
+		template<typename PromiseType, typename Func, typename ArgType>
+		static void Set(PromiseType& Promise, Func& Function, ArgType&& Arg)
+		{
+			Function(Forward<ArgType>(Arg));
+			Promise.SetValue();
+		}
+	};
+
+	/** Implements WhenAll and WhenAny, which need the shared state of the futures they wait for. */
+	struct FFutureCombinators;
+}
 
 /* TFutureBase
 *****************************************************************************/
@@ -78,18 +114,68 @@ public:
 		return false;
 	}
 
+	/**
+	* Adds a function to call once the state is completed, on the thread that completes it.
+	* The function is called right away if the state is already complete.
+	*
+	* @param Continuation The function to call.
+	*/
+	void AddContinuation(TFunction<void()>&& Continuation)
+	{
+		{
+			FScopeLock Lock(&ContinuationsCritical);
+
+			if (!Complete)
+			{
+				Continuations.Add(MoveTemp(Continuation));
+				return;
+			}
+		}
+
+		Continuation();
+	}
+
+	/**
+	* Drops the continuations of a state that will never complete. Called when its promise is destroyed without a result,
+	* as continuations commonly keep the state they wait for alive.
+	*/
+	void DiscardContinuations()
+	{
+		TArray<TFunction<void()>> DiscardedContinuations;
+		{
+			FScopeLock Lock(&ContinuationsCritical);
+
+			Exchange(DiscardedContinuations, Continuations);
+		}
+
+		// destroyed outside the lock, they may hold the promises of further states
+	}
+
 protected:
 
 	/** Notifies any waiting threads that the result is available. */
 	void MarkComplete()
 	{
-		Complete = true;
-		CompletionEvent->Trigger();
-
+		// the callback runs first, so whoever gets the result also sees what the callback did
 		if (CompletionCallback)
 		{
 			CompletionCallback();
 		}
+
+		TArray<TFunction<void()>> CompletedContinuations;
+		{
+			FScopeLock Lock(&ContinuationsCritical);
+
+			Complete = true;
+			Exchange(CompletedContinuations, Continuations);
+		}
+
+		CompletionEvent->Trigger();
+
+		for (TFunction<void()>& Continuation : CompletedContinuations)
+		{
+			Continuation();
+		}
 	}
 
 private:
@@ -97,6 +183,12 @@ private:
 	/** An optional callback function that is executed the state is completed. */
 	TFunction<void()> CompletionCallback;
 
+	/** Functions added with AddContinuation that are waiting for the state to complete. */
+	TArray<TFunction<void()>> Continuations;
+
+	/** Guards Continuations, and Complete against continuations being added while the state completes. */
+	FCriticalSection ContinuationsCritical;
+
 	/** Holds an event signaling that the result is available. */
 	FEvent* CompletionEvent;
 
@@ -264,6 +356,15 @@ protected:
 		: State(InState)
 	{ }
 
+	/**
+	* Copy constructor, for shared futures only.
+	*
+	* @param Other The future holding the shared state to share.
+	*/
+	TFutureBase(const TFutureBase& Other)
+		: State(Other.State)
+	{ }
+
 	/**
 	* Move constructor.
 	*
@@ -280,6 +381,13 @@ protected:
 
 protected:
 
+	/** Copy assignment operator, for shared futures only. */
+	TFutureBase& operator=(const TFutureBase& Other)
+	{
+		State = Other.State;
+		return *this;
+	}
+
 	/** Move assignment operator. */
 	TFutureBase& operator=(TFutureBase&& Other)
 	{
@@ -305,13 +413,98 @@ protected:
 		return State;
 	}
 
+	/**
+	* Implements Then for the derived futures: once the state is complete, the executor is given a function that
+	* passes Future to the continuation and sets the returned future to its result.
+	*
+	* @param Future The future to hand to the continuation, sharing this state.
+	* @param Continuation The function to call with the completed future.
+	* @param Executor Decides where the continuation runs.
+	* @return A future for the result of the continuation.
+	*/
+	template<typename FutureType, typename Func, typename ExecutorType>
+	static auto ThenInternal(FutureType&& Future, Func&& Continuation, const ExecutorType& Executor) -> TFuture<decltype(Continuation(MoveTemp(Future)))>
+	{
+		typedef decltype(Continuation(MoveTemp(Future))) ContinuationResultType;
+		typedef typename TDecay<FutureType>::Type DecayedFutureType;
+		typedef typename TDecay<Func>::Type DecayedFuncType;
+
+		// futures and promises can't be copied, but the functions stored by the state and the executor have to be
+		TSharedRef<DecayedFutureType, ESPMode::ThreadSafe> SharedFuture = MakeShareable(new DecayedFutureType(MoveTemp(Future)));
+		TSharedRef<TPromise<ContinuationResultType>, ESPMode::ThreadSafe> Promise = MakeShareable(new TPromise<ContinuationResultType>());
+		TFuture<ContinuationResultType> Result = Promise->GetFuture();
+
+		const StateType ContinuedState = static_cast<const TFutureBase&>(*SharedFuture).GetState();
+		DecayedFuncType Function(Forward<Func>(Continuation));
+		ContinuedState->AddContinuation([SharedFuture, Promise, Function, Executor]()
+		{
+			Executor.Execute([SharedFuture, Promise, Function]() mutable
+			{
+				UE4Future_Private::TSetPromise<ContinuationResultType>::Set(*Promise, Function, MoveTemp(*SharedFuture));
+			});
+		});
+
+		return Result;
+	}
+
 private:
 
+	friend struct UE4Future_Private::FFutureCombinators;
+
 	/** Holds the future's state. */
 	StateType State;
 };
 
 
+/**
+* Executor that runs future continuations as task graph tasks, on any worker thread by default.
+* Give it a named thread to run them on that thread instead, i.e. FTaskGraphExecutor(ENamedThreads::GameThread).
+*
+* Usage example:
+*
+*		Async<int>(EAsyncExecution::TaskGraph, []() { return 123; })
+*			.Next([](int Result) { return Result * 2; })
+*			.Next([](int Result) { UE_LOG(LogTemp, Log, TEXT("%d"), Result); }, FTaskGraphExecutor(ENamedThreads::GameThread));
+*/
+class CORE_API FTaskGraphExecutor
+{
+public:
+
+	/**
+	* Creates and initializes a new instance.
+	*
+	* @param InThread The thread to run the continuations on.
+	*/
+	explicit FTaskGraphExecutor(ENamedThreads::Type InThread = ENamedThreads::AnyThread)
+		: Thread(InThread)
+	{ }
+
+	/** Dispatches a task that calls the function. */
+	void Execute(TFunction<void()>&& Function) const;
+
+private:
+
+	/** The thread to run the continuations on. */
+	ENamedThreads::Type Thread;
+};
+
+
+/**
+* Executor that runs future continuations on the thread that sets the result, or on the calling thread if the result
+* is already available. Only suited to continuations that do next to nothing, see Async.h for the others.
+*/
+class FInlineExecutor
+{
+public:
+
+	/** Calls the function right away. */
+	void Execute(TFunction<void()>&& Function) const
+	{
+		Function();
+	}
+};
+
+
 /* TFuture
 *****************************************************************************/
 
@@ -380,6 +573,39 @@ public:
 		return TSharedFuture<ResultType>(MoveTemp(*this));
 	}
 
+	/**
+	* Schedules a function to run once the result is available, instead of blocking a thread on it.
+	* This future is moved into the continuation, so it is no longer valid afterwards.
+	*
+	* @param Continuation A function taking the completed TFuture, what it returns is the result of the returned future.
+	* @param Executor Decides where the continuation runs, a task graph worker thread by default (see Async.h).
+	* @return A future for the result of the continuation.
+	* @see Next
+	*/
+	template<typename Func, typename ExecutorType = FTaskGraphExecutor>
+	auto Then(Func&& Continuation, const ExecutorType& Executor = ExecutorType()) -> TFuture<decltype(Continuation(DeclVal<TFuture>()))>
+	{
+		return BaseType::ThenInternal(MoveTemp(*this), Forward<Func>(Continuation), Executor);
+	}
+
+	/**
+	* Like Then, but the continuation takes the result rather than the future.
+	*
+	* @param Continuation A function taking the result rather than the future, what it returns is the result of the returned future.
+	* @param Executor Decides where the continuation runs, a task graph worker thread by default (see Async.h).
+	* @return A future for the result of the continuation.
+	* @see Then
+	*/
+	template<typename Func, typename ExecutorType = FTaskGraphExecutor>
+	auto Next(Func&& Continuation, const ExecutorType& Executor = ExecutorType()) -> TFuture<decltype(Continuation(DeclVal<ResultType>()))>
+	{
+		typename TDecay<Func>::Type Function(Forward<Func>(Continuation));
+		return Then([Function](TFuture Self) mutable
+		{
+			return Function(Self.Get());
+		}, Executor);
+	}
+
 private:
 
 	/** Hidden copy constructor (futures cannot be copied). */
@@ -452,6 +678,39 @@ public:
 		return TSharedFuture<ResultType&>(MoveTemp(*this));
 	}
 
+	/**
+	* Schedules a function to run once the result is available, instead of blocking a thread on it.
+	* This future is moved into the continuation, so it is no longer valid afterwards.
+	*
+	* @param Continuation A function taking the completed TFuture, what it returns is the result of the returned future.
+	* @param Executor Decides where the continuation runs, a task graph worker thread by default (see Async.h).
+	* @return A future for the result of the continuation.
+	* @see Next
+	*/
+	template<typename Func, typename ExecutorType = FTaskGraphExecutor>
+	auto Then(Func&& Continuation, const ExecutorType& Executor = ExecutorType()) -> TFuture<decltype(Continuation(DeclVal<TFuture>()))>
+	{
+		return BaseType::ThenInternal(MoveTemp(*this), Forward<Func>(Continuation), Executor);
+	}
+
+	/**
+	* Like Then, but the continuation takes the result rather than the future.
+	*
+	* @param Continuation A function taking the result rather than the future, what it returns is the result of the returned future.
+	* @param Executor Decides where the continuation runs, a task graph worker thread by default (see Async.h).
+	* @return A future for the result of the continuation.
+	* @see Then
+	*/
+	template<typename Func, typename ExecutorType = FTaskGraphExecutor>
+	auto Next(Func&& Continuation, const ExecutorType& Executor = ExecutorType()) -> TFuture<decltype(Continuation(DeclVal<ResultType&>()))>
+	{
+		typename TDecay<Func>::Type Function(Forward<Func>(Continuation));
+		return Then([Function](TFuture Self) mutable
+		{
+			return Function(Self.Get());
+		}, Executor);
+	}
+
 private:
 
 	/** Hidden copy constructor (futures cannot be copied). */
@@ -521,6 +780,40 @@ public:
 	*/
 	TSharedFuture<void> Share();
 
+	/**
+	* Schedules a function to run once the result is available, instead of blocking a thread on it.
+	* This future is moved into the continuation, so it is no longer valid afterwards.
+	*
+	* @param Continuation A function taking the completed TFuture, what it returns is the result of the returned future.
+	* @param Executor Decides where the continuation runs, a task graph worker thread by default (see Async.h).
+	* @return A future for the result of the continuation.
+	* @see Next
+	*/
+	template<typename Func, typename ExecutorType = FTaskGraphExecutor>
+	auto Then(Func&& Continuation, const ExecutorType& Executor = ExecutorType()) -> TFuture<decltype(Continuation(DeclVal<TFuture>()))>
+	{
+		return BaseType::ThenInternal(MoveTemp(*this), Forward<Func>(Continuation), Executor);
+	}
+
+	/**
+	* Like Then, but the continuation takes no arguments.
+	*
+	* @param Continuation A function taking no arguments, what it returns is the result of the returned future.
+	* @param Executor Decides where the continuation runs, a task graph worker thread by default (see Async.h).
+	* @return A future for the result of the continuation.
+	* @see Then
+	*/
+	template<typename Func, typename ExecutorType = FTaskGraphExecutor>
+	auto Next(Func&& Continuation, const ExecutorType& Executor = ExecutorType()) -> TFuture<decltype(Continuation())>
+	{
+		typename TDecay<Func>::Type Function(Forward<Func>(Continuation));
+		return Then([Function](TFuture Self) mutable
+		{
+			Self.Get();
+			return Function();
+		}, Executor);
+	}
+
 private:
 
 	/** Hidden copy constructor (futures cannot be copied). */
@@ -606,6 +899,39 @@ public:
 	{
 		return MoveTemp(this->GetState()->GetResult());
 	}
+
+	/**
+	* Schedules a function to run once the result is available, instead of blocking a thread on it.
+	* The continuation gets its own shared future, this one stays valid.
+	*
+	* @param Continuation A function taking the completed TSharedFuture, what it returns is the result of the returned future.
+	* @param Executor Decides where the continuation runs, a task graph worker thread by default (see Async.h).
+	* @return A future for the result of the continuation.
+	* @see Next
+	*/
+	template<typename Func, typename ExecutorType = FTaskGraphExecutor>
+	auto Then(Func&& Continuation, const ExecutorType& Executor = ExecutorType()) const -> TFuture<decltype(Continuation(DeclVal<TSharedFuture>()))>
+	{
+		return BaseType::ThenInternal(TSharedFuture(this->GetState()), Forward<Func>(Continuation), Executor);
+	}
+
+	/**
+	* Like Then, but the continuation takes the result rather than the future.
+	*
+	* @param Continuation A function taking the result rather than the future, what it returns is the result of the returned future.
+	* @param Executor Decides where the continuation runs, a task graph worker thread by default (see Async.h).
+	* @return A future for the result of the continuation.
+	* @see Then
+	*/
+	template<typename Func, typename ExecutorType = FTaskGraphExecutor>
+	auto Next(Func&& Continuation, const ExecutorType& Executor = ExecutorType()) const -> TFuture<decltype(Continuation(DeclVal<ResultType>()))>
+	{
+		typename TDecay<Func>::Type Function(Forward<Func>(Continuation));
+		return Then([Function](TSharedFuture Self) mutable
+		{
+			return Function(Self.Get());
+		}, Executor);
+	}
 };
 
 
@@ -637,7 +963,7 @@ public:
 	*
 	* @param Future The future object to initialize from.
 	*/
-	TSharedFuture(TFuture<ResultType>&& Future)
+	TSharedFuture(TFuture<ResultType&>&& Future)
 		: BaseType(MoveTemp(Future))
 	{ }
 
@@ -681,6 +1007,39 @@ public:
 	{
 		return *this->GetState()->GetResult();
 	}
+
+	/**
+	* Schedules a function to run once the result is available, instead of blocking a thread on it.
+	* The continuation gets its own shared future, this one stays valid.
+	*
+	* @param Continuation A function taking the completed TSharedFuture, what it returns is the result of the returned future.
+	* @param Executor Decides where the continuation runs, a task graph worker thread by default (see Async.h).
+	* @return A future for the result of the continuation.
+	* @see Next
+	*/
+	template<typename Func, typename ExecutorType = FTaskGraphExecutor>
+	auto Then(Func&& Continuation, const ExecutorType& Executor = ExecutorType()) const -> TFuture<decltype(Continuation(DeclVal<TSharedFuture>()))>
+	{
+		return BaseType::ThenInternal(TSharedFuture(this->GetState()), Forward<Func>(Continuation), Executor);
+	}
+
+	/**
+	* Like Then, but the continuation takes the result rather than the future.
+	*
+	* @param Continuation A function taking the result rather than the future, what it returns is the result of the returned future.
+	* @param Executor Decides where the continuation runs, a task graph worker thread by default (see Async.h).
+	* @return A future for the result of the continuation.
+	* @see Then
+	*/
+	template<typename Func, typename ExecutorType = FTaskGraphExecutor>
+	auto Next(Func&& Continuation, const ExecutorType& Executor = ExecutorType()) const -> TFuture<decltype(Continuation(DeclVal<ResultType&>()))>
+	{
+		typename TDecay<Func>::Type Function(Forward<Func>(Continuation));
+		return Then([Function](TSharedFuture Self) mutable
+		{
+			return Function(Self.Get());
+		}, Executor);
+	}
 };
 
 
@@ -717,9 +1076,9 @@ public:
 	{ }
 
 	/** Copy constructor. */
-	/*	TSharedFuture(const TSharedFuture& Other)
-	: BaseType(Other)
-	{ }*/
+	TSharedFuture(const TSharedFuture& Other)
+		: BaseType(Other)
+	{ }
 
 	/** Move constructor. */
 	TSharedFuture(TSharedFuture&& Other)
@@ -732,11 +1091,11 @@ public:
 public:
 
 	/** Copy assignment operator. */
-	/*	TSharedFuture& operator=(const TSharedFuture& Other)
+	TSharedFuture& operator=(const TSharedFuture& Other)
 	{
-	BaseType::operator=(Other);
-	return *this;
-	}*/
+		BaseType::operator=(Other);
+		return *this;
+	}
 
 	/** Move assignment operator. */
 	TSharedFuture& operator=(TSharedFuture&& Other)
@@ -756,6 +1115,40 @@ public:
 	{
 		GetState()->GetResult();
 	}
+
+	/**
+	* Schedules a function to run once the result is available, instead of blocking a thread on it.
+	* The continuation gets its own shared future, this one stays valid.
+	*
+	* @param Continuation A function taking the completed TSharedFuture, what it returns is the result of the returned future.
+	* @param Executor Decides where the continuation runs, a task graph worker thread by default (see Async.h).
+	* @return A future for the result of the continuation.
+	* @see Next
+	*/
+	template<typename Func, typename ExecutorType = FTaskGraphExecutor>
+	auto Then(Func&& Continuation, const ExecutorType& Executor = ExecutorType()) const -> TFuture<decltype(Continuation(DeclVal<TSharedFuture>()))>
+	{
+		return BaseType::ThenInternal(TSharedFuture(GetState()), Forward<Func>(Continuation), Executor);
+	}
+
+	/**
+	* Like Then, but the continuation takes no arguments.
+	*
+	* @param Continuation A function taking no arguments, what it returns is the result of the returned future.
+	* @param Executor Decides where the continuation runs, a task graph worker thread by default (see Async.h).
+	* @return A future for the result of the continuation.
+	* @see Then
+	*/
+	template<typename Func, typename ExecutorType = FTaskGraphExecutor>
+	auto Next(Func&& Continuation, const ExecutorType& Executor = ExecutorType()) const -> TFuture<decltype(Continuation())>
+	{
+		typename TDecay<Func>::Type Function(Forward<Func>(Continuation));
+		return Then([Function](TSharedFuture Self) mutable
+		{
+			Self.Get();
+			return Function();
+		}, Executor);
+	}
 };
 
 
@@ -821,6 +1214,13 @@ protected:
 			// if you hit this assertion then your promise never had its result
 			// value set. broken promises are considered programming errors.
 			check(State->IsComplete());
+
+			// without checks, at least free what waits for the result; continuations
+			// added with Then hold the state and would otherwise keep it alive forever
+			if (!State->IsComplete())
+			{
+				State->DiscardContinuations();
+			}
 		}
 	}
 
@@ -1022,7 +1422,7 @@ public:
 	*/
 	void SetValue(ResultType& Result)
 	{
-		this->GetState()->SetResult(Result);
+		this->GetState()->SetResult(&Result);
 	}
 
 private:
@@ -1115,3 +1515,104 @@ private:
 	/** Whether a future has already been retrieved from this promise. */
 	bool FutureRetrieved;
 };
+
+
+/* Combinators
+*****************************************************************************/
+
+namespace UE4Future_Private
+{
+	struct FFutureCombinators
+	{
+		template<typename FutureType>
+		static TFuture<void> WhenAll(const TArray<FutureType>& Futures)
+		{
+			struct FWhenAllState
+			{
+				TPromise<void> Promise;
+				FThreadSafeCounter NumPending;
+			};
+
+			TSharedRef<FWhenAllState, ESPMode::ThreadSafe> State = MakeShareable(new FWhenAllState);
+			TFuture<void> Result = State->Promise.GetFuture();
+
+			// the extra count keeps the promise from being set before the last continuation is added
+			State->NumPending.Set(Futures.Num() + 1);
+			auto OnReady = [State]()
+			{
+				if (State->NumPending.Decrement() == 0)
+				{
+					State->Promise.SetValue();
+				}
+			};
+
+			for (const FutureType& Future : Futures)
+			{
+				Future.GetState()->AddContinuation(OnReady);
+			}
+			OnReady();
+
+			return Result;
+		}
+
+		template<typename FutureType>
+		static TFuture<int32> WhenAny(const TArray<FutureType>& Futures)
+		{
+			// if you hit this assertion then the returned future would never be set
+			check(Futures.Num() > 0);
+
+			struct FWhenAnyState
+			{
+				TPromise<int32> Promise;
+				FThreadSafeCounter NumReady;
+			};
+
+			TSharedRef<FWhenAnyState, ESPMode::ThreadSafe> State = MakeShareable(new FWhenAnyState);
+			TFuture<int32> Result = State->Promise.GetFuture();
+
+			for (int32 Index = 0; Index < Futures.Num(); Index++)
+			{
+				Futures[Index].GetState()->AddContinuation([State, Index]()
+				{
+					if (State->NumReady.Increment() == 1)
+					{
+						State->Promise.SetValue(Index);
+					}
+				});
+			}
+
+			return Result;
+		}
+	};
+}
+
+
+/**
+* Gets a future that is set once all the given futures have their result, without blocking a thread until then.
+* The futures stay valid, so a continuation of the returned future can read their results without waiting;
+* keeping them in a shared array or using TSharedFuture makes them easy to reach from there.
+*
+* @param Futures The futures to wait for, TFuture or TSharedFuture of any result type.
+* @return A future that is set once all of them are ready, right away if the array is empty.
+* @see WhenAny
+*/
+template<typename FutureType>
+TFuture<void> WhenAll(const TArray<FutureType>& Futures)
+{
+	return UE4Future_Private::FFutureCombinators::WhenAll(Futures);
+}
+
+
+/**
+* Gets a future that is set once any of the given futures has its result, without blocking a thread until then.
+* The futures stay valid.
+*
+* @param Futures The futures to wait for, TFuture or TSharedFuture of any result type. Must not be empty.
+* @return A future that is set to the index of the first future to be ready.
+* @see WhenAll
+*/
+template<typename FutureType>
+TFuture<int32> WhenAny(const TArray<FutureType>& Futures)
+{
+	return UE4Future_Private::FFutureCombinators::WhenAny(Futures);
+}
@@ -245,3 +245,297 @@ inline void ParallelForWithPreWork(int32 Num, TFunctionRef<void(int32)> Body, TF
 	// Data must live on until all of the tasks are cleared which might be long after this function exits
 }
 
+
+// struct to hold the working data of the range based variants; like FParallelForData, it outlives the call
+struct FParallelForRangeData
+{
+	int32 Num;
+	int32 MinBatchSize;
+	/** Number of Process calls, including the one from the calling thread **/
+	int32 NumParticipants;
+	/** Body(Begin, End, ParticipantIndex) **/
+	TFunctionRef<void(int32, int32, int32)> Body;
+	FEvent* Event;
+	/** Start of the first range nobody has taken **/
+	volatile int32 NextIndex;
+	FThreadSafeCounter NumCompleted;
+	FThreadSafeCounter NextParticipant;
+	bool bExited;
+	bool bTriggered;
+	FParallelForRangeData(int32 InTotalNum, int32 InMinBatchSize, int32 InNumParticipants, TFunctionRef<void(int32, int32, int32)> InBody)
+		: Num(InTotalNum)
+		, MinBatchSize(InMinBatchSize)
+		, NumParticipants(InNumParticipants)
+		, Body(InBody)
+		, Event(FPlatformProcess::GetSynchEventFromPool(false))
+		, NextIndex(0)
+		, bExited(false)
+		, bTriggered(false)
+	{
+		check(Num > 0 && MinBatchSize > 0 && NumParticipants > 1);
+	}
+	~FParallelForRangeData()
+	{
+		check(NextIndex >= Num);
+		check(NumCompleted.GetValue() == Num);
+		check(bExited);
+		FPlatformProcess::ReturnSynchEventToPool(Event);
+	}
+
+	/** 
+	 * Guided splitting: each batch is a share of what is left, so batches start large to keep the number of atomics low,
+	 * and shrink down to MinBatchSize towards the end so that uneven bodies still balance.
+	 */
+	FORCEINLINE int32 GetBatchSize(int32 Remaining) const
+	{
+		return YMath::Min(Remaining, YMath::Max(MinBatchSize, Remaining / (NumParticipants * 2)));
+	}
+
+	bool Process(int32 TasksToSpawn, TSharedRef<FParallelForRangeData, ESPMode::ThreadSafe>& Data);
+};
+
+class FParallelForRangeTask
+{
+	TSharedRef<FParallelForRangeData, ESPMode::ThreadSafe> Data;
+	int32 TasksToSpawn;
+public:
+	FParallelForRangeTask(TSharedRef<FParallelForRangeData, ESPMode::ThreadSafe>& InData, int32 InTasksToSpawn = 0)
+		: Data(InData)
+		, TasksToSpawn(InTasksToSpawn)
+	{
+	}
+	static FORCEINLINE TStatId GetStatId()
+	{
+		return GET_STATID(STAT_ParallelForTask);
+	}
+	static FORCEINLINE ENamedThreads::Type GetDesiredThread()
+	{
+		return ENamedThreads::AnyHiPriThreadHiPriTask;
+	}
+	static FORCEINLINE ESubsequentsMode::Type GetSubsequentsMode()
+	{
+		return ESubsequentsMode::FireAndForget;
+	}
+	void DoTask(ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+	{
+		if (Data->Process(TasksToSpawn, Data))
+		{
+			checkSlow(!Data->bTriggered);
+			Data->bTriggered = true;
+			Data->Event->Trigger();
+		}
+	}
+};
+
+inline bool FParallelForRangeData::Process(int32 TasksToSpawn, TSharedRef<FParallelForRangeData, ESPMode::ThreadSafe>& Data)
+{
+	if (TasksToSpawn && Num - NextIndex > MinBatchSize)
+	{
+		TGraphTask<FParallelForRangeTask>::CreateTask().ConstructAndDispatchWhenReady(Data, TasksToSpawn - 1);
+	}
+	const int32 ParticipantIndex = NextParticipant.Increment() - 1;
+	check(ParticipantIndex < NumParticipants);
+	const int32 LocalNum = Num;
+	TFunctionRef<void(int32, int32, int32)> LocalBody(Body);
+	while (true)
+	{
+		const int32 Begin = NextIndex;
+		if (Begin >= LocalNum)
+		{
+			break;
+		}
+		const int32 End = Begin + GetBatchSize(LocalNum - Begin);
+		if (FPlatformAtomics::InterlockedCompareExchange(&NextIndex, End, Begin) != Begin)
+		{
+			continue;
+		}
+		LocalBody(Begin, End, ParticipantIndex);
+		checkSlow(!bExited);
+		const int32 LocalNumCompleted = NumCompleted.Add(End - Begin) + (End - Begin);
+		if (LocalNumCompleted == LocalNum)
+		{
+			return true;
+		}
+		checkSlow(LocalNumCompleted < LocalNum);
+	}
+	return false;
+}
+
+namespace UE4ParallelFor_Private
+{
+	/** @return the batch size to use when the caller left it to us **/
+	inline int32 GetMinBatchSize(int32 Num, int32 MinBatchSize)
+	{
+		if (MinBatchSize > 0)
+		{
+			return MinBatchSize;
+		}
+		// small enough that the last batches of each thread balance uneven bodies, large enough that cheap bodies are not dominated by the atomics
+		return YMath::Max(1, Num / (YMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1) * 32));
+	}
+
+	/** @return the number of tasks to start to help the calling thread, 0 to run everything on the calling thread **/
+	inline int32 GetNumRangeTasks(int32 Num, int32 MinBatchSize, bool bForceSingleThread)
+	{
+		if (Num <= MinBatchSize || bForceSingleThread || !FApp::ShouldUseThreadingForPerformance())
+		{
+			return 0;
+		}
+		return YMath::Min<int32>(FTaskGraphInterface::Get().GetNumWorkerThreads(), YMath::DivideAndRoundUp(Num, MinBatchSize) - 1);
+	}
+
+	/** Runs Body(Begin, End, ParticipantIndex) over [0, Num) with AnyThreadTasks tasks helping the calling thread, which is participant 0 when there are none **/
+	inline void ParallelForRange(int32 Num, int32 MinBatchSize, int32 AnyThreadTasks, TFunctionRef<void(int32, int32, int32)> Body, TFunctionRef<void()>* CurrentThreadWorkToDoBeforeHelping)
+	{
+		if (!AnyThreadTasks)
+		{
+			if (CurrentThreadWorkToDoBeforeHelping)
+			{
+				(*CurrentThreadWorkToDoBeforeHelping)();
+			}
+			if (Num)
+			{
+				Body(0, Num, 0);
+			}
+			return;
+		}
+		FParallelForRangeData* DataPtr = new FParallelForRangeData(Num, MinBatchSize, AnyThreadTasks + 1, Body);
+		TSharedRef<FParallelForRangeData, ESPMode::ThreadSafe> Data = MakeShareable(DataPtr);
+		TGraphTask<FParallelForRangeTask>::CreateTask().ConstructAndDispatchWhenReady(Data, AnyThreadTasks - 1);
+		if (CurrentThreadWorkToDoBeforeHelping)
+		{
+			(*CurrentThreadWorkToDoBeforeHelping)();
+		}
+		// this thread can help too and this is important to prevent deadlock on recursion 
+		if (!Data->Process(0, Data))
+		{
+			Data->Event->Wait();
+			check(Data->bTriggered);
+		}
+		else
+		{
+			check(!Data->bTriggered);
+		}
+		check(Data->NumCompleted.GetValue() == Data->Num);
+		Data->bExited = true;
+		// Data must live on until all of the tasks are cleared which might be long after this function exits
+	}
+}
+
+/**
+*	General purpose parallel for over ranges that uses the taskgraph. Each call handles a contiguous range, so the per item cost is a loop iteration rather than a call.
+*	Ranges start large and shrink as the work runs out, which balances uneven bodies.
+*	@param Num; number of items; Body is called with ranges [Begin, End) that together cover [0, Num) exactly once
+*	@param Body; Function to call from multiple threads
+*	@param MinBatchSize; Smallest range to hand out, except for the last one. 0 picks one from Num and the number of threads.
+*	@param bForceSingleThread; Mostly used for testing, if true, run single threaded instead.
+*	Notes: Please add stats around to calls to parallel for and within your lambda as appropriate. Do not clog the task graph with long running tasks or tasks that block.
+**/
+inline void ParallelForRange(int32 Num, TFunctionRef<void(int32, int32)> Body, int32 MinBatchSize = 0, bool bForceSingleThread = false)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ParallelFor);
+	check(Num >= 0);
+	MinBatchSize = UE4ParallelFor_Private::GetMinBatchSize(Num, MinBatchSize);
+	UE4ParallelFor_Private::ParallelForRange(Num, MinBatchSize, UE4ParallelFor_Private::GetNumRangeTasks(Num, MinBatchSize, bForceSingleThread),
+		[&Body](int32 Begin, int32 End, int32 ParticipantIndex)
+		{
+			Body(Begin, End);
+		},
+		nullptr);
+}
+
+/**
+*	General purpose parallel for over ranges that uses the taskgraph, see ParallelForRange. No task is started for less than MinBatchSize items.
+*	@param Num; number of items; Body is called with ranges [Begin, End) that together cover [0, Num) exactly once
+*	@param Body; Function to call from multiple threads
+*   @param CurrentThreadWorkToDoBeforeHelping; The work is performed on the main thread before it starts helping with the ParallelFor proper
+*	@param MinBatchSize; Smallest range to hand out, except for the last one. 0 picks one from Num and the number of threads.
+*	@param bForceSingleThread; Mostly used for testing, if true, run single threaded instead.
+**/
+inline void ParallelForRangeWithPreWork(int32 Num, TFunctionRef<void(int32, int32)> Body, TFunctionRef<void()> CurrentThreadWorkToDoBeforeHelping, int32 MinBatchSize = 0, bool bForceSingleThread = false)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ParallelFor);
+	check(Num >= 0);
+	MinBatchSize = UE4ParallelFor_Private::GetMinBatchSize(Num, MinBatchSize);
+	// unlike ParallelForRange, the calling thread is busy with the prework, so a single batch is still worth a task
+	int32 AnyThreadTasks = UE4ParallelFor_Private::GetNumRangeTasks(Num, MinBatchSize, bForceSingleThread);
+	if (Num && !bForceSingleThread && FApp::ShouldUseThreadingForPerformance())
+	{
+		AnyThreadTasks = YMath::Max(AnyThreadTasks, 1);
+	}
+	UE4ParallelFor_Private::ParallelForRange(Num, MinBatchSize, AnyThreadTasks,
+		[&Body](int32 Begin, int32 End, int32 ParticipantIndex)
+		{
+			Body(Begin, End);
+		},
+		&CurrentThreadWorkToDoBeforeHelping);
+}
+
+/**
+*	Parallel reduction over ranges that uses the taskgraph. Each thread accumulates into its own copy of the result, starting from Identity, 
+*	and the copies are combined on the calling thread at the end.
+*	@param Num; number of items
+*	@param Identity; Value that Combine leaves the other operand unchanged with, and the result when Num is 0
+*	@param RangeBody; T(int32 Begin, int32 End, T Accumulator), accumulates the items of [Begin, End) into Accumulator and returns it
+*	@param Combine; T(const T& A, const T& B). Ranges are not handed out in order, so this must be associative and commutative.
+*	@param MinBatchSize; Smallest range to hand out, except for the last one. 0 picks one from Num and the number of threads.
+*	@param bForceSingleThread; Mostly used for testing, if true, run single threaded instead.
+*	@return the combination of all of the accumulators
+**/
+template<typename T, typename RangeBodyType, typename CombineType>
+T ParallelReduce(int32 Num, const T& Identity, RangeBodyType RangeBody, CombineType Combine, int32 MinBatchSize = 0, bool bForceSingleThread = false)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ParallelFor);
+	check(Num >= 0);
+	MinBatchSize = UE4ParallelFor_Private::GetMinBatchSize(Num, MinBatchSize);
+	const int32 AnyThreadTasks = UE4ParallelFor_Private::GetNumRangeTasks(Num, MinBatchSize, bForceSingleThread);
+	if (!AnyThreadTasks)
+	{
+		return Num ? RangeBody(0, Num, Identity) : Identity;
+	}
+
+	// space the accumulators a cache line apart so the threads don't fight over them
+	const int32 Stride = YMath::DivideAndRoundUp<int32>(PLATFORM_CACHE_LINE_SIZE, sizeof(T));
+	const int32 NumParticipants = AnyThreadTasks + 1;
+	TArray<T> Accumulators;
+	Accumulators.Init(Identity, NumParticipants * Stride);
+	UE4ParallelFor_Private::ParallelForRange(Num, MinBatchSize, AnyThreadTasks,
+		[&Accumulators, &RangeBody, Stride](int32 Begin, int32 End, int32 ParticipantIndex)
+		{
+			T& Accumulator = Accumulators[ParticipantIndex * Stride];
+			Accumulator = RangeBody(Begin, End, MoveTemp(Accumulator));
+		},
+		nullptr);
+
+	T Result = MoveTemp(Accumulators[0]);
+	for (int32 ParticipantIndex = 1; ParticipantIndex < NumParticipants; ParticipantIndex++)
+	{
+		Result = Combine(Result, Accumulators[ParticipantIndex * Stride]);
+	}
+	return Result;
+}
+
+/**
+*	Parallel map and reduce that uses the taskgraph, see ParallelReduce.
+*	@param Num; number of items
+*	@param Identity; Value that Combine leaves the other operand unchanged with, and the result when Num is 0
+*	@param Transform; T(int32 Index), the value of one item
+*	@param Combine; T(const T& A, const T& B), must be associative and commutative
+*	@param MinBatchSize; Smallest range to hand out, except for the last one. 0 picks one from Num and the number of threads.
+*	@param bForceSingleThread; Mostly used for testing, if true, run single threaded instead.
+*	@return the combination of the values of all of the items
+**/
+template<typename T, typename TransformType, typename CombineType>
+T ParallelTransformReduce(int32 Num, const T& Identity, TransformType Transform, CombineType Combine, int32 MinBatchSize = 0, bool bForceSingleThread = false)
+{
+	return ParallelReduce(Num, Identity,
+		[&Transform, &Combine](int32 Begin, int32 End, T Accumulator)
+		{
+			for (int32 Index = Begin; Index < End; Index++)
+			{
+				Accumulator = Combine(Accumulator, Transform(Index));
+			}
+			return Accumulator;
+		},
+		Combine, MinBatchSize, bForceSingleThread);
+}
@@ -0,0 +1,429 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	ParallelSort.h: Sorts that split the work across the task graph
+=============================================================================*/
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Math/SolidAngleMathUtility.h"
+#include "Templates/SolidAngleTemplate.h"
+#include "Templates/Less.h"
+#include "Templates/Sorting.h"
+#include "Containers/Array.h"
+#include "Containers/ArrayView.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Async/ParallelFor.h"
+
+namespace UE4ParallelSort_Private
+{
+	/** Chunks are not made smaller than this, below it the tasks cost more than they save */
+	enum { MinChunkSize = 4096 };
+
+	/** Runs shorter than this are insertion sorted before the buffered merge sort starts merging */
+	enum { InsertionSortRunSize = 32 };
+
+	/** Part of a merge of two adjacent runs that can be done independently of the other parts */
+	struct FMergePiece
+	{
+		int32 BeginA;
+		int32 EndA;
+		int32 BeginB;
+		int32 EndB;
+		int32 Out;
+	};
+
+	/** @return first index in [Begin, End) whose element is not ordered before Value */
+	template<class T, class PREDICATE_CLASS>
+	int32 LowerBound(const T* Data, int32 Begin, int32 End, const T& Value, const PREDICATE_CLASS& Predicate)
+	{
+		while (Begin < End)
+		{
+			const int32 Middle = Begin + (End - Begin) / 2;
+			if (Predicate(Data[Middle], Value))
+			{
+				Begin = Middle + 1;
+			}
+			else
+			{
+				End = Middle;
+			}
+		}
+		return Begin;
+	}
+
+	/** @return first index in [Begin, End) whose element Value is ordered before */
+	template<class T, class PREDICATE_CLASS>
+	int32 UpperBound(const T* Data, int32 Begin, int32 End, const T& Value, const PREDICATE_CLASS& Predicate)
+	{
+		while (Begin < End)
+		{
+			const int32 Middle = Begin + (End - Begin) / 2;
+			if (Predicate(Value, Data[Middle]))
+			{
+				End = Middle;
+			}
+			else
+			{
+				Begin = Middle + 1;
+			}
+		}
+		return Begin;
+	}
+
+	/** Moves the merge of two sorted runs to Out. Elements of A come first on ties, which keeps the merge stable. */
+	template<class T, class PREDICATE_CLASS>
+	void MergeRuns(T* A, T* EndA, T* B, T* EndB, T* Out, const PREDICATE_CLASS& Predicate)
+	{
+		while (A != EndA && B != EndB)
+		{
+			if (Predicate(*B, *A))
+			{
+				*Out++ = MoveTemp(*B++);
+			}
+			else
+			{
+				*Out++ = MoveTemp(*A++);
+			}
+		}
+		while (A != EndA)
+		{
+			*Out++ = MoveTemp(*A++);
+		}
+		while (B != EndB)
+		{
+			*Out++ = MoveTemp(*B++);
+		}
+	}
+
+	/**
+	 * Stable merge sort that merges through a scratch buffer of Num elements instead of rotating in place like
+	 * StableSortInternal does, which makes it O(n log n) rather than O(n log^2 n).
+	 */
+	template<class T, class PREDICATE_CLASS>
+	void StableSortWithBuffer(T* First, const int32 Num, T* Buffer, const PREDICATE_CLASS& Predicate)
+	{
+		for (int32 RunBegin = 0; RunBegin < Num; RunBegin += InsertionSortRunSize)
+		{
+			const int32 RunEnd = YMath::Min<int32>(RunBegin + InsertionSortRunSize, Num);
+			for (int32 Index = RunBegin + 1; Index < RunEnd; Index++)
+			{
+				if (Predicate(First[Index], First[Index - 1]))
+				{
+					T Value = MoveTemp(First[Index]);
+					int32 Insert = Index;
+					do
+					{
+						First[Insert] = MoveTemp(First[Insert - 1]);
+						Insert--;
+					}
+					while (Insert > RunBegin && Predicate(Value, First[Insert - 1]));
+					First[Insert] = MoveTemp(Value);
+				}
+			}
+		}
+
+		T* Source = First;
+		T* Dest = Buffer;
+		for (int32 RunSize = InsertionSortRunSize; RunSize < Num; RunSize *= 2)
+		{
+			for (int32 RunBegin = 0; RunBegin < Num; RunBegin += 2 * RunSize)
+			{
+				const int32 Middle = YMath::Min<int32>(RunBegin + RunSize, Num);
+				const int32 RunEnd = YMath::Min<int32>(RunBegin + 2 * RunSize, Num);
+				MergeRuns(Source + RunBegin, Source + Middle, Source + Middle, Source + RunEnd, Dest + RunBegin, Predicate);
+			}
+			Exchange(Source, Dest);
+		}
+		if (Source != First)
+		{
+			for (int32 Index = 0; Index < Num; Index++)
+			{
+				First[Index] = MoveTemp(Source[Index]);
+			}
+		}
+	}
+
+	/** @return the default cap on the number of chunks, a couple per participant so that an uneven chunk doesn't hold everyone up */
+	inline int32 GetDefaultMaxChunks()
+	{
+		return 2 * (FTaskGraphInterface::Get().GetNumWorkerThreads() + 1);
+	}
+
+	/** @return the number of chunks to sort independently, a power of two so that they merge in pairs */
+	inline int32 GetNumChunks(int32 Num, int32 MaxChunks)
+	{
+		int32 NumChunks = 1;
+		while (NumChunks * 2 <= MaxChunks && Num / (NumChunks * 2) >= MinChunkSize)
+		{
+			NumChunks *= 2;
+		}
+		return NumChunks;
+	}
+
+	/**
+	 * Sorts the chunks of the array in parallel, then merges pairs of adjacent runs until one is left. Each merge round
+	 * is split into about as many pieces as there are chunks, so the last rounds keep every thread busy as well.
+	 * Merges go back and forth between the array and a buffer of Num elements, which is why T must be default
+	 * constructible. No more than MaxChunks tasks run at once.
+	 */
+	template<class T, class PREDICATE_CLASS>
+	void ParallelSortInternal(T* First, const int32 Num, const PREDICATE_CLASS& Predicate, bool bStable, int32 MaxChunks = GetDefaultMaxChunks())
+	{
+		const int32 NumChunks = GetNumChunks(Num, MaxChunks);
+		if (NumChunks == 1)
+		{
+			if (bStable)
+			{
+				TArray<T> Buffer;
+				Buffer.AddDefaulted(Num);
+				StableSortWithBuffer(First, Num, Buffer.GetData(), Predicate);
+			}
+			else
+			{
+				SortInternal(First, Num, Predicate);
+			}
+			return;
+		}
+
+		TArray<T> Buffer;
+		Buffer.AddDefaulted(Num);
+		auto ChunkBegin = [Num, NumChunks](int32 Chunk)
+		{
+			return int32((int64)Num * Chunk / NumChunks);
+		};
+
+		ParallelFor(NumChunks, [First, &Buffer, &Predicate, &ChunkBegin, bStable](int32 Chunk)
+		{
+			const int32 Begin = ChunkBegin(Chunk);
+			const int32 End = ChunkBegin(Chunk + 1);
+			if (bStable)
+			{
+				StableSortWithBuffer(First + Begin, End - Begin, Buffer.GetData() + Begin, Predicate);
+			}
+			else
+			{
+				SortInternal(First + Begin, End - Begin, Predicate);
+			}
+		});
+
+		T* Source = First;
+		T* Dest = Buffer.GetData();
+		TArray<FMergePiece> Pieces;
+		for (int32 ChunksPerRun = 1; ChunksPerRun < NumChunks; ChunksPerRun *= 2)
+		{
+			const int32 NumPiecesPerMerge = ChunksPerRun * 2;
+			Pieces.Reset();
+			for (int32 Chunk = 0; Chunk < NumChunks; Chunk += 2 * ChunksPerRun)
+			{
+				const int32 BeginA = ChunkBegin(Chunk);
+				const int32 BeginB = ChunkBegin(Chunk + ChunksPerRun);
+				const int32 EndB = ChunkBegin(Chunk + 2 * ChunksPerRun);
+
+				// Split the longer run evenly and find the matching split points in the other one
+				int32 PrevA = BeginA;
+				int32 PrevB = BeginB;
+				for (int32 Piece = 1; Piece <= NumPiecesPerMerge; Piece++)
+				{
+					int32 SplitA = BeginB;
+					int32 SplitB = EndB;
+					if (Piece < NumPiecesPerMerge)
+					{
+						if (BeginB - BeginA >= EndB - BeginB)
+						{
+							SplitA = BeginA + int32((int64)(BeginB - BeginA) * Piece / NumPiecesPerMerge);
+							SplitB = LowerBound(Source, BeginB, EndB, Source[SplitA], Predicate);
+						}
+						else
+						{
+							SplitB = BeginB + int32((int64)(EndB - BeginB) * Piece / NumPiecesPerMerge);
+							SplitA = UpperBound(Source, BeginA, BeginB, Source[SplitB], Predicate);
+						}
+					}
+					FMergePiece& NewPiece = Pieces[Pieces.AddUninitialized()];
+					NewPiece.BeginA = PrevA;
+					NewPiece.EndA = SplitA;
+					NewPiece.BeginB = PrevB;
+					NewPiece.EndB = SplitB;
+					NewPiece.Out = PrevA + PrevB - BeginB;
+					PrevA = SplitA;
+					PrevB = SplitB;
+				}
+			}
+
+			ParallelFor(Pieces.Num(), [Source, Dest, &Pieces, &Predicate](int32 Index)
+			{
+				const FMergePiece& Piece = Pieces[Index];
+				MergeRuns(Source + Piece.BeginA, Source + Piece.EndA, Source + Piece.BeginB, Source + Piece.EndB, Dest + Piece.Out, Predicate);
+			});
+			Exchange(Source, Dest);
+		}
+
+		if (Source != First)
+		{
+			ParallelFor(NumChunks, [First, Source, &ChunkBegin](int32 Chunk)
+			{
+				for (int32 Index = ChunkBegin(Chunk), End = ChunkBegin(Chunk + 1); Index < End; Index++)
+				{
+					First[Index] = MoveTemp(Source[Index]);
+				}
+			});
+		}
+	}
+}
+
+/**
+* Sort elements using user defined predicate class, spreading the work over the task graph worker threads.
+* The sort is unstable, meaning that the ordering of equal items is not necessarily preserved.
+* Small arrays are sorted on the calling thread; larger ones need T to be default constructible.
+*
+* @param	First	pointer to the first element to sort
+* @param	Num		the number of items to sort
+* @param Predicate predicate class, called from several threads at once
+*/
+template<class T, class PREDICATE_CLASS>
+void ParallelSort(T* First, const int32 Num, const PREDICATE_CLASS& Predicate)
+{
+	UE4ParallelSort_Private::ParallelSortInternal(First, Num, TDereferenceWrapper<T, PREDICATE_CLASS>(Predicate), false);
+}
+
+/**
+* Specialized version of the above ParallelSort function for pointers to elements.
+*
+* @param	First	pointer to the first element to sort
+* @param	Num		the number of items to sort
+* @param Predicate predicate class, called from several threads at once
+*/
+template<class T, class PREDICATE_CLASS>
+void ParallelSort(T** First, const int32 Num, const PREDICATE_CLASS& Predicate)
+{
+	UE4ParallelSort_Private::ParallelSortInternal(First, Num, TDereferenceWrapper<T*, PREDICATE_CLASS>(Predicate), false);
+}
+
+/**
+* Sort elements in parallel. The sort is unstable.
+* Assumes < operator is defined for the template type.
+*
+* @param	First	pointer to the first element to sort
+* @param	Num		the number of items to sort
+*/
+template<class T>
+void ParallelSort(T* First, const int32 Num)
+{
+	UE4ParallelSort_Private::ParallelSortInternal(First, Num, TDereferenceWrapper<T, TLess<T> >(TLess<T>()), false);
+}
+
+/**
+* Specialized version of the above ParallelSort function for pointers to elements.
+*
+* @param	First	pointer to the first element to sort
+* @param	Num		the number of items to sort
+*/
+template<class T>
+void ParallelSort(T** First, const int32 Num)
+{
+	UE4ParallelSort_Private::ParallelSortInternal(First, Num, TDereferenceWrapper<T*, TLess<T> >(TLess<T>()), false);
+}
+
+/**
+* Stable sort elements using user defined predicate class, spreading the work over the task graph worker threads.
+* The ordering of equal items is preserved. Unlike StableSort this merges through a buffer of Num elements, so T must
+* be default constructible, but it runs in O(n log n) even on a single thread.
+*
+* @param	First	pointer to the first element to sort
+* @param	Num		the number of items to sort
+* @param Predicate predicate class, called from several threads at once
+*/
+template<class T, class PREDICATE_CLASS>
+void ParallelStableSort(T* First, const int32 Num, const PREDICATE_CLASS& Predicate)
+{
+	UE4ParallelSort_Private::ParallelSortInternal(First, Num, TDereferenceWrapper<T, PREDICATE_CLASS>(Predicate), true);
+}
+
+/**
+* Specialized version of the above ParallelStableSort function for pointers to elements.
+*
+* @param	First	pointer to the first element to sort
+* @param	Num		the number of items to sort
+* @param Predicate predicate class, called from several threads at once
+*/
+template<class T, class PREDICATE_CLASS>
+void ParallelStableSort(T** First, const int32 Num, const PREDICATE_CLASS& Predicate)
+{
+	UE4ParallelSort_Private::ParallelSortInternal(First, Num, TDereferenceWrapper<T*, PREDICATE_CLASS>(Predicate), true);
+}
+
+/**
+* Stable sort elements in parallel.
+* Assumes < operator is defined for the template type.
+*
+* @param	First	pointer to the first element to sort
+* @param	Num		the number of items to sort
+*/
+template<class T>
+void ParallelStableSort(T* First, const int32 Num)
+{
+	UE4ParallelSort_Private::ParallelSortInternal(First, Num, TDereferenceWrapper<T, TLess<T> >(TLess<T>()), true);
+}
+
+/**
+* Specialized version of the above ParallelStableSort function for pointers to elements.
+*
+* @param	First	pointer to the first element to sort
+* @param	Num		the number of items to sort
+*/
+template<class T>
+void ParallelStableSort(T** First, const int32 Num)
+{
+	UE4ParallelSort_Private::ParallelSortInternal(First, Num, TDereferenceWrapper<T*, TLess<T> >(TLess<T>()), true);
+}
+
+/** Array versions of the above, arrays of pointers are sorted by the pointed to elements like TArray::Sort does */
+template<typename ElementType, typename Allocator>
+void ParallelSort(TArray<ElementType, Allocator>& Array)
+{
+	ParallelSort(Array.GetData(), Array.Num());
+}
+
+template<typename ElementType, typename Allocator, class PREDICATE_CLASS>
+void ParallelSort(TArray<ElementType, Allocator>& Array, const PREDICATE_CLASS& Predicate)
+{
+	ParallelSort(Array.GetData(), Array.Num(), Predicate);
+}
+
+template<typename ElementType, typename Allocator>
+void ParallelStableSort(TArray<ElementType, Allocator>& Array)
+{
+	ParallelStableSort(Array.GetData(), Array.Num());
+}
+
+template<typename ElementType, typename Allocator, class PREDICATE_CLASS>
+void ParallelStableSort(TArray<ElementType, Allocator>& Array, const PREDICATE_CLASS& Predicate)
+{
+	ParallelStableSort(Array.GetData(), Array.Num(), Predicate);
+}
+
+template<typename ElementType>
+void ParallelSort(TArrayView<ElementType> View)
+{
+	ParallelSort(View.GetData(), View.Num());
+}
+
+template<typename ElementType, class PREDICATE_CLASS>
+void ParallelSort(TArrayView<ElementType> View, const PREDICATE_CLASS& Predicate)
+{
+	ParallelSort(View.GetData(), View.Num(), Predicate);
+}
+
+template<typename ElementType>
+void ParallelStableSort(TArrayView<ElementType> View)
+{
+	ParallelStableSort(View.GetData(), View.Num());
+}
+
+template<typename ElementType, class PREDICATE_CLASS>
+void ParallelStableSort(TArrayView<ElementType> View, const PREDICATE_CLASS& Predicate)
+{
+	ParallelStableSort(View.GetData(), View.Num(), Predicate);
+}
@@ -7,6 +7,8 @@ TaskGraphInterfaces.h: TaskGraph library
 #include "CoreTypes.h"
 #include "Misc/AssertionMacros.h"
 #include "Templates/AlignOf.h"
+#include "Templates/AlignmentTemplates.h"
+#include "HAL/SolidAngleMemory.h"
 #include "Containers/ContainerAllocationPolicies.h"
 #include "Containers/Array.h"
 #include "Containers/SolidAngleString.h"
@@ -20,6 +22,7 @@ TaskGraphInterfaces.h: TaskGraph library
 #include "Templates/RefCounting.h"
 #include "Containers/LockFreeFixedSizeAllocator.h"
 #include "Misc/MemStack.h"
+#include "Async/TaskGraphTrace.h"
 
 #if !defined(STATS)
 #error "STATS must be defined as either zero or one."
@@ -238,6 +241,16 @@ class FTaskGraphInterface
 	**/
 	virtual void QueueTask(class FBaseGraphTask* Task, ENamedThreads::Type ThreadToExecuteOn, ENamedThreads::Type CurrentThreadIfKnown = ENamedThreads::AnyThread) = 0;
 
+	/**
+	*	Internal function to queue several tasks at once, used by TGraphTaskBatch.
+	*	Anythread tasks queued from a task thread go to its own deque in one push and idle task threads are woken to steal them, otherwise each task is queued with QueueTask.
+	*	@param	Tasks; the tasks to queue
+	*	@param	NumTasks; the number of tasks
+	*	@param	ThreadToExecuteOn; the thread all of the tasks execute on, as for QueueTask
+	*	@param	CurrentThreadIfKnown; This should be the current thread if it is known, or otherwise use ENamedThreads::AnyThread and the current thread will be determined.
+	**/
+	virtual void QueueTasks(class FBaseGraphTask* const* Tasks, int32 NumTasks, ENamedThreads::Type ThreadToExecuteOn, ENamedThreads::Type CurrentThreadIfKnown = ENamedThreads::AnyThread) = 0;
+
 public:
 
 	virtual ~FTaskGraphInterface()
@@ -395,9 +408,20 @@ protected:
 	{
 #if USE_VIRTUAL_BYPASS
 		ExecuteTaskPtr = InExecuteTaskPtr;
+#endif
+#if TASKGRAPH_TRACE
+		TraceTaskId = FTaskGraphTrace::IsEnabled() ? FTaskGraphTrace::NewTaskId() : 0;
 #endif
 		checkThreadGraph(LifeStage.Increment() == int32(LS_Contructed));
 	}
+
+#if TASKGRAPH_TRACE
+	/** @return the id this task is recorded with by FTaskGraphTrace, 0 if it was created while tracing was off */
+	uint32 GetTraceTaskId() const
+	{
+		return TraceTaskId;
+	}
+#endif
 	/**
 	*	Sets the desired execution thread. This is not part of the constructor because this information may not be known quite yet duiring construction.
 	*	@param InThreadToExecuteOn; the desired thread to execute on.
@@ -422,6 +446,26 @@ protected:
 			QueueTask(CurrentThread);
 		}
 	}
+
+	/**
+	*	Queues tasks that were set up with PrerequisitesComplete(..., false) all at once, see FTaskGraphInterface::QueueTasks.
+	*	@param Tasks; the tasks to queue, they all execute on ThreadToExecuteOn
+	*	@param CurrentThreadIfKnown; provides the index of the thread we are running on. Can be ENamedThreads::AnyThread if the current thread is unknown.
+	**/
+	static void QueueTasks(FBaseGraphTask* const* Tasks, int32 NumTasks, ENamedThreads::Type ThreadToExecuteOn, ENamedThreads::Type CurrentThreadIfKnown)
+	{
+		for (int32 Index = 0; Index < NumTasks; Index++)
+		{
+			checkThreadGraph(Tasks[Index]->LifeStage.Increment() == int32(LS_Queued));
+#if TASKGRAPH_TRACE
+			if (Tasks[Index]->TraceTaskId)
+			{
+				FTaskGraphTrace::TaskQueued(Tasks[Index]->TraceTaskId);
+			}
+#endif
+		}
+		FTaskGraphInterface::Get().QueueTasks(Tasks, NumTasks, ThreadToExecuteOn, CurrentThreadIfKnown);
+	}
 	/** destructor, just checks the life stage **/
 #if USE_VIRTUAL_BYPASS
 	FORCEINLINE
@@ -496,6 +540,12 @@ private:
 	void QueueTask(ENamedThreads::Type CurrentThreadIfKnown)
 	{
 		checkThreadGraph(LifeStage.Increment() == int32(LS_Queued));
+#if TASKGRAPH_TRACE
+		if (TraceTaskId)
+		{
+			FTaskGraphTrace::TaskQueued(TraceTaskId);
+		}
+#endif
 		FTaskGraphInterface::Get().QueueTask(this, ThreadToExecuteOn, CurrentThreadIfKnown);
 	}
 
@@ -506,6 +556,10 @@ private:
 	ENamedThreads::Type			ThreadToExecuteOn;
 	/**	Number of prerequisites outstanding. When this drops to zero, the thread is queued for execution.  **/
 	FThreadSafeCounter			NumberOfPrerequistitesOutstanding;
+#if TASKGRAPH_TRACE
+	/**	Id of the task in the trace, 0 if not traced **/
+	uint32						TraceTaskId;
+#endif
 
 
 #if !UE_BUILD_SHIPPING
@@ -566,6 +620,20 @@ public:
 		checkThreadGraph(!EventsToWaitFor.Num());
 	}
 
+#if TASKGRAPH_TRACE
+	/** @return the trace id of the task that completes this event, 0 if unknown or not traced */
+	uint32 GetTraceTaskId() const
+	{
+		return TraceTaskId;
+	}
+
+	/** Records which traced task completes this event, so that its subsequents can be linked to it */
+	void SetTraceTaskId(uint32 InTraceTaskId)
+	{
+		TraceTaskId = InTraceTaskId;
+	}
+#endif
+
 	/**
 	*	Delay the firing of this event until the given event fires.
 	*	CAUTION: This is only legal while executing the task associated with this event.
@@ -624,6 +692,9 @@ private:
 		, LockFreePointerQueueNext(nullptr)
 #endif
 	{
+#if TASKGRAPH_TRACE
+		TraceTaskId = 0;
+#endif
 	}
 
 	/**
@@ -668,6 +739,10 @@ private:
 	FGraphEventArray														EventsToWaitFor;
 	/** Number of outstanding references to this graph event **/
 	FThreadSafeCounter														ReferenceCount;
+#if TASKGRAPH_TRACE
+	/** Trace id of the task that completes this event **/
+	uint32																	TraceTaskId;
+#endif
 #if USE_NEW_LOCK_FREE_LISTS
 	void Reset();
 	bool bComplete;
@@ -878,7 +953,24 @@ private:
 		TTask& Task = *(TTask*)&TaskStorage;
 		{
 			FScopeCycleCounter Scope(Task.GetStatId(), true);
+#if TASKGRAPH_TRACE
+			const uint32 TraceTaskId = GetTraceTaskId();
+			if (TraceTaskId)
+			{
+#if STATS
+				FTaskGraphTrace::TaskStarted(TraceTaskId, Task.GetStatId().GetRawPointer());
+#else
+				FTaskGraphTrace::TaskStarted(TraceTaskId, nullptr);
+#endif
+			}
+#endif
 			Task.DoTask(CurrentThread, Subsequents);
+#if TASKGRAPH_TRACE
+			if (TraceTaskId)
+			{
+				FTaskGraphTrace::TaskFinished(TraceTaskId);
+			}
+#endif
 			Task.~TTask();
 			checkThreadGraph(ENamedThreads::GetThreadIndex(CurrentThread) <= ENamedThreads::RenderThread || FMemStack::Get().IsEmpty()); // you must mark and pop memstacks if you use them in tasks! Named threads are excepted.
 		}
@@ -927,6 +1019,18 @@ private:
 		, TaskConstructed(false)
 	{
 		Subsequents.Swap(InSubsequents);
+#if TASKGRAPH_TRACE
+		if (GetTraceTaskId() && Subsequents.GetReference())
+		{
+			// A gather task assumes the event of the task that called DontCompleteUntil, which it then completes
+			if (Subsequents->GetTraceTaskId())
+			{
+				FTaskGraphTrace::TaskDependency(Subsequents->GetTraceTaskId(), GetTraceTaskId());
+				FTaskGraphTrace::TaskCompletedBy(Subsequents->GetTraceTaskId(), GetTraceTaskId());
+			}
+			Subsequents->SetTraceTaskId(GetTraceTaskId());
+		}
+#endif
 	}
 
 	/**
@@ -966,6 +1070,12 @@ private:
 			for (int32 Index = 0; Index < Prerequisites->Num(); Index++)
 			{
 				check((*Prerequisites)[Index]);
+#if TASKGRAPH_TRACE
+				if (GetTraceTaskId() && (*Prerequisites)[Index]->GetTraceTaskId())
+				{
+					FTaskGraphTrace::TaskDependency((*Prerequisites)[Index]->GetTraceTaskId(), GetTraceTaskId());
+				}
+#endif
 				if (!(*Prerequisites)[Index]->AddSubsequent(this))
 				{
 					AlreadyCompletedPrerequisites++;
@@ -1036,6 +1146,257 @@ private:
 };
 
 
+/**
+*	TGraphTaskBatch
+*	Runs many tasks of the same type with the overhead of one: the tasks are built in a single allocation, share one completion event and are
+*	queued together. The batch itself is queued as a single task once its prerequisites are complete, and the task thread that runs it pushes
+*	all of the tasks to its work stealing deque at once, waking idle task threads to steal them.
+*	The embedded tasks have the same API as for TGraphTask, except that GetSubsequentsMode is not used and MyCompletionGraphEvent is the event
+*	of the whole batch, on which DontCompleteUntil must not be called. All of them must want the same thread.
+**/
+template<typename TTask>
+class TGraphTaskBatch : public FBaseGraphTask
+{
+public:
+	/**
+	*	Builds a batch of tasks and dispatches it when its prerequisites are complete.
+	*	@param NumTasks; the number of tasks in the batch.
+	*	@param Constructor; called in order with the index of each task, returns the task to embed, which is constructed in place.
+	*	@param Prerequisites; the list of FGraphEvents that must be completed prior to any task of the batch executing.
+	*	@param CurrentThreadIfKnown; provides the index of the thread we are running on. Can be ENamedThreads::AnyThread if the current thread is unknown.
+	*	@return the event that completes once all of the tasks have executed.
+	**/
+	template<typename ConstructorType>
+	static FGraphEventRef CreateAndDispatchWhenReady(int32 NumTasks, ConstructorType&& Constructor, const FGraphEventArray* Prerequisites = NULL, ENamedThreads::Type CurrentThreadIfKnown = ENamedThreads::AnyThread)
+	{
+		check(NumTasks >= 0);
+		const SIZE_T ItemsOffset = Align(sizeof(TGraphTaskBatch), ALIGNOF(FBatchedTask));
+		const SIZE_T TasksOffset = Align(ItemsOffset + NumTasks * sizeof(FBatchedTask), ALIGNOF(FBaseGraphTask*));
+		uint8* Memory = (uint8*)YMemory::Malloc(TasksOffset + NumTasks * sizeof(FBaseGraphTask*), YMath::Max<uint32>(ALIGNOF(FBatchedTask), PLATFORM_CACHE_LINE_SIZE));
+
+		TGraphTaskBatch* Batch = new (Memory) TGraphTaskBatch(NumTasks, Prerequisites ? Prerequisites->Num() : 0);
+		Batch->Tasks = (FBaseGraphTask**)(Memory + TasksOffset);
+		FBatchedTask* BatchedTasks = (FBatchedTask*)(Memory + ItemsOffset);
+		for (int32 Index = 0; Index < NumTasks; Index++)
+		{
+			FBatchedTask* BatchedTask = new (BatchedTasks + Index) FBatchedTask(Batch);
+			new ((void *)&BatchedTask->TaskStorage) TTask(Constructor(Index));
+			if (Index == 0)
+			{
+				Batch->DesiredThread = BatchedTask->GetTask().GetDesiredThread();
+			}
+			BatchedTask->Setup(Batch->DesiredThread, CurrentThreadIfKnown);
+			Batch->Tasks[Index] = BatchedTask;
+		}
+
+		FGraphEventRef ReturnedEventRef = Batch->Subsequents; // very important so that this doesn't get destroyed before we return
+		Batch->SetupPrereqs(Prerequisites, CurrentThreadIfKnown);
+		return ReturnedEventRef;
+	}
+
+private:
+	/** One task of the batch, queued and executed like any other task. **/
+	class FBatchedTask : public FBaseGraphTask
+	{
+	public:
+		FBatchedTask(TGraphTaskBatch* InBatch)
+			: FBaseGraphTask(
+#if USE_VIRTUAL_BYPASS
+				&ExecuteTask,
+#endif
+				0)
+			, Batch(InBatch)
+		{
+#if TASKGRAPH_TRACE
+			if (GetTraceTaskId() && Batch->GetTraceTaskId())
+			{
+				FTaskGraphTrace::TaskDependency(Batch->GetTraceTaskId(), GetTraceTaskId());
+			}
+#endif
+		}
+
+		TTask& GetTask()
+		{
+			return *(TTask*)&TaskStorage;
+		}
+
+		/** Sets the thread to execute on and leaves the task locked, the batch queues it. **/
+		void Setup(ENamedThreads::Type InThreadToExecuteOn, ENamedThreads::Type CurrentThreadIfKnown)
+		{
+			SetThreadToExecuteOn(InThreadToExecuteOn);
+			PrerequisitesComplete(CurrentThreadIfKnown, 0, false);
+		}
+
+		/** An aligned bit of storage to hold the embedded task **/
+		TAlignedBytes<sizeof(TTask), ALIGNOF(TTask)> TaskStorage;
+
+	private:
+		/**
+		*	Executes and destroys the embedded task, then destroys myself and lets the batch know.
+		**/
+#if USE_VIRTUAL_BYPASS
+		static void ExecuteTask(FBaseGraphTask *This, TArray<FBaseGraphTask*>& NewTasks, ENamedThreads::Type CurrentThread)
+		{
+			((FBatchedTask*)This)->ExecuteTaskInner(NewTasks, CurrentThread);
+		}
+		FORCEINLINE void ExecuteTaskInner(TArray<FBaseGraphTask*>& NewTasks, ENamedThreads::Type CurrentThread)
+#else
+		virtual void ExecuteTask(TArray<FBaseGraphTask*>& NewTasks, ENamedThreads::Type CurrentThread) final override
+#endif
+		{
+			TTask& Task = GetTask();
+			uint32 TraceTaskId = 0;
+			{
+				FScopeCycleCounter Scope(Task.GetStatId(), true);
+#if TASKGRAPH_TRACE
+				TraceTaskId = GetTraceTaskId();
+				if (TraceTaskId)
+				{
+#if STATS
+					FTaskGraphTrace::TaskStarted(TraceTaskId, Task.GetStatId().GetRawPointer());
+#else
+					FTaskGraphTrace::TaskStarted(TraceTaskId, nullptr);
+#endif
+				}
+#endif
+				Task.DoTask(CurrentThread, Batch->Subsequents);
+#if TASKGRAPH_TRACE
+				if (TraceTaskId)
+				{
+					FTaskGraphTrace::TaskFinished(TraceTaskId);
+				}
+#endif
+				Task.~TTask();
+				checkThreadGraph(ENamedThreads::GetThreadIndex(CurrentThread) <= ENamedThreads::RenderThread || FMemStack::Get().IsEmpty()); // you must mark and pop memstacks if you use them in tasks! Named threads are excepted.
+			}
+
+			TGraphTaskBatch* LocalBatch = Batch;
+			this->FBatchedTask::~FBatchedTask();
+			LocalBatch->Release(NewTasks, CurrentThread, TraceTaskId);
+		}
+
+		TGraphTaskBatch* Batch;
+	};
+
+	/**
+	*	Queues the tasks of the batch, all at once.
+	**/
+#if USE_VIRTUAL_BYPASS
+	static void ExecuteTask(FBaseGraphTask *This, TArray<FBaseGraphTask*>& NewTasks, ENamedThreads::Type CurrentThread)
+	{
+		((TGraphTaskBatch*)This)->ExecuteTaskInner(NewTasks, CurrentThread);
+	}
+	FORCEINLINE void ExecuteTaskInner(TArray<FBaseGraphTask*>& NewTasks, ENamedThreads::Type CurrentThread)
+#else
+	virtual void ExecuteTask(TArray<FBaseGraphTask*>& NewTasks, ENamedThreads::Type CurrentThread) final override
+#endif
+	{
+		uint32 TraceTaskId = 0;
+#if TASKGRAPH_TRACE
+		TraceTaskId = GetTraceTaskId();
+		if (TraceTaskId)
+		{
+			FTaskGraphTrace::TaskStarted(TraceTaskId, nullptr);
+		}
+#endif
+		QueueTasks(Tasks, NumTasks, DesiredThread, CurrentThread);
+#if TASKGRAPH_TRACE
+		if (TraceTaskId)
+		{
+			FTaskGraphTrace::TaskFinished(TraceTaskId);
+		}
+#endif
+		// the batch holds a reference of its own until here, so that the tasks cannot free it while they are being queued
+		Release(NewTasks, CurrentThread, TraceTaskId);
+	}
+
+	/**
+	*	Private constructor, creates the completion event.
+	*	@param InNumTasks the number of tasks that will be built in the batch.
+	*	@param NumberOfPrerequistitesOutstanding the number of prerequisites the batch will have when it is built.
+	**/
+	TGraphTaskBatch(int32 InNumTasks, int32 NumberOfPrerequistitesOutstanding)
+		: FBaseGraphTask(
+#if USE_VIRTUAL_BYPASS
+			&ExecuteTask,
+#endif
+			NumberOfPrerequistitesOutstanding)
+		, Subsequents(FGraphEvent::CreateGraphEvent())
+		, Tasks(nullptr)
+		, NumTasks(InNumTasks)
+		, NumOutstanding(InNumTasks + 1)
+		, DesiredThread(ENamedThreads::AnyThread)
+	{
+#if TASKGRAPH_TRACE
+		if (GetTraceTaskId())
+		{
+			Subsequents->SetTraceTaskId(GetTraceTaskId());
+		}
+#endif
+	}
+
+	/**
+	*	Adds the batch as a subsequent to each prerequisite and lets it queue once they are complete.
+	**/
+	void SetupPrereqs(const FGraphEventArray* Prerequisites, ENamedThreads::Type CurrentThreadIfKnown)
+	{
+		SetThreadToExecuteOn(DesiredThread);
+		int32 AlreadyCompletedPrerequisites = 0;
+		if (Prerequisites)
+		{
+			for (int32 Index = 0; Index < Prerequisites->Num(); Index++)
+			{
+				check((*Prerequisites)[Index]);
+#if TASKGRAPH_TRACE
+				if (GetTraceTaskId() && (*Prerequisites)[Index]->GetTraceTaskId())
+				{
+					FTaskGraphTrace::TaskDependency((*Prerequisites)[Index]->GetTraceTaskId(), GetTraceTaskId());
+				}
+#endif
+				if (!(*Prerequisites)[Index]->AddSubsequent(this))
+				{
+					AlreadyCompletedPrerequisites++;
+				}
+			}
+		}
+		PrerequisitesComplete(CurrentThreadIfKnown, AlreadyCompletedPrerequisites);
+	}
+
+	/**
+	*	Called once by each task and once by the batch when it has queued them. The last one dispatches the subsequents and frees the batch.
+	*	@param TraceTaskId; the trace id of the caller, which completes the event if it is the last one.
+	**/
+	void Release(TArray<FBaseGraphTask*>& NewTasks, ENamedThreads::Type CurrentThread, uint32 TraceTaskId)
+	{
+		if (NumOutstanding.Decrement() == 0)
+		{
+#if TASKGRAPH_TRACE
+			// subsequents were linked to the batch, which really completes with its last task
+			if (TraceTaskId && GetTraceTaskId() && TraceTaskId != GetTraceTaskId())
+			{
+				FTaskGraphTrace::TaskCompletedBy(GetTraceTaskId(), TraceTaskId);
+			}
+#endif
+			YPlatformMisc::MemoryBarrier();
+			Subsequents->DispatchSubsequents(NewTasks, CurrentThread);
+			this->TGraphTaskBatch::~TGraphTaskBatch();
+			YMemory::Free(this);
+		}
+	}
+
+	/** A reference counted pointer to the completion event of the whole batch. **/
+	FGraphEventRef				Subsequents;
+	/** The tasks of the batch, stored after them in the same allocation. **/
+	FBaseGraphTask**			Tasks;
+	/** The number of tasks in the batch. **/
+	int32						NumTasks;
+	/** Tasks that have not executed yet, plus one for the batch until it has queued them. **/
+	FThreadSafeCounter			NumOutstanding;
+	/** The thread the tasks execute on, from the first task. **/
+	ENamedThreads::Type			DesiredThread;
+};
+
+
 /**
 *	FReturnGraphTask is a task used to return flow control from a named thread back to the original caller of ProcessThreadUntilRequestReturn
 **/
@@ -0,0 +1,139 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	TaskGraphTrace.h: Recording of task graph tasks and critical path analysis
+=============================================================================*/
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Containers/Array.h"
+#include "Containers/SolidAngleString.h"
+
+/** If true, task graph tasks can record their timings and dependencies with FTaskGraphTrace */
+#ifndef TASKGRAPH_TRACE
+	#define TASKGRAPH_TRACE !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+#endif
+
+class YOutputDevice;
+
+/** A task read back from a trace, times are in microseconds from the start of the trace */
+struct FTaskGraphTraceTask
+{
+	uint32 Id;
+	uint32 ThreadId;
+	YString Name;
+	double QueuedTime;
+	double StartTime;
+	double EndTime;
+	/** Ids of the tasks that had to complete before this one could run */
+	TArray<uint32> Prerequisites;
+	/** Id of the gather task that completes the event of this one when it used DontCompleteUntil, 0 if none */
+	uint32 CompletedBy;
+
+	FTaskGraphTraceTask()
+		: Id(0)
+		, ThreadId(0)
+		, QueuedTime(0.0)
+		, StartTime(0.0)
+		, EndTime(0.0)
+		, CompletedBy(0)
+	{
+	}
+};
+
+/** A trace as written by FTaskGraphTrace::ExportChromeTrace */
+struct FTaskGraphTraceData
+{
+	TArray<FTaskGraphTraceTask> Tasks;
+	/** Thread ids and names, in the same order */
+	TArray<uint32> ThreadIds;
+	TArray<YString> ThreadNames;
+};
+
+/**
+* Records when task graph tasks are queued, start and end, on which thread and which tasks they waited for.
+* Tracing is compiled in with TASKGRAPH_TRACE and is off until Start is called; when off, creating a task only reads
+* a flag. Each thread records into its own ring buffer, so only the most recent events of each thread are kept.
+* Only the tasks created while tracing are recorded.
+*/
+class CORE_API FTaskGraphTrace
+{
+public:
+	/** Event kinds stored in the ring buffers */
+	enum class EEventType : uint8
+	{
+		Queued,
+		Started,
+		Finished,
+		Dependency,
+		CompletedBy,
+	};
+
+	/** @return true if tasks created now are traced */
+	static FORCEINLINE bool IsEnabled()
+	{
+		return bEnabled;
+	}
+
+	/**
+	* Clears the buffers and starts recording.
+	* @param EventsPerThread Size of the ring buffer of each thread, rounded up to a power of two
+	*/
+	static void Start(int32 EventsPerThread = 64 * 1024);
+
+	/** Stops recording. Tasks already created keep recording until they are done, so export once they are. */
+	static void Stop();
+
+	/** Gathers the recorded tasks that both started and finished in the buffers */
+	static void GetTraceData(FTaskGraphTraceData& OutData);
+
+	/**
+	* Writes the recorded tasks as a Chrome trace (chrome://tracing or Perfetto), one complete event per task.
+	* The arguments of each event hold the task id, the time it was queued and its prerequisites.
+	* @return true if the file was written
+	*/
+	static bool ExportChromeTrace(const TCHAR* Filename);
+
+	/**
+	* Reads a trace written by ExportChromeTrace, to analyze it offline.
+	* @return true if the file could be read and had tasks in it
+	*/
+	static bool ImportChromeTrace(const TCHAR* Filename, FTaskGraphTraceData& OutData);
+
+	/**
+	* Logs the critical path of a trace and the utilization of its threads. The critical path is walked back from the
+	* task that finished last, going at each step to the prerequisite that finished last, which is the one that held
+	* the task back. A prerequisite that used DontCompleteUntil finishes when its gather task does.
+	* @param MaxPathTasks How many tasks of the critical path to list, the longest ones first
+	*/
+	static void Analyze(const FTaskGraphTraceData& Data, YOutputDevice& Ar, int32 MaxPathTasks = 20);
+
+	/** Hooks called by the task graph, only when a task has a trace id */
+	static uint32 NewTaskId();
+	static void TaskQueued(uint32 TaskId)
+	{
+		RecordEvent(EEventType::Queued, TaskId, 0, nullptr);
+	}
+	static void TaskStarted(uint32 TaskId, const void* StatId)
+	{
+		RecordEvent(EEventType::Started, TaskId, 0, StatId);
+	}
+	static void TaskFinished(uint32 TaskId)
+	{
+		RecordEvent(EEventType::Finished, TaskId, 0, nullptr);
+	}
+	static void TaskDependency(uint32 PrerequisiteTaskId, uint32 TaskId)
+	{
+		RecordEvent(EEventType::Dependency, TaskId, PrerequisiteTaskId, nullptr);
+	}
+	static void TaskCompletedBy(uint32 TaskId, uint32 GatherTaskId)
+	{
+		RecordEvent(EEventType::CompletedBy, TaskId, GatherTaskId, nullptr);
+	}
+
+private:
+	static void RecordEvent(EEventType Type, uint32 TaskId, uint32 OtherTaskId, const void* StatId);
+
+	static bool bEnabled;
+};
@@ -14,6 +14,8 @@
 #include "Templates/Less.h"
 #include "Templates/Sorting.h"
 
+class UClass;
+
 #define DEBUG_HEAP 0
 
 #if UE_BUILD_SHIPPING || UE_BUILD_TEST
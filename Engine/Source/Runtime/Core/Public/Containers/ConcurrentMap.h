@@ -0,0 +1,591 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Misc/AssertionMacros.h"
+#include "HAL/PlatformAtomics.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformMath.h"
+#include "HAL/SolidAngleMemory.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeLock.h"
+#include "Templates/SolidAngleTemplate.h"
+#include "Templates/Function.h"
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+
+namespace UE4ConcurrentMap_Private
+{
+	/**
+	* Epoch based reclamation, shared by all concurrent maps.
+	*
+	* A reading thread publishes the global epoch it saw when it starts reading and clears it when it is done. The
+	* global epoch only advances when every reading thread has seen the current one, so anything unlinked before the
+	* epoch was E is unreachable by every reader once the epoch reaches E + 2 and can be freed then.
+	*/
+	struct FEpochRecord;
+
+	/** Pins the current epoch for the calling thread, reads can nest. @return the thread's record, to pass to LeaveEpoch */
+	CORE_API FEpochRecord* EnterEpoch();
+
+	/** Ends a read started by EnterEpoch. */
+	CORE_API void LeaveEpoch(FEpochRecord* Record);
+
+	/** @return the global epoch, read after everything the calling thread wrote before. */
+	CORE_API int64 GetEpoch();
+
+	/** Advances the global epoch if no reader is behind it. @return the global epoch. */
+	CORE_API int64 TryAdvanceEpoch();
+
+	/** Memory that was unlinked while readers may still be using it, freed by Deleter once its epoch is old enough. */
+	struct FRetired
+	{
+		void* Ptr;
+		void (*Deleter)(void*);
+		int64 Epoch;
+	};
+
+	/** Spreads the bits of a KeyFuncs hash over the whole word, the low bits pick the shard and the others the bucket. */
+	static FORCEINLINE uint32 MixHash(uint32 Hash)
+	{
+		Hash ^= Hash >> 16;
+		Hash *= 0x85ebca6b;
+		Hash ^= Hash >> 13;
+		Hash *= 0xc2b2ae35;
+		Hash ^= Hash >> 16;
+		return Hash;
+	}
+}
+
+/**
+* Pins the epoch of the concurrent maps for the calling thread while in scope.
+*
+* Every lookup pins the epoch by itself, which takes a memory barrier, and that keeps back-to-back lookups from
+* overlapping their cache misses. A thread making many lookups in a row can hold one of these around them so that
+* the lookups nest in it for free. Nothing unlinked from any map meanwhile is freed until the scope ends, so do not
+* hold it for long.
+*/
+class FConcurrentMapReadScope : public FNoncopyable
+{
+public:
+	FORCEINLINE FConcurrentMapReadScope()
+		: Record(UE4ConcurrentMap_Private::EnterEpoch())
+	{
+	}
+	FORCEINLINE ~FConcurrentMapReadScope()
+	{
+		UE4ConcurrentMap_Private::LeaveEpoch(Record);
+	}
+
+private:
+	UE4ConcurrentMap_Private::FEpochRecord* Record;
+};
+
+/**
+* A hash map from keys to values that any number of threads can read and write at the same time, for shared
+* lookup tables that are read far more often than they change.
+*
+* The map is split into shards by key hash. Each shard is a table of buckets holding linked lists of nodes. Reads
+* take no lock and write nothing shared: they walk the lists of the current table, and are wait-free, except for
+* the first read of each thread, which takes a record to publish its epoch in and may allocate it. Writes lock
+* their shard only. They never change a node that readers may see, so an update links in a new node in place of the
+* old one, and a resize copies the nodes to a new table. Unlinked nodes and tables are freed by epoch based
+* reclamation, once no reader can still be walking them.
+*
+* Since values may be replaced or removed by another thread at any time, lookups return copies of values and
+* never pointers into the map. Keys and values must be copyable. KeyFuncs are the same as for TMap, without
+* duplicate keys.
+*/
+template<
+	typename KeyType,
+	typename ValueType,
+	typename KeyFuncs = TDefaultMapKeyFuncs<KeyType, ValueType, false>
+>
+class TConcurrentMap : public FNoncopyable
+{
+	static_assert(!KeyFuncs::bAllowDuplicateKeys, "TConcurrentMap does not support duplicate keys");
+
+	typedef typename KeyFuncs::KeyInitType KeyInitType;
+	typedef TPair<KeyType, ValueType> ElementType;
+
+public:
+
+	/**
+	* Creates an empty map.
+	*
+	* @param NumShards The number of independently locked parts of the map (will be rounded up to the next power of 2).
+	*					More shards let more threads write at once.
+	*/
+	explicit TConcurrentMap(uint32 NumShards = 64)
+	{
+		checkf(NumShards > 0 && NumShards <= 4096, TEXT("Invalid TConcurrentMap shard count %u"), NumShards);
+
+		NumShards = YPlatformMath::RoundUpToPowerOfTwo(NumShards);
+		ShardBits = YPlatformMath::FloorLog2(NumShards);
+		NextShardToSweep = 0;
+		Shards = (FShard*)YMemory::Malloc(NumShards * sizeof(FShard), PLATFORM_CACHE_LINE_SIZE);
+		for (uint32 Index = 0; Index < NumShards; ++Index)
+		{
+			new(Shards + Index) FShard();
+		}
+	}
+
+	/** Destructor. No other thread may use the map anymore. */
+	~TConcurrentMap()
+	{
+		for (uint32 Index = 0, NumShards = 1u << ShardBits; Index < NumShards; ++Index)
+		{
+			FShard& Shard = Shards[Index];
+			DeleteTable(Shard.Table);
+			for (const UE4ConcurrentMap_Private::FRetired& Retired : Shard.Retired)
+			{
+				Retired.Deleter(Retired.Ptr);
+			}
+			Shard.~FShard();
+		}
+		YMemory::Free(Shards);
+	}
+
+	/**
+	* Copies the value associated with a key. Wait-free once the calling thread has read any concurrent map before.
+	*
+	* @param Key The key to search for.
+	* @param OutValue Receives a copy of the value, if the key is in the map.
+	* @return true if the key was found.
+	*/
+	FORCEINLINE bool Find(KeyInitType Key, ValueType& OutValue) const
+	{
+		return FindByHash(KeyFuncs::GetKeyHash(Key), Key, OutValue);
+	}
+
+	/**
+	* Copies the value associated with a key, without computing the hash of the key and without converting it to KeyType.
+	*
+	* @param KeyHash The hash of the key, as KeyFuncs::GetKeyHash returns it for a matching key.
+	* @param Key The key to search for, KeyFuncs::Matches must compare it to a KeyType.
+	* @param OutValue Receives a copy of the value, if the key is in the map.
+	* @return true if the key was found.
+	*/
+	template<typename ComparableKey>
+	bool FindByHash(uint32 KeyHash, const ComparableKey& Key, ValueType& OutValue) const
+	{
+		const uint32 Hash = UE4ConcurrentMap_Private::MixHash(KeyHash);
+		FConcurrentMapReadScope ReadScope;
+
+		if (const FNode* Node = FindNode(GetShard(Hash).Table, Hash, Key))
+		{
+			OutValue = Node->Pair.Value;
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	* @return A copy of the value associated with a key, or the default value for ValueType if the key isn't in the map.
+	*/
+	FORCEINLINE ValueType FindRef(KeyInitType Key) const
+	{
+		ValueType Value = ValueType();
+		Find(Key, Value);
+		return Value;
+	}
+
+	/** @return true if the map contains the key. */
+	bool Contains(KeyInitType Key) const
+	{
+		const uint32 Hash = UE4ConcurrentMap_Private::MixHash(KeyFuncs::GetKeyHash(Key));
+		FConcurrentMapReadScope ReadScope;
+
+		return FindNode(GetShard(Hash).Table, Hash, Key) != nullptr;
+	}
+
+	/**
+	* Returns the value associated with a key, adding the key with a default constructed value if it is not in the map.
+	* When several threads add the same key at once, they all get the value of the one that won.
+	*/
+	FORCEINLINE ValueType FindOrAdd(KeyInitType Key)
+	{
+		return FindOrAddBy(Key, []() { return ValueType(); });
+	}
+
+	/**
+	* Returns the value associated with a key, adding the key with the given value if it is not in the map.
+	* When several threads add the same key at once, they all get the value of the one that won.
+	*/
+	FORCEINLINE ValueType FindOrAdd(KeyInitType Key, const ValueType& Value)
+	{
+		return FindOrAddBy(Key, [&Value]() { return Value; });
+	}
+
+	/**
+	* Returns the value associated with a key, adding the key with the value made by MakeValue if it is not in the map.
+	* MakeValue is only called when the key is missing, once, with the shard locked, so it must not use the map.
+	*/
+	ValueType FindOrAddBy(KeyInitType Key, TFunctionRef<ValueType()> MakeValue)
+	{
+		const uint32 Hash = UE4ConcurrentMap_Private::MixHash(KeyFuncs::GetKeyHash(Key));
+		FShard& Shard = GetShard(Hash);
+		{
+			FConcurrentMapReadScope ReadScope;
+			if (const FNode* Node = FindNode(Shard.Table, Hash, Key))
+			{
+				return Node->Pair.Value;
+			}
+		}
+
+		FScopeLock Lock(&Shard.Lock);
+
+		// another thread may have added it since
+		if (const FNode* Node = FindNode(Shard.Table, Hash, Key))
+		{
+			return Node->Pair.Value;
+		}
+
+		FNode* NewNode = new FNode(Hash, TPairInitializer<KeyInitType, ValueType&&>(Key, MakeValue()));
+		LinkNode(Shard, NewNode);
+		return NewNode->Pair.Value;
+	}
+
+	/**
+	* Sets the value associated with a key, replacing the value it had if any.
+	*
+	* @param InKey The key to associate the value with.
+	* @param InValue The value to associate with the key.
+	*/
+	void Add(KeyInitType InKey, const ValueType& InValue)
+	{
+		const uint32 Hash = UE4ConcurrentMap_Private::MixHash(KeyFuncs::GetKeyHash(InKey));
+		FShard& Shard = GetShard(Hash);
+		FNode* NewNode = new FNode(Hash, TPairInitializer<KeyInitType, const ValueType&>(InKey, InValue));
+
+		FScopeLock Lock(&Shard.Lock);
+
+		FNode* volatile* Link = FindLink(Shard.Table, Hash, InKey);
+		if (FNode* OldNode = *Link)
+		{
+			NewNode->Next = OldNode->Next;
+			YPlatformMisc::MemoryBarrier();
+			*Link = NewNode;
+			RetireNode(Shard, OldNode);
+		}
+		else
+		{
+			LinkNode(Shard, NewNode);
+		}
+	}
+
+	/**
+	* Removes a key and its value from the map.
+	*
+	* @param Key The key to remove.
+	* @return true if the key was in the map.
+	*/
+	FORCEINLINE bool Remove(KeyInitType Key)
+	{
+		return RemoveImpl(Key, nullptr);
+	}
+
+	/**
+	* Removes a key from the map and copies the value it had.
+	*
+	* @param Key The key to remove.
+	* @param OutRemovedValue Receives the removed value (not modified if the key was not found).
+	* @return true if the key was in the map.
+	*/
+	FORCEINLINE bool RemoveAndCopyValue(KeyInitType Key, ValueType& OutRemovedValue)
+	{
+		return RemoveImpl(Key, &OutRemovedValue);
+	}
+
+	/** Removes all keys from the map. Readers see the shards emptied one by one. */
+	void Empty()
+	{
+		for (uint32 Index = 0, NumShards = 1u << ShardBits; Index < NumShards; ++Index)
+		{
+			FShard& Shard = Shards[Index];
+			FScopeLock Lock(&Shard.Lock);
+
+			if (Shard.NumElements)
+			{
+				FTable* OldTable = Shard.Table;
+				Shard.Table = AllocateTable(FShard::MinBuckets);
+				Shard.NumElements = 0;
+				Retire(Shard, OldTable, &DeleteTable);
+			}
+		}
+	}
+
+	/**
+	* Gets the number of keys in the map.
+	*
+	* CAUTION: other threads can change the map at any time, so the result is only a hint.
+	*/
+	int32 Num() const
+	{
+		int32 Result = 0;
+		for (uint32 Index = 0, NumShards = 1u << ShardBits; Index < NumShards; ++Index)
+		{
+			Result += Shards[Index].NumElements;
+		}
+		return Result;
+	}
+
+	/**
+	* Calls Visitor for each pair in the map. Each shard is walked as it is when the walk reaches it; pairs added or
+	* removed meanwhile may or may not be visited. Visitor is called within a read and must not write to the map.
+	*/
+	void ForEach(TFunctionRef<void(const KeyType&, const ValueType&)> Visitor) const
+	{
+		FConcurrentMapReadScope ReadScope;
+
+		for (uint32 Index = 0, NumShards = 1u << ShardBits; Index < NumShards; ++Index)
+		{
+			const FTable* Table = Shards[Index].Table;
+			for (uint32 Bucket = 0; Bucket <= Table->IndexMask; ++Bucket)
+			{
+				for (const FNode* Node = Table->Buckets[Bucket]; Node; Node = Node->Next)
+				{
+					Visitor(Node->Pair.Key, Node->Pair.Value);
+				}
+			}
+		}
+	}
+
+private:
+
+	/** A key-value pair, never modified once readers can reach it. */
+	struct FNode
+	{
+		template<typename InitializerType>
+		FNode(uint32 InHash, InitializerType&& Initializer)
+			: Next(nullptr)
+			, Hash(InHash)
+			, Pair(Forward<InitializerType>(Initializer))
+		{
+		}
+
+		FNode* volatile Next;
+		uint32 Hash;
+		ElementType Pair;
+	};
+
+	/** The buckets of a shard, allocated with as many bucket heads as needed after the struct. */
+	struct FTable
+	{
+		uint32 IndexMask;
+		FNode* volatile Buckets[1];
+	};
+
+	/** A part of the map that is written under its own lock. */
+	MS_ALIGN(PLATFORM_CACHE_LINE_SIZE) struct FShard
+	{
+		enum { MinBuckets = 8 };
+		enum { MinRetiredToFree = 16 };
+
+		FShard()
+			: Table(AllocateTable(MinBuckets))
+			, NumElements(0)
+		{
+		}
+
+		/** Holds the current table, replaced under Lock when the shard grows. */
+		FTable* volatile Table;
+
+		/** Holds the number of keys in the shard, written under Lock. */
+		volatile int32 NumElements;
+
+		/** Serializes writes to the shard. */
+		FCriticalSection Lock;
+
+		/** Holds the nodes and tables unlinked from the shard that readers may still see, written under Lock. */
+		TArray<UE4ConcurrentMap_Private::FRetired> Retired;
+	} GCC_ALIGN(PLATFORM_CACHE_LINE_SIZE);
+
+	FORCEINLINE FShard& GetShard(uint32 Hash) const
+	{
+		return Shards[Hash & ((1u << ShardBits) - 1)];
+	}
+
+	FORCEINLINE uint32 GetBucket(const FTable* Table, uint32 Hash) const
+	{
+		return (Hash >> ShardBits) & Table->IndexMask;
+	}
+
+	template<typename ComparableKey>
+	FORCEINLINE const FNode* FindNode(const FTable* Table, uint32 Hash, const ComparableKey& Key) const
+	{
+		for (const FNode* Node = Table->Buckets[GetBucket(Table, Hash)]; Node; Node = Node->Next)
+		{
+			if (Node->Hash == Hash && KeyFuncs::Matches(KeyFuncs::GetSetKey(Node->Pair), Key))
+			{
+				return Node;
+			}
+		}
+		return nullptr;
+	}
+
+	/** @return The link that points to the node with the key, or the null link at the end of its bucket. Called under the shard lock. */
+	FNode* volatile* FindLink(FTable* Table, uint32 Hash, KeyInitType Key) const
+	{
+		FNode* volatile* Link = &Table->Buckets[GetBucket(Table, Hash)];
+		for (; *Link; Link = &(*Link)->Next)
+		{
+			if ((*Link)->Hash == Hash && KeyFuncs::Matches(KeyFuncs::GetSetKey((*Link)->Pair), Key))
+			{
+				break;
+			}
+		}
+		return Link;
+	}
+
+	/** Publishes a node whose key is not in the shard, growing the shard first if it is full. Called under the shard lock. */
+	void LinkNode(FShard& Shard, FNode* NewNode)
+	{
+		if (uint32(Shard.NumElements) > Shard.Table->IndexMask)
+		{
+			Grow(Shard);
+		}
+
+		FTable* Table = Shard.Table;
+		FNode* volatile* Head = &Table->Buckets[GetBucket(Table, NewNode->Hash)];
+		NewNode->Next = *Head;
+		YPlatformMisc::MemoryBarrier();
+		*Head = NewNode;
+		Shard.NumElements = Shard.NumElements + 1;
+	}
+
+	bool RemoveImpl(KeyInitType Key, ValueType* OutRemovedValue)
+	{
+		const uint32 Hash = UE4ConcurrentMap_Private::MixHash(KeyFuncs::GetKeyHash(Key));
+		FShard& Shard = GetShard(Hash);
+
+		FScopeLock Lock(&Shard.Lock);
+
+		FNode* volatile* Link = FindLink(Shard.Table, Hash, Key);
+		FNode* OldNode = *Link;
+		if (!OldNode)
+		{
+			return false;
+		}
+
+		if (OutRemovedValue)
+		{
+			*OutRemovedValue = OldNode->Pair.Value;
+		}
+		*Link = OldNode->Next;
+		Shard.NumElements = Shard.NumElements - 1;
+		RetireNode(Shard, OldNode);
+		return true;
+	}
+
+	/** Doubles the buckets of a shard. Readers may be walking the old table, so the nodes are copied rather than relinked. */
+	void Grow(FShard& Shard)
+	{
+		FTable* OldTable = Shard.Table;
+		FTable* NewTable = AllocateTable((OldTable->IndexMask + 1) * 2);
+
+		for (uint32 Bucket = 0; Bucket <= OldTable->IndexMask; ++Bucket)
+		{
+			for (const FNode* Node = OldTable->Buckets[Bucket]; Node; Node = Node->Next)
+			{
+				FNode* NewNode = new FNode(Node->Hash, Node->Pair);
+				FNode* volatile* Head = &NewTable->Buckets[GetBucket(NewTable, Node->Hash)];
+				NewNode->Next = *Head;
+				*Head = NewNode;
+			}
+		}
+
+		YPlatformMisc::MemoryBarrier();
+		Shard.Table = NewTable;
+		Retire(Shard, OldTable, &DeleteTable);
+	}
+
+	void RetireNode(FShard& Shard, FNode* Node)
+	{
+		Retire(Shard, Node, &DeleteNode);
+	}
+
+	/**
+	* Queues memory that was just unlinked and frees what was queued long enough ago. Called under the shard lock.
+	* Advancing the epoch writes to a cache line that every reader reads, so it is only tried once a few are queued.
+	* A shard that is rarely written would then keep its last few for ever, so each reclamation also sweeps another
+	* shard, in turn, unless that one is busy.
+	*/
+	void Retire(FShard& Shard, void* Ptr, void (*Deleter)(void*))
+	{
+		UE4ConcurrentMap_Private::FRetired& Retired = Shard.Retired[Shard.Retired.AddUninitialized()];
+		Retired.Ptr = Ptr;
+		Retired.Deleter = Deleter;
+		Retired.Epoch = UE4ConcurrentMap_Private::GetEpoch();
+
+		if (Shard.Retired.Num() < FShard::MinRetiredToFree)
+		{
+			return;
+		}
+
+		const int64 Epoch = UE4ConcurrentMap_Private::TryAdvanceEpoch();
+		FreeRetired(Shard, Epoch);
+
+		FShard& Other = Shards[FPlatformAtomics::InterlockedIncrement(&NextShardToSweep) & ((1u << ShardBits) - 1)];
+		if (&Other != &Shard && Other.Lock.TryLock())
+		{
+			FreeRetired(Other, Epoch);
+			Other.Lock.Unlock();
+		}
+	}
+
+	/** Frees what the shard retired before Epoch - 1. Called under the shard lock. */
+	static void FreeRetired(FShard& Shard, int64 Epoch)
+	{
+		// the queue is in epoch order
+		int32 NumFreed = 0;
+		while (NumFreed < Shard.Retired.Num() && Shard.Retired[NumFreed].Epoch + 2 <= Epoch)
+		{
+			Shard.Retired[NumFreed].Deleter(Shard.Retired[NumFreed].Ptr);
+			++NumFreed;
+		}
+		if (NumFreed)
+		{
+			Shard.Retired.RemoveAt(0, NumFreed, false);
+		}
+	}
+
+	static FTable* AllocateTable(uint32 NumBuckets)
+	{
+		FTable* Table = (FTable*)YMemory::Malloc(sizeof(FTable) + (NumBuckets - 1) * sizeof(FNode*));
+		Table->IndexMask = NumBuckets - 1;
+		YMemory::Memzero((void*)Table->Buckets, NumBuckets * sizeof(FNode*));
+		return Table;
+	}
+
+	static void DeleteNode(void* Node)
+	{
+		delete (FNode*)Node;
+	}
+
+	/** Frees a table and the nodes linked from it. */
+	static void DeleteTable(void* Ptr)
+	{
+		FTable* Table = (FTable*)Ptr;
+		for (uint32 Bucket = 0; Bucket <= Table->IndexMask; ++Bucket)
+		{
+			for (FNode* Node = Table->Buckets[Bucket]; Node; )
+			{
+				FNode* Next = Node->Next;
+				delete Node;
+				Node = Next;
+			}
+		}
+		YMemory::Free(Table);
+	}
+
+	/** Holds the shards, allocated once at construction. */
+	FShard* Shards;
+
+	/** Holds the log2 of the number of shards. */
+	uint32 ShardBits;
+
+	/** Holds the shard to sweep after the next reclamation, see Retire. */
+	volatile int32 NextShardToSweep;
+};
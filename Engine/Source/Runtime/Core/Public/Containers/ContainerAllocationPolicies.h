@@ -383,7 +383,22 @@ public:
 			if (Data || NumElements)
 			{
 				//checkSlow(((uint64)NumElements*(uint64)ElementTypeInfo.GetSize() < (uint64)INT_MAX));
-				Data = (FScriptContainerElement*)YMemory::Realloc(Data, NumElements*NumBytesPerElement);
+				const SIZE_T NewBytes = NumElements*NumBytesPerElement;
+				if (Data && NumElements)
+				{
+					// Realloc copies the whole old block even when only a few elements or none of them are live
+					if (YMemory::TryReallocInPlace(Data, NewBytes))
+					{
+						return;
+					}
+					if (!PreviousNumElements)
+					{
+						YMemory::Free(Data);
+						Data = (FScriptContainerElement*)YMemory::Malloc(NewBytes);
+						return;
+					}
+				}
+				Data = (FScriptContainerElement*)YMemory::Realloc(Data, NewBytes);
 			}
 		}
 		FORCEINLINE int32 CalculateSlackReserve(int32 NumElements, int32 NumBytesPerElement) const
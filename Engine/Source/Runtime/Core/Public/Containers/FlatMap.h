@@ -0,0 +1,433 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Misc/AssertionMacros.h"
+#include "Templates/SolidAngleTemplate.h"
+#include "Containers/Map.h"
+#include "Containers/FlatSet.h"
+
+/**
+* A map from keys to values, implemented as a TFlatSet of key-value pairs with the KeyFuncs of TMap. It has the
+* interface of TMap for adding, finding and removing pairs, and is faster to search; see TFlatSet for how it works
+* and what it requires. Pointers and references to values are valid until the map is resized.
+*/
+template<
+	typename KeyType,
+	typename ValueType,
+	typename Allocator = FDefaultAllocator,
+	typename KeyFuncs = TDefaultMapKeyFuncs<KeyType, ValueType, false>
+>
+class TFlatMap
+{
+public:
+	typedef typename TTypeTraits<KeyType  >::ConstPointerType KeyConstPointerType;
+	typedef typename TTypeTraits<KeyType  >::ConstInitType    KeyInitType;
+	typedef typename TTypeTraits<ValueType>::ConstInitType    ValueInitType;
+	typedef TPair<KeyType, ValueType> ElementType;
+
+	FORCEINLINE TFlatMap() {}
+	FORCEINLINE TFlatMap(TFlatMap&& Other) : Pairs(MoveTemp(Other.Pairs)) {}
+	FORCEINLINE TFlatMap(const TFlatMap&  Other) : Pairs(Other.Pairs) {}
+	FORCEINLINE TFlatMap& operator=(TFlatMap&& Other) { Pairs = MoveTemp(Other.Pairs); return *this; }
+	FORCEINLINE TFlatMap& operator=(const TFlatMap&  Other) { Pairs = Other.Pairs; return *this; }
+
+	/**
+	* Removes all elements from the map, potentially leaving space allocated for an expected number of elements about to be added.
+	* @param ExpectedNumElements - The number of elements about to be added to the map.
+	*/
+	FORCEINLINE void Empty(int32 ExpectedNumElements = 0)
+	{
+		Pairs.Empty(ExpectedNumElements);
+	}
+
+	/** Efficiently empties out the map but preserves all allocations and capacities */
+	FORCEINLINE void Reset()
+	{
+		Pairs.Reset();
+	}
+
+	/** Shrinks the map to the smallest size that holds its pairs. */
+	FORCEINLINE void Shrink()
+	{
+		Pairs.Shrink();
+	}
+
+	/** Preallocates enough memory to contain Number pairs without growing */
+	FORCEINLINE void Reserve(int32 Number)
+	{
+		Pairs.Reserve(Number);
+	}
+
+	/** @return The number of elements in the map. */
+	FORCEINLINE int32 Num() const
+	{
+		return Pairs.Num();
+	}
+
+	/**
+	* Helper function to return the amount of memory allocated by this container
+	* @return number of bytes allocated by this container
+	*/
+	FORCEINLINE uint32 GetAllocatedSize() const
+	{
+		return Pairs.GetAllocatedSize();
+	}
+
+	/**
+	* Sets the value associated with a key.
+	*
+	* @param InKey - The key to associate the value with.
+	* @param InValue - The value to associate with the key.
+	* @return A reference to the value as stored in the map.  The reference is only valid until the map is resized.
+	*/
+	FORCEINLINE ValueType& Add(const KeyType&  InKey, const ValueType&  InValue) { return Emplace(InKey, InValue); }
+	FORCEINLINE ValueType& Add(const KeyType&  InKey, ValueType&& InValue) { return Emplace(InKey, MoveTemp(InValue)); }
+	FORCEINLINE ValueType& Add(KeyType&& InKey, const ValueType&  InValue) { return Emplace(MoveTemp(InKey), InValue); }
+	FORCEINLINE ValueType& Add(KeyType&& InKey, ValueType&& InValue) { return Emplace(MoveTemp(InKey), MoveTemp(InValue)); }
+
+	/**
+	* Sets a default value associated with a key.
+	*
+	* @param InKey - The key to associate the value with.
+	* @return A reference to the value as stored in the map.  The reference is only valid until the map is resized.
+	*/
+	FORCEINLINE ValueType& Add(const KeyType&  InKey) { return Emplace(InKey); }
+	FORCEINLINE ValueType& Add(KeyType&& InKey) { return Emplace(MoveTemp(InKey)); }
+
+	/** Sets the value associated with a key. */
+	template <typename InitKeyType, typename InitValueType>
+	ValueType& Emplace(InitKeyType&& InKey, InitValueType&& InValue)
+	{
+		return Pairs.Emplace(TPairInitializer<InitKeyType&&, InitValueType&&>(Forward<InitKeyType>(InKey), Forward<InitValueType>(InValue)))->Value;
+	}
+
+	/** Sets a default value associated with a key. */
+	template <typename InitKeyType>
+	ValueType& Emplace(InitKeyType&& InKey)
+	{
+		return Pairs.Emplace(TKeyInitializer<InitKeyType&&>(Forward<InitKeyType>(InKey)))->Value;
+	}
+
+	/** Sets the value associated with a key, with the hash of the key already known. */
+	template <typename InitKeyType, typename InitValueType>
+	ValueType& EmplaceByHash(uint32 KeyHash, InitKeyType&& InKey, InitValueType&& InValue)
+	{
+		return Pairs.EmplaceByHash(KeyHash, TPairInitializer<InitKeyType&&, InitValueType&&>(Forward<InitKeyType>(InKey), Forward<InitValueType>(InValue)))->Value;
+	}
+
+	/**
+	* Removes all value associations for a key.
+	* @param InKey - The key to remove associated values for.
+	* @return The number of values that were associated with the key.
+	*/
+	FORCEINLINE int32 Remove(KeyConstPointerType InKey)
+	{
+		return Pairs.Remove(InKey);
+	}
+
+	/** Same as Remove, with the hash of the key already known. See TFlatSet::FindByHash. */
+	template<typename ComparableKey>
+	FORCEINLINE int32 RemoveByHash(uint32 KeyHash, const ComparableKey& Key)
+	{
+		return Pairs.RemoveByHash(KeyHash, Key);
+	}
+
+	/**
+	* Returns the value associated with a specified key.
+	* @param	Key - The key to search for.
+	* @return	A pointer to the value associated with the specified key, or nullptr if the key isn't contained in this map.  The pointer
+	*			is only valid until the map is resized.
+	*/
+	FORCEINLINE ValueType* Find(KeyConstPointerType Key)
+	{
+		if (ElementType* Pair = Pairs.Find(Key))
+		{
+			return &Pair->Value;
+		}
+
+		return nullptr;
+	}
+	FORCEINLINE const ValueType* Find(KeyConstPointerType Key) const
+	{
+		return const_cast<TFlatMap*>(this)->Find(Key);
+	}
+
+	/**
+	* Returns the value associated with a key, without computing the hash of the key and without converting it to KeyType.
+	* @param	KeyHash - The hash of the key, as KeyFuncs::GetKeyHash returns it for a matching key.
+	* @param	Key - The key to search for.
+	* @return	A pointer to the value associated with the key, or nullptr.
+	*/
+	template<typename ComparableKey>
+	FORCEINLINE ValueType* FindByHash(uint32 KeyHash, const ComparableKey& Key)
+	{
+		if (ElementType* Pair = Pairs.FindByHash(KeyHash, Key))
+		{
+			return &Pair->Value;
+		}
+
+		return nullptr;
+	}
+	template<typename ComparableKey>
+	FORCEINLINE const ValueType* FindByHash(uint32 KeyHash, const ComparableKey& Key) const
+	{
+		return const_cast<TFlatMap*>(this)->FindByHash(KeyHash, Key);
+	}
+
+	/**
+	* Returns the value associated with a specified key, or if none exists,
+	* adds a value using the default constructor.
+	* @param	Key - The key to search for.
+	* @return	A reference to the value associated with the specified key.
+	*/
+	FORCEINLINE ValueType& FindOrAdd(const KeyType&  Key) { return FindOrAddImpl(Key); }
+	FORCEINLINE ValueType& FindOrAdd(KeyType&& Key) { return FindOrAddImpl(MoveTemp(Key)); }
+
+	/**
+	* Returns a reference to the value associated with a specified key.
+	* @param	Key - The key to search for.
+	* @return	The value associated with the specified key, or triggers an assertion if the key does not exist.
+	*/
+	FORCEINLINE const ValueType& FindChecked(KeyConstPointerType Key) const
+	{
+		const ElementType* Pair = Pairs.Find(Key);
+		check(Pair != nullptr);
+		return Pair->Value;
+	}
+	FORCEINLINE ValueType& FindChecked(KeyConstPointerType Key)
+	{
+		ElementType* Pair = Pairs.Find(Key);
+		check(Pair != nullptr);
+		return Pair->Value;
+	}
+
+	/**
+	* Returns the value associated with a specified key.
+	* @param	Key - The key to search for.
+	* @return	The value associated with the specified key, or the default value for the ValueType if the key isn't contained in this map.
+	*/
+	FORCEINLINE ValueType FindRef(KeyConstPointerType Key) const
+	{
+		if (const ElementType* Pair = Pairs.Find(Key))
+		{
+			return Pair->Value;
+		}
+
+		return ValueType();
+	}
+
+	/**
+	* Checks if map contains the specified key.
+	* @param Key - The key to check for.
+	* @return true if the map contains the key.
+	*/
+	FORCEINLINE bool Contains(KeyConstPointerType Key) const
+	{
+		return Pairs.Contains(Key);
+	}
+
+	template<typename ComparableKey>
+	FORCEINLINE bool ContainsByHash(uint32 KeyHash, const ComparableKey& Key) const
+	{
+		return Pairs.ContainsByHash(KeyHash, Key);
+	}
+
+	/**
+	* Removes the pair with the specified key and copies the value that was removed to the ref parameter
+	* @param Key - the key to search for
+	* @param OutRemovedValue - if found, the value that was removed (not modified if the key was not found)
+	* @return whether or not the key was found
+	*/
+	bool RemoveAndCopyValue(KeyInitType Key, ValueType& OutRemovedValue)
+	{
+		if (ElementType* Pair = Pairs.Find(Key))
+		{
+			OutRemovedValue = MoveTemp(Pair->Value);
+			Pairs.Remove(Key);
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	* Finds a pair with the specified key, removes it from the map, and returns the value part of the pair.
+	* If no pair was found, an assertion is triggered.
+	* @param Key - the key to search for
+	* @return the value that was associated with the key
+	*/
+	ValueType FindAndRemoveChecked(KeyConstPointerType Key)
+	{
+		ElementType* Pair = Pairs.Find(Key);
+		check(Pair != nullptr);
+		ValueType Result = MoveTemp(Pair->Value);
+		Pairs.Remove(Key);
+		return Result;
+	}
+
+	/**
+	* Generates an array from the keys in this map.
+	*/
+	template<typename ArrayAllocator> void GenerateKeyArray(TArray<KeyType, ArrayAllocator>& OutArray) const
+	{
+		OutArray.Empty(Pairs.Num());
+		for (typename ElementSetType::TConstIterator PairIt(Pairs); PairIt; ++PairIt)
+		{
+			new(OutArray) KeyType(PairIt->Key);
+		}
+	}
+
+	/**
+	* Generates an array from the values in this map.
+	*/
+	template<typename ArrayAllocator> void GenerateValueArray(TArray<ValueType, ArrayAllocator>& OutArray) const
+	{
+		OutArray.Empty(Pairs.Num());
+		for (typename ElementSetType::TConstIterator PairIt(Pairs); PairIt; ++PairIt)
+		{
+			new(OutArray) ValueType(PairIt->Value);
+		}
+	}
+
+	FORCEINLINE       ValueType& operator[](KeyConstPointerType Key) { return FindChecked(Key); }
+	FORCEINLINE const ValueType& operator[](KeyConstPointerType Key) const { return FindChecked(Key); }
+
+	/** Serializer. */
+	FORCEINLINE friend YArchive& operator<<(YArchive& Ar, TFlatMap& Map)
+	{
+		return Ar << Map.Pairs;
+	}
+
+private:
+	typedef TFlatSet<ElementType, KeyFuncs, Allocator> ElementSetType;
+
+	template <typename ArgType>
+	FORCEINLINE ValueType& FindOrAddImpl(ArgType&& Arg)
+	{
+		if (ElementType* Pair = Pairs.Find(Arg))
+		{
+			return Pair->Value;
+		}
+
+		return Add(Forward<ArgType>(Arg));
+	}
+
+	/** The base of TFlatMap iterators. */
+	template<bool bConst>
+	class TBaseIterator
+	{
+	public:
+		typedef typename TChooseClass<bConst, typename ElementSetType::TConstIterator, typename ElementSetType::TIterator>::Result PairItType;
+	private:
+		typedef typename TChooseClass<bConst, const TFlatMap, TFlatMap>::Result MapType;
+		typedef typename TChooseClass<bConst, const KeyType, KeyType>::Result ItKeyType;
+		typedef typename TChooseClass<bConst, const ValueType, ValueType>::Result ItValueType;
+		typedef typename TChooseClass<bConst, const typename ElementSetType::ElementType, typename ElementSetType::ElementType>::Result PairType;
+
+	public:
+		FORCEINLINE TBaseIterator(const PairItType& InElementIt)
+			: PairIt(InElementIt)
+		{
+		}
+
+		/** Advances the iterator to the next element. */
+		FORCEINLINE TBaseIterator& operator++()
+		{
+			++PairIt;
+			return *this;
+		}
+
+		/** conversion to "bool" returning true if the iterator is valid. */
+		FORCEINLINE explicit operator bool() const
+		{
+			return !!PairIt;
+		}
+		/** inverse of the "bool" operator */
+		FORCEINLINE bool operator !() const
+		{
+			return !(bool)*this;
+		}
+
+		FORCEINLINE friend bool operator==(const TBaseIterator& Lhs, const TBaseIterator& Rhs) { return Lhs.PairIt == Rhs.PairIt; }
+		FORCEINLINE friend bool operator!=(const TBaseIterator& Lhs, const TBaseIterator& Rhs) { return Lhs.PairIt != Rhs.PairIt; }
+
+		// Accessors.
+		FORCEINLINE ItKeyType&   Key()   const { return PairIt->Key; }
+		FORCEINLINE ItValueType& Value() const { return PairIt->Value; }
+
+		FORCEINLINE PairType& operator* () const { return  *PairIt; }
+		FORCEINLINE PairType* operator->() const { return &*PairIt; }
+
+	protected:
+		PairItType PairIt;
+	};
+
+public:
+
+	/** Map iterator. */
+	class TIterator : public TBaseIterator<false>
+	{
+	public:
+		FORCEINLINE TIterator(TFlatMap& InMap)
+			: TBaseIterator<false>(InMap.Pairs.CreateIterator())
+		{
+		}
+
+		FORCEINLINE TIterator(const typename TBaseIterator<false>::PairItType& InPairIt)
+			: TBaseIterator<false>(InPairIt)
+		{
+		}
+
+		/** Removes the current pair from the map. The other pairs do not move, so iteration can go on. */
+		FORCEINLINE void RemoveCurrent()
+		{
+			this->PairIt.RemoveCurrent();
+		}
+	};
+
+	/** Const map iterator. */
+	class TConstIterator : public TBaseIterator<true>
+	{
+	public:
+		FORCEINLINE TConstIterator(const TFlatMap& InMap)
+			: TBaseIterator<true>(InMap.Pairs.CreateConstIterator())
+		{
+		}
+
+		FORCEINLINE TConstIterator(const typename TBaseIterator<true>::PairItType& InPairIt)
+			: TBaseIterator<true>(InPairIt)
+		{
+		}
+	};
+
+	/** Creates an iterator over all the pairs in this map */
+	FORCEINLINE TIterator CreateIterator()
+	{
+		return TIterator(*this);
+	}
+
+	/** Creates a const iterator over all the pairs in this map */
+	FORCEINLINE TConstIterator CreateConstIterator() const
+	{
+		return TConstIterator(*this);
+	}
+
+private:
+	/**
+	* DO NOT USE DIRECTLY
+	* STL-like iterators to enable range-based for loop support.
+	*/
+	FORCEINLINE friend TIterator      begin(TFlatMap& Map) { return TIterator(begin(Map.Pairs)); }
+	FORCEINLINE friend TConstIterator begin(const TFlatMap& Map) { return TConstIterator(begin(Map.Pairs)); }
+	FORCEINLINE friend TIterator      end(TFlatMap& Map) { return TIterator(end(Map.Pairs)); }
+	FORCEINLINE friend TConstIterator end(const TFlatMap& Map) { return TConstIterator(end(Map.Pairs)); }
+
+	ElementSetType Pairs;
+};
+
+template<typename KeyType, typename ValueType, typename Allocator, typename KeyFuncs>
+struct TContainerTraits<TFlatMap<KeyType, ValueType, Allocator, KeyFuncs> > : public TContainerTraitsBase<TFlatMap<KeyType, ValueType, Allocator, KeyFuncs> >
+{
+	enum { MoveWillEmptyContainer = TContainerTraits<TFlatSet<TPair<KeyType, ValueType>, KeyFuncs, Allocator> >::MoveWillEmptyContainer };
+};
@@ -0,0 +1,920 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Misc/AssertionMacros.h"
+#include "HAL/PlatformMath.h"
+#include "HAL/SolidAngleMemory.h"
+#include "Templates/SolidAngleTemplate.h"
+#include "Templates/SolidAngleTypeTraits.h"
+#include "Templates/TypeCompatibleBytes.h"
+#include "Templates/IsTriviallyDestructible.h"
+#include "Templates/AlignmentTemplates.h"
+#include "Templates/MemoryOps.h"
+#include "Containers/ContainerAllocationPolicies.h"
+#include "Containers/Array.h"
+#include "Containers/Set.h"
+#include <initializer_list>
+
+/** If true, the control bytes of TFlatSet are compared 16 at a time with SSE2, otherwise 8 at a time in a 64-bit integer */
+#ifndef FLATSET_SIMD_PROBING
+	#define FLATSET_SIMD_PROBING PLATFORM_ENABLE_VECTORINTRINSICS
+#endif
+
+#if FLATSET_SIMD_PROBING
+	#include <emmintrin.h>
+#endif
+
+namespace UE4FlatSet_Private
+{
+	/**
+	* Control byte of a free slot. A full slot stores the low 7 bits of its hash instead, so the sign bit tells full
+	* slots apart. Deleted slots keep probe sequences that went past them going, empty slots end them.
+	*/
+	enum : int8
+	{
+		CtrlEmpty = -128,
+		CtrlDeleted = -2,
+	};
+
+	/** Control bytes of a set without allocation, so that lookups need no special case for it */
+	extern CORE_API const int8 EmptyGroup[16];
+
+	/** Spreads the bits of a KeyFuncs hash over the whole word; GetTypeHash of integers and pointers is often the value itself. */
+	static FORCEINLINE uint32 MixHash(uint32 Hash)
+	{
+		Hash ^= Hash >> 16;
+		Hash *= 0x85ebca6b;
+		Hash ^= Hash >> 13;
+		Hash *= 0xc2b2ae35;
+		Hash ^= Hash >> 16;
+		return Hash;
+	}
+
+#if FLATSET_SIMD_PROBING
+	/** The control bytes of 16 consecutive slots. Matches are returned as one bit per slot. */
+	struct FGroup
+	{
+		enum { Width = 16 };
+		typedef uint32 FMask;
+
+		__m128i Ctrl;
+
+		explicit FORCEINLINE FGroup(const int8* Pos)
+			: Ctrl(_mm_loadu_si128((const __m128i*)Pos))
+		{
+		}
+
+		/** @return The slots whose control byte is H2. */
+		FORCEINLINE FMask Match(int8 H2) const
+		{
+			return (FMask)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(H2), Ctrl));
+		}
+
+		FORCEINLINE FMask MatchEmpty() const
+		{
+			return Match(CtrlEmpty);
+		}
+
+		/** @return The empty and deleted slots. */
+		FORCEINLINE FMask MatchFree() const
+		{
+			return (FMask)_mm_movemask_epi8(Ctrl);
+		}
+
+		FORCEINLINE FMask MatchFull() const
+		{
+			return MatchFree() ^ 0xFFFF;
+		}
+
+		/** @return The offset of the first slot in a non-empty mask. */
+		static FORCEINLINE uint32 LowestIndex(FMask Mask)
+		{
+			return YPlatformMath::CountTrailingZeros(Mask);
+		}
+
+		/** @return The number of slots at the end of the group that are not in a non-empty mask. */
+		static FORCEINLINE uint32 NumLeadingUnmatched(FMask Mask)
+		{
+			return YPlatformMath::CountLeadingZeros(Mask) - 16;
+		}
+	};
+#else
+	/** The control bytes of 8 consecutive slots. Matches are returned as the top bit of each slot's byte. */
+	struct FGroup
+	{
+		enum { Width = 8 };
+		typedef uint64 FMask;
+
+		uint64 Ctrl;
+
+		explicit FORCEINLINE FGroup(const int8* Pos)
+			: Ctrl(0)
+		{
+			for (int32 Index = 0; Index < Width; ++Index)
+			{
+				Ctrl |= uint64(uint8(Pos[Index])) << (Index * 8);
+			}
+		}
+
+		/** @return The slots whose control byte is H2, and possibly slots after them, which the key comparison sorts out. */
+		FORCEINLINE FMask Match(int8 H2) const
+		{
+			const uint64 Bytes = Ctrl ^ (LowBits * uint8(H2));
+			return (Bytes - LowBits) & ~Bytes & HighBits;
+		}
+
+		FORCEINLINE FMask MatchEmpty() const
+		{
+			// Empty is the only value with the top bit set and bit 1 clear
+			return Ctrl & (~Ctrl << 6) & HighBits;
+		}
+
+		/** @return The empty and deleted slots. */
+		FORCEINLINE FMask MatchFree() const
+		{
+			return Ctrl & HighBits;
+		}
+
+		FORCEINLINE FMask MatchFull() const
+		{
+			return ~Ctrl & HighBits;
+		}
+
+		/** @return The offset of the first slot in a non-empty mask. */
+		static FORCEINLINE uint32 LowestIndex(FMask Mask)
+		{
+			const uint32 Low = uint32(Mask);
+			return (Low ? YPlatformMath::CountTrailingZeros(Low) : 32 + YPlatformMath::CountTrailingZeros(uint32(Mask >> 32))) >> 3;
+		}
+
+		/** @return The number of slots at the end of the group that are not in a non-empty mask. */
+		static FORCEINLINE uint32 NumLeadingUnmatched(FMask Mask)
+		{
+			const uint32 High = uint32(Mask >> 32);
+			return (High ? YPlatformMath::CountLeadingZeros(High) : 32 + YPlatformMath::CountLeadingZeros(uint32(Mask))) >> 3;
+		}
+
+		static const uint64 LowBits = 0x0101010101010101ull;
+		static const uint64 HighBits = 0x8080808080808080ull;
+	};
+#endif
+
+	/** The unit the table is allocated in, so that elements can be aligned up to 16 bytes */
+	typedef TAlignedBytes<16, 16> FAllocationUnit;
+}
+
+/**
+* A hash set using open addressing, for tables that are searched far more often than they change.
+*
+* Elements are stored directly in one array of slots, next to an array with one control byte per slot which holds 7
+* bits of the hash of the element in the slot, or tells that the slot is empty or deleted. A lookup compares the
+* control bytes of a whole group of slots to the hash at once and only compares keys for the slots that match, so
+* it usually touches one cache line of control bytes and one slot. Groups are probed quadratically from the slot
+* the hash picks, and the table grows when it is 7/8 full.
+*
+* KeyFuncs are the same as for TSet. Allocator is an element allocator as used by TArray; control bytes and slots
+* share one allocation made of 16-byte units (an inline allocator counts those units). Elements must be bitwise
+* relocatable, as for every container here, and aligned to at most 16 bytes.
+*
+* Adding or removing elements moves no other element unless the table is resized, but pointers to elements are
+* invalidated by a resize. Iteration order is unspecified.
+*/
+template<
+	typename InElementType,
+	typename KeyFuncs = DefaultKeyFuncs<InElementType>,
+	typename Allocator = FDefaultAllocator
+>
+class TFlatSet
+{
+	typedef typename KeyFuncs::KeyInitType     KeyInitType;
+	typedef typename KeyFuncs::ElementInitType ElementInitType;
+	typedef UE4FlatSet_Private::FGroup         FGroup;
+	typedef typename FGroup::FMask             FMask;
+
+	static_assert(ALIGNOF(InElementType) <= 16, "TFlatSet elements can be aligned to at most 16 bytes");
+
+public:
+	typedef InElementType ElementType;
+
+	/** Initialization constructor. */
+	FORCEINLINE TFlatSet()
+		: Ctrl((int8*)UE4FlatSet_Private::EmptyGroup)
+		, Slots(nullptr)
+		, IndexMask(0)
+		, NumElements(0)
+		, GrowthLeft(0)
+	{
+	}
+
+	/** Copy constructor. */
+	TFlatSet(const TFlatSet& Copy)
+		: Ctrl((int8*)UE4FlatSet_Private::EmptyGroup)
+		, Slots(nullptr)
+		, IndexMask(0)
+		, NumElements(0)
+		, GrowthLeft(0)
+	{
+		*this = Copy;
+	}
+
+	/** Move constructor. */
+	TFlatSet(TFlatSet&& Other)
+		: Ctrl((int8*)UE4FlatSet_Private::EmptyGroup)
+		, Slots(nullptr)
+		, IndexMask(0)
+		, NumElements(0)
+		, GrowthLeft(0)
+	{
+		*this = MoveTemp(Other);
+	}
+
+	/** Initializer list constructor. */
+	TFlatSet(std::initializer_list<ElementType> InitList)
+		: Ctrl((int8*)UE4FlatSet_Private::EmptyGroup)
+		, Slots(nullptr)
+		, IndexMask(0)
+		, NumElements(0)
+		, GrowthLeft(0)
+	{
+		Append(InitList);
+	}
+
+	explicit TFlatSet(const TArray<ElementType>& InArray)
+		: Ctrl((int8*)UE4FlatSet_Private::EmptyGroup)
+		, Slots(nullptr)
+		, IndexMask(0)
+		, NumElements(0)
+		, GrowthLeft(0)
+	{
+		Append(InArray);
+	}
+
+	/** Destructor. */
+	~TFlatSet()
+	{
+		DestructElements();
+	}
+
+	/** Assignment operator. Copies the table as is, without hashing the elements again. */
+	TFlatSet& operator=(const TFlatSet& Copy)
+	{
+		if (this != &Copy)
+		{
+			Reset();
+			if (GetCapacity() != Copy.GetCapacity())
+			{
+				Resize(Copy.GetCapacity());
+			}
+			if (Copy.NumElements)
+			{
+				YMemory::Memcpy(Ctrl, Copy.Ctrl, GetCapacity() + FGroup::Width);
+				for (int32 Index = 0, Capacity = GetCapacity(); Index < Capacity; ++Index)
+				{
+					if (Ctrl[Index] >= 0)
+					{
+						new(Slots + Index) ElementType(Copy.Slots[Index]);
+					}
+				}
+				NumElements = Copy.NumElements;
+				GrowthLeft = Copy.GrowthLeft;
+			}
+		}
+		return *this;
+	}
+
+	/** Move assignment operator. */
+	TFlatSet& operator=(TFlatSet&& Other)
+	{
+		if (this != &Other)
+		{
+			DestructElements();
+			Allocation.MoveToEmpty(Other.Allocation);
+			IndexMask = Other.IndexMask;
+			NumElements = Other.NumElements;
+			GrowthLeft = Other.GrowthLeft;
+			UpdatePointers(Other.Slots != nullptr);
+
+			Other.IndexMask = 0;
+			Other.NumElements = 0;
+			Other.GrowthLeft = 0;
+			Other.UpdatePointers(false);
+		}
+		return *this;
+	}
+
+	/** Initializer list assignment operator */
+	TFlatSet& operator=(std::initializer_list<ElementType> InitList)
+	{
+		Reset();
+		Append(InitList);
+		return *this;
+	}
+
+	/**
+	* Removes all elements from the set, potentially leaving space allocated for an expected number of elements about to be added.
+	* @param ExpectedNumElements - The number of elements about to be added to the set.
+	*/
+	void Empty(int32 ExpectedNumElements = 0)
+	{
+		// The slots must be marked empty before a resize, which moves the elements of every full slot
+		Reset();
+
+		const int32 NewCapacity = ExpectedNumElements > 0 ? GetCapacityFor(ExpectedNumElements) : 0;
+		if (NewCapacity != GetCapacity())
+		{
+			Resize(NewCapacity);
+		}
+	}
+
+	/** Efficiently empties out the set but preserves all allocations and capacities */
+	void Reset()
+	{
+		DestructElements();
+		NumElements = 0;
+		ResetControlBytes();
+	}
+
+	/** Preallocates enough memory to contain Number elements without growing */
+	FORCEINLINE void Reserve(int32 Number)
+	{
+		if (Number > NumElements + GrowthLeft)
+		{
+			Resize(GetCapacityFor(Number));
+		}
+	}
+
+	/** Shrinks the table to the smallest size that holds the elements, which also drops deleted slots. */
+	void Shrink()
+	{
+		const int32 NewCapacity = NumElements ? GetCapacityFor(NumElements) : 0;
+		if (NewCapacity < GetCapacity())
+		{
+			Resize(NewCapacity);
+		}
+	}
+
+	/**
+	* Helper function to return the amount of memory allocated by this container
+	* @return number of bytes allocated by this container
+	*/
+	FORCEINLINE uint32 GetAllocatedSize() const
+	{
+		return Slots ? GetNumAllocationUnits(GetCapacity()) * sizeof(UE4FlatSet_Private::FAllocationUnit) : 0;
+	}
+
+	/** @return the number of elements. */
+	FORCEINLINE int32 Num() const
+	{
+		return NumElements;
+	}
+
+	/** @return the number of slots in the table. */
+	FORCEINLINE int32 GetCapacity() const
+	{
+		return Slots ? int32(IndexMask + 1) : 0;
+	}
+
+	/**
+	* Adds an element to the set, replacing an element with the same key if the KeyFuncs do not allow duplicate keys.
+	*
+	* @param	InElement					Element to add to set
+	* @param	bIsAlreadyInSetPtr	[out]	Optional pointer to bool that will be set depending on whether element is already in set
+	* @return	A pointer to the element stored in the set, valid until the set is resized.
+	*/
+	FORCEINLINE ElementType* Add(const InElementType&  InElement, bool* bIsAlreadyInSetPtr = nullptr) { return Emplace(InElement, bIsAlreadyInSetPtr); }
+	FORCEINLINE ElementType* Add(InElementType&& InElement, bool* bIsAlreadyInSetPtr = nullptr) { return Emplace(MoveTemp(InElement), bIsAlreadyInSetPtr); }
+
+	/**
+	* Adds an element to the set, with the hash of its key already known.
+	*
+	* @param	KeyHash						The hash of the element's key, as KeyFuncs::GetKeyHash returns it
+	* @param	InElement					Element to add to set
+	* @param	bIsAlreadyInSetPtr	[out]	Optional pointer to bool that will be set depending on whether element is already in set
+	* @return	A pointer to the element stored in the set, valid until the set is resized.
+	*/
+	FORCEINLINE ElementType* AddByHash(uint32 KeyHash, const InElementType&  InElement, bool* bIsAlreadyInSetPtr = nullptr) { return EmplaceByHash(KeyHash, InElement, bIsAlreadyInSetPtr); }
+	FORCEINLINE ElementType* AddByHash(uint32 KeyHash, InElementType&& InElement, bool* bIsAlreadyInSetPtr = nullptr) { return EmplaceByHash(KeyHash, MoveTemp(InElement), bIsAlreadyInSetPtr); }
+
+	/**
+	* Adds an element to the set.
+	*
+	* @param	Args						The argument(s) to be forwarded to the set element's constructor.
+	* @param	bIsAlreadyInSetPtr	[out]	Optional pointer to bool that will be set depending on whether element is already in set
+	* @return	A pointer to the element stored in the set, valid until the set is resized.
+	*/
+	template <typename ArgsType>
+	ElementType* Emplace(ArgsType&& Args, bool* bIsAlreadyInSetPtr = nullptr)
+	{
+		TTypeCompatibleBytes<ElementType> NewElementBytes;
+		ElementType& NewElement = *new(&NewElementBytes) ElementType(Forward<ArgsType>(Args));
+		return AddConstructed(KeyFuncs::GetKeyHash(KeyFuncs::GetSetKey(NewElement)), NewElement, bIsAlreadyInSetPtr);
+	}
+
+	/** Same as Emplace, with the hash of the element's key already known. */
+	template <typename ArgsType>
+	ElementType* EmplaceByHash(uint32 KeyHash, ArgsType&& Args, bool* bIsAlreadyInSetPtr = nullptr)
+	{
+		TTypeCompatibleBytes<ElementType> NewElementBytes;
+		ElementType& NewElement = *new(&NewElementBytes) ElementType(Forward<ArgsType>(Args));
+		return AddConstructed(KeyHash, NewElement, bIsAlreadyInSetPtr);
+	}
+
+	template<typename ArrayAllocator>
+	void Append(const TArray<ElementType, ArrayAllocator>& InElements)
+	{
+		Reserve(NumElements + InElements.Num());
+		for (const ElementType& Element : InElements)
+		{
+			Add(Element);
+		}
+	}
+
+	void Append(std::initializer_list<ElementType> InitList)
+	{
+		Reserve(NumElements + (int32)InitList.size());
+		for (const ElementType& Element : InitList)
+		{
+			Add(Element);
+		}
+	}
+
+	/**
+	* Finds an element with the given key in the set.
+	* @param Key - The key to search for.
+	* @return A pointer to an element with the given key.  If no element in the set has the given key, this will return nullptr.
+	*/
+	FORCEINLINE ElementType* Find(KeyInitType Key)
+	{
+		return FindByHash(KeyFuncs::GetKeyHash(Key), Key);
+	}
+	FORCEINLINE const ElementType* Find(KeyInitType Key) const
+	{
+		return const_cast<TFlatSet*>(this)->Find(Key);
+	}
+
+	/**
+	* Finds an element with the given key, without computing the hash of the key and without converting it to KeyType.
+	* Finding a YName by a string, or an object by an id, only needs KeyFuncs::Matches to compare the two types.
+	*
+	* @param KeyHash - The hash of the key, as KeyFuncs::GetKeyHash returns it for a matching key.
+	* @param Key - The key to search for.
+	* @return A pointer to an element with the given key, or nullptr.
+	*/
+	template<typename ComparableKey>
+	FORCEINLINE ElementType* FindByHash(uint32 KeyHash, const ComparableKey& Key)
+	{
+		const int32 Index = FindIndex(UE4FlatSet_Private::MixHash(KeyHash), Key);
+		return Index != INDEX_NONE ? Slots + Index : nullptr;
+	}
+	template<typename ComparableKey>
+	FORCEINLINE const ElementType* FindByHash(uint32 KeyHash, const ComparableKey& Key) const
+	{
+		return const_cast<TFlatSet*>(this)->FindByHash(KeyHash, Key);
+	}
+
+	/**
+	* Checks if the set contains an element with the given key.
+	* @param Key - The key to check for.
+	* @return true if the set contains an element with the given key.
+	*/
+	FORCEINLINE bool Contains(KeyInitType Key) const
+	{
+		return FindIndex(UE4FlatSet_Private::MixHash(KeyFuncs::GetKeyHash(Key)), Key) != INDEX_NONE;
+	}
+
+	template<typename ComparableKey>
+	FORCEINLINE bool ContainsByHash(uint32 KeyHash, const ComparableKey& Key) const
+	{
+		return FindIndex(UE4FlatSet_Private::MixHash(KeyHash), Key) != INDEX_NONE;
+	}
+
+	/**
+	* Removes all elements from the set matching the specified key.
+	* @param Key - The key to match elements against.
+	* @return The number of elements removed.
+	*/
+	FORCEINLINE int32 Remove(KeyInitType Key)
+	{
+		return RemoveByHash(KeyFuncs::GetKeyHash(Key), Key);
+	}
+
+	template<typename ComparableKey>
+	int32 RemoveByHash(uint32 KeyHash, const ComparableKey& Key)
+	{
+		const uint32 Hash = UE4FlatSet_Private::MixHash(KeyHash);
+		int32 NumRemovedElements = 0;
+		for (int32 Index = FindIndex(Hash, Key); Index != INDEX_NONE; Index = FindIndex(Hash, Key))
+		{
+			RemoveAt(Index);
+			++NumRemovedElements;
+
+			if (!KeyFuncs::bAllowDuplicateKeys)
+			{
+				break;
+			}
+		}
+		return NumRemovedElements;
+	}
+
+	/** @return a TArray of the elements */
+	TArray<ElementType> Array() const
+	{
+		TArray<ElementType> Result;
+		Result.Reserve(NumElements);
+		for (TConstIterator It(*this); It; ++It)
+		{
+			Result.Add(*It);
+		}
+		return Result;
+	}
+
+	/** Serializer. */
+	friend YArchive& operator<<(YArchive& Ar, TFlatSet& Set)
+	{
+		int32 SerializeNum = Set.NumElements;
+		Ar << SerializeNum;
+
+		if (Ar.IsLoading())
+		{
+			Set.Empty(SerializeNum);
+			for (int32 Index = 0; Index < SerializeNum; ++Index)
+			{
+				ElementType Element;
+				Ar << Element;
+				Set.Add(MoveTemp(Element));
+			}
+		}
+		else
+		{
+			for (TIterator It(Set); It; ++It)
+			{
+				Ar << *It;
+			}
+		}
+		return Ar;
+	}
+
+private:
+	typedef typename Allocator::template ForElementType<UE4FlatSet_Private::FAllocationUnit> AllocationType;
+
+	/** Control bytes, one per slot followed by a copy of the first group so that groups can be loaded from any slot. */
+	int8* Ctrl;
+	ElementType* Slots;
+	/** The number of slots minus one, the number of slots is a power of two. */
+	uint32 IndexMask;
+	int32 NumElements;
+	/** How many more empty slots can be filled before the table has to grow. */
+	int32 GrowthLeft;
+	AllocationType Allocation;
+
+	static FORCEINLINE int32 GetMaxLoad(int32 Capacity)
+	{
+		return Capacity - Capacity / 8;
+	}
+
+	/** @return The smallest capacity that holds Number elements. */
+	static int32 GetCapacityFor(int32 Number)
+	{
+		int32 Capacity = FGroup::Width;
+		while (GetMaxLoad(Capacity) < Number)
+		{
+			Capacity *= 2;
+		}
+		return Capacity;
+	}
+
+	static FORCEINLINE int32 GetSlotsOffset(int32 Capacity)
+	{
+		return Align(Capacity + FGroup::Width, ALIGNOF(ElementType));
+	}
+
+	static FORCEINLINE int32 GetNumAllocationUnits(int32 Capacity)
+	{
+		return int32((GetSlotsOffset(Capacity) + SIZE_T(Capacity) * sizeof(ElementType) + sizeof(UE4FlatSet_Private::FAllocationUnit) - 1) / sizeof(UE4FlatSet_Private::FAllocationUnit));
+	}
+
+	FORCEINLINE void UpdatePointers(bool bHasAllocation)
+	{
+		if (bHasAllocation)
+		{
+			Ctrl = (int8*)Allocation.GetAllocation();
+			Slots = (ElementType*)(Ctrl + GetSlotsOffset(IndexMask + 1));
+		}
+		else
+		{
+			Ctrl = (int8*)UE4FlatSet_Private::EmptyGroup;
+			Slots = nullptr;
+			IndexMask = 0;
+		}
+	}
+
+	/** Sets the control byte of a slot, and its copy after the end of the table. */
+	FORCEINLINE void SetCtrl(uint32 Index, int8 Value)
+	{
+		Ctrl[Index] = Value;
+		Ctrl[((Index - FGroup::Width) & IndexMask) + FGroup::Width] = Value;
+	}
+
+	void ResetControlBytes()
+	{
+		if (Slots)
+		{
+			YMemory::Memset(Ctrl, (uint8)UE4FlatSet_Private::CtrlEmpty, GetCapacity() + FGroup::Width);
+		}
+		GrowthLeft = Slots ? GetMaxLoad(GetCapacity()) - NumElements : 0;
+	}
+
+	void DestructElements()
+	{
+		if (!TIsTriviallyDestructible<ElementType>::Value && NumElements)
+		{
+			for (int32 Index = 0, Capacity = GetCapacity(); Index < Capacity; ++Index)
+			{
+				if (Ctrl[Index] >= 0)
+				{
+					DestructItem(Slots + Index);
+				}
+			}
+		}
+	}
+
+	/** @return The index of the first element that matches the key, or INDEX_NONE. */
+	template<typename ComparableKey>
+	FORCEINLINE int32 FindIndex(uint32 Hash, const ComparableKey& Key) const
+	{
+		const int8 H2 = int8(Hash & 0x7F);
+		uint32 Pos = (Hash >> 7) & IndexMask;
+		uint32 Stride = 0;
+		for (;;)
+		{
+			const FGroup Group(Ctrl + Pos);
+			for (FMask Match = Group.Match(H2); Match; Match &= Match - 1)
+			{
+				const uint32 Index = (Pos + FGroup::LowestIndex(Match)) & IndexMask;
+				if (KeyFuncs::Matches(KeyFuncs::GetSetKey(Slots[Index]), Key))
+				{
+					return int32(Index);
+				}
+			}
+			if (Group.MatchEmpty())
+			{
+				return INDEX_NONE;
+			}
+			Stride += FGroup::Width;
+			Pos = (Pos + Stride) & IndexMask;
+		}
+	}
+
+	/** @return The index of the first empty or deleted slot on the probe sequence of the hash. */
+	FORCEINLINE uint32 FindFreeIndex(uint32 Hash) const
+	{
+		uint32 Pos = (Hash >> 7) & IndexMask;
+		uint32 Stride = 0;
+		for (;;)
+		{
+			const FMask Free = FGroup(Ctrl + Pos).MatchFree();
+			if (Free)
+			{
+				return (Pos + FGroup::LowestIndex(Free)) & IndexMask;
+			}
+			Stride += FGroup::Width;
+			Pos = (Pos + Stride) & IndexMask;
+		}
+	}
+
+	/** Moves a constructed element into the table, or over the element with the same key. */
+	ElementType* AddConstructed(uint32 KeyHash, ElementType& NewElement, bool* bIsAlreadyInSetPtr)
+	{
+		const uint32 Hash = UE4FlatSet_Private::MixHash(KeyHash);
+
+		if (!KeyFuncs::bAllowDuplicateKeys)
+		{
+			const int32 ExistingIndex = FindIndex(Hash, KeyFuncs::GetSetKey(NewElement));
+			if (ExistingIndex != INDEX_NONE)
+			{
+				MoveByRelocate(Slots[ExistingIndex], NewElement);
+				if (bIsAlreadyInSetPtr)
+				{
+					*bIsAlreadyInSetPtr = true;
+				}
+				return Slots + ExistingIndex;
+			}
+		}
+
+		uint32 Index = FindFreeIndex(Hash);
+		if (GrowthLeft == 0 && Ctrl[Index] == UE4FlatSet_Private::CtrlEmpty)
+		{
+			Grow();
+			Index = FindFreeIndex(Hash);
+		}
+		GrowthLeft -= Ctrl[Index] == UE4FlatSet_Private::CtrlEmpty;
+		SetCtrl(Index, int8(Hash & 0x7F));
+		RelocateConstructItems<ElementType>(Slots + Index, &NewElement, 1);
+		++NumElements;
+
+		if (bIsAlreadyInSetPtr)
+		{
+			*bIsAlreadyInSetPtr = false;
+		}
+		return Slots + Index;
+	}
+
+	/** Destroys the element in a slot and frees the slot. */
+	void RemoveAt(uint32 Index)
+	{
+		DestructItem(Slots + Index);
+		--NumElements;
+
+		// The slot can go back to empty, which ends probe sequences, unless some group around it was full when an element
+		// was added and probing went on past it.
+		const FMask EmptyBefore = FGroup(Ctrl + ((Index - FGroup::Width) & IndexMask)).MatchEmpty();
+		const FMask EmptyAfter = FGroup(Ctrl + Index).MatchEmpty();
+		const bool bWasNeverFull = EmptyBefore && EmptyAfter &&
+			FGroup::LowestIndex(EmptyAfter) + FGroup::NumLeadingUnmatched(EmptyBefore) < FGroup::Width;
+
+		SetCtrl(Index, bWasNeverFull ? UE4FlatSet_Private::CtrlEmpty : UE4FlatSet_Private::CtrlDeleted);
+		GrowthLeft += bWasNeverFull;
+	}
+
+	/** Makes room for one more element, by dropping deleted slots if there are enough of them or by doubling the table. */
+	void Grow()
+	{
+		const int32 Capacity = GetCapacity();
+		if (Capacity && int64(NumElements) * 32 <= int64(Capacity) * 25)
+		{
+			Resize(Capacity);
+		}
+		else
+		{
+			Resize(Capacity ? Capacity * 2 : int32(FGroup::Width));
+		}
+	}
+
+	/** Moves the elements to a new table of NewCapacity slots, which must hold them all. */
+	void Resize(int32 NewCapacity)
+	{
+		checkSlow(NewCapacity == 0 || (GetMaxLoad(NewCapacity) >= NumElements && !(NewCapacity & (NewCapacity - 1))));
+
+		const int8* OldCtrl = Ctrl;
+		ElementType* OldSlots = Slots;
+		const int32 OldCapacity = GetCapacity();
+
+		AllocationType NewAllocation;
+		if (NewCapacity)
+		{
+			NewAllocation.ResizeAllocation(0, GetNumAllocationUnits(NewCapacity), sizeof(UE4FlatSet_Private::FAllocationUnit));
+			Ctrl = (int8*)NewAllocation.GetAllocation();
+			Slots = (ElementType*)(Ctrl + GetSlotsOffset(NewCapacity));
+			IndexMask = uint32(NewCapacity - 1);
+			YMemory::Memset(Ctrl, (uint8)UE4FlatSet_Private::CtrlEmpty, NewCapacity + FGroup::Width);
+
+			for (int32 OldIndex = 0; OldIndex < OldCapacity; ++OldIndex)
+			{
+				if (OldCtrl[OldIndex] >= 0)
+				{
+					const uint32 Hash = UE4FlatSet_Private::MixHash(KeyFuncs::GetKeyHash(KeyFuncs::GetSetKey(OldSlots[OldIndex])));
+					const uint32 Index = FindFreeIndex(Hash);
+					SetCtrl(Index, int8(Hash & 0x7F));
+					RelocateConstructItems<ElementType>(Slots + Index, OldSlots + OldIndex, 1);
+				}
+			}
+		}
+		else
+		{
+			checkSlow(NumElements == 0);
+			IndexMask = 0;
+		}
+
+		// Frees the old table; an inline allocation is moved, so the pointers have to be fetched again
+		Allocation.MoveToEmpty(NewAllocation);
+		UpdatePointers(NewCapacity != 0);
+		GrowthLeft = NewCapacity ? GetMaxLoad(NewCapacity) - NumElements : 0;
+	}
+
+	/** @return The index of the first full slot at or after Index, or the capacity if there is none. */
+	FORCEINLINE int32 GetNextFullIndex(int32 Index) const
+	{
+		const int32 Capacity = GetCapacity();
+		for (; Index < Capacity; Index += FGroup::Width)
+		{
+			const FMask Full = FGroup(Ctrl + Index).MatchFull();
+			if (Full)
+			{
+				// bits past the end of the table are the copies of the first group
+				return YPlatformMath::Min(Index + int32(FGroup::LowestIndex(Full)), Capacity);
+			}
+		}
+		return Capacity;
+	}
+
+	/** The base type of set iterators. */
+	template<bool bConst>
+	class TBaseIterator
+	{
+	private:
+		friend class TFlatSet;
+
+		typedef typename TChooseClass<bConst, const TFlatSet, TFlatSet>::Result SetType;
+		typedef typename TChooseClass<bConst, const ElementType, ElementType>::Result ItElementType;
+
+	public:
+		FORCEINLINE TBaseIterator(SetType& InSet, int32 StartIndex)
+			: Set(InSet)
+			, Index(InSet.GetNextFullIndex(StartIndex))
+		{
+		}
+
+		/** Advances the iterator to the next element. */
+		FORCEINLINE TBaseIterator& operator++()
+		{
+			Index = Set.GetNextFullIndex(Index + 1);
+			return *this;
+		}
+
+		/** conversion to "bool" returning true if the iterator is valid. */
+		FORCEINLINE explicit operator bool() const
+		{
+			return Index < Set.GetCapacity();
+		}
+		/** inverse of the "bool" operator */
+		FORCEINLINE bool operator !() const
+		{
+			return !(bool)*this;
+		}
+
+		// Accessors.
+		FORCEINLINE ItElementType* operator->() const
+		{
+			return Set.Slots + Index;
+		}
+		FORCEINLINE ItElementType& operator*() const
+		{
+			return Set.Slots[Index];
+		}
+
+		FORCEINLINE friend bool operator==(const TBaseIterator& Lhs, const TBaseIterator& Rhs) { return Lhs.Index == Rhs.Index; }
+		FORCEINLINE friend bool operator!=(const TBaseIterator& Lhs, const TBaseIterator& Rhs) { return Lhs.Index != Rhs.Index; }
+
+	protected:
+		SetType& Set;
+		int32 Index;
+	};
+
+public:
+
+	/** Used to iterate over the elements of a const TFlatSet. */
+	class TConstIterator : public TBaseIterator<true>
+	{
+	public:
+		FORCEINLINE TConstIterator(const TFlatSet& InSet, int32 StartIndex = 0)
+			: TBaseIterator<true>(InSet, StartIndex)
+		{
+		}
+	};
+
+	/** Used to iterate over the elements of a TFlatSet. */
+	class TIterator : public TBaseIterator<false>
+	{
+	public:
+		FORCEINLINE TIterator(TFlatSet& InSet, int32 StartIndex = 0)
+			: TBaseIterator<false>(InSet, StartIndex)
+		{
+		}
+
+		/** Removes the current element from the set. The other elements do not move, so iteration can go on. */
+		FORCEINLINE void RemoveCurrent()
+		{
+			this->Set.RemoveAt(this->Index);
+		}
+	};
+
+	/** Creates an iterator for the contents of this set */
+	FORCEINLINE TIterator CreateIterator()
+	{
+		return TIterator(*this);
+	}
+
+	/** Creates a const iterator for the contents of this set */
+	FORCEINLINE TConstIterator CreateConstIterator() const
+	{
+		return TConstIterator(*this);
+	}
+
+private:
+	/**
+	* DO NOT USE DIRECTLY
+	* STL-like iterators to enable range-based for loop support.
+	*/
+	FORCEINLINE friend TIterator      begin(TFlatSet& Set) { return TIterator(Set); }
+	FORCEINLINE friend TConstIterator begin(const TFlatSet& Set) { return TConstIterator(Set); }
+	FORCEINLINE friend TIterator      end(TFlatSet& Set) { return TIterator(Set, Set.GetCapacity()); }
+	FORCEINLINE friend TConstIterator end(const TFlatSet& Set) { return TConstIterator(Set, Set.GetCapacity()); }
+};
+
+template<typename ElementType, typename KeyFuncs, typename Allocator>
+struct TContainerTraits<TFlatSet<ElementType, KeyFuncs, Allocator> > : public TContainerTraitsBase<TFlatSet<ElementType, KeyFuncs, Allocator> >
+{
+	enum { MoveWillEmptyContainer = true };
+};
@@ -0,0 +1,275 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Misc/AssertionMacros.h"
+#include "Containers/ContainerAllocationPolicies.h"
+#include "Containers/Array.h"
+#include "Containers/SolidAngleString.h"
+#include "Misc/CString.h"
+#include "Misc/Crc.h"
+
+/**
+* A string that keeps up to NumInlineChars characters inside the object itself and only touches the heap when it grows
+* past them, like TArray with a TInlineAllocator.
+*
+* Meant for the short lived strings made while parsing and formatting: tokens, names, lines of a config file. Reusing one
+* across iterations also keeps whatever heap buffer it grew into, as Reset() does not free it. Anything that outlives the
+* scope should be a YString, see ToString().
+*
+* Like YString, the characters are always null terminated, so operator* can be passed to any TCHAR* or FCString API.
+*/
+template<int32 NumInlineChars>
+class TInlineString
+{
+	static_assert(NumInlineChars > 0, "TInlineString needs room for at least one character");
+
+	/** Array holding the character data and its terminator, exactly like YString does */
+	typedef TArray<TCHAR, TInlineAllocator<NumInlineChars + 1>> DataType;
+	DataType Data;
+
+public:
+	using ElementType = TCHAR;
+
+	TInlineString() = default;
+	TInlineString(TInlineString&&) = default;
+	TInlineString(const TInlineString&) = default;
+	TInlineString& operator=(TInlineString&&) = default;
+	TInlineString& operator=(const TInlineString&) = default;
+
+	FORCEINLINE TInlineString(const TCHAR* Src)
+	{
+		if (Src && *Src)
+		{
+			Append(Src, FCString::Strlen(Src));
+		}
+	}
+
+	FORCEINLINE explicit TInlineString(const YString& Src)
+	{
+		Append(*Src, Src.Len());
+	}
+
+	/**
+	* Constructor to create a string with the given number of characters of another string
+	*
+	* @param InCount how many characters to copy
+	* @param InSrc String to copy from
+	*/
+	FORCEINLINE explicit TInlineString(int32 InCount, const TCHAR* InSrc)
+	{
+		Append(InSrc, InCount);
+	}
+
+	FORCEINLINE TInlineString& operator=(const TCHAR* Src)
+	{
+		if (Src != Data.GetData())
+		{
+			Reset();
+			if (Src && *Src)
+			{
+				Append(Src, FCString::Strlen(Src));
+			}
+		}
+		return *this;
+	}
+
+	FORCEINLINE TInlineString& operator=(const YString& Src)
+	{
+		Reset();
+		return Append(*Src, Src.Len());
+	}
+
+	/**
+	* Get pointer to the string
+	*
+	* @Return Pointer to the characters if any, otherwise the empty string
+	*/
+	FORCEINLINE const TCHAR* operator*() const
+	{
+		return Data.Num() ? Data.GetData() : TEXT("");
+	}
+
+	FORCEINLINE TCHAR& operator[](int32 Index)
+	{
+		checkf(IsValidIndex(Index), TEXT("String index out of bounds: Index %i from a string with a length of %i"), Index, Len());
+		return Data.GetData()[Index];
+	}
+
+	FORCEINLINE const TCHAR& operator[](int32 Index) const
+	{
+		checkf(IsValidIndex(Index), TEXT("String index out of bounds: Index %i from a string with a length of %i"), Index, Len());
+		return Data.GetData()[Index];
+	}
+
+	/** @return the number of characters, excluding the null terminator */
+	FORCEINLINE int32 Len() const
+	{
+		return Data.Num() ? Data.Num() - 1 : 0;
+	}
+
+	FORCEINLINE bool IsEmpty() const
+	{
+		return Data.Num() <= 1;
+	}
+
+	FORCEINLINE bool IsValidIndex(int32 Index) const
+	{
+		return Index >= 0 && Index < Len();
+	}
+
+	/** @return true while the characters still fit in the object, i.e. no heap memory is used */
+	FORCEINLINE bool IsInline() const
+	{
+		return Data.Max() <= NumInlineChars + 1;
+	}
+
+	/** @return the heap memory used, 0 while the string is inline */
+	FORCEINLINE uint32 GetAllocatedSize() const
+	{
+		return IsInline() ? 0 : Data.GetAllocatedSize();
+	}
+
+	/**
+	* Empties the string, but doesn't change memory allocation, unless the new size is larger than the current string.
+	*
+	* @param NewReservedSize The expected usage size (in characters, not including the terminator) after calling this function.
+	*/
+	FORCEINLINE void Reset(int32 NewReservedSize = 0)
+	{
+		Data.Reset(NewReservedSize > 0 ? NewReservedSize + 1 : 0);
+	}
+
+	/** Empties the string and gives back any heap memory it grew into */
+	FORCEINLINE void Empty()
+	{
+		Data.Empty();
+	}
+
+	FORCEINLINE TInlineString& AppendChar(const TCHAR InChar)
+	{
+		if (InChar != 0)
+		{
+			if (Data.Num() == 0)
+			{
+				Data.AddUninitialized(2);
+				Data[0] = InChar;
+				Data[1] = 0;
+			}
+			else
+			{
+				Data.Last() = InChar;
+				Data.Add(0);
+			}
+		}
+		return *this;
+	}
+
+	TInlineString& Append(const TCHAR* Text, int32 Count)
+	{
+		if (Count > 0)
+		{
+			const int32 InsertIndex = Len();
+			Data.SetNumUninitialized(InsertIndex + Count + 1, false);
+			YMemory::Memcpy(Data.GetData() + InsertIndex, Text, Count * sizeof(TCHAR));
+			Data[InsertIndex + Count] = 0;
+		}
+		return *this;
+	}
+
+	FORCEINLINE TInlineString& operator+=(const TCHAR InChar)
+	{
+		return AppendChar(InChar);
+	}
+
+	FORCEINLINE TInlineString& operator+=(const TCHAR* Str)
+	{
+		checkSlow(Str);
+		return Append(Str, FCString::Strlen(Str));
+	}
+
+	FORCEINLINE TInlineString& operator+=(const YString& Str)
+	{
+		return Append(*Str, Str.Len());
+	}
+
+	/** Removes Count characters from the end of the string, keeping the memory */
+	FORCEINLINE void RemoveFromEnd(int32 Count)
+	{
+		checkSlow(Count >= 0 && Count <= Len());
+		if (Count > 0)
+		{
+			Data.SetNum(Data.Num() - Count, false);
+			Data.Last() = 0;
+		}
+	}
+
+	/**
+	* Lexicographically tests whether this string is equivalent to the Other given string
+	*
+	* @param Other 	The string test against
+	* @param SearchCase 	Whether or not the comparison should ignore case
+	* @return true if this string is lexicographically equivalent to the other, otherwise false
+	*/
+	FORCEINLINE bool Equals(const TCHAR* Other, ESearchCase::Type SearchCase = ESearchCase::CaseSensitive) const
+	{
+		return SearchCase == ESearchCase::CaseSensitive ? FCString::Strcmp(**this, Other) == 0 : FCString::Stricmp(**this, Other) == 0;
+	}
+
+	FORCEINLINE int32 Compare(const TCHAR* Other, ESearchCase::Type SearchCase = ESearchCase::CaseSensitive) const
+	{
+		return SearchCase == ESearchCase::CaseSensitive ? FCString::Strcmp(**this, Other) : FCString::Stricmp(**this, Other);
+	}
+
+	/** Case insensitive, like YString */
+	FORCEINLINE friend bool operator==(const TInlineString& Lhs, const TCHAR* Rhs)
+	{
+		return FCString::Stricmp(*Lhs, Rhs) == 0;
+	}
+
+	FORCEINLINE friend bool operator==(const TInlineString& Lhs, const YString& Rhs)
+	{
+		return FCString::Stricmp(*Lhs, *Rhs) == 0;
+	}
+
+	template<int32 OtherNumInlineChars>
+	FORCEINLINE friend bool operator==(const TInlineString& Lhs, const TInlineString<OtherNumInlineChars>& Rhs)
+	{
+		return FCString::Stricmp(*Lhs, *Rhs) == 0;
+	}
+
+	template<typename OtherType>
+	FORCEINLINE friend bool operator!=(const TInlineString& Lhs, const OtherType& Rhs)
+	{
+		return !(Lhs == Rhs);
+	}
+
+	/** @return a YString holding a copy of the characters, allocated to their exact size */
+	FORCEINLINE YString ToString() const
+	{
+		return IsEmpty() ? YString() : YString(Len(), Data.GetData());
+	}
+
+	/**
+	* Get the characters and their terminator. They may be changed in place, but the terminator must stay where it is.
+	*/
+	FORCEINLINE DataType& GetCharArray()
+	{
+		return Data;
+	}
+
+	FORCEINLINE const DataType& GetCharArray() const
+	{
+		return Data;
+	}
+
+	/** Case insensitive string hash function, the same one YString uses. */
+	FORCEINLINE friend uint32 GetTypeHash(const TInlineString& S)
+	{
+		return FCrc::Strihash_DEPRECATED(*S);
+	}
+};
+
+/** Room for 23 characters and the terminator, which covers most names, tokens and keys. */
+typedef TInlineString<23> YInlineString;
@@ -26,13 +26,13 @@ class TLockFreeFixedSizeAllocator
 
 public:
 
-	/** Destructor, returns all memory via YMemory::Free **/
+	/** Destructor, returns all memory via YMemory::FreeSized **/
 	~TLockFreeFixedSizeAllocator()
 	{
 		check(!NumUsed.GetValue());
 		while (void* Mem = FreeList.Pop())
 		{
-			YMemory::Free(Mem);
+			YMemory::FreeSized(Mem, SIZE);
 			NumFree.Decrement();
 		}
 		check(!NumFree.GetValue());
@@ -118,13 +118,13 @@ class TLockFreeFixedSizeAllocator
 {
 public:
 
-	/** Destructor, returns all memory via YMemory::Free **/
+	/** Destructor, returns all memory via YMemory::FreeSized **/
 	~TLockFreeFixedSizeAllocator()
 	{
 		check(!NumUsed.GetValue());
 		while (void* Mem = FreeList.Pop())
 		{
-			YMemory::Free(Mem);
+			YMemory::FreeSized(Mem, SIZE);
 			NumFree.Decrement();
 		}
 		check(!NumFree.GetValue());
@@ -0,0 +1,249 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Misc/AssertionMacros.h"
+#include "HAL/PlatformAtomics.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformMath.h"
+#include "HAL/SolidAngleMemory.h"
+#include "Templates/SolidAngleTemplate.h"
+#include "Templates/TypeCompatibleBytes.h"
+#include "Templates/MemoryOps.h"
+
+/**
+ * Implements a bounded lock-free first-in first-out queue for any number of producers and consumers.
+ *
+ * The elements are stored in a circular array allocated up front, so enqueuing does not allocate. Each cell of the
+ * array holds a sequence number that tells producers when the cell is free and consumers when it holds an element
+ * for their turn, so a thread only has to win a compare-and-swap on the enqueue or dequeue position to own a cell.
+ * The two positions are on separate cache lines so that producers and consumers do not contend on them.
+ *
+ * Enqueue fails when the queue is full and Dequeue fails when it is empty; neither blocks or spins on the other side.
+ *
+ * @param ElementType The type of elements held in the queue.
+ */
+template<typename ElementType>
+class TMpmcQueue : public FNoncopyable
+{
+public:
+
+	/**
+	 * Creates and initializes a new queue.
+	 *
+	 * @param Size The number of elements that the queue can hold (will be rounded up to the next power of 2).
+	 */
+	explicit TMpmcQueue(uint32 Size)
+		: EnqueuePos(0)
+		, DequeuePos(0)
+	{
+		checkf(Size > 0 && Size <= (1u << 31), TEXT("Invalid TMpmcQueue size %u"), Size);
+
+		const uint32 Capacity = YPlatformMath::RoundUpToPowerOfTwo(Size);
+		IndexMask = Capacity - 1;
+		Cells = (FCell*)YMemory::Malloc(Capacity * sizeof(FCell), PLATFORM_CACHE_LINE_SIZE);
+
+		for (uint32 Index = 0; Index < Capacity; ++Index)
+		{
+			Cells[Index].Sequence = Index;
+		}
+	}
+
+	/** Destructor, destroys the elements still in the queue. */
+	~TMpmcQueue()
+	{
+		for (int64 Pos = DequeuePos; Pos != EnqueuePos; ++Pos)
+		{
+			DestructItem(GetElement(Cells[Pos & IndexMask]));
+		}
+
+		YMemory::Free(Cells);
+	}
+
+public:
+
+	/**
+	 * Adds an item to the end of the queue.
+	 *
+	 * @param Element The element to add.
+	 * @return true if the item was added, false if the queue was full.
+	 */
+	bool Enqueue(const ElementType& Element)
+	{
+		return EnqueueInternal(Element);
+	}
+
+	/**
+	 * Adds an item to the end of the queue.
+	 *
+	 * @param Element The element to move into the queue.
+	 * @return true if the item was added, false if the queue was full (Element is left untouched).
+	 */
+	bool Enqueue(ElementType&& Element)
+	{
+		return EnqueueInternal(MoveTemp(Element));
+	}
+
+	/**
+	 * Removes an item from the front of the queue.
+	 *
+	 * @param OutElement Will contain the element if the queue is not empty.
+	 * @return true if an element has been returned, false if the queue was empty.
+	 */
+	bool Dequeue(ElementType& OutElement)
+	{
+		FCell* Cell;
+		int64 Pos = Load(DequeuePos);
+
+		for (;;)
+		{
+			Cell = &Cells[Pos & IndexMask];
+			const int64 Difference = Load(Cell->Sequence) - (Pos + 1);
+
+			if (Difference == 0)
+			{
+				const int64 Previous = FPlatformAtomics::InterlockedCompareExchange(&DequeuePos, Pos + 1, Pos);
+
+				if (Previous == Pos)
+				{
+					break;
+				}
+
+				Pos = Previous;
+			}
+			else if (Difference < 0)
+			{
+				// the queue is empty, or the producer of this position has not finished writing it yet
+				return false;
+			}
+			else
+			{
+				Pos = Load(DequeuePos);
+			}
+		}
+
+		ElementType* Element = GetElement(*Cell);
+		OutElement = MoveTemp(*Element);
+		DestructItem(Element);
+
+		// the cell is free for the producer that wraps around to it
+		YPlatformMisc::MemoryBarrier();
+		Store(Cell->Sequence, Pos + IndexMask + 1);
+
+		return true;
+	}
+
+	/**
+	 * Checks whether the queue is empty.
+	 *
+	 * CAUTION: other threads can change the queue at any time, so the result is only a hint.
+	 *
+	 * @return true if the queue is empty, false otherwise.
+	 */
+	bool IsEmpty() const
+	{
+		return Load(DequeuePos) >= Load(EnqueuePos);
+	}
+
+	/**
+	 * Gets the number of elements that the queue can hold.
+	 *
+	 * @return Queue capacity.
+	 */
+	uint32 Capacity() const
+	{
+		return IndexMask + 1;
+	}
+
+private:
+
+	/** A slot of the queue, Sequence tells whose turn it is to use it. */
+	struct FCell
+	{
+		/** Aligned so that it never straddles a cache line, 32 bit targets only read and write it atomically then. */
+		MS_ALIGN(8) volatile int64 Sequence GCC_ALIGN(8);
+		TTypeCompatibleBytes<ElementType> Element;
+	};
+
+	static FORCEINLINE ElementType* GetElement(FCell& Cell)
+	{
+		return (ElementType*)&Cell.Element;
+	}
+
+	/** Reads a position or a sequence, a plain 64 bit load can tear on 32 bit targets. */
+	static FORCEINLINE int64 Load(const volatile int64& Value)
+	{
+#if PLATFORM_64BITS
+		return Value;
+#else
+		return FPlatformAtomics::InterlockedCompareExchange((volatile int64*)&Value, 0, 0);
+#endif
+	}
+
+	/** Writes a sequence, for the same reason. */
+	static FORCEINLINE void Store(volatile int64& Value, int64 NewValue)
+	{
+#if PLATFORM_64BITS
+		Value = NewValue;
+#else
+		FPlatformAtomics::InterlockedExchange(&Value, NewValue);
+#endif
+	}
+
+	template<typename ArgType>
+	bool EnqueueInternal(ArgType&& Element)
+	{
+		FCell* Cell;
+		int64 Pos = Load(EnqueuePos);
+
+		for (;;)
+		{
+			Cell = &Cells[Pos & IndexMask];
+			const int64 Difference = Load(Cell->Sequence) - Pos;
+
+			if (Difference == 0)
+			{
+				const int64 Previous = FPlatformAtomics::InterlockedCompareExchange(&EnqueuePos, Pos + 1, Pos);
+
+				if (Previous == Pos)
+				{
+					break;
+				}
+
+				Pos = Previous;
+			}
+			else if (Difference < 0)
+			{
+				// the queue is full, or the consumer of the previous lap has not freed this cell yet
+				return false;
+			}
+			else
+			{
+				Pos = Load(EnqueuePos);
+			}
+		}
+
+		new (GetElement(*Cell)) ElementType(Forward<ArgType>(Element));
+
+		// publish the element before handing the cell to the consumer
+		YPlatformMisc::MemoryBarrier();
+		Store(Cell->Sequence, Pos + 1);
+
+		return true;
+	}
+
+private:
+
+	/** Holds the cells, allocated once at construction. */
+	FCell* Cells;
+
+	/** Holds the capacity minus one. */
+	uint32 IndexMask;
+
+	/** Holds the position of the next element to add. */
+	MS_ALIGN(PLATFORM_CACHE_LINE_SIZE) volatile int64 EnqueuePos GCC_ALIGN(PLATFORM_CACHE_LINE_SIZE);
+
+	/** Holds the position of the next element to remove. */
+	MS_ALIGN(PLATFORM_CACHE_LINE_SIZE) volatile int64 DequeuePos GCC_ALIGN(PLATFORM_CACHE_LINE_SIZE);
+};
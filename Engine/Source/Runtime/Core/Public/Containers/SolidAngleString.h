@@ -18,6 +18,7 @@
 #include "Math/SolidAngleMathUtility.h"
 
 struct YStringFormatArg;
+template<typename CharType> class TStringView;
 template<typename KeyType, typename ValueType, typename SetAllocator, typename KeyFuncs > class TMap;
 
 /** Determines case sensitivity options for string comparisons. */
@@ -1189,6 +1190,17 @@ public:
 		return Find(*SubStr, SearchCase, SearchDir, StartPosition);
 	}
 
+	/**
+	* Searches the string for a substring that does not need to be null terminated, see Containers/StringView.h.
+	*
+	* @param SubStr			The view of the string to search for
+	* @param StartPosition		The start character position to search from
+	* @param SearchCase		Indicates whether the search is case sensitive or not ( defaults to ESearchCase::IgnoreCase )
+	* @param SearchDir			Indicates whether the search starts at the begining or at the end ( defaults to ESearchDir::FromStart )
+	*/
+	int32 Find(const TStringView<TCHAR>& SubStr, ESearchCase::Type SearchCase = ESearchCase::IgnoreCase,
+		ESearchDir::Type SearchDir = ESearchDir::FromStart, int32 StartPosition = INDEX_NONE) const;
+
 	/**
 	* Returns whether this string contains the specified substring.
 	*
@@ -1331,6 +1343,20 @@ public:
 		return true;
 	}
 
+	/**
+	* Splits this string at given string position into views of this string, without allocating.
+	* The views are only valid until this string is changed or destroyed.
+	*
+	* @param InS The string to search and split at
+	* @param LeftS out the view of the characters to the left of InS, not updated if return is false
+	* @param RightS out the view of the characters to the right of InS, not updated if return is false
+	* @param SearchCase		Indicates whether the search is case sensitive or not ( defaults to ESearchCase::IgnoreCase )
+	* @param SearchDir			Indicates whether the search starts at the begining or at the end ( defaults to ESearchDir::FromStart )
+	* @return true if string is split, otherwise false
+	*/
+	bool Split(const TStringView<TCHAR>& InS, TStringView<TCHAR>* LeftS, TStringView<TCHAR>* RightS, ESearchCase::Type SearchCase = ESearchCase::IgnoreCase,
+		ESearchDir::Type SearchDir = ESearchDir::FromStart) const;
+
 	/** @return a new string with the characters of this converted to uppercase */
 	YString ToUpper() const;
 
@@ -1418,6 +1444,14 @@ public:
 	*/
 	bool StartsWith(const YString& InPrefix, ESearchCase::Type SearchCase = ESearchCase::IgnoreCase) const;
 
+	/**
+	* Test whether this string starts with the characters of a view.
+	*
+	* @param SearchCase		Indicates whether the search is case sensitive or not ( defaults to ESearchCase::IgnoreCase )
+	* @return true if this string begins with specified text, false otherwise
+	*/
+	bool StartsWith(const TStringView<TCHAR>& InPrefix, ESearchCase::Type SearchCase = ESearchCase::IgnoreCase) const;
+
 	/**
 	* Test whether this string ends with given string.
 	*
@@ -1434,6 +1468,14 @@ public:
 	*/
 	bool EndsWith(const YString& InSuffix, ESearchCase::Type SearchCase = ESearchCase::IgnoreCase) const;
 
+	/**
+	* Test whether this string ends with the characters of a view.
+	*
+	* @param SearchCase		Indicates whether the search is case sensitive or not ( defaults to ESearchCase::IgnoreCase )
+	* @return true if this string ends with specified text, false otherwise
+	*/
+	bool EndsWith(const TStringView<TCHAR>& InSuffix, ESearchCase::Type SearchCase = ESearchCase::IgnoreCase) const;
+
 	/**
 	* Searches this string for a given wild card
 	*
@@ -1475,6 +1517,18 @@ public:
 	*/
 	int32 ParseIntoArray(TArray<YString>& OutArray, const TCHAR* pchDelim, bool InCullEmpty = true) const;
 
+	/**
+	* Breaks up a delimited string into views of the pieces, without allocating anything but the array.
+	* The views are only valid until this string is changed or destroyed.
+	*
+	* @param	InArray		The array to fill with views of the pieces
+	* @param	pchDelim	The string to delimit on
+	* @param	InCullEmpty	If 1, empty pieces are not added to the array
+	*
+	* @return	The number of elements in InArray
+	*/
+	int32 ParseIntoArray(TArray<TStringView<TCHAR>>& OutArray, const TCHAR* pchDelim, bool InCullEmpty = true) const;
+
 	/**
 	* Breaks up a delimited string into elements of a string array, using any whitespace and an
 	* optional extra delimter, like a ","
@@ -0,0 +1,271 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Misc/AssertionMacros.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformMath.h"
+#include "HAL/SolidAngleMemory.h"
+#include "Templates/SolidAngleTemplate.h"
+#include "Templates/TypeCompatibleBytes.h"
+#include "Templates/MemoryOps.h"
+
+/**
+ * Implements a bounded lock-free first-in first-out ring buffer for one producer thread and one consumer thread.
+ *
+ * Unlike TCircularQueue, elements can be added and removed in batches: EnqueueMany and DequeueMany move as many
+ * elements as fit and publish them with a single update of the tail or head index. The head and tail indices run
+ * freely and are masked on access, so the whole capacity can be used. Each side keeps a private copy of the other
+ * side's index next to its own and only reads the shared one when the copy says the buffer is full or empty, so
+ * the cache lines only move between the threads when they have to.
+ *
+ * @param ElementType The type of elements held in the buffer.
+ */
+template<typename ElementType>
+class TSpscRingBuffer : public FNoncopyable
+{
+public:
+
+	/**
+	 * Creates and initializes a new ring buffer.
+	 *
+	 * @param Size The number of elements that the buffer can hold (will be rounded up to the next power of 2).
+	 */
+	explicit TSpscRingBuffer(uint32 Size)
+		: Tail(0)
+		, CachedHead(0)
+		, Head(0)
+		, CachedTail(0)
+	{
+		checkf(Size > 0 && Size <= (1u << 31), TEXT("Invalid TSpscRingBuffer size %u"), Size);
+
+		const uint32 Capacity = YPlatformMath::RoundUpToPowerOfTwo(Size);
+		IndexMask = Capacity - 1;
+		Elements = (TTypeCompatibleBytes<ElementType>*)YMemory::Malloc(Capacity * sizeof(ElementType), PLATFORM_CACHE_LINE_SIZE);
+	}
+
+	/** Destructor, destroys the elements still in the buffer. */
+	~TSpscRingBuffer()
+	{
+		for (uint32 Index = Head; Index != Tail; ++Index)
+		{
+			DestructItem(GetElement(Index));
+		}
+
+		YMemory::Free(Elements);
+	}
+
+public:
+
+	/**
+	 * Adds an item to the end of the buffer. Must only be called from the producer thread.
+	 *
+	 * @param Element The element to add.
+	 * @return true if the item was added, false if the buffer was full.
+	 */
+	bool Enqueue(const ElementType& Element)
+	{
+		if (GetFreeSlots(1) == 0)
+		{
+			return false;
+		}
+
+		new (GetElement(Tail)) ElementType(Element);
+
+		YPlatformMisc::MemoryBarrier();
+		Tail = Tail + 1;
+
+		return true;
+	}
+
+	/**
+	 * Adds an item to the end of the buffer. Must only be called from the producer thread.
+	 *
+	 * @param Element The element to move into the buffer.
+	 * @return true if the item was added, false if the buffer was full (Element is left untouched).
+	 */
+	bool Enqueue(ElementType&& Element)
+	{
+		if (GetFreeSlots(1) == 0)
+		{
+			return false;
+		}
+
+		new (GetElement(Tail)) ElementType(MoveTemp(Element));
+
+		YPlatformMisc::MemoryBarrier();
+		Tail = Tail + 1;
+
+		return true;
+	}
+
+	/**
+	 * Adds as many of the given items to the end of the buffer as fit. Must only be called from the producer thread.
+	 *
+	 * @param InElements The elements to copy into the buffer, in order.
+	 * @param Num The number of elements.
+	 * @return The number of elements added, from the start of InElements.
+	 */
+	uint32 EnqueueMany(const ElementType* InElements, uint32 Num)
+	{
+		const uint32 NumToAdd = GetFreeSlots(Num);
+		const uint32 LocalTail = Tail;
+
+		for (uint32 Index = 0; Index < NumToAdd; ++Index)
+		{
+			new (GetElement(LocalTail + Index)) ElementType(InElements[Index]);
+		}
+
+		if (NumToAdd)
+		{
+			YPlatformMisc::MemoryBarrier();
+			Tail = LocalTail + NumToAdd;
+		}
+
+		return NumToAdd;
+	}
+
+	/**
+	 * Removes an item from the front of the buffer. Must only be called from the consumer thread.
+	 *
+	 * @param OutElement Will contain the element if the buffer is not empty.
+	 * @return true if an element has been returned, false if the buffer was empty.
+	 */
+	bool Dequeue(ElementType& OutElement)
+	{
+		if (GetUsedSlots(1) == 0)
+		{
+			return false;
+		}
+
+		ElementType* Element = GetElement(Head);
+		OutElement = MoveTemp(*Element);
+		DestructItem(Element);
+
+		YPlatformMisc::MemoryBarrier();
+		Head = Head + 1;
+
+		return true;
+	}
+
+	/**
+	 * Removes up to MaxNum items from the front of the buffer. Must only be called from the consumer thread.
+	 *
+	 * @param OutElements Array of at least MaxNum elements that receives the removed elements, in order.
+	 * @param MaxNum The maximum number of elements to remove.
+	 * @return The number of elements removed.
+	 */
+	uint32 DequeueMany(ElementType* OutElements, uint32 MaxNum)
+	{
+		const uint32 NumToRemove = GetUsedSlots(MaxNum);
+		const uint32 LocalHead = Head;
+
+		for (uint32 Index = 0; Index < NumToRemove; ++Index)
+		{
+			ElementType* Element = GetElement(LocalHead + Index);
+			OutElements[Index] = MoveTemp(*Element);
+			DestructItem(Element);
+		}
+
+		if (NumToRemove)
+		{
+			YPlatformMisc::MemoryBarrier();
+			Head = LocalHead + NumToRemove;
+		}
+
+		return NumToRemove;
+	}
+
+	/**
+	 * Gets the number of elements in the buffer.
+	 *
+	 * CAUTION: unless called from the producer or consumer thread while the other one is idle, the result is only a hint.
+	 *
+	 * @return Number of buffered elements.
+	 */
+	uint32 Count() const
+	{
+		return Tail - Head;
+	}
+
+	/**
+	 * Checks whether the buffer is empty.
+	 *
+	 * @return true if the buffer is empty, false otherwise.
+	 * @see Count
+	 */
+	bool IsEmpty() const
+	{
+		return Tail == Head;
+	}
+
+	/**
+	 * Gets the number of elements that the buffer can hold.
+	 *
+	 * @return Buffer capacity.
+	 */
+	uint32 Capacity() const
+	{
+		return IndexMask + 1;
+	}
+
+private:
+
+	FORCEINLINE ElementType* GetElement(uint32 Index) const
+	{
+		return (ElementType*)&Elements[Index & IndexMask];
+	}
+
+	/** Producer side, returns how many of Num elements can be added, reading the consumer's head only if needed. */
+	FORCEINLINE uint32 GetFreeSlots(uint32 Num)
+	{
+		uint32 Free = IndexMask + 1 - (Tail - CachedHead);
+
+		if (Free < Num)
+		{
+			CachedHead = Head;
+			// the consumer is done with the slots before its head
+			YPlatformMisc::MemoryBarrier();
+			Free = IndexMask + 1 - (Tail - CachedHead);
+		}
+
+		return YPlatformMath::Min(Free, Num);
+	}
+
+	/** Consumer side, returns how many of MaxNum elements can be removed, reading the producer's tail only if needed. */
+	FORCEINLINE uint32 GetUsedSlots(uint32 MaxNum)
+	{
+		uint32 Used = CachedTail - Head;
+
+		if (Used < MaxNum)
+		{
+			CachedTail = Tail;
+			// the slots before the tail are fully written
+			YPlatformMisc::MemoryBarrier();
+			Used = CachedTail - Head;
+		}
+
+		return YPlatformMath::Min(Used, MaxNum);
+	}
+
+private:
+
+	/** Holds the elements, allocated once at construction. */
+	TTypeCompatibleBytes<ElementType>* Elements;
+
+	/** Holds the capacity minus one. */
+	uint32 IndexMask;
+
+	/** Holds the index after the last element, written by the producer. */
+	MS_ALIGN(PLATFORM_CACHE_LINE_SIZE) volatile uint32 Tail GCC_ALIGN(PLATFORM_CACHE_LINE_SIZE);
+
+	/** Holds the producer's copy of Head. */
+	uint32 CachedHead;
+
+	/** Holds the index of the first element, written by the consumer. */
+	MS_ALIGN(PLATFORM_CACHE_LINE_SIZE) volatile uint32 Head GCC_ALIGN(PLATFORM_CACHE_LINE_SIZE);
+
+	/** Holds the consumer's copy of Tail. */
+	uint32 CachedTail;
+};
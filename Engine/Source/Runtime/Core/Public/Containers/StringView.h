@@ -0,0 +1,445 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Misc/AssertionMacros.h"
+#include "Math/NumericLimits.h"
+#include "Math/SolidAngleMathUtility.h"
+#include "Containers/Array.h"
+#include "Containers/SolidAngleString.h"
+#include "Misc/Char.h"
+#include "Misc/CString.h"
+
+/**
+* A view of a range of characters owned by someone else: a pointer and a length.
+*
+* Cutting a view into pieces (Left, Mid, Split, TrimStartAndEnd, ParseIntoArray...) gives more views into the same
+* characters, so tokenizing a line or a command line needs no allocation at all. Unlike YString, a view is not null
+* terminated, so GetData() must not be passed to functions expecting a C string; ToString() makes a YString when one
+* is needed.
+*
+* Caution:
+*   Treat a view like a *reference* to the characters. DO NOT free or change the string while the view exists, and do not
+*   make a view of a temporary YString!
+*
+* Comparisons follow YString: operator== ignores case, Equals and Compare are case sensitive unless asked otherwise,
+* and Find, StartsWith, EndsWith and Split ignore case unless asked otherwise. Nothing starts or ends with an empty string.
+*/
+template<typename CharType>
+class TStringView
+{
+public:
+	using ElementType = CharType;
+
+	FORCEINLINE TStringView()
+		: DataPtr(nullptr)
+		, Size(0)
+	{
+	}
+
+	/** Views a null terminated string, without the terminator */
+	FORCEINLINE TStringView(const CharType* InData)
+		: DataPtr(InData)
+		, Size(InData ? TCString<CharType>::Strlen(InData) : 0)
+	{
+	}
+
+	FORCEINLINE TStringView(const CharType* InData, int32 InSize)
+		: DataPtr(InData)
+		, Size(InSize)
+	{
+		checkSlow(InSize >= 0 && (InData || !InSize));
+	}
+
+	/** Views the characters of a YString, the string must outlive the view */
+	FORCEINLINE TStringView(const YString& Str)
+		: DataPtr(*Str)
+		, Size(Str.Len())
+	{
+	}
+
+	/** @return the first character, which is not followed by a null terminator */
+	FORCEINLINE const CharType* GetData() const
+	{
+		return DataPtr;
+	}
+
+	FORCEINLINE int32 Len() const
+	{
+		return Size;
+	}
+
+	FORCEINLINE bool IsEmpty() const
+	{
+		return Size == 0;
+	}
+
+	FORCEINLINE bool IsValidIndex(int32 Index) const
+	{
+		return Index >= 0 && Index < Size;
+	}
+
+	FORCEINLINE const CharType& operator[](int32 Index) const
+	{
+		checkf(IsValidIndex(Index), TEXT("String view index out of bounds: Index %i from a view with a length of %i"), Index, Size);
+		return DataPtr[Index];
+	}
+
+	/** @return a YString holding a copy of the characters */
+	FORCEINLINE YString ToString() const
+	{
+		return Size ? YString(Size, DataPtr) : YString();
+	}
+
+	/** @return the leftmost Count characters */
+	FORCEINLINE TStringView Left(int32 Count) const
+	{
+		return TStringView(DataPtr, YMath::Clamp(Count, 0, Size));
+	}
+
+	/** @return all but the rightmost Count characters */
+	FORCEINLINE TStringView LeftChop(int32 Count) const
+	{
+		return TStringView(DataPtr, YMath::Clamp(Size - Count, 0, Size));
+	}
+
+	/** @return the rightmost Count characters */
+	FORCEINLINE TStringView Right(int32 Count) const
+	{
+		const int32 NewSize = YMath::Clamp(Count, 0, Size);
+		return TStringView(DataPtr + Size - NewSize, NewSize);
+	}
+
+	/** @return all but the leftmost Count characters */
+	FORCEINLINE TStringView RightChop(int32 Count) const
+	{
+		const int32 Start = YMath::Clamp(Count, 0, Size);
+		return TStringView(DataPtr + Start, Size - Start);
+	}
+
+	/** @return Count characters from Start, both clamped to the view (a negative Start counts as 0) */
+	FORCEINLINE TStringView Mid(int32 Start, int32 Count = MAX_int32) const
+	{
+		const int32 ClampedStart = YMath::Clamp(Start, 0, Size);
+		const int32 ClampedCount = YMath::Clamp(Count, 0, Size - ClampedStart);
+		return TStringView(DataPtr + ClampedStart, ClampedCount);
+	}
+
+	/** @return the view without its leading whitespace */
+	TStringView TrimStart() const
+	{
+		int32 Start = 0;
+		while (Start < Size && TChar<CharType>::IsWhitespace(DataPtr[Start]))
+		{
+			++Start;
+		}
+		return TStringView(DataPtr + Start, Size - Start);
+	}
+
+	/** @return the view without its trailing whitespace */
+	TStringView TrimEnd() const
+	{
+		int32 End = Size;
+		while (End > 0 && TChar<CharType>::IsWhitespace(DataPtr[End - 1]))
+		{
+			--End;
+		}
+		return TStringView(DataPtr, End);
+	}
+
+	/** @return the view without its leading and trailing whitespace */
+	FORCEINLINE TStringView TrimStartAndEnd() const
+	{
+		return TrimStart().TrimEnd();
+	}
+
+	/** @return the view without its wrapping quotation marks, following YString::TrimQuotes */
+	TStringView TrimQuotes(bool* bQuotesRemoved = nullptr) const
+	{
+		int32 Start = 0;
+		int32 Count = Size;
+		if (Size > 0 && DataPtr[0] == CharType('"'))
+		{
+			++Start;
+			--Count;
+		}
+		if (Size > 1 && DataPtr[Size - 1] == CharType('"'))
+		{
+			--Count;
+		}
+		if (bQuotesRemoved)
+		{
+			*bQuotesRemoved = Count != Size;
+		}
+		return TStringView(DataPtr + Start, Count);
+	}
+
+	/**
+	* Searches the view for a character
+	*
+	* @param InChar the character to search for
+	* @param Index out the position the character was found at, INDEX_NONE if return is false
+	* @return true if character was found in this view, otherwise false
+	*/
+	bool FindChar(CharType InChar, int32& Index) const
+	{
+		for (int32 CharIndex = 0; CharIndex < Size; ++CharIndex)
+		{
+			if (DataPtr[CharIndex] == InChar)
+			{
+				Index = CharIndex;
+				return true;
+			}
+		}
+		Index = INDEX_NONE;
+		return false;
+	}
+
+	/**
+	* Searches the view for the last occurrence of a character
+	*
+	* @param InChar the character to search for
+	* @param Index out the position the character was found at, INDEX_NONE if return is false
+	* @return true if character was found in this view, otherwise false
+	*/
+	bool FindLastChar(CharType InChar, int32& Index) const
+	{
+		for (int32 CharIndex = Size - 1; CharIndex >= 0; --CharIndex)
+		{
+			if (DataPtr[CharIndex] == InChar)
+			{
+				Index = CharIndex;
+				return true;
+			}
+		}
+		Index = INDEX_NONE;
+		return false;
+	}
+
+	/**
+	* Searches the view for a substring, and returns the index of the first (or last) instance found.
+	*
+	* @param SubStr			The string to search for
+	* @param SearchCase		Indicates whether the search is case sensitive or not ( defaults to ESearchCase::IgnoreCase )
+	* @param SearchDir			Indicates whether the search starts at the begining or at the end ( defaults to ESearchDir::FromStart )
+	* @param StartPosition		The start character position to search from, INDEX_NONE for the start (or end) of the view
+	* @return the index of the substring, INDEX_NONE if not found
+	*/
+	int32 Find(TStringView SubStr, ESearchCase::Type SearchCase = ESearchCase::IgnoreCase,
+		ESearchDir::Type SearchDir = ESearchDir::FromStart, int32 StartPosition = INDEX_NONE) const
+	{
+		const int32 LastStart = Size - SubStr.Size;
+		if (SearchDir == ESearchDir::FromStart)
+		{
+			for (int32 Start = StartPosition == INDEX_NONE ? 0 : YMath::Max(StartPosition, 0); Start <= LastStart; ++Start)
+			{
+				if (RangeEquals(DataPtr + Start, SubStr.DataPtr, SubStr.Size, SearchCase))
+				{
+					return Start;
+				}
+			}
+		}
+		else
+		{
+			// like YString, a match must end before StartPosition
+			const int32 FirstStart = StartPosition == INDEX_NONE ? LastStart : YMath::Min(StartPosition - SubStr.Size, LastStart);
+			for (int32 Start = FirstStart; Start >= 0; --Start)
+			{
+				if (RangeEquals(DataPtr + Start, SubStr.DataPtr, SubStr.Size, SearchCase))
+				{
+					return Start;
+				}
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	FORCEINLINE bool Contains(TStringView SubStr, ESearchCase::Type SearchCase = ESearchCase::IgnoreCase) const
+	{
+		return Find(SubStr, SearchCase) != INDEX_NONE;
+	}
+
+	FORCEINLINE bool StartsWith(TStringView Prefix, ESearchCase::Type SearchCase = ESearchCase::IgnoreCase) const
+	{
+		return Prefix.Size > 0 && Prefix.Size <= Size && RangeEquals(DataPtr, Prefix.DataPtr, Prefix.Size, SearchCase);
+	}
+
+	FORCEINLINE bool EndsWith(TStringView Suffix, ESearchCase::Type SearchCase = ESearchCase::IgnoreCase) const
+	{
+		return Suffix.Size > 0 && Suffix.Size <= Size && RangeEquals(DataPtr + Size - Suffix.Size, Suffix.DataPtr, Suffix.Size, SearchCase);
+	}
+
+	FORCEINLINE bool Equals(TStringView Other, ESearchCase::Type SearchCase = ESearchCase::CaseSensitive) const
+	{
+		return Size == Other.Size && RangeEquals(DataPtr, Other.DataPtr, Size, SearchCase);
+	}
+
+	/**
+	* Lexicographically tests how this view compares to the Other given string
+	*
+	* @return 0 if equal, negative if less than, positive if greater than
+	*/
+	int32 Compare(TStringView Other, ESearchCase::Type SearchCase = ESearchCase::CaseSensitive) const
+	{
+		const int32 MinSize = YMath::Min(Size, Other.Size);
+		for (int32 Index = 0; Index < MinSize; ++Index)
+		{
+			const int32 Diff = SearchCase == ESearchCase::CaseSensitive
+				? int32(DataPtr[Index]) - int32(Other.DataPtr[Index])
+				: int32(TChar<CharType>::ToLower(DataPtr[Index])) - int32(TChar<CharType>::ToLower(Other.DataPtr[Index]));
+			if (Diff)
+			{
+				return Diff;
+			}
+		}
+		return Size - Other.Size;
+	}
+
+	/** Case insensitive, like YString */
+	FORCEINLINE friend bool operator==(TStringView Lhs, TStringView Rhs)
+	{
+		return Lhs.Equals(Rhs, ESearchCase::IgnoreCase);
+	}
+
+	FORCEINLINE friend bool operator!=(TStringView Lhs, TStringView Rhs)
+	{
+		return !Lhs.Equals(Rhs, ESearchCase::IgnoreCase);
+	}
+
+	/**
+	* Splits this view at the first (or last) occurrence of InS.
+	*
+	* @param InS The string to search and split at
+	* @param LeftS out the view to the left of InS, not updated if return is false
+	* @param RightS out the view to the right of InS, not updated if return is false
+	* @return true if the view is split, otherwise false
+	*/
+	bool Split(TStringView InS, TStringView* LeftS, TStringView* RightS, ESearchCase::Type SearchCase = ESearchCase::IgnoreCase,
+		ESearchDir::Type SearchDir = ESearchDir::FromStart) const
+	{
+		const int32 InPos = Find(InS, SearchCase, SearchDir);
+		if (InPos < 0)
+		{
+			return false;
+		}
+
+		if (LeftS)
+		{
+			*LeftS = Left(InPos);
+		}
+		if (RightS)
+		{
+			*RightS = RightChop(InPos + InS.Size);
+		}
+		return true;
+	}
+
+	/**
+	* Breaks up the view into views of the pieces between the delimiters, like YString::ParseIntoArray.
+	*
+	* @param OutArray		The array to fill with the pieces, emptied first
+	* @param Delim			The string to delimit on, case sensitive
+	* @param bCullEmpty	If true, empty pieces are not added to the array
+	* @return the number of pieces in OutArray
+	*/
+	template<typename Allocator>
+	int32 ParseIntoArray(TArray<TStringView, Allocator>& OutArray, TStringView Delim, bool bCullEmpty = true) const
+	{
+		OutArray.Reset();
+		if (Size == 0 || Delim.Size == 0)
+		{
+			return 0;
+		}
+
+		int32 Start = 0;
+		for (int32 Index = 0; Index <= Size - Delim.Size;)
+		{
+			if (RangeEquals(DataPtr + Index, Delim.DataPtr, Delim.Size, ESearchCase::CaseSensitive))
+			{
+				if (Index > Start || !bCullEmpty)
+				{
+					OutArray.Add(TStringView(DataPtr + Start, Index - Start));
+				}
+				Index += Delim.Size;
+				Start = Index;
+			}
+			else
+			{
+				++Index;
+			}
+		}
+		if (Size > Start || !bCullEmpty)
+		{
+			OutArray.Add(TStringView(DataPtr + Start, Size - Start));
+		}
+		return OutArray.Num();
+	}
+
+public:
+	/** DO NOT USE DIRECTLY
+	* STL-like iterators to enable range-based for loop support.
+	*/
+	FORCEINLINE friend const CharType* begin(TStringView View) { return View.DataPtr; }
+	FORCEINLINE friend const CharType* end(TStringView View) { return View.DataPtr + View.Size; }
+
+private:
+	static bool RangeEquals(const CharType* A, const CharType* B, int32 Count, ESearchCase::Type SearchCase)
+	{
+		if (SearchCase == ESearchCase::CaseSensitive)
+		{
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				if (A[Index] != B[Index])
+				{
+					return false;
+				}
+			}
+		}
+		else
+		{
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				if (A[Index] != B[Index] && TChar<CharType>::ToLower(A[Index]) != TChar<CharType>::ToLower(B[Index]))
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	/** Holds the first character */
+	const CharType* DataPtr;
+
+	/** Holds the number of characters */
+	int32 Size;
+};
+
+template<typename CharType> struct TIsPODType<TStringView<CharType>> { enum { Value = true }; };
+
+typedef TStringView<TCHAR> YStringView;
+
+namespace Lex
+{
+	/**
+	* Parses a number out of a view, which does not need to be null terminated, with the same rules as
+	* TryParseString(T&, const TCHAR*). Numbers longer than 63 characters are rejected.
+	*/
+	template<typename T>
+	typename TEnableIf<TIsArithmetic<T>::Value, bool>::Type
+		TryParseString(T& OutValue, YStringView Buffer)
+	{
+		TCHAR Terminated[64];
+		if (Buffer.Len() >= ARRAY_COUNT(Terminated))
+		{
+			return false;
+		}
+		if (Buffer.Len())
+		{
+			YMemory::Memcpy(Terminated, Buffer.GetData(), Buffer.Len() * sizeof(TCHAR));
+		}
+		Terminated[Buffer.Len()] = 0;
+		return TryParseString(OutValue, (const TCHAR*)Terminated);
+	}
+}
@@ -8,6 +8,7 @@
 #include "Templates/SolidAngleTypeTraits.h"
 #include "Templates/TypeCompatibleBytes.h"
 #include "Templates/SolidAngleTemplate.h"
+#include "Templates/TypeHash.h"
 #include "Logging/LogMacros.h"
 
 
@@ -219,7 +220,7 @@ public:
 	/** Hash function. */
 	friend uint32 GetTypeHash(const TUnion& Union)
 	{
-		uint32 Result = GetTypeHash(Union.CurrentSubtypeIndex);
+		uint32 Result = ::GetTypeHash(Union.CurrentSubtypeIndex);
 
 		switch (Union.CurrentSubtypeIndex)
 		{
@@ -19,6 +19,7 @@ The types declared in this file are for internal use only.
 #include "SObject/NameTypes.h"
 
 class FDelegateBase;
+class UFunction;
 class FDelegateHandle;
 enum class ESPMode;
 
@@ -170,8 +171,7 @@ public:
 public:
 
 	// Holds the cached UFunction to call.
-	//!!FIXME by zyx
-	//UFunction* CachedFunction;
+	UFunction* CachedFunction;
 
 	// Holds the name of the function to call.
 	YName FunctionName;
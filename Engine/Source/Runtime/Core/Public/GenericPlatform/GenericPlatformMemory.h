@@ -276,6 +276,56 @@ struct CORE_API YGenericPlatformMemory
 	*/
 	static void					BinnedFreeToOS(void* Ptr, SIZE_T Size);
 
+	/**
+	* Tries to grow pages allocated by BinnedAllocFromOS without moving them, by mapping the address range right after them.
+	* Fails when that range is taken or the platform cannot extend a mapping; the allocation is left untouched then.
+	*
+	* @param Ptr A pointer previously returned from BinnedAllocFromOS
+	* @param OldSize Current size of the allocation, aligned to OsAllocationGranularity
+	* @param NewSize Size to grow to, aligned to OsAllocationGranularity
+	*
+	* @return true if the pages now span NewSize bytes and must be freed with that size
+	*/
+	static bool					BinnedTryExtendInPlace(void* Ptr, SIZE_T OldSize, SIZE_T NewSize);
+
+	/** Size of the huge (large) pages HugePageAllocFromOS hands out. */
+	static SIZE_T				GetHugePageSize();
+
+	/**
+	* Allocates a region that the OS should back with huge pages, for allocators that carve their pages out of it.
+	*
+	* @param Size Size to allocate, a multiple of GetHugePageSize()
+	* @param bOutHugePages Set to true if the OS accepted the huge page request, false if the region uses regular pages
+	*
+	* @return OS allocated pointer aligned to GetHugePageSize() where supported and to PageSize otherwise
+	*/
+	static void*				HugePageAllocFromOS(SIZE_T Size, bool& bOutHugePages);
+
+	/**
+	* Returns a region allocated by HugePageAllocFromOS to the OS.
+	*
+	* @param A pointer previously returned from HugePageAllocFromOS
+	* @param Size size of the allocation previously passed to HugePageAllocFromOS
+	*/
+	static void					HugePageFreeToOS(void* Ptr, SIZE_T Size);
+
+	/** Number of NUMA nodes in the machine, 1 where the platform doesn't expose the topology. Node indices are 0 to GetNumaNodeCount() - 1. */
+	static uint32				GetNumaNodeCount();
+
+	/** NUMA node of the core the calling thread is running on right now. */
+	static uint32				GetCurrentNumaNode();
+
+	/**
+	* Allocates pages from the OS like BinnedAllocFromOS, asking for them to be placed on a NUMA node.
+	* The placement is a preference, the OS falls back to other nodes when that one is out of memory.
+	*
+	* @param Size Size to allocate, not necessarily aligned
+	* @param Node NUMA node the pages should live on
+	*
+	* @return OS allocated pointer to be freed with BinnedFreeToOS
+	*/
+	static void*				NumaAllocFromOS(SIZE_T Size, uint32 Node);
+
 	// These alloc/free memory that is mapped to the GPU
 	// Only for platforms with UMA (XB1/PS4/etc)
 	static void*				GPUMalloc(SIZE_T Count, uint32 Alignment = 0) { return nullptr; };
@@ -184,6 +184,22 @@ struct CORE_API FSHA256Signature
 	YString ToString() const;
 };
 
+/**
+* Where a logical processor sits in the machine, as returned by GetProcessorTopology.
+* Apart from LogicalId, the ids are dense and start at 0.
+*/
+struct FProcessorTopology
+{
+	/** Id of the processor in the platform affinity masks */
+	int32 LogicalId;
+	/** Physical core, shared by the SMT siblings of the processor */
+	int32 CoreId;
+	/** Group of cores sharing the last level cache */
+	int32 CacheDomainId;
+	/** NUMA node */
+	int32 NodeId;
+};
+
 /**
 * Generic implementation for most platforms
 **/
@@ -660,6 +676,14 @@ public:
 	*/
 	static int32 NumberOfCoresIncludingHyperthreads();
 
+	/**
+	* Describes the logical processors this process may run on. The generic version only knows the core counts, so it
+	* assumes SMT siblings are numbered next to each other and puts everything in one cache domain and node.
+	*
+	* @param OutProcessors receives one entry per logical processor, sorted by node, cache domain, core and logical id
+	*/
+	static void GetProcessorTopology(TArray<FProcessorTopology>& OutProcessors);
+
 	/**
 	* Return the number of worker threads we should spawn, based on number of cores
 	*/
@@ -2,6 +2,8 @@
 
 #include "CoreTypes.h"
 
+struct YHugePageOSAllocator;
+
 struct YCachedOSPageAllocator
 {
 protected:
@@ -17,9 +19,11 @@ protected:
 		}
 	};
 
-	void* AllocateImpl(SIZE_T Size, FFreePageBlock* First, FFreePageBlock* Last, uint32& FreedPageBlocksNum, uint32& CachedTotal);
-	void FreeImpl(void* Ptr, SIZE_T Size, uint32 NumCacheBlocks, uint32 CachedByteLimit, FFreePageBlock* First, uint32& FreedPageBlocksNum, uint32& CachedTotal);
-	void FreeAllImpl(FFreePageBlock* First, uint32& FreedPageBlocksNum, uint32& CachedTotal);
+	// PageSource is optional, when null pages come straight from YPlatformMemory::BinnedAllocFromOS, or NumaAllocFromOS if NumaNode isn't INDEX_NONE
+	// OutActualSize is optional, when null only cached blocks of exactly Size bytes are reused
+	void* AllocateImpl(SIZE_T Size, SIZE_T* OutActualSize, FFreePageBlock* First, FFreePageBlock* Last, uint32& FreedPageBlocksNum, uint32& CachedTotal, YHugePageOSAllocator* PageSource, int32 NumaNode);
+	void FreeImpl(void* Ptr, SIZE_T Size, uint32 NumCacheBlocks, uint32 CachedByteLimit, FFreePageBlock* First, uint32& FreedPageBlocksNum, uint32& CachedTotal, YHugePageOSAllocator* PageSource);
+	void FreeAllImpl(FFreePageBlock* First, uint32& FreedPageBlocksNum, uint32& CachedTotal, YHugePageOSAllocator* PageSource);
 };
 
 template <uint32 NumCacheBlocks, uint32 CachedByteLimit>
@@ -28,25 +32,61 @@ struct TCachedOSPageAllocator : private YCachedOSPageAllocator
 	TCachedOSPageAllocator()
 		: FreedPageBlocksNum(0)
 		, CachedTotal(0)
+		, PageSource(nullptr)
+		, NumaNode(INDEX_NONE)
 	{
 	}
 
-	FORCEINLINE void* Allocate(SIZE_T Size)
+	/**
+	* Allocates Size bytes of pages, from the cache if possible.
+	*
+	* Blocks must be freed with the size they really have, as unmapping them and the huge page source both rely on it.
+	* Callers that can store that size pass OutActualSize, and may get a cached block up to a third larger than Size.
+	* Without OutActualSize only a cached block of exactly Size bytes is reused.
+	*/
+	FORCEINLINE void* Allocate(SIZE_T Size, SIZE_T* OutActualSize = nullptr)
 	{
-		return AllocateImpl(Size, FreedPageBlocks, FreedPageBlocks + FreedPageBlocksNum, FreedPageBlocksNum, CachedTotal);
+		return AllocateImpl(Size, OutActualSize, FreedPageBlocks, FreedPageBlocks + FreedPageBlocksNum, FreedPageBlocksNum, CachedTotal, PageSource, NumaNode);
 	}
 
 	void Free(void* Ptr, SIZE_T Size)
 	{
-		return FreeImpl(Ptr, Size, NumCacheBlocks, CachedByteLimit, FreedPageBlocks, FreedPageBlocksNum, CachedTotal);
+		return FreeImpl(Ptr, Size, NumCacheBlocks, CachedByteLimit, FreedPageBlocks, FreedPageBlocksNum, CachedTotal, PageSource);
 	}
 	void FreeAll()
 	{
-		return FreeAllImpl(FreedPageBlocks, FreedPageBlocksNum, CachedTotal);
+		return FreeAllImpl(FreedPageBlocks, FreedPageBlocksNum, CachedTotal, PageSource);
+	}
+
+	/** Routes cache misses through InPageSource instead of the OS. Only valid while the cache is empty. */
+	void SetPageSource(YHugePageOSAllocator* InPageSource)
+	{
+		FreeAll();
+		PageSource = InPageSource;
+	}
+
+	/** @return true if cache misses are served by a page source rather than straight from the OS */
+	bool HasPageSource() const
+	{
+		return PageSource != nullptr;
+	}
+
+	/** Places the pages of cache misses on a NUMA node, see YPlatformMemory::NumaAllocFromOS. Ignored when there is a page source. */
+	void SetNumaNode(int32 InNumaNode)
+	{
+		FreeAll();
+		NumaNode = InNumaNode;
+	}
+
+	uint32 GetCachedTotal() const
+	{
+		return CachedTotal;
 	}
 
 private:
 	FFreePageBlock FreedPageBlocks[NumCacheBlocks];
 	uint32         FreedPageBlocksNum;
 	uint32         CachedTotal;
+	YHugePageOSAllocator* PageSource;
+	int32          NumaNode;
 };
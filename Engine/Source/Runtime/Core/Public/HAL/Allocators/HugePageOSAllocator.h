@@ -0,0 +1,95 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+
+/** Maximum number of huge page regions tracked at once, anything beyond that goes straight to the OS. */
+#define HUGEPAGE_MAX_REGIONS (1024)
+
+/**
+ * Page source that reserves large regions from the OS (see YPlatformMemory::HugePageAllocFromOS) and carves
+ * fixed size chunks out of them, so that the binned allocators' pools share a handful of huge TLB entries.
+ * Requests that don't fit into a region are forwarded to BinnedAllocFromOS.
+ *
+ * Not thread safe, the owner is expected to serialize access (YMallocBinned2 calls it under its mutex).
+ */
+struct CORE_API YHugePageOSAllocator
+{
+	/** Huge page coverage counters. */
+	struct FStats
+	{
+		/** Number of regions currently reserved from the OS. */
+		uint32 NumRegions;
+		/** Bytes reserved in regions. */
+		SIZE_T RegionBytes;
+		/** Bytes reserved in regions the OS agreed to back with huge pages. */
+		SIZE_T HugePageBytes;
+		/** Bytes currently handed out from regions. */
+		SIZE_T CarvedBytes;
+		/** Bytes currently handed out directly from BinnedAllocFromOS. */
+		SIZE_T FallbackBytes;
+
+		FStats()
+			: NumRegions(0)
+			, RegionBytes(0)
+			, HugePageBytes(0)
+			, CarvedBytes(0)
+			, FallbackBytes(0)
+		{
+		}
+	};
+
+	YHugePageOSAllocator()
+		: ChunkSize(0)
+		, RegionSize(0)
+		, ChunksPerRegion(0)
+		, NumRegions(0)
+	{
+	}
+
+	/**
+	 * Enables carving. Must be called before the first allocation.
+	 *
+	 * @param InChunkSize granularity and alignment of the chunks handed out, must divide the OS huge page size
+	 * @return false if the platform's huge page size can't be split into InChunkSize chunks, in which case everything goes to the OS
+	 */
+	bool Init(SIZE_T InChunkSize);
+
+	FORCEINLINE bool IsEnabled() const
+	{
+		return ChunkSize != 0;
+	}
+
+	void* Allocate(SIZE_T Size);
+	void Free(void* Ptr, SIZE_T Size);
+
+	FORCEINLINE const FStats& GetStats() const
+	{
+		return Stats;
+	}
+
+private:
+	struct FRegion
+	{
+		uint8* Base;
+		/** One bit per chunk, set when the chunk is free. */
+		uint64 FreeMask;
+		uint32 NumFreeChunks;
+		bool   bHugePages;
+	};
+
+	/** Returns the index of the region containing Ptr, or INDEX_NONE. */
+	int32 FindRegion(const void* Ptr) const;
+	int32 AddRegion();
+	void RemoveRegion(int32 Index);
+
+	SIZE_T ChunkSize;
+	SIZE_T RegionSize;
+	uint32 ChunksPerRegion;
+	uint32 NumRegions;
+	FStats Stats;
+
+	/** Regions sorted by base address. */
+	FRegion Regions[HUGEPAGE_MAX_REGIONS];
+};
@@ -20,6 +20,10 @@
 #include "mach/mach.h"
 #endif
 
+#if PLATFORM_LINUX
+#include <malloc.h>
+#endif
+
 
 //
 // ANSI C memory allocator.
@@ -78,7 +82,11 @@ public:
 			Result = nullptr;
 		}
 #else
-		if (Ptr && NewSize)
+		if (Ptr && NewSize && TryReallocInPlace(Ptr, NewSize, Alignment))
+		{
+			Result = Ptr;
+		}
+		else if (Ptr && NewSize)
 		{
 			// Can't use realloc as it might screw with alignment.
 			Result = Malloc(NewSize, Alignment);
@@ -118,6 +126,31 @@ public:
 #endif
 	}
 
+#if !USE_ALIGNED_MALLOC
+	virtual bool TryReallocInPlace(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		// Only grows, a shrink goes through Realloc so that the tail is given back
+		SIZE_T& Size = *((SIZE_T*)((uint8*)Ptr - sizeof(void*) - sizeof(SIZE_T)));
+		if (NewSize < Size || !IsAligned(Ptr, YMath::Max(NewSize >= 16 ? (uint32)16 : (uint32)8, Alignment)))
+		{
+			return false;
+		}
+#if PLATFORM_LINUX
+		// The block malloc handed out is usually a bit larger than what was asked for
+		void* RawPtr = *((void**)((uint8*)Ptr - sizeof(void*)));
+		const SIZE_T Usable = malloc_usable_size(RawPtr) - ((uint8*)Ptr - (uint8*)RawPtr);
+#else
+		const SIZE_T Usable = Size;
+#endif
+		if (NewSize > Usable)
+		{
+			return false;
+		}
+		Size = NewSize;
+		return true;
+	}
+#endif
+
 	virtual bool GetAllocationSize(void *Original, SIZE_T &SizeOut) override
 	{
 		if (!Original)
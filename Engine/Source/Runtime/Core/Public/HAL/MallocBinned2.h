@@ -9,7 +9,10 @@
 #include "HAL/CriticalSection.h"
 #include "HAL/PlatformTLS.h"
 #include "HAL/Allocators/CachedOSPageAllocator.h"
+#include "HAL/Allocators/HugePageOSAllocator.h"
 #include "HAL/PlatformMath.h"
+#include "HAL/PlatformAtomics.h"
+#include "Containers/ContainersFwd.h"
 
 #define BINNED2_MAX_CACHED_OS_FREES (64)
 #if PLATFORM_64BITS
@@ -18,11 +21,28 @@
 #define BINNED2_MAX_CACHED_OS_FREES_BYTE_LIMIT (16*1024*1024)
 #endif
 
+// Default for carving pools out of 2MB huge page regions, can be turned on with -hugepages
+#ifndef BINNED2_USE_HUGE_PAGES
+#define BINNED2_USE_HUGE_PAGES (0)
+#endif
+
+// Default for keeping small pools on the NUMA node of the threads that use them, can be turned on with -numa
+#ifndef BINNED2_USE_NUMA
+#define BINNED2_USE_NUMA (0)
+#endif
+#define BINNED2_MAX_NUMA_NODES (4)	// Threads on higher nodes share the tables of node (Node % BINNED2_MAX_NUMA_NODES)
+
+// Per pool and per thread cache counters, see YMallocBinned2::GetPoolCounters
+#ifndef BINNED2_ALLOCATOR_STATS
+#define BINNED2_ALLOCATOR_STATS (!UE_BUILD_SHIPPING)
+#endif
+
 #define BINNED2_LARGE_ALLOC					65536		// Alignment of OS-allocated pointer - pool-allocated pointers will have a non-aligned pointer
 #define BINNED2_MINIMUM_ALIGNMENT_SHIFT		4			// Alignment of blocks, expressed as a shift
 #define BINNED2_MINIMUM_ALIGNMENT			16			// Alignment of blocks
 #define BINNED2_MAX_SMALL_POOL_SIZE			(32768-16)	// Maximum block size in GMallocBinned2SmallBlockSizes
 #define BINNED2_SMALL_POOL_COUNT			45
+#define BINNED2_SIZE_BUCKET_COUNT			(1 + (BINNED2_MAX_SMALL_POOL_SIZE >> BINNED2_MINIMUM_ALIGNMENT_SHIFT))	// Small sizes rounded up to BINNED2_MINIMUM_ALIGNMENT
 
 
 #define DEFAULT_GMallocBinned2PerThreadCaches 1
@@ -31,6 +51,8 @@
 #define DEFAULT_GMallocBinned2BundleCount 64
 #define DEFAULT_GMallocBinned2AllocExtra 32
 #define BINNED2_MAX_GMallocBinned2MaxBundlesBeforeRecycle 8
+#define DEFAULT_GMallocBinned2RemoteFrees 0
+#define BINNED2_MAX_REMOTE_FREE_BUNDLES 16			// Full bundles a thread cache accepts from other threads, per pool
 
 #define BINNED2_ALLOW_RUNTIME_TWEAKING 0
 #if BINNED2_ALLOW_RUNTIME_TWEAKING
@@ -47,6 +69,14 @@ extern CORE_API int32 GMallocBinned2AllocExtra = DEFAULT_GMallocBinned2AllocExtr
 #define GMallocBinned2AllocExtra DEFAULT_GMallocBinned2AllocExtra
 #endif
 
+// When non-zero, full bundles freed by one thread are handed to the thread that last refilled that pool, see FRemoteFreeList
+extern CORE_API int32 GMallocBinned2RemoteFrees;
+
+#if BINNED2_ALLOCATOR_STATS
+// When non-zero, small requests are counted per size bucket, see YMallocBinned2::ComputeSmallBlockSizes
+extern CORE_API int32 GMallocBinned2CaptureSizeProfile;
+#endif
+
 
 
 //
@@ -56,6 +86,90 @@ class CORE_API YMallocBinned2 final : public YMalloc
 {
 	struct Private;
 
+public:
+#if BINNED2_ALLOCATOR_STATS
+	/**
+	 * Counters for one small pool, either for a single thread cache or summed over all of them.
+	 * Thread caches update their counters without synchronization, so readers get approximate values.
+	 */
+	struct FPoolCounters
+	{
+		/** Blocks handed out by thread caches. */
+		uint64 CacheAllocs;
+		/** Blocks pushed into thread caches, by frees and by refills from the pool. */
+		uint64 CachePushes;
+		/** Full bundles passed to the global recycler. */
+		uint64 BundlesRecycled;
+		/** Full bundles returned to the pool because the global recycler was full. */
+		uint64 BundlesFreed;
+		/** Partial bundles taken from the global recycler. */
+		uint64 BundlesObtained;
+		/** Blocks currently sitting in thread caches. This is a snapshot, not a running counter. */
+		uint64 CachedBlocks;
+		/** Blocks taken from the pool under the allocator lock. Pool only. */
+		uint64 PoolAllocs;
+		/** Blocks returned to the pool under the allocator lock. Pool only. */
+		uint64 PoolFrees;
+		/** Pages requested from the OS for this pool. Pool only. */
+		uint64 OSCommits;
+		/** Pages given back to the OS by this pool. Pool only. */
+		uint64 OSFrees;
+		/** Full bundles handed to the remote free list of another thread. */
+		uint64 RemoteBundlesPushed;
+		/** Bundles taken from this thread's remote free list. */
+		uint64 RemoteBundlesPopped;
+		/** Blocks handed to thread caches that were running on another NUMA node than their home node at the time. Pool only. */
+		uint64 RemoteNodeAllocs;
+		/** Blocks freed by a thread whose home NUMA node isn't the one the block lives on, sent back to their node. */
+		uint64 ForeignNodeFrees;
+
+		FPoolCounters()
+			: CacheAllocs(0)
+			, CachePushes(0)
+			, BundlesRecycled(0)
+			, BundlesFreed(0)
+			, BundlesObtained(0)
+			, CachedBlocks(0)
+			, PoolAllocs(0)
+			, PoolFrees(0)
+			, OSCommits(0)
+			, OSFrees(0)
+			, RemoteBundlesPushed(0)
+			, RemoteBundlesPopped(0)
+			, RemoteNodeAllocs(0)
+			, ForeignNodeFrees(0)
+		{
+		}
+
+		void Accumulate(const FPoolCounters& Other)
+		{
+			CacheAllocs     += Other.CacheAllocs;
+			CachePushes     += Other.CachePushes;
+			BundlesRecycled += Other.BundlesRecycled;
+			BundlesFreed    += Other.BundlesFreed;
+			BundlesObtained += Other.BundlesObtained;
+			CachedBlocks    += Other.CachedBlocks;
+			PoolAllocs      += Other.PoolAllocs;
+			PoolFrees       += Other.PoolFrees;
+			OSCommits       += Other.OSCommits;
+			OSFrees         += Other.OSFrees;
+			RemoteBundlesPushed += Other.RemoteBundlesPushed;
+			RemoteBundlesPopped += Other.RemoteBundlesPopped;
+			RemoteNodeAllocs    += Other.RemoteNodeAllocs;
+			ForeignNodeFrees    += Other.ForeignNodeFrees;
+		}
+	};
+
+	/** Counters of one thread cache. */
+	struct FThreadCounters
+	{
+		uint32 ThreadId;
+		FPoolCounters Pools[BINNED2_SMALL_POOL_COUNT];
+	};
+#endif
+
+private:
+
 // Forward declares.
 struct FPoolInfo;
 struct PoolHashBucket;
@@ -72,9 +186,10 @@ struct FFreeBlock
 		: BlockSize(InBlockSize)
 		, PoolIndex(InPoolIndex)
 		, Canary(CANARY_VALUE)
+		, NumaNode(0)
 		, NextFreeBlock(nullptr)
 	{
-		check(InPoolIndex < MAX_uint8 && InBlockSize <= MAX_uint16);
+		check(InPoolIndex < MAX_uint8 && InBlockSize <= MAX_uint16 && InPageSize / InBlockSize <= MAX_uint16);
 		NumFreeBlocks = InPageSize / InBlockSize;
 		if (NumFreeBlocks * InBlockSize + BINNED2_MINIMUM_ALIGNMENT > InPageSize)
 		{
@@ -115,7 +230,9 @@ struct FFreeBlock
 	uint16 BlockSize;				// Size of the blocks that this list points to
 	uint8 PoolIndex;				// Index of this pool
 	uint8 Canary;					// Constant value of 0xe3
-	uint32 NumFreeBlocks;          // Number of consecutive free blocks here, at least 1.
+	uint16 NumFreeBlocks;          // Number of consecutive free blocks here, at least 1.
+	uint8  NumaNode;               // Pool header only: NUMA node the pages of this pool were placed on
+	uint8  Padding;
 	void*  NextFreeBlock;          // Next free block in another pool
 };
 
@@ -130,7 +247,7 @@ struct FPoolList
 
 	void LinkToFront(FPoolInfo* Pool);
 
-	FPoolInfo& PushNewPoolToFront(YMallocBinned2& Allocator, uint32 InBytes, uint32 InPoolIndex);
+	FPoolInfo& PushNewPoolToFront(YMallocBinned2& Allocator, uint32 InBytes, uint32 InPoolIndex, uint32 InNumaNode);
 
 	void ValidateActivePools();
 	void ValidateExhaustedPools();
@@ -145,6 +262,9 @@ struct FPoolTable
 	FPoolList ActivePools;
 	FPoolList ExhaustedPools;
 	uint32    BlockSize;
+#if BINNED2_ALLOCATOR_STATS
+	FPoolCounters Counters;
+#endif
 
 	FPoolTable();
 };
@@ -201,14 +321,34 @@ private:
 
 FPtrToPoolMapping PtrToPoolMapping;
 
-// Pool tables for different pool sizes
-FPoolTable SmallPoolTables[BINNED2_SMALL_POOL_COUNT];
+// Pool tables for different pool sizes, one set per NUMA node. Only the first is used unless bNumaAware.
+FPoolTable SmallPoolTables[BINNED2_MAX_NUMA_NODES][BINNED2_SMALL_POOL_COUNT];
 
 PoolHashBucket* HashBuckets;
 PoolHashBucket* HashBucketFreeList;
 uint64 NumPoolsPerPage;
 
-TCachedOSPageAllocator<BINNED2_MAX_CACHED_OS_FREES, BINNED2_MAX_CACHED_OS_FREES_BYTE_LIMIT> CachedOSPageAllocator;
+typedef TCachedOSPageAllocator<BINNED2_MAX_CACHED_OS_FREES, BINNED2_MAX_CACHED_OS_FREES_BYTE_LIMIT> FCachedPageAllocator;
+FCachedPageAllocator CachedOSPageAllocator;
+
+// Small pool pages of each NUMA node when bNumaAware, everything else uses CachedOSPageAllocator
+FCachedPageAllocator NodePageAllocators[BINNED2_MAX_NUMA_NODES];
+bool bNumaAware;
+uint32 NumNumaNodes;
+
+FORCEINLINE FCachedPageAllocator& GetPoolPageAllocator(uint32 InNumaNode)
+{
+	return bNumaAware ? NodePageAllocators[InNumaNode] : CachedOSPageAllocator;
+}
+
+// Node whose pool tables the calling thread should use
+FORCEINLINE uint32 GetCurrentNumaNode() const
+{
+	return bNumaAware ? YPlatformMemory::GetCurrentNumaNode() % NumNumaNodes : 0;
+}
+
+// Page source behind CachedOSPageAllocator when huge pages are enabled
+YHugePageOSAllocator HugePageOSAllocator;
 
 FCriticalSection Mutex;
 
@@ -262,6 +402,105 @@ struct FBundle
 };
 static_assert(sizeof(FBundleNode) <= BINNED2_MINIMUM_ALIGNMENT, "Bundle nodes must fit into the smallest block size");
 
+/**
+ * Full bundles freed by other threads, waiting for the thread cache that owns this list to allocate from them again.
+ * Any thread can push, only the owning thread pops, so popping a single bundle can't run into ABA.
+ * Bundles are chained through NextBundle, which overlaps their Count, so the owner has to recount them.
+ */
+struct FRemoteFreeList
+{
+	FORCEINLINE FRemoteFreeList()
+		: Head(nullptr)
+		, NumBundles(0)
+	{
+	}
+
+	// return true if the bundle was queued, false if the list is full or its owner has gone away
+	bool Push(FBundleNode* InBundle)
+	{
+		if (NumBundles >= BINNED2_MAX_REMOTE_FREE_BUNDLES)
+		{
+			return false;
+		}
+		while (true)
+		{
+			FBundleNode* OldHead = Head;
+			if (OldHead == ClosedHead())
+			{
+				return false;
+			}
+			InBundle->NextBundle = OldHead;
+			if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&Head, InBundle, OldHead) == OldHead)
+			{
+				FPlatformAtomics::InterlockedIncrement(&NumBundles);
+				return true;
+			}
+		}
+	}
+
+	// owner only
+	FBundleNode* Pop()
+	{
+		while (true)
+		{
+			FBundleNode* OldHead = Head;
+			if (!OldHead || OldHead == ClosedHead())
+			{
+				return nullptr;
+			}
+			if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&Head, OldHead->NextBundle, OldHead) == OldHead)
+			{
+				FPlatformAtomics::InterlockedDecrement(&NumBundles);
+				OldHead->NextBundle = nullptr;
+				return OldHead;
+			}
+		}
+	}
+
+	// owner only, returns every queued bundle chained through NextBundle
+	FBundleNode* PopAll()
+	{
+		if (!Head || Head == ClosedHead())
+		{
+			return nullptr;
+		}
+		return TakeAll(nullptr);
+	}
+
+	// owner only, refuses all further pushes and returns what was queued
+	FBundleNode* Close()
+	{
+		return TakeAll(ClosedHead());
+	}
+
+private:
+	static FORCEINLINE FBundleNode* ClosedHead()
+	{
+		return (FBundleNode*)UPTRINT(1);
+	}
+
+	FBundleNode* TakeAll(FBundleNode* NewHead)
+	{
+		FBundleNode* Result = (FBundleNode*)FPlatformAtomics::InterlockedExchangePtr((void**)&Head, NewHead);
+		if (Result == ClosedHead())
+		{
+			return nullptr;
+		}
+		int32 Count = 0;
+		for (FBundleNode* Bundle = Result; Bundle; Bundle = Bundle->NextBundle)
+		{
+			++Count;
+		}
+		FPlatformAtomics::InterlockedAdd(&NumBundles, -Count);
+		return Result;
+	}
+
+	FBundleNode* volatile Head;
+	volatile int32 NumBundles;
+	uint8 Padding[PLATFORM_CACHE_LINE_SIZE - sizeof(FBundleNode*) - sizeof(int32)];
+};
+static_assert(sizeof(FRemoteFreeList) == PLATFORM_CACHE_LINE_SIZE, "FRemoteFreeList should be the same size as a cache line");
+
 struct FFreeBlockList
 {
 	// return true if we actually pushed it
@@ -279,6 +518,9 @@ struct FFreeBlockList
 			PartialBundle.Reset();
 		}
 		PartialBundle.PushHead((FBundleNode*)InPtr);
+#if BINNED2_ALLOCATOR_STATS
+		++Counters.CachePushes;
+#endif
 		return true;
 	}
 	FORCEINLINE bool CanPushToFront(uint32 InPoolIndex, uint32 InBlockSize)
@@ -299,16 +541,39 @@ struct FFreeBlockList
 				FullBundle.Reset();
 			}
 		}
-		return PartialBundle.Head ? PartialBundle.PopHead() : nullptr;
+		if (!PartialBundle.Head)
+		{
+			return nullptr;
+		}
+#if BINNED2_ALLOCATOR_STATS
+		++Counters.CacheAllocs;
+#endif
+		return PartialBundle.PopHead();
 	}
 
-	// tries to recycle the full bundle, if that fails, it is returned for freeing
-	FBundleNode* RecyleFull(uint32 InPoolIndex);
-	bool ObtainPartial(uint32 InPoolIndex);
+	// tries to hand the full bundle to another thread's remote free list, then to recycle it, if that fails, it is returned for freeing
+	FBundleNode* RecyleFull(uint32 InPoolIndex, FRemoteFreeList* RemoteList, uint32 InNumaNode);
+	bool ObtainPartial(uint32 InPoolIndex, FRemoteFreeList& RemoteList, uint32 InNumaNode);
 	FBundleNode* PopBundles(uint32 InPoolIndex);
+
+#if BINNED2_ALLOCATOR_STATS
+	FORCEINLINE void CountForeignNodeFree()
+	{
+		++Counters.ForeignNodeFrees;
+	}
+	FPoolCounters GetCounters() const
+	{
+		FPoolCounters Result = Counters;
+		Result.CachedBlocks = PartialBundle.Count + FullBundle.Count;
+		return Result;
+	}
+#endif
 private:
 	FBundle PartialBundle;
 	FBundle FullBundle;
+#if BINNED2_ALLOCATOR_STATS
+	FPoolCounters Counters;
+#endif
 };
 
 struct FPerThreadFreeBlockLists
@@ -334,24 +599,65 @@ struct FPerThreadFreeBlockLists
 	{
 		return FreeLists[InPoolIndex].CanPushToFront(InPoolIndex, InBlockSize);
 	}
-	// returns a bundle that needs to be freed if it can't be recycled
-	FBundleNode* RecycleFullBundle(uint32 InPoolIndex)
+	// returns a bundle that needs to be freed if it can't be recycled, Owner is the thread cache that should get it back if it isn't this one
+	FBundleNode* RecycleFullBundle(uint32 InPoolIndex, FPerThreadFreeBlockLists* Owner)
 	{
-		return FreeLists[InPoolIndex].RecyleFull(InPoolIndex);
+		return FreeLists[InPoolIndex].RecyleFull(InPoolIndex, Owner && Owner != this ? &Owner->RemoteFrees[InPoolIndex] : nullptr, NumaNode);
 	}
 	// returns true if we have anything to pop
 	bool ObtainRecycledPartial(uint32 InPoolIndex)
 	{
-		return FreeLists[InPoolIndex].ObtainPartial(InPoolIndex);
+		return FreeLists[InPoolIndex].ObtainPartial(InPoolIndex, RemoteFrees[InPoolIndex], NumaNode);
 	}
 	FBundleNode* PopBundles(uint32 InPoolIndex)
 	{
 		return FreeLists[InPoolIndex].PopBundles(InPoolIndex);
 	}
+	// returns the bundles other threads have freed to this one, chained through NextBundle
+	FBundleNode* PopRemoteBundles(uint32 InPoolIndex)
+	{
+		return RemoteFrees[InPoolIndex].PopAll();
+	}
+	// stops other threads from freeing to this one and returns what they already have
+	FBundleNode* CloseRemoteBundles(uint32 InPoolIndex)
+	{
+		return RemoteFrees[InPoolIndex].Close();
+	}
+#if BINNED2_ALLOCATOR_STATS
+	void CountForeignNodeFree(uint32 InPoolIndex)
+	{
+		FreeLists[InPoolIndex].CountForeignNodeFree();
+	}
+	void GetCounters(FThreadCounters& OutCounters) const
+	{
+		OutCounters.ThreadId = ThreadId;
+		for (uint32 PoolIndex = 0; PoolIndex < BINNED2_SMALL_POOL_COUNT; ++PoolIndex)
+		{
+			OutCounters.Pools[PoolIndex] = FreeLists[PoolIndex].GetCounters();
+		}
+	}
+
+	// Registry of all thread caches, guarded by the allocator mutex
+	FPerThreadFreeBlockLists* NextThreadLists;
+	uint32 ThreadId;
+#endif
+	// Node this cache takes its blocks from, picked where the thread first set it up. Blocks of other nodes are never cached here.
+	uint32 NumaNode;
 private:
 	FFreeBlockList FreeLists[BINNED2_SMALL_POOL_COUNT];
+	// Written by other threads, kept off the cache lines of FreeLists
+	MS_ALIGN(PLATFORM_CACHE_LINE_SIZE) FRemoteFreeList RemoteFrees[BINNED2_SMALL_POOL_COUNT] GCC_ALIGN(PLATFORM_CACHE_LINE_SIZE);
 };
 
+// Thread cache that last refilled each pool under the lock, where other threads send full bundles of that pool when GMallocBinned2RemoteFrees is set
+FPerThreadFreeBlockLists* volatile RemoteFreeOwners[BINNED2_MAX_NUMA_NODES][BINNED2_SMALL_POOL_COUNT];
+
+#if BINNED2_ALLOCATOR_STATS
+// Thread caches that are alive, and the counters of the ones that have been cleared
+FPerThreadFreeBlockLists* RegisteredThreadLists;
+FPoolCounters RetiredThreadCounters[BINNED2_SMALL_POOL_COUNT];
+#endif
+
 static FORCEINLINE FFreeBlock* GetPoolHeaderFromPointer(void* Ptr)
 {
 	return (FFreeBlock*)AlignDown(Ptr, BINNED2_LARGE_ALLOC);
@@ -360,7 +666,12 @@ static FORCEINLINE FFreeBlock* GetPoolHeaderFromPointer(void* Ptr)
 public:
 
 
-	YMallocBinned2();
+	/**
+	 * @param bUseHugePages carve pools out of huge page regions instead of mapping every page separately
+	 * @param InSmallBlockSizes BINNED2_SMALL_POOL_COUNT block sizes to use instead of the default table, ignored if they don't pass ValidateSmallBlockSizes
+	 * @param bUseNuma keep pool tables, page caches and thread caches per NUMA node, ignored on single node machines. Small pool pages don't use huge pages in this mode.
+	 */
+	YMallocBinned2(bool bUseHugePages = BINNED2_USE_HUGE_PAGES, const uint16* InSmallBlockSizes = nullptr, bool bUseNuma = BINNED2_USE_NUMA);
 
 	virtual ~YMallocBinned2();
 
@@ -372,6 +683,9 @@ public:
 		// With large alignments, we'll waste a lot of memory allocating an entire page, but such alignments are highly unlikely in practice.
 		if ((Size <= BINNED2_MAX_SMALL_POOL_SIZE) & (Alignment <= BINNED2_MINIMUM_ALIGNMENT)) // one branch, not two
 		{
+#if BINNED2_ALLOCATOR_STATS
+			RecordSizeProfile(Size);
+#endif
 			FPerThreadFreeBlockLists* Lists = GMallocBinned2PerThreadCaches ? FPerThreadFreeBlockLists::Get() : nullptr;
 			if (Lists)
 			{
@@ -388,6 +702,9 @@ public:
 	{
 		if (NewSize <= BINNED2_MAX_SMALL_POOL_SIZE && Alignment <= BINNED2_MINIMUM_ALIGNMENT) // one branch, not two
 		{
+#if BINNED2_ALLOCATOR_STATS
+			RecordSizeProfile(NewSize);
+#endif
 			FPerThreadFreeBlockLists* Lists = GMallocBinned2PerThreadCaches ? FPerThreadFreeBlockLists::Get() : nullptr;
 			if (Lists && (!Ptr || !IsOSAllocation(Ptr)))
 			{
@@ -406,7 +723,7 @@ public:
 					{
 						return Ptr;
 					}
-					bCanFree = bCanFree && Lists->CanFree(PoolIndex, BlockSize);
+					bCanFree = bCanFree && Free->NumaNode == Lists->NumaNode && Lists->CanFree(PoolIndex, BlockSize);
 				}
 				if (bCanFree)
 				{
@@ -438,7 +755,26 @@ public:
 			if (Lists)
 			{
 				FFreeBlock* BasePtr = GetPoolHeaderFromPointer(Ptr);
-				if (BasePtr->IsCanaryOk() && Lists->Free(Ptr, BasePtr->PoolIndex, BasePtr->BlockSize))
+				if (BasePtr->IsCanaryOk() && BasePtr->NumaNode == Lists->NumaNode && Lists->Free(Ptr, BasePtr->PoolIndex, BasePtr->BlockSize))
+				{
+					return;
+				}
+			}
+		}
+		FreeExternal(Ptr);
+	}
+
+	FORCEINLINE virtual void FreeSized(void* Ptr, SIZE_T Size, uint32 Alignment) override
+	{
+		// The size gives the pool, so the page header of the block isn't read. NUMA mode needs it for the node of the block.
+		if ((Size <= BINNED2_MAX_SMALL_POOL_SIZE) & (Alignment <= BINNED2_MINIMUM_ALIGNMENT) && !bNumaAware && !IsOSAllocation(Ptr))
+		{
+			FPerThreadFreeBlockLists* Lists = GMallocBinned2PerThreadCaches ? FPerThreadFreeBlockLists::Get() : nullptr;
+			if (Lists)
+			{
+				const uint32 PoolIndex = BoundSizeToPoolIndex(Size);
+				checkSlow(GetPoolHeaderFromPointer(Ptr)->IsCanaryOk() && GetPoolHeaderFromPointer(Ptr)->PoolIndex == PoolIndex);
+				if (Lists->Free(Ptr, PoolIndex, PoolIndexToBlockSize(PoolIndex)))
 				{
 					return;
 				}
@@ -447,6 +783,18 @@ public:
 		FreeExternal(Ptr);
 	}
 
+	FORCEINLINE virtual bool TryReallocInPlace(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		if (!IsOSAllocation(Ptr))
+		{
+			// Same rule as Realloc: the block stays while the new size still maps to its pool
+			const FFreeBlock* Free = GetPoolHeaderFromPointer(Ptr);
+			const uint32 PoolIndex = Free->PoolIndex;
+			return NewSize && (Alignment <= BINNED2_MINIMUM_ALIGNMENT) && Free->IsCanaryOk() && NewSize <= Free->BlockSize && (PoolIndex == 0 || NewSize > PoolIndexToBlockSize(PoolIndex - 1));
+		}
+		return TryReallocInPlaceExternal(Ptr, NewSize, Alignment);
+	}
+
 	FORCEINLINE virtual bool GetAllocationSize(void *Ptr, SIZE_T &SizeOut) override
 	{
 		if (!IsOSAllocation(Ptr))
@@ -485,12 +833,90 @@ public:
 	virtual void SetupTLSCachesOnCurrentThread() override;
 	virtual void ClearAndDisableTLSCachesOnCurrentThread() override;
 	virtual const TCHAR* GetDescriptiveName() override;
+	virtual void GetAllocatorStats(YGenericMemoryStats& out_Stats) override;
+	virtual void DumpAllocatorStats(class YOutputDevice& Ar) override;
 	// End YMalloc interface.
 
+#if BINNED2_ALLOCATOR_STATS
+	/**
+	 * Sums the counters of all thread caches, including the ones of threads that went away, and of the pools.
+	 *
+	 * @param OutCounters receives BINNED2_SMALL_POOL_COUNT entries, in pool order
+	 */
+	void GetPoolCounters(FPoolCounters* OutCounters);
+
+	/** Takes a snapshot of the counters of every live thread cache. */
+	void GetThreadCounters(TArray<FThreadCounters>& OutThreads);
+
+	/** Logs the summed counters of every pool. */
+	void DumpPoolCounters(class YOutputDevice& Ar);
+
+	/** Writes one row per pool and thread cache, plus one row per pool for the totals. */
+	bool DumpPoolCountersToCSV(const TCHAR* Filename);
+
+	/** Copies the request counts captured while GMallocBinned2CaptureSizeProfile was set, one entry per BINNED2_MINIMUM_ALIGNMENT bucket. */
+	static void GetSizeProfile(uint64* OutCounts);
+	static void ResetSizeProfile();
+#endif
+
+	/** Returns the built-in table of BINNED2_SMALL_POOL_COUNT block sizes. */
+	static const uint16* GetDefaultSmallBlockSizes();
+
+	/** Returns the block sizes of the small pools in use. */
+	void GetSmallBlockSizes(uint16* OutSizes);
+
+	/** True if the small pools were set up from a table passed to the constructor. */
+	FORCEINLINE bool HasCustomSmallBlockSizes() const
+	{
+		return bCustomSmallBlockSizes;
+	}
+
+	/**
+	 * Checks a table of block sizes against the rules the small pools rely on.
+	 *
+	 * @param Sizes BINNED2_SMALL_POOL_COUNT block sizes
+	 * @param InPageSize OS page size the pools will be carved from
+	 * @param OutError if not null, receives a description of the first broken rule
+	 * @return true if the table can be passed to the constructor
+	 */
+	static bool ValidateSmallBlockSizes(const uint16* Sizes, uint32 InPageSize, const TCHAR** OutError = nullptr);
+
+	/**
+	 * Parses a table of block sizes, either a list of numbers separated by commas or whitespace, or the path of a file holding
+	 * such a list (as written by MallocBinned2.SaveSizeClasses). Lines starting with ';' are comments.
+	 * Only uses the C runtime so that it can run before GMalloc exists.
+	 *
+	 * @param Value list or file name
+	 * @param OutSizes receives BINNED2_SMALL_POOL_COUNT block sizes
+	 * @return true if exactly BINNED2_SMALL_POOL_COUNT sizes were read; they still need to be validated
+	 */
+	static bool ParseSmallBlockSizes(const ANSICHAR* Value, uint16* OutSizes);
+
+	/**
+	 * Picks the block sizes that minimize the memory lost to rounding and to page tails for a size profile.
+	 * The last size is always BINNED2_MAX_SMALL_POOL_SIZE, and no block is more than a third larger than the smallest request it serves,
+	 * so that sizes missing from the profile still get reasonable pools.
+	 *
+	 * @param SizeCounts BINNED2_SIZE_BUCKET_COUNT request counts, see GetSizeProfile
+	 * @param InPageSize OS page size the pools will be carved from
+	 * @param OutSizes receives BINNED2_SMALL_POOL_COUNT block sizes
+	 */
+	static void ComputeSmallBlockSizes(const uint64* SizeCounts, uint32 InPageSize, uint16* OutSizes);
+
+	/**
+	 * Estimates the bytes lost to rounding and to page tails when serving a size profile with a table of block sizes.
+	 *
+	 * @return lost bytes as a fraction of the requested bytes
+	 */
+	static double ComputeSmallBlockWaste(const uint64* SizeCounts, const uint16* Sizes, uint32 InPageSize);
+
 	void FlushCurrentThreadCache();
 	void* MallocExternal(SIZE_T Size, uint32 Alignment);
 	void* ReallocExternal(void* Ptr, SIZE_T NewSize, uint32 Alignment);
 	void FreeExternal(void *Ptr);
+	bool TryReallocInPlaceExternal(void* Ptr, SIZE_T NewSize, uint32 Alignment);
+	/** Grows a large allocation by mapping the pages after it, only possible when it came straight from the OS. Mutex must be held. */
+	bool TryExtendOSAllocation(void* Ptr, UPTRINT OldOsBytes, UPTRINT NewOsBytes);
 	bool GetAllocationSizeExternal(void* Ptr, SIZE_T& SizeOut);
 
 	static uint16 SmallBlockSizesReversed[BINNED2_SMALL_POOL_COUNT]; // this is reversed to get the smallest elements on our main cache line
@@ -499,7 +925,21 @@ public:
 	static uint32 PageSize;
 	static uint32 OsAllocationGranularity;
 	// Mapping of sizes to small table indices
-	static uint8 MemSizeToIndex[1 + (BINNED2_MAX_SMALL_POOL_SIZE >> BINNED2_MINIMUM_ALIGNMENT_SHIFT)];
+	static uint8 MemSizeToIndex[BINNED2_SIZE_BUCKET_COUNT];
+#if BINNED2_ALLOCATOR_STATS
+	static int64 SizeProfile[BINNED2_SIZE_BUCKET_COUNT];
+
+	static FORCEINLINE void RecordSizeProfile(SIZE_T Size)
+	{
+		if (GMallocBinned2CaptureSizeProfile)
+		{
+			FPlatformAtomics::InterlockedIncrement(&SizeProfile[(Size + BINNED2_MINIMUM_ALIGNMENT - 1) >> BINNED2_MINIMUM_ALIGNMENT_SHIFT]);
+		}
+	}
+#endif
+	bool bCustomSmallBlockSizes;
+	// Why the table passed to the constructor was rejected, if it was
+	const TCHAR* SmallBlockSizesError;
 
 	FORCEINLINE uint32 BoundSizeToPoolIndex(SIZE_T Size)
 	{
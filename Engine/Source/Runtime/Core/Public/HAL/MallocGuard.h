@@ -0,0 +1,253 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	MallocGuard.h: Proxy that puts a sample of allocations between guard pages
+=============================================================================*/
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/CriticalSection.h"
+
+/** Governs whether the guard proxy is compiled in. Nothing is sampled until Memory.UseGuard is run. */
+#ifndef USE_MALLOC_GUARD
+#define USE_MALLOC_GUARD (!PLATFORM_USES_FIXED_GMalloc_CLASS && (PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC))
+#endif
+
+#if USE_MALLOC_GUARD
+
+/**
+ * Sampling version of FMallocStomp, cheap enough to leave on in production.
+ *
+ * One allocation in SampleRate is placed in a page of its own out of a fixed pool, with an inaccessible guard page on
+ * each side; every other allocation goes to the underlying allocator. Sampled blocks alternate between touching the
+ * end of their page, so that overruns fault, and touching its start, so that underruns do. The rest of the page is
+ * filled with a pattern that is checked on free, which catches the accesses that land in the alignment slack.
+ * Freed pages are made inaccessible and reused in the order they were freed, so use after free faults for as long as
+ * possible. Faults in the pool are reported with the callstacks that allocated and freed the block before the crash
+ * handler sees them.
+ */
+class CORE_API FMallocGuardProxy : public YMalloc
+{
+public:
+	/** Frames kept for the callstacks that allocated and freed a sampled block */
+	static const uint32 MaxCallstackDepth = 16;
+
+	/**
+	 * @param InMalloc		Allocator everything that isn't sampled goes to
+	 * @param InSampleRate	One allocation in this many is sampled on average, 0 samples nothing
+	 * @param InNumSlots	Sampled blocks that can be alive or in quarantine at once
+	 */
+	FMallocGuardProxy(YMalloc* InMalloc, uint32 InSampleRate, uint32 InNumSlots);
+
+	/** Gives the pool back to the OS. Only for a proxy that never was GMalloc, blocks it handed out are gone with it. */
+	virtual ~FMallocGuardProxy();
+
+	/**
+	 * Puts the proxy on top of GMalloc, or changes the sample rate if it is already there.
+	 * The fault handlers are installed along with it.
+	 *
+	 * @return false if the proxy could not be installed
+	 */
+	static bool Install(uint32 SampleRate, uint32 NumSlots = 256);
+
+	/** @return the installed proxy, or null */
+	static FMallocGuardProxy* Get();
+
+	void SetSampleRate(uint32 InSampleRate);
+
+	/**
+	 * Logs what is known about a faulting address in the pool: the kind of error, the block involved and the callstacks
+	 * that allocated and freed it. Called by the fault handlers; platform crash handlers may call it as well.
+	 * It doesn't take the proxy's lock, but the logging and the symbol lookup for the callstacks do lock and allocate,
+	 * which is not signal safe. A fault in a thread that holds the log or the allocator lock can deadlock instead of
+	 * reaching the crash handler; since the process is going down either way, the report is worth that risk.
+	 *
+	 * @return true if the address is in the pool
+	 */
+	bool ReportFault(const void* Address);
+
+	FORCEINLINE bool IsGuarded(const void* Ptr) const
+	{
+		return (UPTRINT)Ptr - PoolBase < PoolSize;
+	}
+
+	// YMalloc interface begin
+	virtual void InitializeStatsMetadata() override
+	{
+		UsedMalloc->InitializeStatsMetadata();
+	}
+
+	virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+	{
+		if (UNLIKELY(ShouldSample()))
+		{
+			if (void* Result = GuardedMalloc(Size, Alignment))
+			{
+				return Result;
+			}
+		}
+		return UsedMalloc->Malloc(Size, Alignment);
+	}
+
+	virtual void* Realloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		if (UNLIKELY(IsGuarded(Ptr)))
+		{
+			return GuardedRealloc(Ptr, NewSize, Alignment);
+		}
+		if (!Ptr && NewSize)
+		{
+			return Malloc(NewSize, Alignment);
+		}
+		return UsedMalloc->Realloc(Ptr, NewSize, Alignment);
+	}
+
+	virtual void Free(void* Ptr) override
+	{
+		if (UNLIKELY(IsGuarded(Ptr)))
+		{
+			GuardedFree(Ptr);
+			return;
+		}
+		UsedMalloc->Free(Ptr);
+	}
+
+	virtual void FreeSized(void* Ptr, SIZE_T Size, uint32 Alignment) override
+	{
+		if (UNLIKELY(IsGuarded(Ptr)))
+		{
+			GuardedFree(Ptr);
+			return;
+		}
+		UsedMalloc->FreeSized(Ptr, Size, Alignment);
+	}
+
+	virtual bool TryReallocInPlace(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		// Sampled blocks touch a guard page on one side, they can't grow
+		return !IsGuarded(Ptr) && UsedMalloc->TryReallocInPlace(Ptr, NewSize, Alignment);
+	}
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+	{
+		return UsedMalloc->QuantizeSize(Count, Alignment);
+	}
+
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override;
+
+	virtual void Trim() override
+	{
+		UsedMalloc->Trim();
+	}
+
+	virtual void SetupTLSCachesOnCurrentThread() override
+	{
+		UsedMalloc->SetupTLSCachesOnCurrentThread();
+	}
+
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+	{
+		UsedMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+	}
+
+	virtual void GetAllocatorStats(YGenericMemoryStats& OutStats) override
+	{
+		UsedMalloc->GetAllocatorStats(OutStats);
+	}
+
+	virtual void DumpAllocatorStats(class YOutputDevice& Ar) override;
+
+	virtual bool IsInternallyThreadSafe() const override
+	{
+		return UsedMalloc->IsInternallyThreadSafe();
+	}
+
+	/** Also checks the fill pattern around every live sampled block, and logs the ones written outside their bounds */
+	virtual bool ValidateHeap() override;
+
+	virtual bool Exec(UWorld* InWorld, const TCHAR* Cmd, YOutputDevice& Ar) override
+	{
+		return UsedMalloc->Exec(InWorld, Cmd, Ar);
+	}
+
+	virtual const TCHAR* GetDescriptiveName() override
+	{
+		return UsedMalloc->GetDescriptiveName();
+	}
+	// YMalloc interface end
+
+private:
+	enum class ESlotState : uint8
+	{
+		Unused,
+		Allocated,
+		Freed,
+	};
+
+	struct FSlot
+	{
+		UPTRINT Ptr;
+		SIZE_T Size;
+		uint32 NextFree;
+		uint32 AllocThreadId;
+		uint32 FreeThreadId;
+		ESlotState State;
+		uint64 AllocCallstack[MaxCallstackDepth];
+		uint64 FreeCallstack[MaxCallstackDepth];
+	};
+
+	/** Counts down the allocations a thread makes before its next sample, in a TLS slot */
+	FORCEINLINE bool ShouldSample()
+	{
+		const UPTRINT Countdown = (UPTRINT)YPlatformTLS::GetTlsValue(CountdownTlsSlot);
+		if (LIKELY(Countdown > 1))
+		{
+			YPlatformTLS::SetTlsValue(CountdownTlsSlot, (void*)(Countdown - 1));
+			return false;
+		}
+		return StartNextCountdown(Countdown);
+	}
+
+	bool StartNextCountdown(UPTRINT Countdown);
+	void* GuardedMalloc(SIZE_T Size, uint32 Alignment);
+	void* GuardedRealloc(void* Ptr, SIZE_T NewSize, uint32 Alignment);
+	void GuardedFree(void* Ptr);
+
+	FORCEINLINE uint8* GetSlotPage(uint32 SlotIndex) const
+	{
+		return (uint8*)PoolBase + (2 * SIZE_T(SlotIndex) + 1) * PageSize;
+	}
+
+	/** @return the number of bytes outside the block that no longer hold the fill pattern, the first one in OutFirstBad */
+	SIZE_T CheckFillPattern(const FSlot& Slot, uint32 SlotIndex, const uint8*& OutFirstBad) const;
+
+	void LogSlot(const FSlot& Slot) const;
+
+	/** Malloc we're based on, aka using under the hood */
+	YMalloc* UsedMalloc;
+
+	/** Pool of guard and block pages, guard pages are at even indices */
+	UPTRINT PoolBase;
+	SIZE_T PoolSize;
+	SIZE_T PageSize;
+
+	FSlot* Slots;
+	uint32 NumSlots;
+	/** Queue of free slots, oldest first */
+	uint32 FirstFree;
+	uint32 LastFree;
+
+	volatile int32 SampleRate;
+	uint32 CountdownTlsSlot;
+	uint32 NumSampled;
+	uint32 NumLive;
+	/** Samples that went to the underlying allocator because every slot was taken */
+	uint32 NumPoolFull;
+
+	FCriticalSection Mutex;
+};
+
+#endif // USE_MALLOC_GUARD
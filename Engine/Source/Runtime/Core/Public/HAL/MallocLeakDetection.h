@@ -229,6 +229,27 @@ public:
 		}
 	}
 
+	virtual void FreeSized(void* Ptr, SIZE_T Size, uint32 Alignment) override
+	{
+		if (Ptr)
+		{
+			FScopeLock SafeLock(&AllocatedPointersCritical);
+			Verify.Free(Ptr);
+			UsedMalloc->FreeSized(Ptr, Size, Alignment);
+		}
+	}
+
+	virtual bool TryReallocInPlace(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		FScopeLock SafeLock(&AllocatedPointersCritical);
+		const bool bResized = UsedMalloc->TryReallocInPlace(Ptr, NewSize, Alignment);
+		if (bResized)
+		{
+			Verify.Realloc(Ptr, Ptr, NewSize);
+		}
+		return bResized;
+	}
+
 	virtual void InitializeStatsMetadata() override
 	{
 		UsedMalloc->InitializeStatsMetadata();
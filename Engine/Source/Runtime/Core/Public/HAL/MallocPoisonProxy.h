@@ -88,6 +88,39 @@ public:
 		}
 	}
 
+	virtual void FreeSized(void* Ptr, SIZE_T Size, uint32 Alignment) override
+	{
+		if (LIKELY(Ptr))
+		{
+			IncrementTotalFreeCalls();
+			SIZE_T AllocSize;
+			if (LIKELY(GetAllocationSize(Ptr, AllocSize) && AllocSize > 0))
+			{
+				YMemory::Memset(Ptr, UE_DEBUG_FILL_FREED, AllocSize);
+			}
+			UsedMalloc->FreeSized(Ptr, Size, Alignment);
+		}
+	}
+
+	virtual bool TryReallocInPlace(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		SIZE_T OldSize = 0;
+		GetAllocationSize(Ptr, OldSize);
+		if (!UsedMalloc->TryReallocInPlace(Ptr, NewSize, Alignment))
+		{
+			return false;
+		}
+		if (OldSize > NewSize)
+		{
+			YMemory::Memset(static_cast<uint8*>(Ptr) + NewSize, UE_DEBUG_FILL_FREED, OldSize - NewSize);
+		}
+		else if (OldSize > 0 && OldSize < NewSize)
+		{
+			YMemory::Memset(static_cast<uint8*>(Ptr) + OldSize, UE_DEBUG_FILL_NEW, NewSize - OldSize);
+		}
+		return true;
+	}
+
 	virtual void GetAllocatorStats(YGenericMemoryStats& out_Stats) override
 	{
 		UsedMalloc->GetAllocatorStats(out_Stats);
@@ -29,6 +29,7 @@ public:
 	virtual void*				Malloc(SIZE_T Size, uint32 Alignment) override;
 	virtual void*				Realloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override;
 	virtual void				Free(void* Ptr) override;
+	virtual bool				TryReallocInPlace(void* Ptr, SIZE_T NewSize, uint32 Alignment) override;
 	virtual bool				GetAllocationSize(void *Original, SIZE_T &SizeOut) override;
 
 	virtual bool				IsInternallyThreadSafe() const override
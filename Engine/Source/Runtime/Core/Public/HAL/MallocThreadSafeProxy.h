@@ -67,6 +67,22 @@ public:
 		}
 	}
 
+	virtual void FreeSized(void* Ptr, SIZE_T Size, uint32 Alignment) override
+	{
+		if (Ptr)
+		{
+			IncrementTotalFreeCalls();
+			FScopeLock ScopeLock(&SynchronizationObject);
+			UsedMalloc->FreeSized(Ptr, Size, Alignment);
+		}
+	}
+
+	virtual bool TryReallocInPlace(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		FScopeLock ScopeLock(&SynchronizationObject);
+		return UsedMalloc->TryReallocInPlace(Ptr, NewSize, Alignment);
+	}
+
 	/** Writes allocator stats from the last update into the specified destination. */
 	virtual void GetAllocatorStats(YGenericMemoryStats& out_Stats) override
 	{
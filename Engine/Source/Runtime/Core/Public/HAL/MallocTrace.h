@@ -0,0 +1,230 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	MallocTrace.h: Proxy that records allocation events to a binary file
+=============================================================================*/
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "HAL/MemoryBase.h"
+#include "Containers/SolidAngleString.h"
+#include "HAL/PlatformTime.h"
+
+/** Governs whether the tracing proxy is compiled in. Nothing is traced until MallocTrace.Start is run. */
+#ifndef USE_MALLOC_TRACE
+#define USE_MALLOC_TRACE (!UE_BUILD_SHIPPING && !PLATFORM_USES_FIXED_GMalloc_CLASS)
+#endif
+
+#if USE_MALLOC_TRACE
+
+/**
+ * Layout of a malloc trace file.
+ *
+ * The file starts with an FFileHeader and is followed by blocks, each made of an FBlockHeader and Size bytes of events
+ * recorded by one thread. An event is an EEvent byte followed by LEB128 varints:
+ *   Alloc:     Ptr, Size, CallstackId, DeltaCycles
+ *   Free:      Ptr, DeltaCycles
+ *   Realloc:   OldPtr, NewPtr, Size, CallstackId, DeltaCycles, AllocDeltaCycles
+ *   Callstack: CallstackId, Depth, Depth frame addresses
+ * Pointers are zigzag encoded deltas from the previous pointer in the block and cycles are deltas from the previous event
+ * in the block, starting at FBlockHeader::BaseCycles. Blocks of different threads are not ordered in the file.
+ * A realloc is timed twice: DeltaCycles is when OldPtr was released, taken before the block could be handed to another
+ * thread, and AllocDeltaCycles is the time from there until NewPtr was returned.
+ * CallstackId 0 means that no callstack was recorded.
+ */
+namespace MallocTrace
+{
+	/** 'MTRC' */
+	static const uint32 FileMagic = 0x4352544D;
+	static const uint32 FileVersion = 2;
+
+	/** Deepest callstack that can be recorded */
+	static const uint32 MaxCallstackDepth = 32;
+
+	enum class EEvent : uint8
+	{
+		Alloc,
+		Free,
+		Realloc,
+		Callstack,
+	};
+
+	struct FFileHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint64 StartCycles;
+		double SecondsPerCycle;
+	};
+
+	struct FBlockHeader
+	{
+		uint32 ThreadId;
+		uint32 Size;
+		uint64 BaseCycles;
+	};
+}
+
+/**
+ * YMalloc proxy that records every allocation, reallocation and free with a deduplicated callstack.
+ * Events go to a buffer owned by the calling thread without taking locks; full buffers are written to disk by a background
+ * thread. Cheap enough to leave installed: when no trace is running the only cost is a test of a global flag.
+ * Start and stop traces with MallocTrace.Start / MallocTrace.Stop and inspect them with MallocTrace.Analyze.
+ */
+class CORE_API FMallocTraceProxy : public YMalloc
+{
+private:
+	/** Malloc we're based on, aka using under the hood */
+	YMalloc* UsedMalloc;
+
+	/** Set while a trace is being recorded */
+	static volatile int32 bTracing;
+
+	static void TraceAlloc(void* Ptr, SIZE_T Size);
+	static void TraceRealloc(void* OldPtr, void* NewPtr, SIZE_T Size, uint64 ReleaseCycles);
+	static void TraceFree(void* Ptr);
+
+public:
+	explicit FMallocTraceProxy(YMalloc* InMalloc);
+
+	/**
+	 * Installs the proxy on top of GMalloc if needed and starts recording to a file.
+	 *
+	 * @param Filename	File to write, or nullptr for a new file in the profiling directory
+	 * @return true if the trace was started
+	 */
+	static bool StartTrace(const TCHAR* Filename = nullptr);
+
+	/** Stops recording and flushes every thread's events to the file. */
+	static void StopTrace();
+
+	/** @return the file written by the last trace, empty if no trace was run */
+	static YString GetLastTraceFilename();
+
+	static FORCEINLINE bool IsTracing()
+	{
+		return bTracing != 0;
+	}
+
+	// YMalloc interface begin
+	virtual void InitializeStatsMetadata() override
+	{
+		UsedMalloc->InitializeStatsMetadata();
+	}
+
+	virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+	{
+		void* Result = UsedMalloc->Malloc(Size, Alignment);
+		if (UNLIKELY(bTracing))
+		{
+			TraceAlloc(Result, Size);
+		}
+		return Result;
+	}
+
+	virtual void* Realloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		if (LIKELY(!bTracing))
+		{
+			return UsedMalloc->Realloc(Ptr, NewSize, Alignment);
+		}
+		// Timed before the old block can be handed out again, so its release is always ordered before the next alloc of the same address
+		const uint64 ReleaseCycles = FPlatformTime::Cycles64();
+		void* Result = UsedMalloc->Realloc(Ptr, NewSize, Alignment);
+		// A failed realloc leaves the old block alive
+		if (Result || !NewSize)
+		{
+			TraceRealloc(Ptr, Result, NewSize, ReleaseCycles);
+		}
+		return Result;
+	}
+
+	virtual void Free(void* Ptr) override
+	{
+		// Recorded before the block can be handed out again, so the free is always ordered before the next alloc of the same address
+		if (UNLIKELY(bTracing) && Ptr)
+		{
+			TraceFree(Ptr);
+		}
+		UsedMalloc->Free(Ptr);
+	}
+
+	virtual void FreeSized(void* Ptr, SIZE_T Size, uint32 Alignment) override
+	{
+		if (UNLIKELY(bTracing) && Ptr)
+		{
+			TraceFree(Ptr);
+		}
+		UsedMalloc->FreeSized(Ptr, Size, Alignment);
+	}
+
+	virtual bool TryReallocInPlace(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		const uint64 ReleaseCycles = UNLIKELY(bTracing) ? FPlatformTime::Cycles64() : 0;
+		const bool bResized = UsedMalloc->TryReallocInPlace(Ptr, NewSize, Alignment);
+		if (UNLIKELY(bTracing) && bResized && ReleaseCycles)
+		{
+			TraceRealloc(Ptr, Ptr, NewSize, ReleaseCycles);
+		}
+		return bResized;
+	}
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+	{
+		return UsedMalloc->QuantizeSize(Count, Alignment);
+	}
+
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+	{
+		return UsedMalloc->GetAllocationSize(Original, SizeOut);
+	}
+
+	virtual void Trim() override
+	{
+		UsedMalloc->Trim();
+	}
+
+	virtual void SetupTLSCachesOnCurrentThread() override
+	{
+		UsedMalloc->SetupTLSCachesOnCurrentThread();
+	}
+
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+	{
+		UsedMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+	}
+
+	virtual void GetAllocatorStats(YGenericMemoryStats& OutStats) override
+	{
+		UsedMalloc->GetAllocatorStats(OutStats);
+	}
+
+	virtual void DumpAllocatorStats(class YOutputDevice& Ar) override
+	{
+		UsedMalloc->DumpAllocatorStats(Ar);
+	}
+
+	virtual bool IsInternallyThreadSafe() const override
+	{
+		return UsedMalloc->IsInternallyThreadSafe();
+	}
+
+	virtual bool ValidateHeap() override
+	{
+		return UsedMalloc->ValidateHeap();
+	}
+
+	virtual bool Exec(UWorld* InWorld, const TCHAR* Cmd, YOutputDevice& Ar) override
+	{
+		return UsedMalloc->Exec(InWorld, Cmd, Ar);
+	}
+
+	virtual const TCHAR* GetDescriptiveName() override
+	{
+		return UsedMalloc->GetDescriptiveName();
+	}
+	// YMalloc interface end
+};
+
+#endif // USE_MALLOC_TRACE
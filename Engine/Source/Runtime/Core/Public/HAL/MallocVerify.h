@@ -84,6 +84,22 @@ public:
 		}
 	}
 
+	virtual void FreeSized(void* Ptr, SIZE_T Size, uint32 Alignment) override
+	{
+		if (Ptr)
+		{
+			FScopeLock VerifyLock(&VerifyCritical);
+			Verify.Free(Ptr);
+			UsedMalloc->FreeSized(Ptr, Size, Alignment);
+		}
+	}
+
+	virtual bool TryReallocInPlace(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		// The block keeps its address, so there is nothing to verify
+		return UsedMalloc->TryReallocInPlace(Ptr, NewSize, Alignment);
+	}
+
 	virtual void InitializeStatsMetadata() override
 	{
 		UsedMalloc->InitializeStatsMetadata();
@@ -88,6 +88,33 @@ public:
 	*/
 	virtual void Free(void* Original) = 0;
 
+	/**
+	* Free for callers that know how big the allocation is, which lets some allocators skip looking the block up.
+	*
+	* @param Original - Pointer to free, may be null
+	* @param Size - Size passed to Malloc or Realloc for Original, or anything up to QuantizeSize of that size
+	* @param Alignment - Alignment passed to Malloc or Realloc for Original
+	*/
+	virtual void FreeSized(void* Original, SIZE_T Size, uint32 Alignment = DEFAULT_ALIGNMENT)
+	{
+		Free(Original); // Default implementation has no use for the size
+	}
+
+	/**
+	* Resizes an allocation without moving it. Unlike Realloc this never copies, so callers that know how much of the
+	* block is live can do the copy themselves when it fails.
+	* Allocators may refuse a resize they could do in place, e.g. a shrink that is better served by a smaller block.
+	*
+	* @param Original - Allocation to resize, must not be null
+	* @param Count - New size, must not be 0
+	* @param Alignment - Alignment passed to Malloc or Realloc for Original
+	* @return true if Original now holds Count bytes
+	*/
+	virtual bool TryReallocInPlace(void* Original, SIZE_T Count, uint32 Alignment = DEFAULT_ALIGNMENT)
+	{
+		return false; // Default implementation has no way of determining this
+	}
+
 	/**
 	* For some allocators this will return the actual size that should be requested to eliminate
 	* internal fragmentation. The return value will always be >= Count. This can be used to grow
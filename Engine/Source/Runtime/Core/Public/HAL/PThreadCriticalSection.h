@@ -49,6 +49,16 @@ public:
         pthread_mutex_lock(&Mutex);
 	}
 
+	/**
+	 * Attempt to take a lock and returns whether or not a lock was taken.
+	 *
+	 * @return true if a lock was taken, false otherwise.
+	 */
+	FORCEINLINE bool TryLock()
+	{
+		return pthread_mutex_trylock(&Mutex) == 0;
+	}
+
 	/**
 	 * Releases the lock on the critical seciton
 	 */
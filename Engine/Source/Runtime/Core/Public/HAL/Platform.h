@@ -188,6 +188,14 @@
 #ifndef PLATFORM_COMPILER_HAS_TCHAR_WMAIN
 #define PLATFORM_COMPILER_HAS_TCHAR_WMAIN 0
 #endif
+#ifndef PLATFORM_COMPILER_HAS_COROUTINES
+	// C++20 coroutines, only available when the module is compiled as C++20
+	#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+		#define PLATFORM_COMPILER_HAS_COROUTINES	1
+	#else
+		#define PLATFORM_COMPILER_HAS_COROUTINES	0
+	#endif
+#endif
 #ifndef PLATFORM_TCHAR_IS_1_BYTE
 #define PLATFORM_TCHAR_IS_1_BYTE			0
 #endif
@@ -4,4 +4,6 @@
 
 #if PLATFORM_WINDOWS
 #include "Windows/WindowsPlatformMath.h"
+#elif PLATFORM_LINUX
+#include "Linux/LinuxPlatformMath.h"
 #endif
@@ -192,6 +192,15 @@ struct CORE_API YMemory
 	static void Free(void* Original);
 	static SIZE_T GetAllocSize(void* Original);
 	/**
+	* Free for callers that know the size of the allocation, see YMalloc::FreeSized.
+	*/
+	static void FreeSized(void* Original, SIZE_T Size, uint32 Alignment = DEFAULT_ALIGNMENT);
+	/**
+	* Resizes an allocation only if it can stay where it is, see YMalloc::TryReallocInPlace.
+	* @return true if Original now holds Count bytes, otherwise it is left untouched
+	*/
+	static bool TryReallocInPlace(void* Original, SIZE_T Count, uint32 Alignment = DEFAULT_ALIGNMENT);
+	/**
 	* For some allocators this will return the actual size that should be requested to eliminate
 	* internal fragmentation. The return value will always be >= Count. This can be used to grow
 	* and shrink containers to optimal sizes.
@@ -247,6 +256,8 @@ private:
 	static void* MallocExternal(SIZE_T Count, uint32 Alignment = DEFAULT_ALIGNMENT);
 	static void* ReallocExternal(void* Original, SIZE_T Count, uint32 Alignment = DEFAULT_ALIGNMENT);
 	static void FreeExternal(void* Original);
+	static void FreeSizedExternal(void* Original, SIZE_T Size, uint32 Alignment = DEFAULT_ALIGNMENT);
+	static bool TryReallocInPlaceExternal(void* Original, SIZE_T Count, uint32 Alignment = DEFAULT_ALIGNMENT);
 	static SIZE_T GetAllocSizeExternal(void* Original);
 	static SIZE_T QuantizeSizeExternal(SIZE_T Count, uint32 Alignment = DEFAULT_ALIGNMENT);
 };
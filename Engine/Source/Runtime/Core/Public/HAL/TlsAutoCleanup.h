@@ -10,8 +10,12 @@ public:
 	virtual ~FTlsAutoCleanup()
 	{}
 
-	/** Register this instance to be auto-cleanup. */
-	void Register();
+	/**
+	 * Register this instance to be auto-cleanup.
+	 *
+	 * @return false if the calling thread is not a runnable thread, nothing then cleans the instance up.
+	 */
+	bool Register();
 };
 
 /** Wrapper for values to be stored in TLS that support auto-cleanup. */
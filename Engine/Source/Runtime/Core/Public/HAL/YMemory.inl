@@ -51,6 +51,35 @@ YMemory_INLINE_FUNCTION_DECORATOR void YMemory::Free(void* Original)
 	YMemory_INLINE_GMalloc->Free(Original);
 }
 
+YMemory_INLINE_FUNCTION_DECORATOR void YMemory::FreeSized(void* Original, SIZE_T Size, uint32 Alignment)
+{
+	if (!Original)
+	{
+		FScopedMallocTimer Timer(3);
+		return;
+	}
+
+	if (!YMemory_INLINE_GMalloc)
+	{
+		FreeSizedExternal(Original, Size, Alignment);
+		return;
+	}
+	DoGamethreadHook(2);
+	FScopedMallocTimer Timer(2);
+	YMemory_INLINE_GMalloc->FreeSized(Original, Size, Alignment);
+}
+
+YMemory_INLINE_FUNCTION_DECORATOR bool YMemory::TryReallocInPlace(void* Original, SIZE_T Count, uint32 Alignment)
+{
+	if (!YMemory_INLINE_GMalloc)
+	{
+		return TryReallocInPlaceExternal(Original, Count, Alignment);
+	}
+	DoGamethreadHook(1);
+	FScopedMallocTimer Timer(1);
+	return YMemory_INLINE_GMalloc->TryReallocInPlace(Original, Count, Alignment);
+}
+
 YMemory_INLINE_FUNCTION_DECORATOR SIZE_T YMemory::GetAllocSize(void* Original)
 {
 	if (!YMemory_INLINE_GMalloc)
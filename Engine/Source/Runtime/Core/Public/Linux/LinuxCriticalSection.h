@@ -0,0 +1,9 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "HAL/PThreadCriticalSection.h"
+#include "GenericPlatform/GenericPlatformCriticalSection.h"
+
+typedef FPThreadsCriticalSection FCriticalSection;
+typedef FSystemWideCriticalSectionNotImplemented FSystemWideCriticalSection;
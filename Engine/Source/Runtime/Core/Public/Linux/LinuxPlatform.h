@@ -0,0 +1,117 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================================
+	LinuxPlatform.h: Setup for the linux platform
+==============================================================================================*/
+
+#pragma once
+
+#include <linux/version.h>
+#include <signal.h>
+#include <pthread.h>
+
+/**
+* Linux specific types
+**/
+struct YLinuxPlatformTypes : public YGenericPlatformTypes
+{
+	typedef __SIZE_TYPE__		SIZE_T;
+	typedef __PTRDIFF_TYPE__	SSIZE_T;
+	typedef decltype(__null)	TYPE_OF_NULL;
+};
+
+typedef YLinuxPlatformTypes YPlatformTypes;
+
+// Base defines, must define these for the platform, there are no defaults
+#define PLATFORM_DESKTOP					1
+#if defined(_LINUX64) || defined(__x86_64__) || defined(__aarch64__)
+#define PLATFORM_64BITS						1
+#else
+#define PLATFORM_64BITS						0
+#endif
+#define PLATFORM_CAN_SUPPORT_EDITORONLY_DATA	1
+
+// Base defines, defaults are commented out
+#define PLATFORM_LITTLE_ENDIAN								1
+#define PLATFORM_SUPPORTS_UNALIGNED_INT_LOADS				1
+#if defined(__x86_64__) || defined(__i386__)
+#define PLATFORM_ENABLE_VECTORINTRINSICS					1
+#endif
+#define PLATFORM_SUPPORTS_PRAGMA_PACK						1
+#define PLATFORM_COMPILER_DISTINGUISHES_INT_AND_LONG		1
+#define PLATFORM_TCHAR_IS_4_BYTES							1
+#define PLATFORM_USE_LS_SPEC_FOR_WIDECHAR					1
+#define PLATFORM_USE_SYSTEM_VSWPRINTF						1
+#define PLATFORM_HAS_BSD_TIME								1
+#define PLATFORM_USE_PTHREADS								1
+#define PLATFORM_MAX_FILEPATH_LENGTH						PATH_MAX
+#define PLATFORM_HAS_BSD_SOCKET_FEATURE_CLOSE_ON_EXEC		1
+#define PLATFORM_SUPPORTS_NAMED_PIPES						0
+#define PLATFORM_SUPPORTS_STACK_SYMBOLS						1
+#define PLATFORM_HAS_64BIT_ATOMICS							1
+#define PLATFORM_HAS_128BIT_ATOMICS							0
+#define PLATFORM_RHITHREAD_DEFAULT_BYPASS					0
+
+// Function type macros.
+#define VARARGS															/* Functions with variable arguments */
+#define CDECL															/* Standard C function */
+#define STDCALL															/* Standard calling convention */
+#define FORCEINLINE inline __attribute__ ((always_inline))				/* Force code to be inline */
+#define FORCENOINLINE __attribute__((noinline))							/* Force code to NOT be inline */
+#if defined(__clang__)
+	#define FUNCTION_CHECK_RETURN_END __attribute__ ((warn_unused_result))	/* Warn that callers should not ignore the return value. */
+	#define FUNCTION_NO_RETURN_END __attribute__ ((noreturn))				/* Indicate that the function never returns. */
+#else
+	// GCC does not accept attributes after the declarator of a function definition
+	#define FUNCTION_CHECK_RETURN_START __attribute__ ((warn_unused_result))
+	#define FUNCTION_CHECK_RETURN_END
+	#define FUNCTION_NO_RETURN_START __attribute__ ((noreturn))
+	#define FUNCTION_NO_RETURN_END
+#endif
+
+#define ABSTRACT abstract
+#define CONSTEXPR constexpr
+
+// Optimization macros
+#if defined(__clang__)
+#define PRAGMA_DISABLE_OPTIMIZATION_ACTUAL _Pragma("clang optimize off")
+#define PRAGMA_ENABLE_OPTIMIZATION_ACTUAL  _Pragma("clang optimize on")
+#else
+#define PRAGMA_DISABLE_OPTIMIZATION_ACTUAL _Pragma("GCC push_options") _Pragma("GCC optimize (\"O0\")")
+#define PRAGMA_ENABLE_OPTIMIZATION_ACTUAL  _Pragma("GCC pop_options")
+#endif
+
+// Disable optimization of a specific function
+#define DISABLE_FUNCTION_OPTIMIZATION	__attribute__((optnone))
+
+// Alignment.
+#define GCC_PACK(n) __attribute__((packed,aligned(n)))
+#define GCC_ALIGN(n) __attribute__((aligned(n)))
+
+// Pragmas
+#define MSVC_PRAGMA(Pragma)
+
+// Prefetch
+#define PLATFORM_CACHE_LINE_SIZE	64
+
+// DLL export and import definitions
+#define DLLEXPORT			__attribute__((visibility("default")))
+#define DLLIMPORT			__attribute__((visibility("default")))
+
+// Strings.
+#define LINE_TERMINATOR TEXT("\n")
+#define LINE_TERMINATOR_ANSI "\n"
+
+// Other macros
+#define DECLARE_UINT64(x)	x##ULL
+
+#include <limits.h>
+
+// Parameter annotations, which come from the system headers on Windows.
+#ifndef OUT
+#define OUT
+#endif
+
+#ifndef IN
+#define IN
+#endif
@@ -0,0 +1,112 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "GenericPlatform/GenericPlatformAtomics.h"
+
+/**
+* Linux implementation of the Atomics OS functions (GCC/Clang builtins)
+*/
+struct CORE_API YLinuxPlatformAtomics
+	: public YGenericPlatformAtomics
+{
+	static FORCEINLINE int32 InterlockedIncrement(volatile int32* Value)
+	{
+		return __sync_fetch_and_add(Value, 1) + 1;
+	}
+
+	static FORCEINLINE int64 InterlockedIncrement(volatile int64* Value)
+	{
+		return __sync_fetch_and_add(Value, 1) + 1;
+	}
+
+	static FORCEINLINE int32 InterlockedDecrement(volatile int32* Value)
+	{
+		return __sync_fetch_and_sub(Value, 1) - 1;
+	}
+
+	static FORCEINLINE int64 InterlockedDecrement(volatile int64* Value)
+	{
+		return __sync_fetch_and_sub(Value, 1) - 1;
+	}
+
+	static FORCEINLINE int32 InterlockedAdd(volatile int32* Value, int32 Amount)
+	{
+		return __sync_fetch_and_add(Value, Amount);
+	}
+
+	static FORCEINLINE int64 InterlockedAdd(volatile int64* Value, int64 Amount)
+	{
+		return __sync_fetch_and_add(Value, Amount);
+	}
+
+	static FORCEINLINE int32 InterlockedExchange(volatile int32* Value, int32 Exchange)
+	{
+		return __sync_lock_test_and_set(Value, Exchange);
+	}
+
+	static FORCEINLINE int64 InterlockedExchange(volatile int64* Value, int64 Exchange)
+	{
+		return __sync_lock_test_and_set(Value, Exchange);
+	}
+
+	static FORCEINLINE void* InterlockedExchangePtr(void** Dest, void* Exchange)
+	{
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+		if (IsAligned(Dest) == false)
+		{
+			HandleAtomicsFailure(TEXT("InterlockedExchangePointer requires Dest pointer to be aligned to %d bytes"), (int)sizeof(void*));
+		}
+#endif
+
+		return __sync_lock_test_and_set(Dest, Exchange);
+	}
+
+	static FORCEINLINE int32 InterlockedCompareExchange(volatile int32* Dest, int32 Exchange, int32 Comparand)
+	{
+		return __sync_val_compare_and_swap(Dest, Comparand, Exchange);
+	}
+
+	static FORCEINLINE int64 InterlockedCompareExchange(volatile int64* Dest, int64 Exchange, int64 Comparand)
+	{
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+		if (IsAligned(Dest) == false)
+		{
+			HandleAtomicsFailure(TEXT("InterlockedCompareExchangePointer requires Dest pointer to be aligned to %d bytes"), (int)sizeof(void*));
+		}
+#endif
+
+		return __sync_val_compare_and_swap(Dest, Comparand, Exchange);
+	}
+
+	static FORCEINLINE void* InterlockedCompareExchangePointer(void** Dest, void* Exchange, void* Comparand)
+	{
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+		if (IsAligned(Dest) == false)
+		{
+			HandleAtomicsFailure(TEXT("InterlockedCompareExchangePointer requires Dest pointer to be aligned to %d bytes"), (int)sizeof(void*));
+		}
+#endif
+
+		return __sync_val_compare_and_swap(Dest, Comparand, Exchange);
+	}
+
+	static FORCEINLINE bool CanUseCompareExchange128()
+	{
+		return false;
+	}
+
+protected:
+	/**
+	* Handles atomics function failure.
+	*
+	* Since 'check' has not yet been declared here we need to call external function to use it.
+	*
+	* @param InFormat - The string format string.
+	*/
+	static void HandleAtomicsFailure(const TCHAR* InFormat, ...);
+};
+
+
+typedef YLinuxPlatformAtomics FPlatformAtomics;
@@ -0,0 +1,57 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#ifndef DISABLE_DEPRECATION
+#define DEPRECATED(VERSION, MESSAGE) __attribute__((deprecated(MESSAGE " Please update your code to the new API before upgrading to the next release, otherwise your project will no longer compile.")))
+
+#define PRAGMA_DISABLE_DEPRECATION_WARNINGS \
+			_Pragma ("GCC diagnostic push") \
+			_Pragma ("GCC diagnostic ignored \"-Wdeprecated-declarations\"")
+
+#define PRAGMA_ENABLE_DEPRECATION_WARNINGS \
+			_Pragma ("GCC diagnostic pop")
+#endif // DISABLE_DEPRECATION
+
+#ifndef PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+#define PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS \
+			_Pragma ("GCC diagnostic push") \
+			_Pragma ("GCC diagnostic ignored \"-Wshadow\"")
+#endif // PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+#ifndef PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
+#define PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS \
+			_Pragma("GCC diagnostic pop")
+#endif // PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
+
+#ifndef PRAGMA_DISABLE_UNDEFINED_IDENTIFIER_WARNINGS
+#define PRAGMA_DISABLE_UNDEFINED_IDENTIFIER_WARNINGS \
+			_Pragma("GCC diagnostic push") \
+			_Pragma("GCC diagnostic ignored \"-Wundef\"")
+#endif // PRAGMA_DISABLE_UNDEFINED_IDENTIFIER_WARNINGS
+
+#ifndef PRAGMA_ENABLE_UNDEFINED_IDENTIFIER_WARNINGS
+#define PRAGMA_ENABLE_UNDEFINED_IDENTIFIER_WARNINGS \
+			_Pragma("GCC diagnostic pop")
+#endif // PRAGMA_ENABLE_UNDEFINED_IDENTIFIER_WARNINGS
+
+#ifndef PRAGMA_POP
+#define PRAGMA_POP \
+			_Pragma("GCC diagnostic pop")
+#endif // PRAGMA_POP
+
+// Disable common CA warnings around SDK includes
+#ifndef THIRD_PARTY_INCLUDES_START
+#define THIRD_PARTY_INCLUDES_START \
+			PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS \
+			PRAGMA_DISABLE_UNDEFINED_IDENTIFIER_WARNINGS
+#endif
+
+#ifndef THIRD_PARTY_INCLUDES_END
+#define THIRD_PARTY_INCLUDES_END \
+			PRAGMA_ENABLE_UNDEFINED_IDENTIFIER_WARNINGS \
+			PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
+#endif
+
+#define EMIT_CUSTOM_WARNING_AT_LINE(Line, Warning) \
+	_Pragma(PREPROCESSOR_TO_STRING(message(WARNING_LOCATION(Line) Warning)))
@@ -0,0 +1,16 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#if !PLATFORM_LINUX
+#error PLATFORM_LINUX not defined
+#endif
+
+/**
+* We require at least GCC 5 or Clang 3.5 to compile on Linux platform
+*/
+#if defined(__clang__)
+static_assert(__clang_major__ > 3 || (__clang_major__ == 3 && __clang_minor__ >= 5), "Clang 3.5 or later is required to compile on Linux platform");
+#else
+static_assert(__GNUC__ >= 5, "GCC 5 or later is required to compile on Linux platform");
+#endif
@@ -0,0 +1,100 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+#include "GenericPlatform/GenericPlatformMath.h"
+#include "HAL/Platform.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include "Math/SolidAnglePlatformMathSSE.h"
+#endif
+
+/**
+* Linux implementation of the Math OS functions
+**/
+struct YLinuxPlatformMath : public YGenericPlatformMath
+{
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+	static FORCEINLINE int32 TruncToInt(float F)
+	{
+		return _mm_cvtt_ss2si(_mm_set_ss(F));
+	}
+
+	static FORCEINLINE float TruncToFloat(float F)
+	{
+		return (float)TruncToInt(F); // same as generic implementation, but this will call the faster trunc
+	}
+
+	static FORCEINLINE int32 RoundToInt(float F)
+	{
+		// Note: the x2 is to workaround the rounding-to-nearest-even-number issue when the fraction is .5
+		return _mm_cvt_ss2si(_mm_set_ss(F + F + 0.5f)) >> 1;
+	}
+
+	static FORCEINLINE float RoundToFloat(float F)
+	{
+		return (float)RoundToInt(F);
+	}
+
+	static FORCEINLINE int32 FloorToInt(float F)
+	{
+		return _mm_cvt_ss2si(_mm_set_ss(F + F - 0.5f)) >> 1;
+	}
+
+	static FORCEINLINE float FloorToFloat(float F)
+	{
+		return (float)FloorToInt(F);
+	}
+
+	static FORCEINLINE int32 CeilToInt(float F)
+	{
+		// Note: the x2 is to workaround the rounding-to-nearest-even-number issue when the fraction is .5
+		return -(_mm_cvt_ss2si(_mm_set_ss(-0.5f - (F + F))) >> 1);
+	}
+
+	static FORCEINLINE float CeilToFloat(float F)
+	{
+		// Note: the x2 is to workaround the rounding-to-nearest-even-number issue when the fraction is .5
+		return (float)CeilToInt(F);
+	}
+
+	static FORCEINLINE float InvSqrt(float F)
+	{
+		return SolidAnglePlatformMathSSE::InvSqrt(F);
+	}
+
+	static FORCEINLINE float InvSqrtEst(float F)
+	{
+		return SolidAnglePlatformMathSSE::InvSqrtEst(F);
+	}
+#endif
+
+	static FORCEINLINE bool IsNaN(float A) { return __builtin_isnan(A) != 0; }
+	static FORCEINLINE bool IsFinite(float A) { return __builtin_isfinite(A) != 0; }
+
+	static FORCEINLINE uint32 FloorLog2(uint32 Value)
+	{
+		// Use BSR through the builtin; the zero case is undefined for __builtin_clz
+		return Value == 0 ? 0 : 31 - __builtin_clz(Value);
+	}
+	static FORCEINLINE uint32 CountLeadingZeros(uint32 Value)
+	{
+		return Value == 0 ? 32 : __builtin_clz(Value);
+	}
+	static FORCEINLINE uint32 CountTrailingZeros(uint32 Value)
+	{
+		return Value == 0 ? 32 : __builtin_ctz(Value);
+	}
+	static FORCEINLINE uint32 CeilLogTwo(uint32 Arg)
+	{
+		int32 Bitmask = ((int32)(CountLeadingZeros(Arg) << 26)) >> 31;
+		return (32 - CountLeadingZeros(Arg - 1)) & (~Bitmask);
+	}
+	static FORCEINLINE uint32 RoundUpToPowerOfTwo(uint32 Arg)
+	{
+		return 1 << CeilLogTwo(Arg);
+	}
+};
+
+typedef YLinuxPlatformMath	YPlatformMath;
@@ -0,0 +1,77 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+#include "CoreTypes.h"
+#include "GenericPlatform/GenericPlatformMemory.h"
+
+class YString;
+class YMalloc;
+struct YGenericMemoryStats;
+
+/**
+*	Linux implementation of the FGenericPlatformMemoryStats.
+*	At this moment it's just the same as the FGenericPlatformMemoryStats.
+*/
+struct YPlatformMemoryStats
+	: public YGenericPlatformMemoryStats
+{
+	/** Default constructor, clears all variables. */
+	YPlatformMemoryStats()
+		: YGenericPlatformMemoryStats()
+	{ }
+};
+
+
+/**
+* Linux implementation of the memory OS functions
+**/
+struct CORE_API YLinuxPlatformMemory
+	: public YGenericPlatformMemory
+{
+	/**
+	* Linux representation of a shared memory region
+	*/
+	struct FLinuxSharedMemoryRegion : public YSharedMemoryRegion
+	{
+		/** Returns file descriptor of a shared memory object */
+		int GetFileDescriptor() const { return Fd; }
+
+		/** Returns true if we need to unlink this region on destruction (no other process will be able to access it) */
+		bool NeedsToUnlinkRegion() const { return bCreatedThisRegion; }
+
+		FLinuxSharedMemoryRegion(const YString& InName, uint32 InAccessMode, void* InAddress, SIZE_T InSize, int InFd, bool bInCreatedThisRegion)
+			: YSharedMemoryRegion(InName, InAccessMode, InAddress, InSize)
+			, Fd(InFd)
+			, bCreatedThisRegion(bInCreatedThisRegion)
+		{}
+
+	protected:
+
+		/** File descriptor of a shared region */
+		int				Fd;
+
+		/** Whether we created this region */
+		bool			bCreatedThisRegion;
+	};
+
+	//~ Begin YGenericPlatformMemory Interface
+	static void					Init();
+	static class YMalloc*		BaseAllocator();
+	static YPlatformMemoryStats GetStats();
+	static const YPlatformMemoryConstants& GetConstants();
+	static bool					PageProtect(void* const Ptr, const SIZE_T Size, const bool bCanRead, const bool bCanWrite);
+	static void*				BinnedAllocFromOS(SIZE_T Size);
+	static void					BinnedFreeToOS(void* Ptr, SIZE_T Size);
+	static bool					BinnedTryExtendInPlace(void* Ptr, SIZE_T OldSize, SIZE_T NewSize);
+	static void*				HugePageAllocFromOS(SIZE_T Size, bool& bOutHugePages);
+	static void					HugePageFreeToOS(void* Ptr, SIZE_T Size);
+	static uint32				GetNumaNodeCount();
+	static uint32				GetCurrentNumaNode();
+	static void*				NumaAllocFromOS(SIZE_T Size, uint32 Node);
+	static YSharedMemoryRegion* MapNamedSharedMemoryRegion(const YString& InName, bool bCreate, uint32 AccessMode, SIZE_T Size);
+	static bool					UnmapNamedSharedMemoryRegion(YSharedMemoryRegion * MemoryRegion);
+	//~ End YGenericPlatformMemory Interface
+};
+
+
+typedef YLinuxPlatformMemory YPlatformMemory;
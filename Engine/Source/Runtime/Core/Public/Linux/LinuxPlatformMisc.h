@@ -0,0 +1,94 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "HAL/PlatformMemory.h"
+#include "GenericPlatform/GenericPlatformMisc.h"
+#include <signal.h>
+
+struct YGuid;
+
+/**
+* Linux implementation of the misc OS functions
+**/
+struct CORE_API YLinuxPlatformMisc
+	: public YGenericPlatformMisc
+{
+	static void PlatformPreInit();
+	static void PlatformInit();
+	static void SetGracefulTerminationHandler();
+	static void GetEnvironmentVariable(const TCHAR* VariableName, TCHAR* Result, int32 ResultLength);
+	static void SetEnvironmentVar(const TCHAR* VariableName, const TCHAR* Value);
+	static TArray<uint8> GetMacAddress();
+
+#if !UE_BUILD_SHIPPING
+	static bool IsDebuggerPresent();
+	FORCEINLINE static void DebugBreak()
+	{
+		if (IsDebuggerPresent())
+		{
+			raise(SIGTRAP);
+		}
+	}
+#endif
+
+	/** Break into debugger. Returning false allows this function to be used in conditionals. */
+	FORCEINLINE static bool DebugBreakReturningFalse()
+	{
+#if !UE_BUILD_SHIPPING
+		DebugBreak();
+#endif
+		return false;
+	}
+
+	/** Break into debugger. Returning false allows this function to be used in conditionals. */
+	FORCEINLINE static bool DebugBreakAndPromptForRemoteReturningFalse(bool bIsEnsure = false)
+	{
+#if !UE_BUILD_SHIPPING
+		DebugBreak();
+#endif
+		return false;
+	}
+
+	static void LocalPrint(const TCHAR *Message);
+	static void RequestExit(bool Force);
+	static const TCHAR* GetSystemErrorMessage(TCHAR* OutBuffer, int32 BufferCount, int32 Error);
+	static void CreateGuid(struct YGuid& Result);
+	static bool Is64bitOperatingSystem();
+	static int32 NumberOfCores();
+	static int32 NumberOfCoresIncludingHyperthreads();
+	static void GetProcessorTopology(TArray<FProcessorTopology>& OutProcessors);
+	static uint32 GetLastError();
+
+	FORCEINLINE static void MemoryBarrier()
+	{
+		__sync_synchronize();
+	}
+
+	FORCEINLINE static void PrefetchBlock(const void* InPtr, int32 NumBytes = 1)
+	{
+		const char* Ptr = static_cast<const char*>(InPtr);
+		const int32 CacheLineSize = PLATFORM_CACHE_LINE_SIZE;
+		for (int32 LinesToPrefetch = (NumBytes + CacheLineSize - 1) / CacheLineSize; LinesToPrefetch; --LinesToPrefetch)
+		{
+			__builtin_prefetch(Ptr);
+			Ptr += CacheLineSize;
+		}
+	}
+
+	/** Platform-specific instruction prefetch */
+	FORCEINLINE static void Prefetch(void const* x, int32 offset = 0)
+	{
+		__builtin_prefetch(static_cast<const char*>(x) + offset);
+	}
+
+	static YString GetCPUVendor();
+	static YString GetCPUBrand();
+	static uint32 GetCPUInfo();
+	static void GetOSVersions(YString& out_OSVersionLabel, YString& out_OSSubVersionLabel);
+	static bool GetDiskTotalAndFreeSpace(const YString& InPath, uint64& TotalNumberOfBytes, uint64& NumberOfFreeBytes);
+	static YString GetOperatingSystemId();
+};
+
+typedef YLinuxPlatformMisc YPlatformMisc;
@@ -0,0 +1,17 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "GenericPlatform/GenericPlatformOutputDevices.h"
+
+/**
+ * Linux output devices. The generic file log, ANSI error and ANSI feedback context are used as is.
+ */
+struct CORE_API YLinuxPlatformOutputDevices
+	: public YGenericPlatformOutputDevices
+{
+};
+
+
+typedef YLinuxPlatformOutputDevices YPlatformOutputDevices;
@@ -0,0 +1,85 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "GenericPlatform/GenericPlatformProcess.h"
+#include <sys/types.h>
+
+class FEvent;
+class FRunnableThread;
+
+/** Linux implementation of the process handle. */
+struct FProcHandle : public TProcHandle<pid_t, -1>
+{
+public:
+	/** Default constructor. */
+	FORCEINLINE FProcHandle()
+		: TProcHandle()
+		, bIsRunning(false)
+		, bHasBeenWaitedFor(false)
+		, ReturnCode(-1)
+	{}
+
+	/** Initialization constructor. */
+	FORCEINLINE explicit FProcHandle(HandleType Other)
+		: TProcHandle(Other)
+		, bIsRunning(Other != -1)
+		, bHasBeenWaitedFor(false)
+		, ReturnCode(-1)
+	{}
+
+	/** Whether the child was still running the last time we polled it. */
+	bool bIsRunning;
+
+	/** Whether the child has been reaped with waitpid(). */
+	bool bHasBeenWaitedFor;
+
+	/** Exit code of the child, only valid once bHasBeenWaitedFor is set. */
+	int32 ReturnCode;
+};
+
+
+/**
+* Linux implementation of the Process OS functions.
+**/
+struct CORE_API FLinuxPlatformProcess
+	: public FGenericPlatformProcess
+{
+public:
+
+	// FGenericPlatformProcess interface
+
+	static void* GetDllHandle(const TCHAR* Filename);
+	static void FreeDllHandle(void* DllHandle);
+	static void* GetDllExport(void* DllHandle, const TCHAR* ProcName);
+	static uint32 GetCurrentProcessId();
+	static void SetThreadAffinityMask(uint64 AffinityMask);
+	static const TCHAR* BaseDir();
+	static const TCHAR* UserDir();
+	static const TCHAR* UserTempDir();
+	static const TCHAR* UserSettingsDir();
+	static const TCHAR* ApplicationSettingsDir();
+	static const TCHAR* ComputerName();
+	static const TCHAR* UserName(bool bOnlyAlphaNumeric = true);
+	static void SetCurrentWorkingDirectoryToBaseDir();
+	static YString GetCurrentWorkingDirectory();
+	static const TCHAR* ExecutableName(bool bRemoveExtension = true);
+	static const TCHAR* GetModulePrefix();
+	static const TCHAR* GetModuleExtension();
+	static const TCHAR* GetBinariesSubdirectory();
+	static FProcHandle CreateProc(const TCHAR* URL, const TCHAR* Parms, bool bLaunchDetached, bool bLaunchHidden, bool bLaunchReallyHidden, uint32* OutProcessID, int32 PriorityModifier, const TCHAR* OptionalWorkingDirectory, void* PipeWriteChild, void * PipeReadChild = nullptr);
+	static bool IsProcRunning(FProcHandle & ProcessHandle);
+	static void WaitForProc(FProcHandle & ProcessHandle);
+	static void CloseProc(FProcHandle & ProcessHandle);
+	static void TerminateProc(FProcHandle & ProcessHandle, bool KillTree = false);
+	static bool GetProcReturnCode(FProcHandle & ProcHandle, int32* ReturnCode);
+	static bool IsApplicationRunning(uint32 ProcessId);
+	static YString GetApplicationName(uint32 ProcessId);
+	static bool GetApplicationMemoryUsage(uint32 ProcessId, SIZE_T* OutMemoryUsage);
+	static bool IsThisApplicationForeground();
+	static bool ExecProcess(const TCHAR* URL, const TCHAR* Params, int32* OutReturnCode, YString* OutStdOut, YString* OutStdErr);
+};
+
+
+typedef FLinuxPlatformProcess FPlatformProcess;
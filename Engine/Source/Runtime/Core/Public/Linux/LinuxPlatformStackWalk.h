@@ -0,0 +1,23 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "GenericPlatform/GenericPlatformStackWalk.h"
+
+
+/**
+* Linux implementation of the stack walking.
+*
+* Uses glibc backtrace() for capture and dladdr() for symbolication, so only exported
+* (or -rdynamic linked) symbols resolve to function names; file and line are not available.
+**/
+struct CORE_API FLinuxPlatformStackWalk
+	: public FGenericPlatformStackWalk
+{
+	static void ProgramCounterToSymbolInfo(uint64 ProgramCounter, FProgramCounterSymbolInfo& out_SymbolInfo);
+	static void CaptureStackBackTrace(uint64* BackTrace, uint32 MaxDepth, void* Context = nullptr);
+};
+
+
+typedef FLinuxPlatformStackWalk FPlatformStackWalk;
@@ -0,0 +1,20 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "GenericPlatform/StandardPlatformString.h"
+
+
+/**
+* Linux string implementation.
+*
+* TCHAR is a 4-byte wchar_t here, so the wcs* based standard implementation is used as is.
+*/
+struct YLinuxPlatformString
+	: public FStandardPlatformString
+{
+};
+
+
+typedef YLinuxPlatformString FPlatformString;
@@ -0,0 +1,18 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "GenericPlatform/GenericPlatformSurvey.h"
+
+
+/**
+ * Linux implementation of FGenericPlatformSurvey. The hardware survey is not supported.
+ */
+struct FLinuxPlatformSurvey
+	: public FGenericPlatformSurvey
+{
+};
+
+
+typedef FLinuxPlatformSurvey FPlatformSurvey;
@@ -0,0 +1,95 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "GenericPlatform/GenericPlatformTLS.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+
+/**
+* Linux implementation of the TLS OS functions.
+*/
+struct CORE_API YLinuxPlatformTLS
+	: public YGenericPlatformTLS
+{
+	/**
+	* Returns the currently executing thread's identifier.
+	*
+	* @return The thread identifier.
+	*/
+	static FORCEINLINE uint32 GetCurrentThreadId(void)
+	{
+		// syscall() is relatively expensive, so the kernel thread id is cached per thread
+		static __thread uint32 ThreadIdTLS = 0;
+		if (ThreadIdTLS == 0)
+		{
+			ThreadIdTLS = static_cast<uint32>(syscall(SYS_gettid));
+		}
+		return ThreadIdTLS;
+	}
+
+	/**
+	* Allocates a thread local store slot.
+	*
+	* @return The index of the allocated slot.
+	*/
+	static FORCEINLINE uint32 AllocTlsSlot(void)
+	{
+		// allocate a per-thread mem slot
+		pthread_key_t Key = 0;
+		if (pthread_key_create(&Key, nullptr) != 0)
+		{
+			return static_cast<uint32>(INDEX_NONE);
+		}
+
+		// callers treat slot 0 as not allocated yet, so key 0 is kept reserved and another one is handed out
+		if (Key == 0)
+		{
+			pthread_key_t NextKey = 0;
+			if (pthread_key_create(&NextKey, nullptr) != 0)
+			{
+				return static_cast<uint32>(INDEX_NONE);
+			}
+			Key = NextKey;
+		}
+		return static_cast<uint32>(Key);
+	}
+
+	/**
+	* Sets a value in the specified TLS slot.
+	*
+	* @param SlotIndex the TLS index to store it in.
+	* @param Value the value to store in the slot.
+	*/
+	static FORCEINLINE void SetTlsValue(uint32 SlotIndex, void* Value)
+	{
+		pthread_setspecific(static_cast<pthread_key_t>(SlotIndex), Value);
+	}
+
+	/**
+	* Reads the value stored at the specified TLS slot.
+	*
+	* @param SlotIndex The index of the slot to read.
+	* @return The value stored in the slot.
+	*/
+	static FORCEINLINE void* GetTlsValue(uint32 SlotIndex)
+	{
+		return pthread_getspecific(static_cast<pthread_key_t>(SlotIndex));
+	}
+
+	/**
+	* Frees a previously allocated TLS slot
+	*
+	* @param SlotIndex the TLS index to store it in
+	*/
+	static FORCEINLINE void FreeTlsSlot(uint32 SlotIndex)
+	{
+		pthread_key_delete(static_cast<pthread_key_t>(SlotIndex));
+	}
+};
+
+
+typedef YLinuxPlatformTLS YPlatformTLS;
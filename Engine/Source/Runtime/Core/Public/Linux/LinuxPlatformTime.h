@@ -0,0 +1,54 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "GenericPlatform/GenericPlatformTime.h"
+#include <time.h>
+
+
+/**
+* Linux implementation of the Time OS functions.
+*
+* Uses CLOCK_MONOTONIC through clock_gettime(), which on modern kernels is serviced by the vDSO
+* without a syscall. 32-bit cycles are counted in microseconds and 64-bit cycles in 100ns ticks.
+*/
+struct CORE_API FLinuxPlatformTime
+	: public FGenericPlatformTime
+{
+	static double InitTiming();
+
+	static FORCEINLINE double Seconds()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+
+		// add big number to make bugs apparent where return value is being passed to float
+		return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9 + 16777216.0;
+	}
+
+	static FORCEINLINE uint32 Cycles()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return static_cast<uint32>(static_cast<uint64>(ts.tv_sec) * 1000000ULL + static_cast<uint64>(ts.tv_nsec) / 1000ULL);
+	}
+
+	static FORCEINLINE uint64 Cycles64()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return static_cast<uint64>(ts.tv_sec) * 10000000ULL + static_cast<uint64>(ts.tv_nsec) / 100ULL;
+	}
+
+	static bool UpdateCPUTime(float DeltaTime);
+	static FCPUTime GetCPUTime();
+
+protected:
+
+	/** Percentage CPU utilization for the last interval relative to one core. */
+	static float CPUTimePctRelative;
+};
+
+
+typedef FLinuxPlatformTime FPlatformTime;
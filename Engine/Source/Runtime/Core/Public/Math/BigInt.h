@@ -649,7 +649,7 @@ public:
 	/**
 	* this < Other
 	*/
-	FORCEINLINE bool IsLess(const BigInt& Other) const
+	bool IsLess(const BigInt& Other) const
 	{
 		if (IsNegative())
 		{
@@ -670,7 +670,7 @@ public:
 	/**
 	* this <= Other
 	*/
-	FORCEINLINE bool IsLessOrEqual(const BigInt& Other) const
+	bool IsLessOrEqual(const BigInt& Other) const
 	{
 		if (IsNegative())
 		{
@@ -691,7 +691,7 @@ public:
 	/**
 	* this > Other
 	*/
-	FORCEINLINE bool IsGreater(const BigInt& Other) const
+	bool IsGreater(const BigInt& Other) const
 	{
 		if (IsNegative())
 		{
@@ -712,7 +712,7 @@ public:
 	/**
 	* this >= Other
 	*/
-	FORCEINLINE bool IsGreaterOrEqual(const BigInt& Other) const
+	bool IsGreaterOrEqual(const BigInt& Other) const
 	{
 		if (IsNegative())
 		{
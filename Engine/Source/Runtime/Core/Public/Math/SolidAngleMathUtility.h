@@ -520,7 +520,7 @@ struct YMath :public YPlatformMath
 
 	// Performs a 2D linear interpolation between four values, FracX, FracY ranges form 0~1
 	template< class T, class U>
-	static FORCEINLINE T		BiLerp(const T& P00, const T& P10, const T& P01, const T& p11, const U& FracX, const U& FracY)
+	static FORCEINLINE T		BiLerp(const T& P00, const T& P10, const T& P01, const T& P11, const U& FracX, const U& FracY)
 	{
 		return Lerp(Lerp(P00, P10, FracX), Lerp(P01, P11, FracX), FracY);
 	}
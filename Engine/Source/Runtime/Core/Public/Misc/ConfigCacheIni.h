@@ -147,7 +147,8 @@ private:
 	/** Internal version of ExpandValue that expands SavedValue into ExpandedValue, or produces an empty ExpandedValue if no expansion occurred. */
 	void ExpandValueInternal()
 	{
-		if (!ExpandValue(SavedValue, ExpandedValue))
+		// every placeholder starts with a %, most values have none and need neither the copy nor the directories looked up
+		if (!FCString::Strchr(*SavedValue, TEXT('%')) || !ExpandValue(SavedValue, ExpandedValue))
 		{
 			ExpandedValue.Empty();
 		}
@@ -0,0 +1,406 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Misc/AssertionMacros.h"
+#include "HAL/SolidAngleMemory.h"
+#include "HAL/PlatformTLS.h"
+#include "Math/SolidAngleMathUtility.h"
+#include "Templates/AlignmentTemplates.h"
+#include "Containers/ContainerAllocationPolicies.h"
+#include "Misc/MemStack.h"
+
+class FMemArenaMark;
+
+/**
+* Linear allocator for temporary allocations, like FMemStack but not tied to a thread.
+* - Chunks grow geometrically from one FPageAllocator page up to MaxChunkSize, so large temporaries don't end up in many small chunks.
+* - Popping a mark or resetting keeps the chunks for reuse, so an arena that is reset every frame or task stops touching GMalloc.
+* - The arena belongs to one thread at a time; the owner can release it and another thread acquire it, e.g. to hand results to a task.
+* - Tracks the high-water mark of the bytes in use.
+**/
+class CORE_API FMemArena
+{
+public:
+	enum
+	{
+		DefaultMaxChunkSize = 16 * FPageAllocator::PageSize
+	};
+
+	/**
+	* @param InMaxChunkSize size the chunks stop growing at, larger allocations still get a chunk of their own
+	*/
+	explicit FMemArena(int32 InMaxChunkSize = DefaultMaxChunkSize);
+
+	~FMemArena();
+
+	FORCEINLINE uint8* PushBytes(int32 AllocSize, int32 Alignment)
+	{
+		return (uint8*)Alloc(AllocSize, YMath::Max(AllocSize >= 16 ? (int32)16 : (int32)8, Alignment));
+	}
+
+	FORCEINLINE void* Alloc(int32 AllocSize, int32 Alignment)
+	{
+		// Debug checks.
+		checkSlow(AllocSize >= 0);
+		checkSlow((Alignment&(Alignment - 1)) == 0);
+		checkSlow(Top <= End);
+		checkSlow(IsOwnedByCurrentThread());
+
+		// Try to get memory from the current chunk.
+		uint8* Result = Align(Top, Alignment);
+		uint8* NewTop = Result + AllocSize;
+
+		if (NewTop > End)
+		{
+			// We'd pass the end of the current chunk, so move to a new one.
+			AllocateNewChunk(AllocSize + Alignment);
+			Result = Align(Top, Alignment);
+			NewTop = Result + AllocSize;
+		}
+		Top = NewTop;
+		return Result;
+	}
+
+	/**
+	* Resizes the most recent allocation if it is still at the top of the arena and the current chunk has room.
+	* Allocations made before the topmost mark are never resized, as popping the mark would free what they grew into.
+	*
+	* @return true if Ptr now holds NewSize bytes
+	*/
+	FORCEINLINE bool TryResizeInPlace(void* Ptr, int32 OldSize, int32 NewSize);
+
+	/**
+	* Makes the marks pushed after Ptr was allocated keep everything allocated so far. Used when an allocation made before
+	* a mark is moved to the top of the arena, e.g. by a container growing, so that popping the mark doesn't free it.
+	* Whatever was allocated after those marks until now is only freed by an outer mark or Reset.
+	*/
+	void RaiseMarksAbove(const void* Ptr);
+
+	/** Frees everything allocated from the arena. The chunks are kept for the next allocations, see Trim. */
+	void Reset();
+
+	/** Returns the chunks kept by Reset and popped marks to the page allocator. */
+	void Trim();
+
+	/** @return the number of bytes currently in use. */
+	SIZE_T GetByteCount() const
+	{
+		return UsedBytesBelowTopChunk + (TopChunk ? SIZE_T(Top - TopChunk->Data()) : 0);
+	}
+
+	/** @return the number of bytes held in chunks, in use or not. */
+	FORCEINLINE SIZE_T GetAllocatedSize() const
+	{
+		return ReservedBytes;
+	}
+
+	/** @return the largest number of bytes in use since the arena was created or ResetHighWaterMark was called. */
+	SIZE_T GetHighWaterMark() const
+	{
+		return YMath::Max(HighWaterMark, GetByteCount());
+	}
+
+	void ResetHighWaterMark()
+	{
+		HighWaterMark = GetByteCount();
+	}
+
+	/** Returns true if the pointer was allocated from this arena. */
+	bool ContainsPointer(const void* Pointer) const;
+
+	FORCEINLINE bool IsOwnedByCurrentThread() const
+	{
+		return OwnerThreadId == int32(YPlatformTLS::GetCurrentThreadId());
+	}
+
+	/** Gives up ownership so that another thread can acquire the arena. Must be called by the owner, with no marks outstanding. */
+	void ReleaseOwnership();
+
+	/** Makes the calling thread the owner of an arena released by another thread. */
+	void AcquireOwnership();
+
+	/** @return the arena set with FMemArenaScope on the calling thread, or nullptr. */
+	static FMemArena* GetCurrent()
+	{
+		return (FMemArena*)YPlatformTLS::GetTlsValue(CurrentTlsSlot);
+	}
+
+private:
+	FMemArena(const FMemArena&);
+	FMemArena& operator=(const FMemArena&);
+
+	friend class FMemArenaMark;
+	friend class FMemArenaScope;
+
+	struct FChunk
+	{
+		FChunk* Next;
+		int32 DataSize;
+
+		uint8* Data() const
+		{
+			return ((uint8*)this) + sizeof(FChunk);
+		}
+	};
+
+	/** Moves to a spare chunk of at least MinSize bytes, or allocates a new one. */
+	void AllocateNewChunk(int32 MinSize);
+
+	/** Moves the chunks above NewTopChunk to the spare list and restores the top of the arena. */
+	void Rewind(FChunk* NewTopChunk, uint8* NewTop, SIZE_T NewUsedBytesBelowTopChunk);
+
+	/** Returns a chunk to where it was allocated from. */
+	void FreeChunk(FChunk* Chunk);
+
+	/** Returns true if Ptr was allocated before the mark was pushed. */
+	bool IsBelowMark(const void* Ptr, const FMemArenaMark& Mark) const;
+
+	uint8*  Top;
+	uint8*  End;
+	FChunk* TopChunk;
+	/** Chunks kept by Rewind, oldest first. */
+	FChunk* SpareChunks;
+
+	SIZE_T UsedBytesBelowTopChunk;
+	SIZE_T ReservedBytes;
+	SIZE_T HighWaterMark;
+
+	int32 MaxChunkSize;
+	int32 LastChunkSize;
+
+	FMemArenaMark* TopMark;
+	int32 NumMarks;
+
+	/** Id of the thread allowed to allocate, 0 while the arena is being handed over. */
+	volatile int32 OwnerThreadId;
+
+	static uint32 CurrentTlsSlot;
+};
+
+
+/**
+* Marks the top of an arena; popping the mark frees everything allocated after it.
+* Works like FMemMark, except that the chunks are kept by the arena.
+*/
+class FMemArenaMark
+{
+public:
+	FMemArenaMark(FMemArena& InArena)
+		: Arena(InArena)
+		, Top(InArena.Top)
+		, SavedChunk(InArena.TopChunk)
+		, SavedUsedBytesBelowTopChunk(InArena.UsedBytesBelowTopChunk)
+		, bPopped(false)
+		, NextTopmostMark(InArena.TopMark)
+	{
+		checkSlow(Arena.IsOwnedByCurrentThread());
+		Arena.TopMark = this;
+		Arena.NumMarks++;
+	}
+
+	~FMemArenaMark()
+	{
+		Pop();
+	}
+
+	/** Free the memory allocated after the mark was created. */
+	void Pop()
+	{
+		if (!bPopped)
+		{
+			check(Arena.TopMark == this);
+			bPopped = true;
+			--Arena.NumMarks;
+
+			Arena.Rewind(SavedChunk, Top, SavedUsedBytesBelowTopChunk);
+			Arena.TopMark = NextTopmostMark;
+			Top = nullptr;
+		}
+	}
+
+private:
+	friend class FMemArena;
+
+	FMemArena& Arena;
+	uint8* Top;
+	FMemArena::FChunk* SavedChunk;
+	SIZE_T SavedUsedBytesBelowTopChunk;
+	bool bPopped;
+	FMemArenaMark* NextTopmostMark;
+};
+
+
+FORCEINLINE bool FMemArena::TryResizeInPlace(void* Ptr, int32 OldSize, int32 NewSize)
+{
+	checkSlow(IsOwnedByCurrentThread());
+	uint8* Base = (uint8*)Ptr;
+	// anything in a chunk above the one the mark saved was allocated after the mark
+	const bool bBelowTopMark = TopMark && TopChunk == TopMark->SavedChunk && Base < TopMark->Top;
+	if (Base + OldSize == Top && Base + NewSize <= End && !bBelowTopMark)
+	{
+		Top = Base + NewSize;
+		return true;
+	}
+	return false;
+}
+
+
+/** Makes an arena the one TArenaAllocator containers allocate from on the calling thread, for the lifetime of the scope. */
+class FMemArenaScope
+{
+public:
+	FMemArenaScope(FMemArena& Arena)
+		: PreviousArena(FMemArena::GetCurrent())
+	{
+		checkSlow(Arena.IsOwnedByCurrentThread());
+		YPlatformTLS::SetTlsValue(FMemArena::CurrentTlsSlot, &Arena);
+	}
+
+	~FMemArenaScope()
+	{
+		YPlatformTLS::SetTlsValue(FMemArena::CurrentTlsSlot, PreviousArena);
+	}
+
+private:
+	FMemArena* PreviousArena;
+};
+
+
+/**
+* A container allocator that allocates from an FMemArena.
+* The arena is the one set with FMemArenaScope when the container first allocates; the container keeps using it afterwards,
+* so it can be resized on whatever thread owns the arena at the time. Freed memory is only reclaimed when the arena is reset,
+* except that growing or shrinking the most recent allocation happens in place. A container that grows while a mark pushed after
+* its first allocation is outstanding keeps the memory of the mark alive until an outer mark is popped or the arena is reset.
+*/
+template<uint32 Alignment = DEFAULT_ALIGNMENT>
+class TArenaAllocator
+{
+public:
+
+	enum { NeedsElementType = true };
+	enum { RequireRangeCheck = true };
+
+	template<typename ElementType>
+	class ForElementType
+	{
+	public:
+
+		/** Default constructor. */
+		ForElementType()
+			: Data(nullptr)
+			, Arena(nullptr)
+			, AllocatedBytes(0)
+		{}
+
+		/**
+		* Moves the state of another allocator into this one.
+		* @param Other - The allocator to move the state from.  This allocator should be left in a valid empty state.
+		*/
+		FORCEINLINE void MoveToEmpty(ForElementType& Other)
+		{
+			checkSlow(this != &Other);
+
+			Data           = Other.Data;
+			Arena          = Other.Arena;
+			AllocatedBytes = Other.AllocatedBytes;
+
+			Other.Data           = nullptr;
+			Other.AllocatedBytes = 0;
+		}
+
+		// FContainerAllocatorInterface
+		FORCEINLINE ElementType* GetAllocation() const
+		{
+			return Data;
+		}
+		void ResizeAllocation(int32 PreviousNumElements, int32 NumElements, int32 NumBytesPerElement)
+		{
+			const int32 NewBytes = NumElements * NumBytesPerElement;
+			if (Data && Arena->TryResizeInPlace(Data, AllocatedBytes, NewBytes))
+			{
+				AllocatedBytes = NewBytes;
+				if (!NumElements)
+				{
+					Data = nullptr;
+				}
+				return;
+			}
+
+			void* OldData = Data;
+			Data = nullptr;
+			AllocatedBytes = 0;
+			if (NumElements)
+			{
+				if (!Arena)
+				{
+					Arena = FMemArena::GetCurrent();
+					checkf(Arena, TEXT("TArenaAllocator containers must first allocate inside an FMemArenaScope"));
+				}
+
+				// Allocate memory from the arena.
+				Data = (ElementType*)Arena->PushBytes(NewBytes, YMath::Max(Alignment, (uint32)ALIGNOF(ElementType)));
+				AllocatedBytes = NewBytes;
+
+				// If the container previously held elements, copy them into the new allocation.
+				if (OldData && PreviousNumElements)
+				{
+					const int32 NumCopiedElements = YMath::Min(NumElements, PreviousNumElements);
+					YMemory::Memcpy(Data, OldData, NumCopiedElements * NumBytesPerElement);
+				}
+
+				// A container made before a mark must outlive it
+				if (OldData)
+				{
+					Arena->RaiseMarksAbove(OldData);
+				}
+			}
+		}
+		FORCEINLINE int32 CalculateSlackReserve(int32 NumElements, int32 NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackReserve(NumElements, NumBytesPerElement, false, Alignment);
+		}
+		FORCEINLINE int32 CalculateSlackShrink(int32 NumElements, int32 NumAllocatedElements, int32 NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackShrink(NumElements, NumAllocatedElements, NumBytesPerElement, false, Alignment);
+		}
+		FORCEINLINE int32 CalculateSlackGrow(int32 NumElements, int32 NumAllocatedElements, int32 NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackGrow(NumElements, NumAllocatedElements, NumBytesPerElement, false, Alignment);
+		}
+
+		FORCEINLINE int32 GetAllocatedSize(int32 NumAllocatedElements, int32 NumBytesPerElement) const
+		{
+			return NumAllocatedElements * NumBytesPerElement;
+		}
+
+		bool HasAllocation()
+		{
+			return !!Data;
+		}
+
+	private:
+		ForElementType(const ForElementType&);
+		ForElementType& operator=(const ForElementType&);
+
+		/** A pointer to the container's elements. */
+		ElementType* Data;
+		/** The arena Data lives in. */
+		FMemArena* Arena;
+		/** Bytes at Data, needed to resize in place. */
+		int32 AllocatedBytes;
+	};
+
+	typedef ForElementType<FScriptContainerElement> ForAnyElementType;
+};
+
+template <uint32 Alignment>
+struct TAllocatorTraits<TArenaAllocator<Alignment>> : TAllocatorTraitsBase<TArenaAllocator<Alignment>>
+{
+	enum { SupportsMove = true };
+};
+
+/** Set and map allocator keeping elements, the allocation bits and the hash in an FMemArena. */
+typedef TSetAllocator<TSparseArrayAllocator<TArenaAllocator<>, TArenaAllocator<>>, TArenaAllocator<>> FArenaSetAllocator;
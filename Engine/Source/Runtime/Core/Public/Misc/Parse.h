@@ -2,6 +2,8 @@
 
 #include "CoreTypes.h"
 #include "Containers/SolidAngleString.h"
+#include "Containers/InlineString.h"
+#include "Containers/StringView.h"
 
 /*-----------------------------------------------------------------------------
 Parsing functions.
@@ -36,6 +38,8 @@ struct CORE_API FParse
 	static bool Value(const TCHAR* Stream, const TCHAR* Match, int32& Value);
 	/** Parses a string. */
 	static bool Value(const TCHAR* Stream, const TCHAR* Match, YString& Value, bool bShouldStopOnComma = true);
+	/** Parses a string, returning a view into Stream rather than a copy. */
+	static bool Value(const TCHAR* Stream, const TCHAR* Match, YStringView& Value, bool bShouldStopOnComma = true);
 	/** Parses an FText. */
 	static bool Value(const TCHAR* Stream, const TCHAR* Match, FText& Value, const TCHAR* Namespace = NULL);
 	/** Parses a quadword. */
@@ -48,16 +52,28 @@ struct CORE_API FParse
 	static bool Line(const TCHAR** Stream, TCHAR* Result, int32 MaxLen, bool Exact = 0);
 	/** Get a line of Stream (everything up to, but not including, CR/LF. Returns 0 if ok, nonzero if at end of stream and returned 0-length string. */
 	static bool Line(const TCHAR** Stream, YString& Resultd, bool Exact = 0);
+	/** Get a line of Stream into a string that keeps short lines inline, and reuses its memory when it is reused. */
+	static bool Line(const TCHAR** Stream, YInlineString& Result, bool Exact = 0);
 	/** Get a line of Stream, with support for extending beyond that line with certain characters, e.g. {} and \
 	* the out character array will not include the ignored endlines
 	*/
 	static bool LineExtended(const TCHAR** Stream, YString& Result, int32& LinesConsumed, bool Exact = 0);
+	/** Get a line of Stream as a view into Stream, without the comment at its end if any. */
+	static bool Line(const TCHAR** Stream, YStringView& Result, bool Exact = 0);
+	/** Get an extended line of Stream into a string that keeps short lines inline, and reuses its memory when it is reused. */
+	static bool LineExtended(const TCHAR** Stream, YInlineString& Result, int32& LinesConsumed, bool Exact = 0);
 	/** Grabs the next space-delimited string from the input stream. If quoted, gets entire quoted string. */
 	static bool Token(const TCHAR*& Str, TCHAR* Result, int32 MaxLen, bool UseEscape);
 	/** Grabs the next space-delimited string from the input stream. If quoted, gets entire quoted string. */
 	static bool Token(const TCHAR*& Str, YString& Arg, bool UseEscape);
+	/** Grabs the next space-delimited string from the input stream, without allocating unless the token is long. */
+	static bool Token(const TCHAR*& Str, YInlineString& Arg, bool UseEscape);
+	/** Grabs the next space-delimited string from the input stream as a view into it. If quoted, gets the text between the quotes, escapes are not processed. */
+	static bool Token(const TCHAR*& Str, YStringView& Arg);
 	/** Grabs the next alpha-numeric space-delimited token from the input stream. */
 	static bool AlnumToken(const TCHAR*& Str, YString& Arg);
+	/** Grabs the next alpha-numeric space-delimited token from the input stream, without allocating unless the token is long. */
+	static bool AlnumToken(const TCHAR*& Str, YInlineString& Arg);
 	/** Grabs the next space-delimited string from the input stream. If quoted, gets entire quoted string. */
 	static YString Token(const TCHAR*& Str, bool UseEscape);
 	/** Get next command.  Skips past comments and cr's. */
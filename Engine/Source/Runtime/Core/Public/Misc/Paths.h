@@ -4,6 +4,7 @@
 
 #include "CoreTypes.h"
 #include "Containers/SolidAngleString.h"
+#include "Containers/StringView.h"
 #include "HAL/CriticalSection.h"
 
 /**
@@ -333,6 +334,15 @@ public:
 	// Returns the path in front of the filename
 	static YString GetPath(YString&& InPath);
 
+	/**
+	* Views of the parts of a path, which point into InPath rather than copy it. They follow GetExtension, GetCleanFilename,
+	* GetBaseFilename and GetPath, and are only valid as long as the characters of InPath are.
+	*/
+	static YStringView GetExtensionView(const YStringView& InPath, bool bIncludeDot = false);
+	static YStringView GetCleanFilenameView(const YStringView& InPath);
+	static YStringView GetBaseFilenameView(const YStringView& InPath, bool bRemovePath = true);
+	static YStringView GetPathView(const YStringView& InPath);
+
 	// Changes the extension of the given filename
 	static YString ChangeExtension(const YString& InPath, const YString& InNewExtension);
 
@@ -475,6 +485,15 @@ public:
 	*/
 	static void Split(const YString& InPath, YString& PathPart, YString& FilenamePart, YString& ExtensionPart);
 
+	/**
+	* Parses a fully qualified or relative filename into views of its components (filename, path, extension), without allocating.
+	*
+	* @param	Path		[out] receives the path portion of the input string
+	* @param	Filename	[out] receives the filename portion of the input string
+	* @param	Extension	[out] receives the extension portion of the input string
+	*/
+	static void Split(const YStringView& InPath, YStringView& PathPart, YStringView& FilenamePart, YStringView& ExtensionPart);
+
 	/** Gets the relative path to get from BaseDir to RootDirectory  */
 	static const YString& GetRelativePathToRoot();
 
@@ -4,9 +4,56 @@
 
 #include "CoreTypes.h"
 #include "GenericPlatform/GenericPlatformAffinity.h"
+#include "HAL/SolidAngleMemory.h"
 
 class IQueuedWork;
 
+/**
+* Priority bands of a queued thread pool. Work is always taken from the highest non-empty band first, in the order it
+* was queued within a band.
+*/
+enum class EQueuedWorkPriority : uint8
+{
+	Highest,
+	High,
+	Normal,
+	Low,
+	Lowest,
+
+	Count
+};
+
+/** Snapshot of the counters of a queued thread pool, see FQueuedThreadPool::GetStats */
+struct FQueuedThreadPoolStats
+{
+	/** Threads currently in the pool, busy or idle */
+	int32 NumThreads;
+	/** Threads currently waiting for work */
+	int32 NumIdleThreads;
+	/** Work waiting for a thread, per priority band */
+	int32 NumQueued[(int32)EQueuedWorkPriority::Count];
+	/** The most work that was ever waiting at once */
+	int32 PeakNumQueued;
+	/** Work that was handed to a thread */
+	uint64 NumStarted;
+	/** Work that was retracted before it started */
+	uint64 NumRetracted;
+	/** Threads created after Create because queued work was waiting too long */
+	uint32 NumThreadsAdded;
+	/** Threads that exited after being idle for too long */
+	uint32 NumThreadsRetired;
+	/** Time spent by started work waiting in the queue */
+	double TotalWaitSeconds;
+	double MaxWaitSeconds;
+	/** Time spent by pool threads doing work */
+	double TotalRunSeconds;
+
+	FQueuedThreadPoolStats()
+	{
+		YMemory::Memzero(this, sizeof(*this));
+	}
+};
+
 /**
 * Interface for queued thread pools.
 *
@@ -35,9 +82,10 @@ public:
 	* it queues the work for later. Otherwise it is immediately dispatched.
 	*
 	* @param InQueuedWork The work that needs to be done asynchronously
+	* @param InPriority The band the work is queued in if no thread is available
 	* @see RetractQueuedWork
 	*/
-	virtual void AddQueuedWork(IQueuedWork* InQueuedWork) = 0;
+	virtual void AddQueuedWork(IQueuedWork* InQueuedWork, EQueuedWorkPriority InPriority = EQueuedWorkPriority::Normal) = 0;
 
 	/**
 	* Attempts to retract a previously queued task.
@@ -61,6 +109,32 @@ public:
 	*/
 	virtual int32 GetNumThreads() const = 0;
 
+	/**
+	* Lets the pool change its number of threads with the load. By default a pool keeps the threads it was created with.
+	* When work is queued and no thread is idle, the pool adds a thread if it has fewer than InMinThreads, or if it has
+	* fewer than InMaxThreads and the oldest queued work has been waiting for more than InGrowAfterSeconds, which is
+	* what happens when the running work blocks. As blocked work queues nothing more, a pool that may grow also checks
+	* its queue from a monitor thread, a few times every InGrowAfterSeconds. Threads idle for more than
+	* InRetireAfterSeconds exit while the pool has more than InMinThreads.
+	*
+	* @param InMinThreads The number of threads the pool does not retire below
+	* @param InMaxThreads The number of threads the pool does not grow past
+	* @param InGrowAfterSeconds How long work may wait before a thread is added, 0 adds one as soon as none is idle
+	* @param InRetireAfterSeconds How long a thread may stay idle before it exits, 0 never retires threads
+	*/
+	virtual void SetElasticLimits(uint32 InMinThreads, uint32 InMaxThreads, double InGrowAfterSeconds, double InRetireAfterSeconds)
+	{
+	}
+
+	/**
+	* Reads the counters of the pool.
+	*
+	* @param OutStats Receives the counters, left zeroed by pools that do not keep any
+	*/
+	virtual void GetStats(FQueuedThreadPoolStats& OutStats) const
+	{
+	}
+
 public:
 
 	/** Virtual destructor. */
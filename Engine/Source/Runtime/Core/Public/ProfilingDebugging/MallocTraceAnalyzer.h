@@ -0,0 +1,121 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	MallocTraceAnalyzer.h: Offline reports for files written by FMallocTraceProxy
+=============================================================================*/
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "Containers/SolidAngleString.h"
+#include "HAL/MallocTrace.h"
+
+#if USE_MALLOC_TRACE
+
+class YOutputDevice;
+
+/**
+ * Replays a malloc trace and reports where memory is held and where it churns: live memory by callsite at the moment
+ * the trace peaked, the callsites that allocate most often and how long allocations live.
+ * Callstacks are symbolized with the running process' modules, so they only resolve in the process that recorded the
+ * trace or in one running the same binaries without address randomization.
+ */
+class CORE_API FMallocTraceAnalyzer
+{
+public:
+	/** Numbers for one callstack */
+	struct FCallsite
+	{
+		uint32 CallstackId;
+		uint64 NumAllocs;
+		uint64 NumFrees;
+		uint64 AllocatedBytes;
+		int64 LiveBytes;
+		int64 PeakLiveBytes;
+		int64 LiveBytesAtPeak;
+		/** Summed over the freed allocations */
+		uint64 LifetimeCycles;
+		/** Allocations freed within ShortLifetimeSeconds */
+		uint64 NumShortLived;
+	};
+
+	/** Lifetimes are bucketed by powers of ten, from under a microsecond to ten seconds and over */
+	static const int32 NumLifetimeBuckets = 9;
+
+	/** Lifetime below which an allocation counts as churn */
+	static const double ShortLifetimeSeconds;
+
+	FMallocTraceAnalyzer();
+
+	/**
+	 * Reads a trace file and replays its events. A truncated last block is ignored.
+	 *
+	 * @return false if the file cannot be read or is not a malloc trace
+	 */
+	bool Load(const TCHAR* InFilename);
+
+	/** Logs the summary, the top callsites by live memory at peak and by allocation count, and the lifetime histogram. */
+	void Report(YOutputDevice& Ar, int32 NumCallsites = 20) const;
+
+	const TArray<FCallsite>& GetCallsites() const
+	{
+		return Callsites;
+	}
+
+	int64 GetPeakLiveBytes() const
+	{
+		return PeakLiveBytes;
+	}
+
+	/** @return the frames of a callstack, empty if the trace has no record of it */
+	const TArray<uint64>& GetCallstack(uint32 CallstackId) const;
+
+private:
+	struct FEvent
+	{
+		uint64 Cycles;
+		uint64 Ptr;
+		uint64 OldPtr;
+		uint64 Size;
+		uint32 CallstackId;
+		uint32 Sequence;
+		MallocTrace::EEvent Type;
+	};
+
+	bool ParseBlock(const uint8* Data, uint32 Size, uint64 BaseCycles);
+
+	/** Replays the first NumEvents events; gathers all statistics with bGatherStats, otherwise only the live bytes at peak */
+	void Replay(int32 NumEvents, bool bGatherStats);
+
+	/** @return index of the callsite in Callsites */
+	int32 FindOrAddCallsite(uint32 CallstackId);
+
+	YString DescribeCallsite(uint32 CallstackId) const;
+
+	YString Filename;
+	double SecondsPerCycle;
+	uint64 StartCycles;
+	uint64 EndCycles;
+	int32 NumThreads;
+
+	TArray<FEvent> Events;
+	TMap<uint32, TArray<uint64>> Callstacks;
+	TArray<FCallsite> Callsites;
+	TMap<uint32, int32> CallsiteIndices;
+
+	uint64 NumAllocs;
+	uint64 NumFrees;
+	uint64 NumReallocs;
+	/** Frees of blocks allocated before the trace started */
+	uint64 NumUnknownFrees;
+	int64 PeakLiveBytes;
+	uint64 PeakCycles;
+	int32 PeakEventIndex;
+	int64 FinalLiveBytes;
+	/** Last bucket counts the allocations still alive when the trace ended */
+	uint64 LifetimeHistogram[NumLifetimeBuckets + 1];
+};
+
+#endif // USE_MALLOC_TRACE
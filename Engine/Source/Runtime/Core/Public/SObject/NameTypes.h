@@ -74,16 +74,25 @@ enum class ENameCase : uint8
 	IgnoreCase,
 };
 
+/**
+ * The name hash is split in shards that are locked independently, each an open addressed table that
+ * doubles in size as it fills up, so these only set its initial size.
+ */
 namespace YNameDefs
 {
 #if !WITH_EDITORONLY_DATA
-	// Use a modest bucket count on consoles
-	static const uint32 NameHashBucketCount = 65536;
+	// Use a modest number of shards on consoles
+	static const uint32 NameHashShardCount = 32;
+	static const uint32 NameHashShardInitialSlots = 1024;
 #else
-	// On PC platform we use a large number of name hash buckets to accommodate the editor's
-	// use of YNames to store asset path and content tags
-	static const uint32 NameHashBucketCount = 65536;
+	// On PC platform we use more and larger shards to accommodate the editor's use of YNames
+	// to store asset path and content tags, and its many loading threads
+	static const uint32 NameHashShardCount = 64;
+	static const uint32 NameHashShardInitialSlots = 2048;
 #endif
+
+	/** Maximum number of unique names */
+	static const int32 MaxNames = 16 * 1024 * 1024;
 }
 
 
@@ -125,10 +134,6 @@ private:
 	/** Index of name in hash. */
 	NAME_INDEX		Index;
 
-public:
-	/** Pointer to the next entry in this hash bin's linked list. */
-	YNameEntry*		HashNext;
-
 protected:
 	/** Name, variable-sized - note that AllocateNameEntry only allocates memory as needed. */
 	union
@@ -307,39 +312,40 @@ class TStaticIndirectArrayThreadSafeRead
 	};
 	/** Static master table to chunks of pointers **/
 	ElementType** Chunks[ChunkTableSize];
-	/** Number of elements we currently have **/
-	int32 NumElements;
+	/** Number of elements we currently have, all of them in allocated chunks **/
+	volatile int32 NumElements;
+	/** Number of elements handed out by AddZeroed, some of which may not be in NumElements yet **/
+	volatile int32 NumReserved;
 	/** Number of chunks we currently have **/
-	int32 NumChunks;
+	volatile int32 NumChunks;
 
 	/**
-	* Expands the array so that Element[Index] is allocated. New pointers are all zero.
+	* Expands the array so that Element[Index] is allocated, along with all the chunks before it. New pointers are all zero.
+	* Thread safe, threads that race to add the same chunk keep the first one.
 	* @param Index The Index of an element we want to be sure is allocated
 	**/
 	void ExpandChunksToIndex(int32 Index)
 	{
 		check(Index >= 0 && Index < MaxTotalElements);
-		int32 ChunkIndex = Index / ElementsPerChunk;
-		while (1)
+		const int32 ChunkIndex = Index / ElementsPerChunk;
+		for (int32 NewChunkIndex = NumChunks; NewChunkIndex <= ChunkIndex; ++NewChunkIndex)
 		{
-			if (ChunkIndex < NumChunks)
-			{
-				break;
-			}
-			// add a chunk, and make sure nobody else tries
-			ElementType*** Chunk = &Chunks[ChunkIndex];
-			ElementType** NewChunk = (ElementType**)YMemory::Malloc(sizeof(ElementType*) * ElementsPerChunk);
-			YMemory::Memzero(NewChunk, sizeof(ElementType*) * ElementsPerChunk);
-			if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)Chunk, NewChunk, nullptr))
+			if (!Chunks[NewChunkIndex])
 			{
-				// someone else beat us to the add, we don't support multiple concurrent adds
-				check(0)
-			}
-			else
-			{
-				NumChunks++;
+				ElementType** NewChunk = (ElementType**)YMemory::Malloc(sizeof(ElementType*) * ElementsPerChunk);
+				YMemory::Memzero(NewChunk, sizeof(ElementType*) * ElementsPerChunk);
+				if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&Chunks[NewChunkIndex], NewChunk, nullptr))
+				{
+					// someone else beat us to the add
+					YMemory::Free(NewChunk);
+				}
 			}
 		}
+		// every chunk up to ours is allocated, only ever move the count forward
+		for (int32 OldNumChunks = NumChunks; OldNumChunks <= ChunkIndex; OldNumChunks = NumChunks)
+		{
+			FPlatformAtomics::InterlockedCompareExchange(&NumChunks, ChunkIndex + 1, OldNumChunks);
+		}
 		check(ChunkIndex < NumChunks && Chunks[ChunkIndex]); // should have a valid pointer now
 	}
 
@@ -361,6 +367,7 @@ public:
 	/** Constructor : Probably not thread safe **/
 	TStaticIndirectArrayThreadSafeRead()
 		: NumElements(0)
+		, NumReserved(0)
 		, NumChunks(0)
 	{
 		YMemory::Memzero(Chunks);
@@ -400,16 +407,20 @@ public:
 	* Add more elements to the array
 	* @param	NumToAdd	Number of elements to add
 	* @return	the number of elements in the container before we did the add. In other words, the add index.
-	* Not thread safe. This should only be called by one thread, but the other methods can be called while this is going on.
+	* Thread safe. Num() only grows past the new elements once their chunks are allocated, so it may briefly lag behind
+	* the adds of other threads.
 	**/
 	int32 AddZeroed(int32 NumToAdd)
 	{
-		int32 Result = NumElements;
-		check(NumElements + NumToAdd <= MaxTotalElements);
-		ExpandChunksToIndex(NumElements + NumToAdd - 1);
-		check(Result == NumElements);
-		NumElements += NumToAdd;
+		const int32 Result = FPlatformAtomics::InterlockedAdd(&NumReserved, NumToAdd);
+		const int32 NewNum = Result + NumToAdd;
+		check(NewNum <= MaxTotalElements);
+		ExpandChunksToIndex(NewNum - 1);
 		YPlatformMisc::MemoryBarrier();
+		for (int32 OldNum = NumElements; OldNum < NewNum; OldNum = NumElements)
+		{
+			FPlatformAtomics::InterlockedCompareExchange(&NumElements, NewNum, OldNum);
+		}
 		return Result;
 	}
 	/**
@@ -420,32 +431,21 @@ public:
 		return Chunks;
 	}
 	/**
-	* Make sure chunks are allocated to hold the specified capacity of items. This is NOT thread safe.
+	* Make sure chunks are allocated to hold the specified capacity of items.
 	**/
 	void Reserve(int32 Capacity)
 	{
 		check(Capacity >= 0 && Capacity <= MaxTotalElements);
 		if (Capacity > NumElements)
 		{
-			int32 MaxChunks = (Capacity + ElementsPerChunk - 1) / ElementsPerChunk;
-			check(MaxChunks >= NumChunks);
-			for (int32 ChunkIndex = 0; ChunkIndex < MaxChunks; ++ChunkIndex)
-			{
-				if (!Chunks[ChunkIndex])
-				{
-					ElementType** NewChunk = (ElementType**)YMemory::Malloc(sizeof(ElementType*) * ElementsPerChunk);
-					YMemory::Memzero(NewChunk, sizeof(ElementType*) * ElementsPerChunk);
-					Chunks[ChunkIndex] = NewChunk;
-				}
-			}
-			NumChunks = MaxChunks;
+			ExpandChunksToIndex(Capacity - 1);
 		}
 	}
 };
 
 // Typedef for the threadsafe master name table. 
 // CAUTION: If you change those constants, you probably need to update the debug visualizers.
-typedef TStaticIndirectArrayThreadSafeRead<YNameEntry, 2 * 1024 * 1024 /* 2M unique YNames */, 16384 /* allocated in 64K/128K chunks */ > TNameEntryArray;
+typedef TStaticIndirectArrayThreadSafeRead<YNameEntry, YNameDefs::MaxNames, 16384 /* allocated in 64K/128K chunks */ > TNameEntryArray;
 
 /**
 * The minimum amount of data required to reconstruct a name
@@ -917,9 +917,9 @@ public:
 	}
 
 	template <typename TCharType>
-	static uint16 GetCasePreservingHash(const TCharType* Source);
+	static uint32 GetCasePreservingHash(const TCharType* Source);
 	template <typename TCharType>
-	static uint16 GetNonCasePreservingHash(const TCharType* Source);
+	static uint32 GetNonCasePreservingHash(const TCharType* Source);
 
 	static void StaticInit();
 	static void DisplayHash(class YOutputDevice& Ar);
@@ -946,10 +946,7 @@ public:
 	/**
 	* @return Size of Name Table object as a whole
 	*/
-	static int32 GetNameTableMemorySize()
-	{
-		return GetNameEntryMemorySize() + (GetMaxNames() * sizeof(YNameEntry*)) + sizeof(NameHashHead) + sizeof(NameHashTail);
-	}
+	static int32 GetNameTableMemorySize();
 
 	/**
 	* @return number of ansi names in name table
@@ -1023,10 +1020,6 @@ private:
 #endif
 	};
 
-	/** Name hash head - used to iterate the single-linked list.		*/
-	static YNameEntry*						NameHashHead[YNameDefs::NameHashBucketCount];
-	/** Name hash tail - insert new entries after this - NON ATOMIC!	*/
-	static YNameEntry*						NameHashTail[YNameDefs::NameHashBucketCount];
 	/** Size of all name entries.								*/
 	static int32							NameEntryMemorySize;
 	/** Number of ANSI names in name table.						*/
@@ -1060,10 +1053,6 @@ private:
 	* @param HardcodeIndex If >= 0, this represents a hardcoded YName and so automatically gets this index
 	*/
 	void Init(const WIDECHAR* InName, int32 InNumber, EFindName FindType, bool bSplitName = true, int32 HardcodeIndex = -1);
-	/**
-	* Version that takes the hashes as part of the constructor (serialized previously)
-	*/
-	void Init(const WIDECHAR* InName, int32 InNumber, EFindName FindType, const uint16 NonCasePreservingHash, const uint16 CasePreservingHash);
 
 	/**
 	* Initialization from an ANSI string
@@ -1075,13 +1064,9 @@ private:
 	* @param HardcodeIndex If >= 0, this represents a hardcoded YName and so automatically gets this index
 	*/
 	void Init(const ANSICHAR* InName, int32 InNumber, EFindName FindType, bool bSplitName = true, int32 HardcodeIndex = -1);
-	/**
-	* Version that takes the hashes as part of the constructor (serialized previously). Skips InitInternal_HashSplit for loading perf reasons
-	*/
-	void Init(const ANSICHAR* InName, int32 InNumber, EFindName FindType, const uint16 NonCasePreservingHash, const uint16 CasePreservingHash);
 
 	template <typename TCharType>
-	void InitInternal(const TCharType* InName, int32 InNumber, const EFindName FindType, const int32 HardcodeIndex, const uint16 NonCasePreservingHash, const uint16 CasePreservingHash);
+	void InitInternal(const TCharType* InName, int32 InNumber, const EFindName FindType, const int32 HardcodeIndex, const uint32 NonCasePreservingHash);
 
 	/**
 	* Version of InitInternal that calculates the hash after splitting the string. Used by runtime YName construction
@@ -1090,10 +1075,10 @@ private:
 	void InitInternal_HashSplit(const TCharType* InName, int32 InNumber, const EFindName FindType, bool bSplitName, const int32 HardcodeIndex);
 
 	template <typename TCharType>
-	static bool InitInternal_FindOrAdd(const TCharType* InName, const EFindName FindType, const int32 HardcodeIndex, const uint16 NonCasePreservingHash, const uint16 CasePreservingHash, int32& OutComparisonIndex, int32& OutDisplayIndex);
+	static bool InitInternal_FindOrAdd(const TCharType* InName, const EFindName FindType, const int32 HardcodeIndex, const uint32 NonCasePreservingHash, int32& OutComparisonIndex, int32& OutDisplayIndex);
 
 	template <typename TCharType>
-	static bool InitInternal_FindOrAddNameEntry(const TCharType* InName, const EFindName FindType, const ENameCase ComparisonMode, const uint16 iHash, int32& OutIndex);
+	static bool InitInternal_FindOrAddNameEntry(const TCharType* InName, const EFindName FindType, const ENameCase ComparisonMode, const uint32 Hash, int32& OutIndex);
 
 	template <typename TCharType>
 	static bool SplitNameWithCheckImpl(const TCharType* OldName, TCharType* NewName, int32 NewNameLen, int32& NewNumber);
@@ -1111,10 +1096,6 @@ private:
 		return ComparisonIndex;
 #endif
 	}
-
-	/** Singleton to retrieve the critical section. */
-	static FCriticalSection* GetCriticalSection();
-
 };
 
 template<> struct TIsZeroConstructType<class YName> { enum { Value = true }; };
@@ -12,6 +12,8 @@
 #include "SObject/NameTypes.h"
 #include "Templates/SharedPointer.h"
 
+class UFunction;
+
 struct FWeakObjectPtr;
 
 /**
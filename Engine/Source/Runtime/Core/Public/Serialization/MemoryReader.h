@@ -47,7 +47,7 @@ public:
 	YMemoryReader( const TArray<uint8>& InBytes, bool bIsPersistent = false )
 	: YMemoryArchive()
 	, Bytes(InBytes)
-	, LimitSize(INT64_MAX)
+	, LimitSize(MAX_int64)
 	{
 		ArIsLoading		= true;
 		ArIsPersistent	= bIsPersistent;
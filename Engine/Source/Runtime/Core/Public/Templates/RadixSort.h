@@ -0,0 +1,203 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	RadixSort.h: Least significant digit radix sort for integer and float keys
+=============================================================================*/
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "HAL/SolidAngleMemory.h"
+#include "Templates/SolidAngleTemplate.h"
+#include "Templates/Decay.h"
+#include "Templates/Sorting.h"
+#include "Containers/Array.h"
+#include "Containers/ArrayView.h"
+
+/**
+ * Maps a key to an unsigned integer whose order is the order of the key, which is what the radix sort actually sorts.
+ * Specialized for the integer types, float and double.
+ */
+template<typename KeyType>
+struct TRadixSortKeyTraits;
+
+#define RADIX_SORT_UNSIGNED_KEY(KeyType) \
+	template<> struct TRadixSortKeyTraits<KeyType> \
+	{ \
+		typedef KeyType UnsignedType; \
+		static FORCEINLINE UnsignedType ToUnsigned(KeyType Key) { return Key; } \
+	};
+
+/** Signed keys have the sign bit flipped so that negative values come first */
+#define RADIX_SORT_SIGNED_KEY(KeyType, InUnsignedType) \
+	template<> struct TRadixSortKeyTraits<KeyType> \
+	{ \
+		typedef InUnsignedType UnsignedType; \
+		static FORCEINLINE UnsignedType ToUnsigned(KeyType Key) { return (UnsignedType)Key ^ ((UnsignedType)1 << (sizeof(UnsignedType) * 8 - 1)); } \
+	};
+
+/**
+ * Negative floats have all their bits flipped, positive ones only the sign bit, so that the integers order like the
+ * floats do. -0 sorts before +0 and NaNs end up at either end depending on their sign.
+ */
+#define RADIX_SORT_FLOAT_KEY(KeyType, InUnsignedType) \
+	template<> struct TRadixSortKeyTraits<KeyType> \
+	{ \
+		typedef InUnsignedType UnsignedType; \
+		static FORCEINLINE UnsignedType ToUnsigned(KeyType Key) \
+		{ \
+			UnsignedType Bits; \
+			YMemory::Memcpy(&Bits, &Key, sizeof(Bits)); \
+			const UnsignedType SignBit = (UnsignedType)1 << (sizeof(UnsignedType) * 8 - 1); \
+			return (Bits & SignBit) ? ~Bits : (Bits | SignBit); \
+		} \
+	};
+
+RADIX_SORT_UNSIGNED_KEY(uint8)
+RADIX_SORT_UNSIGNED_KEY(uint16)
+RADIX_SORT_UNSIGNED_KEY(uint32)
+RADIX_SORT_UNSIGNED_KEY(uint64)
+RADIX_SORT_SIGNED_KEY(int8, uint8)
+RADIX_SORT_SIGNED_KEY(int16, uint16)
+RADIX_SORT_SIGNED_KEY(int32, uint32)
+RADIX_SORT_SIGNED_KEY(int64, uint64)
+RADIX_SORT_FLOAT_KEY(float, uint32)
+RADIX_SORT_FLOAT_KEY(double, uint64)
+
+#undef RADIX_SORT_UNSIGNED_KEY
+#undef RADIX_SORT_SIGNED_KEY
+#undef RADIX_SORT_FLOAT_KEY
+
+namespace UE4RadixSort_Private
+{
+	/** Below this many elements the histograms cost more than a comparison sort */
+	enum { MinRadixSortNum = 64 };
+
+	/** Identity projection, for arrays of keys */
+	struct FIdentityKey
+	{
+		template<typename T>
+		FORCEINLINE const T& operator()(const T& Element) const
+		{
+			return Element;
+		}
+	};
+}
+
+/**
+* Stable radix sort of elements by a key extracted from each of them, one byte of the key per pass.
+* The histograms of every pass are gathered in a single read of the array and passes where all the elements share the
+* same byte are skipped, so keys that only use their low bits cost fewer passes.
+* Runs on the calling thread and moves the elements through a buffer of Num elements, so T must be default
+* constructible.
+*
+* @param	First		pointer to the first element to sort
+* @param	Num			the number of items to sort
+* @param	Projection	returns the key of an element, an integer type, float or double; called several times per element
+*/
+template<class T, class ProjectionType>
+void RadixSort(T* First, const int32 Num, ProjectionType Projection)
+{
+	typedef typename TDecay<decltype(Projection(DeclVal<const T&>()))>::Type KeyType;
+	typedef TRadixSortKeyTraits<KeyType> KeyTraits;
+	typedef typename KeyTraits::UnsignedType UnsignedType;
+	enum { NumPasses = sizeof(UnsignedType) };
+
+	if (Num < UE4RadixSort_Private::MinRadixSortNum)
+	{
+		StableSortInternal(First, Num, [&Projection](const T& A, const T& B)
+		{
+			return KeyTraits::ToUnsigned(Projection(A)) < KeyTraits::ToUnsigned(Projection(B));
+		});
+		return;
+	}
+
+	int32 Histograms[NumPasses][256];
+	YMemory::Memzero(Histograms, sizeof(Histograms));
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		const UnsignedType Key = KeyTraits::ToUnsigned(Projection(First[Index]));
+		for (int32 Pass = 0; Pass < NumPasses; Pass++)
+		{
+			Histograms[Pass][(Key >> (Pass * 8)) & 0xff]++;
+		}
+	}
+
+	TArray<T> Buffer;
+	T* Source = First;
+	T* Dest = nullptr;
+	for (int32 Pass = 0; Pass < NumPasses; Pass++)
+	{
+		int32* Histogram = Histograms[Pass];
+		const uint32 FirstDigit = (KeyTraits::ToUnsigned(Projection(Source[0])) >> (Pass * 8)) & 0xff;
+		if (Histogram[FirstDigit] == Num)
+		{
+			continue;
+		}
+		if (!Dest)
+		{
+			Buffer.AddDefaulted(Num);
+			Dest = Buffer.GetData();
+		}
+
+		// Turn the counts into the offset each digit starts at
+		int32 Offset = 0;
+		for (int32 Digit = 0; Digit < 256; Digit++)
+		{
+			const int32 Count = Histogram[Digit];
+			Histogram[Digit] = Offset;
+			Offset += Count;
+		}
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			const uint32 Digit = (KeyTraits::ToUnsigned(Projection(Source[Index])) >> (Pass * 8)) & 0xff;
+			Dest[Histogram[Digit]++] = MoveTemp(Source[Index]);
+		}
+		Exchange(Source, Dest);
+	}
+
+	if (Source != First)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			First[Index] = MoveTemp(Source[Index]);
+		}
+	}
+}
+
+/**
+* Stable radix sort of integer or float keys.
+*
+* @param	First	pointer to the first element to sort
+* @param	Num		the number of items to sort
+*/
+template<class T>
+void RadixSort(T* First, const int32 Num)
+{
+	RadixSort(First, Num, UE4RadixSort_Private::FIdentityKey());
+}
+
+/** Array versions of the above */
+template<typename ElementType, typename Allocator>
+void RadixSort(TArray<ElementType, Allocator>& Array)
+{
+	RadixSort(Array.GetData(), Array.Num());
+}
+
+template<typename ElementType, typename Allocator, class ProjectionType>
+void RadixSort(TArray<ElementType, Allocator>& Array, ProjectionType Projection)
+{
+	RadixSort(Array.GetData(), Array.Num(), Projection);
+}
+
+template<typename ElementType>
+void RadixSort(TArrayView<ElementType> View)
+{
+	RadixSort(View.GetData(), View.Num());
+}
+
+template<typename ElementType, class ProjectionType>
+void RadixSort(TArrayView<ElementType> View, ProjectionType Projection)
+{
+	RadixSort(View.GetData(), View.Num(), Projection);
+}
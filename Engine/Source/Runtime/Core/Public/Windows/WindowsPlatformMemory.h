@@ -86,6 +86,12 @@ struct CORE_API YWindowsPlatformMemory
 	static bool					PageProtect(void* const Ptr, const SIZE_T Size, const bool bCanRead, const bool bCanWrite);
 	static void*				BinnedAllocFromOS(SIZE_T Size);
 	static void					BinnedFreeToOS(void* Ptr, SIZE_T Size);
+	static SIZE_T				GetHugePageSize();
+	static void*				HugePageAllocFromOS(SIZE_T Size, bool& bOutHugePages);
+	static void					HugePageFreeToOS(void* Ptr, SIZE_T Size);
+	static uint32				GetNumaNodeCount();
+	static uint32				GetCurrentNumaNode();
+	static void*				NumaAllocFromOS(SIZE_T Size, uint32 Node);
 	static YSharedMemoryRegion* MapNamedSharedMemoryRegion(const YString& InName, bool bCreate, uint32 AccessMode, SIZE_T Size);
 	static bool					UnmapNamedSharedMemoryRegion(YSharedMemoryRegion * MemoryRegion);
 protected:
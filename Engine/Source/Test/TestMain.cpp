@@ -5,13 +5,17 @@
 //#include "Containers/SolidAngleString.h"
 #include <vector>
 #include <memory>
-#include "Containers\StringConv.h"
-#include "Modules\ModuleManager.h"
-#include "HAL\MallocLeakDetection.h"
-#include "Templates\AlignmentTemplates.h"
-#include "Templates\AlignOf.h"
-#include "Templates\Decay.h"
-#include "Templates\AreTypesEqual.h"
+#include "Containers/StringConv.h"
+#include "Modules/ModuleManager.h"
+#include "HAL/MallocLeakDetection.h"
+#include "Templates/AlignmentTemplates.h"
+#include "Templates/AlignOf.h"
+#include "Templates/Decay.h"
+#include "Templates/AreTypesEqual.h"
+#include "Misc/CommandLine.h"
+#include "Async/Async.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/ThreadSafeCounter.h"
 
 struct TrueValue
 {
@@ -188,6 +192,54 @@ void TestDecay()
 	static_assert(TAreTypesEqual<pFunc, TDecay<void()>::Type>::Value,"Types are not equal");
 }
 
+bool TestTaskGraph()
+{
+	std::cout << "\n---------------TaskGraphTest----------" << std::endl;
+	GGameThreadId = YPlatformTLS::GetCurrentThreadId();
+	GIsGameThreadIdInitialized = true;
+	FCommandLine::Set(TEXT(""));
+	FTaskGraphInterface::Startup(YPlatformMisc::NumberOfCores());
+	FTaskGraphInterface::Get().AttachToThread(ENamedThreads::GameThread);
+
+	// tasks are allocated here and freed on the worker threads, which exercises the per-thread task allocator caches
+	const int32 NumTasks = 20000;
+	FThreadSafeCounter NumRun;
+	for (int32 Index = 0; Index < NumTasks; ++Index)
+	{
+		AsyncTask(ENamedThreads::AnyThread, [&NumRun]()
+		{
+			NumRun.Increment();
+		});
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	while (NumRun.GetValue() < NumTasks && FPlatformTime::Seconds() - StartTime < 60.0)
+	{
+		FPlatformProcess::Sleep(0.001f);
+	}
+
+	// and the other way around, tasks queued from a worker and run on the game thread
+	FThreadSafeCounter NumRunOnGameThread;
+	AsyncTask(ENamedThreads::AnyThread, [&NumRunOnGameThread]()
+	{
+		for (int32 Index = 0; Index < 1000; ++Index)
+		{
+			AsyncTask(ENamedThreads::GameThread, [&NumRunOnGameThread]()
+			{
+				NumRunOnGameThread.Increment();
+			});
+		}
+	});
+	while (NumRunOnGameThread.GetValue() < 1000 && FPlatformTime::Seconds() - StartTime < 60.0)
+	{
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		FPlatformProcess::Sleep(0.001f);
+	}
+
+	std::cout << "Tasks run: " << NumRun.GetValue() << " of " << NumTasks << ", on the game thread: " << NumRunOnGameThread.GetValue() << " of 1000" << std::endl;
+	return NumRun.GetValue() == NumTasks && NumRunOnGameThread.GetValue() == 1000;
+}
+
 class YTestModel : public FDefaultModuleImpl
 {
 public:
@@ -292,6 +344,10 @@ int main()
 	TestAlign();
 	TestAlignOf();
 	TestDecay();
+	if (!TestTaskGraph())
+	{
+		return 1;
+	}
 	typedef void (*pFUnc)();
 	//using FuncPointerType = decltype(pFUnc);
 	pFUnc c=nullptr;